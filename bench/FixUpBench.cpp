@@ -0,0 +1,68 @@
+#include "AsmAST.hpp"
+#include "FixUpInstructions.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+namespace {
+
+using namespace CodeGen;
+
+// Shaped like the output of GenerateAsmTree for straight-line arithmetic: every temporary is
+// a fresh pseudo, most instructions have two operands in memory and need a scratch register.
+void buildFunction(Function& function, const i64 instructionCount)
+{
+    const Symbol base("tmp");
+    std::vector<Identifier> temps;
+    temps.reserve(static_cast<size_t>(instructionCount / 4 + 2));
+    const auto pseudo = [&temps](const size_t index, const AsmType type) {
+        return PseudoOperand(temps[index], ReferingTo::Local, type, true);
+    };
+    function.instructions.reserve(static_cast<size_t>(instructionCount));
+    temps.emplace_back(Symbol::derive(base, 0));
+    function.instructions.push_back(function.make<MoveInst>(
+        ImmOperand(1, AsmType::LongWord), pseudo(0, AsmType::LongWord), AsmType::LongWord));
+    while (static_cast<i64>(function.instructions.size()) + 4 <= instructionCount) {
+        const size_t last = temps.size() - 1;
+        temps.emplace_back(Symbol::derive(base, temps.size()));
+        const size_t next = temps.size() - 1;
+        function.instructions.push_back(function.make<MoveInst>(
+            pseudo(last, AsmType::LongWord), pseudo(next, AsmType::LongWord), AsmType::LongWord));
+        function.instructions.push_back(function.make<BinaryInst>(
+            pseudo(last, AsmType::LongWord), pseudo(next, AsmType::LongWord),
+            BinaryInst::Operator::Add, AsmType::LongWord));
+        function.instructions.push_back(function.make<CmpInst>(
+            ImmOperand(0, AsmType::LongWord), pseudo(next, AsmType::LongWord), AsmType::LongWord));
+        function.instructions.push_back(function.make<SetCCInst>(
+            Inst::CondCode::NE, pseudo(next, AsmType::Byte)));
+    }
+    while (static_cast<i64>(function.instructions.size()) < instructionCount)
+        function.instructions.push_back(function.make<CdqInst>(AsmType::LongWord));
+}
+
+void BM_FixUp(benchmark::State& state)
+{
+    const i64 instructionCount = state.range(0);
+    size_t emitted = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto function = std::make_unique<Function>(Identifier("f"), true);
+        buildFunction(*function, instructionCount);
+        state.ResumeTiming();
+        FixUpInstructions fixUpInstructions(function->instructions, function->pool);
+        fixUpInstructions.fixUp();
+        emitted = function->instructions.size();
+        benchmark::DoNotOptimize(emitted);
+        state.PauseTiming();
+        function.reset();
+        state.ResumeTiming();
+    }
+    state.counters["instructions/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * instructionCount), benchmark::Counter::kIsRate);
+    state.counters["emitted"] = static_cast<double>(emitted);
+}
+
+} // namespace
+
+BENCHMARK(BM_FixUp)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,97 @@
+#include "CompilerDriver.hpp"
+#include "SyntheticSource.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+#include <unistd.h>
+
+namespace {
+
+constexpr i32 functionCount = 2000;
+
+// Rebuilds a large translation unit to an object file after changing the body of one function,
+// once from scratch and once with the compile cache, which reuses every other function.
+class IncrementalFixture {
+    std::filesystem::path m_directory;
+    std::string m_source;
+    size_t m_editOffset;
+    i32 m_edits = 0;
+public:
+    IncrementalFixture()
+        : m_directory(std::filesystem::temp_directory_path() / ("cc-incremental-bench-" + std::to_string(getpid()))),
+          m_source(Bench::generateSource(functionCount))
+    {
+        const std::string edited = "(a + " + std::to_string(functionCount / 2) + ")";
+        m_editOffset = m_source.find(edited) + edited.size() - 1;
+        std::filesystem::create_directories(m_directory);
+    }
+    IncrementalFixture(const IncrementalFixture&) = delete;
+    IncrementalFixture& operator=(const IncrementalFixture&) = delete;
+    ~IncrementalFixture()
+    {
+        unsetenv("CC_CACHE_DIR");
+        std::filesystem::remove_all(m_directory);
+    }
+
+    // Every edit is new, so neither the file nor the edited function is ever in the cache.
+    void edit()
+    {
+        std::string source = m_source;
+        source.insert(m_editOffset, " + " + std::to_string(++m_edits));
+        std::ofstream(m_directory / "unit.c") << source;
+    }
+
+    void useCache(const bool enabled) const
+    {
+        if (enabled)
+            setenv("CC_CACHE_DIR", (m_directory / "cache").c_str(), 1);
+        else
+            unsetenv("CC_CACHE_DIR");
+    }
+
+    void compile() const
+    {
+        const CompilerDriver driver({"CC", "-c", "unit.c"}, m_directory);
+        if (driver.runLocal() != 0)
+            std::abort();
+    }
+};
+
+IncrementalFixture& fixture()
+{
+    static IncrementalFixture incrementalFixture;
+    return incrementalFixture;
+}
+
+void rebuild(benchmark::State& state, const bool cached)
+{
+    fixture().useCache(cached);
+    fixture().edit();
+    fixture().compile();
+    for (auto _ : state) {
+        state.PauseTiming();
+        fixture().edit();
+        state.ResumeTiming();
+        fixture().compile();
+    }
+    fixture().useCache(false);
+}
+
+void BM_FullRebuild(benchmark::State& state)
+{
+    rebuild(state, false);
+}
+
+void BM_IncrementalRebuild(benchmark::State& state)
+{
+    rebuild(state, true);
+}
+
+} // namespace
+
+BENCHMARK(BM_FullRebuild)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_IncrementalRebuild)->Unit(benchmark::kMillisecond);
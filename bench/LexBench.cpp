@@ -0,0 +1,31 @@
+#include "Lexer.hpp"
+#include "SyntheticSource.hpp"
+#include "TokenStore.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+void BM_Lex(benchmark::State& state)
+{
+    const std::string source = Bench::generateSource(static_cast<i32>(state.range(0)));
+    size_t tokens = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::string input = source;
+        TokenStore tokenStore;
+        state.ResumeTiming();
+        Lexing::Lexer lexer(std::move(input), tokenStore);
+        if (!lexer.getLexemes().empty())
+            std::abort();
+        tokens = tokenStore.size();
+        benchmark::DoNotOptimize(tokens);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<i64>(source.size()));
+    state.counters["tokens/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * tokens), benchmark::Counter::kIsRate);
+}
+
+} // namespace
+
+BENCHMARK(BM_Lex)->Arg(1000)->Arg(10000)->Arg(30000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,86 @@
+#include "ASTArena.hpp"
+#include "ASTParser.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "SyntheticSource.hpp"
+#include "TokenStore.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <optional>
+
+namespace {
+
+TokenStore lexSource(const std::string& source)
+{
+    TokenStore tokenStore;
+    Lexing::Lexer lexer(source, tokenStore);
+    if (!lexer.getLexemes().empty())
+        std::abort();
+    return tokenStore;
+}
+
+void parseAndTeardown(benchmark::State& state, const bool useArena)
+{
+    const std::string source = Bench::generateSource(static_cast<i32>(state.range(0)));
+    const TokenStore tokenStore = lexSource(source);
+    for (auto _ : state) {
+        std::optional<Parsing::ASTArena> arena;
+        std::optional<Parsing::ArenaScope> arenaScope;
+        if (useArena) {
+            arena.emplace();
+            arenaScope.emplace(*arena);
+        }
+        auto* program = new Parsing::Program();
+        Parsing::Parser parser(tokenStore);
+        if (!parser.programParse(*program).empty())
+            std::abort();
+        benchmark::DoNotOptimize(program);
+        arenaScope.reset();
+        if (useArena)
+            arena->release();
+        else
+            delete program;
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<i64>(tokenStore.size()));
+}
+
+void teardown(benchmark::State& state, const bool useArena)
+{
+    const std::string source = Bench::generateSource(static_cast<i32>(state.range(0)));
+    const TokenStore tokenStore = lexSource(source);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::optional<Parsing::ASTArena> arena;
+        Parsing::Program* program;
+        {
+            std::optional<Parsing::ArenaScope> arenaScope;
+            if (useArena) {
+                arena.emplace();
+                arenaScope.emplace(*arena);
+            }
+            program = new Parsing::Program();
+            Parsing::Parser parser(tokenStore);
+            if (!parser.programParse(*program).empty())
+                std::abort();
+        }
+        state.ResumeTiming();
+        // An arena-backed tree is never destroyed, the whole arena goes at once.
+        if (useArena)
+            arena->release();
+        else
+            delete program;
+    }
+}
+
+void BM_ParseHeap(benchmark::State& state) { parseAndTeardown(state, false); }
+void BM_ParseArena(benchmark::State& state) { parseAndTeardown(state, true); }
+void BM_TeardownHeap(benchmark::State& state) { teardown(state, false); }
+void BM_TeardownArena(benchmark::State& state) { teardown(state, true); }
+
+} // namespace
+
+BENCHMARK(BM_ParseHeap)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseArena)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TeardownHeap)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TeardownArena)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
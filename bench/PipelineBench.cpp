@@ -0,0 +1,234 @@
+#include "ASTArena.hpp"
+#include "ASTParser.hpp"
+#include "Assembly.hpp"
+#include "CodeGenDriver.hpp"
+#include "DynCast.hpp"
+#include "FrontendDriver.hpp"
+#include "GenerateIr.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "SyntheticSource.hpp"
+#include "TokenStore.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+namespace {
+
+// One translation unit as it moves through the frontend. The arena scope stays active for
+// the whole lifetime, nodes created by the semantic passes go into the same arena.
+struct Frontend {
+    Parsing::ASTArena arena;
+    Parsing::ArenaScope arenaScope{arena};
+    Parsing::Program program;
+    SymbolTable symbolTable;
+};
+
+// Times each pipeline stage on its own. The stages before it run untimed to produce its
+// input, fresh for every iteration when the stage changes that input. The benchmark
+// arguments are the function count, expression depth and array size of the synthetic source.
+class Pipeline : public benchmark::Fixture {
+protected:
+    std::string m_source;
+    TokenStore m_tokenStore;
+    CodeGen::WorkStealingPool m_pool{1};
+public:
+    void SetUp(const benchmark::State& state) override
+    {
+        m_source = Bench::generateSource({
+            .functionCount = static_cast<i32>(state.range(0)),
+            .expressionDepth = static_cast<i32>(state.range(1)),
+            .arraySize = static_cast<i32>(state.range(2))});
+        m_tokenStore = TokenStore();
+        Lexing::Lexer lexer(m_source, m_tokenStore);
+        if (!lexer.getLexemes().empty())
+            std::abort();
+    }
+    void TearDown(const benchmark::State&) override
+    {
+        m_source.clear();
+        m_tokenStore = TokenStore();
+    }
+
+    [[nodiscard]] std::unique_ptr<Frontend> parse() const
+    {
+        auto frontend = std::make_unique<Frontend>();
+        Parsing::Parser parser(m_tokenStore);
+        if (!parser.programParse(frontend->program).empty())
+            std::abort();
+        return frontend;
+    }
+    [[nodiscard]] std::unique_ptr<Frontend> validate() const
+    {
+        std::unique_ptr<Frontend> frontend = parse();
+        if (validateSemantics(frontend->program, frontend->symbolTable).first != StateCode::Done)
+            std::abort();
+        return frontend;
+    }
+    [[nodiscard]] Ir::Program ir() const
+    {
+        const std::unique_ptr<Frontend> frontend = validate();
+        Ir::Program irProgram;
+        Ir::GenerateIr generateIr(frontend->symbolTable);
+        generateIr.program(frontend->program, irProgram);
+        return irProgram;
+    }
+
+    void reportTokens(benchmark::State& state) const
+    {
+        state.counters["tokens/s"] = benchmark::Counter(
+            static_cast<double>(state.iterations() * m_tokenStore.size()), benchmark::Counter::kIsRate);
+    }
+    static void reportInstructions(benchmark::State& state, const size_t instructions)
+    {
+        state.counters["instructions/s"] = benchmark::Counter(
+            static_cast<double>(state.iterations() * instructions), benchmark::Counter::kIsRate);
+    }
+};
+
+size_t instructionCount(const Ir::Program& program)
+{
+    size_t count = 0;
+    for (const std::unique_ptr<Ir::TopLevel>& topLevel : program.topLevels)
+        if (topLevel->kind == Ir::TopLevel::Kind::Function)
+            count += dynCast<const Ir::Function>(topLevel.get())->insts.size();
+    return count;
+}
+
+size_t instructionCount(const CodeGen::Program& program)
+{
+    size_t count = 0;
+    for (const std::unique_ptr<CodeGen::TopLevel>& topLevel : program.topLevels)
+        if (topLevel->kind == CodeGen::TopLevel::Kind::Function)
+            count += dynCast<const CodeGen::Function>(topLevel.get())->instructions.size();
+    return count;
+}
+
+} // namespace
+
+BENCHMARK_DEFINE_F(Pipeline, Lex)(benchmark::State& state)
+{
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::string input = m_source;
+        TokenStore tokenStore;
+        state.ResumeTiming();
+        Lexing::Lexer lexer(std::move(input), tokenStore);
+        if (!lexer.getLexemes().empty())
+            std::abort();
+        benchmark::DoNotOptimize(tokenStore.size());
+    }
+    reportTokens(state);
+}
+
+BENCHMARK_DEFINE_F(Pipeline, Parse)(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::unique_ptr<Frontend> frontend = parse();
+        benchmark::DoNotOptimize(frontend.get());
+        state.PauseTiming();
+        frontend.reset();
+        state.ResumeTiming();
+    }
+    reportTokens(state);
+}
+
+BENCHMARK_DEFINE_F(Pipeline, Semantics)(benchmark::State& state)
+{
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<Frontend> frontend = parse();
+        state.ResumeTiming();
+        if (validateSemantics(frontend->program, frontend->symbolTable).first != StateCode::Done)
+            std::abort();
+        state.PauseTiming();
+        frontend.reset();
+        state.ResumeTiming();
+    }
+    reportTokens(state);
+}
+
+BENCHMARK_DEFINE_F(Pipeline, GenerateIr)(benchmark::State& state)
+{
+    size_t instructions = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<Frontend> frontend = validate();
+        auto irProgram = std::make_unique<Ir::Program>();
+        state.ResumeTiming();
+        Ir::GenerateIr generateIr(frontend->symbolTable);
+        generateIr.program(frontend->program, *irProgram);
+        state.PauseTiming();
+        instructions = instructionCount(*irProgram);
+        irProgram.reset();
+        frontend.reset();
+        state.ResumeTiming();
+    }
+    reportTokens(state);
+    reportInstructions(state, instructions);
+}
+
+BENCHMARK_DEFINE_F(Pipeline, Codegen)(benchmark::State& state)
+{
+    const Ir::Program irProgram = ir();
+    size_t instructions = 0;
+    for (auto _ : state) {
+        auto program = std::make_unique<CodeGen::Program>(CodeGen::codegen(irProgram, m_pool));
+        state.PauseTiming();
+        instructions = instructionCount(*program);
+        program.reset();
+        state.ResumeTiming();
+    }
+    reportInstructions(state, instructions);
+}
+
+BENCHMARK_DEFINE_F(Pipeline, FixAsm)(benchmark::State& state)
+{
+    const Ir::Program irProgram = ir();
+    size_t instructions = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto program = std::make_unique<CodeGen::Program>(CodeGen::codegen(irProgram, m_pool));
+        state.ResumeTiming();
+        CodeGen::fixAsm(*program, m_pool);
+        state.PauseTiming();
+        instructions = instructionCount(*program);
+        program.reset();
+        state.ResumeTiming();
+    }
+    reportInstructions(state, instructions);
+}
+
+BENCHMARK_DEFINE_F(Pipeline, AsmProgram)(benchmark::State& state)
+{
+    const CodeGen::Program program = CodeGen::codegen(ir(), m_pool);
+    CodeGen::fixAsm(program, m_pool);
+    std::string text;
+    for (auto _ : state) {
+        text.clear();
+        CodeGen::AsmWriter out(text);
+        CodeGen::asmProgram(out, program, m_pool);
+        benchmark::DoNotOptimize(text.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<i64>(text.size()));
+    reportInstructions(state, instructionCount(program));
+}
+
+static void shapes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"functions", "depth", "array"});
+    benchmark->Args({1000, 1, 4});
+    benchmark->Args({1000, 16, 4});
+    benchmark->Args({1000, 1, 256});
+    benchmark->Args({10000, 1, 4});
+    benchmark->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK_REGISTER_F(Pipeline, Lex)->Apply(shapes);
+BENCHMARK_REGISTER_F(Pipeline, Parse)->Apply(shapes);
+BENCHMARK_REGISTER_F(Pipeline, Semantics)->Apply(shapes);
+BENCHMARK_REGISTER_F(Pipeline, GenerateIr)->Apply(shapes);
+BENCHMARK_REGISTER_F(Pipeline, Codegen)->Apply(shapes);
+BENCHMARK_REGISTER_F(Pipeline, FixAsm)->Apply(shapes);
+BENCHMARK_REGISTER_F(Pipeline, AsmProgram)->Apply(shapes);
@@ -0,0 +1,41 @@
+#include "Preprocessor.hpp"
+#include "SyntheticSource.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+// The first argument is the function count of the synthetic source. With the second argument
+// at 0 the only directive is an unused #define in front of the source, which is enough to
+// leave the fast path, at 1 the source is full of directives and macro expansions.
+void BM_Preprocess(benchmark::State& state)
+{
+    std::string source = Bench::generateSource({
+        .functionCount = static_cast<i32>(state.range(0)),
+        .directives = state.range(1) != 0});
+    if (state.range(1) == 0)
+        source.insert(0, "#define UNUSED 1\n");
+    size_t size = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::string input = source;
+        state.ResumeTiming();
+        Preprocessing::Preprocessor preprocessor;
+        std::string output;
+        if (!preprocessor.process(std::move(input), "bench.c", output).empty())
+            std::abort();
+        size = output.size();
+        benchmark::DoNotOptimize(size);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<i64>(source.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_Preprocess)
+    ->ArgNames({"functions", "directives"})
+    ->Args({10000, 0})
+    ->Args({10000, 1})
+    ->Args({30000, 0})
+    ->Args({30000, 1})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,119 @@
+#include "CompileServer.hpp"
+#include "SyntheticSource.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace {
+
+// Compiles the same small translation unit to an object file, once by starting CC for every
+// request and once through a compile server that stays warm between requests.
+class ServerFixture {
+    std::filesystem::path m_directory;
+    pid_t m_server = -1;
+public:
+    ServerFixture()
+        : m_directory(std::filesystem::temp_directory_path() / ("cc-server-bench-" + std::to_string(getpid())))
+    {
+        std::filesystem::create_directories(m_directory);
+        std::ofstream(m_directory / "unit.c") << Bench::generateSource(20);
+    }
+    ServerFixture(const ServerFixture&) = delete;
+    ServerFixture& operator=(const ServerFixture&) = delete;
+    ~ServerFixture()
+    {
+        if (m_server != -1) {
+            kill(m_server, SIGTERM);
+            waitpid(m_server, nullptr, 0);
+        }
+        std::filesystem::remove_all(m_directory);
+    }
+
+    [[nodiscard]] std::filesystem::path socketPath() const { return m_directory / "socket"; }
+    [[nodiscard]] const std::filesystem::path& directory() const { return m_directory; }
+    [[nodiscard]] std::vector<std::string> args() const { return {CC_BINARY, "-c", "unit.c"}; }
+
+    void startServer()
+    {
+        if (m_server != -1)
+            return;
+        m_server = spawn({CC_BINARY, "--server", socketPath().string()}, {});
+        for (i32 i = 0; i < 500 && !Server::forward(socketPath(), m_directory, {"CC", "--lex", "unit.c"}); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    [[nodiscard]] pid_t spawn(const std::vector<std::string>& args, const std::vector<std::string>& extraEnv) const
+    {
+        std::vector<char*> argv;
+        for (const std::string& arg : args)
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        argv.push_back(nullptr);
+        std::vector<char*> envp;
+        for (char** env = environ; *env != nullptr; ++env)
+            envp.push_back(*env);
+        for (const std::string& env : extraEnv)
+            envp.push_back(const_cast<char*>(env.c_str()));
+        envp.push_back(nullptr);
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addchdir_np(&actions, m_directory.c_str());
+        pid_t pid = -1;
+        if (posix_spawn(&pid, argv.front(), &actions, nullptr, argv.data(), envp.data()) != 0)
+            std::abort();
+        posix_spawn_file_actions_destroy(&actions);
+        return pid;
+    }
+
+    void runProcess(const std::vector<std::string>& extraEnv) const
+    {
+        i32 status = 0;
+        waitpid(spawn(args(), extraEnv), &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            std::abort();
+    }
+};
+
+ServerFixture& fixture()
+{
+    static ServerFixture serverFixture;
+    return serverFixture;
+}
+
+void BM_ColdInvocation(benchmark::State& state)
+{
+    for (auto _ : state)
+        fixture().runProcess({});
+}
+
+void BM_ServerThinClient(benchmark::State& state)
+{
+    fixture().startServer();
+    const std::vector<std::string> env{"CC_SERVER=" + fixture().socketPath().string()};
+    for (auto _ : state)
+        fixture().runProcess(env);
+}
+
+void BM_ServerRequest(benchmark::State& state)
+{
+    fixture().startServer();
+    for (auto _ : state)
+        if (Server::forward(fixture().socketPath(), fixture().directory(), fixture().args()) != 0)
+            std::abort();
+}
+
+} // namespace
+
+BENCHMARK(BM_ColdInvocation)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ServerThinClient)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ServerRequest)->Unit(benchmark::kMillisecond);
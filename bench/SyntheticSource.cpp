@@ -0,0 +1,49 @@
+#include "SyntheticSource.hpp"
+
+namespace Bench {
+
+static std::string expression(const std::string& n, const i32 depth)
+{
+    if (depth <= 1)
+        return "values[i] * (a + " + n + ") - (b >> 1)";
+    const std::string level = std::to_string(depth);
+    return "(" + expression(n, depth - 1) + ") * (a + " + level + ") - (b >> " + std::to_string(depth % 8) + ")";
+}
+
+std::string generateSource(const i32 functionCount)
+{
+    return generateSource(SourceShape{.functionCount = functionCount});
+}
+
+std::string generateSource(const SourceShape& shape)
+{
+    std::string initializer;
+    for (i32 i = 0; i < shape.arraySize; ++i)
+        initializer += (i == 0 ? "" : ", ") + std::to_string(i + 1);
+    const std::string size = std::to_string(shape.arraySize);
+    std::string source;
+    source.reserve(static_cast<size_t>(shape.functionCount) *
+                   (256 + 4 * static_cast<size_t>(shape.arraySize) + 32 * static_cast<size_t>(shape.expressionDepth)));
+    if (shape.directives)
+        source += "#define LIMIT 100\n#define SCALE(x) ((x) * 3)\n";
+    for (i32 i = 0; i < shape.functionCount; ++i) {
+        const std::string n = std::to_string(i);
+        if (shape.directives)
+            source += "#if LIMIT > " + std::to_string(i % 64) + "\n";
+        source += "int function" + n + "(int a, long b) {\n";
+        source += "    int values[" + size + "] = {" + initializer + "};\n";
+        source += "    long sum = b;\n";
+        source += "    for (int i = 0; i < " + size + "; i = i + 1)\n";
+        source += "        sum += " + expression(n, shape.expressionDepth) + ";\n";
+        source += shape.directives ? "    if (sum > LIMIT && a != 0)\n" : "    if (sum > 100 && a != 0)\n";
+        source += "        return (int)(sum % a);\n";
+        source += shape.directives ? "    return SCALE(a) + (int) b;\n" : "    return a * 3 + (int) b;\n";
+        source += "}\n";
+        if (shape.directives)
+            source += "#endif\n";
+    }
+    source += "int main(void) {\n    return function0(1, 2l);\n}\n";
+    return source;
+}
+
+} // Bench
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <string>
+
+namespace Bench {
+
+// Every function declares an array of arraySize elements, sums it in a loop and folds each
+// element into an expression expressionDepth operators deep. With directives the source defines
+// two macros up front, guards every function with #if and expands both macros in its body.
+// The output only depends on the shape.
+struct SourceShape {
+    i32 functionCount = 1000;
+    i32 expressionDepth = 1;
+    i32 arraySize = 4;
+    bool directives = false;
+};
+
+std::string generateSource(i32 functionCount);
+std::string generateSource(const SourceShape& shape);
+
+} // Bench
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "InstructionPool.hpp"
+#include "ObjectModule.hpp"
 #include "ShortTypes.hpp"
+#include "Symbol.hpp"
 #include "Types/Type.hpp"
 
 #include <memory>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -14,6 +19,7 @@ assembly_type = Byte | Word | Longword | Quadword | Double | ByteArray(int size,
 top_level = Function(identifier name, bool global, instruction* instructions)
           | StaticVariable(identifier name, bool global, int alignment, int init)
           | StaticConstant(identifier name, int alignment, static init)
+          | EmittedFunction(identifier name, string assembly, object fragment)
 instruction = Mov(assembly_type, operand src, operand dst)
             | MovSX(operand src, operand dst)
             | MoveZeroExtend(operand src, operand dst)
@@ -44,7 +50,7 @@ operand = Imm(int)
         | Pseudo(identifier)
         | Memory(reg, int)
         | Data(identifier)
-        | PseudoMem(Identifier, int)
+        | PseudoMem(identifier, int offset)
         | Indexed(reg base, reg index, int scale)
 cond_code = E | NE | G | GE | L | LE | A | AE | B | BE
 reg = AX | CX | DX | DI | SI | R8 | R9 | R10 | R11 | SP | BP
@@ -56,16 +62,22 @@ namespace CodeGen {
 
 struct InstVisitor;
 
+using InstructionPool = Ir::InstructionPool;
+
 enum class AsmType : u8 {
     Byte, Word, LongWord, QuadWord, Double
 };
 
 struct Identifier {
-    std::string value;
-    explicit Identifier(std::string value)
-        : value(std::move(value)) {}
+    Symbol value;
+    explicit Identifier(const Symbol value)
+        : value(value) {}
+    explicit Identifier(const std::string_view value)
+        : value(value) {}
 };
 
+// Operands are 16-byte values stored inline in the instructions. Which of the shared fields
+// are meaningful depends on the kind, the named operands below only construct one.
 struct Operand {
     enum class Kind : u8 {
         Imm, Register, Pseudo, Memory, Data, PseudoMem, Indexed
@@ -74,120 +86,100 @@ struct Operand {
         AX, CX, DX, DI, SI, R8, R9, R10, R11, SP, BP,
         XMM0, XMM1, XMM2, XMM3, XMM4, XMM5, XMM6, XMM7, XMM14, XMM15
     };
-    const Kind kind;
-    const AsmType type;
-    const bool isSigned = true;
-
-    virtual ~Operand() = default;
+    Kind kind;
+    AsmType type;
+    union {
+        RegKind regKind;            // Register, Memory, Indexed
+        ReferingTo referingTo;      // Pseudo, PseudoMem
+    };
+    union {
+        RegKind indexRegKind;       // Indexed
+        bool local;                 // Pseudo, Data, PseudoMem
+    };
+    Identifier identifier;          // Pseudo, Data, PseudoMem
+    union {
+        u64 value;                  // Imm
+        i64 offset;                 // Memory, PseudoMem
+        i64 scale;                  // Indexed
+    };
 
     Operand() = delete;
 protected:
-    explicit Operand(const Kind k, const AsmType asmType)
-      : kind(k), type(asmType) {}
-
-    Operand(const Kind k, const AsmType asmType, const bool isSigned)
-        : kind(k), type(asmType), isSigned(isSigned) {}
+    Operand(const Kind k, const AsmType asmType)
+        : kind(k), type(asmType), regKind(RegKind::AX), indexRegKind(RegKind::AX),
+          identifier(Symbol()), value(0) {}
 };
 
 struct ImmOperand final : Operand {
-    u64 value;
-
-    explicit ImmOperand(const u64 value, const AsmType asmType)
-        : Operand(Kind::Imm, asmType, false), value(value) {}
-
-    static bool classOf(const Operand* operand) { return operand->kind == Kind::Imm; }
-
-    ImmOperand() = delete;
+    explicit ImmOperand(const u64 immValue, const AsmType asmType)
+        : Operand(Kind::Imm, asmType)
+    {
+        value = immValue;
+    }
 };
 
 struct RegisterOperand final : Operand {
-    RegKind regKind;
-
     explicit RegisterOperand(const RegKind rK, const AsmType asmType)
-        : Operand(Kind::Register, asmType), regKind(rK) {}
-
-    static bool classOf(const Operand* operand) { return operand->kind == Kind::Register; }
-
-    RegisterOperand() = delete;
+        : Operand(Kind::Register, asmType)
+    {
+        regKind = rK;
+    }
 };
 
 struct PseudoOperand final : Operand {
-    Identifier identifier;
-    ReferingTo referingTo = ReferingTo::Local;
-    bool local;
-
-    PseudoOperand(Identifier identifier, const ReferingTo referingTo, const AsmType asmType, const bool local)
-        : Operand(Kind::Pseudo, asmType), identifier(std::move(identifier)),
-          referingTo(referingTo), local(local) {}
-
-    static bool classOf(const Operand* operand) { return operand->kind == Kind::Pseudo; }
-
-    PseudoOperand() = delete;
+    PseudoOperand(const Identifier iden, const ReferingTo referTo, const AsmType asmType, const bool isLocal)
+        : Operand(Kind::Pseudo, asmType)
+    {
+        identifier = iden;
+        referingTo = referTo;
+        local = isLocal;
+    }
 };
 
 struct MemoryOperand final : Operand {
-    RegKind regKind;
-    i64 value;
-
-    MemoryOperand(const RegKind rK, const i64 value, const AsmType type)
-        : Operand(Kind::Memory, type), regKind(rK), value(value) {}
-
-    static bool classOf(const Operand* operand) { return operand->kind == Kind::Memory; }
-
-    MemoryOperand() = delete;
+    MemoryOperand(const RegKind rK, const i64 displacement, const AsmType asmType)
+        : Operand(Kind::Memory, asmType)
+    {
+        regKind = rK;
+        offset = displacement;
+    }
 };
 
 struct DataOperand final : Operand {
-    Identifier identifier;
-    bool local;
-
-    DataOperand(Identifier iden, const AsmType asmType, const bool local)
-        : Operand(Kind::Data, asmType), identifier(std::move(iden)), local(local) {}
-
-    static bool classOf(const Operand* operand) { return operand->kind == Kind::Data; }
-
-    DataOperand() = delete;
+    DataOperand(const Identifier iden, const AsmType asmType, const bool isLocal)
+        : Operand(Kind::Data, asmType)
+    {
+        identifier = iden;
+        local = isLocal;
+    }
 };
 
+// An element of a local array, the array itself is reserved on the stack by a PushPseudo.
 struct PseudoMemOperand final : Operand {
-    const Identifier identifier;
-    const i64 offset;
-    const i64 size = 0;
-    const i64 alignment;
-    ReferingTo referingTo = ReferingTo::Local;
-    bool local;
-
-    PseudoMemOperand(Identifier identifier,
-                     const i64 offset,
-                     const i64 size,
-                     const i64 alignment,
-                     const bool local,
-                     const AsmType type)
-        : Operand(Kind::PseudoMem, type),
-            identifier(std::move(identifier)),
-            offset(offset),
-            size(size),
-            alignment(alignment),
-            local(local) {}
-
-    static bool classOf(const Operand* operand) { return operand->kind == Kind::PseudoMem; }
-
-    PseudoMemOperand() = delete;
+    PseudoMemOperand(const Identifier iden, const i64 elementOffset, const bool isLocal, const AsmType asmType)
+        : Operand(Kind::PseudoMem, asmType)
+    {
+        identifier = iden;
+        referingTo = ReferingTo::Local;
+        local = isLocal;
+        offset = elementOffset;
+    }
 };
 
 struct IndexedOperand final : Operand {
-    RegKind regKind;
-    RegKind indexRegKind;
-    i64 scale;
-
-    IndexedOperand(const RegKind rK, const RegKind indexRegKind, const i64 scale, const AsmType asmType)
-        : Operand(Kind::Indexed, asmType), regKind(rK), indexRegKind(indexRegKind), scale(scale) {}
-
-    static bool classOf(const Operand* operand) { return operand->kind == Kind::Indexed; }
-
-    IndexedOperand() = delete;
+    IndexedOperand(const RegKind rK, const RegKind indexRK, const i64 indexScale, const AsmType asmType)
+        : Operand(Kind::Indexed, asmType)
+    {
+        regKind = rK;
+        indexRegKind = indexRK;
+        scale = indexScale;
+    }
 };
 
+static_assert(sizeof(Operand) == 16);
+static_assert(std::is_trivially_copyable_v<Operand>);
+static_assert(sizeof(PseudoMemOperand) == sizeof(Operand));
+
 struct Initializer {
     enum class Kind : u8 {
         Zero, Value
@@ -236,8 +228,6 @@ struct Inst {
     };
     const Kind kind;
 
-    virtual ~Inst() = default;
-
     virtual void accept(InstVisitor& visitor) = 0;
 
     Inst() = delete;
@@ -247,15 +237,15 @@ protected:
 };
 
 struct MoveInst final : Inst {
-    std::shared_ptr<Operand> src;
-    std::shared_ptr<Operand> dst;
+    Operand src;
+    Operand dst;
     const AsmType type;
 
     MoveInst(
-        std::shared_ptr<Operand> src,
-        std::shared_ptr<Operand> dst,
+        const Operand& src,
+        const Operand& dst,
         const AsmType t)
-        : Inst(Kind::Move), src(std::move(src)), dst(std::move(dst)), type(t) {}
+        : Inst(Kind::Move), src(src), dst(dst), type(t) {}
 
     void accept(InstVisitor& visitor) override;
     static bool classOf(const Inst* inst) { return inst->kind == Kind::Move; }
@@ -264,17 +254,17 @@ struct MoveInst final : Inst {
 };
 
 struct MoveSXInst final : Inst {
-    std::shared_ptr<Operand> src;
-    std::shared_ptr<Operand> dst;
+    Operand src;
+    Operand dst;
     const AsmType srcType;
     const AsmType dstType;
 
     MoveSXInst(
-        std::shared_ptr<Operand> src,
-        std::shared_ptr<Operand> dst,
+        const Operand& src,
+        const Operand& dst,
         const AsmType srcType,
         const AsmType dstType)
-        : Inst(Kind::MoveSX), src(std::move(src)), dst(std::move(dst)), srcType(srcType), dstType(dstType) {}
+        : Inst(Kind::MoveSX), src(src), dst(dst), srcType(srcType), dstType(dstType) {}
 
     void accept(InstVisitor& visitor) override;
     static bool classOf(const Inst* inst) { return inst->kind == Kind::MoveSX; }
@@ -283,18 +273,18 @@ struct MoveSXInst final : Inst {
 };
 
 struct MoveZeroExtendInst final : Inst {
-    std::shared_ptr<Operand> src;
-    std::shared_ptr<Operand> dst;
+    Operand src;
+    Operand dst;
     const AsmType srcType;
     const AsmType dstType;
 
     MoveZeroExtendInst(
-        std::shared_ptr<Operand> src,
-        std::shared_ptr<Operand> dst,
+        const Operand& src,
+        const Operand& dst,
         const AsmType srcType,
         const AsmType dstType)
-        : Inst(Kind::MoveZeroExtend), src(std::move(src)),
-                                        dst(std::move(dst)),
+        : Inst(Kind::MoveZeroExtend), src(src),
+                                        dst(dst),
                                         srcType(srcType),
                                         dstType(dstType) {}
 
@@ -305,12 +295,12 @@ struct MoveZeroExtendInst final : Inst {
 };
 
 struct LeaInst final : Inst {
-    std::shared_ptr<Operand> src;
-    std::shared_ptr<Operand> dst;
+    Operand src;
+    Operand dst;
     const AsmType type;
 
-    LeaInst(std::shared_ptr<Operand> src, std::shared_ptr<Operand> dst, const AsmType t)
-        : Inst(Kind::Lea), src(std::move(src)), dst(std::move(dst)), type(t) {}
+    LeaInst(const Operand& src, const Operand& dst, const AsmType t)
+        : Inst(Kind::Lea), src(src), dst(dst), type(t) {}
 
     void accept(InstVisitor& visitor) override;
     static bool classOf(const Inst* inst) { return inst->kind == Kind::Lea; }
@@ -319,15 +309,15 @@ struct LeaInst final : Inst {
 };
 
 struct Cvttsd2siInst final : Inst {
-    std::shared_ptr<Operand> src;
-    std::shared_ptr<Operand> dst;
+    Operand src;
+    Operand dst;
     const AsmType dstType;
 
     Cvttsd2siInst(
-        std::shared_ptr<Operand> src,
-        std::shared_ptr<Operand> dst,
+        const Operand& src,
+        const Operand& dst,
         const AsmType dstType)
-        : Inst(Kind::Cvttsd2si), src(std::move(src)), dst(std::move(dst)), dstType(dstType) {}
+        : Inst(Kind::Cvttsd2si), src(src), dst(dst), dstType(dstType) {}
 
     void accept(InstVisitor& visitor) override;
     static bool classOf(const Inst* inst) { return inst->kind == Kind::Cvttsd2si; }
@@ -336,15 +326,15 @@ struct Cvttsd2siInst final : Inst {
 };
 
 struct Cvtsi2sdInst final : Inst {
-    std::shared_ptr<Operand> src;
-    std::shared_ptr<Operand> dst;
+    Operand src;
+    Operand dst;
     const AsmType srcType;
 
     Cvtsi2sdInst(
-        std::shared_ptr<Operand> src,
-        std::shared_ptr<Operand> dst,
+        const Operand& src,
+        const Operand& dst,
         const AsmType srcType)
-        : Inst(Kind::Cvtsi2sd), src(std::move(src)), dst(std::move(dst)), srcType(srcType) {}
+        : Inst(Kind::Cvtsi2sd), src(src), dst(dst), srcType(srcType) {}
 
     void accept(InstVisitor& visitor) override;
     static bool classOf(const Inst* inst) { return inst->kind == Kind::Cvtsi2sd; }
@@ -356,12 +346,12 @@ struct UnaryInst final : Inst {
     enum class Operator : u8 {
         Neg, Not, Shr
     };
-    std::shared_ptr<Operand> destination;
+    Operand destination;
     const Operator oper;
     const AsmType type;
 
-    UnaryInst(std::shared_ptr<Operand> dst, const Operator op, const AsmType type)
-        : Inst(Kind::Unary), destination(std::move(dst)), oper(op), type(type) {}
+    UnaryInst(const Operand& dst, const Operator op, const AsmType type)
+        : Inst(Kind::Unary), destination(dst), oper(op), type(type) {}
 
     void accept(InstVisitor& visitor) override;
     static bool classOf(const Inst* inst) { return inst->kind == Kind::Unary; }
@@ -377,15 +367,15 @@ struct BinaryInst final : Inst {
         LeftShiftUnsigned, RightShiftUnsigned,
         DivDouble,
     };
-    std::shared_ptr<Operand> lhs;
-    std::shared_ptr<Operand> rhs;
+    Operand lhs;
+    Operand rhs;
     const Operator oper;
     const AsmType type;
-    BinaryInst(std::shared_ptr<Operand> lhs,
-               std::shared_ptr<Operand> rhs,
+    BinaryInst(const Operand& lhs,
+               const Operand& rhs,
                const Operator op,
                const AsmType ty)
-        :Inst(Kind::Binary), lhs(std::move(lhs)), rhs(std::move(rhs)), oper(op), type(ty) {}
+        :Inst(Kind::Binary), lhs(lhs), rhs(rhs), oper(op), type(ty) {}
 
     void accept(InstVisitor& visitor) override;
     static bool classOf(const Inst* inst) { return inst->kind == Kind::Binary; }
@@ -394,11 +384,11 @@ struct BinaryInst final : Inst {
 };
 
 struct CmpInst final : Inst {
-    std::shared_ptr<Operand> lhs;
-    std::shared_ptr<Operand> rhs;
+    Operand lhs;
+    Operand rhs;
     const AsmType type;
-    CmpInst(std::shared_ptr<Operand> lhs, std::shared_ptr<Operand> rhs, const AsmType ty)
-        : Inst(Kind::Cmp), lhs(std::move(lhs)), rhs(std::move(rhs)), type(ty) {}
+    CmpInst(const Operand& lhs, const Operand& rhs, const AsmType ty)
+        : Inst(Kind::Cmp), lhs(lhs), rhs(rhs), type(ty) {}
 
     void accept(InstVisitor& visitor) override;
     static bool classOf(const Inst* inst) { return inst->kind == Kind::Cmp; }
@@ -407,11 +397,11 @@ struct CmpInst final : Inst {
 };
 
 struct IdivInst final : Inst {
-    std::shared_ptr<Operand> operand;
+    Operand operand;
     const AsmType type;
 
-    IdivInst(std::shared_ptr<Operand> operand, const AsmType ty)
-        : Inst(Kind::Idiv), operand(std::move(operand)), type(ty) {}
+    IdivInst(const Operand& operand, const AsmType ty)
+        : Inst(Kind::Idiv), operand(operand), type(ty) {}
 
     void accept(InstVisitor& visitor) override;
     static bool classOf(const Inst* inst) { return inst->kind == Kind::Idiv; }
@@ -420,11 +410,11 @@ struct IdivInst final : Inst {
 };
 
 struct DivInst final : Inst {
-    std::shared_ptr<Operand> operand;
+    Operand operand;
     const AsmType type;
 
-    DivInst(std::shared_ptr<Operand> operand, const AsmType ty)
-        : Inst(Kind::Div), operand(std::move(operand)), type(ty) {}
+    DivInst(const Operand& operand, const AsmType ty)
+        : Inst(Kind::Div), operand(operand), type(ty) {}
 
     void accept(InstVisitor& visitor) override;
     static bool classOf(const Inst* inst) { return inst->kind == Kind::Div; }
@@ -466,10 +456,10 @@ struct JmpCCInst final : Inst {
 };
 
 struct SetCCInst final : Inst {
-    std::shared_ptr<Operand> operand;
+    Operand operand;
     const CondCode condition;
-    explicit SetCCInst(const CondCode condition, std::shared_ptr<Operand> operand)
-        : Inst(Kind::SetCC), condition(condition), operand(std::move(operand)) {}
+    explicit SetCCInst(const CondCode condition, const Operand& operand)
+        : Inst(Kind::SetCC), condition(condition), operand(operand) {}
 
     void accept(InstVisitor& visitor) override;
     static bool classOf(const Inst* inst) { return inst->kind == Kind::SetCC; }
@@ -505,9 +495,9 @@ struct PushPseudoInst final : Inst {
 };
 
 struct PushInst final : Inst {
-    std::shared_ptr<Operand> operand;
-    explicit PushInst(std::shared_ptr<Operand> operand)
-        : Inst(Kind::Push), operand(std::move(operand)) {}
+    Operand operand;
+    explicit PushInst(const Operand& operand)
+        : Inst(Kind::Push), operand(operand) {}
 
     void accept(InstVisitor& visitor) override;
     static bool classOf(const Inst* inst) { return inst->kind == Kind::Push; }
@@ -536,7 +526,7 @@ struct ReturnInst final : Inst {
 
 struct TopLevel {
     enum class Kind {
-        Function, StaticVariable, StaticConstant, StaticArray, StaticString
+        Function, StaticVariable, StaticConstant, StaticArray, StaticString, EmittedFunction
     };
     const Kind kind;
 
@@ -549,12 +539,16 @@ protected:
 };
 
 struct Function final : TopLevel {
-    std::string name;
-    std::vector<std::unique_ptr<Inst>> instructions;
+    Identifier name;
+    std::vector<Inst*> instructions;
+    InstructionPool pool;
     i64 stackAlloc = 0;
     const bool isGlobal;
-    Function(std::string name, const bool isGlobal)
-        : TopLevel(Kind::Function), name(std::move(name)), isGlobal(isGlobal) {}
+    Function(const Identifier name, const bool isGlobal)
+        : TopLevel(Kind::Function), name(name), isGlobal(isGlobal) {}
+
+    template<typename T, typename... Args>
+    T* make(Args&&... args) { return pool.make<T>(std::forward<Args>(args)...); }
 
     static bool classOf(const TopLevel* topLevel) { return topLevel->kind == Kind::Function; }
 
@@ -562,12 +556,12 @@ struct Function final : TopLevel {
 };
 
 struct StaticVariable final : TopLevel {
-    std::string name;
+    Identifier name;
     u64 init = 0;
     AsmType type;
     const bool global;
-    StaticVariable(std::string name, const AsmType type, const bool isGlobal)
-        : TopLevel(Kind::StaticVariable), name(std::move(name)), type(type), global(isGlobal) {}
+    StaticVariable(const Identifier name, const AsmType type, const bool isGlobal)
+        : TopLevel(Kind::StaticVariable), name(name), type(type), global(isGlobal) {}
 
     static bool classOf(const TopLevel* topLevel) { return topLevel->kind == Kind::StaticVariable; }
 
@@ -611,13 +605,13 @@ struct ArrayVariable final : TopLevel {
 };
 
 struct StringVariable final : TopLevel {
-    const std::string name;
+    const Identifier name;
     const std::string value;
     const bool global;
     const bool nullTerminated;
 
-    StringVariable(std::string name, const std::string& value, const bool global, const bool nullTerminated)
-        : TopLevel(Kind::StaticString), name(std::move(name)), value(value),
+    StringVariable(const Identifier name, const std::string& value, const bool global, const bool nullTerminated)
+        : TopLevel(Kind::StaticString), name(name), value(value),
                                          global(global), nullTerminated(nullTerminated) {}
 
     static bool classOf(const TopLevel* topLevel) { return topLevel->kind == Kind::StaticString; }
@@ -625,6 +619,21 @@ struct StringVariable final : TopLevel {
     StringVariable() = delete;
 };
 
+// A function that already went through fixAsm and emission, kept as the text asmProgram would
+// print for it or as the machine code fragment the object emitter would produce.
+struct EmittedFunction final : TopLevel {
+    Identifier name;
+    std::string assembly;
+    ObjectModule object;
+
+    EmittedFunction(const Identifier name, std::string assembly, ObjectModule object)
+        : TopLevel(Kind::EmittedFunction), name(name), assembly(std::move(assembly)), object(std::move(object)) {}
+
+    static bool classOf(const TopLevel* topLevel) { return topLevel->kind == Kind::EmittedFunction; }
+
+    EmittedFunction() = delete;
+};
+
 struct Program {
     std::vector<std::unique_ptr<TopLevel>> topLevels;
 };
@@ -40,12 +40,12 @@ void AsmPrinter::add(const StaticVariable& staticVariable)
         global = "is global";
     else
         global = "is not global";
-    addLine(staticVariable.name + " " + std::to_string(staticVariable.init) + " " + global);
+    addLine(to_string(staticVariable.name) + " " + std::to_string(staticVariable.init) + " " + global);
 }
 
 void AsmPrinter::add(const ConstVariable& constVariable)
 {
-    addLine(constVariable.name.value + " " + std::to_string(constVariable.staticInit) + " " +
+    addLine(to_string(constVariable.name) + " " + std::to_string(constVariable.staticInit) + " " +
             std::to_string(constVariable.alignment));
 }
 
@@ -57,7 +57,7 @@ void AsmPrinter::add(const Function& function)
         global = "is global";
     else
         global = "is not global";
-    addLine(function.name + " " + global);
+    addLine(to_string(function.name) + " " + global);
     for (const auto& inst : function.instructions)
         add(*inst);
 }
@@ -112,58 +112,58 @@ void AsmPrinter::add(const Inst& inst)
 
 void AsmPrinter::add(const MoveInst& move)
 {
-    addLine("MoveInst: ", to_string(*move.src) + " " + to_string(*move.dst));
+    addLine("MoveInst: ", to_string(move.src) + " " + to_string(move.dst));
 }
 
 void AsmPrinter::add(const MoveSXInst& moveSX)
 {
     addLine("MoveSXInst: ",
-        to_string(*moveSX.src) + " " +
-        to_string(*moveSX.dst));
+        to_string(moveSX.src) + " " +
+        to_string(moveSX.dst));
 }
 
 void AsmPrinter::add(const MoveZeroExtendInst& moveZeroExtend)
 {
     addLine("MoveZeroExtendInst: ",
-            to_string(*moveZeroExtend.src) + " " +
-            to_string(*moveZeroExtend.dst));
+            to_string(moveZeroExtend.src) + " " +
+            to_string(moveZeroExtend.dst));
 }
 
 void AsmPrinter::add(const LeaInst& lea)
 {
-    addLine("LeaInst: ", to_string(*lea.src) + " " + to_string(*lea.dst));
+    addLine("LeaInst: ", to_string(lea.src) + " " + to_string(lea.dst));
 }
 
 void AsmPrinter::add(const UnaryInst& unary)
 {
     addLine("Unary: ",
             to_string(unary.oper) + " " +
-            to_string(*unary.destination));
+            to_string(unary.destination));
 }
 
 void AsmPrinter::add(const BinaryInst& binary)
 {
     addLine("Binary: ",
-            to_string(*binary.lhs) + " " +
+            to_string(binary.lhs) + " " +
             to_string(binary.oper) + " " +
-            to_string(*binary.rhs));
+            to_string(binary.rhs));
 }
 
 void AsmPrinter::add(const CmpInst& cmp)
 {
     addLine("Cmp: ",
-            to_string(*cmp.lhs) + " " +
-            to_string(*cmp.rhs));
+            to_string(cmp.lhs) + " " +
+            to_string(cmp.rhs));
 }
 
 void AsmPrinter::add(const IdivInst& idiv)
 {
-    addLine("Idiv: ", to_string(*idiv.operand));
+    addLine("Idiv: ", to_string(idiv.operand));
 }
 
 void AsmPrinter::add(const DivInst& div)
 {
-    addLine("Div: ", to_string(*div.operand));
+    addLine("Div: ", to_string(div.operand));
 }
 
 void AsmPrinter::add(const CdqInst& cpq)
@@ -186,7 +186,7 @@ void AsmPrinter::add(const JmpCCInst& jmpCC)
 void AsmPrinter::add(const SetCCInst& setCC)
 {
     addLine("SetCC: ",
-            to_string(*setCC.operand) + " " +
+            to_string(setCC.operand) + " " +
             to_string(setCC.condition));
 }
 
@@ -198,7 +198,7 @@ void AsmPrinter::add(const LabelInst& label)
 
 void AsmPrinter::add(const PushInst& push)
 {
-    addLine("Push: ",  to_string(*push.operand));
+    addLine("Push: ",  to_string(push.operand));
 }
 
 void AsmPrinter::add(const CallInst& call)
@@ -214,82 +214,54 @@ void AsmPrinter::add(const ReturnInst& returnInst)
 void AsmPrinter::add(const Cvtsi2sdInst& cvtsi2sd)
 {
     addLine("Cvtsi2sd",
-    to_string(*cvtsi2sd.src) +  " " +
-            to_string(*cvtsi2sd.dst) + " " +
+    to_string(cvtsi2sd.src) +  " " +
+            to_string(cvtsi2sd.dst) + " " +
             to_string(cvtsi2sd.srcType));
 }
 
 void AsmPrinter::add(const Cvttsd2siInst& cvttsd2si)
 {
     addLine("Cvttsd2si",
-            to_string(*cvttsd2si.src) + " " +
-            to_string(*cvttsd2si.dst) + " " +
+            to_string(cvttsd2si.src) + " " +
+            to_string(cvttsd2si.dst) + " " +
             to_string(cvttsd2si.dstType));
 }
 
 std::string to_string(const Identifier& identifier)
 {
-    return identifier.value;
+    return identifier.value.str();
 }
 
 std::string to_string(const Operand& operand)
 {
     using Kind = Operand::Kind;
     switch (operand.kind) {
-        case Kind::Imm:         return to_string(*dynCast<const ImmOperand>(&operand));
-        case Kind::Register:    return to_string(*dynCast<const RegisterOperand>(&operand));
-        case Kind::Pseudo:      return to_string(*dynCast<const PseudoOperand>(&operand));
-        case Kind::PseudoMem:   return to_string(*dynCast<const PseudoMemOperand>(&operand));
-        case Kind::Memory:      return to_string(*dynCast<const MemoryOperand>(&operand));
-        case Kind::Data:        return to_string(*dynCast<const DataOperand>(&operand));
-        case Kind::Indexed:     return to_string(*dynCast<const IndexedOperand>(&operand));
+        case Kind::Imm:
+            return "ImmOperand(" + std::to_string(operand.value) + ", " + to_string(operand.type) + ")";
+        case Kind::Register:
+            return "Register(" + to_string(operand.regKind) + ", " + to_string(operand.type) + ")";
+        case Kind::Pseudo:
+            return "Pseudo(" + operand.identifier.value.str() + ", " + to_string(operand.type) + ")";
+        case Kind::PseudoMem:
+            return "PseudoMem(" + operand.identifier.value.str() + ", " +
+                                  to_string(operand.type) + ", " +
+                                  std::to_string(operand.offset)  + ")";
+        case Kind::Memory:
+            return "Memory(" + std::to_string(operand.offset) + ", " +
+                               to_string(operand.regKind) + ", " +
+                               to_string(operand.type) + ")";
+        case Kind::Data:
+            return "Data(" + operand.identifier.value.str() + ", " + to_string(operand.type) + ")";
+        case Kind::Indexed:
+            return "Indexed(" + to_string(operand.regKind) + ", " +
+                                to_string(operand.indexRegKind) + ", " +
+                                std::to_string(operand.scale) + ", " +
+                                to_string(operand.type) + ")";
         default:
             std::unreachable();
     }
 }
 
-std::string to_string(const ImmOperand& immOperand)
-{
-    return "ImmOperand(" + std::to_string(immOperand.value) + ", " + to_string(immOperand.type) + ")";
-}
-
-std::string to_string(const RegisterOperand& registerOperand)
-{
-    return "Register(" + to_string(registerOperand.regKind) + ", " + to_string(registerOperand.type) + ")";
-}
-
-std::string to_string(const PseudoOperand& pseudoOperand)
-{
-    return "Pseudo(" + pseudoOperand.identifier.value + ", " + to_string(pseudoOperand.type) + ")";
-}
-
-std::string to_string(const PseudoMemOperand& pseudoMemOperand)
-{
-    return "PseudoMem(" + pseudoMemOperand.identifier.value + ", " +
-                          to_string(pseudoMemOperand.type) + ", " +
-                          std::to_string(pseudoMemOperand.offset)  + ")";
-}
-
-std::string to_string(const MemoryOperand& memoryOperand)
-{
-    return "Memory(" + std::to_string(memoryOperand.value) + ", " +
-                       to_string(memoryOperand.regKind) + ", " +
-                       to_string(memoryOperand.type) + ")";
-}
-
-std::string to_string(const DataOperand& dataOperand)
-{
-    return "Data(" + dataOperand.identifier.value + ", " + to_string(dataOperand.type) + ")";
-}
-
-std::string to_string(const IndexedOperand& indexedOperand)
-{
-    return "Indexed(" + to_string(indexedOperand.regKind) + ", " +
-                        to_string(indexedOperand.indexRegKind) + ", " +
-                        std::to_string(indexedOperand.scale) + ", " +
-                        to_string(indexedOperand.type) + ")";
-}
-
 std::string to_string(const Operand::RegKind regType)
 {
     using Type = Operand::RegKind;
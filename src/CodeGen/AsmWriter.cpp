@@ -0,0 +1,34 @@
+#include "AsmWriter.hpp"
+
+#include <cerrno>
+
+#include <unistd.h>
+
+namespace CodeGen {
+
+AsmWriter::AsmWriter(const i32 fd)
+    : m_out(&m_chunk), m_fd(fd)
+{
+    m_chunk.reserve(2 * chunkSize);
+}
+
+void AsmWriter::flush()
+{
+    if (m_fd < 0)
+        return;
+    const char* data = m_chunk.data();
+    size_t left = m_chunk.size();
+    while (0 < left && !m_failed) {
+        const ssize_t written = ::write(m_fd, data, left);
+        if (written < 0) {
+            m_failed = errno != EINTR;
+            continue;
+        }
+        data += written;
+        left -= static_cast<size_t>(written);
+    }
+    m_flushed += m_chunk.size();
+    m_chunk.clear();
+}
+
+} // CodeGen
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <charconv>
+#include <string>
+#include <string_view>
+
+namespace CodeGen {
+
+// Output buffer for assembly text. Writing to a file descriptor goes through one reusable
+// chunk that is handed to the descriptor once it fills up, writing to a string appends to it.
+class AsmWriter {
+    static constexpr size_t chunkSize = 64 * 1024;
+    std::string m_chunk;
+    std::string* m_out;
+    i32 m_fd = -1;
+    u64 m_flushed = 0;
+    bool m_failed = false;
+public:
+    explicit AsmWriter(i32 fd);
+    explicit AsmWriter(std::string& target)
+        : m_out(&target) {}
+    ~AsmWriter() { flush(); }
+
+    AsmWriter(const AsmWriter&) = delete;
+    AsmWriter& operator=(const AsmWriter&) = delete;
+
+    void put(const char c) { m_out->push_back(c); }
+    void put(const std::string_view text) { m_out->append(text); }
+    template<typename T>
+    void putNumber(const T value)
+    {
+        char digits[24];
+        const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+        m_out->append(digits, end);
+    }
+    // Fills with spaces up to the given absolute position, does nothing when already past it.
+    void padTo(const u64 position)
+    {
+        if (this->position() < position)
+            m_out->append(position - this->position(), ' ');
+    }
+    [[nodiscard]] u64 position() const { return m_flushed + m_out->size(); }
+    [[nodiscard]] bool failed() const { return m_failed; }
+
+    // Called between top levels, so at most one chunk and one function are held at a time.
+    void endTopLevel()
+    {
+        if (chunkSize <= m_chunk.size())
+            flush();
+    }
+    void flush();
+};
+
+} // CodeGen
@@ -1,450 +1,570 @@
 #include "Assembly.hpp"
 #include "DynCast.hpp"
 #include "Operators.hpp"
+#include "TimeTrace.hpp"
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <string>
-#include <iomanip>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace CodeGen {
 
+namespace {
+
+constexpr u64 mnemonicWidth = 12;
+constexpr u64 operandsWidth = 16;
+
+using RegKind = Operand::RegKind;
+
+constexpr std::array<std::string_view, 5> typeSuffixes{"b", " not set addType", "l", "q", "sd"};
+
+constexpr std::array<std::string_view, 11> condCodeNames{"e", "ne", "g", "ge", "l", "le", "a", "ae", "b", "be", "p"};
+
+constexpr std::array<std::string_view, 3> unaryMnemonics{"neg", "not", "shr"};
+
+constexpr std::array<std::string_view, 10> binaryMnemonics{
+    "add", "sub", "imul", "and", "or", "xor", "shl", "sar", "sal", "shr"
+};
+
+// Indexed by register and then by AsmType.
+constexpr std::array<std::array<std::string_view, 5>, 21> registerNames{{
+    {"%al",   "%ax",   "%eax",  "%rax", "invalid_size"},
+    {"%cl",   "%cx",   "%ecx",  "%rcx", "invalid_size"},
+    {"%dl",   "%dx",   "%edx",  "%rdx", "invalid_size"},
+    {"%dil",  "%di",   "%edi",  "%rdi", "invalid_size"},
+    {"%sil",  "%si",   "%esi",  "%rsi", "invalid_size"},
+    {"%r8b",  "%r8w",  "%r8d",  "%r8",  "invalid_size"},
+    {"%r9b",  "%r9w",  "%r9d",  "%r9",  "invalid_size"},
+    {"%r10b", "%r10w", "%r10d", "%r10", "invalid_size"},
+    {"%r11b", "%r11w", "%r11d", "%r11", "invalid_size"},
+    {"%rsp",  "%rsp",  "%rsp",  "%rsp", "invalid_size"},
+    {"%rbp",  "%rbp",  "%rbp",  "%rbp", "%rbp"},
+    {"%xmm0",  "%xmm0",  "%xmm0",  "%xmm0",  "%xmm0"},
+    {"%xmm1",  "%xmm1",  "%xmm1",  "%xmm1",  "%xmm1"},
+    {"%xmm2",  "%xmm2",  "%xmm2",  "%xmm2",  "%xmm2"},
+    {"%xmm3",  "%xmm3",  "%xmm3",  "%xmm3",  "%xmm3"},
+    {"%xmm4",  "%xmm4",  "%xmm4",  "%xmm4",  "%xmm4"},
+    {"%xmm5",  "%xmm5",  "%xmm5",  "%xmm5",  "%xmm5"},
+    {"%xmm6",  "%xmm6",  "%xmm6",  "%xmm6",  "%xmm6"},
+    {"%xmm7",  "%xmm7",  "%xmm7",  "%xmm7",  "%xmm7"},
+    {"%xmm14", "%xmm14", "%xmm14", "%xmm14", "%xmm14"},
+    {"%xmm15", "%xmm15", "%xmm15", "%xmm15", "%xmm15"},
+}};
+
+std::string_view typeSuffix(const AsmType type)
+{
+    return typeSuffixes[static_cast<size_t>(type)];
+}
+
+std::string_view registerName(const AsmType type, const RegKind reg)
+{
+    return registerNames[static_cast<size_t>(reg)][static_cast<size_t>(type)];
+}
+
+std::string_view condCodeName(const BinaryInst::CondCode condCode)
+{
+    return condCodeNames[static_cast<size_t>(condCode)];
+}
+
+// A line is four spaces, the mnemonic padded to 12 columns and the operands padded to 16.
+u64 beginLine(AsmWriter& out)
+{
+    out.put("    ");
+    return out.position();
+}
+
+u64 beginOperands(AsmWriter& out, const u64 lineStart)
+{
+    out.padTo(lineStart + mnemonicWidth);
+    return out.position();
+}
+
+void endLine(AsmWriter& out, const u64 operandsStart)
+{
+    out.padTo(operandsStart + operandsWidth);
+    out.put('\n');
+}
+
+u64 beginInstruction(AsmWriter& out, const std::string_view mnemonic, const std::string_view suffix = {})
+{
+    const u64 lineStart = beginLine(out);
+    out.put(mnemonic);
+    out.put(suffix);
+    return beginOperands(out, lineStart);
+}
+
+void line(AsmWriter& out, const std::string_view mnemonic, const std::string_view operands = {})
+{
+    const u64 operandsStart = beginInstruction(out, mnemonic);
+    out.put(operands);
+    endLine(out, operandsStart);
+}
+
+template<typename T>
+void numberLine(AsmWriter& out, const std::string_view mnemonic, const T value)
+{
+    const u64 lineStart = beginLine(out);
+    out.put(mnemonic);
+    out.putNumber(value);
+    endLine(out, beginOperands(out, lineStart));
+}
+
+void label(AsmWriter& out, const std::string_view name, const bool local = false)
+{
+    if (local)
+        out.put(".L");
+    out.put(name);
+    out.put(":\n");
+}
+
+void emitInstruction(AsmWriter& out, const std::string_view mnemonic, const std::string_view suffix,
+                     const Operand& operand)
+{
+    const u64 operandsStart = beginInstruction(out, mnemonic, suffix);
+    asmOperand(out, operand);
+    endLine(out, operandsStart);
+}
+
+void emitInstruction(AsmWriter& out, const std::string_view mnemonic, const std::string_view suffix,
+                     const Operand& src, const Operand& dst)
+{
+    const u64 operandsStart = beginInstruction(out, mnemonic, suffix);
+    asmOperand(out, src);
+    out.put(", ");
+    asmOperand(out, dst);
+    endLine(out, operandsStart);
+}
+
+void jump(AsmWriter& out, const std::string_view mnemonic, const std::string_view suffix, const Identifier& target)
+{
+    const u64 operandsStart = beginInstruction(out, mnemonic, suffix);
+    out.put(".L");
+    out.put(target.value.text());
+    endLine(out, operandsStart);
+}
+
+struct Mnemonic {
+    std::string_view base;
+    std::string_view suffix;
+};
+
+Mnemonic binaryMnemonic(const BinaryInst::Operator oper, const AsmType type)
+{
+    using Operator = BinaryInst::Operator;
+    if (oper == Operator::BitwiseXor && type == AsmType::Double)
+        return {"xorpd", {}};
+    if (oper == Operator::Mul && type == AsmType::Double)
+        return {"mulsd", {}};
+    if (oper == Operator::DivDouble && type == AsmType::Double)
+        return {"divsd", {}};
+    if (oper == Operator::DivDouble)
+        return {"not set asmBinaryOperator", {}};
+    return {binaryMnemonics[static_cast<size_t>(oper)], typeSuffix(type)};
+}
+
+void staticHeader(AsmWriter& out, const std::string_view name, const bool global, const bool zero,
+                  const std::string_view alignment)
+{
+    if (global)
+        line(out, ".globl", name);
+    line(out, zero ? ".bss" : ".data");
+    line(out, ".align", alignment);
+    label(out, name);
+}
+
+} // namespace
+
 std::string asmProgram(const Program& program)
+{
+    return asmProgram(program, WorkStealingPool(1));
+}
+
+std::string asmProgram(const Program& program, const WorkStealingPool& pool)
 {
     std::string result;
-    for (const std::unique_ptr<TopLevel>& topLevel : program.topLevels) {
-        switch (topLevel->kind) {
-            case TopLevel::Kind::StaticVariable: {
-                const auto var = dynCast<const StaticVariable>(topLevel.get());
-                asmStaticVariable(result, *var);
-                break;
-            }
-            case TopLevel::Kind::StaticConstant: {
-                const auto var = dynCast<const ConstVariable>(topLevel.get());
-                asmStaticConstant(result, *var);
-                break;
-            }
-            case TopLevel::Kind::Function: {
-                const auto function = dynCast<const Function>(topLevel.get());
-                asmFunction(result, *function);
-                break;
-            }
-            case TopLevel::Kind::StaticArray: {
-                const auto array = dynCast<const ArrayVariable>(topLevel.get());
-                asmStaticArray(result, *array);
-                break;
-            }
-            case TopLevel::Kind::StaticString: {
-                const auto str = dynCast<const StringVariable>(topLevel.get());
-                asmStaticString(result, *str);
-                break;
+    {
+        AsmWriter out(result);
+        asmProgram(out, program, pool);
+    }
+    return result;
+}
+
+void asmProgram(AsmWriter& out, const Program& program, const WorkStealingPool& pool)
+{
+    const size_t count = program.topLevels.size();
+    if (pool.threadCount() == 1) {
+        for (const auto& topLevel : program.topLevels) {
+            asmTopLevel(out, *topLevel);
+            out.endTopLevel();
+        }
+    } else {
+        // Formatted in parallel one batch at a time, so only the text of one batch is held.
+        const size_t batchSize = pool.threadCount() * 64;
+        std::vector<std::string> parts(std::min(batchSize, count));
+        for (size_t first = 0; first < count; first += batchSize) {
+            const size_t size = std::min(batchSize, count - first);
+            pool.run(size, [&program, &parts, first](const size_t i) {
+                parts[i].clear();
+                AsmWriter part(parts[i]);
+                asmTopLevel(part, *program.topLevels[first + i]);
+            });
+            for (size_t i = 0; i < size; ++i) {
+                out.put(parts[i]);
+                out.endTopLevel();
             }
-            default:
-                std::abort();
         }
     }
-    result += asmFormatInstruction(".section .note.GNU-stack,\"\",@progbits\n");
-    return result;
+    line(out, ".section .note.GNU-stack,\"\",@progbits\n");
+    out.flush();
 }
 
-void asmStaticString(std::string& result, const StringVariable& variable)
+bool writeAsmProgram(const std::filesystem::path& path, const Program& program, const WorkStealingPool& pool)
 {
-    result += asmFormatInstruction(".section .rodata");
-    result += asmFormatLabel(variable.name);
+    const TimeTrace::Scope scope("emission");
+    const i32 fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+    AsmWriter out(fd);
+    asmProgram(out, program, pool);
+    return ::close(fd) == 0 && !out.failed();
+}
 
-    const std::string escaped_value = genAsmCompatibleString(variable);
+void asmTopLevel(AsmWriter& out, const TopLevel& topLevel)
+{
+    switch (topLevel.kind) {
+        case TopLevel::Kind::StaticVariable:
+            asmStaticVariable(out, *dynCast<const StaticVariable>(&topLevel));
+            break;
+        case TopLevel::Kind::StaticConstant:
+            asmStaticConstant(out, *dynCast<const ConstVariable>(&topLevel));
+            break;
+        case TopLevel::Kind::Function:
+            asmFunction(out, *dynCast<const Function>(&topLevel));
+            break;
+        case TopLevel::Kind::StaticArray:
+            asmStaticArray(out, *dynCast<const ArrayVariable>(&topLevel));
+            break;
+        case TopLevel::Kind::StaticString:
+            asmStaticString(out, *dynCast<const StringVariable>(&topLevel));
+            break;
+        case TopLevel::Kind::EmittedFunction:
+            out.put(dynCast<const EmittedFunction>(&topLevel)->assembly);
+            break;
+        default:
+            std::abort();
+    }
+}
 
+void asmStaticString(AsmWriter& out, const StringVariable& variable)
+{
+    line(out, ".section .rodata");
+    label(out, variable.name.value.text());
+    const std::string escaped = genAsmCompatibleString(variable);
+    const u64 operandsStart = beginInstruction(out, variable.nullTerminated ? ".asciz " : ".ascii \"");
     if (variable.nullTerminated)
-        result += asmFormatInstruction(".asciz ", + "\"" + escaped_value + '\"');
-    else
-        result += asmFormatInstruction(".ascii \"", escaped_value + '\"');
-    result += '\n';
-}
-
-void asmStaticVariable(std::string& result, const StaticVariable& variable)
-{
-    if (variable.type == AsmType::LongWord)
-        return asmStaticVariableLong(result, variable);
-    if (variable.type == AsmType::QuadWord)
-        return asmStaticVariableQuad(result, variable);
-    if (variable.type == AsmType::Double)
-        return asmStaticVariableDouble(result, variable);
-    if (variable.type == AsmType::Byte)
-        return asmStaticVariableByte(result, variable);
-}
-
-void asmStaticVariableByte(std::string& result, const StaticVariable& variable)
-{
-    if (variable.global)
-        result += asmFormatInstruction(".globl", variable.name);
-    if (variable.init == 0)
-        result += asmFormatInstruction(".bss");
-    else
-        result += asmFormatInstruction(".data");
-    result += asmFormatInstruction(".align","1");
-    result += asmFormatLabel(variable.name);
-    if (variable.init == 0)
-        result += asmFormatInstruction(".zero 1");
-    if (variable.init != 0)
-        result += asmFormatInstruction(".byte " + std::to_string(variable.init));
-    result += '\n';
-}
-
-void asmStaticVariableLong(std::string& result, const StaticVariable& variable)
-{
-    if (variable.global)
-        result += asmFormatInstruction(".globl", variable.name);
-    if (variable.init == 0)
-        result += asmFormatInstruction(".bss");
-    else
-        result += asmFormatInstruction(".data");
-    result += asmFormatInstruction(".align","4");
-    result += asmFormatLabel(variable.name);
-    if (variable.init == 0)
-        result += asmFormatInstruction(".zero 4");
-    if (variable.init != 0)
-        result += asmFormatInstruction(".long " + std::to_string(variable.init));
-    result += '\n';
-}
-
-void asmStaticVariableQuad(std::string& result, const StaticVariable& variable)
-{
-    if (variable.global)
-        result += asmFormatInstruction(".globl", variable.name);
-    if (variable.init == 0)
-        result += asmFormatInstruction(".bss");
-    else
-        result += asmFormatInstruction(".data");
-    result += asmFormatInstruction(".align","8");
-    result += asmFormatLabel(variable.name);
-    if (variable.init == 0)
-        result += asmFormatInstruction(".zero 8");
-    if (variable.init != 0)
-        result += asmFormatInstruction(".quad " + std::to_string(variable.init));
-    result += '\n';
-}
-
-void asmStaticVariableDouble(std::string& result, const StaticVariable& variable)
-{
-    if (variable.global)
-        result += asmFormatInstruction(".globl", variable.name);
-    result += asmFormatInstruction(".data");
-    result += asmFormatInstruction(".align","8");
-    result += asmFormatLabel(variable.name);
-    result += asmFormatInstruction(".quad " + std::to_string(variable.init));
-    result += '\n';
-}
-
-void asmStaticConstant(std::string& result, const ConstVariable& variable)
-{
-    result += asmFormatInstruction(".section .rodata");
-    result += asmFormatInstruction(".align",std::to_string(variable.alignment));
-    if (variable.local)
-        result += asmFormatLabel(createLabel(variable.name.value));
-    else
-        result += asmFormatLabel(variable.name.value);
-    result += asmFormatInstruction(".quad "+ std::to_string( std::bit_cast<u64>(variable.staticInit))
-                + " # " + std::to_string(variable.staticInit));
-    result += '\n';
-}
-
-void asmStaticArray(std::string& result, const ArrayVariable& array)
+        out.put('"');
+    out.put(escaped);
+    out.put('"');
+    endLine(out, operandsStart);
+    out.put('\n');
+}
+
+void asmStaticVariable(AsmWriter& out, const StaticVariable& variable)
+{
+    const std::string_view name = variable.name.value.text();
+    switch (variable.type) {
+        case AsmType::Byte:
+            staticHeader(out, name, variable.global, variable.init == 0, "1");
+            if (variable.init == 0)
+                line(out, ".zero 1");
+            else
+                numberLine(out, ".byte ", variable.init);
+            break;
+        case AsmType::LongWord:
+            staticHeader(out, name, variable.global, variable.init == 0, "4");
+            if (variable.init == 0)
+                line(out, ".zero 4");
+            else
+                numberLine(out, ".long ", variable.init);
+            break;
+        case AsmType::QuadWord:
+            staticHeader(out, name, variable.global, variable.init == 0, "8");
+            if (variable.init == 0)
+                line(out, ".zero 8");
+            else
+                numberLine(out, ".quad ", variable.init);
+            break;
+        case AsmType::Double:
+            staticHeader(out, name, variable.global, false, "8");
+            numberLine(out, ".quad ", variable.init);
+            break;
+        default:
+            return;
+    }
+    out.put('\n');
+}
+
+void asmStaticConstant(AsmWriter& out, const ConstVariable& variable)
+{
+    line(out, ".section .rodata");
+    const u64 alignStart = beginInstruction(out, ".align");
+    out.putNumber(variable.alignment);
+    endLine(out, alignStart);
+    label(out, variable.name.value.text(), variable.local);
+    const u64 lineStart = beginLine(out);
+    out.put(".quad ");
+    out.putNumber(std::bit_cast<u64>(variable.staticInit));
+    out.put(" # ");
+    out.put(std::to_string(variable.staticInit));
+    endLine(out, beginOperands(out, lineStart));
+    out.put('\n');
+}
+
+void asmStaticArray(AsmWriter& out, const ArrayVariable& array)
 {
     if (array.isGlobal)
-        result += asmFormatInstruction(".globl", array.name.value);
-    if (array.initializers.size() == 1 && array.initializers.front()->kind == Initializer::Kind::Zero)
-        result += asmFormatInstruction(".bss");
-    else
-        result += asmFormatInstruction(".data");
-    result += asmFormatInstruction(".align", std::to_string(array.alignment));
-    result += asmFormatLabel(array.name.value);
+        line(out, ".globl", array.name.value.text());
+    const bool zero = array.initializers.size() == 1 && array.initializers.front()->kind == Initializer::Kind::Zero;
+    line(out, zero ? ".bss" : ".data");
+    const u64 alignStart = beginInstruction(out, ".align");
+    out.putNumber(array.alignment);
+    endLine(out, alignStart);
+    label(out, array.name.value.text());
     const std::string typeName = '.' + getTypeName(array.type);
     for (const auto& init : array.initializers) {
+        u64 operandsStart = 0;
         switch (init->kind) {
-            case Initializer::Kind::Zero: {
-                const auto zero = dynCast<const ZeroInitializer>(init.get());
-                result += asmFormatInstruction(
-                    ".zero",
-                    std::to_string(zero->size * Operators::getSizeAsmType(array.type)));
+            case Initializer::Kind::Zero:
+                operandsStart = beginInstruction(out, ".zero");
+                out.putNumber(dynCast<const ZeroInitializer>(init.get())->size *
+                              Operators::getSizeAsmType(array.type));
                 break;
-            }
-            case Initializer::Kind::Value: {
-                const auto value = dynCast<ValueInitializer>(init.get());
-                result += asmFormatInstruction(typeName, std::to_string(value->init));
+            case Initializer::Kind::Value:
+                operandsStart = beginInstruction(out, typeName);
+                out.putNumber(dynCast<const ValueInitializer>(init.get())->init);
                 break;
-            }
         }
+        endLine(out, operandsStart);
     }
-    result += '\n';
+    out.put('\n');
 }
 
 void asmFunction(std::string& result, const Function& functionNode)
 {
+    AsmWriter out(result);
+    asmFunction(out, functionNode);
+}
+
+void asmFunction(AsmWriter& out, const Function& functionNode)
+{
+    const TimeTrace::FunctionScope scope("emission", functionNode.name.value.text());
+    const std::string_view name = functionNode.name.value.text();
     if (functionNode.isGlobal)
-        result += asmFormatInstruction(".globl", functionNode.name);
-    result += asmFormatInstruction(".text");
-    result += asmFormatLabel(functionNode.name);
-    result += asmFormatInstruction("pushq", "%rbp");
-    result += asmFormatInstruction("movq","%rsp, %rbp");
-    for (const std::unique_ptr<Inst>& inst : functionNode.instructions)
-        asmInstruction(result, inst);
-    result += '\n';
+        line(out, ".globl", name);
+    line(out, ".text");
+    label(out, name);
+    line(out, "pushq", "%rbp");
+    line(out, "movq", "%rsp, %rbp");
+    for (const Inst* inst : functionNode.instructions)
+        asmInstruction(out, *inst);
+    out.put('\n');
 }
 
-void asmInstruction(std::string& result, const std::unique_ptr<Inst>& instruction)
+void asmInstruction(AsmWriter& out, const Inst& instruction)
 {
-    switch (instruction->kind) {
+    switch (instruction.kind) {
         case Inst::Kind::Move: {
-            const auto moveInst = dynCast<MoveInst>(instruction.get());
-            const std::string operand = asmOperand(moveInst->src) + ", " + asmOperand(moveInst->dst);
-            result += asmFormatInstruction(addType("mov", moveInst->type), operand);
+            const auto moveInst = dynCast<const MoveInst>(&instruction);
+            emitInstruction(out, "mov", typeSuffix(moveInst->type), moveInst->src, moveInst->dst);
             return;
         }
         case Inst::Kind::MoveSX: {
-            const auto moveSXInst = dynCast<MoveSXInst>(instruction.get());
-            const std::string operands = asmOperand(moveSXInst->src) + ", " + asmOperand(moveSXInst->dst);
-            result += asmFormatInstruction(addType(
-                    addType("movs", moveSXInst->srcType),
-                    moveSXInst->dstType),
-                operands);
+            const auto moveSXInst = dynCast<const MoveSXInst>(&instruction);
+            const u64 lineStart = beginLine(out);
+            out.put("movs");
+            out.put(typeSuffix(moveSXInst->srcType));
+            out.put(typeSuffix(moveSXInst->dstType));
+            const u64 operandsStart = beginOperands(out, lineStart);
+            asmOperand(out, moveSXInst->src);
+            out.put(", ");
+            asmOperand(out, moveSXInst->dst);
+            endLine(out, operandsStart);
             return;
         }
         case Inst::Kind::MoveZeroExtend: {
-            const auto moveZeroExtend = dynCast<MoveZeroExtendInst>(instruction.get());
-            const std::string operands = asmOperand(moveZeroExtend->src) + ", " + asmOperand(moveZeroExtend->dst);
-            result += asmFormatInstruction(
-                addType(
-                    addType("movz", moveZeroExtend->srcType),
-                    moveZeroExtend->dstType),
-                operands);
+            const auto moveZeroExtend = dynCast<const MoveZeroExtendInst>(&instruction);
+            const u64 lineStart = beginLine(out);
+            out.put("movz");
+            out.put(typeSuffix(moveZeroExtend->srcType));
+            out.put(typeSuffix(moveZeroExtend->dstType));
+            const u64 operandsStart = beginOperands(out, lineStart);
+            asmOperand(out, moveZeroExtend->src);
+            out.put(", ");
+            asmOperand(out, moveZeroExtend->dst);
+            endLine(out, operandsStart);
             return;
         }
         case Inst::Kind::Lea: {
-            const auto lea = dynCast<const LeaInst>(instruction.get());
-            const std::string operands = asmOperand(lea->src) + ", " + asmOperand(lea->dst);
-            result += asmFormatInstruction(addType("lea", lea->type), operands);
+            const auto lea = dynCast<const LeaInst>(&instruction);
+            emitInstruction(out, "lea", typeSuffix(lea->type), lea->src, lea->dst);
             return;
         }
         case Inst::Kind::Cvtsi2sd: {
-            const auto cvtsi2sd = dynCast<Cvtsi2sdInst>(instruction.get());
-            const AsmType type = cvtsi2sd->srcType;
-            const std::string operands = asmOperand(cvtsi2sd->src) + ", " + asmOperand(cvtsi2sd->dst);
-            result += asmFormatInstruction(addType("cvtsi2sd", type), operands);
+            const auto cvtsi2sd = dynCast<const Cvtsi2sdInst>(&instruction);
+            emitInstruction(out, "cvtsi2sd", typeSuffix(cvtsi2sd->srcType), cvtsi2sd->src, cvtsi2sd->dst);
             return;
         }
         case Inst::Kind::Cvttsd2si: {
-            const auto cvtsd2siInst = dynCast<Cvttsd2siInst>(instruction.get());
-            const AsmType type = cvtsd2siInst->dstType;
-            const std::string operands = asmOperand(cvtsd2siInst->src) + ", " + asmOperand(cvtsd2siInst->dst);
-            result += asmFormatInstruction(addType("cvttsd2si", type), operands);
+            const auto cvtsd2siInst = dynCast<const Cvttsd2siInst>(&instruction);
+            emitInstruction(out, "cvttsd2si", typeSuffix(cvtsd2siInst->dstType), cvtsd2siInst->src, cvtsd2siInst->dst);
             return;
         }
         case Inst::Kind::Unary: {
-            const auto unaryInst = dynCast<UnaryInst>(instruction.get());
-            result += asmFormatInstruction(
-                asmUnaryOperator(unaryInst->oper, unaryInst->type),
-                asmOperand(unaryInst->destination));
+            const auto unaryInst = dynCast<const UnaryInst>(&instruction);
+            emitInstruction(out, unaryMnemonics[static_cast<size_t>(unaryInst->oper)], typeSuffix(unaryInst->type),
+                            unaryInst->destination);
             return;
         }
         case Inst::Kind::Binary: {
-            const auto binaryInst = dynCast<BinaryInst>(instruction.get());
-            const std::string operands = asmOperand(binaryInst->lhs) + ", " + asmOperand(binaryInst->rhs);
-            result += asmFormatInstruction(asmBinaryOperator(binaryInst->oper, binaryInst->type), operands);
+            const auto binaryInst = dynCast<const BinaryInst>(&instruction);
+            const Mnemonic mnemonic = binaryMnemonic(binaryInst->oper, binaryInst->type);
+            emitInstruction(out, mnemonic.base, mnemonic.suffix, binaryInst->lhs, binaryInst->rhs);
             return;
         }
         case Inst::Kind::Cdq: {
-            const auto cdqInst = dynCast<CdqInst>(instruction.get());
+            const auto cdqInst = dynCast<const CdqInst>(&instruction);
             if (cdqInst->type == AsmType::LongWord)
-                result += asmFormatInstruction("cdq");
+                line(out, "cdq");
             if (cdqInst->type == AsmType::QuadWord)
-                result += asmFormatInstruction("cqo");
+                line(out, "cqo");
             return;
         }
         case Inst::Kind::Idiv: {
-            const auto idivInst = dynCast<IdivInst>(instruction.get());
-            result += asmFormatInstruction(addType(
-                "idiv", idivInst->type), asmOperand(idivInst->operand));
+            const auto idivInst = dynCast<const IdivInst>(&instruction);
+            emitInstruction(out, "idiv", typeSuffix(idivInst->type), idivInst->operand);
             return;
         }
         case Inst::Kind::Div: {
-            const auto divInst = dynCast<DivInst>(instruction.get());
+            const auto divInst = dynCast<const DivInst>(&instruction);
             if (divInst->type == AsmType::LongWord)
-                result += asmFormatInstruction("divl", asmOperand(divInst->operand));
+                emitInstruction(out, "divl", {}, divInst->operand);
             if (divInst->type == AsmType::QuadWord)
-                result += asmFormatInstruction("divq", asmOperand(divInst->operand));
+                emitInstruction(out, "divq", {}, divInst->operand);
             return;
         }
         case Inst::Kind::Ret: {
-            result += asmFormatInstruction("movq", "%rbp, %rsp");
-            result += asmFormatInstruction("popq", "%rbp");
-            result += asmFormatInstruction("ret");
+            line(out, "movq", "%rbp, %rsp");
+            line(out, "popq", "%rbp");
+            line(out, "ret");
             return;
         }
         case Inst::Kind::Cmp: {
-            const auto cmpInst = dynCast<CmpInst>(instruction.get());
-            const std::string operands = asmOperand(cmpInst->lhs) + ", " + asmOperand(cmpInst->rhs);
-            if (cmpInst->lhs->type == AsmType::Double)
-                result += asmFormatInstruction("comisd", operands);
+            const auto cmpInst = dynCast<const CmpInst>(&instruction);
+            if (cmpInst->lhs.type == AsmType::Double)
+                emitInstruction(out, "comisd", {}, cmpInst->lhs, cmpInst->rhs);
             else
-                result += asmFormatInstruction(addType("cmp", cmpInst->lhs->type), operands);
+                emitInstruction(out, "cmp", typeSuffix(cmpInst->lhs.type), cmpInst->lhs, cmpInst->rhs);
             return;
         }
         case Inst::Kind::Jmp: {
-            const auto jmpInst = dynCast<JmpInst>(instruction.get());
-            result += asmFormatInstruction("jmp", createLabel(jmpInst->target.value));
+            jump(out, "jmp", {}, dynCast<const JmpInst>(&instruction)->target);
             return;
         }
         case Inst::Kind::JmpCC: {
-            const auto jmpCCInst = dynCast<JmpCCInst>(instruction.get());
-            result += asmFormatInstruction(
-                "j" + condCode(jmpCCInst->condition), createLabel(jmpCCInst->target.value));
+            const auto jmpCCInst = dynCast<const JmpCCInst>(&instruction);
+            jump(out, "j", condCodeName(jmpCCInst->condition), jmpCCInst->target);
             return;
         }
         case Inst::Kind::SetCC: {
-            const auto setCCInst = dynCast<SetCCInst>(instruction.get());
-            result += asmFormatInstruction(
-                "set" + condCode(setCCInst->condition), asmOperand(setCCInst->operand));
+            const auto setCCInst = dynCast<const SetCCInst>(&instruction);
+            emitInstruction(out, "set", condCodeName(setCCInst->condition), setCCInst->operand);
             return;
         }
         case Inst::Kind::Label: {
-            const auto labelInst = dynCast<LabelInst>(instruction.get());
-            result += asmFormatLabel(createLabel(labelInst->target.value));
+            label(out, dynCast<const LabelInst>(&instruction)->target.value.text(), true);
             return;
         }
         case Inst::Kind::Push: {
-            const auto pushInst = dynCast<PushInst>(instruction.get());
-            result += asmFormatInstruction("pushq", asmOperand(pushInst->operand));
+            emitInstruction(out, "pushq", {}, dynCast<const PushInst>(&instruction)->operand);
             return;
         }
         case Inst::Kind::Call: {
-            const auto callInst = dynCast<CallInst>(instruction.get());
-            result += asmFormatInstruction("call", callInst->funName.value);
+            line(out, "call", dynCast<const CallInst>(&instruction)->funName.value.text());
             return;
         }
         default:
-            result += asmFormatInstruction("not set asmInstruction");
+            line(out, "not set asmInstruction");
     }
 }
 
-std::string asmOperand(const std::shared_ptr<Operand>& operand)
+void asmOperand(AsmWriter& out, const Operand& operand)
 {
-    switch (operand->kind) {
-        case Operand::Kind::Register: {
-            const auto registerOperand = dynCast<RegisterOperand>(operand.get());
-            return asmRegister(registerOperand->type, registerOperand->regKind);
-        }
+    switch (operand.kind) {
+        case Operand::Kind::Register:
+            out.put(registerName(operand.type, operand.regKind));
+            return;
         case Operand::Kind::Pseudo:
-            return "invalid pseudo";
-        case Operand::Kind::Imm: {
-            const auto immOperand = dynCast<ImmOperand>(operand.get());
-            return "$" + std::to_string(immOperand->value);
-        }
-        case Operand::Kind::Memory: {
-            const auto moveOperand = dynCast<const MemoryOperand>(operand.get());
-            if (moveOperand->value != 0)
-                return std::to_string(moveOperand->value) + "(" +
-                            asmRegister(moveOperand->type, moveOperand->regKind) + ")";
-            return "(" + asmRegister(moveOperand->type, moveOperand->regKind) + ")";
-        }
-        case Operand::Kind::Data: {
-            const auto dataOperand = dynCast<DataOperand>(operand.get());
-            if (dataOperand->local && dataOperand->type == AsmType::Double)
-                return createLabel(dataOperand->identifier.value) + "(%rip)";
-            return dataOperand->identifier.value + "(%rip)";
-        }
-        case Operand::Kind::Indexed: {
-            const auto indexedOperand = dynCast<IndexedOperand>(operand.get());
-            return "(" + asmRegister(indexedOperand->type, indexedOperand->regKind) + ", " +
-                         asmRegister(indexedOperand->type, indexedOperand->indexRegKind) + ", " +
-                            std::to_string(indexedOperand->scale) + ")";
-        }
+            out.put("invalid pseudo");
+            return;
+        case Operand::Kind::Imm:
+            out.put('$');
+            out.putNumber(operand.value);
+            return;
+        case Operand::Kind::Memory:
+            if (operand.offset != 0)
+                out.putNumber(operand.offset);
+            out.put('(');
+            out.put(registerName(operand.type, operand.regKind));
+            out.put(')');
+            return;
+        case Operand::Kind::Data:
+            if (operand.local && operand.type == AsmType::Double)
+                out.put(".L");
+            out.put(operand.identifier.value.text());
+            out.put("(%rip)");
+            return;
+        case Operand::Kind::Indexed:
+            out.put('(');
+            out.put(registerName(operand.type, operand.regKind));
+            out.put(", ");
+            out.put(registerName(operand.type, operand.indexRegKind));
+            out.put(", ");
+            out.putNumber(operand.scale);
+            out.put(')');
+            return;
         default:
-            return "not set asmOperand";
+            out.put("not set asmOperand");
     }
 }
 
+std::string asmOperand(const Operand& operand)
+{
+    std::string result;
+    AsmWriter out(result);
+    asmOperand(out, operand);
+    return result;
+}
+
 std::string asmRegister(const AsmType& type, const Operand::RegKind reg)
 {
-    using Type = Operand::RegKind;
-    if (reg == Type::BP)
-        return "%rbp";
-    switch (reg) {
-        case Type::XMM0: return "%xmm0";
-        case Type::XMM1: return "%xmm1";
-        case Type::XMM2: return "%xmm2";
-        case Type::XMM3: return "%xmm3";
-        case Type::XMM4: return "%xmm4";
-        case Type::XMM5: return "%xmm5";
-        case Type::XMM6: return "%xmm6";
-        case Type::XMM7: return "%xmm7";
-        case Type::XMM14: return "%xmm14";
-        case Type::XMM15: return "%xmm15";
-            default:
-            break;
-    }
-    static const std::unordered_map<Type, std::array<std::string, 4>> registerMap = {
-        {Type::AX,  {"%al",   "%ax",   "%eax",  "%rax"}},
-        {Type::CX,  {"%cl",   "%cx",   "%ecx",  "%rcx"}},
-        {Type::DX,  {"%dl",   "%dx",   "%edx",  "%rdx"}},
-        {Type::DI,  {"%dil",  "%di",   "%edi",  "%rdi"}},
-        {Type::SI,  {"%sil",  "%si",   "%esi",  "%rsi"}},
-        {Type::R8,  {"%r8b",  "%r8w",  "%r8d",  "%r8"}},
-        {Type::R9,  {"%r9b",  "%r9w",  "%r9d",  "%r9"}},
-        {Type::R10, {"%r10b", "%r10w", "%r10d", "%r10"}},
-        {Type::R11, {"%r11b", "%r11w", "%r11d", "%r11"}},
-        {Type::SP,  {"%rsp",  "%rsp",  "%rsp",  "%rsp"}}
-    };
-
-    const auto it = registerMap.find(reg);
-    if (it == registerMap.end())
-        return "invalid_register";
-
-    const auto& names = it->second;
-    switch (type) {
-        case AsmType::Byte:     return names[0];
-        case AsmType::Word:     return names[1];
-        case AsmType::LongWord: return names[2];
-        case AsmType::QuadWord: return names[3];
-        default: return "invalid_size";
-    }
+    return std::string(registerName(type, reg));
 }
 
 std::string asmUnaryOperator(const UnaryInst::Operator oper, const AsmType type)
 {
-    using Operator = UnaryInst::Operator;
-    switch (oper) {
-        case Operator::Neg:      return addType("neg", type);
-        case Operator::Not:      return addType("not", type);
-        case Operator::Shr:      return addType("shr", type);
-        default:                 return "not set asmUnaryOperator";
-    }
+    return addType(std::string(unaryMnemonics[static_cast<size_t>(oper)]), type);
 }
 
 std::string asmBinaryOperator(const BinaryInst::Operator oper, const AsmType type)
 {
-    using Operator = BinaryInst::Operator;
-    if (oper == Operator::BitwiseXor && type == AsmType::Double)
-        return "xorpd";
-    if (oper == Operator::Mul && type == AsmType::Double)
-        return "mulsd";
-    if (oper == Operator::DivDouble && type == AsmType::Double)
-        return "divsd";
-    switch (oper) {
-        case Operator::Mul:                 return addType("imul", type);
-        case Operator::Add:                 return addType("add", type);
-        case Operator::Sub:                 return addType("sub", type);
-
-        case Operator::BitwiseAnd:          return addType("and", type);
-        case Operator::BitwiseOr:           return addType("or", type);
-        case Operator::BitwiseXor:          return addType("xor" ,type);
-
-        case Operator::LeftShiftSigned:     return addType("shl", type);
-        case Operator::LeftShiftUnsigned:   return addType("sal", type);
-        case Operator::RightShiftSigned:    return addType("sar", type);
-        case Operator::RightShiftUnsigned:  return addType("shr", type);
-        default:
-            return "not set asmBinaryOperator";
-    }
+    const Mnemonic mnemonic = binaryMnemonic(oper, type);
+    return std::string(mnemonic.base) + std::string(mnemonic.suffix);
 }
 
 std::string asmFormatLabel(const std::string& name)
@@ -459,50 +579,12 @@ std::string createLabel(const std::string& name)
 
 std::string condCode(const BinaryInst::CondCode condCode)
 {
-    using CondCode = BinaryInst::CondCode;
-    switch (condCode) {
-        case CondCode::E:   return "e";
-        case CondCode::NE:  return "ne";
-        case CondCode::L:   return "l";
-        case CondCode::LE:  return "le";
-        case CondCode::G:   return "g";
-        case CondCode::GE:  return "ge";
-        case CondCode::A:   return "a";
-        case CondCode::AE:  return "ae";
-        case CondCode::B:   return "b";
-        case CondCode::BE:  return "be";
-        case CondCode::PF:  return "p";
-        default:
-            return "not set condCode";
-    }
-}
-
-std::string asmFormatInstruction(const std::string& mnemonic,
-                                 const std::string& operands,
-                                 const std::string& comment)
-{
-    constexpr int mnemonicWidth = 12;
-    constexpr int operandsWidth = 16;
-
-    std::ostringstream oss;
-    oss << "    " << std::left << std::setw(mnemonicWidth) << mnemonic
-        << std::setw(operandsWidth) << operands;
-    if (!comment.empty())
-        oss << "# " << comment;
-    oss << "\n";
-    return oss.str();
+    return std::string(condCodeName(condCode));
 }
 
 std::string addType(const std::string& instruction, const AsmType type)
 {
-    switch (type) {
-        case AsmType::Byte:         return instruction + "b";
-        case AsmType::LongWord:     return instruction + "l";
-        case AsmType::QuadWord:     return instruction + "q";
-        case AsmType::Double:       return instruction + "sd";
-        default:
-            return instruction + " not set addType";
-    }
+    return instruction + std::string(typeSuffix(type));
 }
 
 std::string getTypeName(const AsmType type)
@@ -533,4 +615,4 @@ std::string genAsmCompatibleString(const StringVariable& variable)
     return escaped_value;
 }
 
-} // CodeGen
\ No newline at end of file
+} // CodeGen
@@ -1,33 +1,37 @@
 #pragma once
 
 #include "AsmAST.hpp"
+#include "AsmWriter.hpp"
 #include "ASTIr.hpp"
+#include "WorkStealingPool.hpp"
+
+#include <filesystem>
 
 namespace CodeGen {
 
 std::string asmProgram(const Program& program);
+std::string asmProgram(const Program& program, const WorkStealingPool& pool);
+void asmProgram(AsmWriter& out, const Program& program, const WorkStealingPool& pool);
+[[nodiscard]] bool writeAsmProgram(const std::filesystem::path& path, const Program& program,
+                                   const WorkStealingPool& pool);
+void asmTopLevel(AsmWriter& out, const TopLevel& topLevel);
 void asmFunction(std::string& result, const Function& functionNode);
-void asmStaticVariable(std::string& result, const StaticVariable& variable);
-void asmStaticVariableByte(std::string& result, const StaticVariable& variable);
-void asmStaticVariableLong(std::string& result, const StaticVariable& variable);
-void asmStaticVariableQuad(std::string& result, const StaticVariable& variable);
-void asmStaticVariableDouble(std::string& result, const StaticVariable& variable);
-void asmStaticConstant(std::string& result, const ConstVariable& variable);
-void asmStaticArray(std::string& result, const ArrayVariable& array);
-void asmStaticString(std::string& result, const StringVariable& variable);
-void asmInstruction(std::string& result, const std::unique_ptr<Inst>& instruction);
-std::string asmOperand(const std::shared_ptr<Operand>& operand);
+void asmFunction(AsmWriter& out, const Function& functionNode);
+void asmStaticVariable(AsmWriter& out, const StaticVariable& variable);
+void asmStaticConstant(AsmWriter& out, const ConstVariable& variable);
+void asmStaticArray(AsmWriter& out, const ArrayVariable& array);
+void asmStaticString(AsmWriter& out, const StringVariable& variable);
+void asmInstruction(AsmWriter& out, const Inst& instruction);
+void asmOperand(AsmWriter& out, const Operand& operand);
+std::string asmOperand(const Operand& operand);
 std::string asmRegister(const AsmType& type, Operand::RegKind reg);
 std::string asmUnaryOperator(UnaryInst::Operator oper, AsmType type);
 std::string asmBinaryOperator(BinaryInst::Operator oper, AsmType type);
 std::string asmFormatLabel(const std::string& name);
-std::string asmFormatInstruction(const std::string& mnemonic,
-                                 const std::string& operands = "",
-                                 const std::string& comment = "");
 std::string createLabel(const std::string& name);
 std::string addType(const std::string& instruction, AsmType type);
 std::string condCode(BinaryInst::CondCode condCode);
 std::string getTypeName(AsmType type);
 std::string genAsmCompatibleString(const StringVariable& variable);
 
-} // CodeGen
\ No newline at end of file
+} // CodeGen
@@ -1,111 +1,156 @@
 #include "CodeGenDriver.hpp"
 #include "AsmPrinter.hpp"
 #include "Assembly.hpp"
+#include "ElfWriter.hpp"
 #include "FixUpInstructions.hpp"
 #include "GenerateAsmTree.hpp"
-#include "PseudoRegisterReplacer.hpp"
+#include "JitImage.hpp"
+#include "ObjectEmitter.hpp"
+#include "TimeTrace.hpp"
 
+#include <cstdio>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
 
+#include <unistd.h>
+
 namespace CodeGen {
 
-void run(const Ir::Program& irProgram,
-         const std::string& argument,
-         const std::string& inputFile)
+StateCode run(const Ir::Program& irProgram,
+              const std::string& argument,
+              const std::string& inputFile,
+              const std::vector<std::string>& libraries,
+              const WorkStealingPool& pool)
 {
-    Program codegenProgram = codegen(irProgram);
+    Program codegenProgram = codegen(irProgram, pool);
     if (argument == "--codegen")
-        return;
+        return StateCode::Done;
     if (argument == "--printAsm") {
         AsmPrinter printer;
         std::cout << printer.printProgram(codegenProgram);
-        return;
+        return StateCode::Done;
     }
-    fixAsm(codegenProgram);
+    fixAsm(codegenProgram, pool);
     if (argument == "--printAsmAfter") {
         AsmPrinter printer;
         std::cout << printer.printProgram(codegenProgram);
-        return;
+        return StateCode::Done;
+    }
+    if (argument == "--assemble") {
+        if (writeAsmFile(inputFile, codegenProgram, pool).empty())
+            return StateCode::AsmFileWrite;
+        return StateCode::Done;
+    }
+    const ObjectModule object = emitObject(codegenProgram, pool);
+    const std::string outputFile = inputFile.substr(0, inputFile.length() - 2);
+    if (argument == "-c") {
+        if (!writeObjectFile(outputFile + ".o", object)) {
+            std::cerr << "Error: Could not write object file " << outputFile << ".o\n";
+            return StateCode::ObjectFileWrite;
+        }
+        return StateCode::Done;
     }
-    std::string output = asmProgram(codegenProgram);
-    std::string outputFileName = writeAsmFile(inputFile, output);
-    if (argument == "--assemble")
-        return;
-    if (argument == "-c")
-        makeLib(outputFileName, inputFile.substr(0, inputFile.length() - 2));
-    else if (argument.starts_with("-l"))
-        linkLib(outputFileName, inputFile.substr(0, inputFile.length() - 2), argument);
-    else
-        assemble(outputFileName, inputFile.substr(0, inputFile.length() - 2));
+    const std::filesystem::path objectFile = std::filesystem::temp_directory_path() /
+        (std::filesystem::path(inputFile).stem().string() + '-' + std::to_string(getpid()) + ".o");
+    if (!writeObjectFile(objectFile, object)) {
+        std::cerr << "Error: Could not write object file " << objectFile.string() << '\n';
+        return StateCode::ObjectFileWrite;
+    }
+    StateCode result = StateCode::Done;
+    if (!linkObjects({objectFile}, outputFile, libraries)) {
+        std::cerr << "Error: Could not link " << outputFile << '\n';
+        result = StateCode::Link;
+    }
+    std::filesystem::remove(objectFile);
+    return result;
+}
+
+StateCode runJit(const Ir::Program& irProgram, i32& exitCode)
+{
+    Program codegenProgram = codegen(irProgram, WorkStealingPool(1));
+    fixAsm(codegenProgram);
+    const ObjectModule object = emitObject(codegenProgram);
+    JitImage image;
+    std::vector<std::string> errors = image.load(object);
+    void* entry = image.symbolAddress("main");
+    if (errors.empty() && entry == nullptr)
+        errors.emplace_back("no definition of 'main'");
+    if (!errors.empty()) {
+        for (const std::string& error : errors)
+            std::cerr << "Error: " << error << '\n';
+        return StateCode::Jit;
+    }
+    image.writePerfMap();
+    using MainFunction = i32 (*)();
+    exitCode = reinterpret_cast<MainFunction>(entry)();
+    std::fflush(nullptr);
+    return StateCode::Done;
+}
+
+bool compileToObject(const Ir::Program& irProgram, const std::filesystem::path& objectFile)
+{
+    Program codegenProgram = codegen(irProgram, WorkStealingPool(1));
+    fixAsm(codegenProgram);
+    return writeObjectFile(objectFile, emitObject(codegenProgram));
 }
 
-Program codegen(const Ir::Program& irProgram)
+Program codegen(const Ir::Program& irProgram, const WorkStealingPool& pool)
 {
+    const TimeTrace::Scope scope("GenerateAsmTree");
     Program codegenProgram;
     GenerateAsmTree generateAsmTree;
-    generateAsmTree.genProgram(irProgram, codegenProgram);
+    generateAsmTree.genProgram(irProgram, codegenProgram, pool);
     return codegenProgram;
 }
 
-i32 replacingPseudoRegisters(const Function& function)
+void fixUpInstructions(Function& function)
 {
-    PseudoRegisterReplacer pseudoRegisterReplacer;
-    for (const auto& inst : function.instructions)
-        inst->accept(pseudoRegisterReplacer);
-    return pseudoRegisterReplacer.stackPointer();
+    const TimeTrace::FunctionScope scope("fixAsm", function.name.value.text());
+    FixUpInstructions fixUpInstructions(function.instructions, function.pool);
+    fixUpInstructions.fixUp();
+    function.stackAlloc = fixUpInstructions.stackPointer();
 }
 
-void fixUpInstructions(Function& function, const i32 stackAlloc)
+void fixAsm(const Program& codegenProgram)
 {
-    FixUpInstructions fixUpInstructions(function.instructions, stackAlloc);
-    fixUpInstructions.fixUp();
+    fixAsm(codegenProgram, WorkStealingPool(1));
 }
 
-void fixAsm(const Program& codegenProgram)
+void fixAsm(const Program& codegenProgram, const WorkStealingPool& pool)
 {
-    for (auto& topLevel : codegenProgram.topLevels) {
+    const TimeTrace::Scope scope("fixAsm");
+    pool.run(codegenProgram.topLevels.size(), [&codegenProgram](const size_t i) {
+        TopLevel* topLevel = codegenProgram.topLevels[i].get();
         if (topLevel->kind != TopLevel::Kind::Function)
-            continue;
-        const auto function = dynamic_cast<Function*>(topLevel.get());
-        const i32 stackAlloc = replacingPseudoRegisters(*function);
-        fixUpInstructions(*function, stackAlloc);
-    }
+            return;
+        const auto function = dynamic_cast<Function*>(topLevel);
+        fixUpInstructions(*function);
+    });
 }
 
-std::string writeAsmFile(const std::string& inputFile, const std::string& output)
+std::string writeAsmFile(const std::string& inputFile, const Program& program, const WorkStealingPool& pool)
 {
-    std::string stem = std::filesystem::path(inputFile).stem().string();
-    const std::string inputFolder = std::filesystem::path(inputFile).parent_path().string();
     std::filesystem::path inputPath(inputFile);
     std::filesystem::path outputPath = inputPath.parent_path() / (inputPath.stem().string() + ".s");
     std::string outputFileName = outputPath.string();
-    std::ofstream ofs(outputFileName);
-    if (!ofs) {
+    if (!writeAsmProgram(outputPath, program, pool)) {
         std::cerr << "Error: Could not open output file " << outputFileName << '\n';
-        return outputFileName;
+        return {};
     }
-    ofs << output;
-    ofs.close();
     return outputFileName;
 }
 
-void assemble(const std::string& asmFile, const std::string& outputFile)
-{
-    const std::string command = "gcc " + asmFile + " -o " + outputFile;
-    std::system(command.c_str());
-}
-
-void linkLib(const std::string& asmFile, const std::string& outputFile, const std::string& argument)
-{
-    const std::string command = "gcc " + asmFile + " -o " + outputFile + " " + argument;
-    std::system(command.c_str());
-}
-
-void makeLib(const std::string& asmFile, const std::string& outputFile)
+bool linkObjects(const std::vector<std::filesystem::path>& objectFiles,
+                 const std::string& outputFile,
+                 const std::vector<std::string>& libraries)
 {
-    const std::string command = "gcc -c " + asmFile + " -o " + outputFile + ".o";
-    std::system(command.c_str());
+    const TimeTrace::Scope scope("gcc");
+    std::string command = "gcc";
+    for (const std::filesystem::path& objectFile : objectFiles)
+        command += " " + objectFile.string();
+    command += " -o " + outputFile;
+    for (const std::string& library : libraries)
+        command += " " + library;
+    return std::system(command.c_str()) == 0;
 }
 } // CodeGen
\ No newline at end of file
@@ -3,17 +3,26 @@
 #include "AsmAST.hpp"
 #include "ASTIr.hpp"
 #include "ShortTypes.hpp"
+#include "StateCode.hpp"
+#include "WorkStealingPool.hpp"
+
+#include <filesystem>
+#include <vector>
 
 namespace CodeGen {
 
-void run(const Ir::Program& irProgram, const std::string& argument, const std::string& inputFile);
-[[nodiscard]] i32 replacingPseudoRegisters(const Function& function);
-void fixUpInstructions(Function& function, i32 stackAlloc);
+[[nodiscard]] StateCode run(const Ir::Program& irProgram, const std::string& argument, const std::string& inputFile,
+                            const std::vector<std::string>& libraries, const WorkStealingPool& pool);
+[[nodiscard]] StateCode runJit(const Ir::Program& irProgram, i32& exitCode);
+[[nodiscard]] bool compileToObject(const Ir::Program& irProgram, const std::filesystem::path& objectFile);
+[[nodiscard]] bool linkObjects(const std::vector<std::filesystem::path>& objectFiles,
+                               const std::string& outputFile,
+                               const std::vector<std::string>& libraries);
+void fixUpInstructions(Function& function);
 void fixAsm(const Program& codegenProgram);
-static Program codegen(const Ir::Program& irProgram);
-static void assemble(const std::string& asmFile, const std::string& outputFile);
-static void linkLib(const std::string& asmFile, const std::string& outputFile, const std::string& argument);
-static void makeLib(const std::string& asmFile, const std::string& outputFile);
-std::string writeAsmFile(const std::string& inputFile, const std::string& output);
+void fixAsm(const Program& codegenProgram, const WorkStealingPool& pool);
+[[nodiscard]] Program codegen(const Ir::Program& irProgram, const WorkStealingPool& pool);
+// Returns the name of the written file, empty if it could not be opened.
+std::string writeAsmFile(const std::string& inputFile, const Program& program, const WorkStealingPool& pool);
 
 } // CodeGen
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "ElfWriter.hpp"
+#include "TimeTrace.hpp"
+
+#include <elf.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+
+namespace CodeGen {
+
+namespace {
+
+using SectionKind = ObjectModule::SectionKind;
+
+enum SectionIndex : u16 {
+    Null, Text, Data, Bss, Rodata, RelaText, SymTab, StrTab, ShStrTab, NoteGnuStack, Count
+};
+
+struct SectionInfo {
+    std::string_view name;
+    u32 type;
+    u64 flags;
+};
+
+constexpr std::array<SectionInfo, Count> sectionInfos{{
+    {"", SHT_NULL, 0},
+    {".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR},
+    {".data", SHT_PROGBITS, SHF_ALLOC | SHF_WRITE},
+    {".bss", SHT_NOBITS, SHF_ALLOC | SHF_WRITE},
+    {".rodata", SHT_PROGBITS, SHF_ALLOC},
+    {".rela.text", SHT_RELA, SHF_INFO_LINK},
+    {".symtab", SHT_SYMTAB, 0},
+    {".strtab", SHT_STRTAB, 0},
+    {".shstrtab", SHT_STRTAB, 0},
+    {".note.GNU-stack", SHT_PROGBITS, 0},
+}};
+
+u16 sectionIndex(const SectionKind kind)
+{
+    switch (kind) {
+        case SectionKind::Text:     return Text;
+        case SectionKind::Data:     return Data;
+        case SectionKind::Bss:      return Bss;
+        case SectionKind::Rodata:   return Rodata;
+        default:                    return SHN_UNDEF;
+    }
+}
+
+class StringTable {
+    std::vector<u8> m_bytes{0};
+public:
+    u32 add(const std::string_view text)
+    {
+        const auto offset = static_cast<u32>(m_bytes.size());
+        m_bytes.insert(m_bytes.end(), text.begin(), text.end());
+        m_bytes.push_back(0);
+        return offset;
+    }
+    [[nodiscard]] const std::vector<u8>& bytes() const { return m_bytes; }
+};
+
+template<typename T>
+void append(std::vector<u8>& out, const T& value)
+{
+    const size_t offset = out.size();
+    out.resize(offset + sizeof(T));
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+void appendBytes(std::vector<u8>& out, const std::vector<u8>& bytes)
+{
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+void alignTo(std::vector<u8>& out, const u64 alignment)
+{
+    out.resize((out.size() + alignment - 1) / alignment * alignment);
+}
+
+} // namespace
+
+std::vector<u8> elfObject(const ObjectModule& module)
+{
+    // Locals have to precede globals in the symbol table, the section symbols come first.
+    // Like gas, .L labels stay out of the table and relocations against locals use the section symbol.
+    StringTable strTab;
+    std::vector<Elf64_Sym> symbols(1 + ObjectModule::sectionCount);
+    for (u16 i = 0; i < ObjectModule::sectionCount; ++i) {
+        symbols[1 + i].st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+        symbols[1 + i].st_shndx = Text + i;
+    }
+    std::vector<u32> elfIndex(module.symbols.size());
+    for (const bool globalPass : {false, true}) {
+        for (size_t i = 0; i < module.symbols.size(); ++i) {
+            const ObjectModule::SymbolEntry& symbol = module.symbols[i];
+            const bool isGlobal = symbol.global || symbol.section == SectionKind::Undefined;
+            if (isGlobal != globalPass || symbol.name.starts_with(".L"))
+                continue;
+            Elf64_Sym elfSymbol{};
+            elfSymbol.st_name = strTab.add(symbol.name);
+            u8 type = STT_NOTYPE;
+            if (symbol.section != SectionKind::Undefined)
+                type = symbol.function ? STT_FUNC : STT_OBJECT;
+            elfSymbol.st_info = ELF64_ST_INFO(isGlobal ? STB_GLOBAL : STB_LOCAL, type);
+            elfSymbol.st_shndx = sectionIndex(symbol.section);
+            elfSymbol.st_value = symbol.offset;
+            elfSymbol.st_size = symbol.size;
+            elfIndex[i] = static_cast<u32>(symbols.size());
+            symbols.push_back(elfSymbol);
+        }
+    }
+    const auto firstGlobal = static_cast<u32>(std::ranges::find_if(symbols, [](const Elf64_Sym& symbol) {
+        return ELF64_ST_BIND(symbol.st_info) == STB_GLOBAL;
+    }) - symbols.begin());
+
+    StringTable shStrTab;
+    std::array<Elf64_Shdr, Count> headers{};
+    for (u16 i = 0; i < Count; ++i) {
+        headers[i].sh_name = i == Null ? 0 : shStrTab.add(sectionInfos[i].name);
+        headers[i].sh_type = sectionInfos[i].type;
+        headers[i].sh_flags = sectionInfos[i].flags;
+        headers[i].sh_addralign = 1;
+    }
+
+    std::vector<u8> out(sizeof(Elf64_Ehdr));
+    const auto placeSection = [&out, &headers](const u16 index, const std::vector<u8>& bytes, const u64 alignment) {
+        alignTo(out, alignment);
+        headers[index].sh_offset = out.size();
+        headers[index].sh_size = bytes.size();
+        headers[index].sh_addralign = alignment;
+        appendBytes(out, bytes);
+    };
+    for (u16 i = 0; i < ObjectModule::sectionCount; ++i) {
+        const ObjectModule::Section& section = module.sections[i];
+        if (Text + i == Bss) {
+            headers[Bss].sh_offset = out.size();
+            headers[Bss].sh_size = section.bssSize;
+            headers[Bss].sh_addralign = section.alignment;
+            continue;
+        }
+        placeSection(Text + i, section.bytes, section.alignment);
+    }
+
+    std::vector<u8> relocations;
+    for (const ObjectModule::Relocation& relocation : module.textRelocations) {
+        const u32 type = relocation.kind == ObjectModule::RelocationKind::PLT32 ? R_X86_64_PLT32 : R_X86_64_PC32;
+        const ObjectModule::SymbolEntry& symbol = module.symbols[relocation.symbol];
+        u64 index = elfIndex[relocation.symbol];
+        i64 addend = relocation.addend;
+        if (!symbol.global && symbol.section != SectionKind::Undefined) {
+            index = 1 + static_cast<u64>(symbol.section);
+            addend += static_cast<i64>(symbol.offset);
+        }
+        append(relocations, Elf64_Rela{relocation.offset, ELF64_R_INFO(index, type), addend});
+    }
+    placeSection(RelaText, relocations, 8);
+    headers[RelaText].sh_link = SymTab;
+    headers[RelaText].sh_info = Text;
+    headers[RelaText].sh_entsize = sizeof(Elf64_Rela);
+
+    std::vector<u8> symbolBytes;
+    for (const Elf64_Sym& symbol : symbols)
+        append(symbolBytes, symbol);
+    placeSection(SymTab, symbolBytes, 8);
+    headers[SymTab].sh_link = StrTab;
+    headers[SymTab].sh_info = firstGlobal;
+    headers[SymTab].sh_entsize = sizeof(Elf64_Sym);
+
+    placeSection(StrTab, strTab.bytes(), 1);
+    placeSection(ShStrTab, shStrTab.bytes(), 1);
+    headers[NoteGnuStack].sh_offset = out.size();
+
+    alignTo(out, 8);
+    Elf64_Ehdr header{};
+    std::memcpy(header.e_ident, ELFMAG, SELFMAG);
+    header.e_ident[EI_CLASS] = ELFCLASS64;
+    header.e_ident[EI_DATA] = ELFDATA2LSB;
+    header.e_ident[EI_VERSION] = EV_CURRENT;
+    header.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    header.e_type = ET_REL;
+    header.e_machine = EM_X86_64;
+    header.e_version = EV_CURRENT;
+    header.e_shoff = out.size();
+    header.e_ehsize = sizeof(Elf64_Ehdr);
+    header.e_shentsize = sizeof(Elf64_Shdr);
+    header.e_shnum = Count;
+    header.e_shstrndx = ShStrTab;
+    std::memcpy(out.data(), &header, sizeof(header));
+    for (const Elf64_Shdr& sectionHeader : headers)
+        append(out, sectionHeader);
+    return out;
+}
+
+bool writeObjectFile(const std::filesystem::path& path, const ObjectModule& module)
+{
+    const TimeTrace::Scope scope("writeObject");
+    const std::vector<u8> bytes = elfObject(module);
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs)
+        return false;
+    ofs.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(ofs);
+}
+
+} // CodeGen
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "ObjectModule.hpp"
+
+#include <filesystem>
+#include <vector>
+
+namespace CodeGen {
+
+// Serializes an ObjectModule as an ELF64 x86-64 relocatable object.
+[[nodiscard]] std::vector<u8> elfObject(const ObjectModule& module);
+[[nodiscard]] bool writeObjectFile(const std::filesystem::path& path, const ObjectModule& module);
+
+} // CodeGen
@@ -5,119 +5,126 @@ namespace CodeGen {
 
 void FixUpInstructions::fixStackAlignment()
 {
+    const i64 stackAlloc = m_replacer.stackPointer();
     if (0 < -stackAlloc) {
-        i32 allocationSize = -stackAlloc;
+        i64 allocationSize = -stackAlloc;
         allocationSize += 16 - allocationSize % 16;
-        m_copy.emplace_back(std::make_unique<BinaryInst>(
-            std::make_shared<ImmOperand>(allocationSize, AsmType::LongWord),
-            std::make_shared<RegisterOperand>(RegType::SP, AsmType::QuadWord),
-            BinaryInst::Operator::Sub, AsmType::QuadWord));
+        m_copy.front() = m_pool.make<BinaryInst>(
+            ImmOperand(allocationSize, AsmType::LongWord),
+            RegisterOperand(RegType::SP, AsmType::QuadWord),
+            BinaryInst::Operator::Sub, AsmType::QuadWord);
     }
 }
 
 void FixUpInstructions::fixUp()
 {
-    using Inst = Inst::Kind;
+    using Kind = Inst::Kind;
+    // No instruction expands to more than three, the first slot is kept for the frame allocation
+    // which is only known once every pseudo has been placed.
     m_copy.reserve(m_insts.size() * 3 + 1);
-    fixStackAlignment();
-    while (!m_insts.empty()) {
-        auto inst = std::move(m_insts.front());
-        m_insts.erase(m_insts.begin());
+    m_copy.push_back(nullptr);
+    for (Inst* inst : m_insts) {
+        inst->accept(m_replacer);
         switch (inst->kind) {
-            case Inst::Move:
-                fixMove(*dynCast<MoveInst>(inst.get()));
+            case Kind::Move:
+                fixMove(*dynCast<MoveInst>(inst));
                 break;
-            case Inst::MoveSX:
-                fixMoveSX(*dynCast<MoveSXInst>(inst.get()));
+            case Kind::MoveSX:
+                fixMoveSX(*dynCast<MoveSXInst>(inst));
                 break;
-            case Inst::MoveZeroExtend:
-                fixMoveZero(*dynCast<MoveZeroExtendInst>(inst.get()));
+            case Kind::MoveZeroExtend:
+                fixMoveZero(*dynCast<MoveZeroExtendInst>(inst));
                 break;
-            case Inst::Lea:
-                fixLea(*dynCast<LeaInst>(inst.get()));
+            case Kind::Lea:
+                fixLea(*dynCast<LeaInst>(inst));
                 break;
-            case Inst::Binary:
-                fixBinary(*dynCast<BinaryInst>(inst.get()));
+            case Kind::Binary:
+                fixBinary(*dynCast<BinaryInst>(inst));
                 break;
-            case Inst::Cmp:
-                fixCmp(*dynCast<CmpInst>(inst.get()));
+            case Kind::Cmp:
+                fixCmp(*dynCast<CmpInst>(inst));
                 break;
-            case Inst::Idiv:
-                fixIdiv(*dynCast<IdivInst>(inst.get()));
+            case Kind::Idiv:
+                fixIdiv(*dynCast<IdivInst>(inst));
                 break;
-            case Inst::Div:
-                fixDiv(*dynCast<DivInst>(inst.get()));
+            case Kind::Div:
+                fixDiv(*dynCast<DivInst>(inst));
                 break;
-            case Inst::Cvttsd2si:
-                fixCvttsd2si(*dynCast<Cvttsd2siInst>(inst.get()));
+            case Kind::Cvttsd2si:
+                fixCvttsd2si(*dynCast<Cvttsd2siInst>(inst));
                 break;
-            case Inst::Cvtsi2sd:
-                fixCvtsi2sd(*dynCast<Cvtsi2sdInst>(inst.get()));
+            case Kind::Cvtsi2sd:
+                fixCvtsi2sd(*dynCast<Cvtsi2sdInst>(inst));
                 break;
-            case Inst::PushPseudo:
+            case Kind::PushPseudo:
                 break;
             default:
-                m_copy.emplace_back(std::move(inst));
+                insert(inst);
         }
     }
+    fixStackAlignment();
+    if (m_copy.front() == nullptr) {
+        m_insts.assign(m_copy.begin() + 1, m_copy.end());
+        return;
+    }
     m_insts.swap(m_copy);
 }
 
 void FixUpInstructions::fixMove(MoveInst& moveInst)
 {
     if (areBothOnTheStack(moveInst)) {
-        std::shared_ptr<Operand> src = genSrcOperand(moveInst.type);
-        insert(std::make_unique<MoveInst>(moveInst.src, src, moveInst.type));
-        insert(std::make_unique<MoveInst>(src, moveInst.dst, moveInst.type));
+        Operand src = genSrcOperand(moveInst.type);
+        insert<MoveInst>(moveInst.src, src, moveInst.type);
+        insert<MoveInst>(src, moveInst.dst, moveInst.type);
         return;
     }
-    insert(std::make_unique<MoveInst>(moveInst));
+    insert(&moveInst);
 }
 
 void FixUpInstructions::fixMoveSX(MoveSXInst& moveSX)
 {
-    std::shared_ptr<Operand> src = moveSX.src;
-    if (src->kind == Operand::Kind::Imm) {
-        insert(std::make_unique<MoveInst>(
-            src, genSrcOperand(AsmType::LongWord), AsmType::LongWord));
+    Operand src = moveSX.src;
+    if (src.kind == Operand::Kind::Imm) {
+        insert<MoveInst>(
+            src, genSrcOperand(AsmType::LongWord), AsmType::LongWord);
         src = genSrcOperand(AsmType::LongWord);
     }
-    if (isOnTheStack(moveSX.dst->kind)) {
-        std::shared_ptr<Operand> dst = genDstOperand(AsmType::QuadWord);
-        insert(std::make_unique<MoveSXInst>(src, dst, src->type, dst->type));
-        insert(std::make_unique<MoveInst>(dst, moveSX.dst, AsmType::QuadWord));
+    if (isOnTheStack(moveSX.dst.kind)) {
+        Operand dst = genDstOperand(AsmType::QuadWord);
+        insert<MoveSXInst>(src, dst, src.type, dst.type);
+        insert<MoveInst>(dst, moveSX.dst, AsmType::QuadWord);
         return;
     }
-    insert(std::make_unique<MoveSXInst>(src, moveSX.dst, src->type, moveSX.dst->type));
+    insert<MoveSXInst>(src, moveSX.dst, src.type, moveSX.dst.type);
 }
 
 void FixUpInstructions::fixMoveZero(MoveZeroExtendInst& moveZero)
 {
-    if (moveZero.src->type == AsmType::Byte) {
-        insert(std::make_unique<MoveInst>(moveZero.src, genSrcOperand(moveZero.srcType), moveZero.srcType));
-        insert(std::make_unique<MoveZeroExtendInst>(
+    if (moveZero.src.type == AsmType::Byte) {
+        insert<MoveInst>(moveZero.src, genSrcOperand(moveZero.srcType), moveZero.srcType);
+        insert<MoveZeroExtendInst>(
             genSrcOperand(moveZero.srcType), genDstOperand(moveZero.dstType),
-            moveZero.srcType, moveZero.dstType));
-        insert(std::make_unique<MoveInst>(genDstOperand(moveZero.dstType), moveZero.dst, moveZero.dstType));
+            moveZero.srcType, moveZero.dstType);
+        insert<MoveInst>(genDstOperand(moveZero.dstType), moveZero.dst, moveZero.dstType);
         return;
     }
-    if (moveZero.dst->kind == Operand::Kind::Register) {
-        insert(std::make_unique<MoveInst>(moveZero.src, moveZero.dst, moveZero.dstType));
+    if (moveZero.dst.kind == Operand::Kind::Register) {
+        insert<MoveInst>(moveZero.src, moveZero.dst, moveZero.dstType);
         return;
     }
-    insert(std::make_unique<MoveInst>(moveZero.src, genDstOperand(moveZero.srcType), moveZero.srcType));
-    insert(std::make_unique<MoveInst>(genDstOperand(moveZero.dstType), moveZero.dst, moveZero.dstType));
+    insert<MoveInst>(moveZero.src, genDstOperand(moveZero.srcType), moveZero.srcType);
+    insert<MoveInst>(genDstOperand(moveZero.dstType), moveZero.dst, moveZero.dstType);
 }
 
 void FixUpInstructions::fixLea(LeaInst& lea)
 {
-    if (isOnTheStack(lea.dst->kind)) {
-        std::shared_ptr<Operand> dst = genDstOperand(AsmType::QuadWord);
-        insert(std::make_unique<LeaInst>(lea.src, dst, AsmType::QuadWord));
-        insert(std::make_unique<MoveInst>(dst, lea.dst, AsmType::QuadWord));
+    if (isOnTheStack(lea.dst.kind)) {
+        Operand dst = genDstOperand(AsmType::QuadWord);
+        insert<LeaInst>(lea.src, dst, AsmType::QuadWord);
+        insert<MoveInst>(dst, lea.dst, AsmType::QuadWord);
         return;
     }
-    insert(std::make_unique<LeaInst>(lea));
+    insert(&lea);
 }
 
 void FixUpInstructions::fixBinary(BinaryInst& binary)
@@ -134,128 +141,128 @@ void FixUpInstructions::fixBinary(BinaryInst& binary)
 
 void FixUpInstructions::binaryShift(BinaryInst& binaryInst)
 {
-    auto regCX = std::make_shared<RegisterOperand>(RegType::CX, binaryInst.type);
-    auto regCL = std::make_shared<RegisterOperand>(RegType::CX, AsmType::Byte);
+    const RegisterOperand regCX(RegType::CX, binaryInst.type);
+    const RegisterOperand regCL(RegType::CX, AsmType::Byte);
 
-    insert(std::make_unique<MoveInst>(binaryInst.lhs, regCX, binaryInst.type));
-    insert(std::make_unique<BinaryInst>(regCL, binaryInst.rhs, binaryInst.oper, binaryInst.type));
+    insert<MoveInst>(binaryInst.lhs, regCX, binaryInst.type);
+    insert<BinaryInst>(regCL, binaryInst.rhs, binaryInst.oper, binaryInst.type);
 }
 
 void FixUpInstructions::binaryMul(BinaryInst& binaryInst)
 {
-    if (isOnTheStack(binaryInst.rhs->kind)) {
-        std::shared_ptr<Operand> dst = genDstOperand(binaryInst.type);
-        insert(std::make_unique<MoveInst>(binaryInst.rhs, dst, binaryInst.type));
-        insert(std::make_unique<BinaryInst>(binaryInst.lhs, dst, binaryInst.oper, binaryInst.type));
-        insert(std::make_unique<MoveInst>(dst, binaryInst.rhs, binaryInst.type));
+    if (isOnTheStack(binaryInst.rhs.kind)) {
+        Operand dst = genDstOperand(binaryInst.type);
+        insert<MoveInst>(binaryInst.rhs, dst, binaryInst.type);
+        insert<BinaryInst>(binaryInst.lhs, dst, binaryInst.oper, binaryInst.type);
+        insert<MoveInst>(dst, binaryInst.rhs, binaryInst.type);
         return;
     }
-    insert(std::make_unique<BinaryInst>(binaryInst));
+    insert(&binaryInst);
 }
 
 void FixUpInstructions::binaryDoubleOthers(BinaryInst& binaryInst)
 {
-    if (binaryInst.rhs->kind == Operand::Kind::Register) {
-        insert(std::make_unique<BinaryInst>(binaryInst));
+    if (binaryInst.rhs.kind == Operand::Kind::Register) {
+        insert(&binaryInst);
         return;
     }
-    std::shared_ptr<Operand> dst = genDstOperand(binaryInst.type);
-    insert(std::make_unique<MoveInst>(binaryInst.rhs, dst, binaryInst.type));
-    insert(std::make_unique<BinaryInst>(binaryInst.lhs, dst, binaryInst.oper, binaryInst.type));
-    insert(std::make_unique<MoveInst>(dst, binaryInst.rhs, binaryInst.type));
+    Operand dst = genDstOperand(binaryInst.type);
+    insert<MoveInst>(binaryInst.rhs, dst, binaryInst.type);
+    insert<BinaryInst>(binaryInst.lhs, dst, binaryInst.oper, binaryInst.type);
+    insert<MoveInst>(dst, binaryInst.rhs, binaryInst.type);
 }
 
 void FixUpInstructions::binaryOthers(BinaryInst& binaryInst)
 {
     if (areBothOnTheStack(binaryInst)) {
-        std::shared_ptr<Operand> src = genSrcOperand(binaryInst.type);
-        insert(std::make_unique<MoveInst>(binaryInst.lhs, src, binaryInst.type));
-        insert(std::make_unique<BinaryInst>(src, binaryInst.rhs, binaryInst.oper, binaryInst.type));
+        Operand src = genSrcOperand(binaryInst.type);
+        insert<MoveInst>(binaryInst.lhs, src, binaryInst.type);
+        insert<BinaryInst>(src, binaryInst.rhs, binaryInst.oper, binaryInst.type);
         return;
     }
-    insert(std::make_unique<BinaryInst>(binaryInst));
+    insert(&binaryInst);
 }
 
 void FixUpInstructions::fixCmp(CmpInst& cmpInst)
 {
-    if (cmpInst.rhs->kind != Operand::Kind::Register && cmpInst.type == AsmType::Double) {
-        std::shared_ptr<Operand> dst = genDstOperand(cmpInst.type);
-        insert(std::make_unique<MoveInst>(cmpInst.rhs, dst, cmpInst.type));
-        insert(std::make_unique<CmpInst>(cmpInst.lhs, dst, cmpInst.type));
-    } else if (cmpInst.rhs->kind == Operand::Kind::Imm) {
-        std::shared_ptr<Operand> dst = genDstOperand(cmpInst.type);
-        insert(std::make_unique<MoveInst>(cmpInst.rhs, dst, cmpInst.type));
-        insert(std::make_unique<CmpInst>(cmpInst.lhs, dst, cmpInst.type));
+    if (cmpInst.rhs.kind != Operand::Kind::Register && cmpInst.type == AsmType::Double) {
+        Operand dst = genDstOperand(cmpInst.type);
+        insert<MoveInst>(cmpInst.rhs, dst, cmpInst.type);
+        insert<CmpInst>(cmpInst.lhs, dst, cmpInst.type);
+    } else if (cmpInst.rhs.kind == Operand::Kind::Imm) {
+        Operand dst = genDstOperand(cmpInst.type);
+        insert<MoveInst>(cmpInst.rhs, dst, cmpInst.type);
+        insert<CmpInst>(cmpInst.lhs, dst, cmpInst.type);
     } else if (areBothOnTheStack(cmpInst)) {
-        std::shared_ptr<Operand> src = genSrcOperand(cmpInst.type);
-        insert(std::make_unique<MoveInst>(cmpInst.lhs, src, cmpInst.type));
-        insert(std::make_unique<CmpInst>(src, cmpInst.rhs, cmpInst.type));
+        Operand src = genSrcOperand(cmpInst.type);
+        insert<MoveInst>(cmpInst.lhs, src, cmpInst.type);
+        insert<CmpInst>(src, cmpInst.rhs, cmpInst.type);
     } else
-        insert(std::make_unique<CmpInst>(cmpInst));
+        insert(&cmpInst);
 }
 
 void FixUpInstructions::fixIdiv(IdivInst& idiv)
 {
-    if (isOnTheStack(idiv.operand->kind) || idiv.operand->kind == Operand::Kind::Imm) {
-        std::shared_ptr<Operand> src = genSrcOperand(idiv.type);
-        insert(std::make_unique<MoveInst>(idiv.operand, src, idiv.type));
-        insert(std::make_unique<IdivInst>(src, idiv.type));
+    if (isOnTheStack(idiv.operand.kind) || idiv.operand.kind == Operand::Kind::Imm) {
+        Operand src = genSrcOperand(idiv.type);
+        insert<MoveInst>(idiv.operand, src, idiv.type);
+        insert<IdivInst>(src, idiv.type);
         return;
     }
-    insert(std::make_unique<IdivInst>(idiv));
+    insert(&idiv);
 }
 
 void FixUpInstructions::fixDiv(DivInst& div)
 {
-    if (isOnTheStack(div.operand->kind) || div.operand->kind == Operand::Kind::Imm) {
-        std::shared_ptr<Operand> src = genSrcOperand(div.type);
-        insert(std::make_unique<MoveInst>(div.operand, src, div.type));
-        insert(std::make_unique<DivInst>(src, div.type));
+    if (isOnTheStack(div.operand.kind) || div.operand.kind == Operand::Kind::Imm) {
+        Operand src = genSrcOperand(div.type);
+        insert<MoveInst>(div.operand, src, div.type);
+        insert<DivInst>(src, div.type);
         return;
     }
-    insert(std::make_unique<DivInst>(div));
+    insert(&div);
 }
 
 void FixUpInstructions::fixCvttsd2si(Cvttsd2siInst& cvttsd2si)
 {
-    if (cvttsd2si.dst->kind == Operand::Kind::Register) {
-        insert(std::make_unique<Cvttsd2siInst>(cvttsd2si));
+    if (cvttsd2si.dst.kind == Operand::Kind::Register) {
+        insert(&cvttsd2si);
         return;
     }
-    std::shared_ptr<Operand> dst = genDstOperand(cvttsd2si.dstType);
-    insert(std::make_unique<Cvttsd2siInst>(cvttsd2si.src, dst, cvttsd2si.dstType));
-    insert(std::make_unique<MoveInst>(dst, cvttsd2si.dst, cvttsd2si.dstType));
+    Operand dst = genDstOperand(cvttsd2si.dstType);
+    insert<Cvttsd2siInst>(cvttsd2si.src, dst, cvttsd2si.dstType);
+    insert<MoveInst>(dst, cvttsd2si.dst, cvttsd2si.dstType);
 }
 
 void FixUpInstructions::fixCvtsi2sd(Cvtsi2sdInst& cvtsi2sd)
 {
-    std::shared_ptr<Operand> src = cvtsi2sd.src;
-    if (src->kind == Operand::Kind::Imm) {
-        std::shared_ptr<Operand> srcReg = genSrcOperand(cvtsi2sd.srcType);
-        insert(std::make_unique<MoveInst>(src, srcReg, cvtsi2sd.srcType));
+    Operand src = cvtsi2sd.src;
+    if (src.kind == Operand::Kind::Imm) {
+        Operand srcReg = genSrcOperand(cvtsi2sd.srcType);
+        insert<MoveInst>(src, srcReg, cvtsi2sd.srcType);
         src = srcReg;
     }
-    if (cvtsi2sd.dst->kind == Operand::Kind::Register) {
-        insert(std::make_unique<Cvtsi2sdInst>(src, cvtsi2sd.dst, AsmType::Double));
+    if (cvtsi2sd.dst.kind == Operand::Kind::Register) {
+        insert<Cvtsi2sdInst>(src, cvtsi2sd.dst, AsmType::Double);
         return;
     }
-    std::shared_ptr<Operand> dst = genDstOperand(AsmType::Double);
-    insert(std::make_unique<Cvtsi2sdInst>(src, dst, cvtsi2sd.srcType));
-    insert(std::make_unique<MoveInst>(dst, cvtsi2sd.dst, AsmType::Double));
+    Operand dst = genDstOperand(AsmType::Double);
+    insert<Cvtsi2sdInst>(src, dst, cvtsi2sd.srcType);
+    insert<MoveInst>(dst, cvtsi2sd.dst, AsmType::Double);
 }
 
-std::shared_ptr<RegisterOperand> FixUpInstructions::genSrcOperand(AsmType type)
+RegisterOperand FixUpInstructions::genSrcOperand(const AsmType type)
 {
     if (type == AsmType::Double)
-        return std::make_shared<RegisterOperand>(RegType::XMM14, type);
-    return std::make_shared<RegisterOperand>(RegType::R10, type);
+        return RegisterOperand(RegType::XMM14, type);
+    return RegisterOperand(RegType::R10, type);
 }
 
-std::shared_ptr<RegisterOperand> FixUpInstructions::genDstOperand(AsmType type)
+RegisterOperand FixUpInstructions::genDstOperand(const AsmType type)
 {
     if (type == AsmType::Double)
-        return std::make_shared<RegisterOperand>(RegType::XMM15, type);
-    return std::make_shared<RegisterOperand>(RegType::R11, type);
+        return RegisterOperand(RegType::XMM15, type);
+    return RegisterOperand(RegType::R11, type);
 }
 
 } // namespace CodeGen
\ No newline at end of file
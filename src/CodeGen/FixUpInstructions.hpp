@@ -1,20 +1,26 @@
 #pragma once
 
 #include "AsmAST.hpp"
+#include "PseudoRegisterReplacer.hpp"
 
 #include <vector>
 
 namespace CodeGen {
 
+// Assigns stack slots to pseudo operands and legalises the operands of every instruction
+// in one forward walk. stackAlloc is the part of the frame already in use.
 class FixUpInstructions final {
     using RegType = Operand::RegKind;
 
-    std::vector<std::unique_ptr<Inst>>& m_insts;
-    std::vector<std::unique_ptr<Inst>> m_copy;
-    i32 stackAlloc;
+    std::vector<Inst*>& m_insts;
+    InstructionPool& m_pool;
+    std::vector<Inst*> m_copy;
+    PseudoRegisterReplacer m_replacer;
 public:
-    FixUpInstructions(std::vector<std::unique_ptr<Inst>>& insts, const i32 stackAlloc)
-        : m_insts(insts), stackAlloc(stackAlloc) {}
+    FixUpInstructions(std::vector<Inst*>& insts, InstructionPool& pool, const i32 stackAlloc = 0)
+        : m_insts(insts), m_pool(pool), m_replacer(stackAlloc) {}
+
+    [[nodiscard]] i64 stackPointer() const { return m_replacer.stackPointer(); }
 
     void fixStackAlignment();
     void fixUp();
@@ -30,13 +36,17 @@ public:
     void fixCvttsd2si(Cvttsd2siInst& cvttsd2si);
     void fixCvtsi2sd(Cvtsi2sdInst& cvtsi2sd);
 
-    static std::shared_ptr<RegisterOperand> genSrcOperand(AsmType type);
-    static std::shared_ptr<RegisterOperand> genDstOperand(AsmType type);
+    static RegisterOperand genSrcOperand(AsmType type);
+    static RegisterOperand genDstOperand(AsmType type);
 private:
-    template<typename... InstPtrs>
-    void insert(InstPtrs&&... others)
+    void insert(Inst* inst)
+    {
+        m_copy.push_back(inst);
+    }
+    template<typename T, typename... Args>
+    void insert(Args&&... args)
     {
-        (m_copy.push_back(std::forward<InstPtrs>(others)), ...);
+        m_copy.push_back(m_pool.make<T>(std::forward<Args>(args)...));
     }
 
     void binaryShift(BinaryInst& binaryInst);
@@ -62,17 +72,17 @@ constexpr bool FixUpInstructions::isBinaryShift(const BinaryInst& binaryInst)
 
 constexpr bool FixUpInstructions::areBothOnTheStack(const MoveInst& move)
 {
-    return isOnTheStack(move.src->kind) && isOnTheStack(move.dst->kind);
+    return isOnTheStack(move.src.kind) && isOnTheStack(move.dst.kind);
 }
 
 constexpr bool FixUpInstructions::areBothOnTheStack(const CmpInst& cmp)
 {
-    return isOnTheStack(cmp.lhs->kind) && isOnTheStack(cmp.rhs->kind);
+    return isOnTheStack(cmp.lhs.kind) && isOnTheStack(cmp.rhs.kind);
 }
 
 constexpr bool FixUpInstructions::areBothOnTheStack(const BinaryInst& binary)
 {
-    return isOnTheStack(binary.lhs->kind) && isOnTheStack(binary.rhs->kind);
+    return isOnTheStack(binary.lhs.kind) && isOnTheStack(binary.rhs.kind);
 }
 
 constexpr bool FixUpInstructions::isOnTheStack(const Operand::Kind kind)
@@ -0,0 +1,264 @@
+#include "FunctionUnit.hpp"
+#include "DynCast.hpp"
+
+#include <bit>
+
+namespace CodeGen {
+
+namespace {
+
+constexpr u64 formatVersion = 1;
+
+class Writer {
+    std::string m_bytes;
+public:
+    void add(const u64 value)
+    {
+        for (size_t i = 0; i < sizeof(value); ++i)
+            m_bytes += static_cast<char>(value >> (8 * i));
+    }
+    void add(const std::string_view text)
+    {
+        add(text.size());
+        m_bytes += text;
+    }
+    void add(const std::vector<u8>& bytes)
+    {
+        add(bytes.size());
+        m_bytes.append(bytes.begin(), bytes.end());
+    }
+    [[nodiscard]] std::string take() { return std::move(m_bytes); }
+};
+
+class Reader {
+    std::string_view m_bytes;
+    bool m_failed = false;
+public:
+    explicit Reader(const std::string_view bytes)
+        : m_bytes(bytes) {}
+
+    u64 number()
+    {
+        if (m_bytes.size() < sizeof(u64)) {
+            m_failed = true;
+            return 0;
+        }
+        u64 value = 0;
+        for (size_t i = 0; i < sizeof(value); ++i)
+            value |= static_cast<u64>(static_cast<u8>(m_bytes[i])) << (8 * i);
+        m_bytes.remove_prefix(sizeof(value));
+        return value;
+    }
+    std::string_view text()
+    {
+        const u64 size = number();
+        if (m_bytes.size() < size) {
+            m_failed = true;
+            return {};
+        }
+        const std::string_view result = m_bytes.substr(0, size);
+        m_bytes.remove_prefix(size);
+        return result;
+    }
+    std::vector<u8> bytes()
+    {
+        const std::string_view data = text();
+        return {data.begin(), data.end()};
+    }
+    void fail() { m_failed = true; }
+    [[nodiscard]] bool failed() const { return m_failed; }
+    [[nodiscard]] bool done() const { return m_bytes.empty(); }
+};
+
+void writeObject(Writer& writer, const ObjectModule& object)
+{
+    writer.add(object.section(ObjectModule::SectionKind::Text).bytes);
+    writer.add(object.symbols.size());
+    for (const ObjectModule::SymbolEntry& symbol : object.symbols) {
+        writer.add(symbol.name);
+        writer.add(static_cast<u64>(symbol.section));
+        writer.add(symbol.offset);
+        writer.add(symbol.size);
+        writer.add(symbol.global);
+        writer.add(symbol.function);
+    }
+    writer.add(object.textRelocations.size());
+    for (const ObjectModule::Relocation& relocation : object.textRelocations) {
+        writer.add(relocation.offset);
+        writer.add(relocation.symbol);
+        writer.add(static_cast<u64>(relocation.kind));
+        writer.add(static_cast<u64>(relocation.addend));
+    }
+}
+
+ObjectModule readObject(Reader& reader)
+{
+    ObjectModule object;
+    object.section(ObjectModule::SectionKind::Text).bytes = reader.bytes();
+    const u64 symbolCount = reader.number();
+    for (u64 i = 0; i < symbolCount && !reader.failed(); ++i) {
+        const u32 index = object.symbol(std::string(reader.text()));
+        ObjectModule::SymbolEntry& symbol = object.symbols[index];
+        symbol.section = static_cast<ObjectModule::SectionKind>(reader.number());
+        symbol.offset = reader.number();
+        symbol.size = reader.number();
+        symbol.global = reader.number() != 0;
+        symbol.function = reader.number() != 0;
+    }
+    const u64 relocationCount = reader.number();
+    for (u64 i = 0; i < relocationCount && !reader.failed(); ++i) {
+        const u64 offset = reader.number();
+        const u64 symbol = reader.number();
+        const u64 kind = reader.number();
+        const i64 addend = static_cast<i64>(reader.number());
+        if (object.symbols.size() <= symbol)
+            reader.fail();
+        object.textRelocations.push_back({offset, static_cast<u32>(symbol),
+                                          static_cast<ObjectModule::RelocationKind>(kind), addend});
+    }
+    return object;
+}
+
+void writeTopLevel(Writer& writer, const TopLevel& topLevel)
+{
+    writer.add(static_cast<u64>(topLevel.kind));
+    switch (topLevel.kind) {
+        case TopLevel::Kind::StaticVariable: {
+            const auto variable = dynCast<const StaticVariable>(&topLevel);
+            writer.add(variable->name.value.str());
+            writer.add(variable->init);
+            writer.add(static_cast<u64>(variable->type));
+            writer.add(variable->global);
+            break;
+        }
+        case TopLevel::Kind::StaticConstant: {
+            const auto constant = dynCast<const ConstVariable>(&topLevel);
+            writer.add(constant->name.value.str());
+            writer.add(static_cast<u64>(constant->alignment));
+            writer.add(std::bit_cast<u64>(constant->staticInit));
+            writer.add(constant->local);
+            break;
+        }
+        case TopLevel::Kind::StaticArray: {
+            const auto array = dynCast<const ArrayVariable>(&topLevel);
+            writer.add(array->name.value.str());
+            writer.add(static_cast<u64>(array->alignment));
+            writer.add(array->isGlobal);
+            writer.add(static_cast<u64>(array->type));
+            writer.add(array->initializers.size());
+            for (const std::unique_ptr<Initializer>& initializer : array->initializers) {
+                writer.add(static_cast<u64>(initializer->kind));
+                if (initializer->kind == Initializer::Kind::Zero)
+                    writer.add(static_cast<u64>(dynCast<const ZeroInitializer>(initializer.get())->size));
+                else
+                    writer.add(dynCast<const ValueInitializer>(initializer.get())->init);
+            }
+            break;
+        }
+        case TopLevel::Kind::StaticString: {
+            const auto string = dynCast<const StringVariable>(&topLevel);
+            writer.add(string->name.value.str());
+            writer.add(string->value);
+            writer.add(string->global);
+            writer.add(string->nullTerminated);
+            break;
+        }
+        case TopLevel::Kind::EmittedFunction: {
+            const auto function = dynCast<const EmittedFunction>(&topLevel);
+            writer.add(function->name.value.str());
+            writer.add(function->assembly);
+            writeObject(writer, function->object);
+            break;
+        }
+        default:
+            std::abort();
+    }
+}
+
+std::unique_ptr<TopLevel> readTopLevel(Reader& reader)
+{
+    const auto identifier = [&reader] { return Identifier(Symbol(reader.text())); };
+    switch (static_cast<TopLevel::Kind>(reader.number())) {
+        case TopLevel::Kind::StaticVariable: {
+            const Identifier name = identifier();
+            const u64 init = reader.number();
+            const auto type = static_cast<AsmType>(reader.number());
+            auto variable = std::make_unique<StaticVariable>(name, type, reader.number() != 0);
+            variable->init = init;
+            return variable;
+        }
+        case TopLevel::Kind::StaticConstant: {
+            Identifier name = identifier();
+            const auto alignment = static_cast<i32>(reader.number());
+            const auto value = std::bit_cast<double>(reader.number());
+            return std::make_unique<ConstVariable>(std::move(name), alignment, value, reader.number() != 0);
+        }
+        case TopLevel::Kind::StaticArray: {
+            Identifier name = identifier();
+            const auto alignment = static_cast<i32>(reader.number());
+            const bool isGlobal = reader.number() != 0;
+            const auto type = static_cast<AsmType>(reader.number());
+            const u64 count = reader.number();
+            std::vector<std::unique_ptr<Initializer>> initializers;
+            for (u64 i = 0; i < count && !reader.failed(); ++i) {
+                const auto kind = static_cast<Initializer::Kind>(reader.number());
+                if (kind == Initializer::Kind::Zero)
+                    initializers.emplace_back(std::make_unique<ZeroInitializer>(static_cast<i64>(reader.number())));
+                else
+                    initializers.emplace_back(std::make_unique<ValueInitializer>(reader.number()));
+            }
+            return std::make_unique<ArrayVariable>(std::move(name), alignment, std::move(initializers), isGlobal,
+                                                   type);
+        }
+        case TopLevel::Kind::StaticString: {
+            const Identifier name = identifier();
+            const std::string value(reader.text());
+            const bool global = reader.number() != 0;
+            return std::make_unique<StringVariable>(name, value, global, reader.number() != 0);
+        }
+        case TopLevel::Kind::EmittedFunction: {
+            const Identifier name = identifier();
+            std::string assembly(reader.text());
+            return std::make_unique<EmittedFunction>(name, std::move(assembly), readObject(reader));
+        }
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace
+
+std::string FunctionUnit::serialize() const
+{
+    Writer writer;
+    writer.add(formatVersion);
+    writer.add(topLevels.size());
+    for (const std::unique_ptr<TopLevel>& topLevel : topLevels)
+        writeTopLevel(writer, *topLevel);
+    writer.add(constants.size());
+    for (const std::unique_ptr<TopLevel>& constant : constants)
+        writeTopLevel(writer, *constant);
+    return writer.take();
+}
+
+std::optional<FunctionUnit> FunctionUnit::deserialize(const std::string_view bytes)
+{
+    Reader reader(bytes);
+    if (reader.number() != formatVersion)
+        return std::nullopt;
+    FunctionUnit unit;
+    for (auto* list : {&unit.topLevels, &unit.constants}) {
+        const u64 count = reader.number();
+        for (u64 i = 0; i < count && !reader.failed(); ++i) {
+            std::unique_ptr<TopLevel> topLevel = readTopLevel(reader);
+            if (topLevel == nullptr)
+                return std::nullopt;
+            list->emplace_back(std::move(topLevel));
+        }
+    }
+    if (reader.failed() || !reader.done())
+        return std::nullopt;
+    return unit;
+}
+
+} // CodeGen
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "AsmAST.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace CodeGen {
+
+// Backend output of one function definition: the string literals and static locals it
+// introduced, the function itself as an EmittedFunction, and the double constants it uses.
+// Stored in the compile cache so an unchanged function is not lowered again.
+struct FunctionUnit {
+    std::vector<std::unique_ptr<TopLevel>> topLevels;
+    std::vector<std::unique_ptr<TopLevel>> constants;
+
+    [[nodiscard]] std::string serialize() const;
+    // Empty if the bytes are not a unit written by serialize().
+    [[nodiscard]] static std::optional<FunctionUnit> deserialize(std::string_view bytes);
+};
+
+} // CodeGen
@@ -3,9 +3,11 @@
 #include "DynCast.hpp"
 #include "FixUpInstructions.hpp"
 #include "PseudoRegisterReplacer.hpp"
+#include "TimeTrace.hpp"
 #include "Types/TypeConversion.hpp"
 #include "Operators.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 
@@ -21,14 +23,52 @@ namespace CodeGen {
 
 void GenerateAsmTree::genProgram(const Ir::Program &program, Program &programCodegen)
 {
-    m_toplevel.clear();
-    for (const auto& toplevelIr : program.topLevels) {
-        std::unique_ptr<TopLevel> topLevel = genTopLevel(*toplevelIr);
-        m_toplevel.emplace_back(std::move(topLevel));
+    genProgram(program, programCodegen, WorkStealingPool(1));
+}
+
+void GenerateAsmTree::genProgram(const Ir::Program &program, Program &programCodegen, const WorkStealingPool& pool)
+{
+    std::vector<GeneratedTopLevel> generated = genTopLevels(program, pool);
+    std::vector<std::unique_ptr<TopLevel>> constants;
+    for (GeneratedTopLevel& topLevel : generated) {
+        programCodegen.topLevels.emplace_back(std::move(topLevel.topLevel));
+        for (std::unique_ptr<TopLevel>& constant : topLevel.constants)
+            constants.emplace_back(std::move(constant));
     }
+    appendConstants(programCodegen, std::move(constants));
+}
+
+std::vector<GenerateAsmTree::GeneratedTopLevel> GenerateAsmTree::genTopLevels(const Ir::Program &program,
+                                                                              const WorkStealingPool& pool)
+{
+    std::vector<GeneratedTopLevel> generated(program.topLevels.size());
+    pool.run(generated.size(), [&program, &generated](const size_t i) {
+        GenerateAsmTree generateAsmTree;
+        generated[i].topLevel = generateAsmTree.genTopLevel(*program.topLevels[i]);
+        generated[i].constants = std::move(generateAsmTree.m_toplevel);
+    });
+    return generated;
+}
+
+void GenerateAsmTree::appendConstants(Program &programCodegen, std::vector<std::unique_ptr<TopLevel>> constants)
+{
+    m_toplevel = std::move(programCodegen.topLevels);
+    m_constantDoubles.clear();
+    for (std::unique_ptr<TopLevel>& constant : constants)
+        mergeDoubleConstant(std::move(constant));
     programCodegen.topLevels = std::move(m_toplevel);
 }
 
+void GenerateAsmTree::mergeDoubleConstant(std::unique_ptr<TopLevel> topLevel)
+{
+    const auto constant = dynCast<ConstVariable>(topLevel.get());
+    const auto [it, inserted] = m_constantDoubles.try_emplace(constant->staticInit, constant);
+    if (inserted)
+        m_toplevel.emplace_back(std::move(topLevel));
+    else
+        it->second->alignment = std::max(it->second->alignment, constant->alignment);
+}
+
 std::unique_ptr<TopLevel> GenerateAsmTree::genTopLevel(const Ir::TopLevel& topLevel)
 {
     using Type = Ir::TopLevel::Kind;
@@ -56,13 +96,21 @@ std::unique_ptr<TopLevel> GenerateAsmTree::genTopLevel(const Ir::TopLevel& topLe
 
 std::unique_ptr<TopLevel> GenerateAsmTree::genFunction(const Ir::Function& function)
 {
-    auto functionCodeGen = std::make_unique<Function>(function.name, function.isGlobal);
+    const TimeTrace::FunctionScope scope("GenerateAsmTree", function.name.value.text());
+    auto functionCodeGen = std::make_unique<Function>(Identifier(function.name.value), function.isGlobal);
     insts.clear();
+    m_pool = InstructionPool();
+    m_function = &function;
+    m_labels.assign(function.labelCount, Symbol());
+    m_temporaryBase = function.name.value;
+    m_temporaryCounter = 0;
     const std::vector<bool> pushedIntoRegs = genFunctionPushIntoRegs(function);
     genFunctionPushOntoStack(function, pushedIntoRegs);
-    for (const std::unique_ptr<Ir::Instruction>& inst : function.insts)
-        genInst(inst);
+    for (const Ir::Instruction* inst : function.insts)
+        genInst(*inst);
     functionCodeGen->instructions = std::move(insts);
+    functionCodeGen->pool = std::move(m_pool);
+    m_function = nullptr;
     return functionCodeGen;
 }
 
@@ -73,15 +121,15 @@ std::vector<bool> GenerateAsmTree::genFunctionPushIntoRegs(const Ir::Function& f
     i32 regDoubleInex = 0;
     for (size_t i = 0; i < function.args.size(); ++i) {
         const AsmType type = Operators::getAsmType(function.argTypes[i]);
-        std::shared_ptr<RegisterOperand> src;
+        RegType reg;
         if (type != AsmType::Double && regIntIndex < intRegs.size())
-            src = std::make_shared<RegisterOperand>(intRegs[regIntIndex++], type);
+            reg = intRegs[regIntIndex++];
         else if (type == AsmType::Double && regDoubleInex < doubleRegs.size())
-            src = std::make_shared<RegisterOperand>(doubleRegs[regDoubleInex++], type);
+            reg = doubleRegs[regDoubleInex++];
         else
             continue;
-        auto arg = std::make_shared<Ir::ValueVar>(function.args[i], function.argTypes[i]);
-        std::shared_ptr<Operand> dst = genOperand(arg);
+        const RegisterOperand src(reg, type);
+        Operand dst = genOperand(Ir::Value(function.args[i], function.argTypes[i]));
         emplaceMove(src, dst, type);
         pushedIntoRegs[i] = true;
     }
@@ -95,29 +143,29 @@ void GenerateAsmTree::genFunctionPushOntoStack(const Ir::Function& function, std
         if (pushedIntoRegs[i])
             continue;
         constexpr i32 stackAlignment = 8;
-        auto stack = std::make_shared<MemoryOperand>(
+        auto stack = MemoryOperand(
             RegType::BP, stackAlignment * stackPtr++, Operators::getAsmType(function.argTypes[i]));
-        auto arg = std::make_shared<Ir::ValueVar>(function.args[i], function.argTypes[i]);
-        std::shared_ptr<Operand> dst = genOperand(arg);
+        Operand dst = genOperand(Ir::Value(function.args[i], function.argTypes[i]));
         emplaceMove(stack, dst, Operators::getAsmType(function.argTypes[i]));
     }
 }
 
-u64 getSingleInitValue(const Type type, const Ir::ValueConst* const value)
+u64 getSingleInitValue(const Type type, const Ir::Value& value)
 {
+    // GenerateIr reports non constant static initializers, one reaching here is a bug.
+    if (!value.isConstant())
+        std::abort();
     switch (type) {
-        case Type::Char:    return std::get<char>(value->value);
-        case Type::I8:      return std::get<i8>(value->value);
-        case Type::U8:      return std::get<u8>(value->value);
-        case Type::I32:     return std::get<i32>(value->value);
-        case Type::U32:     return std::get<u32>(value->value);
-        case Type::I64:     return std::get<i64>(value->value);
-        case Type::Pointer: return std::get<u64>(value->value);
-        case Type::U64:     return std::get<u64>(value->value);
-        case Type::Double: {
-            const double init = std::get<double>(value->value);
-            return std::bit_cast<i64>(init);
-        }
+        case Type::Char:
+        case Type::I8:
+        case Type::U8:
+        case Type::I32:
+        case Type::U32:
+        case Type::I64:
+        case Type::Pointer:
+        case Type::U64:
+        case Type::Double:
+            return value.bits;
         default:
             std::abort();
     }
@@ -126,7 +174,7 @@ u64 getSingleInitValue(const Type type, const Ir::ValueConst* const value)
 std::unique_ptr<TopLevel> genStaticString(const Ir::StaticConstant& staticConstant)
 {
     return std::make_unique<StringVariable>(
-        staticConstant.identifier.value,
+        Identifier(staticConstant.identifier.value),
         staticConstant.value,
         staticConstant.global,
         staticConstant.nullTerminated
@@ -136,10 +184,9 @@ std::unique_ptr<TopLevel> genStaticString(const Ir::StaticConstant& staticConsta
 std::unique_ptr<TopLevel> genStaticVariable(const Ir::StaticVariable& staticVariable)
 {
     const Type type = staticVariable.type;
-    const auto value = dynCast<const Ir::ValueConst>(staticVariable.value.get());
     auto result = std::make_unique<StaticVariable>(
-        staticVariable.name, Operators::getAsmType(type), staticVariable.global);
-    result->init = getSingleInitValue(type, value);
+        Identifier(staticVariable.name.value), Operators::getAsmType(type), staticVariable.global);
+    result->init = getSingleInitValue(type, staticVariable.value);
     return result;
 }
 
@@ -150,9 +197,8 @@ std::unique_ptr<TopLevel> genStaticArray(const Ir::StaticArray& staticArray)
         switch (init->kind) {
             case Ir::Initializer::Kind::Value: {
                 const auto value = dynCast<Ir::ValueInitializer>(init.get());
-                const auto constValue = dynCast<Ir::ValueConst>(value->value.get());
                 initializers.emplace_back(std::make_unique<ValueInitializer>(
-                    getSingleInitValue(constValue->type, constValue)));
+                    getSingleInitValue(value->value.type, value->value)));
                 break;
             }
             case Ir::Initializer::Kind::Zero: {
@@ -163,121 +209,121 @@ std::unique_ptr<TopLevel> genStaticArray(const Ir::StaticArray& staticArray)
         }
     }
     return std::make_unique<ArrayVariable>(
-        Identifier(staticArray.name), 16, std::move(initializers),
+        Identifier(staticArray.name.value), 16, std::move(initializers),
         staticArray.global, Operators::getAsmType(staticArray.type));
 }
 
-void GenerateAsmTree::genInst(const std::unique_ptr<Ir::Instruction>& inst)
+void GenerateAsmTree::genInst(const Ir::Instruction& inst)
 {
     using Kind = Ir::Instruction::Kind;
-    switch (inst->kind) {
+    switch (inst.kind) {
         case Kind::Return: {
-            const auto irReturn = dynCast<const Ir::ReturnInst>(inst.get());
+            const auto irReturn = dynCast<const Ir::ReturnInst>(&inst);
             genReturn(*irReturn);
             break;
         }
         case Kind::SignExtend: {
-            const auto signExtend = dynCast<const Ir::SignExtendInst>(inst.get());
+            const auto signExtend = dynCast<const Ir::SignExtendInst>(&inst);
             genSignExtend(*signExtend);
             break;
         }
         case Kind::Truncate: {
-            const auto truncate = dynCast<const Ir::TruncateInst>(inst.get());
+            const auto truncate = dynCast<const Ir::TruncateInst>(&inst);
             genTruncate(*truncate);
             break;
         }
         case Kind::ZeroExtend: {
-            const auto zeroExtend = dynCast<const Ir::ZeroExtendInst>(inst.get());
+            const auto zeroExtend = dynCast<const Ir::ZeroExtendInst>(&inst);
             genZeroExtend(*zeroExtend);
             break;
         }
         case Kind::DoubleToInt: {
-            const auto doubleToInt = dynCast<const Ir::DoubleToIntInst>(inst.get());
+            const auto doubleToInt = dynCast<const Ir::DoubleToIntInst>(&inst);
             genDoubleToInt(*doubleToInt);
             break;
         }
         case Kind::DoubleToUInt: {
-            const auto doubleToUInt = dynCast<const Ir::DoubleToUIntInst>(inst.get());
+            const auto doubleToUInt = dynCast<const Ir::DoubleToUIntInst>(&inst);
             genDoubleToUInt(*doubleToUInt);
             break;
         }
         case Kind::IntToDouble: {
-            const auto intToDouble = dynCast<const Ir::IntToDoubleInst>(inst.get());
+            const auto intToDouble = dynCast<const Ir::IntToDoubleInst>(&inst);
             genIntToDouble(*intToDouble);
             break;
         }
         case Kind::UIntToDouble: {
-            const auto uIntToDouble = dynCast<const Ir::UIntToDoubleInst>(inst.get());
+            const auto uIntToDouble = dynCast<const Ir::UIntToDoubleInst>(&inst);
             genUIntToDouble(*uIntToDouble);
             break;
         }
         case Kind::Unary: {
-            const auto irUnary = dynCast<const Ir::UnaryInst>(inst.get());
+            const auto irUnary = dynCast<const Ir::UnaryInst>(&inst);
             genUnary(*irUnary);
             break;
         }
         case Kind::Binary: {
-            const auto irBinary = dynCast<const Ir::BinaryInst>(inst.get());
+            const auto irBinary = dynCast<const Ir::BinaryInst>(&inst);
             genBinary(*irBinary);
             break;
         }
         case Kind::Copy: {
-            const auto irCopy = dynCast<const Ir::CopyInst>(inst.get());
+            const auto irCopy = dynCast<const Ir::CopyInst>(&inst);
             genCopy(*irCopy);
             break;
         }
         case Kind::Jump: {
-            const auto irJump = dynCast<const Ir::JumpInst>(inst.get());
+            const auto irJump = dynCast<const Ir::JumpInst>(&inst);
             genJump(*irJump);
             break;
         }
         case Kind::JumpIfZero: {
-            const auto irJumpIfZero = dynCast<const Ir::JumpIfZeroInst>(inst.get());
+            const auto irJumpIfZero = dynCast<const Ir::JumpIfZeroInst>(&inst);
             genJumpIfZero(*irJumpIfZero);
             break;
         }
         case Kind::JumpIfNotZero: {
-            const auto irJumpIfNotZero = dynCast<const Ir::JumpIfNotZeroInst>(inst.get());
+            const auto irJumpIfNotZero = dynCast<const Ir::JumpIfNotZeroInst>(&inst);
             genJumpIfNotZero(*irJumpIfNotZero);
             break;
         }
         case Kind::Label: {
-            const auto irLabel = dynCast<const Ir::LabelInst>(inst.get());
+            const auto irLabel = dynCast<const Ir::LabelInst>(&inst);
             genLabel(*irLabel);
             break;
         }
         case Kind::FunCall: {
-            const auto irFunCall = dynCast<const Ir::FunCallInst>(inst.get());
+            const auto irFunCall = dynCast<const Ir::FunCallInst>(&inst);
             genFunCall(*irFunCall);
             break;
         }
         case Kind::Store: {
-            const auto irStore = dynCast<const Ir::StoreInst>(inst.get());
+            const auto irStore = dynCast<const Ir::StoreInst>(&inst);
             genStore(*irStore);
             break;
         }
         case Kind::Load: {
-            const auto irLoad = dynCast<const Ir::LoadInst>(inst.get());
+            const auto irLoad = dynCast<const Ir::LoadInst>(&inst);
             genLoad(*irLoad);
             break;
         }
         case Kind::GetAddress: {
-            const auto irGetAddress = dynCast<const Ir::GetAddressInst>(inst.get());
+            const auto irGetAddress = dynCast<const Ir::GetAddressInst>(&inst);
             genGetAddress(*irGetAddress);
             break;
         }
         case Kind::AddPtr: {
-            const auto irAddPtr = dynCast<const Ir::AddPtrInst>(inst.get());
+            const auto irAddPtr = dynCast<const Ir::AddPtrInst>(&inst);
             genAddPtr(*irAddPtr);
             break;
         }
         case Kind::CopyToOffset: {
-            const auto irCopyToOffset = dynCast<const Ir::CopyToOffsetInst>(inst.get());
+            const auto irCopyToOffset = dynCast<const Ir::CopyToOffsetInst>(&inst);
             genCopyToOffSet(*irCopyToOffset);
             break;
         }
         case Kind::Allocate: {
-            const auto allocate = dynCast<const Ir::AllocateInst>(inst.get());
+            const auto allocate = dynCast<const Ir::AllocateInst>(&inst);
             genAllocate(*allocate);
             break;
         }
@@ -288,7 +334,7 @@ void GenerateAsmTree::genInst(const std::unique_ptr<Ir::Instruction>& inst)
 
 void GenerateAsmTree::genJump(const Ir::JumpInst& irJump)
 {
-    const Identifier iden(irJump.target.value);
+    const Identifier iden(label(irJump.target));
     emplaceJmp(iden);
 }
 
@@ -303,9 +349,9 @@ void GenerateAsmTree::genJumpIfZero(const Ir::JumpIfZeroInst& jumpIfZero)
 
 void GenerateAsmTree::genJumpIfZeroDouble(const Ir::JumpIfZeroInst& jumpIfZero)
 {
-    const auto xmm0 = std::make_shared<RegisterOperand>(RegType::XMM0, AsmType::Double);
-    const std::shared_ptr<Operand> condition = genOperand(jumpIfZero.condition);
-    const Identifier target(jumpIfZero.target.value);
+    const auto xmm0 = RegisterOperand(RegType::XMM0, AsmType::Double);
+    const Operand condition = genOperand(jumpIfZero.condition);
+    const Identifier target(label(jumpIfZero.target));
     const Identifier endLabel(makeTemporaryPseudoName());
 
     zeroOutReg(xmm0);
@@ -318,11 +364,11 @@ void GenerateAsmTree::genJumpIfZeroDouble(const Ir::JumpIfZeroInst& jumpIfZero)
 
 void GenerateAsmTree::genJumpIfZeroInteger(const Ir::JumpIfZeroInst& jumpIfZero)
 {
-    const std::shared_ptr<Operand> condition = genOperand(jumpIfZero.condition);
-    const std::shared_ptr<Operand> zero = getZeroOperand(condition->type);
-    const Identifier target(jumpIfZero.target.value);
+    const Operand condition = genOperand(jumpIfZero.condition);
+    const Operand zero = getZeroOperand(condition.type);
+    const Identifier target(label(jumpIfZero.target));
 
-    emplaceCmp(zero, condition, condition->type);
+    emplaceCmp(zero, condition, condition.type);
     emplaceJmpCC(BinaryInst::CondCode::E, target);
 }
 
@@ -337,9 +383,9 @@ void GenerateAsmTree::genJumpIfNotZero(const Ir::JumpIfNotZeroInst& jumpIfNotZer
 
 void GenerateAsmTree::genJumpIfNotZeroDouble(const Ir::JumpIfNotZeroInst& jumpIfNotZero)
 {
-    const auto xmm0 = std::make_shared<RegisterOperand>(RegType::XMM0, AsmType::Double);
-    const std::shared_ptr<Operand> condition = genOperand(jumpIfNotZero.condition);
-    const Identifier target(jumpIfNotZero.target.value);
+    const auto xmm0 = RegisterOperand(RegType::XMM0, AsmType::Double);
+    const Operand condition = genOperand(jumpIfNotZero.condition);
+    const Identifier target(label(jumpIfNotZero.target));
 
     zeroOutReg(xmm0);
 
@@ -350,54 +396,53 @@ void GenerateAsmTree::genJumpIfNotZeroDouble(const Ir::JumpIfNotZeroInst& jumpIf
 
 void GenerateAsmTree::genJumpIfNotZeroInteger(const Ir::JumpIfNotZeroInst& jumpIfNotZero)
 {
-    const std::shared_ptr<Operand> condition = genOperand(jumpIfNotZero.condition);
-    const std::shared_ptr<Operand> zero = getZeroOperand(condition->type);
-    const Identifier target(jumpIfNotZero.target.value);
+    const Operand condition = genOperand(jumpIfNotZero.condition);
+    const Operand zero = getZeroOperand(condition.type);
+    const Identifier target(label(jumpIfNotZero.target));
 
-    emplaceCmp(zero, condition, condition->type);
+    emplaceCmp(zero, condition, condition.type);
     emplaceJmpCC(Inst::CondCode::NE, target);
 }
 
 void GenerateAsmTree::genCopy(const Ir::CopyInst& copy)
 {
-    const std::shared_ptr<Operand> src = genOperand(copy.src);
-    const std::shared_ptr<Operand> dst = genOperand(copy.dst);
-    emplaceMove(src, dst, src->type);
+    const Operand src = genOperand(copy.src);
+    const Operand dst = genOperand(copy.dst);
+    emplaceMove(src, dst, src.type);
 }
 
 void GenerateAsmTree::genGetAddress(const Ir::GetAddressInst& getAddress)
 {
-    const std::shared_ptr<Operand> src = genOperand(getAddress.src);
-    const std::shared_ptr<Operand> dst = genOperand(getAddress.dst);
+    const Operand src = genOperand(getAddress.src);
+    const Operand dst = genOperand(getAddress.dst);
     emplaceLea(src, dst, AsmType::QuadWord);
 }
 
 void GenerateAsmTree::genLoad(const Ir::LoadInst& load)
 {
-    const std::shared_ptr<Operand> ptr = genOperand(load.ptr);
-    const std::shared_ptr<Operand> dst = genOperand(load.dst);
-    const auto rax = std::make_shared<RegisterOperand>(RegType::DX, AsmType::QuadWord);
-    const auto memory = std::make_shared<MemoryOperand>(RegType::DX, 0, AsmType::QuadWord);
+    const Operand ptr = genOperand(load.ptr);
+    const Operand dst = genOperand(load.dst);
+    const auto rax = RegisterOperand(RegType::DX, AsmType::QuadWord);
+    const auto memory = MemoryOperand(RegType::DX, 0, AsmType::QuadWord);
 
     emplaceMove(ptr, rax, AsmType::QuadWord);
-    emplaceMove(memory, dst, dst->type);
+    emplaceMove(memory, dst, dst.type);
 }
 
 void GenerateAsmTree::genStore(const Ir::StoreInst& store)
 {
-    const std::shared_ptr<Operand> src = genOperand(store.src);
-    const std::shared_ptr<Operand> ptr = genOperand(store.ptr);
-    const auto rax = std::make_shared<RegisterOperand>(RegType::DX, AsmType::QuadWord);
-    const auto memory = std::make_shared<MemoryOperand>(RegType::DX, 0, AsmType::QuadWord);
+    const Operand src = genOperand(store.src);
+    const Operand ptr = genOperand(store.ptr);
+    const auto rax = RegisterOperand(RegType::DX, AsmType::QuadWord);
+    const auto memory = MemoryOperand(RegType::DX, 0, AsmType::QuadWord);
 
     emplaceMove(ptr, rax, AsmType::QuadWord);
-    emplaceMove(src, memory, src->type);
+    emplaceMove(src, memory, src.type);
 }
 
 void GenerateAsmTree::genLabel(const Ir::LabelInst& irLabel)
 {
-    const Identifier label(irLabel.target.value);
-    emplaceLabel(label);
+    emplaceLabel(Identifier(label(irLabel.target)));
 }
 
 void GenerateAsmTree::genUnary(const Ir::UnaryInst& irUnary)
@@ -417,27 +462,27 @@ void GenerateAsmTree::genUnary(const Ir::UnaryInst& irUnary)
 void GenerateAsmTree::genUnaryBasic(const Ir::UnaryInst& irUnary)
 {
     const UnaryInst::Operator oper = Operators::unaryOperator(irUnary.operation);
-    const std::shared_ptr<Operand> src = genOperand(irUnary.src);
-    const std::shared_ptr<Operand> dst = genOperand(irUnary.dst);
+    const Operand src = genOperand(irUnary.src);
+    const Operand dst = genOperand(irUnary.dst);
 
-    emplaceMove(src, dst, src->type);
-    emplaceUnary(dst, oper, src->type);
+    emplaceMove(src, dst, src.type);
+    emplaceUnary(dst, oper, src.type);
 }
 
 void GenerateAsmTree::genNegateDouble(const Ir::UnaryInst& irUnary)
 {
     using Operator = BinaryInst::Operator;
-    const std::shared_ptr<Operand> src = genOperand(irUnary.src);
-    const std::shared_ptr<Operand> rhs = genOperand(irUnary.dst);
-    const std::shared_ptr<Operand> lhs = genDoubleLocalConst(-0.0, 16);
+    const Operand src = genOperand(irUnary.src);
+    const Operand rhs = genOperand(irUnary.dst);
+    const Operand lhs = genDoubleLocalConst(-0.0, 16);
 
-    emplaceMove(src, rhs, src->type);
+    emplaceMove(src, rhs, src.type);
     emplaceBinary(lhs, rhs, Operator::BitwiseXor, AsmType::Double);
 }
 
 void GenerateAsmTree::genUnaryNot(const Ir::UnaryInst& irUnary)
 {
-    if (irUnary.src->type != Type::Double)
+    if (value(irUnary.src).type != Type::Double)
         genUnaryNotInteger(irUnary);
     else
         genUnaryNotDouble(irUnary);
@@ -445,57 +490,56 @@ void GenerateAsmTree::genUnaryNot(const Ir::UnaryInst& irUnary)
 
 void GenerateAsmTree::genUnaryNotDouble(const Ir::UnaryInst& irUnary)
 {
-    const std::shared_ptr<Operand> src = genOperand(irUnary.src);
-    const std::shared_ptr<Operand> dst = genOperand(irUnary.dst);
-    const auto zero = getZeroOperand(dst->type);
-    const auto one = std::make_shared<ImmOperand>(1, AsmType::LongWord);
-    const auto xmm0 = std::make_shared<RegisterOperand>(RegType::XMM0, AsmType::Double);
-    const Identifier nanLabel(makeTemporaryPseudoName() + "nanUnaryNot");
+    const Operand src = genOperand(irUnary.src);
+    const Operand dst = genOperand(irUnary.dst);
+    const auto zero = getZeroOperand(dst.type);
+    const auto xmm0 = RegisterOperand(RegType::XMM0, AsmType::Double);
+    const Identifier nanLabel(makeTemporaryPseudoName(".nanUnaryNot"));
     const Identifier endLabel(makeTemporaryPseudoName());
 
     zeroOutReg(xmm0);
 
     emplaceCmp(src, xmm0, AsmType::Double);
     emplaceJmpCC(BinaryInst::CondCode::PF, nanLabel);
-    emplaceMove(zero, dst, dst->type);
+    emplaceMove(zero, dst, dst.type);
     emplaceSetCC(BinaryInst::CondCode::E, dst);
     emplaceJmp(endLabel);
     emplaceLabel(nanLabel);
-    emplaceMove(zero, dst, dst->type);
+    emplaceMove(zero, dst, dst.type);
     emplaceLabel(endLabel);
 }
 
 void GenerateAsmTree::genUnaryNotInteger(const Ir::UnaryInst& irUnary)
 {
-    const std::shared_ptr<Operand> src = genOperand(irUnary.src);
-    const std::shared_ptr<Operand> zero = getZeroOperand(src->type);
-    const std::shared_ptr<Operand> dst = genOperand(irUnary.dst);
+    const Operand src = genOperand(irUnary.src);
+    const Operand zero = getZeroOperand(src.type);
+    const Operand dst = genOperand(irUnary.dst);
 
-    emplaceCmp(zero, src, src->type);
-    emplaceMove(zero, dst, dst->type);
+    emplaceCmp(zero, src, src.type);
+    emplaceMove(zero, dst, dst.type);
     emplaceSetCC(BinaryInst::CondCode::E, dst);
 }
 
 void GenerateAsmTree::genZeroExtend(const Ir::ZeroExtendInst& zeroExtend)
 {
-    const std::shared_ptr<Operand> src = genOperand(zeroExtend.src);
-    const std::shared_ptr<Operand> dst = genOperand(zeroExtend.dst);
-    emplaceMoveZeroExtend(src, dst, src->type, dst->type);
+    const Operand src = genOperand(zeroExtend.src);
+    const Operand dst = genOperand(zeroExtend.dst);
+    emplaceMoveZeroExtend(src, dst, src.type, dst.type);
 }
 
 void GenerateAsmTree::genDoubleToInt(const Ir::DoubleToIntInst& doubleToInt)
 {
-    const std::shared_ptr<Operand> src = genOperand(doubleToInt.src);
-    const std::shared_ptr<Operand> dst = genOperand(doubleToInt.dst);
+    const Operand src = genOperand(doubleToInt.src);
+    const Operand dst = genOperand(doubleToInt.dst);
 
-    if (Operators::getSizeAsmType(dst->type) < 4) {
-        const auto raxLongWord = std::make_shared<RegisterOperand>(RegType::AX, AsmType::LongWord);
+    if (Operators::getSizeAsmType(dst.type) < 4) {
+        const auto raxLongWord = RegisterOperand(RegType::AX, AsmType::LongWord);
         emplaceCvttsd2si(src, raxLongWord, AsmType::LongWord);
-        const auto raxByte = std::make_shared<RegisterOperand>(RegType::AX, AsmType::Byte);
-        emplaceMove(raxByte, dst, dst->type);
+        const auto raxByte = RegisterOperand(RegType::AX, AsmType::Byte);
+        emplaceMove(raxByte, dst, dst.type);
     }
     else
-        emplaceCvttsd2si(src, dst, dst->type);
+        emplaceCvttsd2si(src, dst, dst.type);
 }
 
 void GenerateAsmTree::genDoubleToUInt(const Ir::DoubleToUIntInst& doubleToUInt)
@@ -510,34 +554,34 @@ void GenerateAsmTree::genDoubleToUInt(const Ir::DoubleToUIntInst& doubleToUInt)
 
 void GenerateAsmTree::genDoubleToUIntByte(const Ir::DoubleToUIntInst& doubleToUInt)
 {
-    const std::shared_ptr<Operand> src = genOperand(doubleToUInt.src);
-    const std::shared_ptr<Operand> dst = genOperand(doubleToUInt.dst);
-    const auto rax = std::make_shared<RegisterOperand>(RegType::AX, AsmType::LongWord);
-    const auto eax = std::make_shared<RegisterOperand>(RegType::AX, AsmType::Byte);
+    const Operand src = genOperand(doubleToUInt.src);
+    const Operand dst = genOperand(doubleToUInt.dst);
+    const auto rax = RegisterOperand(RegType::AX, AsmType::LongWord);
+    const auto eax = RegisterOperand(RegType::AX, AsmType::Byte);
 
     emplaceCvttsd2si(src, rax, AsmType::LongWord);
-    emplaceMove(eax, dst, dst->type);
+    emplaceMove(eax, dst, dst.type);
 }
 
 void GenerateAsmTree::genDoubleToUIntLong(const Ir::DoubleToUIntInst& doubleToUInt)
 {
-    const std::shared_ptr<Operand> src = genOperand(doubleToUInt.src);
-    const std::shared_ptr<Operand> dst = genOperand(doubleToUInt.dst);
-    const auto rax = std::make_shared<RegisterOperand>(RegType::AX, AsmType::QuadWord);
-    const auto eax = std::make_shared<RegisterOperand>(RegType::AX, AsmType::LongWord);
+    const Operand src = genOperand(doubleToUInt.src);
+    const Operand dst = genOperand(doubleToUInt.dst);
+    const auto rax = RegisterOperand(RegType::AX, AsmType::QuadWord);
+    const auto eax = RegisterOperand(RegType::AX, AsmType::LongWord);
 
     emplaceCvttsd2si(src, rax, AsmType::QuadWord);
-    emplaceMove(eax, dst, dst->type);
+    emplaceMove(eax, dst, dst.type);
 }
 
 void GenerateAsmTree::genDoubleToUIntQuad(const Ir::DoubleToUIntInst& doubleToUInt)
 {
     constexpr double upperBoundConst = 9223372036854775808.0;
-    const std::shared_ptr<Operand> upperBound = genDoubleLocalConst(upperBoundConst, 8);
-    const std::shared_ptr<Operand> src = genOperand(doubleToUInt.src);
-    const std::shared_ptr<Operand> dst = genOperand(doubleToUInt.dst);
-    const auto xmm0 = std::make_shared<RegisterOperand>(RegType::XMM0, AsmType::Double);
-    const auto xmm1 = std::make_shared<RegisterOperand>(RegType::XMM1, AsmType::Double);
+    const Operand upperBound = genDoubleLocalConst(upperBoundConst, 8);
+    const Operand src = genOperand(doubleToUInt.src);
+    const Operand dst = genOperand(doubleToUInt.dst);
+    const auto xmm0 = RegisterOperand(RegType::XMM0, AsmType::Double);
+    const auto xmm1 = RegisterOperand(RegType::XMM1, AsmType::Double);
     const Identifier labelOne(makeTemporaryPseudoName());
     const Identifier labelTwo(makeTemporaryPseudoName());
 
@@ -555,33 +599,33 @@ void GenerateAsmTree::genDoubleToUIntQuad(const Ir::DoubleToUIntInst& doubleToUI
 
 void GenerateAsmTree::genIntToDouble(const Ir::IntToDoubleInst& intToDouble)
 {
-    const std::shared_ptr<Operand> src = genOperand(intToDouble.src);
-    const std::shared_ptr<Operand> dst = genOperand(intToDouble.dst);
+    const Operand src = genOperand(intToDouble.src);
+    const Operand dst = genOperand(intToDouble.dst);
 
-    if (Operators::getSizeAsmType(src->type) < 4) {
-        const auto rax = std::make_shared<RegisterOperand>(RegType::AX, AsmType::LongWord);
+    if (Operators::getSizeAsmType(src.type) < 4) {
+        const auto rax = RegisterOperand(RegType::AX, AsmType::LongWord);
         emplaceMoveSX(src, rax, AsmType::Byte, AsmType::LongWord);
         emplaceCvtsi2sd(rax, dst, AsmType::LongWord);
     }
     else
-        emplaceCvtsi2sd(src, dst, src->type);
+        emplaceCvtsi2sd(src, dst, src.type);
 }
 
 void GenerateAsmTree::genUIntToDouble(const Ir::UIntToDoubleInst& uintToDouble)
 {
-    if (uintToDouble.src->type == Type::U8)
+    if (value(uintToDouble.src).type == Type::U8)
         genUIntToDoubleByte(uintToDouble);
-    if (uintToDouble.src->type == Type::U32)
+    if (value(uintToDouble.src).type == Type::U32)
         genUIntToDoubleLong(uintToDouble);
-    if (uintToDouble.src->type == Type::U64)
+    if (value(uintToDouble.src).type == Type::U64)
         genUIntToDoubleQuad(uintToDouble);
 }
 
 void GenerateAsmTree::genUIntToDoubleByte(const Ir::UIntToDoubleInst& uintToDouble)
 {
-    const std::shared_ptr<Operand> src = genOperand(uintToDouble.src);
-    const std::shared_ptr<Operand> rax = std::make_unique<RegisterOperand>(RegType::AX, AsmType::LongWord);
-    const std::shared_ptr<Operand> dst = genOperand(uintToDouble.dst);
+    const Operand src = genOperand(uintToDouble.src);
+    const Operand rax = RegisterOperand(RegType::AX, AsmType::LongWord);
+    const Operand dst = genOperand(uintToDouble.dst);
 
     emplaceMoveZeroExtend(src, rax, AsmType::Byte, AsmType::LongWord);
     emplaceCvtsi2sd(rax, dst, AsmType::LongWord);
@@ -589,9 +633,9 @@ void GenerateAsmTree::genUIntToDoubleByte(const Ir::UIntToDoubleInst& uintToDoub
 
 void GenerateAsmTree::genUIntToDoubleLong(const Ir::UIntToDoubleInst& uintToDouble)
 {
-    const std::shared_ptr<Operand> src = genOperand(uintToDouble.src);
-    const std::shared_ptr<Operand> rax = std::make_unique<RegisterOperand>(RegType::AX, AsmType::QuadWord);
-    const std::shared_ptr<Operand> dst = genOperand(uintToDouble.dst);
+    const Operand src = genOperand(uintToDouble.src);
+    const Operand rax = RegisterOperand(RegType::AX, AsmType::QuadWord);
+    const Operand dst = genOperand(uintToDouble.dst);
 
     emplaceMoveZeroExtend(src, rax, AsmType::LongWord, AsmType::QuadWord);
     emplaceCvtsi2sd(rax, dst, AsmType::QuadWord);
@@ -602,14 +646,14 @@ void GenerateAsmTree::genUIntToDoubleQuad(const Ir::UIntToDoubleInst& uintToDoub
     using UnaryOper = UnaryInst::Operator;
     using BinaryOper = BinaryInst::Operator;
 
-    const std::shared_ptr<Operand> zero = getZeroOperand(AsmType::QuadWord);
-    const std::shared_ptr<Operand> src = genOperand(uintToDouble.src);
+    const Operand zero = getZeroOperand(AsmType::QuadWord);
+    const Operand src = genOperand(uintToDouble.src);
     const Identifier labelOutOfRange(makeTemporaryPseudoName());
-    const std::shared_ptr<Operand> dst = genOperand(uintToDouble.dst);
+    const Operand dst = genOperand(uintToDouble.dst);
     const Identifier labelEnd(makeTemporaryPseudoName());
-    const auto rax = std::make_shared<RegisterOperand>(RegType::AX, AsmType::QuadWord);
-    const auto rdx = std::make_shared<RegisterOperand>(RegType::DX, AsmType::QuadWord);
-    const auto one = std::make_shared<ImmOperand>(1l, AsmType::QuadWord);
+    const auto rax = RegisterOperand(RegType::AX, AsmType::QuadWord);
+    const auto rdx = RegisterOperand(RegType::DX, AsmType::QuadWord);
+    const auto one = ImmOperand(1l, AsmType::QuadWord);
 
     emplaceCmp(zero, src, AsmType::QuadWord);
     emplaceJmpCC(Inst::CondCode::L, labelOutOfRange);
@@ -628,16 +672,16 @@ void GenerateAsmTree::genUIntToDoubleQuad(const Ir::UIntToDoubleInst& uintToDoub
 
 void GenerateAsmTree::genSignExtend(const Ir::SignExtendInst& signExtend)
 {
-    const std::shared_ptr<Operand> src = genOperand(signExtend.src);
-    const std::shared_ptr<Operand> dst = genOperand(signExtend.dst);
-    emplaceMoveSX(src, dst, src->type, dst->type);
+    const Operand src = genOperand(signExtend.src);
+    const Operand dst = genOperand(signExtend.dst);
+    emplaceMoveSX(src, dst, src.type, dst.type);
 }
 
 void GenerateAsmTree::genTruncate(const Ir::TruncateInst& truncate)
 {
-    const std::shared_ptr<Operand> src = genOperand(truncate.src);
-    const std::shared_ptr<Operand> dst = genOperand(truncate.dst);
-    emplaceMove(src, dst, dst->type);
+    const Operand src = genOperand(truncate.src);
+    const Operand dst = genOperand(truncate.dst);
+    emplaceMove(src, dst, dst.type);
 }
 
 void GenerateAsmTree::genBinary(const Ir::BinaryInst& irBinary)
@@ -678,7 +722,7 @@ void GenerateAsmTree::genBinary(const Ir::BinaryInst& irBinary)
 
 void GenerateAsmTree::genBinaryCond(const Ir::BinaryInst& irBinary)
 {
-    if (irBinary.lhs->type == Type::Double) {
+    if (value(irBinary.lhs).type == Type::Double) {
         genBinaryCondDouble(irBinary);
         return;
     }
@@ -687,36 +731,36 @@ void GenerateAsmTree::genBinaryCond(const Ir::BinaryInst& irBinary)
 
 void GenerateAsmTree::genBinaryCondInteger(const Ir::BinaryInst& irBinary)
 {
-    const std::shared_ptr<Operand> lhs = genOperand(irBinary.lhs);
-    const std::shared_ptr<Operand> rhs = genOperand(irBinary.rhs);
-    const std::shared_ptr<Operand> dst = genOperand(irBinary.dst);
-    const std::shared_ptr<Operand> zero = getZeroOperand(AsmType::LongWord);
-    const BinaryInst::CondCode cc = Operators::condCode(irBinary.operation, isSigned(irBinary.lhs->type));
+    const Operand lhs = genOperand(irBinary.lhs);
+    const Operand rhs = genOperand(irBinary.rhs);
+    const Operand dst = genOperand(irBinary.dst);
+    const Operand zero = getZeroOperand(AsmType::LongWord);
+    const BinaryInst::CondCode cc = Operators::condCode(irBinary.operation, isSigned(value(irBinary.lhs).type));
 
-    emplaceCmp(rhs, lhs, lhs->type);
-    emplaceMove(zero, dst, dst->type);
+    emplaceCmp(rhs, lhs, lhs.type);
+    emplaceMove(zero, dst, dst.type);
     emplaceSetCC(cc, dst);
 }
 
 void GenerateAsmTree::genBinaryCondDouble(const Ir::BinaryInst& irBinary)
 {
-    const std::shared_ptr<Operand> lhs = genOperand(irBinary.lhs);
-    const std::shared_ptr<Operand> rhs = genOperand(irBinary.rhs);
-    const std::shared_ptr<Operand> dst = genOperand(irBinary.dst);
-    const std::shared_ptr<Operand> zero = getZeroOperand(AsmType::LongWord);
+    const Operand lhs = genOperand(irBinary.lhs);
+    const Operand rhs = genOperand(irBinary.rhs);
+    const Operand dst = genOperand(irBinary.dst);
+    const Operand zero = getZeroOperand(AsmType::LongWord);
     const BinaryInst::CondCode cc = Operators::condCode(irBinary.operation, false);
     const Identifier nanLabel(makeTemporaryPseudoName());
     const Identifier endLabel(makeTemporaryPseudoName());
 
-    emplaceCmp(rhs, lhs, lhs->type);
-    emplaceMove(zero, dst, dst->type);
+    emplaceCmp(rhs, lhs, lhs.type);
+    emplaceMove(zero, dst, dst.type);
     emplaceJmpCC(Inst::CondCode::PF, nanLabel);
     emplaceSetCC(cc, dst);
     emplaceJmp(endLabel);
     emplaceLabel(nanLabel);
     if (cc == Inst::CondCode::NE) {
-        const auto one = std::make_shared<ImmOperand>(1, AsmType::LongWord);
-        emplaceMove(one, dst, dst->type);
+        const auto one = ImmOperand(1, AsmType::LongWord);
+        emplaceMove(one, dst, dst.type);
     }
     emplaceLabel(endLabel);
 }
@@ -736,9 +780,9 @@ void GenerateAsmTree::genBinaryDivide(const Ir::BinaryInst& irBinary)
 
 void GenerateAsmTree::genBinaryDivideDouble(const Ir::BinaryInst& irBinary)
 {
-    const std::shared_ptr<Operand> lhs = genOperand(irBinary.lhs);
-    const std::shared_ptr<Operand> dst = genOperand(irBinary.dst);
-    const std::shared_ptr<Operand> rhs = genOperand(irBinary.rhs);
+    const Operand lhs = genOperand(irBinary.lhs);
+    const Operand dst = genOperand(irBinary.dst);
+    const Operand rhs = genOperand(irBinary.rhs);
 
     emplaceMove(lhs, dst, AsmType::Double);
     emplaceBinary(rhs, dst, BinaryInst::Operator::DivDouble, AsmType::Double);
@@ -746,31 +790,31 @@ void GenerateAsmTree::genBinaryDivideDouble(const Ir::BinaryInst& irBinary)
 
 void GenerateAsmTree::genBinaryDivideSigned(const Ir::BinaryInst& irBinary)
 {
-    const std::shared_ptr<Operand> src1 = genOperand(irBinary.lhs);
-    const auto regAX = std::make_shared<RegisterOperand>(RegType::AX, Operators::getAsmType(irBinary.type));
-    const std::shared_ptr<Operand> src2 = genOperand(irBinary.rhs);
-    const std::shared_ptr<Operand> dst = genOperand(irBinary.dst);
+    const Operand src1 = genOperand(irBinary.lhs);
+    const auto regAX = RegisterOperand(RegType::AX, Operators::getAsmType(irBinary.type));
+    const Operand src2 = genOperand(irBinary.rhs);
+    const Operand dst = genOperand(irBinary.dst);
 
-    emplaceMove(src1, regAX, src1->type);
-    emplaceCdq(src1->type);
-    emplaceIdiv(src2, src1->type);
-    emplaceMove(regAX, dst, src1->type);
+    emplaceMove(src1, regAX, src1.type);
+    emplaceCdq(src1.type);
+    emplaceIdiv(src2, src1.type);
+    emplaceMove(regAX, dst, src1.type);
 }
 
 void GenerateAsmTree::genUnsignedBinaryDivide(const Ir::BinaryInst& irBinary)
 {
-    const std::shared_ptr<Operand> src1 = genOperand(irBinary.lhs);
-    const auto zero = getZeroOperand(src1->type);
-    const auto regAX = std::make_shared<RegisterOperand>(RegType::AX, Operators::getAsmType(irBinary.type));
-    const auto regDX = std::make_shared<RegisterOperand>(
+    const Operand src1 = genOperand(irBinary.lhs);
+    const auto zero = getZeroOperand(src1.type);
+    const auto regAX = RegisterOperand(RegType::AX, Operators::getAsmType(irBinary.type));
+    const auto regDX = RegisterOperand(
         RegType::DX, Operators::getAsmType(irBinary.type));
-    const std::shared_ptr<Operand> src2 = genOperand(irBinary.rhs);
-    const std::shared_ptr<Operand> dst = genOperand(irBinary.dst);
+    const Operand src2 = genOperand(irBinary.rhs);
+    const Operand dst = genOperand(irBinary.dst);
 
-    emplaceMove(src1, regAX, src1->type);
-    emplaceMove(zero, regDX, src1->type);
-    emplaceDiv(src2, src1->type);
-    emplaceMove(regAX, dst, src1->type);
+    emplaceMove(src1, regAX, src1.type);
+    emplaceMove(zero, regDX, src1.type);
+    emplaceDiv(src2, src1.type);
+    emplaceMove(regAX, dst, src1.type);
 }
 
 void GenerateAsmTree::genBinaryRemainder(const Ir::BinaryInst& irBinary)
@@ -784,59 +828,59 @@ void GenerateAsmTree::genBinaryRemainder(const Ir::BinaryInst& irBinary)
 
 void GenerateAsmTree::genSignedBinaryRemainder(const Ir::BinaryInst& irBinary)
 {
-    const std::shared_ptr<Operand> src1 = genOperand(irBinary.lhs);
-    const auto regAX = std::make_shared<RegisterOperand>(RegType::AX, Operators::getAsmType(irBinary.type));
-    const std::shared_ptr<Operand> src2 = genOperand(irBinary.rhs);
-    const std::shared_ptr<Operand> dst = genOperand(irBinary.dst);
-    const auto regDX = std::make_shared<RegisterOperand>(RegType::DX, Operators::getAsmType(irBinary.type));
+    const Operand src1 = genOperand(irBinary.lhs);
+    const auto regAX = RegisterOperand(RegType::AX, Operators::getAsmType(irBinary.type));
+    const Operand src2 = genOperand(irBinary.rhs);
+    const Operand dst = genOperand(irBinary.dst);
+    const auto regDX = RegisterOperand(RegType::DX, Operators::getAsmType(irBinary.type));
 
-    emplaceMove(src1, regAX, src1->type);
-    emplaceCdq(src1->type);
-    emplaceIdiv(src2, src1->type);
-    emplaceMove(regDX, dst, src1->type);
+    emplaceMove(src1, regAX, src1.type);
+    emplaceCdq(src1.type);
+    emplaceIdiv(src2, src1.type);
+    emplaceMove(regDX, dst, src1.type);
 }
 
 void GenerateAsmTree::genUnsignedBinaryRemainder(const Ir::BinaryInst& irBinary)
 {
-    const std::shared_ptr<Operand> lhs = genOperand(irBinary.lhs);
-    const auto zero = getZeroOperand(lhs->type);
-    const auto regAX = std::make_shared<RegisterOperand>(RegType::AX, Operators::getAsmType(irBinary.type));
-    const auto regDX = std::make_shared<RegisterOperand>(RegType::DX, Operators::getAsmType(irBinary.type));
-    const std::shared_ptr<Operand> rhs = genOperand(irBinary.rhs);
-    const std::shared_ptr<Operand> dst = genOperand(irBinary.dst);
+    const Operand lhs = genOperand(irBinary.lhs);
+    const auto zero = getZeroOperand(lhs.type);
+    const auto regAX = RegisterOperand(RegType::AX, Operators::getAsmType(irBinary.type));
+    const auto regDX = RegisterOperand(RegType::DX, Operators::getAsmType(irBinary.type));
+    const Operand rhs = genOperand(irBinary.rhs);
+    const Operand dst = genOperand(irBinary.dst);
 
-    emplaceMove(lhs, regAX, lhs->type);
-    emplaceMove(zero, regDX, lhs->type);
-    emplaceDiv(rhs, lhs->type);
-    emplaceMove(regDX, dst, lhs->type);
+    emplaceMove(lhs, regAX, lhs.type);
+    emplaceMove(zero, regDX, lhs.type);
+    emplaceDiv(rhs, lhs.type);
+    emplaceMove(regDX, dst, lhs.type);
 }
 
 void GenerateAsmTree::genBinaryBasic(const Ir::BinaryInst& irBinary)
 {
-    const std::shared_ptr<Operand> lhs = genOperand(irBinary.lhs);
-    const std::shared_ptr<Operand> dst = genOperand(irBinary.dst);
+    const Operand lhs = genOperand(irBinary.lhs);
+    const Operand dst = genOperand(irBinary.dst);
     const BinaryInst::Operator oper = Operators::binaryOperator(irBinary.operation);
-    const std::shared_ptr<Operand> rhs = genOperand(irBinary.rhs);
+    const Operand rhs = genOperand(irBinary.rhs);
 
-    emplaceMove(lhs, dst, lhs->type);
-    emplaceBinary(rhs, dst, oper, lhs->type);
+    emplaceMove(lhs, dst, lhs.type);
+    emplaceBinary(rhs, dst, oper, lhs.type);
 }
 
 void GenerateAsmTree::genBinaryShift(const Ir::BinaryInst& irBinary)
 {
-    const std::shared_ptr<Operand> lhs = genOperand(irBinary.lhs);
-    const std::shared_ptr<Operand> dst = genOperand(irBinary.dst);
+    const Operand lhs = genOperand(irBinary.lhs);
+    const Operand dst = genOperand(irBinary.dst);
     const bool isSigned = irBinary.type == Type::I32 || irBinary.type == Type::I64;
     const BinaryInst::Operator oper = Operators::getShiftOperator(irBinary.operation, isSigned);
-    const std::shared_ptr<Operand> rhs = genOperand(irBinary.rhs);
+    const Operand rhs = genOperand(irBinary.rhs);
 
-    emplaceMove(lhs, dst, lhs->type);
-    emplaceBinary(rhs, dst, oper, lhs->type);
+    emplaceMove(lhs, dst, lhs.type);
+    emplaceBinary(rhs, dst, oper, lhs.type);
 }
 
 void GenerateAsmTree::genAddPtr(const Ir::AddPtrInst& addPtrInst)
 {
-    if (addPtrInst.index->kind == Ir::Value::Kind::Constant)
+    if (value(addPtrInst.index).isConstant())
         genAddPtrConstIndex(addPtrInst);
     else if (addPtrInst.scale == 1 || addPtrInst.scale == 4 ||
              addPtrInst.scale == 2 || addPtrInst.scale == 8) {
@@ -849,27 +893,26 @@ void GenerateAsmTree::genAddPtr(const Ir::AddPtrInst& addPtrInst)
 
 void GenerateAsmTree::genAddPtrConstIndex(const Ir::AddPtrInst& addPtrInst)
 {
-    const auto regAX = std::make_shared<RegisterOperand>(RegType::AX, Operators::getAsmType(addPtrInst.type));
+    const auto regAX = RegisterOperand(RegType::AX, Operators::getAsmType(addPtrInst.type));
     const auto ptr = genOperand(addPtrInst.ptr);
-    const auto constValue = dynCast<Ir::ValueConst>(addPtrInst.index.get());
-    const i64 index = std::get<i64>(constValue->value) * addPtrInst.scale;
-    const auto memoryOp = std::make_shared<MemoryOperand>(
-        RegType::AX, index, Operators::getAsmType(addPtrInst.ptr->type));
-    const std::shared_ptr<Operand> dst = genOperand(addPtrInst.dst);
+    const i64 index = value(addPtrInst.index).asI64() * addPtrInst.scale;
+    const auto memoryOp = MemoryOperand(
+        RegType::AX, index, Operators::getAsmType(value(addPtrInst.ptr).type));
+    const Operand dst = genOperand(addPtrInst.dst);
 
-    emplaceMove(ptr, regAX, Operators::getAsmType(addPtrInst.ptr->type));
-    emplaceLea(memoryOp, dst, Operators::getAsmType(addPtrInst.ptr->type));
+    emplaceMove(ptr, regAX, Operators::getAsmType(value(addPtrInst.ptr).type));
+    emplaceLea(memoryOp, dst, Operators::getAsmType(value(addPtrInst.ptr).type));
 }
 
 void GenerateAsmTree::genAddPtrVariableIndex1_2_4_8(const Ir::AddPtrInst& addPtrInst)
 {
-    const auto regAX = std::make_shared<RegisterOperand>(RegType::AX, Operators::getAsmType(addPtrInst.type));
-    const auto regDX = std::make_shared<RegisterOperand>(RegType::DX, Operators::getAsmType(addPtrInst.type));
+    const auto regAX = RegisterOperand(RegType::AX, Operators::getAsmType(addPtrInst.type));
+    const auto regDX = RegisterOperand(RegType::DX, Operators::getAsmType(addPtrInst.type));
     const auto ptr = genOperand(addPtrInst.ptr);
-    const std::shared_ptr<Operand> index = genOperand(addPtrInst.index);
-    const AsmType type = Operators::getAsmType(addPtrInst.ptr->type);
-    const auto indexed = std::make_shared<IndexedOperand>(RegType::AX, RegType::DX, addPtrInst.scale, type);
-    const std::shared_ptr<Operand> dst = genOperand(addPtrInst.dst);
+    const Operand index = genOperand(addPtrInst.index);
+    const AsmType type = Operators::getAsmType(value(addPtrInst.ptr).type);
+    const auto indexed = IndexedOperand(RegType::AX, RegType::DX, addPtrInst.scale, type);
+    const Operand dst = genOperand(addPtrInst.dst);
 
     emplaceMove(ptr, regAX, AsmType::QuadWord);
     emplaceMove(index, regDX, AsmType::QuadWord);
@@ -878,15 +921,15 @@ void GenerateAsmTree::genAddPtrVariableIndex1_2_4_8(const Ir::AddPtrInst& addPtr
 
 void GenerateAsmTree::genAddPtrVariableIndexAndOtherScale(const Ir::AddPtrInst& addPtrInst)
 {
-    const auto regAX = std::make_shared<RegisterOperand>(RegType::AX, Operators::getAsmType(addPtrInst.type));
-    const auto regDX = std::make_shared<RegisterOperand>(RegType::DX, Operators::getAsmType(addPtrInst.type));
+    const auto regAX = RegisterOperand(RegType::AX, Operators::getAsmType(addPtrInst.type));
+    const auto regDX = RegisterOperand(RegType::DX, Operators::getAsmType(addPtrInst.type));
     const auto ptr = genOperand(addPtrInst.ptr);
-    const std::shared_ptr<Operand> index = genOperand(addPtrInst.index);
-    const auto immScale = std::make_shared<ImmOperand>(addPtrInst.scale, AsmType::QuadWord);
-    const AsmType type = Operators::getAsmType(addPtrInst.ptr->type);
+    const Operand index = genOperand(addPtrInst.index);
+    const auto immScale = ImmOperand(addPtrInst.scale, AsmType::QuadWord);
+    const AsmType type = Operators::getAsmType(value(addPtrInst.ptr).type);
     constexpr i64 byteSize = 1;
-    const auto indexed = std::make_shared<IndexedOperand>(RegType::AX, RegType::DX, byteSize, type);
-    const std::shared_ptr<Operand> dst = genOperand(addPtrInst.dst);
+    const auto indexed = IndexedOperand(RegType::AX, RegType::DX, byteSize, type);
+    const Operand dst = genOperand(addPtrInst.dst);
 
     emplaceMove(ptr, regAX, AsmType::QuadWord);
     emplaceMove(index, regDX, AsmType::QuadWord);
@@ -897,19 +940,12 @@ void GenerateAsmTree::genAddPtrVariableIndexAndOtherScale(const Ir::AddPtrInst&
 void GenerateAsmTree::genCopyToOffSet(const Ir::CopyToOffsetInst& copyToOffset)
 {
     const auto src = genOperand(copyToOffset.src);
-    const AsmType srcType = src->type;
-    bool referingToLocal;
-    if (copyToOffset.src->kind == Ir::Value::Kind::Variable) {
-        const auto copyToOffSetSrcVar = dynCast<Ir::ValueVar>(copyToOffset.src.get());
-        referingToLocal = copyToOffSetSrcVar->referingTo == ReferingTo::Local;
-    }
-    if (copyToOffset.src->kind == Ir::Value::Kind::Constant)
-        referingToLocal = true;
-    const auto pseudoMem = std::make_shared<PseudoMemOperand>(
+    const AsmType srcType = src.type;
+    const Ir::Value& srcValue = value(copyToOffset.src);
+    const bool referingToLocal = srcValue.isConstant() || srcValue.referingTo == ReferingTo::Local;
+    const auto pseudoMem = PseudoMemOperand(
             Identifier(copyToOffset.iden.value),
             copyToOffset.offset,
-            copyToOffset.size,
-            copyToOffset.alignment,
             referingToLocal,
             srcType);
 
@@ -921,22 +957,22 @@ void GenerateAsmTree::genAllocate(const Ir::AllocateInst& allocate)
     emplacePushPseudo(allocate.size, Operators::getAsmType(allocate.type), allocate.iden.value);
 }
 
-std::shared_ptr<Operand> GenerateAsmTree::getReturnRegister(const Ir::ReturnInst& returnInst)
+Operand GenerateAsmTree::getReturnRegister(const Ir::ReturnInst& returnInst)
 {
     if (Operators::getAsmType(returnInst.type) == AsmType::Double)
-        return std::make_shared<RegisterOperand>(RegType::XMM0, Operators::getAsmType(returnInst.type));
+        return RegisterOperand(RegType::XMM0, Operators::getAsmType(returnInst.type));
     else
-        return std::make_shared<RegisterOperand>(RegType::AX, Operators::getAsmType(returnInst.type));
+        return RegisterOperand(RegType::AX, Operators::getAsmType(returnInst.type));
 }
 
 void GenerateAsmTree::genReturn(const Ir::ReturnInst& returnInst)
 {
-    if (!returnInst.returnValue) {
+    if (returnInst.returnValue == Ir::ValueId::None) {
         emplaceReturn();
         return;
     }
-    const std::shared_ptr<Operand> val = genOperand(returnInst.returnValue);
-    const std::shared_ptr<Operand> regReturn = getReturnRegister(returnInst);
+    const Operand val = genOperand(returnInst.returnValue);
+    const Operand regReturn = getReturnRegister(returnInst);
 
     emplaceMove(val, regReturn, Operators::getAsmType(returnInst.type));
     emplaceReturn();
@@ -944,52 +980,50 @@ void GenerateAsmTree::genReturn(const Ir::ReturnInst& returnInst)
 
 void GenerateAsmTree::deAllocateStack(const Ir::FunCallInst& funcCall, const i64 stackPadding)
 {
-    const i64 bytesToRemove = 8l * (funcCall.args.size() - 6l) + stackPadding;
+    const i64 bytesToRemove = 8l * (static_cast<i64>(funcCall.argCount) - 6l) + stackPadding;
     if (0 < bytesToRemove) {
-        const auto bytesToRemoveOperand = std::make_shared<ImmOperand>(bytesToRemove, AsmType::LongWord);
-        const auto sp = std::make_shared<RegisterOperand>(RegType::SP, AsmType::QuadWord);
+        const auto bytesToRemoveOperand = ImmOperand(bytesToRemove, AsmType::LongWord);
+        const auto sp = RegisterOperand(RegType::SP, AsmType::QuadWord);
         emplaceBinary(bytesToRemoveOperand, sp, BinaryInst::Operator::Add, AsmType::QuadWord);
     }
 }
 
 void GenerateAsmTree::genFunCall(const Ir::FunCallInst& funcCall)
 {
-    const i32 stackPadding = getStackPadding(funcCall.args.size());
+    const i32 stackPadding = getStackPadding(funcCall.argCount);
     if (0 < stackPadding)
         emplaceBinary(
-            std::make_shared<ImmOperand>(8, AsmType::LongWord),
-            std::make_shared<RegisterOperand>(RegType::SP, AsmType::QuadWord),
+            ImmOperand(8, AsmType::LongWord),
+            RegisterOperand(RegType::SP, AsmType::QuadWord),
             BinaryInst::Operator::Sub, AsmType::QuadWord);
     genFunCallPushArgs(funcCall);
     emplaceCall(Identifier(funcCall.funName.value));
     deAllocateStack(funcCall, stackPadding);
-    if (!funcCall.destination)
+    if (funcCall.destination == Ir::ValueId::None)
         return;
-    const std::shared_ptr<Operand> dst = genOperand(funcCall.destination);
-    std::shared_ptr<Operand> src;
-    if (Operators::getAsmType(funcCall.type) != AsmType::Double)
-        src = std::make_shared<RegisterOperand>(RegType::AX, Operators::getAsmType(funcCall.type));
-    else
-        src = std::make_shared<RegisterOperand>(RegType::XMM0, Operators::getAsmType(funcCall.type));
-    emplaceMove(src, dst, Operators::getAsmType(funcCall.type));
+    const Operand dst = genOperand(funcCall.destination);
+    const AsmType type = Operators::getAsmType(funcCall.type);
+    const RegisterOperand src(type != AsmType::Double ? RegType::AX : RegType::XMM0, type);
+    emplaceMove(src, dst, type);
 }
 
 std::vector<bool> GenerateAsmTree::genFuncCallPushArgsRegs(const Ir::FunCallInst& funcCall)
 {
     i32 regIntIndex = 0;
     i32 regDoubleIndex = 0;
-    std::vector pushedIntoRegs(funcCall.args.size(), false);
-    for (size_t i = 0; i < funcCall.args.size(); ++i) {
-        std::shared_ptr<Operand> src = genOperand(funcCall.args[i]);
-        const AsmType type = Operators::getAsmType(funcCall.args[i]->type);
-        std::shared_ptr<RegisterOperand> reg;
+    const std::span<const Ir::ValueId> args = m_function->arguments(funcCall);
+    std::vector pushedIntoRegs(args.size(), false);
+    for (size_t i = 0; i < args.size(); ++i) {
+        Operand src = genOperand(args[i]);
+        const AsmType type = Operators::getAsmType(value(args[i]).type);
+        RegType reg;
         if (type != AsmType::Double && regIntIndex < intRegs.size())
-            reg = std::make_shared<RegisterOperand>(intRegs[regIntIndex++], type);
+            reg = intRegs[regIntIndex++];
         else if (type == AsmType::Double && regDoubleIndex < doubleRegs.size())
-            reg = std::make_shared<RegisterOperand>(doubleRegs[regDoubleIndex++], type);
+            reg = doubleRegs[regDoubleIndex++];
         else
             continue;
-        emplaceMove(src, reg, type);
+        emplaceMove(src, RegisterOperand(reg, type), type);
         pushedIntoRegs[i] = true;
     }
     return pushedIntoRegs;
@@ -998,19 +1032,20 @@ std::vector<bool> GenerateAsmTree::genFuncCallPushArgsRegs(const Ir::FunCallInst
 void GenerateAsmTree::genFunCallPushArgs(const Ir::FunCallInst& funcCall)
 {
     std::vector<bool> pushedIntoRegs = genFuncCallPushArgsRegs(funcCall);
-    for (i64 i = funcCall.args.size() - 1; 0 <= i; --i) {
+    const std::span<const Ir::ValueId> args = m_function->arguments(funcCall);
+    for (i64 i = static_cast<i64>(args.size()) - 1; 0 <= i; --i) {
         if (pushedIntoRegs[i])
             continue;
-        std::shared_ptr<Operand> src = genOperand(funcCall.args[i]);
-        if (src->kind == Operand::Kind::Imm ||
-            src->kind == Operand::Kind::Register ||
-            getTypeSize(funcCall.args[i]->type) == 8) {
+        Operand src = genOperand(args[i]);
+        if (src.kind == Operand::Kind::Imm ||
+            src.kind == Operand::Kind::Register ||
+            getTypeSize(value(args[i]).type) == 8) {
             emplacePush(src);
         }
         else {
-            const AsmType type = Operators::getAsmType(funcCall.args[i]->type);
-            emplaceMove(src, std::make_shared<RegisterOperand>(RegType::AX, type), type);
-            emplacePush(std::make_shared<RegisterOperand>(RegType::AX, AsmType::QuadWord));
+            const AsmType type = Operators::getAsmType(value(args[i]).type);
+            emplaceMove(src, RegisterOperand(RegType::AX, type), type);
+            emplacePush(RegisterOperand(RegType::AX, AsmType::QuadWord));
         }
     }
 }
@@ -1025,36 +1060,39 @@ i64 getStackPadding(const size_t numArgs)
     return stackPadding;
 }
 
-std::shared_ptr<Operand> GenerateAsmTree::genOperand(const std::shared_ptr<Ir::Value>& value)
+Operand GenerateAsmTree::genOperand(const Ir::ValueId id)
 {
-    switch (value->kind) {
+    return genOperand(value(id));
+}
+
+Operand GenerateAsmTree::genOperand(const Ir::Value& value)
+{
+    switch (value.kind) {
         case Ir::Value::Kind::Constant:
             return getOperandFromConstant(value);
         case Ir::Value::Kind::Variable: {
-            const auto valueVar = dynCast<Ir::ValueVar>(value.get());
-            const bool isConst = valueVar->type == Type::Double;
-            return std::make_shared<PseudoOperand>(
-                Identifier(valueVar->value.value),
-                valueVar->referingTo,
-                Operators::getAsmType(valueVar->type),
+            const bool isConst = value.type == Type::Double;
+            return PseudoOperand(
+                Identifier(value.name),
+                value.referingTo,
+                Operators::getAsmType(value.type),
                 isConst
             );
         }
         default:
-            throw std::invalid_argument("Invalid UnaryOperator type");
+            std::abort();
     }
 }
 
-std::shared_ptr<Operand> GenerateAsmTree::getOperandFromConstant(const std::shared_ptr<Ir::Value>& value)
+Operand GenerateAsmTree::getOperandFromConstant(const Ir::Value& value)
 {
-    const auto valueConst = dynCast<Ir::ValueConst>(value.get());
-    if (valueConst->type == Type::Double)
-        return genDoubleLocalConst(std::get<double>(valueConst->value), 8);
-    std::shared_ptr<ImmOperand> imm = getImmOperandFromValue(*valueConst);
-    if (INT_MAX < imm->value) {
+    if (value.type == Type::Double)
+        return genDoubleLocalConst(value.asDouble(), 8);
+    Operand imm = getImmOperandFromValue(value);
+    if (INT_MAX < imm.value) {
         Identifier pseudoName(makeTemporaryPseudoName());
-        const auto reg10 = std::make_shared<RegisterOperand>(RegType::R10, AsmType::QuadWord);
-        const auto pseudo = std::make_shared<PseudoOperand>(
+        const auto reg10 = RegisterOperand(RegType::R10, AsmType::QuadWord);
+        const auto pseudo = PseudoOperand(
             pseudoName, ReferingTo::Local, AsmType::QuadWord, false);
 
         emplaceMove(imm, reg10, AsmType::QuadWord);
@@ -1064,62 +1102,66 @@ std::shared_ptr<Operand> GenerateAsmTree::getOperandFromConstant(const std::shar
     return imm;
 }
 
-std::shared_ptr<Operand> GenerateAsmTree::genDoubleLocalConst(double value, i32 alignment)
+Operand GenerateAsmTree::genDoubleLocalConst(double value, i32 alignment)
 {
-    const auto it = m_constantDoubles.find(value);
-    if (it != m_constantDoubles.end())
-        return std::make_shared<DataOperand>(Identifier(it->second), AsmType::Double, true);
-    Identifier constLabel(makeTemporaryPseudoName());
-    m_toplevel.emplace_back(std::make_unique<ConstVariable>(
-        Identifier(constLabel), alignment, value, true));
-    m_constantDoubles.emplace_hint(it, value, constLabel.value);
-    return std::make_shared<DataOperand>(constLabel, AsmType::Double, true);
+    const auto [it, inserted] = m_constantDoubles.try_emplace(value, nullptr);
+    if (inserted) {
+        // Named after its bits, so functions lowered on different threads agree on the label.
+        const Identifier constLabel(Symbol("double." + std::to_string(std::bit_cast<u64>(value))));
+        auto constant = std::make_unique<ConstVariable>(constLabel, alignment, value, true);
+        it->second = constant.get();
+        m_toplevel.emplace_back(std::move(constant));
+    }
+    it->second->alignment = std::max(it->second->alignment, alignment);
+    return DataOperand(it->second->name, AsmType::Double, true);
 }
 
-std::shared_ptr<Operand> GenerateAsmTree::getZeroOperand(const AsmType type)
+Operand GenerateAsmTree::getZeroOperand(const AsmType type)
 {
     switch (type) {
-        case AsmType::Byte:         return std::make_shared<ImmOperand>(0, AsmType::Byte);
-        case AsmType::LongWord:     return std::make_shared<ImmOperand>(0, AsmType::LongWord);
-        case AsmType::QuadWord:     return std::make_shared<ImmOperand>(0, AsmType::QuadWord);
+        case AsmType::Byte:         return ImmOperand(0, AsmType::Byte);
+        case AsmType::LongWord:     return ImmOperand(0, AsmType::LongWord);
+        case AsmType::QuadWord:     return ImmOperand(0, AsmType::QuadWord);
         case AsmType::Double:       return genDoubleLocalConst(0.0, 8);
         default:
             std::abort();
     }
 }
 
-std::shared_ptr<ImmOperand> GenerateAsmTree::getImmOperandFromValue(const Ir::ValueConst& valueConst)
+Operand GenerateAsmTree::getImmOperandFromValue(const Ir::Value& value)
 {
-    switch (valueConst.type) {
+    switch (value.type) {
         case Type::Char:
-            return std::make_shared<ImmOperand>(std::get<char>(valueConst.value), AsmType::Byte);
         case Type::I8:
-            return std::make_shared<ImmOperand>(std::get<i8>(valueConst.value), AsmType::Byte);
         case Type::U8:
-            return std::make_shared<ImmOperand>(std::get<u8>(valueConst.value), AsmType::Byte);
+            return ImmOperand(value.bits, AsmType::Byte);
         case Type::I32:
-            return std::make_shared<ImmOperand>(std::get<i32>(valueConst.value), AsmType::LongWord);
         case Type::U32:
-            return std::make_shared<ImmOperand>(std::get<u32>(valueConst.value), AsmType::LongWord);
+            return ImmOperand(value.bits, AsmType::LongWord);
         case Type::U64:
-            return std::make_shared<ImmOperand>(std::get<u64>(valueConst.value), AsmType::QuadWord);
         case Type::I64:
-            return std::make_shared<ImmOperand>(
-                std::bit_cast<u64>(std::get<i64>(valueConst.value)), AsmType::QuadWord);
+            return ImmOperand(value.bits, AsmType::QuadWord);
         default:
             std::abort();
     }
 }
 
-void GenerateAsmTree::zeroOutReg(const std::shared_ptr<RegisterOperand>& reg)
+void GenerateAsmTree::zeroOutReg(const Operand& reg)
+{
+    emplaceBinary(reg, reg, BinaryInst::Operator::BitwiseXor, reg.type);
+}
+
+Symbol GenerateAsmTree::label(const Ir::LabelId id)
 {
-    emplaceBinary(reg, reg, BinaryInst::Operator::BitwiseXor, reg->type);
+    Symbol& label = m_labels[static_cast<u32>(id)];
+    if (label.empty())
+        label = Symbol::derive(m_temporaryBase, static_cast<u32>(id), ".label");
+    return label;
 }
 
-std::string makeTemporaryPseudoName()
+Symbol GenerateAsmTree::makeTemporaryPseudoName(const char* suffix)
 {
-    static i32 i = 0;
-    return std::to_string(i++) + "..";
+    return Symbol::derive(m_temporaryBase, m_temporaryCounter++, suffix);
 }
 
 }// namespace CodeGen
\ No newline at end of file
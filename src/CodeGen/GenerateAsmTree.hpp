@@ -2,6 +2,7 @@
 
 #include "AsmAST.hpp"
 #include "ASTIr.hpp"
+#include "WorkStealingPool.hpp"
 
 #include <cmath>
 #include <unordered_map>
@@ -22,19 +23,34 @@ class GenerateAsmTree {
         }
     };
 
-    std::unordered_map<double, std::string, DoubleHash, DoubleEqual> m_constantDoubles;
+    std::unordered_map<double, ConstVariable*, DoubleHash, DoubleEqual> m_constantDoubles;
     using RegType = Operand::RegKind;
-    std::vector<std::unique_ptr<Inst>> insts;
+    std::vector<Inst*> insts;
+    InstructionPool m_pool;
     Program m_programCodegen;
     std::vector<std::unique_ptr<TopLevel>> m_toplevel;
+    const Ir::Function* m_function = nullptr;
+    std::vector<Symbol> m_labels;
+    Symbol m_temporaryBase;
+    i32 m_temporaryCounter = 0;
 public:
     void genProgram(const Ir::Program &program, Program &programCodegen);
+    void genProgram(const Ir::Program &program, Program &programCodegen, const WorkStealingPool& pool);
+    struct GeneratedTopLevel {
+        std::unique_ptr<TopLevel> topLevel;
+        std::vector<std::unique_ptr<TopLevel>> constants;
+    };
+    // Each top level on its own, with the double constants it refers to still unmerged.
+    [[nodiscard]] static std::vector<GeneratedTopLevel> genTopLevels(const Ir::Program &program,
+                                                                    const WorkStealingPool& pool);
+    // Appends the constants to the program, merging equal values into the first one.
+    void appendConstants(Program &programCodegen, std::vector<std::unique_ptr<TopLevel>> constants);
     [[nodiscard]] std::unique_ptr<TopLevel> genTopLevel(const Ir::TopLevel& topLevel);
     void genFunctionPushOntoStack(const Ir::Function& function, std::vector<bool> pushedIntoRegs);
     [[nodiscard]] std::unique_ptr<TopLevel> genFunction(const Ir::Function& function);
     [[nodiscard]] std::vector<bool> genFunctionPushIntoRegs(const Ir::Function& function);
 
-    void genInst(const std::unique_ptr<Ir::Instruction>& inst);
+    void genInst(const Ir::Instruction& inst);
     void genUnary(const Ir::UnaryInst& irUnary);
     void genUnaryBasic(const Ir::UnaryInst& irUnary);
     void genNegateDouble(const Ir::UnaryInst& irUnary);
@@ -91,128 +107,137 @@ public:
     void genLabel(const Ir::LabelInst& irLabel);
     void genCopyToOffSet(const Ir::CopyToOffsetInst& copyToOffset);
     void genAllocate(const Ir::AllocateInst& allocate);
-    std::shared_ptr<Operand> getReturnRegister(const Ir::ReturnInst& returnInst);
+    Operand getReturnRegister(const Ir::ReturnInst& returnInst);
 
     void genFunCall(const Ir::FunCallInst& funcCall);
     std::vector<bool> genFuncCallPushArgsRegs(const Ir::FunCallInst& funcCall);
     void genFunCallPushArgs(const Ir::FunCallInst& funcCall);
     void deAllocateStack(const Ir::FunCallInst& funcCall, i64 stackPadding);
 
-    std::shared_ptr<Operand> genDoubleLocalConst(double value, i32 alignment);
-    std::shared_ptr<Operand> getOperandFromConstant(const std::shared_ptr<Ir::Value>& value);
-    std::shared_ptr<Operand> genOperand(const std::shared_ptr<Ir::Value>& value);
-    std::shared_ptr<Operand> getZeroOperand(AsmType type);
+    Operand genDoubleLocalConst(double value, i32 alignment);
+    Operand getOperandFromConstant(const Ir::Value& value);
+    Operand genOperand(Ir::ValueId id);
+    Operand genOperand(const Ir::Value& value);
+    Operand getZeroOperand(AsmType type);
 
-    static std::shared_ptr<ImmOperand> getImmOperandFromValue(const Ir::ValueConst& valueConst);
+    static Operand getImmOperandFromValue(const Ir::Value& value);
 private:
-    void zeroOutReg(const std::shared_ptr<RegisterOperand>& reg);
-    void emplaceUnary(const std::shared_ptr<Operand>& target, UnaryInst::Operator oper, const AsmType type)
+    [[nodiscard]] const Ir::Value& value(const Ir::ValueId id) const { return m_function->value(id); }
+    // Labels of the IR are numbered per function, they get a name the first time one is used.
+    Symbol label(Ir::LabelId id);
+    Symbol makeTemporaryPseudoName(const char* suffix = ".");
+    void mergeDoubleConstant(std::unique_ptr<TopLevel> topLevel);
+    void zeroOutReg(const Operand& reg);
+    template<typename T, typename... Args>
+    void emplace(Args&&... args)
+    {
+        insts.push_back(m_pool.make<T>(std::forward<Args>(args)...));
+    }
+    void emplaceUnary(const Operand& target, UnaryInst::Operator oper, const AsmType type)
     {
-        insts.emplace_back(std::make_unique<UnaryInst>(target, oper, type));
+        emplace<UnaryInst>(target, oper, type);
     }
-    void emplaceBinary(const std::shared_ptr<Operand>& left,
-                       const std::shared_ptr<Operand>& right,
+    void emplaceBinary(const Operand& left,
+                       const Operand& right,
                        const BinaryInst::Operator oper,
                        const AsmType type)
     {
-        insts.emplace_back(std::make_unique<BinaryInst>(left, right, oper, type));
+        emplace<BinaryInst>(left, right, oper, type);
     }
-    void emplaceCvtsi2sd(const std::shared_ptr<Operand>& src,
-                         const std::shared_ptr<Operand>& dst,
+    void emplaceCvtsi2sd(const Operand& src,
+                         const Operand& dst,
                          const AsmType type)
     {
-        insts.emplace_back(std::make_unique<Cvtsi2sdInst>(src, dst, type));
+        emplace<Cvtsi2sdInst>(src, dst, type);
     }
-    void emplaceCvttsd2si(const std::shared_ptr<Operand>& src,
-                          const std::shared_ptr<Operand>& dst,
+    void emplaceCvttsd2si(const Operand& src,
+                          const Operand& dst,
                           const AsmType type)
     {
-        insts.emplace_back(std::make_unique<Cvttsd2siInst>(src, dst, type));
+        emplace<Cvttsd2siInst>(src, dst, type);
     }
-    void emplaceDiv(const std::shared_ptr<Operand>& src, const AsmType type)
+    void emplaceDiv(const Operand& src, const AsmType type)
     {
-        insts.emplace_back(std::make_unique<DivInst>(src, type));
+        emplace<DivInst>(src, type);
     }
     void emplaceCdq(const AsmType type)
     {
-        insts.emplace_back(std::make_unique<CdqInst>(type));
+        emplace<CdqInst>(type);
     }
-    void emplaceIdiv(const std::shared_ptr<Operand>& src, const AsmType type)
+    void emplaceIdiv(const Operand& src, const AsmType type)
     {
-        insts.emplace_back(std::make_unique<IdivInst>(src, type));
+        emplace<IdivInst>(src, type);
     }
-    void emplaceMove(const std::shared_ptr<Operand>& src,
-                     const std::shared_ptr<Operand>& dst,
+    void emplaceMove(const Operand& src,
+                     const Operand& dst,
                      const AsmType type)
     {
-        insts.emplace_back(std::make_unique<MoveInst>(src, dst, type));
+        emplace<MoveInst>(src, dst, type);
     }
-    void emplaceMoveZeroExtend(const std::shared_ptr<Operand>& src,
-                               const std::shared_ptr<Operand>& dst,
+    void emplaceMoveZeroExtend(const Operand& src,
+                               const Operand& dst,
                                const AsmType srcType,
                                const AsmType dstType)
     {
-        insts.emplace_back(std::make_unique<MoveZeroExtendInst>(src, dst, srcType, dstType));
+        emplace<MoveZeroExtendInst>(src, dst, srcType, dstType);
     }
-    void emplaceMoveSX(const std::shared_ptr<Operand>& src,
-                       const std::shared_ptr<Operand>& dst,
+    void emplaceMoveSX(const Operand& src,
+                       const Operand& dst,
                        const AsmType srcType,
                        const AsmType dstType)
     {
-        insts.emplace_back(std::make_unique<MoveSXInst>(src, dst, srcType, dstType));
+        emplace<MoveSXInst>(src, dst, srcType, dstType);
     }
-    void emplacePushPseudo(const i64 size, const AsmType type, const std::string& iden)
+    void emplacePushPseudo(const i64 size, const AsmType type, const Symbol iden)
     {
-        insts.emplace_back(std::make_unique<PushPseudoInst>(size, 16, type, Identifier(iden)));
+        emplace<PushPseudoInst>(size, 16, type, Identifier(iden));
     }
-    void emplacePush(const std::shared_ptr<Operand>& src)
+    void emplacePush(const Operand& src)
     {
-        insts.emplace_back(std::make_unique<PushInst>(src));
+        emplace<PushInst>(src);
     }
-    void emplaceLea(const std::shared_ptr<Operand>& src,
-                    const std::shared_ptr<Operand>& dst,
+    void emplaceLea(const Operand& src,
+                    const Operand& dst,
                     const AsmType type)
     {
-        insts.emplace_back(std::make_unique<LeaInst>(src, dst, type));
+        emplace<LeaInst>(src, dst, type);
     }
-    void emplaceCmp(const std::shared_ptr<Operand>& lhs,
-                    const std::shared_ptr<Operand>& rhs,
+    void emplaceCmp(const Operand& lhs,
+                    const Operand& rhs,
                     const AsmType type)
     {
-        insts.emplace_back(std::make_unique<CmpInst>(lhs, rhs, type));
+        emplace<CmpInst>(lhs, rhs, type);
     }
-    void emplaceSetCC(BinaryInst::CondCode cond, const std::shared_ptr<Operand>& src)
+    void emplaceSetCC(BinaryInst::CondCode cond, const Operand& src)
     {
-        insts.emplace_back(std::make_unique<SetCCInst>(cond, src));
+        emplace<SetCCInst>(cond, src);
     }
     void emplaceJmp(const Identifier& iden)
     {
-        insts.emplace_back(std::make_unique<JmpInst>(iden));
+        emplace<JmpInst>(iden);
     }
     void emplaceJmpCC(const Inst::CondCode cond, const Identifier& iden)
     {
-        insts.emplace_back(std::make_unique<JmpCCInst>(cond, iden));
+        emplace<JmpCCInst>(cond, iden);
     }
     void emplaceLabel(const Identifier& iden)
     {
-        insts.emplace_back(std::make_unique<LabelInst>(iden));
+        emplace<LabelInst>(iden);
     }
     void emplaceCall(const Identifier& iden)
     {
-        insts.emplace_back(std::make_unique<CallInst>(iden));
+        emplace<CallInst>(iden);
     }
     void emplaceReturn()
     {
-        insts.emplace_back(std::make_unique<ReturnInst>());
+        emplace<ReturnInst>();
     }
 };
 
 std::unique_ptr<TopLevel> genStaticVariable(const Ir::StaticVariable& staticVariable);
 std::unique_ptr<TopLevel> genStaticArray(const Ir::StaticArray& staticArray);
 std::unique_ptr<TopLevel> genStaticString(const Ir::StaticConstant& staticConstant);
-u64 getSingleInitValue(Type type, const Ir::ValueConst* value);
+u64 getSingleInitValue(Type type, const Ir::Value& value);
 i64 getStackPadding(size_t numArgs);
 
-std::string makeTemporaryPseudoName();
-
 } // CodeGen
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "JitImage.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace CodeGen {
+
+namespace {
+
+using SectionKind = ObjectModule::SectionKind;
+
+size_t alignUp(const size_t value, const size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+JitImage::~JitImage()
+{
+    if (m_base != nullptr)
+        munmap(m_base, m_size);
+}
+
+std::vector<std::string> JitImage::load(const ObjectModule& module)
+{
+    m_module = &module;
+    const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t stubCount = 0;
+    for (const ObjectModule::SymbolEntry& symbol : module.symbols)
+        if (symbol.section == SectionKind::Undefined)
+            ++stubCount;
+
+    // Code and stubs share the executable pages, every other section gets its own pages.
+    const size_t textSize = module.section(SectionKind::Text).size();
+    const size_t stubOffset = alignUp(textSize, s_stubSize);
+    std::array<size_t, ObjectModule::sectionCount> offsets{};
+    size_t end = stubOffset + stubCount * s_stubSize;
+    for (const SectionKind kind : {SectionKind::Rodata, SectionKind::Data, SectionKind::Bss}) {
+        end = alignUp(end, pageSize);
+        offsets[static_cast<size_t>(kind)] = end;
+        end += module.section(kind).size();
+    }
+    m_size = alignUp(std::max<size_t>(end, 1), pageSize);
+    void* base = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        m_base = nullptr;
+        return {"could not map " + std::to_string(m_size) + " bytes for the generated code"};
+    }
+    m_base = static_cast<u8*>(base);
+    for (size_t i = 0; i < ObjectModule::sectionCount; ++i) {
+        const ObjectModule::Section& section = module.sections[i];
+        m_sections[i] = {m_base + offsets[i], section.size()};
+        if (!section.bytes.empty())
+            std::memcpy(m_sections[i].address, section.bytes.data(), section.bytes.size());
+    }
+
+    std::vector<std::string> errors = resolveSymbols(m_base + stubOffset);
+    if (errors.empty())
+        errors = relocate();
+    if (!errors.empty())
+        return errors;
+    const size_t rodataOffset = offsets[static_cast<size_t>(SectionKind::Rodata)];
+    const size_t dataOffset = offsets[static_cast<size_t>(SectionKind::Data)];
+    if (mprotect(m_base, rodataOffset, PROT_READ | PROT_EXEC) != 0 ||
+        mprotect(m_base + rodataOffset, dataOffset - rodataOffset, PROT_READ) != 0)
+        return {"could not make the generated code executable"};
+    return {};
+}
+
+std::vector<std::string> JitImage::resolveSymbols(u8* stubs)
+{
+    std::vector<std::string> errors;
+    m_symbolAddresses.assign(m_module->symbols.size(), nullptr);
+    for (size_t i = 0; i < m_module->symbols.size(); ++i) {
+        const ObjectModule::SymbolEntry& symbol = m_module->symbols[i];
+        if (symbol.section != SectionKind::Undefined) {
+            m_symbolAddresses[i] = m_sections[static_cast<size_t>(symbol.section)].address + symbol.offset;
+            continue;
+        }
+        void* external = dlsym(RTLD_DEFAULT, symbol.name.c_str());
+        if (external == nullptr) {
+            errors.push_back("undefined reference to '" + symbol.name + "'");
+            continue;
+        }
+        // jmp *0(%rip) followed by the absolute target.
+        constexpr std::array<u8, 6> jumpIndirect{0xFF, 0x25, 0x00, 0x00, 0x00, 0x00};
+        std::memcpy(stubs, jumpIndirect.data(), jumpIndirect.size());
+        std::memcpy(stubs + jumpIndirect.size(), &external, sizeof(external));
+        m_symbolAddresses[i] = stubs;
+        stubs += s_stubSize;
+    }
+    return errors;
+}
+
+std::vector<std::string> JitImage::relocate()
+{
+    std::vector<std::string> errors;
+    u8* text = m_sections[static_cast<size_t>(SectionKind::Text)].address;
+    for (const ObjectModule::Relocation& relocation : m_module->textRelocations) {
+        const ObjectModule::SymbolEntry& symbol = m_module->symbols[relocation.symbol];
+        u8* target = m_symbolAddresses[relocation.symbol];
+        // Data living in a shared library is referenced directly and may be out of rel32 reach.
+        if (relocation.kind == ObjectModule::RelocationKind::PC32 && symbol.section == SectionKind::Undefined)
+            target = static_cast<u8*>(dlsym(RTLD_DEFAULT, symbol.name.c_str()));
+        u8* place = text + relocation.offset;
+        const i64 value = reinterpret_cast<i64>(target) + relocation.addend - reinterpret_cast<i64>(place);
+        if (value < std::numeric_limits<i32>::min() || std::numeric_limits<i32>::max() < value) {
+            errors.push_back("relocation against '" + symbol.name + "' out of range");
+            continue;
+        }
+        const auto value32 = static_cast<i32>(value);
+        std::memcpy(place, &value32, sizeof(value32));
+    }
+    return errors;
+}
+
+void* JitImage::symbolAddress(const std::string_view name) const
+{
+    if (m_module == nullptr)
+        return nullptr;
+    const auto it = m_module->symbolIndex.find(std::string(name));
+    if (it == m_module->symbolIndex.end() || m_module->symbols[it->second].section == SectionKind::Undefined)
+        return nullptr;
+    return m_symbolAddresses[it->second];
+}
+
+void JitImage::writePerfMap() const
+{
+    std::ofstream ofs("/tmp/perf-" + std::to_string(getpid()) + ".map", std::ios::app);
+    ofs << std::hex;
+    for (size_t i = 0; i < m_module->symbols.size(); ++i) {
+        const ObjectModule::SymbolEntry& symbol = m_module->symbols[i];
+        if (symbol.function)
+            ofs << reinterpret_cast<uintptr_t>(m_symbolAddresses[i]) << ' ' << symbol.size << ' ' << symbol.name << '\n';
+    }
+}
+
+} // CodeGen
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "ObjectModule.hpp"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CodeGen {
+
+// Lays an ObjectModule out in mmap'd memory of this process and resolves its relocations.
+// Undefined symbols are looked up with dlsym, calls to them go through 14 byte jump stubs
+// placed behind the code so rel32 calls reach the shared libraries.
+class JitImage {
+    struct Region {
+        u8* address = nullptr;
+        size_t size = 0;
+    };
+    static constexpr size_t s_stubSize = 16;
+
+    u8* m_base = nullptr;
+    size_t m_size = 0;
+    std::array<Region, ObjectModule::sectionCount> m_sections;
+    std::vector<u8*> m_symbolAddresses;
+    const ObjectModule* m_module = nullptr;
+public:
+    JitImage() = default;
+    JitImage(const JitImage&) = delete;
+    JitImage& operator=(const JitImage&) = delete;
+    ~JitImage();
+
+    [[nodiscard]] std::vector<std::string> load(const ObjectModule& module);
+    [[nodiscard]] void* symbolAddress(std::string_view name) const;
+    // Writes /tmp/perf-<pid>.map so perf can symbolise the generated functions.
+    void writePerfMap() const;
+private:
+    [[nodiscard]] std::vector<std::string> resolveSymbols(u8* stubs);
+    [[nodiscard]] std::vector<std::string> relocate();
+};
+
+} // CodeGen
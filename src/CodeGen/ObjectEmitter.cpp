@@ -0,0 +1,776 @@
+#include "ObjectEmitter.hpp"
+#include "DynCast.hpp"
+#include "Operators.hpp"
+#include "TimeTrace.hpp"
+
+#include <bit>
+#include <optional>
+#include <limits>
+
+namespace CodeGen {
+
+namespace {
+
+constexpr u8 rexBase = 0x40;
+constexpr u8 rexW = 0x08;
+constexpr u8 rexR = 0x04;
+constexpr u8 rexX = 0x02;
+constexpr u8 rexB = 0x01;
+
+bool fitsI8(const i64 value)
+{
+    return std::numeric_limits<i8>::min() <= value && value <= std::numeric_limits<i8>::max();
+}
+
+bool fitsI32(const i64 value)
+{
+    return std::numeric_limits<i32>::min() <= value && value <= std::numeric_limits<i32>::max();
+}
+
+bool isXmm(const Operand& operand)
+{
+    if (operand.kind != Operand::Kind::Register)
+        return false;
+    const Operand::RegKind reg = operand.regKind;
+    return Operand::RegKind::XMM0 <= reg && reg <= Operand::RegKind::XMM15;
+}
+
+bool isQuad(const AsmType type)
+{
+    return type == AsmType::QuadWord;
+}
+
+u8 condCodeNumber(const Inst::CondCode condCode)
+{
+    using CondCode = Inst::CondCode;
+    switch (condCode) {
+        case CondCode::E:   return 0x4;
+        case CondCode::NE:  return 0x5;
+        case CondCode::L:   return 0xC;
+        case CondCode::LE:  return 0xE;
+        case CondCode::G:   return 0xF;
+        case CondCode::GE:  return 0xD;
+        case CondCode::A:   return 0x7;
+        case CondCode::AE:  return 0x3;
+        case CondCode::B:   return 0x2;
+        case CondCode::BE:  return 0x6;
+        case CondCode::PF:  return 0xA;
+        default:
+            std::abort();
+    }
+}
+
+u8 scaleBits(const i64 scale)
+{
+    switch (scale) {
+        case 1: return 0;
+        case 2: return 1;
+        case 4: return 2;
+        case 8: return 3;
+        default:
+            std::abort();
+    }
+}
+
+void appendValue(std::vector<u8>& bytes, const u64 value, const i64 size)
+{
+    for (i64 i = 0; i < size; ++i)
+        bytes.push_back(static_cast<u8>(value >> (8 * i)));
+}
+
+} // namespace
+
+ObjectModule emitObject(const Program& program)
+{
+    const TimeTrace::Scope scope("emission");
+    ObjectEmitter emitter;
+    return emitter.emitProgram(program);
+}
+
+ObjectModule emitObject(const Program& program, const WorkStealingPool& pool)
+{
+    const TimeTrace::Scope scope("emission");
+    ObjectEmitter emitter;
+    return emitter.emitProgram(program, pool);
+}
+
+ObjectModule emitFunctionObject(const Function& function)
+{
+    ObjectEmitter emitter;
+    return emitter.emitFunctionFragment(function);
+}
+
+u8 registerNumber(const Operand::RegKind reg)
+{
+    using RegKind = Operand::RegKind;
+    switch (reg) {
+        case RegKind::AX:    return 0;
+        case RegKind::CX:    return 1;
+        case RegKind::DX:    return 2;
+        case RegKind::SP:    return 4;
+        case RegKind::BP:    return 5;
+        case RegKind::SI:    return 6;
+        case RegKind::DI:    return 7;
+        case RegKind::R8:    return 8;
+        case RegKind::R9:    return 9;
+        case RegKind::R10:   return 10;
+        case RegKind::R11:   return 11;
+        case RegKind::XMM0:  return 0;
+        case RegKind::XMM1:  return 1;
+        case RegKind::XMM2:  return 2;
+        case RegKind::XMM3:  return 3;
+        case RegKind::XMM4:  return 4;
+        case RegKind::XMM5:  return 5;
+        case RegKind::XMM6:  return 6;
+        case RegKind::XMM7:  return 7;
+        case RegKind::XMM14: return 14;
+        case RegKind::XMM15: return 15;
+        default:
+            std::abort();
+    }
+}
+
+std::string dataSymbolName(const Operand& data)
+{
+    if (data.local && data.type == AsmType::Double)
+        return ".L" + data.identifier.value.str();
+    return data.identifier.value.str();
+}
+
+ObjectModule ObjectEmitter::emitProgram(const Program& program)
+{
+    m_module = ObjectModule();
+    m_text = &m_module.section(SectionKind::Text).bytes;
+    for (const std::unique_ptr<TopLevel>& topLevel : program.topLevels)
+        emitTopLevel(*topLevel);
+    resolveLocalCalls();
+    return std::move(m_module);
+}
+
+ObjectModule ObjectEmitter::emitProgram(const Program& program, const WorkStealingPool& pool)
+{
+    if (pool.threadCount() == 1)
+        return emitProgram(program);
+    // Functions are encoded into fragments of their own and appended in program order, which
+    // yields the same module as encoding them one after another.
+    std::vector<ObjectModule> fragments(program.topLevels.size());
+    pool.run(program.topLevels.size(), [&program, &fragments](const size_t i) {
+        if (program.topLevels[i]->kind != TopLevel::Kind::Function)
+            return;
+        ObjectEmitter emitter;
+        fragments[i] = emitter.emitFunctionFragment(*dynCast<const Function>(program.topLevels[i].get()));
+    });
+    m_module = ObjectModule();
+    m_text = &m_module.section(SectionKind::Text).bytes;
+    for (size_t i = 0; i < program.topLevels.size(); ++i) {
+        if (program.topLevels[i]->kind == TopLevel::Kind::Function)
+            appendFragment(fragments[i]);
+        else
+            emitTopLevel(*program.topLevels[i]);
+    }
+    resolveLocalCalls();
+    return std::move(m_module);
+}
+
+void ObjectEmitter::emitTopLevel(const TopLevel& topLevel)
+{
+    switch (topLevel.kind) {
+        case TopLevel::Kind::Function:
+            emitFunction(*dynCast<const Function>(&topLevel));
+            break;
+        case TopLevel::Kind::StaticVariable:
+            emitStaticVariable(*dynCast<const StaticVariable>(&topLevel));
+            break;
+        case TopLevel::Kind::StaticConstant:
+            emitStaticConstant(*dynCast<const ConstVariable>(&topLevel));
+            break;
+        case TopLevel::Kind::StaticArray:
+            emitStaticArray(*dynCast<const ArrayVariable>(&topLevel));
+            break;
+        case TopLevel::Kind::StaticString:
+            emitStaticString(*dynCast<const StringVariable>(&topLevel));
+            break;
+        case TopLevel::Kind::EmittedFunction:
+            appendFragment(dynCast<const EmittedFunction>(&topLevel)->object);
+            break;
+        default:
+            std::abort();
+    }
+}
+
+ObjectModule ObjectEmitter::emitFunctionFragment(const Function& function)
+{
+    const TimeTrace::FunctionScope scope("emission", function.name.value.text());
+    m_module = ObjectModule();
+    m_text = &m_module.section(SectionKind::Text).bytes;
+    emitFunction(function);
+    return std::move(m_module);
+}
+
+void ObjectEmitter::appendFragment(const ObjectModule& fragment)
+{
+    const u64 start = m_text->size();
+    const std::vector<u8>& code = fragment.section(SectionKind::Text).bytes;
+    m_text->insert(m_text->end(), code.begin(), code.end());
+    // Registering the fragment's symbols in its own order keeps the symbol table identical.
+    std::vector<u32> indices;
+    indices.reserve(fragment.symbols.size());
+    for (const ObjectModule::SymbolEntry& symbol : fragment.symbols)
+        indices.push_back(m_module.symbol(symbol.name));
+    for (const ObjectModule::Relocation& relocation : fragment.textRelocations)
+        m_module.textRelocations.push_back({start + relocation.offset, indices[relocation.symbol],
+                                            relocation.kind, relocation.addend});
+    for (const ObjectModule::SymbolEntry& symbol : fragment.symbols)
+        if (symbol.section == SectionKind::Text)
+            defineSymbol(symbol.name, SectionKind::Text, start + symbol.offset, symbol.size,
+                         symbol.global, symbol.function);
+}
+
+void ObjectEmitter::resolveLocalCalls()
+{
+    std::erase_if(m_module.textRelocations, [this](const ObjectModule::Relocation& relocation) {
+        const ObjectModule::SymbolEntry& symbol = m_module.symbols[relocation.symbol];
+        if (symbol.global || symbol.section != SectionKind::Text)
+            return false;
+        const i64 disp = static_cast<i64>(symbol.offset) + relocation.addend - static_cast<i64>(relocation.offset);
+        for (size_t i = 0; i < 4; ++i)
+            (*m_text)[relocation.offset + i] = static_cast<u8>(static_cast<u64>(disp) >> (8 * i));
+        return true;
+    });
+}
+
+void ObjectEmitter::emitFunction(const Function& function)
+{
+    const size_t start = m_text->size();
+    const size_t relocationStart = m_module.textRelocations.size();
+    m_longJumps.assign(function.instructions.size(), false);
+    // Jumps start out short and are widened until every displacement fits.
+    for (bool grown = true; grown;) {
+        m_text->resize(start);
+        m_module.textRelocations.resize(relocationStart);
+        m_labels.clear();
+        m_jumps.clear();
+        emitByte(0x55);
+        emitBytes({0x48, 0x89, 0xE5});
+        for (m_instIndex = 0; m_instIndex < function.instructions.size(); ++m_instIndex)
+            emitInst(*function.instructions[m_instIndex]);
+        grown = false;
+        for (const JumpSite& jump : m_jumps) {
+            const i64 disp = static_cast<i64>(m_labels.at(jump.target)) - static_cast<i64>(jump.dispOffset + 1);
+            if (jump.isShort && !fitsI8(disp)) {
+                m_longJumps[jump.instIndex] = true;
+                grown = true;
+            }
+        }
+    }
+    patchJumps();
+    defineSymbol(function.name.value.str(), SectionKind::Text, start, m_text->size() - start,
+                 function.isGlobal, true);
+}
+
+void ObjectEmitter::patchJumps()
+{
+    for (const JumpSite& jump : m_jumps) {
+        const size_t dispSize = jump.isShort ? 1 : 4;
+        const i64 disp = static_cast<i64>(m_labels.at(jump.target)) - static_cast<i64>(jump.dispOffset + dispSize);
+        for (size_t i = 0; i < dispSize; ++i)
+            (*m_text)[jump.dispOffset + i] = static_cast<u8>(static_cast<u64>(disp) >> (8 * i));
+    }
+}
+
+void ObjectEmitter::emitStaticVariable(const StaticVariable& variable)
+{
+    const i64 size = Operators::getSizeAsmType(variable.type);
+    const std::string name = variable.name.value.str();
+    if (variable.init == 0 && variable.type != AsmType::Double) {
+        const u64 offset = place(SectionKind::Bss, size, {}, size);
+        defineSymbol(name, SectionKind::Bss, offset, size, variable.global, false);
+        return;
+    }
+    std::vector<u8> bytes;
+    appendValue(bytes, variable.init, size);
+    const u64 offset = place(SectionKind::Data, size, bytes, size);
+    defineSymbol(name, SectionKind::Data, offset, size, variable.global, false);
+}
+
+void ObjectEmitter::emitStaticConstant(const ConstVariable& variable)
+{
+    std::vector<u8> bytes;
+    appendValue(bytes, std::bit_cast<u64>(variable.staticInit), 8);
+    const u64 offset = place(SectionKind::Rodata, variable.alignment, bytes, bytes.size());
+    const std::string name = variable.local ? ".L" + variable.name.value.str() : variable.name.value.str();
+    defineSymbol(name, SectionKind::Rodata, offset, bytes.size(), false, false);
+}
+
+void ObjectEmitter::emitStaticArray(const ArrayVariable& array)
+{
+    const i64 elementSize = Operators::getSizeAsmType(array.type);
+    if (array.initializers.size() == 1 && array.initializers.front()->kind == Initializer::Kind::Zero) {
+        const i64 size = dynCast<const ZeroInitializer>(array.initializers.front().get())->size * elementSize;
+        const u64 offset = place(SectionKind::Bss, array.alignment, {}, size);
+        defineSymbol(array.name.value.str(), SectionKind::Bss, offset, size, array.isGlobal, false);
+        return;
+    }
+    std::vector<u8> bytes;
+    for (const auto& init : array.initializers) {
+        if (init->kind == Initializer::Kind::Zero)
+            bytes.resize(bytes.size() + dynCast<const ZeroInitializer>(init.get())->size * elementSize);
+        else
+            appendValue(bytes, dynCast<const ValueInitializer>(init.get())->init, elementSize);
+    }
+    const u64 offset = place(SectionKind::Data, array.alignment, bytes, bytes.size());
+    defineSymbol(array.name.value.str(), SectionKind::Data, offset, bytes.size(), array.isGlobal, false);
+}
+
+void ObjectEmitter::emitStaticString(const StringVariable& variable)
+{
+    std::vector<u8> bytes(variable.value.begin(), variable.value.end());
+    if (variable.nullTerminated)
+        bytes.push_back(0);
+    const u64 offset = place(SectionKind::Rodata, 1, bytes, bytes.size());
+    defineSymbol(variable.name.value.str(), SectionKind::Rodata, offset, bytes.size(), false, false);
+}
+
+u64 ObjectEmitter::place(const SectionKind section, const u64 alignment, const std::vector<u8>& bytes,
+                         const u64 size)
+{
+    ObjectModule::Section& target = m_module.section(section);
+    target.alignment = std::max(target.alignment, alignment);
+    if (section == SectionKind::Bss) {
+        target.bssSize = (target.bssSize + alignment - 1) / alignment * alignment;
+        const u64 offset = target.bssSize;
+        target.bssSize += size;
+        return offset;
+    }
+    target.bytes.resize((target.bytes.size() + alignment - 1) / alignment * alignment);
+    const u64 offset = target.bytes.size();
+    target.bytes.insert(target.bytes.end(), bytes.begin(), bytes.end());
+    return offset;
+}
+
+void ObjectEmitter::defineSymbol(const std::string& name, const SectionKind section, const u64 offset,
+                                 const u64 size, const bool global, const bool function)
+{
+    ObjectModule::SymbolEntry& symbol = m_module.symbols[m_module.symbol(name)];
+    symbol.section = section;
+    symbol.offset = offset;
+    symbol.size = size;
+    symbol.global = global;
+    symbol.function = function;
+}
+
+void ObjectEmitter::emitInst(const Inst& inst)
+{
+    switch (inst.kind) {
+        case Inst::Kind::Move:
+            emitMove(*dynCast<const MoveInst>(&inst));
+            return;
+        case Inst::Kind::MoveSX:
+            emitMoveSX(*dynCast<const MoveSXInst>(&inst));
+            return;
+        case Inst::Kind::MoveZeroExtend:
+            emitMoveZeroExtend(*dynCast<const MoveZeroExtendInst>(&inst));
+            return;
+        case Inst::Kind::Lea: {
+            const auto lea = dynCast<const LeaInst>(&inst);
+            emitRm(0, isQuad(lea->type), {0x8D}, registerNumber(lea->dst.regKind), lea->src);
+            return;
+        }
+        case Inst::Kind::Cvttsd2si: {
+            const auto cvttsd2si = dynCast<const Cvttsd2siInst>(&inst);
+            emitRm(0xF2, isQuad(cvttsd2si->dstType), {0x0F, 0x2C}, registerNumber(cvttsd2si->dst.regKind), cvttsd2si->src);
+            return;
+        }
+        case Inst::Kind::Cvtsi2sd: {
+            const auto cvtsi2sd = dynCast<const Cvtsi2sdInst>(&inst);
+            const AsmType srcType = cvtsi2sd->srcType == AsmType::Double ? cvtsi2sd->src.type : cvtsi2sd->srcType;
+            emitRm(0xF2, isQuad(srcType), {0x0F, 0x2A}, registerNumber(cvtsi2sd->dst.regKind), cvtsi2sd->src);
+            return;
+        }
+        case Inst::Kind::Unary:
+            emitUnary(*dynCast<const UnaryInst>(&inst));
+            return;
+        case Inst::Kind::Binary:
+            emitBinary(*dynCast<const BinaryInst>(&inst));
+            return;
+        case Inst::Kind::Cmp:
+            emitCmp(*dynCast<const CmpInst>(&inst));
+            return;
+        case Inst::Kind::Idiv: {
+            const auto idiv = dynCast<const IdivInst>(&inst);
+            emitRm(0, isQuad(idiv->type), {0xF7}, 7, idiv->operand);
+            return;
+        }
+        case Inst::Kind::Div: {
+            const auto div = dynCast<const DivInst>(&inst);
+            emitRm(0, isQuad(div->type), {0xF7}, 6, div->operand);
+            return;
+        }
+        case Inst::Kind::Cdq: {
+            if (isQuad(dynCast<const CdqInst>(&inst)->type))
+                emitByte(rexBase | rexW);
+            emitByte(0x99);
+            return;
+        }
+        case Inst::Kind::Jmp:
+            emitJump(dynCast<const JmpInst>(&inst)->target.value, 0xEB, {0xE9});
+            return;
+        case Inst::Kind::JmpCC: {
+            const auto jmpCC = dynCast<const JmpCCInst>(&inst);
+            const u8 condCode = condCodeNumber(jmpCC->condition);
+            emitJump(jmpCC->target.value, 0x70 | condCode, {0x0F, static_cast<u8>(0x80 | condCode)});
+            return;
+        }
+        case Inst::Kind::SetCC: {
+            const auto setCC = dynCast<const SetCCInst>(&inst);
+            emitRm(0, false, {0x0F, static_cast<u8>(0x90 | condCodeNumber(setCC->condition))}, 0,
+                   setCC->operand, ByteRegs::Rm);
+            return;
+        }
+        case Inst::Kind::Label:
+            m_labels[dynCast<const LabelInst>(&inst)->target.value] = m_text->size();
+            return;
+        case Inst::Kind::PushPseudo:
+            return;
+        case Inst::Kind::Push:
+            emitPush(dynCast<const PushInst>(&inst)->operand);
+            return;
+        case Inst::Kind::Call:
+            emitCall(*dynCast<const CallInst>(&inst));
+            return;
+        case Inst::Kind::Ret:
+            emitBytes({0x48, 0x89, 0xEC, 0x5D, 0xC3});
+            return;
+        default:
+            std::abort();
+    }
+}
+
+void ObjectEmitter::emitMove(const MoveInst& move)
+{
+    if (move.type == AsmType::Double) {
+        if (move.dst.kind == Operand::Kind::Register) {
+            emitRm(0xF2, false, {0x0F, 0x10}, registerNumber(move.dst.regKind), move.src);
+            return;
+        }
+        emitRm(0xF2, false, {0x0F, 0x11}, registerNumber(move.src.regKind), move.dst);
+        return;
+    }
+    if (isXmm(move.src) || isXmm(move.dst))
+        return emitMoveXmmQuad(move);
+    const bool isByte = move.type == AsmType::Byte;
+    if (move.src.kind == Operand::Kind::Imm) {
+        emitMoveImm(move.src, move.dst, move.type);
+        return;
+    }
+    if (move.src.kind == Operand::Kind::Register) {
+        emitRm(0, isQuad(move.type), {static_cast<u8>(isByte ? 0x88 : 0x89)}, registerNumber(move.src.regKind),
+               move.dst, isByte ? ByteRegs::RegAndRm : ByteRegs::None);
+        return;
+    }
+    emitRm(0, isQuad(move.type), {static_cast<u8>(isByte ? 0x8A : 0x8B)}, registerNumber(move.dst.regKind),
+           move.src, isByte ? ByteRegs::RegAndRm : ByteRegs::None);
+}
+
+void ObjectEmitter::emitMoveXmmQuad(const MoveInst& move)
+{
+    if (isXmm(move.dst)) {
+        const u8 dst = registerNumber(move.dst.regKind);
+        if (move.src.kind == Operand::Kind::Register && !isXmm(move.src))
+            emitRm(0x66, true, {0x0F, 0x6E}, dst, move.src);
+        else
+            emitRm(0xF3, false, {0x0F, 0x7E}, dst, move.src);
+        return;
+    }
+    const u8 src = registerNumber(move.src.regKind);
+    if (move.dst.kind == Operand::Kind::Register)
+        emitRm(0x66, true, {0x0F, 0x7E}, src, move.dst);
+    else
+        emitRm(0x66, false, {0x0F, 0xD6}, src, move.dst);
+}
+
+void ObjectEmitter::emitMoveImm(const Operand& imm, const Operand& dst, const AsmType type)
+{
+    if (type == AsmType::Byte) {
+        emitRm(0, false, {0xC6}, 0, dst, ByteRegs::Rm, 1);
+        emitImm(imm.value, 1);
+        return;
+    }
+    const bool quadWide = isQuad(type) && !fitsI32(static_cast<i64>(imm.value));
+    if (dst.kind == Operand::Kind::Register && (!isQuad(type) || quadWide)) {
+        const u8 reg = registerNumber(dst.regKind);
+        const u8 rex = (quadWide ? rexW : 0) | (reg & 8 ? rexB : 0);
+        if (rex != 0)
+            emitByte(rexBase | rex);
+        emitByte(0xB8 | (reg & 7));
+        emitImm(imm.value, quadWide ? 8 : 4);
+        return;
+    }
+    if (quadWide)
+        std::abort();
+    emitRm(0, isQuad(type), {0xC7}, 0, dst, ByteRegs::None, 4);
+    emitImm(imm.value, 4);
+}
+
+void ObjectEmitter::emitMoveSX(const MoveSXInst& moveSX)
+{
+    const bool quad = isQuad(moveSX.dstType);
+    if (moveSX.srcType == AsmType::Byte)
+        emitRm(0, quad, {0x0F, 0xBE}, registerNumber(moveSX.dst.regKind), moveSX.src, ByteRegs::Rm);
+    else
+        emitRm(0, quad, {0x63}, registerNumber(moveSX.dst.regKind), moveSX.src);
+}
+
+void ObjectEmitter::emitMoveZeroExtend(const MoveZeroExtendInst& moveZero)
+{
+    if (moveZero.srcType == AsmType::Byte)
+        emitRm(0, isQuad(moveZero.dstType), {0x0F, 0xB6}, registerNumber(moveZero.dst.regKind), moveZero.src, ByteRegs::Rm);
+    else
+        emitRm(0, false, {0x8B}, registerNumber(moveZero.dst.regKind), moveZero.src);
+}
+
+void ObjectEmitter::emitUnary(const UnaryInst& unary)
+{
+    const bool isByte = unary.type == AsmType::Byte;
+    const ByteRegs byteRegs = isByte ? ByteRegs::Rm : ByteRegs::None;
+    switch (unary.oper) {
+        case UnaryInst::Operator::Neg:
+            emitRm(0, isQuad(unary.type), {static_cast<u8>(isByte ? 0xF6 : 0xF7)}, 3, unary.destination, byteRegs);
+            return;
+        case UnaryInst::Operator::Not:
+            emitRm(0, isQuad(unary.type), {static_cast<u8>(isByte ? 0xF6 : 0xF7)}, 2, unary.destination, byteRegs);
+            return;
+        case UnaryInst::Operator::Shr:
+            emitRm(0, isQuad(unary.type), {static_cast<u8>(isByte ? 0xD0 : 0xD1)}, 5, unary.destination, byteRegs);
+            return;
+        default:
+            std::abort();
+    }
+}
+
+void ObjectEmitter::emitBinary(const BinaryInst& binary)
+{
+    using Operator = BinaryInst::Operator;
+    if (binary.type == AsmType::Double)
+        return emitBinaryDouble(binary);
+    switch (binary.oper) {
+        case Operator::Add:                 return emitArithmetic(0, binary.lhs, binary.rhs, binary.type);
+        case Operator::BitwiseOr:           return emitArithmetic(1, binary.lhs, binary.rhs, binary.type);
+        case Operator::BitwiseAnd:          return emitArithmetic(4, binary.lhs, binary.rhs, binary.type);
+        case Operator::Sub:                 return emitArithmetic(5, binary.lhs, binary.rhs, binary.type);
+        case Operator::BitwiseXor:          return emitArithmetic(6, binary.lhs, binary.rhs, binary.type);
+        case Operator::Mul:                 return emitMul(binary);
+        case Operator::LeftShiftSigned:
+        case Operator::LeftShiftUnsigned:
+        case Operator::RightShiftSigned:
+        case Operator::RightShiftUnsigned:  return emitShift(binary);
+        default:
+            std::abort();
+    }
+}
+
+void ObjectEmitter::emitBinaryDouble(const BinaryInst& binary)
+{
+    using Operator = BinaryInst::Operator;
+    const u8 dst = registerNumber(binary.rhs.regKind);
+    switch (binary.oper) {
+        case Operator::Add:         return emitRm(0xF2, false, {0x0F, 0x58}, dst, binary.lhs);
+        case Operator::Sub:         return emitRm(0xF2, false, {0x0F, 0x5C}, dst, binary.lhs);
+        case Operator::Mul:         return emitRm(0xF2, false, {0x0F, 0x59}, dst, binary.lhs);
+        case Operator::DivDouble:   return emitRm(0xF2, false, {0x0F, 0x5E}, dst, binary.lhs);
+        case Operator::BitwiseXor:  return emitRm(0x66, false, {0x0F, 0x57}, dst, binary.lhs);
+        default:
+            std::abort();
+    }
+}
+
+void ObjectEmitter::emitShift(const BinaryInst& binary)
+{
+    using Operator = BinaryInst::Operator;
+    u8 extension = 4;
+    if (binary.oper == Operator::RightShiftSigned)
+        extension = 7;
+    else if (binary.oper == Operator::RightShiftUnsigned)
+        extension = 5;
+    const bool isByte = binary.type == AsmType::Byte;
+    const ByteRegs byteRegs = isByte ? ByteRegs::Rm : ByteRegs::None;
+    if (binary.lhs.kind == Operand::Kind::Imm) {
+        emitRm(0, isQuad(binary.type), {static_cast<u8>(isByte ? 0xC0 : 0xC1)}, extension, binary.rhs, byteRegs, 1);
+        emitImm(binary.lhs.value, 1);
+        return;
+    }
+    emitRm(0, isQuad(binary.type), {static_cast<u8>(isByte ? 0xD2 : 0xD3)}, extension, binary.rhs, byteRegs);
+}
+
+void ObjectEmitter::emitMul(const BinaryInst& binary)
+{
+    const u8 dst = registerNumber(binary.rhs.regKind);
+    if (binary.lhs.kind == Operand::Kind::Imm) {
+        const u64 value = binary.lhs.value;
+        const i64 imm = isQuad(binary.type) ? static_cast<i64>(value) : static_cast<i32>(value);
+        if (fitsI8(imm)) {
+            emitRm(0, isQuad(binary.type), {0x6B}, dst, binary.rhs, ByteRegs::None, 1);
+            emitImm(value, 1);
+        } else {
+            emitRm(0, isQuad(binary.type), {0x69}, dst, binary.rhs, ByteRegs::None, 4);
+            emitImm(value, 4);
+        }
+        return;
+    }
+    emitRm(0, isQuad(binary.type), {0x0F, 0xAF}, dst, binary.lhs);
+}
+
+void ObjectEmitter::emitArithmetic(const u8 extension, const Operand& src, const Operand& dst, const AsmType type)
+{
+    const bool isByte = type == AsmType::Byte;
+    const u8 base = extension << 3;
+    if (src.kind == Operand::Kind::Imm) {
+        const u64 value = src.value;
+        const i64 imm = isQuad(type) ? static_cast<i64>(value) : static_cast<i32>(value);
+        if (isByte) {
+            emitRm(0, false, {0x80}, extension, dst, ByteRegs::Rm, 1);
+            emitImm(value, 1);
+        } else if (fitsI8(imm)) {
+            emitRm(0, isQuad(type), {0x83}, extension, dst, ByteRegs::None, 1);
+            emitImm(value, 1);
+        } else {
+            if (!fitsI32(imm))
+                std::abort();
+            emitRm(0, isQuad(type), {0x81}, extension, dst, ByteRegs::None, 4);
+            emitImm(value, 4);
+        }
+        return;
+    }
+    const ByteRegs byteRegs = isByte ? ByteRegs::RegAndRm : ByteRegs::None;
+    if (src.kind == Operand::Kind::Register) {
+        const u8 reg = registerNumber(src.regKind);
+        emitRm(0, isQuad(type), {static_cast<u8>(base | (isByte ? 0x00 : 0x01))}, reg, dst, byteRegs);
+        return;
+    }
+    const u8 reg = registerNumber(dst.regKind);
+    emitRm(0, isQuad(type), {static_cast<u8>(base | (isByte ? 0x02 : 0x03))}, reg, src, byteRegs);
+}
+
+void ObjectEmitter::emitCmp(const CmpInst& cmp)
+{
+    if (cmp.lhs.type == AsmType::Double) {
+        const u8 reg = registerNumber(cmp.rhs.regKind);
+        emitRm(0x66, false, {0x0F, 0x2F}, reg, cmp.lhs);
+        return;
+    }
+    emitArithmetic(7, cmp.lhs, cmp.rhs, cmp.lhs.type);
+}
+
+void ObjectEmitter::emitJump(const Symbol target, const u8 shortOpcode, const std::initializer_list<u8> longOpcode)
+{
+    const bool isShort = !m_longJumps[m_instIndex];
+    if (isShort)
+        emitByte(shortOpcode);
+    else
+        emitBytes(longOpcode);
+    m_jumps.push_back({m_instIndex, m_text->size(), target, isShort});
+    emitImm(0, isShort ? 1 : 4);
+}
+
+void ObjectEmitter::emitPush(const Operand& operand)
+{
+    if (operand.kind == Operand::Kind::Register) {
+        const u8 reg = registerNumber(operand.regKind);
+        if (reg & 8)
+            emitByte(rexBase | rexB);
+        emitByte(0x50 | (reg & 7));
+        return;
+    }
+    if (operand.kind == Operand::Kind::Imm) {
+        const u64 value = operand.value;
+        if (fitsI8(static_cast<i64>(value))) {
+            emitByte(0x6A);
+            emitImm(value, 1);
+        } else {
+            emitByte(0x68);
+            emitImm(value, 4);
+        }
+        return;
+    }
+    emitRm(0, false, {0xFF}, 6, operand);
+}
+
+void ObjectEmitter::emitCall(const CallInst& call)
+{
+    emitByte(0xE8);
+    m_module.textRelocations.push_back({m_text->size(), m_module.symbol(call.funName.value.str()),
+                                        ObjectModule::RelocationKind::PLT32, -4});
+    emitImm(0, 4);
+}
+
+void ObjectEmitter::emitRm(const u8 prefix, const bool wide, const std::initializer_list<u8> opcode,
+                           const u8 reg, const Operand& rm, const ByteRegs byteRegs, const u8 immSize)
+{
+    // Without a REX prefix the byte encodings of SP, BP, SI and DI select AH, CH, DH and BH.
+    const auto isHighByte = [](const u8 number) { return 4 <= number && number < 8; };
+    u8 rex = (wide ? rexW : 0) | (reg & 8 ? rexR : 0);
+    bool forceRex = byteRegs == ByteRegs::RegAndRm && isHighByte(reg);
+    u8 mod = 0;
+    u8 rmBits = 0;
+    std::optional<u8> sib;
+    i64 disp = 0;
+    switch (rm.kind) {
+        case Operand::Kind::Register: {
+            const u8 number = registerNumber(rm.regKind);
+            mod = 3;
+            rmBits = number & 7;
+            rex |= number & 8 ? rexB : 0;
+            forceRex = forceRex || (byteRegs != ByteRegs::None && isHighByte(number));
+            break;
+        }
+        case Operand::Kind::Memory: {
+            const u8 base = registerNumber(rm.regKind);
+            disp = rm.offset;
+            rmBits = base & 7;
+            rex |= base & 8 ? rexB : 0;
+            if (rmBits == 4)
+                sib = 0x24;
+            mod = disp == 0 && rmBits != 5 ? 0 : fitsI8(disp) ? 1 : 2;
+            break;
+        }
+        case Operand::Kind::Indexed: {
+            const u8 base = registerNumber(rm.regKind);
+            const u8 index = registerNumber(rm.indexRegKind);
+            rmBits = 4;
+            rex |= (base & 8 ? rexB : 0) | (index & 8 ? rexX : 0);
+            sib = static_cast<u8>(scaleBits(rm.scale) << 6 | (index & 7) << 3 | (base & 7));
+            mod = (base & 7) == 5 ? 1 : 0;
+            break;
+        }
+        case Operand::Kind::Data:
+            rmBits = 5;
+            break;
+        default:
+            std::abort();
+    }
+    if (prefix != 0)
+        emitByte(prefix);
+    if (rex != 0 || forceRex)
+        emitByte(rexBase | rex);
+    emitBytes(opcode);
+    emitByte(static_cast<u8>(mod << 6 | (reg & 7) << 3 | rmBits));
+    if (sib.has_value())
+        emitByte(*sib);
+    if (rm.kind == Operand::Kind::Data) {
+        m_module.textRelocations.push_back({m_text->size(), m_module.symbol(dataSymbolName(rm)),
+                                            ObjectModule::RelocationKind::PC32, -4 - static_cast<i64>(immSize)});
+        emitImm(0, 4);
+    }
+    else if (mod == 1)
+        emitImm(static_cast<u64>(disp), 1);
+    else if (mod == 2)
+        emitImm(static_cast<u64>(disp), 4);
+}
+
+void ObjectEmitter::emitImm(const u64 value, const u8 size)
+{
+    for (u8 i = 0; i < size; ++i)
+        emitByte(static_cast<u8>(value >> (8 * i)));
+}
+
+} // CodeGen
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "AsmAST.hpp"
+#include "ObjectModule.hpp"
+#include "WorkStealingPool.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace CodeGen {
+
+// x86-64 encoder working directly on the fixed up instruction tree. Produces the same
+// machine code gas would for the text of asmProgram, without building that text.
+class ObjectEmitter {
+    using RegKind = Operand::RegKind;
+    using SectionKind = ObjectModule::SectionKind;
+    enum class ByteRegs : u8 {
+        None, Rm, RegAndRm
+    };
+    struct JumpSite {
+        size_t instIndex;
+        size_t dispOffset;
+        Symbol target;
+        bool isShort;
+    };
+    ObjectModule m_module;
+    std::vector<u8>* m_text = nullptr;
+    std::unordered_map<Symbol, size_t> m_labels;
+    std::vector<JumpSite> m_jumps;
+    std::vector<bool> m_longJumps;
+    size_t m_instIndex = 0;
+public:
+    [[nodiscard]] ObjectModule emitProgram(const Program& program);
+    [[nodiscard]] ObjectModule emitProgram(const Program& program, const WorkStealingPool& pool);
+    // The code of one function on its own. Calls between functions stay relocations until the
+    // fragment is appended to a program.
+    [[nodiscard]] ObjectModule emitFunctionFragment(const Function& function);
+private:
+    void emitTopLevel(const TopLevel& topLevel);
+    void emitFunction(const Function& function);
+    void appendFragment(const ObjectModule& fragment);
+    void emitStaticVariable(const StaticVariable& variable);
+    void emitStaticConstant(const ConstVariable& variable);
+    void emitStaticArray(const ArrayVariable& array);
+    void emitStaticString(const StringVariable& variable);
+    u64 place(SectionKind section, u64 alignment, const std::vector<u8>& bytes, u64 size);
+    void defineSymbol(const std::string& name, SectionKind section, u64 offset, u64 size, bool global, bool function);
+
+    void emitInst(const Inst& inst);
+    void emitMove(const MoveInst& move);
+    void emitMoveXmmQuad(const MoveInst& move);
+    void emitMoveImm(const Operand& imm, const Operand& dst, AsmType type);
+    void emitMoveSX(const MoveSXInst& moveSX);
+    void emitMoveZeroExtend(const MoveZeroExtendInst& moveZero);
+    void emitUnary(const UnaryInst& unary);
+    void emitBinary(const BinaryInst& binary);
+    void emitBinaryDouble(const BinaryInst& binary);
+    void emitShift(const BinaryInst& binary);
+    void emitMul(const BinaryInst& binary);
+    void emitArithmetic(u8 extension, const Operand& src, const Operand& dst, AsmType type);
+    void emitCmp(const CmpInst& cmp);
+    void emitJump(Symbol target, u8 shortOpcode, std::initializer_list<u8> longOpcode);
+    void emitPush(const Operand& operand);
+    void emitCall(const CallInst& call);
+
+    void emitRm(u8 prefix, bool wide, std::initializer_list<u8> opcode, u8 reg, const Operand& rm,
+                ByteRegs byteRegs = ByteRegs::None, u8 immSize = 0);
+    void emitByte(u8 byte) { m_text->push_back(byte); }
+    void emitBytes(std::initializer_list<u8> bytes) { m_text->insert(m_text->end(), bytes); }
+    void emitImm(u64 value, u8 size);
+    void patchJumps();
+    void resolveLocalCalls();
+};
+
+[[nodiscard]] ObjectModule emitObject(const Program& program);
+[[nodiscard]] ObjectModule emitObject(const Program& program, const WorkStealingPool& pool);
+[[nodiscard]] ObjectModule emitFunctionObject(const Function& function);
+[[nodiscard]] u8 registerNumber(Operand::RegKind reg);
+[[nodiscard]] std::string dataSymbolName(const Operand& data);
+
+} // CodeGen
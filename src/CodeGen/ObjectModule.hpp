@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CodeGen {
+
+// Machine code and data of one translation unit before it is given a container format.
+// Consumed by the ELF object writer.
+struct ObjectModule {
+    enum class SectionKind : u8 {
+        Text, Data, Bss, Rodata, Undefined
+    };
+    enum class RelocationKind : u8 {
+        PC32, PLT32
+    };
+    struct Section {
+        std::vector<u8> bytes;
+        u64 bssSize = 0;
+        u64 alignment = 1;
+        [[nodiscard]] u64 size() const { return bytes.empty() ? bssSize : bytes.size(); }
+    };
+    struct SymbolEntry {
+        std::string name;
+        SectionKind section = SectionKind::Undefined;
+        u64 offset = 0;
+        u64 size = 0;
+        bool global = false;
+        bool function = false;
+    };
+    struct Relocation {
+        u64 offset;
+        u32 symbol;
+        RelocationKind kind;
+        i64 addend;
+    };
+    static constexpr size_t sectionCount = 4;
+
+    std::array<Section, sectionCount> sections;
+    std::vector<SymbolEntry> symbols;
+    std::vector<Relocation> textRelocations;
+    std::unordered_map<std::string, u32> symbolIndex;
+
+    [[nodiscard]] Section& section(const SectionKind kind) { return sections[static_cast<size_t>(kind)]; }
+    [[nodiscard]] const Section& section(const SectionKind kind) const
+    {
+        return sections[static_cast<size_t>(kind)];
+    }
+    u32 symbol(const std::string& name)
+    {
+        const auto [it, inserted] = symbolIndex.try_emplace(name, static_cast<u32>(symbols.size()));
+        if (inserted)
+            symbols.push_back(SymbolEntry{.name = name});
+        return it->second;
+    }
+};
+
+} // CodeGen
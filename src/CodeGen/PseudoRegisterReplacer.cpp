@@ -1,52 +1,25 @@
 #include "PseudoRegisterReplacer.hpp"
-#include "DynCast.hpp"
 #include "Operators.hpp"
 
 namespace CodeGen {
 
-std::tuple<ReferingTo, AsmType, bool, std::string, i64> getPseudoValues(const std::shared_ptr<Operand>& operand)
+void PseudoRegisterReplacer::replaceIfPseudo(Operand& operand)
 {
-    if (operand->kind == Operand::Kind::PseudoMem) {
-        const auto pseudoMem = dynamic_cast<PseudoMemOperand*>(operand.get());
-        return {pseudoMem->referingTo, pseudoMem->type, pseudoMem->local, pseudoMem->identifier.value, pseudoMem->offset};
+    if (operand.kind != Operand::Kind::PseudoMem && operand.kind != Operand::Kind::Pseudo)
+        return;
+    const Symbol identifier = operand.identifier.value;
+    if (operand.referingTo == ReferingTo::Extern || operand.referingTo == ReferingTo::Static) {
+        operand = DataOperand(Identifier(identifier), operand.type, !operand.local);
+        return;
     }
-    if (operand->kind == Operand::Kind::Pseudo) {
-        const auto pseudo = dynamic_cast<PseudoOperand*>(operand.get());
-        return {pseudo->referingTo, pseudo->type, pseudo->local, pseudo->identifier.value, 0};
-    }
-    std::abort();
-}
-
-void PseudoRegisterReplacer::replaceIfPseudo(std::shared_ptr<Operand>& operand)
-{
-    if (operand && (operand->kind == Operand::Kind::PseudoMem || operand->kind == Operand::Kind::Pseudo)) {
-        const auto [referingTo, asmType, isLocal, identifier, offset] = getPseudoValues(operand);
-        if (referingTo == ReferingTo::Extern || referingTo == ReferingTo::Static) {
-            operand = std::make_shared<DataOperand>(Identifier(identifier), asmType, !isLocal);
-            return;
-        }
-        if (!m_pseudoMap.contains(identifier)) {
-            if (operand->kind == Operand::Kind::PseudoMem) {
-                const auto pseudoMem = dynCast<PseudoMemOperand>(operand.get());
-                i64 arraySize = pseudoMem->size * Operators::getSizeAsmType(asmType);
-                if (arraySize % pseudoMem->alignment != 0) {
-                    arraySize -= arraySize % pseudoMem->alignment;
-                    arraySize += pseudoMem->alignment;
-                }
-                m_stackPtr -= arraySize;
-                fitTo8Alignment();
-                m_pseudoMap[identifier] = m_stackPtr;
-                operand = std::make_shared<MemoryOperand>(
-                    Operand::RegKind::BP, m_stackPtr, operand->type);
-                return;
-            }
-            m_stackPtr -= 1 * Operators::getSizeAsmType(asmType);
-            fitTo8Alignment();
-            m_pseudoMap[identifier] = m_stackPtr;
-        }
-        operand = std::make_shared<MemoryOperand>(
-            Operand::RegKind::BP, m_pseudoMap.at(identifier) + offset, operand->type);
+    const i64 offset = operand.kind == Operand::Kind::PseudoMem ? operand.offset : 0;
+    auto [it, inserted] = m_pseudoMap.try_emplace(identifier, 0);
+    if (inserted) {
+        m_stackPtr -= Operators::getSizeAsmType(operand.type);
+        fitTo8Alignment();
+        it->second = m_stackPtr;
     }
+    operand = MemoryOperand(Operand::RegKind::BP, it->second + offset, operand.type);
 }
 
 void PseudoRegisterReplacer::visit(MoveInst& move)
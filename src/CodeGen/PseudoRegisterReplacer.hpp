@@ -7,9 +7,13 @@
 namespace CodeGen {
 
 class PseudoRegisterReplacer final : public InstVisitor {
-    std::unordered_map<std::string, i64> m_pseudoMap;
+    std::unordered_map<Symbol, i64> m_pseudoMap;
     i64 m_stackPtr = 0;
 public:
+    PseudoRegisterReplacer() = default;
+    explicit PseudoRegisterReplacer(const i64 stackPtr)
+        : m_stackPtr(stackPtr) {}
+
     [[nodiscard]] i64 stackPointer() const { return m_stackPtr; }
 
     void visit(MoveInst& move) override;
@@ -36,8 +40,6 @@ public:
 private:
     void fitTo8Alignment();
     void fitTo16Alignment();
-    void replaceIfPseudo(std::shared_ptr<Operand>& operand);
+    void replaceIfPseudo(Operand& operand);
 };
-
-std::tuple<ReferingTo, AsmType, bool, std::string, i64> getPseudoValues(const std::shared_ptr<Operand>& operand);
 } // CodeGen
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include "WorkStealingPool.hpp"
+#include "Symbol.hpp"
+
+#include <thread>
+#include <vector>
+
+namespace CodeGen {
+
+void WorkStealingPool::run(const size_t taskCount, const std::function<void(size_t)>& task) const
+{
+    const size_t threadCount = std::min(m_threadCount, taskCount);
+    if (threadCount <= 1) {
+        for (size_t i = 0; i < taskCount; ++i)
+            task(i);
+        return;
+    }
+    std::vector<Queue> queues(threadCount);
+    for (size_t i = 0; i < taskCount; ++i)
+        queues[i * threadCount / taskCount].tasks.push_back(i);
+    // No task creates new ones, so a worker that finds every deque empty is done.
+    Symbol::Table* symbols = Symbol::Table::active();
+    const auto worker = [&queues, &task, threadCount, symbols](const size_t self) {
+        const Symbol::Scope scope(symbols);
+        while (true) {
+            std::optional<size_t> index = take(queues[self], true);
+            for (size_t offset = 1; !index.has_value() && offset < threadCount; ++offset)
+                index = take(queues[(self + offset) % threadCount], false);
+            if (!index.has_value())
+                return;
+            task(*index);
+        }
+    };
+    std::vector<std::jthread> workers;
+    for (size_t i = 1; i < threadCount; ++i)
+        workers.emplace_back(worker, i);
+    worker(0);
+}
+
+std::optional<size_t> WorkStealingPool::take(Queue& queue, const bool back)
+{
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty())
+        return std::nullopt;
+    size_t index;
+    if (back) {
+        index = queue.tasks.back();
+        queue.tasks.pop_back();
+    }
+    else {
+        index = queue.tasks.front();
+        queue.tasks.pop_front();
+    }
+    return index;
+}
+
+} // CodeGen
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+namespace CodeGen {
+
+// Runs independent tasks on a fixed number of threads. Every worker starts with a contiguous
+// block of task indices, takes work from the back of its own deque and steals from the front
+// of the others once it runs dry. A pool of one thread runs everything on the caller.
+class WorkStealingPool {
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+    size_t m_threadCount;
+public:
+    explicit WorkStealingPool(const size_t threadCount)
+        : m_threadCount(std::max<size_t>(threadCount, 1)) {}
+
+    void run(size_t taskCount, const std::function<void(size_t)>& task) const;
+    [[nodiscard]] size_t threadCount() const { return m_threadCount; }
+private:
+    static std::optional<size_t> take(Queue& queue, bool back);
+};
+
+} // CodeGen
@@ -0,0 +1,264 @@
+#include "CompileCache.hpp"
+#include "Sha256.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Statistics live in one small text file: "hits misses bytesSaved size".
+constexpr std::string_view statsFileName = "stats";
+
+class FileLock {
+    int m_fd;
+public:
+    explicit FileLock(const std::filesystem::path& path)
+        : m_fd(open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644))
+    {
+        if (m_fd != -1)
+            flock(m_fd, LOCK_EX);
+    }
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+    ~FileLock()
+    {
+        if (m_fd != -1)
+            close(m_fd);
+    }
+
+    [[nodiscard]] int fd() const { return m_fd; }
+};
+
+CompileCache::Stats readStats(const int fd)
+{
+    std::string text;
+    std::array<char, 128> buffer{};
+    for (ssize_t count; (count = pread(fd, buffer.data(), buffer.size(), static_cast<off_t>(text.size()))) > 0;)
+        text.append(buffer.data(), static_cast<size_t>(count));
+    CompileCache::Stats stats;
+    std::istringstream(text) >> stats.hits >> stats.misses >> stats.bytesSaved >> stats.size;
+    return stats;
+}
+
+bool writeStats(const int fd, const CompileCache::Stats& stats)
+{
+    const std::string text = std::to_string(stats.hits) + ' ' + std::to_string(stats.misses) + ' ' +
+        std::to_string(stats.bytesSaved) + ' ' + std::to_string(stats.size) + '\n';
+    return ftruncate(fd, 0) == 0 && pwrite(fd, text.data(), text.size(), 0) == static_cast<ssize_t>(text.size());
+}
+
+std::string uniqueSuffix()
+{
+    return std::to_string(getpid()) + '-' + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+}
+
+// Copies source next to destination and renames it into place, so readers never see half a file.
+bool publish(const std::filesystem::path& source, const std::filesystem::path& temporary,
+             const std::filesystem::path& destination)
+{
+    std::error_code ec;
+    std::filesystem::copy_file(source, temporary, std::filesystem::copy_options::overwrite_existing, ec);
+    if (!ec)
+        std::filesystem::rename(temporary, destination, ec);
+    if (ec) {
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+CompileCache::CompileCache(std::filesystem::path directory, const u64 maxSize)
+    : m_directory(std::move(directory)), m_maxSize(maxSize)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory / "tmp", ec);
+}
+
+std::optional<CompileCache> CompileCache::fromEnvironment()
+{
+    const char* directory = std::getenv("CC_CACHE_DIR");
+    if (directory == nullptr || *directory == '\0')
+        return std::nullopt;
+    u64 maxSize = defaultMaxSize;
+    if (const char* size = std::getenv("CC_CACHE_SIZE"); size != nullptr) {
+        const std::string_view text(size);
+        u64 parsed = 0;
+        const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+        if (ec == std::errc() && end == text.data() + text.size())
+            maxSize = parsed;
+    }
+    return CompileCache(directory, maxSize);
+}
+
+std::string CompileCache::key(const std::string_view preprocessed, const std::string_view flags)
+{
+    static const std::string version = compilerVersion();
+    Sha256 sha256;
+    sha256.update(version);
+    sha256.update(std::string_view("\0", 1));
+    sha256.update(flags);
+    sha256.update(std::string_view("\0", 1));
+    sha256.update(preprocessed);
+    return sha256.hexDigest();
+}
+
+bool CompileCache::fetch(const std::string& key, const std::filesystem::path& outputFile) const
+{
+    const std::filesystem::path entry = entryPath(key);
+    std::error_code ec;
+    const u64 size = std::filesystem::file_size(entry, ec);
+    const bool hit = !ec && publish(entry, outputFile.string() + ".tmp" + uniqueSuffix(), outputFile);
+    if (hit)
+        std::filesystem::last_write_time(entry, std::filesystem::file_time_type::clock::now(), ec);
+    updateStats([hit, size](Stats& stats) {
+        if (!hit) {
+            ++stats.misses;
+            return;
+        }
+        ++stats.hits;
+        stats.bytesSaved += size;
+    });
+    return hit;
+}
+
+void CompileCache::store(const std::string& key, const std::filesystem::path& outputFile) const
+{
+    const std::filesystem::path entry = entryPath(key);
+    std::error_code ec;
+    std::filesystem::create_directories(entry.parent_path(), ec);
+    const u64 size = std::filesystem::file_size(outputFile, ec);
+    if (ec || !publish(outputFile, temporaryPath(key), entry))
+        return;
+    updateStats([this, size](Stats& stats) {
+        stats.size += size;
+        if (m_maxSize < stats.size)
+            evict(stats);
+    });
+}
+
+std::optional<std::string> CompileCache::load(const std::string& key) const
+{
+    const std::filesystem::path entry = entryPath(key);
+    std::ifstream file(entry, std::ios::binary);
+    if (!file)
+        return std::nullopt;
+    std::string contents{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (file.bad())
+        return std::nullopt;
+    std::error_code ec;
+    std::filesystem::last_write_time(entry, std::filesystem::file_time_type::clock::now(), ec);
+    return contents;
+}
+
+void CompileCache::save(const std::vector<std::pair<std::string, std::string>>& entries) const
+{
+    u64 size = 0;
+    for (const auto& [key, contents] : entries) {
+        const std::filesystem::path entry = entryPath(key);
+        const std::filesystem::path temporary = temporaryPath(key);
+        std::error_code ec;
+        std::filesystem::create_directories(entry.parent_path(), ec);
+        std::ofstream file(temporary, std::ios::binary);
+        file << contents;
+        file.close();
+        if (file.fail())
+            ec = std::make_error_code(std::errc::io_error);
+        else
+            std::filesystem::rename(temporary, entry, ec);
+        if (ec) {
+            std::filesystem::remove(temporary, ec);
+            continue;
+        }
+        size += contents.size();
+    }
+    if (size == 0)
+        return;
+    updateStats([this, size](Stats& stats) {
+        stats.size += size;
+        if (m_maxSize < stats.size)
+            evict(stats);
+    });
+}
+
+CompileCache::Stats CompileCache::stats() const
+{
+    Stats result;
+    updateStats([&result](const Stats& stats) { result = stats; });
+    return result;
+}
+
+std::filesystem::path CompileCache::entryPath(const std::string& key) const
+{
+    return m_directory / key.substr(0, 2) / key.substr(2);
+}
+
+std::filesystem::path CompileCache::temporaryPath(const std::string& name) const
+{
+    return m_directory / "tmp" / (name + '.' + uniqueSuffix());
+}
+
+void CompileCache::updateStats(const std::function<void(Stats&)>& update) const
+{
+    const FileLock lock(m_directory / statsFileName);
+    if (lock.fd() == -1)
+        return;
+    Stats stats = readStats(lock.fd());
+    update(stats);
+    writeStats(lock.fd(), stats);
+}
+
+// Runs under the statistics lock. Removes the least recently used entries until the cache is
+// back under 90% of its limit, so that the next few stores do not each scan the directory.
+void CompileCache::evict(Stats& stats) const
+{
+    struct Entry {
+        std::filesystem::path path;
+        std::filesystem::file_time_type lastUse;
+        u64 size;
+    };
+    std::vector<Entry> entries;
+    u64 total = 0;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(m_directory, ec);
+         !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        const std::filesystem::path& path = it->path();
+        if (it.depth() != 1 || !it->is_regular_file(ec) || path.parent_path().filename() == "tmp")
+            continue;
+        Entry entry{path, it->last_write_time(ec), it->file_size(ec)};
+        if (ec)
+            continue;
+        total += entry.size;
+        entries.push_back(std::move(entry));
+    }
+    std::ranges::sort(entries, {}, &Entry::lastUse);
+    const u64 target = m_maxSize / 10 * 9;
+    for (const Entry& entry : entries) {
+        if (total <= target)
+            break;
+        if (std::filesystem::remove(entry.path, ec))
+            total -= entry.size;
+    }
+    stats.size = total;
+}
+
+std::string compilerVersion()
+{
+    struct stat status{};
+    if (stat("/proc/self/exe", &status) != 0)
+        return "CC";
+    return "CC " + std::to_string(status.st_size) + ' ' + std::to_string(status.st_mtim.tv_sec) + '.' +
+        std::to_string(status.st_mtim.tv_nsec);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// On-disk cache of compiler output, addressed by the hash of the preprocessed source, the
+// compiler binary and the flags that change the output. Several compilers may share one
+// directory: entries are published by rename and the statistics are updated under a file lock.
+class CompileCache {
+    std::filesystem::path m_directory;
+    u64 m_maxSize;
+public:
+    struct Stats {
+        u64 hits = 0;
+        u64 misses = 0;
+        u64 bytesSaved = 0;
+        u64 size = 0;
+    };
+
+    static constexpr u64 defaultMaxSize = u64{512} << 20;
+
+    CompileCache(std::filesystem::path directory, u64 maxSize);
+
+    // Uses CC_CACHE_DIR, bounded by CC_CACHE_SIZE bytes if set.
+    [[nodiscard]] static std::optional<CompileCache> fromEnvironment();
+
+    [[nodiscard]] static std::string key(std::string_view preprocessed, std::string_view flags);
+    // Copies the entry for key to outputFile, returns false on a miss.
+    [[nodiscard]] bool fetch(const std::string& key, const std::filesystem::path& outputFile) const;
+    void store(const std::string& key, const std::filesystem::path& outputFile) const;
+    // Entries that are not output files, such as the functions IncrementalBuild reuses. They
+    // count towards the size limit but not towards the hit statistics.
+    [[nodiscard]] std::optional<std::string> load(const std::string& key) const;
+    void save(const std::vector<std::pair<std::string, std::string>>& entries) const;
+    [[nodiscard]] Stats stats() const;
+    [[nodiscard]] const std::filesystem::path& directory() const { return m_directory; }
+    [[nodiscard]] u64 maxSize() const { return m_maxSize; }
+private:
+    [[nodiscard]] std::filesystem::path entryPath(const std::string& key) const;
+    [[nodiscard]] std::filesystem::path temporaryPath(const std::string& name) const;
+    void updateStats(const std::function<void(Stats&)>& update) const;
+    void evict(Stats& stats) const;
+};
+
+std::string compilerVersion();
@@ -0,0 +1,308 @@
+#include "CompileServer.hpp"
+#include "CompilerDriver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace Server {
+
+namespace {
+
+thread_local Connection* t_connection = nullptr;
+
+constexpr u32 maxStrings = 1 << 16;
+constexpr u32 maxStringLength = 1 << 20;
+
+// --run executes in the calling process and --time-trace records into process-wide state that
+// concurrent requests would share, so both stay with the client.
+std::optional<std::string> localOnlyOption(const std::vector<std::string>& args)
+{
+    for (const std::string& arg : args)
+        if (arg == "--run" || arg.starts_with("--time-trace="))
+            return arg.substr(0, arg.find('='));
+    return std::nullopt;
+}
+
+// Sends the text of the threads inside an OutputScope to their connection, everything else to
+// the buffer the stream had before.
+class RoutingBuffer final : public std::streambuf {
+    FrameKind m_kind;
+    std::streambuf* m_fallback;
+public:
+    RoutingBuffer(const FrameKind kind, std::streambuf* fallback)
+        : m_kind(kind), m_fallback(fallback) {}
+protected:
+    std::streamsize xsputn(const char* text, const std::streamsize count) override
+    {
+        if (t_connection == nullptr)
+            return m_fallback->sputn(text, count);
+        t_connection->send(m_kind, std::string_view(text, static_cast<size_t>(count)));
+        return count;
+    }
+    int_type overflow(const int_type ch) override
+    {
+        if (traits_type::eq_int_type(ch, traits_type::eof()))
+            return traits_type::not_eof(ch);
+        const char c = traits_type::to_char_type(ch);
+        return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+    }
+    int sync() override
+    {
+        return t_connection == nullptr ? m_fallback->pubsync() : 0;
+    }
+};
+
+class StreamRedirect {
+    std::ostream& m_stream;
+    RoutingBuffer m_buffer;
+    std::streambuf* m_previous;
+public:
+    StreamRedirect(std::ostream& stream, const FrameKind kind)
+        : m_stream(stream), m_buffer(kind, stream.rdbuf()), m_previous(stream.rdbuf(&m_buffer)) {}
+    StreamRedirect(const StreamRedirect&) = delete;
+    StreamRedirect& operator=(const StreamRedirect&) = delete;
+    ~StreamRedirect() { m_stream.rdbuf(m_previous); }
+};
+
+bool writeAll(const int fd, const char* data, size_t size)
+{
+    while (size != 0) {
+        const ssize_t written = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (written <= 0)
+            return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool readAll(const int fd, char* data, size_t size)
+{
+    while (size != 0) {
+        const ssize_t received = ::recv(fd, data, size, 0);
+        if (received <= 0)
+            return false;
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+void appendU32(std::string& out, const u32 value)
+{
+    for (i32 i = 0; i < 4; ++i)
+        out += static_cast<char>(value >> (8 * i));
+}
+
+bool readU32(const int fd, u32& value)
+{
+    std::array<char, 4> bytes{};
+    if (!readAll(fd, bytes.data(), bytes.size()))
+        return false;
+    value = 0;
+    for (i32 i = 0; i < 4; ++i)
+        value |= static_cast<u32>(static_cast<u8>(bytes[i])) << (8 * i);
+    return true;
+}
+
+bool readRequest(const int fd, std::vector<std::string>& strings)
+{
+    u32 count = 0;
+    if (!readU32(fd, count) || count < 2 || maxStrings < count)
+        return false;
+    strings.resize(count);
+    for (std::string& string : strings) {
+        u32 length = 0;
+        if (!readU32(fd, length) || maxStringLength < length)
+            return false;
+        string.resize(length);
+        if (!readAll(fd, string.data(), length))
+            return false;
+    }
+    return true;
+}
+
+sockaddr_un socketAddress(const std::filesystem::path& socketPath)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string path = socketPath.string();
+    std::memcpy(address.sun_path, path.data(), std::min(path.size(), sizeof(address.sun_path) - 1));
+    return address;
+}
+
+} // namespace
+
+void Connection::send(const FrameKind kind, const std::string_view payload)
+{
+    std::string frame;
+    frame.reserve(5 + payload.size());
+    frame += static_cast<char>(kind);
+    appendU32(frame, static_cast<u32>(payload.size()));
+    frame += payload;
+    std::lock_guard lock(m_mutex);
+    writeAll(m_fd, frame.data(), frame.size());
+}
+
+OutputScope::OutputScope(Connection* connection)
+    : m_previous(t_connection)
+{
+    t_connection = connection;
+}
+
+OutputScope::~OutputScope()
+{
+    t_connection = m_previous;
+}
+
+Connection* OutputScope::current()
+{
+    return t_connection;
+}
+
+CompileServer::~CompileServer()
+{
+    if (m_listenFd != -1) {
+        close(m_listenFd);
+        std::filesystem::remove(m_socketPath);
+    }
+}
+
+std::vector<std::string> CompileServer::listen()
+{
+    const sockaddr_un address = socketAddress(m_socketPath);
+    if (sizeof(address.sun_path) <= m_socketPath.string().size())
+        return {"socket path " + m_socketPath.string() + " is too long"};
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenFd == -1)
+        return {std::string("could not create socket: ") + std::strerror(errno)};
+    std::error_code ec;
+    std::filesystem::remove(m_socketPath, ec);
+    if (bind(m_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(m_listenFd, SOMAXCONN) != 0)
+        return {"could not listen on " + m_socketPath.string() + ": " + std::strerror(errno)};
+    return {};
+}
+
+void CompileServer::serve()
+{
+    const StreamRedirect out(std::cout, FrameKind::Stdout);
+    const StreamRedirect err(std::cerr, FrameKind::Stderr);
+    // Every worker accepts its own connections, stop wakes all of them by shutting the socket down.
+    const auto worker = [this] {
+        while (!m_stopping) {
+            const int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd == -1) {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+                return;
+            }
+            handle(fd);
+        }
+    };
+    std::vector<std::jthread> workers;
+    for (size_t i = 1; i < m_workerCount; ++i)
+        workers.emplace_back(worker);
+    worker();
+}
+
+void CompileServer::stop()
+{
+    m_stopping = true;
+    if (m_listenFd != -1)
+        shutdown(m_listenFd, SHUT_RDWR);
+}
+
+void CompileServer::handle(const int fd)
+{
+    Connection connection(fd);
+    std::vector<std::string> strings;
+    if (readRequest(fd, strings)) {
+        std::filesystem::path workingDirectory = strings.front();
+        std::vector<std::string> args(std::make_move_iterator(strings.begin() + 1),
+                                      std::make_move_iterator(strings.end()));
+        i32 exitCode;
+        if (const std::optional<std::string> option = localOnlyOption(args)) {
+            connection.send(FrameKind::Stderr, *option + " is not supported by the compile server\n");
+            exitCode = static_cast<i32>(StateCode::InvalidCommandlineArgs);
+        }
+        else {
+            const OutputScope scope(&connection);
+            const CompilerDriver driver(std::move(args), std::move(workingDirectory));
+            exitCode = driver.runLocal();
+        }
+        std::string code;
+        appendU32(code, static_cast<u32>(exitCode));
+        connection.send(FrameKind::Exit, code);
+    }
+    close(fd);
+}
+
+std::optional<i32> forward(const std::filesystem::path& socketPath,
+                           const std::filesystem::path& workingDirectory,
+                           const std::vector<std::string>& args)
+{
+    if (localOnlyOption(args).has_value())
+        return std::nullopt;
+    const sockaddr_un address = socketAddress(socketPath);
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1)
+        return std::nullopt;
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return std::nullopt;
+    }
+    std::string request;
+    appendU32(request, static_cast<u32>(args.size() + 1));
+    appendU32(request, static_cast<u32>(workingDirectory.string().size()));
+    request += workingDirectory.string();
+    for (const std::string& arg : args) {
+        appendU32(request, static_cast<u32>(arg.size()));
+        request += arg;
+    }
+    // Once the request is out the server may already have written files, so a broken
+    // connection is reported instead of silently compiling a second time.
+    std::optional<i32> exitCode;
+    if (writeAll(fd, request.data(), request.size())) {
+        std::string payload;
+        while (true) {
+            char kind = 0;
+            u32 length = 0;
+            if (!readAll(fd, &kind, 1) || !readU32(fd, length))
+                break;
+            payload.resize(length);
+            if (!readAll(fd, payload.data(), length))
+                break;
+            if (static_cast<FrameKind>(kind) == FrameKind::Exit) {
+                u32 code = 0;
+                std::memcpy(&code, payload.data(), std::min<size_t>(length, sizeof(code)));
+                exitCode = static_cast<i32>(code);
+                break;
+            }
+            const int target = static_cast<FrameKind>(kind) == FrameKind::Stderr ? STDERR_FILENO : STDOUT_FILENO;
+            size_t offset = 0;
+            while (offset < payload.size()) {
+                const ssize_t written = write(target, payload.data() + offset, payload.size() - offset);
+                if (written <= 0)
+                    break;
+                offset += static_cast<size_t>(written);
+            }
+        }
+    }
+    close(fd);
+    if (!exitCode.has_value()) {
+        std::cerr << to_string(StateCode::Server) << '\n';
+        return static_cast<i32>(StateCode::Server);
+    }
+    return exitCode;
+}
+
+} // Server
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Server {
+
+// Wire format, all integers little endian.
+// Request:  u32 count, then count strings of u32 length and bytes: the working directory and argv.
+// Response: frames of u8 kind, u32 length and payload. Output frames carry text for stdout or
+// stderr, the final exit frame carries the i32 exit code.
+enum class FrameKind : u8 {
+    Exit, Stdout, Stderr
+};
+
+// One client connection. Frames may be sent from every thread compiling for the client.
+class Connection {
+    int m_fd;
+    std::mutex m_mutex;
+public:
+    explicit Connection(const int fd)
+        : m_fd(fd) {}
+
+    void send(FrameKind kind, std::string_view payload);
+};
+
+// While alive, std::cout and std::cerr written on this thread go to the connection
+// instead of the terminal of the server.
+class OutputScope {
+    Connection* m_previous;
+public:
+    explicit OutputScope(Connection* connection);
+    OutputScope(const OutputScope&) = delete;
+    OutputScope& operator=(const OutputScope&) = delete;
+    ~OutputScope();
+
+    [[nodiscard]] static Connection* current();
+};
+
+class CompileServer {
+    std::filesystem::path m_socketPath;
+    size_t m_workerCount;
+    int m_listenFd = -1;
+    std::atomic<bool> m_stopping = false;
+public:
+    explicit CompileServer(std::filesystem::path socketPath,
+                           const size_t workerCount = std::thread::hardware_concurrency())
+        : m_socketPath(std::move(socketPath)), m_workerCount(std::max<size_t>(workerCount, 1)) {}
+    CompileServer(const CompileServer&) = delete;
+    CompileServer& operator=(const CompileServer&) = delete;
+    ~CompileServer();
+
+    [[nodiscard]] std::vector<std::string> listen();
+    // Compiles requests on a fixed number of workers until stop is called. Connections beyond
+    // that wait in the listen backlog.
+    void serve();
+    void stop();
+private:
+    void handle(int fd);
+};
+
+// Runs the invocation on the server listening at socketPath and relays its output.
+// Returns nullopt when no server answers or the invocation uses --run or --time-trace, so the
+// caller can compile locally instead.
+[[nodiscard]] std::optional<i32> forward(const std::filesystem::path& socketPath,
+                                         const std::filesystem::path& workingDirectory,
+                                         const std::vector<std::string>& args);
+
+} // Server
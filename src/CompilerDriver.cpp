@@ -4,74 +4,401 @@
 #include "IrPrinter.hpp"
 #include "GenerateAsmTree.hpp"
 #include "CodeGenDriver.hpp"
+#include "CompileServer.hpp"
+#include "CompileCache.hpp"
+#include "Assembly.hpp"
+#include "ElfWriter.hpp"
+#include "IncrementalBuild.hpp"
+#include "ObjectEmitter.hpp"
+#include "TimeTrace.hpp"
+#include "Symbol.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <charconv>
 #include <iostream>
-#include <fstream>
 #include <filesystem>
 #include <format>
+#include <thread>
+
+#include <unistd.h>
 
 static void printIr(const Ir::Program& irProgram);
+static StateCode compileToObject(const std::string& inputFile, const std::filesystem::path& objectFile,
+                                 const std::optional<CompileCache>& cache, const Optimization::Options& optimization);
+static StateCode lookUpCache(FrontendDriver& frontend, const CompileCache& cache, std::string_view flags,
+                             const std::filesystem::path& outputFile, std::string& key);
+static StateCode compileIncrementally(FrontendDriver& frontend, const CompileCache& cache,
+                                      const std::string& argument, const Optimization::Options& optimization,
+                                      const std::filesystem::path& outputFile, const CodeGen::WorkStealingPool& pool);
+static void optimize(Ir::Program& irProgram, const Optimization::Options& optimization,
+                     const CodeGen::WorkStealingPool& pool);
+static std::string cacheFlags(const std::string& argument, const Optimization::Options& optimization);
+static std::filesystem::path cachedOutputFor(const std::string& inputFile, const std::string& argument);
+static void printCacheStats();
+static std::filesystem::path objectFileFor(const std::string& inputFile, size_t index, const Invocation& invocation);
+static bool parseJobs(std::string_view text, i32& jobs);
 static bool isCommandLineArgumentValid(const std::string& argument);
 static void printHelp();
 
 i32 CompilerDriver::run() const
 {
-    StateCode code = wrappedRun();
-    if (code == StateCode::Done)
+    if (m_args.size() == 3 && m_args[1] == "--server") {
+        Server::CompileServer server(m_args[2]);
+        if (const std::vector<std::string> errors = server.listen(); !errors.empty()) {
+            for (const std::string& error : errors)
+                std::cerr << "Error: " << error << '\n';
+            return static_cast<i32>(StateCode::Server);
+        }
+        server.serve();
         return 0;
+    }
+    if (const char* socketPath = std::getenv("CC_SERVER"); socketPath != nullptr && *socketPath != '\0')
+        if (const std::optional<i32> exitCode = Server::forward(socketPath, std::filesystem::current_path(), m_args))
+            return *exitCode;
+    return runLocal();
+}
+
+i32 CompilerDriver::runLocal() const
+{
+    i32 exitCode = 0;
+    StateCode code = wrappedRun(exitCode);
+    if (code == StateCode::Done)
+        return exitCode;
     std::cerr << to_string(code) << '\n' << std::flush;
     return static_cast<i32>(code);
 }
 
-StateCode CompilerDriver::wrappedRun() const
+StateCode CompilerDriver::wrappedRun(i32& exitCode) const
 {
-    std::string argument;
-    if (const StateCode errorCode = validateAndSetArg(argument); errorCode != StateCode::Continue)
+    Invocation invocation;
+    if (const StateCode errorCode = validateAndSetArg(invocation); errorCode != StateCode::Continue)
         return errorCode;
-    if (argument == "--help" || argument == "-h") {
+    if (invocation.argument == "--help" || invocation.argument == "-h") {
         printHelp();
         return StateCode::Done;
     }
-    const std::string inputFile = m_args.back();
+    if (invocation.argument == "--cache-stats") {
+        printCacheStats();
+        return StateCode::Done;
+    }
+    if (invocation.timeTraceFile.empty())
+        return compile(invocation, exitCode);
+    TimeTrace::start();
+    const StateCode result = compile(invocation, exitCode);
+    if (!TimeTrace::write(invocation.timeTraceFile)) {
+        std::cerr << "Error: Could not write time trace " << invocation.timeTraceFile << '\n';
+        return StateCode::TimeTraceWrite;
+    }
+    return result;
+}
+
+StateCode CompilerDriver::compile(const Invocation& invocation, i32& exitCode) const
+{
+    if (invocation.inputFiles.size() == 1 && invocation.outputFile.empty())
+        return compileSingle(invocation, exitCode);
+    return compileAndLink(invocation);
+}
+
+StateCode CompilerDriver::compileSingle(const Invocation& invocation, i32& exitCode)
+{
+    const std::string& argument = invocation.argument;
+    const std::string& inputFile = invocation.inputFiles.front();
+    const TimeTrace::Scope scope(inputFile);
+    Symbol::Table symbols;
+    const Symbol::Scope symbolScope(&symbols);
     FrontendDriver frontend(argument, inputFile);
+    std::optional<CompileCache> cache;
+    if (argument == "-c" || argument == "--assemble")
+        cache = CompileCache::fromEnvironment();
+    std::string cacheKey;
+    const std::filesystem::path outputFile = cachedOutputFor(inputFile, argument);
+    const CodeGen::WorkStealingPool pool(invocation.jobs);
+    if (cache.has_value()) {
+        const std::string flags = cacheFlags(argument, invocation.optimization);
+        if (const StateCode code = lookUpCache(frontend, *cache, flags, outputFile, cacheKey); code != StateCode::Continue)
+            return code;
+        const StateCode result = compileIncrementally(frontend, *cache, argument, invocation.optimization,
+                                                      outputFile, pool);
+        if (result == StateCode::Done)
+            cache->store(cacheKey, outputFile);
+        return result;
+    }
     auto [irProgramOptional, err] = frontend.run();
     if (!irProgramOptional.has_value())
         return err;
-    const Ir::Program irProgram = std::move(irProgramOptional.value());
+    Ir::Program irProgram = std::move(irProgramOptional.value());
     if (err != StateCode::Continue)
         return err;
+    optimize(irProgram, invocation.optimization, pool);
     if (argument == "--tacky")
         return StateCode::Done;
     if (argument == "--printTacky") {
         printIr(irProgram);
         return StateCode::Done;
     }
-    CodeGen::run(irProgram, argument, inputFile);
-    return StateCode::Done;
+    if (argument == "--run")
+        return CodeGen::runJit(irProgram, exitCode);
+    return CodeGen::run(irProgram, argument, inputFile, invocation.libraries, pool);
 }
 
-StateCode CompilerDriver::validateAndSetArg(std::string& argument) const
+StateCode CompilerDriver::compileAndLink(const Invocation& invocation) const
 {
-    if (m_args.size() < 2 || 3 < m_args.size()) {
-        std::cerr << "Usage: possible-argument <input_file>" << '\n';
-        return StateCode::NoInputFile;
+    const std::vector<std::string>& inputFiles = invocation.inputFiles;
+    const bool compileOnly = invocation.argument == "-c";
+    std::vector<std::filesystem::path> objectFiles;
+    for (size_t i = 0; i < inputFiles.size(); ++i)
+        objectFiles.push_back(objectFileFor(inputFiles[i], i, invocation));
+
+    // Every translation unit owns its frontend and backend state, so workers only share the index.
+    std::vector<StateCode> results(inputFiles.size(), StateCode::Done);
+    const std::optional<CompileCache> cache = CompileCache::fromEnvironment();
+    std::atomic<size_t> next = 0;
+    {
+        Server::Connection* connection = Server::OutputScope::current();
+        const auto worker = [&] {
+            const Server::OutputScope scope(connection);
+            for (size_t i = next++; i < inputFiles.size(); i = next++)
+                results[i] = compileToObject(inputFiles[i], objectFiles[i], cache, invocation.optimization);
+        };
+        const size_t threadCount = std::min(static_cast<size_t>(invocation.jobs), inputFiles.size());
+        std::vector<std::jthread> workers;
+        for (size_t i = 1; i < threadCount; ++i)
+            workers.emplace_back(worker);
+        worker();
     }
-    if (const std::filesystem::path m_inputFile(m_args.back()); !std::filesystem::exists(m_inputFile)) {
-        std::cerr << "File " << m_inputFile.string() << " not found" << '\n';
-        return StateCode::FileNotFound;
+    const auto failed = std::ranges::find_if(results, [](const StateCode code) {
+        return code != StateCode::Done;
+    });
+    StateCode result = failed == results.end() ? StateCode::Done : *failed;
+    if (compileOnly)
+        return result;
+    const std::string outputFile = invocation.outputFile.empty() ? resolve("a.out") : invocation.outputFile;
+    if (result == StateCode::Done && !CodeGen::linkObjects(objectFiles, outputFile, invocation.libraries))
+        result = StateCode::Link;
+    for (const std::filesystem::path& objectFile : objectFiles)
+        std::filesystem::remove(objectFile);
+    return result;
+}
+
+StateCode CompilerDriver::validateAndSetArg(Invocation& invocation) const
+{
+    for (size_t i = 1; i < m_args.size(); ++i) {
+        const std::string& arg = m_args[i];
+        if (arg == "-o" || arg == "-j") {
+            if (i + 1 == m_args.size()) {
+                std::cerr << "Missing value after " << arg << '\n';
+                return StateCode::InvalidCommandlineArgs;
+            }
+            const std::string& value = m_args[++i];
+            if (arg == "-o")
+                invocation.outputFile = resolve(value);
+            else if (!parseJobs(value, invocation.jobs))
+                return StateCode::InvalidCommandlineArgs;
+            continue;
+        }
+        if (arg.starts_with("-j")) {
+            if (!parseJobs(arg.substr(2), invocation.jobs))
+                return StateCode::InvalidCommandlineArgs;
+            continue;
+        }
+        if (!arg.starts_with("-")) {
+            invocation.inputFiles.push_back(resolve(arg));
+            continue;
+        }
+        if (arg.starts_with("-l")) {
+            invocation.libraries.push_back(arg);
+            continue;
+        }
+        if (arg == "-O" || arg == "-O0" || arg == "-O1" || arg == "-O2") {
+            invocation.optimization.level = arg == "-O" ? Optimization::OptLevel::O1
+                                                        : static_cast<Optimization::OptLevel>(arg[2] - '0');
+            continue;
+        }
+        if (arg.starts_with("--passes=")) {
+            std::vector<std::string> errors;
+            if (!Optimization::parsePasses(std::string_view(arg).substr(std::string_view("--passes=").size()),
+                                           invocation.optimization, errors)) {
+                for (const std::string& error : errors)
+                    std::cerr << error << '\n';
+                return StateCode::InvalidCommandlineArgs;
+            }
+            continue;
+        }
+        if (arg.starts_with("--time-trace=")) {
+            invocation.timeTraceFile = resolve(arg.substr(std::string_view("--time-trace=").size()));
+            if (invocation.timeTraceFile.empty()) {
+                std::cerr << "Missing file name after --time-trace=" << '\n';
+                return StateCode::InvalidCommandlineArgs;
+            }
+            continue;
+        }
+        if (!invocation.argument.empty()) {
+            std::cerr << "Only one argument is supported, got " << invocation.argument << " and " << arg << '\n';
+            return StateCode::InvalidCommandlineArgs;
+        }
+        invocation.argument = arg;
     }
-    if (m_args.size() == 3)
-        argument = m_args[1];
-    if (!isCommandLineArgumentValid(argument)) {
-        std::cerr << "Invalid argument: " << argument << '\n';
+    if (!isCommandLineArgumentValid(invocation.argument)) {
+        std::cerr << "Invalid argument: " << invocation.argument << '\n';
         printHelp();
         return StateCode::InvalidCommandlineArgs;
     }
+    if (invocation.argument == "--help" || invocation.argument == "-h" || invocation.argument == "--cache-stats")
+        return StateCode::Continue;
+    if (invocation.inputFiles.empty()) {
+        std::cerr << "Usage: possible-argument <input_file>... [-j N] [-o output]" << '\n';
+        return StateCode::NoInputFile;
+    }
+    for (const std::string& inputFile : invocation.inputFiles) {
+        if (!std::filesystem::exists(inputFile)) {
+            std::cerr << "File " << inputFile << " not found" << '\n';
+            return StateCode::FileNotFound;
+        }
+    }
+    const bool linking = 1 < invocation.inputFiles.size() || !invocation.outputFile.empty();
+    if (linking && !invocation.argument.empty() && invocation.argument != "-c") {
+        std::cerr << "Argument " << invocation.argument << " only supports a single input file" << '\n';
+        return StateCode::InvalidCommandlineArgs;
+    }
+    if (invocation.argument == "-c" && 1 < invocation.inputFiles.size() && !invocation.outputFile.empty()) {
+        std::cerr << "Cannot specify -o with -c and multiple input files" << '\n';
+        return StateCode::InvalidCommandlineArgs;
+    }
     return StateCode::Continue;
 }
 
-void printIr(const Ir::Program& irProgram)
+std::string CompilerDriver::resolve(const std::string& path) const
+{
+    if (m_workingDirectory.empty() || std::filesystem::path(path).is_absolute())
+        return path;
+    return (m_workingDirectory / path).string();
+}
+
+static StateCode compileToObject(const std::string& inputFile, const std::filesystem::path& objectFile,
+                                 const std::optional<CompileCache>& cache, const Optimization::Options& optimization)
+{
+    const TimeTrace::Scope scope(inputFile);
+    Symbol::Table symbols;
+    const Symbol::Scope symbolScope(&symbols);
+    FrontendDriver frontend("", inputFile);
+    std::string cacheKey;
+    const CodeGen::WorkStealingPool pool(1);
+    if (cache.has_value()) {
+        const std::string flags = cacheFlags("-c", optimization);
+        if (const StateCode code = lookUpCache(frontend, *cache, flags, objectFile, cacheKey); code != StateCode::Continue)
+            return code;
+        const StateCode result = compileIncrementally(frontend, *cache, "-c", optimization, objectFile, pool);
+        if (result == StateCode::Done)
+            cache->store(cacheKey, objectFile);
+        return result;
+    }
+    auto [irProgram, err] = frontend.run();
+    if (!irProgram.has_value())
+        return err;
+    optimize(*irProgram, optimization, pool);
+    if (!CodeGen::compileToObject(*irProgram, objectFile)) {
+        std::cerr << "Error: Could not write object file " << objectFile.string() << '\n';
+        return StateCode::ObjectFileWrite;
+    }
+    return StateCode::Done;
+}
+
+// Done if outputFile was filled from the cache, Continue on a miss with key set for storing the
+// output afterwards.
+static StateCode lookUpCache(FrontendDriver& frontend, const CompileCache& cache, const std::string_view flags,
+                             const std::filesystem::path& outputFile, std::string& key)
+{
+    if (const StateCode err = frontend.preprocess(); err != StateCode::Continue)
+        return err;
+    key = CompileCache::key(frontend.preprocessedSource(), flags);
+    if (cache.fetch(key, outputFile))
+        return StateCode::Done;
+    return StateCode::Continue;
+}
+
+// Used on a cache miss: functions that did not change since they were last cached are taken
+// from the cache, the rest of the translation unit is compiled.
+static StateCode compileIncrementally(FrontendDriver& frontend, const CompileCache& cache, const std::string& argument,
+                                      const Optimization::Options& optimization, const std::filesystem::path& outputFile,
+                                      const CodeGen::WorkStealingPool& pool)
+{
+    IncrementalBuild build(cache, argument, optimization);
+    CodeGen::Program program;
+    if (const StateCode err = build.run(frontend, program, pool); err != StateCode::Continue)
+        return err;
+    if (argument == "--assemble") {
+        if (!CodeGen::writeAsmProgram(outputFile, program, pool)) {
+            std::cerr << "Error: Could not open output file " << outputFile.string() << '\n';
+            return StateCode::AsmFileWrite;
+        }
+        return StateCode::Done;
+    }
+    if (!CodeGen::writeObjectFile(outputFile, CodeGen::emitObject(program, pool))) {
+        std::cerr << "Error: Could not write object file " << outputFile.string() << '\n';
+        return StateCode::ObjectFileWrite;
+    }
+    return StateCode::Done;
+}
+
+static void optimize(Ir::Program& irProgram, const Optimization::Options& optimization, const CodeGen::WorkStealingPool& pool)
+{
+    const Optimization::PassManager passManager = Optimization::PassManager::create(optimization);
+    passManager.run(irProgram, pool);
+}
+
+// The flags the cached output depends on.
+static std::string cacheFlags(const std::string& argument, const Optimization::Options& optimization)
+{
+    const std::string flags = optimization.flags();
+    return flags.empty() ? argument : argument + ' ' + flags;
+}
+
+static std::filesystem::path cachedOutputFor(const std::string& inputFile, const std::string& argument)
+{
+    if (argument == "--assemble")
+        return std::filesystem::path(inputFile).replace_extension(".s");
+    return inputFile.substr(0, inputFile.length() - 2) + ".o";
+}
+
+static void printCacheStats()
+{
+    const std::optional<CompileCache> cache = CompileCache::fromEnvironment();
+    if (!cache.has_value()) {
+        std::cout << "Compilation cache disabled, set CC_CACHE_DIR to enable it\n";
+        return;
+    }
+    const CompileCache::Stats stats = cache->stats();
+    std::cout << "Cache directory: " << cache->directory().string() << '\n'
+              << "Hits:            " << stats.hits << '\n'
+              << "Misses:          " << stats.misses << '\n'
+              << "Bytes saved:     " << stats.bytesSaved << '\n'
+              << "Size:            " << stats.size << " of " << cache->maxSize() << " bytes\n";
+}
+
+static std::filesystem::path objectFileFor(const std::string& inputFile, const size_t index, const Invocation& invocation)
+{
+    if (invocation.argument == "-c") {
+        if (!invocation.outputFile.empty())
+            return invocation.outputFile;
+        return inputFile.substr(0, inputFile.length() - 2) + ".o";
+    }
+    return std::filesystem::temp_directory_path() / (std::filesystem::path(inputFile).stem().string() + '-' +
+        std::to_string(getpid()) + '-' + std::to_string(index) + ".o");
+}
+
+static bool parseJobs(const std::string_view text, i32& jobs)
+{
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), jobs);
+    if (ec != std::errc() || end != text.data() + text.size() || jobs < 1) {
+        std::cerr << "Invalid job count: " << text << '\n';
+        return false;
+    }
+    return true;
+}
+
+static void printIr(const Ir::Program& irProgram)
 {
     Ir::IrPrinter printer;
     std::cout << printer.print(irProgram);
@@ -79,11 +406,9 @@ void printIr(const Ir::Program& irProgram)
 
 static bool isCommandLineArgumentValid(const std::string &argument)
 {
-    if (argument.starts_with("-l"))
-        return true;
     constexpr std::array validArguments = {"",  "--printAst","--help", "-h", "--version",
         "--lex", "--parse", "--tacky", "--codegen", "--printTacky", "--validate",
-        "--assemble", "--printAsm", "--printAsmAfter", "-c", "--printAstAfter", "--printTokens"};
+        "--assemble", "--printAsm", "--printAsmAfter", "-c", "--printAstAfter", "--printTokens", "--run", "--cache-stats"};
     return std::ranges::contains(validArguments, argument);
 }
 
@@ -100,6 +425,19 @@ static void printHelp()
         "--lex            - Stop after the lexing stage.\n"
         "--parse          - Stop after the parsing stage.\n"
         "--codegen        - Stop after the writing the assembly file.\n"
+        "--run            - Compile into memory and run main, exiting with its return value.\n"
+        "-o <file>        - Link all input files into <file>, a.out if several inputs are given without it.\n"
+        "-O0, -O1, -O2    - Optimization level of the intermediate representation, -O0 by default.\n"
+        "--passes=<list>  - Run only the comma separated optimization passes in <list>.\n"
+        "-l<library>      - Link against <library>, may be given several times.\n"
+        "-j <N>           - Compile up to N translation units, or the functions of a single one, in parallel.\n"
+        "--server <path>  - Serve compile requests on the Unix socket <path>.\n"
+        "                   With CC_SERVER=<path> set, CC forwards its arguments to that server.\n"
+        "--time-trace=<file> - Write a Chrome trace of the time, allocations and peak memory of each\n"
+        "                   stage and function to <file>, viewable in chrome://tracing or Perfetto.\n"
+        "--cache-stats    - Print hits, misses and bytes saved by the compilation cache.\n"
+        "                   With CC_CACHE_DIR=<dir> set, object and assembly output is cached in <dir>,\n"
+        "                   bounded by CC_CACHE_SIZE bytes. Unchanged functions are reused on a miss.\n"
     ;
     std::cout << helpText << '\n';
 }
\ No newline at end of file
@@ -1,24 +1,46 @@
 #pragma once
 
 #include "Parser.hpp"
+#include "PassManager.hpp"
 #include "StateCode.hpp"
 
 #include <filesystem>
 #include <string>
 #include <vector>
 
+// The command line: at most one argument selecting what to do, plus any number of options.
+struct Invocation {
+    std::string argument;
+    std::vector<std::string> inputFiles;
+    std::vector<std::string> libraries;
+    std::string outputFile;
+    std::string timeTraceFile;
+    Optimization::Options optimization;
+    i32 jobs = 1;
+};
+
 class CompilerDriver {
     std::vector<std::string> m_args;
+    std::filesystem::path m_workingDirectory;
 public:
     CompilerDriver() = delete;
     CompilerDriver(const CompilerDriver& other) = delete;
     CompilerDriver(const int argc, char *argv[])
         : m_args(std::vector<std::string>(argv, argv + argc)) {}
+    // Relative paths are resolved against workingDirectory instead of the process directory.
+    CompilerDriver(std::vector<std::string> args, std::filesystem::path workingDirectory)
+        : m_args(std::move(args)), m_workingDirectory(std::move(workingDirectory)) {}
 
-    StateCode validateAndSetArg(std::string& argument) const;
+    StateCode validateAndSetArg(Invocation& invocation) const;
+    // Serves or forwards to a compile server when asked to, otherwise compiles in this process.
     [[nodiscard]] i32 run() const;
+    [[nodiscard]] i32 runLocal() const;
 private:
-    [[nodiscard]] StateCode wrappedRun() const;
+    [[nodiscard]] std::string resolve(const std::string& path) const;
+    [[nodiscard]] StateCode wrappedRun(i32& exitCode) const;
+    [[nodiscard]] StateCode compile(const Invocation& invocation, i32& exitCode) const;
+    [[nodiscard]] static StateCode compileSingle(const Invocation& invocation, i32& exitCode);
+    [[nodiscard]] StateCode compileAndLink(const Invocation& invocation) const;
     StateCode writeAssmFile(const std::string& inputFile, const std::string& output, const std::string& argument);
 };
 
@@ -0,0 +1,89 @@
+#include "ASTArena.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace Parsing {
+
+namespace {
+thread_local ASTArena* s_activeArena = nullptr;
+
+enum class Origin : u64 {
+    Heap, Arena
+};
+constexpr size_t headerSize = sizeof(Origin);
+constexpr size_t nodeAlignment = alignof(u64);
+}
+
+void* ASTArena::allocate(const size_t size, const size_t alignment)
+{
+    auto cursor = reinterpret_cast<uintptr_t>(m_cursor);
+    uintptr_t aligned = (cursor + alignment - 1) & ~(alignment - 1);
+    if (m_cursor == nullptr || m_end < reinterpret_cast<std::byte*>(aligned + size)) {
+        newBlock(size + alignment);
+        cursor = reinterpret_cast<uintptr_t>(m_cursor);
+        aligned = (cursor + alignment - 1) & ~(alignment - 1);
+    }
+    m_cursor = reinterpret_cast<std::byte*>(aligned + size);
+    m_bytesAllocated += size;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void ASTArena::release()
+{
+    m_blocks.clear();
+    m_cursor = nullptr;
+    m_end = nullptr;
+    m_bytesAllocated = 0;
+}
+
+void ASTArena::newBlock(const size_t minSize)
+{
+    const size_t size = std::max(s_blockSize, minSize);
+    m_blocks.emplace_back(new std::byte[size]);
+    m_cursor = m_blocks.back().get();
+    m_end = m_cursor + size;
+}
+
+ArenaScope::ArenaScope(ASTArena& arena)
+    : m_previous(s_activeArena)
+{
+    s_activeArena = &arena;
+}
+
+ArenaScope::~ArenaScope()
+{
+    s_activeArena = m_previous;
+}
+
+ASTArena* activeArena()
+{
+    return s_activeArena;
+}
+
+void* ArenaAllocated::operator new(const size_t size)
+{
+    std::byte* memory;
+    Origin origin;
+    if (s_activeArena != nullptr) {
+        memory = static_cast<std::byte*>(s_activeArena->allocate(headerSize + size, nodeAlignment));
+        origin = Origin::Arena;
+    }
+    else {
+        memory = static_cast<std::byte*>(::operator new(headerSize + size));
+        origin = Origin::Heap;
+    }
+    *reinterpret_cast<Origin*>(memory) = origin;
+    return memory + headerSize;
+}
+
+void ArenaAllocated::operator delete(void* ptr)
+{
+    if (ptr == nullptr)
+        return;
+    std::byte* memory = static_cast<std::byte*>(ptr) - headerSize;
+    if (*reinterpret_cast<Origin*>(memory) == Origin::Heap)
+        ::operator delete(memory);
+}
+
+} // Parsing
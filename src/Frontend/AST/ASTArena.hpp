@@ -0,0 +1,89 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Parsing {
+
+// Bump allocator backing every AST node created while an ArenaScope is active, together
+// with the lists and strings inside them. Nothing in such a tree owns heap memory, so the
+// tree is dropped by release() without running a single node destructor.
+class ASTArena {
+    static constexpr size_t s_blockSize = 64 * 1024;
+    std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+    std::byte* m_cursor = nullptr;
+    std::byte* m_end = nullptr;
+    size_t m_bytesAllocated = 0;
+public:
+    ASTArena() = default;
+    ASTArena(const ASTArena& other) = delete;
+    ASTArena& operator=(const ASTArena& other) = delete;
+
+    [[nodiscard]] void* allocate(size_t size, size_t alignment);
+    void release();
+    [[nodiscard]] size_t bytesAllocated() const { return m_bytesAllocated; }
+    [[nodiscard]] size_t blockCount() const { return m_blocks.size(); }
+private:
+    void newBlock(size_t minSize);
+};
+
+class ArenaScope {
+    ASTArena* m_previous;
+public:
+    explicit ArenaScope(ASTArena& arena);
+    ~ArenaScope();
+    ArenaScope(const ArenaScope& other) = delete;
+    ArenaScope& operator=(const ArenaScope& other) = delete;
+};
+
+[[nodiscard]] ASTArena* activeArena();
+
+struct ArenaAllocated {
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr);
+};
+
+// Container allocator taking its memory from the arena active at construction. Freeing arena
+// memory is a no-op, outside any scope it falls back to the heap.
+template<typename T>
+class ArenaAllocator {
+    ASTArena* m_arena = activeArena();
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() = default;
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : m_arena(other.arena()) {}
+
+    [[nodiscard]] T* allocate(const size_t count)
+    {
+        if (m_arena == nullptr)
+            return static_cast<T*>(::operator new(count * sizeof(T)));
+        return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* ptr, size_t) noexcept
+    {
+        if (m_arena == nullptr)
+            ::operator delete(ptr);
+    }
+    [[nodiscard]] ASTArena* arena() const noexcept { return m_arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return m_arena == other.arena(); }
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+} // Parsing
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ASTArena.hpp"
 #include "ASTVisitor.hpp"
 #include "ShortTypes.hpp"
 #include "Types/Type.hpp"
@@ -8,7 +9,7 @@
 
 namespace Parsing {
 
-struct ASTNode {
+struct ASTNode : ArenaAllocated {
     const i64 location = 0;
     explicit ASTNode(const i64 location)
         : location(location) {}
@@ -19,13 +20,14 @@ struct TypeBase {
         Var, Func, Pointer, Array
     };
     const Kind kind;
-    Type type;
+    const Type type;
 
     virtual ~TypeBase() = default;
-    virtual void accept(ASTVisitor& visitor) = 0;
     virtual void accept(ConstASTVisitor& visitor) const = 0;
 
     TypeBase() = delete;
+    TypeBase(const TypeBase& other) = delete;
+    TypeBase& operator=(const TypeBase& other) = delete;
 protected:
     explicit TypeBase(const Type type, const Kind kind)
         : kind(kind), type(type) {}
@@ -73,7 +75,7 @@ struct Expr : ASTNode {
         Dereference, AddrOf, Subscript, SizeOfExpr, SizeOfType
     };
     const Kind kind;
-    std::unique_ptr<TypeBase> type = nullptr;
+    const TypeBase* type = nullptr;
 
     virtual ~Expr() = default;
 
@@ -82,10 +84,10 @@ struct Expr : ASTNode {
 
     Expr() = delete;
 protected:
-    Expr(const i64 location, const Kind kind, std::unique_ptr<TypeBase>&& type)
-        : ASTNode(location), kind(kind), type(std::move(type)) {}
-    Expr(const Kind kind, std::unique_ptr<TypeBase>&& type)
-        : ASTNode(0l), kind(kind), type(std::move(type)) {}
+    Expr(const i64 location, const Kind kind, const TypeBase* type)
+        : ASTNode(location), kind(kind), type(type) {}
+    Expr(const Kind kind, const TypeBase* type)
+        : ASTNode(0l), kind(kind), type(type) {}
     Expr(const i64 location, const Kind kind)
         : ASTNode(location), kind(kind) {}
     explicit Expr(const Kind kind)
@@ -138,7 +140,7 @@ protected:
         : ASTNode(loc), kind(kind), storage(storageClass) {}
 };
 
-struct Initializer {
+struct Initializer : ArenaAllocated {
     enum class Kind {
         Single, Compound, Zero, String
     };
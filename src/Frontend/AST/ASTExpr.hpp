@@ -3,6 +3,7 @@
 #include "ASTVisitor.hpp"
 #include "ASTBase.hpp"
 #include "ShortTypes.hpp"
+#include "Symbol.hpp"
 
 #include <memory>
 #include <string>
@@ -10,7 +11,7 @@
 #include <variant>
 #include <vector>
 
-#include "ASTTypes.hpp"
+#include "TypeContext.hpp"
 
 namespace Parsing {
 
@@ -18,12 +19,12 @@ struct ConstExpr final : Expr {
     std::variant<char, i8, u8, i32, i64, u32, u64, double> value;
 
     template<typename T>
-    ConstExpr(T&& value, std::unique_ptr<TypeBase> varType) noexcept
-        : Expr(Kind::Constant, std::move(varType)), value(std::forward<T>(value)) {}
+    ConstExpr(T&& value, const TypeBase* varType) noexcept
+        : Expr(Kind::Constant, varType), value(std::forward<T>(value)) {}
 
     template<typename T>
-    ConstExpr(const i64 location, T&& value, std::unique_ptr<TypeBase> varType) noexcept
-        : Expr(location, Kind::Constant, std::move(varType)), value(std::forward<T>(value)) {}
+    ConstExpr(const i64 location, T&& value, const TypeBase* varType) noexcept
+        : Expr(location, Kind::Constant, varType), value(std::forward<T>(value)) {}
 
     template<typename TargetType>
     TargetType getValue() const
@@ -51,12 +52,12 @@ struct ConstExpr final : Expr {
 };
 
 struct StringExpr final : Expr {
-    const std::string value;
+    const ArenaString value;
 
-    StringExpr(const i64 location, std::string&& value) noexcept
-        : Expr(location, Kind::String), value(std::move(value)) {}
-    StringExpr(const i64 location, std::string&& value, std::unique_ptr<TypeBase> varType) noexcept
-        : Expr(location, Kind::String, std::move(varType)), value(std::move(value)) {}
+    StringExpr(const i64 location, const std::string_view value) noexcept
+        : Expr(location, Kind::String), value(value) {}
+    StringExpr(const i64 location, const std::string_view value, const TypeBase* varType) noexcept
+        : Expr(location, Kind::String, varType), value(value) {}
 
     void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
@@ -67,14 +68,14 @@ struct StringExpr final : Expr {
 };
 
 struct VarExpr final : Expr {
-    std::string name;
+    Symbol name;
     ReferingTo referingTo = ReferingTo::Local;
 
-    explicit VarExpr(std::string name) noexcept
-        : Expr(Kind::Var), name(std::move(name)) {}
+    explicit VarExpr(const Symbol name) noexcept
+        : Expr(Kind::Var), name(name) {}
 
-    VarExpr(const i64 loc, std::string name) noexcept
-        : Expr(loc, Kind::Var), name(std::move(name)) {}
+    VarExpr(const i64 loc, const Symbol name) noexcept
+        : Expr(loc, Kind::Var), name(name) {}
 
     void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
@@ -87,11 +88,11 @@ struct VarExpr final : Expr {
 struct CastExpr final : Expr {
     std::unique_ptr<Expr> innerExpr;
 
-    CastExpr(std::unique_ptr<TypeBase>&& type, std::unique_ptr<Expr>&& expr) noexcept
-        : Expr(Kind::Cast, std::move(type)), innerExpr(std::move(expr)) {}
+    CastExpr(const TypeBase* type, std::unique_ptr<Expr>&& expr) noexcept
+        : Expr(Kind::Cast, type), innerExpr(std::move(expr)) {}
 
-    CastExpr(const i64 loc, std::unique_ptr<TypeBase>&& type, std::unique_ptr<Expr>&& expr) noexcept
-        : Expr(loc, Kind::Cast, std::move(type)), innerExpr(std::move(expr)) {}
+    CastExpr(const i64 loc, const TypeBase* type, std::unique_ptr<Expr>&& expr) noexcept
+        : Expr(loc, Kind::Cast, type), innerExpr(std::move(expr)) {}
 
     void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
@@ -204,14 +205,14 @@ struct TernaryExpr final : Expr {
 };
 
 struct FuncCallExpr final : Expr {
-    std::string name;
-    std::vector<std::unique_ptr<Expr>> args;
+    Symbol name;
+    ArenaVector<std::unique_ptr<Expr>> args;
 
-    FuncCallExpr(std::string identifier, std::vector<std::unique_ptr<Expr>> args)
-        : Expr(Kind::FunctionCall), name(std::move(identifier)), args(std::move(args)) {}
+    FuncCallExpr(const Symbol identifier, ArenaVector<std::unique_ptr<Expr>> args)
+        : Expr(Kind::FunctionCall), name(identifier), args(std::move(args)) {}
 
-    FuncCallExpr(const i64 loc, std::string identifier, std::vector<std::unique_ptr<Expr>> args)
-        : Expr(loc, Kind::FunctionCall), name(std::move(identifier)), args(std::move(args)) {}
+    FuncCallExpr(const i64 loc, const Symbol identifier, ArenaVector<std::unique_ptr<Expr>> args)
+        : Expr(loc, Kind::FunctionCall), name(identifier), args(std::move(args)) {}
 
     void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
@@ -277,7 +278,7 @@ struct SizeOfExprExpr final : Expr {
     std::unique_ptr<Expr> innerExpr;
 
     explicit SizeOfExprExpr(const i64 loc, std::unique_ptr<Expr>&& innerExpr)
-        : Expr(loc, Kind::SizeOfExpr, std::make_unique<VarType>(Type::U64)), innerExpr(std::move(innerExpr)) {}
+        : Expr(loc, Kind::SizeOfExpr, varType(Type::U64)), innerExpr(std::move(innerExpr)) {}
 
     void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
@@ -288,10 +289,10 @@ struct SizeOfExprExpr final : Expr {
 };
 
 struct SizeOfTypeExpr final : Expr {
-    std::unique_ptr<TypeBase> sizeType;
+    const TypeBase* sizeType;
 
-    explicit SizeOfTypeExpr(const i64 loc, std::unique_ptr<TypeBase>&& sizeType)
-        : Expr(loc, Kind::SizeOfType, std::make_unique<VarType>(Type::U64)), sizeType(std::move(sizeType)) {}
+    explicit SizeOfTypeExpr(const i64 loc, const TypeBase* sizeType)
+        : Expr(loc, Kind::SizeOfType, varType(Type::U64)), sizeType(sizeType) {}
 
     void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
@@ -12,15 +12,15 @@
 namespace Parsing {
 
 struct VarDecl final : Declaration {
-    std::string name;
+    Symbol name;
     std::unique_ptr<Initializer> init = nullptr;
-    std::unique_ptr<TypeBase> type;
+    const TypeBase* type;
 
-    VarDecl(const StorageClass storageClass, std::string name, std::unique_ptr<TypeBase> type)
-        : Declaration(Kind::VarDecl, storageClass), name(std::move(name)), type(std::move(type)) {}
+    VarDecl(const StorageClass storageClass, const Symbol name, const TypeBase* type)
+        : Declaration(Kind::VarDecl, storageClass), name(name), type(type) {}
 
-    VarDecl(const i64 loc, const StorageClass storageClass, std::string name, std::unique_ptr<TypeBase> type)
-        : Declaration(loc, Kind::VarDecl, storageClass), name(std::move(name)), type(std::move(type)) {}
+    VarDecl(const i64 loc, const StorageClass storageClass, const Symbol name, const TypeBase* type)
+        : Declaration(loc, Kind::VarDecl, storageClass), name(name), type(type) {}
 
     void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
@@ -99,37 +99,37 @@ struct DeclBlockItem final : BlockItem {
     DeclBlockItem() = delete;
 };
 
-struct Block {
-    std::vector<std::unique_ptr<BlockItem>> body;
+struct Block : ArenaAllocated {
+    ArenaVector<std::unique_ptr<BlockItem>> body;
 
     void accept(ASTVisitor& visitor) { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const { visitor.visit(*this); }
 };
 
 struct FuncDeclaration final : Declaration {
-    std::string name;
-    std::vector<std::string> params;
+    Symbol name;
+    ArenaVector<Symbol> params;
     std::unique_ptr<Block> body = nullptr;
-    std::unique_ptr<TypeBase> type = nullptr;
+    const TypeBase* type = nullptr;
 
     FuncDeclaration(const StorageClass storageClass,
-            std::string name,
-            std::vector<std::string>&& ps,
-            std::unique_ptr<TypeBase>&& t)
+            const Symbol name,
+            ArenaVector<Symbol>&& ps,
+            const TypeBase* t)
         : Declaration(Kind::FuncDecl, storageClass),
-            name(std::move(name)),
+            name(name),
             params(std::move(ps)),
-            type(std::move(t)){}
+            type(t){}
 
     FuncDeclaration(const i64 loc,
             const StorageClass storageClass,
-            std::string name,
-            std::vector<std::string>&& ps,
-            std::unique_ptr<TypeBase>&& t)
+            const Symbol name,
+            ArenaVector<Symbol>&& ps,
+            const TypeBase* t)
     : Declaration(loc, Kind::FuncDecl, storageClass),
-            name(std::move(name)),
+            name(name),
             params(std::move(ps)),
-            type(std::move(t)){}
+            type(t){}
 
     void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
@@ -207,13 +207,13 @@ struct IfStmt final : Stmt {
 };
 
 struct GotoStmt final : Stmt {
-    std::string identifier;
+    ArenaString identifier;
 
-    explicit GotoStmt(std::string iden)
-        : Stmt(Kind::Goto), identifier(std::move(iden)) {}
+    explicit GotoStmt(const std::string_view iden)
+        : Stmt(Kind::Goto), identifier(iden) {}
 
-    GotoStmt(const i64 loc, std::string iden)
-       : Stmt(loc, Kind::Goto), identifier(std::move(iden)) {}
+    GotoStmt(const i64 loc, const std::string_view iden)
+       : Stmt(loc, Kind::Goto), identifier(iden) {}
 
     void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
@@ -241,7 +241,7 @@ struct CompoundStmt final : Stmt {
 };
 
 struct BreakStmt final : Stmt {
-    std::string identifier;
+    ArenaString identifier;
 
     explicit BreakStmt()
         : Stmt(Kind::Break) {}
@@ -256,7 +256,7 @@ struct BreakStmt final : Stmt {
 };
 
 struct ContinueStmt final : Stmt {
-    std::string identifier;
+    ArenaString identifier;
 
     explicit ContinueStmt()
         : Stmt(Kind::Continue) {}
@@ -271,14 +271,14 @@ struct ContinueStmt final : Stmt {
 };
 
 struct LabelStmt final : Stmt {
-    std::string identifier;
+    ArenaString identifier;
     std::unique_ptr<Stmt> stmt;
 
-    explicit LabelStmt(std::string name, std::unique_ptr<Stmt> stmt)
-        : Stmt(Kind::Label), identifier(std::move(name)), stmt(std::move(stmt)) {}
+    explicit LabelStmt(const std::string_view name, std::unique_ptr<Stmt> stmt)
+        : Stmt(Kind::Label), identifier(name), stmt(std::move(stmt)) {}
 
-    LabelStmt(const i64 loc, std::string name, std::unique_ptr<Stmt> stmt)
-        : Stmt(loc, Kind::Label), identifier(std::move(name)), stmt(std::move(stmt)) {}
+    LabelStmt(const i64 loc, const std::string_view name, std::unique_ptr<Stmt> stmt)
+        : Stmt(loc, Kind::Label), identifier(name), stmt(std::move(stmt)) {}
 
     void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
@@ -289,7 +289,7 @@ struct LabelStmt final : Stmt {
 };
 
 struct CaseStmt final : Stmt {
-    std::string identifier;
+    ArenaString identifier;
     std::unique_ptr<Expr> condition;
     std::unique_ptr<Stmt> body;
 
@@ -308,7 +308,7 @@ struct CaseStmt final : Stmt {
 };
 
 struct DefaultStmt final : Stmt {
-    std::string identifier;
+    ArenaString identifier;
     std::unique_ptr<Stmt> body;
 
     explicit DefaultStmt(std::unique_ptr<Stmt> body)
@@ -328,7 +328,7 @@ struct DefaultStmt final : Stmt {
 struct WhileStmt final : Stmt {
     std::unique_ptr<Expr> condition;
     std::unique_ptr<Stmt> body;
-    std::string identifier;
+    ArenaString identifier;
 
     WhileStmt(std::unique_ptr<Expr> condition, std::unique_ptr<Stmt> body)
         : Stmt(Kind::While), condition(std::move(condition)), body(std::move(body)) {}
@@ -347,7 +347,7 @@ struct WhileStmt final : Stmt {
 struct DoWhileStmt final : Stmt {
     std::unique_ptr<Stmt> body;
     std::unique_ptr<Expr> condition;
-    std::string identifier;
+    ArenaString identifier;
 
     DoWhileStmt(std::unique_ptr<Stmt> body, std::unique_ptr<Expr> condition)
         : Stmt(Kind::DoWhile), body(std::move(body)), condition(std::move(condition)) {}
@@ -368,7 +368,7 @@ struct ForStmt final : Stmt {
     std::unique_ptr<Expr> condition = nullptr;
     std::unique_ptr<Expr> post = nullptr;
     std::unique_ptr<Stmt> body;
-    std::string identifier;
+    ArenaString identifier;
 
     explicit ForStmt(std::unique_ptr<Stmt> body)
         : Stmt(Kind::For), body(std::move(body)) {}
@@ -385,10 +385,10 @@ struct ForStmt final : Stmt {
 };
 
 struct SwitchStmt final : Stmt {
-    std::string identifier;
+    ArenaString identifier;
     std::unique_ptr<Expr> condition;
     std::unique_ptr<Stmt> body;
-    std::vector<std::variant<i32, i64, u32, u64>> cases;
+    ArenaVector<std::variant<i32, i64, u32, u64>> cases;
 
     bool hasDefault = false;
 
@@ -419,9 +419,8 @@ struct NullStmt final : Stmt {
     static bool classOf(const Stmt* stmt) { return stmt->kind == Kind::Null; }
 };
 
-struct Program {
-    std::vector<std::unique_ptr<Declaration>> declarations;
-    ~Program() = default;
+struct Program : ArenaAllocated {
+    ArenaVector<std::unique_ptr<Declaration>> declarations;
     void accept(ASTVisitor& visitor) { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const { visitor.visit(*this); }
 };
@@ -439,12 +438,12 @@ struct SingleInitializer final : Initializer {
 };
 
 struct CompoundInitializer final : Initializer {
-    std::vector<std::unique_ptr<Initializer>> initializers;
+    ArenaVector<std::unique_ptr<Initializer>> initializers;
 
     void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
 
-    explicit CompoundInitializer(std::vector<std::unique_ptr<Initializer>>&& initializers)
+    explicit CompoundInitializer(ArenaVector<std::unique_ptr<Initializer>>&& initializers)
         : Initializer(Kind::Compound), initializers(std::move(initializers)) {}
 
     static bool classOf(const Initializer* initializer) { return initializer->kind == Kind::Compound; }
@@ -463,11 +462,11 @@ struct ZeroInitializer final : Initializer {
 };
 
 struct StringInitializer final : Initializer {
-    const std::string value;
+    const ArenaString value;
     const bool nullTerminated;
     const i64 location;
 
-    explicit StringInitializer(const std::string& value, const  bool nullTerminated, const i64 location)
+    explicit StringInitializer(const std::string_view value, const  bool nullTerminated, const i64 location)
         : Initializer(Kind::String), value(value), nullTerminated(nullTerminated), location(location) {}
 
     void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
@@ -3,57 +3,55 @@
 #include "ASTVisitor.hpp"
 #include "ASTBase.hpp"
 
-#include <memory>
 #include <vector>
 
 namespace Parsing {
 
+// Type nodes are immutable and interned by TypeContext, so two types are equal exactly
+// when they are the same object. Construct them through TypeContext only.
+
 struct VarType final : TypeBase {
     explicit VarType(const Type type)
         : TypeBase(type, Kind::Var) {}
 
-    void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
 
     static bool classOf(const TypeBase* typeBase) { return typeBase->kind == Kind::Var; }
 };
 
 struct FuncType final : TypeBase {
-    std::vector<std::unique_ptr<TypeBase>> params;
-    std::unique_ptr<TypeBase> returnType;
+    const std::vector<const TypeBase*> params;
+    const TypeBase* const returnType;
 
-    explicit FuncType(std::unique_ptr<TypeBase>&& rT, std::vector<std::unique_ptr<TypeBase>>&& params)
-        : TypeBase(Type::Function, Kind::Func), params(std::move(params)), returnType(std::move(rT)) {}
+    FuncType(const TypeBase* rT, std::vector<const TypeBase*>&& params)
+        : TypeBase(Type::Function, Kind::Func), params(std::move(params)), returnType(rT) {}
 
-    void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
 
     static bool classOf(const TypeBase* typeBase) { return typeBase->kind == Kind::Func; }
 };
 
 struct PointerType final : TypeBase {
-    std::unique_ptr<TypeBase> referenced;
+    const TypeBase* const referenced;
 
-    explicit PointerType(std::unique_ptr<TypeBase>&& r)
-        : TypeBase(Type::Pointer, Kind::Pointer), referenced(std::move(r)) {}
+    explicit PointerType(const TypeBase* r)
+        : TypeBase(Type::Pointer, Kind::Pointer), referenced(r) {}
 
-    void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
 
     static bool classOf(const TypeBase* typeBase) { return typeBase->kind == Kind::Pointer; }
 };
 
 struct ArrayType final : TypeBase {
-    std::unique_ptr<TypeBase> elementType;
-    i64 size;
+    const TypeBase* const elementType;
+    const i64 size;
 
-    explicit ArrayType(std::unique_ptr<TypeBase>&& elementType, const i64 size)
-        : TypeBase(Type::Array, Kind::Array), elementType(std::move(elementType)), size(size) {}
+    ArrayType(const TypeBase* elementType, const i64 size)
+        : TypeBase(Type::Array, Kind::Array), elementType(elementType), size(size) {}
 
-    void accept(ASTVisitor& visitor) override { visitor.visit(*this); }
     void accept(ConstASTVisitor& visitor) const override { visitor.visit(*this); }
 
     static bool classOf(const TypeBase* typeBase) { return typeBase->kind == Kind::Array; }
 };
 
-} // Parsing
\ No newline at end of file
+} // Parsing
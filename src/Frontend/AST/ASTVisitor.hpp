@@ -16,12 +16,6 @@ public:
 
     virtual void visit(Block&) = 0;
 
-    // Type
-    virtual void visit(VarType&) = 0;
-    virtual void visit(FuncType&) = 0;
-    virtual void visit(PointerType&) = 0;
-    virtual void visit(ArrayType&) = 0;
-
     // Initializer
     virtual void visit(SingleInitializer&) = 0;
     virtual void visit(CompoundInitializer&) = 0;
@@ -0,0 +1,110 @@
+#include "TypeContext.hpp"
+
+#include <functional>
+#include <mutex>
+
+namespace Parsing {
+
+namespace {
+thread_local TypeContext* s_activeContext = nullptr;
+
+size_t combine(const size_t seed, const size_t value)
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+} // namespace
+
+size_t TypeContext::ArrayKeyHash::operator()(const ArrayKey& key) const noexcept
+{
+    return combine(std::hash<const TypeBase*>{}(key.elementType), std::hash<i64>{}(key.size));
+}
+
+size_t TypeContext::FuncKeyHash::operator()(const std::vector<const TypeBase*>& key) const noexcept
+{
+    size_t seed = key.size();
+    for (const TypeBase* type : key)
+        seed = combine(seed, std::hash<const TypeBase*>{}(type));
+    return seed;
+}
+
+TypeContext& TypeContext::active()
+{
+    if (s_activeContext != nullptr)
+        return *s_activeContext;
+    static TypeContext context;
+    return context;
+}
+
+const VarType* TypeContext::var(const Type type)
+{
+    static const std::deque<VarType> vars = [] {
+        std::deque<VarType> result;
+        for (u16 type = 0; type <= static_cast<u16>(Type::Void); ++type)
+            result.emplace_back(static_cast<Type>(type));
+        return result;
+    }();
+    return &vars[static_cast<u16>(type)];
+}
+
+const PointerType* TypeContext::pointer(const TypeBase* referenced)
+{
+    {
+        std::shared_lock lock(m_mutex);
+        if (const auto it = m_pointerIds.find(referenced); it != m_pointerIds.end())
+            return it->second;
+    }
+    std::unique_lock lock(m_mutex);
+    if (const auto it = m_pointerIds.find(referenced); it != m_pointerIds.end())
+        return it->second;
+    const PointerType* pointerType = &m_pointers.emplace_back(referenced);
+    m_pointerIds.emplace(referenced, pointerType);
+    return pointerType;
+}
+
+const ArrayType* TypeContext::array(const TypeBase* elementType, const i64 size)
+{
+    const ArrayKey key{elementType, size};
+    {
+        std::shared_lock lock(m_mutex);
+        if (const auto it = m_arrayIds.find(key); it != m_arrayIds.end())
+            return it->second;
+    }
+    std::unique_lock lock(m_mutex);
+    if (const auto it = m_arrayIds.find(key); it != m_arrayIds.end())
+        return it->second;
+    const ArrayType* arrayType = &m_arrays.emplace_back(elementType, size);
+    m_arrayIds.emplace(key, arrayType);
+    return arrayType;
+}
+
+const FuncType* TypeContext::function(const TypeBase* returnType, std::vector<const TypeBase*> params)
+{
+    std::vector<const TypeBase*> key;
+    key.reserve(params.size() + 1);
+    key.push_back(returnType);
+    key.insert(key.end(), params.begin(), params.end());
+    {
+        std::shared_lock lock(m_mutex);
+        if (const auto it = m_funcIds.find(key); it != m_funcIds.end())
+            return it->second;
+    }
+    std::unique_lock lock(m_mutex);
+    if (const auto it = m_funcIds.find(key); it != m_funcIds.end())
+        return it->second;
+    const FuncType* funcType = &m_funcs.emplace_back(returnType, std::move(params));
+    m_funcIds.emplace(std::move(key), funcType);
+    return funcType;
+}
+
+TypeScope::TypeScope(TypeContext& context)
+    : m_previous(s_activeContext)
+{
+    s_activeContext = &context;
+}
+
+TypeScope::~TypeScope()
+{
+    s_activeContext = m_previous;
+}
+
+} // Parsing
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ASTTypes.hpp"
+#include "ShortTypes.hpp"
+
+#include <deque>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Parsing {
+
+// Interner for type nodes, so that structurally equal types share one object and type
+// equality is a pointer comparison. Every FrontendDriver owns a context and installs it with
+// a TypeScope, types made outside any scope go to a process-wide context. The basic var
+// types are shared by all contexts.
+class TypeContext {
+    struct ArrayKey {
+        const TypeBase* elementType;
+        i64 size;
+        bool operator==(const ArrayKey& other) const = default;
+    };
+    struct ArrayKeyHash {
+        size_t operator()(const ArrayKey& key) const noexcept;
+    };
+    struct FuncKeyHash {
+        size_t operator()(const std::vector<const TypeBase*>& key) const noexcept;
+    };
+    std::deque<PointerType> m_pointers;
+    std::deque<ArrayType> m_arrays;
+    std::deque<FuncType> m_funcs;
+    std::unordered_map<const TypeBase*, const PointerType*> m_pointerIds;
+    std::unordered_map<ArrayKey, const ArrayType*, ArrayKeyHash> m_arrayIds;
+    std::unordered_map<std::vector<const TypeBase*>, const FuncType*, FuncKeyHash> m_funcIds;
+    mutable std::shared_mutex m_mutex;
+public:
+    TypeContext() = default;
+    TypeContext(const TypeContext& other) = delete;
+    TypeContext& operator=(const TypeContext& other) = delete;
+
+    [[nodiscard]] static TypeContext& active();
+
+    [[nodiscard]] static const VarType* var(Type type);
+    [[nodiscard]] const PointerType* pointer(const TypeBase* referenced);
+    [[nodiscard]] const ArrayType* array(const TypeBase* elementType, i64 size);
+    [[nodiscard]] const FuncType* function(const TypeBase* returnType, std::vector<const TypeBase*> params);
+};
+
+class TypeScope {
+    TypeContext* m_previous;
+public:
+    explicit TypeScope(TypeContext& context);
+    ~TypeScope();
+    TypeScope(const TypeScope& other) = delete;
+    TypeScope& operator=(const TypeScope& other) = delete;
+};
+
+[[nodiscard]] inline const VarType* varType(const Type type)
+{
+    return TypeContext::var(type);
+}
+
+[[nodiscard]] inline const PointerType* pointerTo(const TypeBase* referenced)
+{
+    return TypeContext::active().pointer(referenced);
+}
+
+[[nodiscard]] inline const ArrayType* arrayOf(const TypeBase* elementType, const i64 size)
+{
+    return TypeContext::active().array(elementType, size);
+}
+
+[[nodiscard]] inline const FuncType* funcType(const TypeBase* returnType, std::vector<const TypeBase*> params)
+{
+    return TypeContext::active().function(returnType, std::move(params));
+}
+
+} // Parsing
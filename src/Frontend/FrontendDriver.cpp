@@ -9,23 +9,43 @@
 #include "Lexer.hpp"
 #include "LvalueVerification.hpp"
 #include "Parser.hpp"
+#include "Preprocessor.hpp"
 #include "LoopLabeling.hpp"
 #include "ValidateReturn.hpp"
 #include "TypeResolution.hpp"
+#include "TimeTrace.hpp"
 
-#include <fstream>
 #include <iostream>
 
-static std::vector<Error> lex(TokenStore& tokenStore, const std::filesystem::path& inputFile);
+static std::vector<Error> lex(TokenStore& tokenStore, std::string source);
 static std::vector<Error> parse(const TokenStore& tokenStore, Parsing::Program& programNode);
 static void printParsingAst(const Parsing::Program& program);
-static Ir::Program ir(const Parsing::Program& parsingProgram, SymbolTable& symbolTable);
-static std::string preProcess(const std::filesystem::path& file);
-static std::string getSourceCode(const std::filesystem::path& inputFile);
+static Ir::Program ir(const Parsing::Program& parsingProgram, SymbolTable& symbolTable, std::vector<Error>& errors);
+static std::vector<std::string> preProcess(const std::filesystem::path& file, std::string& source);
+
+StateCode FrontendDriver::preprocess()
+{
+    m_preprocessed = true;
+    const TimeTrace::Scope scope("preprocess");
+    if (const std::vector<std::string> errors = preProcess(m_inputFile, m_source); !errors.empty()) {
+        for (const std::string& error : errors)
+            std::cout << error << '\n';
+        return StateCode::Preprocessor;
+    }
+    return StateCode::Continue;
+}
 
 std::tuple<std::optional<Ir::Program>, StateCode> FrontendDriver::run()
 {
-    if (const std::vector<Error> errors = lex(m_tokenStore, m_inputFile); !errors.empty()) {
+    return run(ir);
+}
+
+std::tuple<std::optional<Ir::Program>, StateCode> FrontendDriver::run(const IrGenerator& generateIr)
+{
+    if (!m_preprocessed)
+        if (const StateCode err = preprocess(); err != StateCode::Continue)
+            return {std::nullopt, err};
+    if (const std::vector<Error> errors = lex(m_tokenStore, std::move(m_source)); !errors.empty()) {
         reportErrors(errors, m_tokenStore);
         return {std::nullopt, StateCode::Lexer};
     }
@@ -36,7 +56,17 @@ std::tuple<std::optional<Ir::Program>, StateCode> FrontendDriver::run()
             std::cout << m_tokenStore.getToken(i) << '\n';
         return {std::nullopt, StateCode::Done};
     }
-    Parsing::Program program;
+    auto result = runOnAst(generateIr);
+    // Nothing in the tree owns memory outside the arena, so it is dropped without walking it.
+    m_astArena.release();
+    return result;
+}
+
+std::tuple<std::optional<Ir::Program>, StateCode> FrontendDriver::runOnAst(const IrGenerator& generateIr)
+{
+    const Parsing::ArenaScope arenaScope(m_astArena);
+    const Parsing::TypeScope typeScope(m_types);
+    Parsing::Program& program = *new Parsing::Program();
     if (const std::vector<Error> errors = parse(m_tokenStore, program); !errors.empty()) {
         reportErrors(errors, m_tokenStore);
         return {std::nullopt, StateCode::Parser};
@@ -58,36 +88,49 @@ std::tuple<std::optional<Ir::Program>, StateCode> FrontendDriver::run()
         printParsingAst(program);
         return {std::nullopt, StateCode::Done};
     }
-    Ir::Program irProgram = ir(program, symbolTable);
+    const TimeTrace::Scope scope("GenerateIr");
+    std::vector<Error> errors;
+    Ir::Program irProgram = generateIr(program, symbolTable, errors);
+    if (!errors.empty()) {
+        reportErrors(errors, m_tokenStore);
+        return {std::nullopt, StateCode::IrGeneration};
+    }
     return {std::move(irProgram), StateCode::Continue};
 }
 
-std::string getSourceCode(const std::filesystem::path& inputFile)
-{
-    std::ifstream file(inputFile);
-    if (!file.is_open())
-        return {};
-    std::string source((std::istreambuf_iterator(file)), std::istreambuf_iterator<char>());
-    return source;
-}
-
 std::pair<StateCode, std::vector<Error>> validateSemantics(Parsing::Program& program, SymbolTable& symbolTable)
 {
-    Semantics::VariableResolution variableResolution(symbolTable);
-    if (const std::vector<Error> errors = variableResolution.resolve(program); !errors.empty())
-        return {StateCode::VariableResolution, errors};
-    Semantics::TypeResolution typeResolution;
-    if (const std::vector<Error> errors = typeResolution.validate(program); !errors.empty())
-        return {StateCode::TypeResolution, errors};
-    Semantics::LvalueVerification lvalueVerification;
-    if (const std::vector<Error> errors = lvalueVerification.resolve(program); !errors.empty())
-        return {StateCode::LValueVerification, errors};
-    Semantics::ValidateReturn validateReturn;
-    if (std::vector<Error> errors = validateReturn.programValidate(program); !errors.empty())
-        return {StateCode::ValidateReturn, errors};
-    Semantics::GotoLabelsUnique labelsUnique;
-    if (const std::vector<Error> errors = labelsUnique.programValidate(program); !errors.empty())
-        return {StateCode::LabelsUnique, errors};
+    {
+        const TimeTrace::Scope scope("VariableResolution");
+        Semantics::VariableResolution variableResolution(symbolTable);
+        if (const std::vector<Error> errors = variableResolution.resolve(program); !errors.empty())
+            return {StateCode::VariableResolution, errors};
+    }
+    {
+        const TimeTrace::Scope scope("TypeResolution");
+        Semantics::TypeResolution typeResolution;
+        if (const std::vector<Error> errors = typeResolution.validate(program); !errors.empty())
+            return {StateCode::TypeResolution, errors};
+    }
+    {
+        const TimeTrace::Scope scope("LvalueVerification");
+        Semantics::LvalueVerification lvalueVerification;
+        if (const std::vector<Error> errors = lvalueVerification.resolve(program); !errors.empty())
+            return {StateCode::LValueVerification, errors};
+    }
+    {
+        const TimeTrace::Scope scope("ValidateReturn");
+        Semantics::ValidateReturn validateReturn;
+        if (std::vector<Error> errors = validateReturn.programValidate(program); !errors.empty())
+            return {StateCode::ValidateReturn, errors};
+    }
+    {
+        const TimeTrace::Scope scope("GotoLabelsUnique");
+        Semantics::GotoLabelsUnique labelsUnique;
+        if (const std::vector<Error> errors = labelsUnique.programValidate(program); !errors.empty())
+            return {StateCode::LabelsUnique, errors};
+    }
+    const TimeTrace::Scope scope("LoopLabeling");
     Semantics::LoopLabeling loopLabeling;
     if (const std::vector<Error> errors = loopLabeling.programValidate(program); !errors.empty())
         return {StateCode::LoopLabeling, errors};
@@ -101,39 +144,33 @@ void printParsingAst(const Parsing::Program& program)
     std::cout << printer.getString();
 }
 
-std::vector<Error> lex(TokenStore& tokenStore, const std::filesystem::path& inputFile)
+std::vector<Error> lex(TokenStore& tokenStore, std::string source)
 {
-    const std::string source = preProcess(inputFile);
-    Lexing::Lexer lexer(source, tokenStore);
+    const TimeTrace::Scope scope("lex");
+    Lexing::Lexer lexer(std::move(source), tokenStore);
     return lexer.getLexemes();
 }
 
 std::vector<Error> parse(const TokenStore& tokenStore, Parsing::Program& programNode)
 {
+    const TimeTrace::Scope scope("parse");
     Parsing::Parser parser(tokenStore);
     return parser.programParse(programNode);
 }
 
-Ir::Program ir(const Parsing::Program& parsingProgram, SymbolTable& symbolTable)
+Ir::Program ir(const Parsing::Program& parsingProgram, SymbolTable& symbolTable, std::vector<Error>& errors)
 {
     Ir::Program irProgram;
     Ir::GenerateIr generateIr(symbolTable);
     generateIr.program(parsingProgram, irProgram);
+    errors = generateIr.takeErrors();
     return irProgram;
 }
 
-static std::string preProcess(const std::filesystem::path& file)
+std::vector<std::string> preProcess(const std::filesystem::path& file, std::string& source)
 {
-    const std::filesystem::path& inputFile(file);
-    const std::filesystem::path generatedFilesDir = std::filesystem::path(PROJECT_ROOT_DIR) / "generated_files";
-    const std::filesystem::path generatedFile = inputFile.string() + ".i";
-    std::string command = "gcc -E -P ";
-    command += inputFile.string();
-    command += " -o ";
-    command += generatedFile.string();
-    if (std::system(command.c_str()) != 0)
-        return {};
-    return getSourceCode(generatedFile.string());
+    Preprocessing::Preprocessor preprocessor;
+    return preprocessor.processFile(file, source);
 }
 
 void reportErrors(const std::vector<Error>& errors, const TokenStore& tokenStore)
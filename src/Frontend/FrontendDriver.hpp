@@ -1,26 +1,44 @@
 #pragma once
 
+#include "ASTArena.hpp"
 #include "ASTIr.hpp"
 #include "StateCode.hpp"
 #include "ASTParser.hpp"
 #include "Error.hpp"
 #include "SymbolTable.hpp"
 #include "TokenStore.hpp"
+#include "TypeContext.hpp"
 
 #include <filesystem>
+#include <functional>
+#include <optional>
 #include <string>
 
 class FrontendDriver {
     std::string m_arg;
     std::filesystem::path m_inputFile;
     TokenStore m_tokenStore;
+    Parsing::ASTArena m_astArena;
+    Parsing::TypeContext m_types;
+    std::string m_source;
+    bool m_preprocessed = false;
 public:
     FrontendDriver() = delete;
     FrontendDriver(const FrontendDriver& other) = delete;
     FrontendDriver(std::string arg, std::filesystem::path inputFile)
         : m_arg(std::move(arg)), m_inputFile(std::move(inputFile)) {}
 
+    // Runs only the preprocessor, run() then continues from its output.
+    [[nodiscard]] StateCode preprocess();
+    [[nodiscard]] const std::string& preprocessedSource() const { return m_source; }
     [[nodiscard]] std::tuple<std::optional<Ir::Program>, StateCode> run();
+    // The AST only lives for the duration of run, so callers that lower it themselves hook in here.
+    // Initializers the generator cannot lower go into the error list and end the run.
+    using IrGenerator = std::function<Ir::Program(const Parsing::Program&, SymbolTable&, std::vector<Error>&)>;
+    [[nodiscard]] std::tuple<std::optional<Ir::Program>, StateCode> run(const IrGenerator& generateIr);
+private:
+    // Builds the AST in m_astArena, it is never destroyed but released as a whole by run.
+    [[nodiscard]] std::tuple<std::optional<Ir::Program>, StateCode> runOnAst(const IrGenerator& generateIr);
 };
 
 std::pair<StateCode, std::vector<Error>> validateSemantics(Parsing::Program& program, SymbolTable& symbolTable);
@@ -105,13 +105,13 @@ inline bool isBitShift(const Parsing::AssignmentExpr::Operator oper)
 }
 
 
-inline i64 getArraySize(Parsing::TypeBase* type)
+inline i64 getArraySize(const Parsing::TypeBase* type)
 {
     i64 result = 1;
     while (type->kind == Parsing::TypeBase::Kind::Array) {
-        const auto arrayType = dynCast<Parsing::ArrayType>(type);
+        const auto arrayType = dynCast<const Parsing::ArrayType>(type);
         result *= arrayType->size;
-        type = arrayType->elementType.get();
+        type = arrayType->elementType;
     }
     return result;
 }
@@ -121,17 +121,9 @@ inline Type getArrayType(const Parsing::TypeBase* const type)
     const Parsing::TypeBase* currentType = type;
     while (currentType->kind == Parsing::TypeBase::Kind::Array) {
         const auto arrayType = dynCast<const Parsing::ArrayType>(currentType);
-        currentType = arrayType->elementType.get();
+        currentType = arrayType->elementType;
     }
     return currentType->type;
 }
 
-inline i64 getArrayAlignment(const i64 size, const Type type)
-{
-    const i64 realSize = size * getTypeSize(type);
-    if (16 <= realSize)
-        return 16;
-    return getTypeSize(type);
-}
-
 } // Ir
\ No newline at end of file
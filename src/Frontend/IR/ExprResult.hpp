@@ -19,10 +19,10 @@ protected:
 };
 
 struct PlainOperand : ExprResult {
-    std::shared_ptr<Value> value;
+    ValueId value;
 
-    explicit PlainOperand(std::shared_ptr<Value> value)
-        : ExprResult(Kind::PlainOperand), value(std::move(value)) {}
+    explicit PlainOperand(const ValueId value)
+        : ExprResult(Kind::PlainOperand), value(value) {}
 
     static bool classOf(const ExprResult* expr) { return expr->kind == Kind::PlainOperand; }
 
@@ -30,10 +30,10 @@ struct PlainOperand : ExprResult {
 };
 
 struct DereferencedPointer : ExprResult {
-    std::shared_ptr<Value> ptr;
+    ValueId ptr;
     Type referredToType;
-    DereferencedPointer(std::shared_ptr<Value> p, const Type rt)
-        : ExprResult(Kind::DereferencedPointer), ptr(std::move(p)), referredToType(rt) {}
+    DereferencedPointer(const ValueId p, const Type rt)
+        : ExprResult(Kind::DereferencedPointer), ptr(p), referredToType(rt) {}
 
     static bool classOf(const ExprResult* expr) { return expr->kind == Kind::DereferencedPointer; }
 
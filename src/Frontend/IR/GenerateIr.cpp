@@ -4,30 +4,33 @@
 #include "ASTTypes.hpp"
 #include "AstToIrOperators.hpp"
 #include "DynCast.hpp"
+#include "TimeTrace.hpp"
 #include "Utils.hpp"
 
 #include <algorithm>
 #include <cassert>
+#include <utility>
 #include <strings.h>
 
 namespace Ir {
-static Identifier makeTemporaryName();
-static Identifier makeTemporaryName(Value& value);
-static Identifier makeTemporaryName(const std::string& name);
 static std::string generateCaseLabelName(std::string before);
-static std::shared_ptr<Value> genConstValue(const Parsing::ConstExpr& constExpr);
-static std::shared_ptr<Value> genZeroValueForType(Type type);
-static i64 getTypeOfSize(Parsing::TypeBase* typeBase);
+static Value genConstValue(const Parsing::ConstExpr& constExpr);
+static Value genZeroValueForType(Type type);
+static i64 getTypeOfSize(const Parsing::TypeBase* typeBase);
 
 void GenerateIr::program(const Parsing::Program& parsingProgram, Program& tackyProgram)
 {
-    for (const std::unique_ptr<Parsing::Declaration>& decl : parsingProgram.declarations) {
-        std::unique_ptr<TopLevel> topLevel = topLevelIr(*decl);
-        if (topLevel == nullptr)
-            continue;
+    for (const std::unique_ptr<Parsing::Declaration>& decl : parsingProgram.declarations)
+        for (std::unique_ptr<TopLevel>& topLevel : declarationIr(*decl))
+            tackyProgram.topLevels.emplace_back(std::move(topLevel));
+}
+
+std::vector<std::unique_ptr<TopLevel>> GenerateIr::declarationIr(const Parsing::Declaration& decl)
+{
+    std::unique_ptr<TopLevel> topLevel = topLevelIr(decl);
+    if (topLevel != nullptr)
         m_topLevels.emplace_back(std::move(topLevel));
-    }
-    tackyProgram.topLevels = std::move(m_topLevels);
+    return std::exchange(m_topLevels, {});
 }
 
 std::unique_ptr<TopLevel> GenerateIr::topLevelIr(const Parsing::Declaration& decl)
@@ -51,15 +54,14 @@ std::unique_ptr<TopLevel> GenerateIr::topLevelIr(const Parsing::Declaration& dec
 
 void GenerateIr::allocateLocalArrayWithoutInitializer(const Parsing::VarDecl& varDecl)
 {
-    const i64 size = getArraySize(varDecl.type.get());
-    const Type type = getArrayType(varDecl.type.get());
+    const i64 size = getArraySize(varDecl.type);
+    const Type type = getArrayType(varDecl.type);
     emplaceAllocate(size, varDecl.name, type);
 }
 
-void GenerateIr::directlyPushConstant32Bit(const Parsing::VarDecl& varDecl, const std::shared_ptr<Value>& value)
+void GenerateIr::directlyPushConstant32Bit(const Parsing::VarDecl& varDecl, const ValueId value)
 {
-    const Identifier iden(varDecl.name);
-    const auto var = std::make_shared<ValueVar>(iden, varDecl.type->type);
+    const ValueId var = intern(Value(Identifier(varDecl.name), varDecl.type->type));
     emplaceCopy(value, var, varDecl.type->type);
 }
 
@@ -93,78 +95,66 @@ void GenerateIr::genDeclaration(const Parsing::Declaration& decl)
 void GenerateIr::genSingleDeclaration(const Parsing::VarDecl& varDecl)
 {
     const auto singleInit = dynCast<Parsing::SingleInitializer>(varDecl.init.get());
-    const std::shared_ptr<Value> value = genInstAndConvert(*singleInit->expr);
-    if (value->kind == Value::Kind::Constant &&
+    const ValueId value = genInstAndConvert(*singleInit->expr);
+    if (this->value(value).isConstant() &&
         (varDecl.type->type == Type::I32 || varDecl.type->type == Type::U32)) {
         directlyPushConstant32Bit(varDecl, value);
         return;
     }
-    const auto temporary = std::make_shared<ValueVar>(makeTemporaryName(), varDecl.type->type);
+    const ValueId temporary = makeTemporary(varDecl.type->type);
     emplaceCopy(value, temporary, varDecl.type->type);
-    const Identifier iden(varDecl.name);
-    const auto var = std::make_shared<ValueVar>(iden, varDecl.type->type);
+    const ValueId var = intern(Value(Identifier(varDecl.name), varDecl.type->type));
     emplaceCopy(temporary, var, varDecl.type->type);
 }
 
-void GenerateIr::genZeroLocalInit(const std::string& name,
+void GenerateIr::genZeroLocalInit(const Symbol name,
                                   const Type type,
-                                  const i64 arraySize,
-                                  const i64 alignment,
                                   const i64 lengthZeroInit,
                                   i64& offset,
-                                  const std::shared_ptr<Value>& zeroConst)
+                                  const ValueId zeroConst)
 {
     const i64 typeSize = getTypeSize(type);
     for (size_t i = 0; i < lengthZeroInit; ++i) {
-        emplaceCopyToOffset(
-            zeroConst, Identifier(name), offset, arraySize, alignment, type);
+        emplaceCopyToOffset(zeroConst, Identifier(name), offset, type);
         offset += typeSize;
     }
 }
 
-void GenerateIr::genSingleLocalInit(const std::string& name,
+void GenerateIr::genSingleLocalInit(const Symbol name,
                                     const Type type,
-                                    const i64 arraySize,
-                                    const i64 alignment,
                                     i64& offset,
                                     const Parsing::SingleInitializer& singleInit)
 {
     const i64 typeSize = getTypeSize(type);
-    std::shared_ptr<Value> value = genInstAndConvert(*singleInit.expr);
+    ValueId value = genInstAndConvert(*singleInit.expr);
     if (singleInit.expr->kind == Parsing::Expr::Kind::String) {
-        const std::shared_ptr<ValueVar> var = std::make_shared<ValueVar>(makeTemporaryName(), Type::Pointer);
+        const ValueId var = makeTemporary(Type::Pointer);
         emplaceGetAddress(value, var, Type::Pointer);
         value = var;
     }
-    emplaceCopyToOffset(value, Identifier(name), offset, arraySize, alignment, type);
+    emplaceCopyToOffset(value, Identifier(name), offset, type);
     offset += typeSize;
 }
 
 void GenerateIr::genCompoundLocalInit(const Parsing::VarDecl& varDecl)
 {
     const auto compoundInit = dynCast<Parsing::CompoundInitializer>(varDecl.init.get());
-    const auto arrayType = dynCast<Parsing::ArrayType>(varDecl.type.get());
-    const Type type = getArrayType(varDecl.type.get());
+    const auto arrayType = dynCast<const Parsing::ArrayType>(varDecl.type);
+    const Type type = getArrayType(varDecl.type);
     const i64 arraySize = getArraySize(arrayType);
-    const i64 alignment = getArrayAlignment(arraySize, type);
+    emplaceAllocate(arraySize, varDecl.name, type);
     i64 offset = 0;
-    const auto zeroConst = genZeroValueForType(type);
+    const ValueId zeroConst = intern(genZeroValueForType(type));
     for (const auto& init : compoundInit->initializers) {
         switch (init->kind) {
             case Parsing::Initializer::Kind::Single: {
                 const auto singleInit = dynCast<Parsing::SingleInitializer>(init.get());
-                genSingleLocalInit(varDecl.name, type, arraySize, alignment, offset, *singleInit);
+                genSingleLocalInit(varDecl.name, type, offset, *singleInit);
                 break;
             }
             case Parsing::Initializer::Kind::Zero: {
                 const auto zeroInit = dynCast<Parsing::ZeroInitializer>(init.get());
-                genZeroLocalInit(varDecl.name,
-                                 type,
-                                 arraySize,
-                                 alignment,
-                                 zeroInit->size,
-                                 offset,
-                                 zeroConst);
+                genZeroLocalInit(varDecl.name, type, zeroInit->size, offset, zeroConst);
                 break;
             }
             default:
@@ -180,7 +170,7 @@ void GenerateIr::genStaticLocal(const Parsing::VarDecl& varDecl)
     m_topLevels.emplace_back(std::move(variable));
     m_symbolTable.addEntry(varDecl.name,
                            varDecl.name,
-                           *varDecl.type,
+                           varDecl.type,
                            true, false, false, defined);
 }
 
@@ -200,18 +190,18 @@ std::unique_ptr<TopLevel> GenerateIr::staticVariableIr(const Parsing::VarDecl& v
     if (varDecl.type->kind == Parsing::TypeBase::Kind::Array)
         return genStaticArray(varDecl, defined);
 
-    const std::shared_ptr<Value> value = genStaticVariableInit(varDecl, defined);
+    const Value value = genStaticVariableInit(varDecl, defined);
     auto variable = std::make_unique<StaticVariable>(
-        varDecl.name, value, varDecl.type->type, varDecl.storage != Storage::Static);
+        Identifier(varDecl.name), value, varDecl.type->type, varDecl.storage != Storage::Static);
     return variable;
 }
 
 std::unique_ptr<TopLevel> GenerateIr::genStaticArray(const Parsing::VarDecl& varDecl, const bool defined)
 {
-    const Type innerType = getArrayType(varDecl.type.get());
+    const Type innerType = getArrayType(varDecl.type);
     std::vector<std::unique_ptr<Initializer>> initializers = genStaticArrayInit(varDecl, defined);
     auto variable = std::make_unique<StaticArray>(
-        varDecl.name, std::move(initializers), innerType, varDecl.storage != Storage::Static);
+        Identifier(varDecl.name), std::move(initializers), innerType, varDecl.storage != Storage::Static);
     return variable;
 }
 
@@ -220,7 +210,7 @@ std::vector<std::unique_ptr<Initializer>> GenerateIr::genStaticArrayInit(
 {
     std::vector<std::unique_ptr<Initializer>> initializers;
     if (!defined) {
-        const i64 size = getArraySize(varDecl.type.get());
+        const i64 size = getArraySize(varDecl.type);
         initializers.emplace_back(std::make_unique<ZeroInitializer>(size));
         return initializers;
     }
@@ -229,8 +219,7 @@ std::vector<std::unique_ptr<Initializer>> GenerateIr::genStaticArrayInit(
         switch (stuff->kind) {
             case Parsing::Initializer::Kind::Single: {
                 const auto singleInit = dynCast<Parsing::SingleInitializer>(stuff.get());
-                const auto value = genInstAndConvert(*singleInit->expr);
-                initializers.emplace_back(std::make_unique<ValueInitializer>(value));
+                initializers.emplace_back(std::make_unique<ValueInitializer>(genStaticSingleInit(*singleInit->expr)));
                 break;
             }
             case Parsing::Initializer::Kind::Zero: {
@@ -251,35 +240,43 @@ std::vector<std::unique_ptr<Initializer>> GenerateIr::genStaticArrayInit(
 std::unique_ptr<TopLevel> GenerateIr::genStaticInit(const Parsing::VarDecl& varDecl, const bool defined)
 {
     if (varDecl.type->type == Type::Array) {
-        const Type innerType = getArrayType(varDecl.type.get());
+        const Type innerType = getArrayType(varDecl.type);
         auto initializers = genStaticArrayInit(varDecl, defined);
-        return std::make_unique<StaticArray>(varDecl.name, std::move(initializers), innerType, false);
+        return std::make_unique<StaticArray>(Identifier(varDecl.name), std::move(initializers), innerType, false);
     }
-    std::shared_ptr<Value> value = genStaticVariableInit(varDecl, defined);
-    return std::make_unique<StaticVariable>(varDecl.name, value, varDecl.type->type, false);
+    const Value value = genStaticVariableInit(varDecl, defined);
+    return std::make_unique<StaticVariable>(Identifier(varDecl.name), value, varDecl.type->type, false);
 }
 
-std::shared_ptr<Value> GenerateIr::genStaticVariableInit(const Parsing::VarDecl& varDecl, const bool defined)
+Value GenerateIr::genStaticVariableInit(const Parsing::VarDecl& varDecl, const bool defined)
 {
     if (defined) {
         const auto singleInit = dynCast<Parsing::SingleInitializer>(varDecl.init.get());
-        return genInstAndConvert(*singleInit->expr);
+        return genStaticSingleInit(*singleInit->expr);
     }
     return genZeroValueForType(varDecl.type->type);
 }
 
-std::shared_ptr<Value> genZeroValueForType(const Type type)
+Value GenerateIr::genStaticSingleInit(const Parsing::Expr& expr)
+{
+    const Value result = value(genInstAndConvert(expr));
+    if (!result.isConstant())
+        m_errors.emplace_back("Static initializer is not constant", expr.location);
+    return result;
+}
+
+Value genZeroValueForType(const Type type)
 {
     switch (type) {
-        case Type::Char:    return std::make_shared<ValueConst>(static_cast<char>(0));
-        case Type::I8:      return std::make_shared<ValueConst>(static_cast<i8>(0));
-        case Type::U8:      return std::make_shared<ValueConst>(static_cast<u8>(0));
-        case Type::I32:     return std::make_shared<ValueConst>(0);
-        case Type::U32:     return std::make_shared<ValueConst>(0u);
-        case Type::I64:     return std::make_shared<ValueConst>(static_cast<i64>(0l));
-        case Type::U64:     return std::make_shared<ValueConst>(static_cast<u64>(0ul));
-        case Type::Pointer: return std::make_shared<ValueConst>(static_cast<u64>(0ul));
-        case Type::Double:  return std::make_shared<ValueConst>(0.0);
+        case Type::Char:    return Value(static_cast<char>(0));
+        case Type::I8:      return Value(static_cast<i8>(0));
+        case Type::U8:      return Value(static_cast<u8>(0));
+        case Type::I32:     return Value(0);
+        case Type::U32:     return Value(0u);
+        case Type::I64:     return Value(static_cast<i64>(0l));
+        case Type::U64:     return Value(static_cast<u64>(0ul));
+        case Type::Pointer: return Value(static_cast<u64>(0ul));
+        case Type::Double:  return Value(0.0);
         default:
             abort();
     }
@@ -287,20 +284,30 @@ std::shared_ptr<Value> genZeroValueForType(const Type type)
 
 std::unique_ptr<TopLevel> GenerateIr::functionIr(const Parsing::FuncDeclaration& parsingFunction)
 {
+    const TimeTrace::FunctionScope scope("GenerateIr", parsingFunction.name.text());
     bool global = !m_symbolTable.lookup(parsingFunction.name).hasInternalLinkage();
-    auto functionTacky = std::make_unique<Function>(parsingFunction.name, global);
+    auto functionTacky = std::make_unique<Function>(Identifier(parsingFunction.name), global);
+    // Temporaries and labels are numbered per function and named after it, so a function gets
+    // the same IR no matter what comes before it.
+    const Symbol fileScopeBase = std::exchange(m_temporaryBase, parsingFunction.name);
+    const i64 fileScopeCounter = std::exchange(m_temporaryCounter, 0);
     m_global = true;
-    m_insts = std::move(functionTacky->insts);
+    m_function = functionTacky.get();
+    m_valueIds.clear();
+    m_labelIds.clear();
     functionTacky->args.reserve(parsingFunction.params.size());
     functionTacky->argTypes.reserve(parsingFunction.params.size());
-    const auto funcType = dynCast<const Parsing::FuncType>(parsingFunction.type.get());
+    const auto funcType = dynCast<const Parsing::FuncType>(parsingFunction.type);
     for (size_t i = 0; i < parsingFunction.params.size(); ++i) {
         functionTacky->args.emplace_back(Identifier(parsingFunction.params[i]));
         functionTacky->argTypes.emplace_back(funcType->params[i]->type);
     }
     genBlock(*parsingFunction.body);
-    functionTacky->insts = std::move(m_insts);
+    m_function = &m_fileScope;
+    m_valueIds.clear();
     m_global = false;
+    m_temporaryBase = fileScopeBase;
+    m_temporaryCounter = fileScopeCounter;
     return functionTacky;
 }
 
@@ -439,8 +446,8 @@ void GenerateIr::genIfStmt(const Parsing::IfStmt& ifStmt)
 
 void GenerateIr::genIfBasicStmt(const Parsing::IfStmt& ifStmt)
 {
-    const std::shared_ptr<Value> condition = genInstAndConvert(*ifStmt.condition);
-    const Identifier endLabelIden = makeTemporaryName();
+    const ValueId condition = genInstAndConvert(*ifStmt.condition);
+    const LabelId endLabelIden = makeLabel();
 
     emplaceJumpIfZero(condition, endLabelIden);
     genStmt(*ifStmt.thenStmt);
@@ -449,9 +456,9 @@ void GenerateIr::genIfBasicStmt(const Parsing::IfStmt& ifStmt)
 
 void GenerateIr::genIfElseStmt(const Parsing::IfStmt& ifStmt)
 {
-    const std::shared_ptr<Value> condition = genInstAndConvert(*ifStmt.condition);
-    const Identifier elseStmtLabel = makeTemporaryName();
-    const Identifier endLabelIden = makeTemporaryName();
+    const ValueId condition = genInstAndConvert(*ifStmt.condition);
+    const LabelId elseStmtLabel = makeLabel();
+    const LabelId endLabelIden = makeLabel();
 
     emplaceJumpIfZero(condition, elseStmtLabel);
     genStmt(*ifStmt.thenStmt);
@@ -464,10 +471,8 @@ void GenerateIr::genIfElseStmt(const Parsing::IfStmt& ifStmt)
 void GenerateIr::genReturnStmt(const Parsing::ReturnStmt& returnStmt)
 {
     if (returnStmt.expr) {
-        const std::shared_ptr<Value> value = genInstAndConvert(*returnStmt.expr);
-        if (value == nullptr)
-            return;
-        emplaceReturn(value, value->type);
+        const ValueId value = genInstAndConvert(*returnStmt.expr);
+        emplaceReturn(value, this->value(value).type);
         return;
     }
     emplaceReturn();
@@ -475,7 +480,7 @@ void GenerateIr::genReturnStmt(const Parsing::ReturnStmt& returnStmt)
 
 void GenerateIr::genGotoStmt(const Parsing::GotoStmt& gotoStmt)
 {
-    emplaceJump(Identifier(gotoStmt.identifier + ".label"));
+    emplaceJump(namedLabel(gotoStmt.identifier + ".label"));
 }
 
 void GenerateIr::genCompoundStmt(const Parsing::CompoundStmt& compoundStmt)
@@ -485,47 +490,47 @@ void GenerateIr::genCompoundStmt(const Parsing::CompoundStmt& compoundStmt)
 
 void GenerateIr::genBreakStmt(const Parsing::BreakStmt& breakStmt)
 {
-    emplaceJump(Identifier(breakStmt.identifier + "break"));
+    emplaceJump(namedLabel(breakStmt.identifier + "break"));
 }
 
 void GenerateIr::genContinueStmt(const Parsing::ContinueStmt& continueStmt)
 {
-    emplaceJump(Identifier(continueStmt.identifier + "continue"));
+    emplaceJump(namedLabel(continueStmt.identifier + "continue"));
 }
 
 void GenerateIr::genLabelStmt(const Parsing::LabelStmt& labelStmt)
 {
-    emplaceLabel(Identifier(labelStmt.identifier + ".label"));
+    emplaceLabel(namedLabel(labelStmt.identifier + ".label"));
     genStmt(*labelStmt.stmt);
 }
 
 void GenerateIr::genCaseStmt(const Parsing::CaseStmt& caseStmt)
 {
     emplaceLabel(
-        Identifier(generateCaseLabelName(caseStmt.identifier)));
+        namedLabel(generateCaseLabelName(std::string(caseStmt.identifier))));
     genStmt(*caseStmt.body);
 }
 
 void GenerateIr::genDefaultStmt(const Parsing::DefaultStmt& defaultStmt)
 {
-    emplaceLabel(Identifier(defaultStmt.identifier + "default"));
+    emplaceLabel(namedLabel(defaultStmt.identifier + "default"));
     genStmt(*defaultStmt.body);
 }
 
 void GenerateIr::genDoWhileStmt(const Parsing::DoWhileStmt& doWhileStmt)
 {
-    emplaceLabel(Identifier(doWhileStmt.identifier + "start"));
+    emplaceLabel(namedLabel(doWhileStmt.identifier + "start"));
     genStmt(*doWhileStmt.body);
-    emplaceLabel(Identifier(doWhileStmt.identifier + "continue"));
-    const std::shared_ptr<Value> condition = genInstAndConvert(*doWhileStmt.condition);
-    emplaceJumpIfNotZero(condition, Identifier(doWhileStmt.identifier + "start"));
-    emplaceLabel(Identifier(doWhileStmt.identifier + "break"));
+    emplaceLabel(namedLabel(doWhileStmt.identifier + "continue"));
+    const ValueId condition = genInstAndConvert(*doWhileStmt.condition);
+    emplaceJumpIfNotZero(condition, namedLabel(doWhileStmt.identifier + "start"));
+    emplaceLabel(namedLabel(doWhileStmt.identifier + "break"));
 }
 
 void GenerateIr::genWhileStmt(const Parsing::WhileStmt& whileStmt)
 {
-    const auto continueIden = Identifier(whileStmt.identifier + "continue");
-    const auto breakIden = Identifier(whileStmt.identifier + "break");
+    const LabelId continueIden = namedLabel(whileStmt.identifier + "continue");
+    const LabelId breakIden = namedLabel(whileStmt.identifier + "break");
 
     emplaceLabel(continueIden);
     const auto condition = genInstAndConvert(*whileStmt.condition);
@@ -539,56 +544,56 @@ void GenerateIr::genForStmt(const Parsing::ForStmt& forStmt)
 {
     if (forStmt.init)
         genForInit(*forStmt.init);
-    emplaceLabel(Identifier(forStmt.identifier + "start"));
+    emplaceLabel(namedLabel(forStmt.identifier + "start"));
     if (forStmt.condition) {
         const auto condition = genInstAndConvert(*forStmt.condition);
-        emplaceJumpIfZero(condition, Identifier(forStmt.identifier + "break"));
+        emplaceJumpIfZero(condition, namedLabel(forStmt.identifier + "break"));
     }
     genStmt(*forStmt.body);
-    emplaceLabel(Identifier(forStmt.identifier + "continue"));
+    emplaceLabel(namedLabel(forStmt.identifier + "continue"));
     if (forStmt.post)
         genInst(*forStmt.post);
-    emplaceJump(Identifier(forStmt.identifier + "start"));
-    emplaceLabel(Identifier(forStmt.identifier + "break"));
+    emplaceJump(namedLabel(forStmt.identifier + "start"));
+    emplaceLabel(namedLabel(forStmt.identifier + "break"));
 }
 
 void GenerateIr::genSwitchStmt(const Parsing::SwitchStmt& stmt)
 {
-    const std::shared_ptr<Value> realValue = genInstAndConvert(*stmt.condition);
+    const ValueId realValue = genInstAndConvert(*stmt.condition);
     const Type conditionType = stmt.condition->type->type;
     for (const std::variant<i32, i64, u32, u64>& caseValue : stmt.cases) {
-        const auto dst = std::make_shared<ValueVar>(makeTemporaryName(), conditionType);
+        const ValueId dst = makeTemporary(conditionType);
         std::string caseLabelName;
-        std::shared_ptr<ValueConst> src2;
+        ValueId src2 = ValueId::None;
         if (conditionType == Type::I32) {
             const i32 value = std::get<i32>(caseValue);
-            caseLabelName = generateCaseLabelName(stmt.identifier + std::to_string(value));
-            src2 = std::make_shared<ValueConst>(value);
+            caseLabelName = generateCaseLabelName(std::string(stmt.identifier) + std::to_string(value));
+            src2 = makeConstant(value);
         }
         if (conditionType == Type::I64) {
             const i64 value = std::get<i64>(caseValue);
-            caseLabelName = generateCaseLabelName(stmt.identifier + std::to_string(value));
-            src2 = std::make_shared<ValueConst>(value);
+            caseLabelName = generateCaseLabelName(std::string(stmt.identifier) + std::to_string(value));
+            src2 = makeConstant(value);
         }
         if (conditionType == Type::U32) {
             const u32 value = std::get<u32>(caseValue);
-            caseLabelName = generateCaseLabelName(stmt.identifier + std::to_string(value));
-            src2 = std::make_shared<ValueConst>(value);
+            caseLabelName = generateCaseLabelName(std::string(stmt.identifier) + std::to_string(value));
+            src2 = makeConstant(value);
         }
         if (conditionType == Type::U64) {
             const u64 value = std::get<u32>(caseValue);
-            caseLabelName = generateCaseLabelName(stmt.identifier + std::to_string(value));
-            src2 = std::make_shared<ValueConst>(value);
+            caseLabelName = generateCaseLabelName(std::string(stmt.identifier) + std::to_string(value));
+            src2 = makeConstant(value);
         }
-        emplaceBinary(BinaryInst::Operation::Equal, realValue, src2, dst, realValue->type);
-        emplaceJumpIfNotZero(dst, Identifier(caseLabelName));
+        emplaceBinary(BinaryInst::Operation::Equal, realValue, src2, dst, value(realValue).type);
+        emplaceJumpIfNotZero(dst, namedLabel(caseLabelName));
     }
     if (stmt.hasDefault)
-        emplaceJump(Identifier(stmt.identifier + "default"));
+        emplaceJump(namedLabel(stmt.identifier + "default"));
     else
-        emplaceJump(Identifier(stmt.identifier + "break"));
+        emplaceJump(namedLabel(stmt.identifier + "break"));
     genStmt(*stmt.body);
-    emplaceLabel(Identifier(stmt.identifier + "break"));
+    emplaceLabel(namedLabel(stmt.identifier + "break"));
 }
 
 std::unique_ptr<ExprResult> GenerateIr::genInst(const Parsing::Expr& parsingExpr)
@@ -657,7 +662,7 @@ std::unique_ptr<ExprResult> GenerateIr::genInst(const Parsing::Expr& parsingExpr
     std::unreachable();
 }
 
-std::shared_ptr<Value> GenerateIr::genInstAndConvert(const Parsing::Expr& parsingExpr)
+ValueId GenerateIr::genInstAndConvert(const Parsing::Expr& parsingExpr)
 {
     const std::unique_ptr<ExprResult> result = genInst(parsingExpr);
     switch (result->kind) {
@@ -667,8 +672,7 @@ std::shared_ptr<Value> GenerateIr::genInstAndConvert(const Parsing::Expr& parsin
         }
         case ExprResult::Kind::DereferencedPointer: {
             const auto dereferencedPointer = dynCast<const DereferencedPointer>(result.get());
-            Identifier dstIden = makeTemporaryName();
-            std::shared_ptr<Value> dst = std::make_shared<ValueVar>(dstIden, dereferencedPointer->referredToType);
+            const ValueId dst = makeTemporary(dereferencedPointer->referredToType);
             emplaceLoad(dereferencedPointer->ptr, dst, dereferencedPointer->referredToType);
             return dst;
         }
@@ -678,17 +682,16 @@ std::shared_ptr<Value> GenerateIr::genInstAndConvert(const Parsing::Expr& parsin
 
 std::unique_ptr<ExprResult> GenerateIr::genCastInst(const Parsing::CastExpr& castExpr)
 {
-    const std::shared_ptr<Value> result = genInstAndConvert(*castExpr.innerExpr);
+    const ValueId result = genInstAndConvert(*castExpr.innerExpr);
     const Type towards = castExpr.type->type;
     const Type from = castExpr.innerExpr->type->type;
-    const std::shared_ptr<Value> dst = castValue(result, towards, from);
+    const ValueId dst = castValue(result, towards, from);
     return std::make_unique<PlainOperand>(dst);
 }
 
-std::shared_ptr<ValueVar> GenerateIr::castValue(
-    const std::shared_ptr<Value>& result, const Type towards, const Type from)
+ValueId GenerateIr::castValue(const ValueId result, const Type towards, const Type from)
 {
-    auto dst = std::make_shared<ValueVar>(makeTemporaryName(), towards);
+    const ValueId dst = makeTemporary(towards);
     if (towards == Type::Void)
         return dst;
     if (towards == Type::Double && !isSigned(from))
@@ -724,8 +727,8 @@ std::unique_ptr<ExprResult> GenerateIr::genUnaryInst(const Parsing::UnaryExpr& u
 std::unique_ptr<ExprResult> GenerateIr::genUnaryBasicInst(const Parsing::UnaryExpr& unaryExpr)
 {
     const UnaryInst::Operation operation = convertUnaryOperation(unaryExpr.op);
-    const std::shared_ptr<Value> src = genInstAndConvert(*unaryExpr.innerExpr);
-    auto dst = std::make_shared<ValueVar>(makeTemporaryName(), unaryExpr.type->type);
+    const ValueId src = genInstAndConvert(*unaryExpr.innerExpr);
+    const ValueId dst = makeTemporary(unaryExpr.type->type);
 
     emplaceUnary(operation, src, dst, unaryExpr.type->type);
     return std::make_unique<PlainOperand>(dst);
@@ -733,11 +736,11 @@ std::unique_ptr<ExprResult> GenerateIr::genUnaryBasicInst(const Parsing::UnaryEx
 
 std::unique_ptr<ExprResult> GenerateIr::genUnaryPostfixInst(const Parsing::UnaryExpr& unaryExpr)
 {
-    auto originalForReturn = std::make_shared<ValueVar>(makeTemporaryName(), unaryExpr.type->type);
-    const auto tempNew = std::make_shared<ValueVar>(makeTemporaryName(), unaryExpr.type->type);
+    const ValueId originalForReturn = makeTemporary(unaryExpr.type->type);
+    const ValueId tempNew = makeTemporary(unaryExpr.type->type);
     const auto oper = getPostPrefixOperation(unaryExpr.op);
     const Type type = unaryExpr.type->type;
-    const std::shared_ptr<ValueConst> scale = getInrDecScale(unaryExpr, type);
+    const ValueId scale = incDecScale(unaryExpr, type);
     const std::shared_ptr original = genInst(*unaryExpr.innerExpr);
     switch (original->kind) {
         case ExprResult::Kind::PlainOperand: {
@@ -749,7 +752,7 @@ std::unique_ptr<ExprResult> GenerateIr::genUnaryPostfixInst(const Parsing::Unary
         }
         case ExprResult::Kind::DereferencedPointer: {
             const auto derefOriginal = dynCast<const DereferencedPointer>(original.get());
-            const auto derefValue = std::make_shared<ValueVar>(Identifier(makeTemporaryName()), type);
+            const ValueId derefValue = makeTemporary(type);
             emplaceLoad(derefOriginal->ptr, derefValue, type);
             emplaceCopy(derefValue, originalForReturn, type);
             emplaceBinary(oper, originalForReturn, scale, tempNew, type);
@@ -763,8 +766,8 @@ std::unique_ptr<ExprResult> GenerateIr::genUnaryPostfixInst(const Parsing::Unary
 std::unique_ptr<ExprResult> GenerateIr::genUnaryPrefixInst(const Parsing::UnaryExpr& unaryExpr)
 {
     const Type type = unaryExpr.type->type;
-    const std::shared_ptr<ValueConst> scale = getInrDecScale(unaryExpr, type);
-    const auto temp = std::make_shared<ValueVar>(Identifier(makeTemporaryName()), type);
+    const ValueId scale = incDecScale(unaryExpr, type);
+    const ValueId temp = makeTemporary(type);
     const auto operation = getPostPrefixOperation(unaryExpr.op);
     const std::unique_ptr<ExprResult> original = genInst(*unaryExpr.innerExpr);
     switch (original->kind) {
@@ -776,7 +779,7 @@ std::unique_ptr<ExprResult> GenerateIr::genUnaryPrefixInst(const Parsing::UnaryE
         }
         case ExprResult::Kind::DereferencedPointer: {
             const auto derefPtr = dynCast<const DereferencedPointer>(original.get());
-            const auto derefValue = std::make_shared<ValueVar>(Identifier(makeTemporaryName()), type);
+            const ValueId derefValue = makeTemporary(type);
             emplaceLoad(derefPtr->ptr, derefValue, type);
             emplaceBinary(operation, derefValue, scale, temp, type);
             emplaceStore(temp, derefPtr->ptr, type);
@@ -788,14 +791,12 @@ std::unique_ptr<ExprResult> GenerateIr::genUnaryPrefixInst(const Parsing::UnaryE
 
 std::unique_ptr<ExprResult> GenerateIr::genVarInst(const Parsing::VarExpr& varExpr)
 {
-    const Identifier iden(varExpr.name);
-    auto var = std::make_shared<ValueVar>(iden, varExpr.type->type);
-    var->referingTo = varExpr.referingTo;
-    if (var->type == Type::Array) {
-        var->size = getArraySize(varExpr.type.get());
-        var->type = Type::Pointer;
+    Value var(Identifier(varExpr.name), varExpr.type->type, varExpr.referingTo, 0);
+    if (var.type == Type::Array) {
+        var.size = getArraySize(varExpr.type);
+        var.type = Type::Pointer;
     }
-    return std::make_unique<PlainOperand>(var);
+    return std::make_unique<PlainOperand>(intern(var));
 }
 
 std::unique_ptr<ExprResult> GenerateIr::genBinaryInst(const Parsing::BinaryExpr& binaryExpr)
@@ -811,10 +812,10 @@ std::unique_ptr<ExprResult> GenerateIr::genBinaryInst(const Parsing::BinaryExpr&
 
 std::unique_ptr<ExprResult> GenerateIr::genBinarySimpleInst(const Parsing::BinaryExpr& binaryExpr)
 {
-    const std::shared_ptr<Value> lhs = genInstAndConvert(*binaryExpr.lhs);
-    const std::shared_ptr<Value> rhs = genInstAndConvert(*binaryExpr.rhs);
+    const ValueId lhs = genInstAndConvert(*binaryExpr.lhs);
+    const ValueId rhs = genInstAndConvert(*binaryExpr.rhs);
 
-    auto dst = std::make_shared<ValueVar>(makeTemporaryName(), binaryExpr.type->type);
+    const ValueId dst = makeTemporary(binaryExpr.type->type);
     const BinaryInst::Operation operation = convertBinaryOperation(binaryExpr.op);
     emplaceBinary(operation, lhs, rhs, dst, binaryExpr.type->type);
     return std::make_unique<PlainOperand>(dst);
@@ -822,19 +823,19 @@ std::unique_ptr<ExprResult> GenerateIr::genBinarySimpleInst(const Parsing::Binar
 
 std::unique_ptr<ExprResult> GenerateIr::genBinaryAndInst(const Parsing::BinaryExpr& binaryExpr)
 {
-    auto result = std::make_shared<ValueVar>(makeTemporaryName(), binaryExpr.type->type);
-    const std::shared_ptr<Value> lhs = genInstAndConvert(*binaryExpr.lhs);
-    const Identifier falseLabelIden = makeTemporaryName();
+    const ValueId result = makeTemporary(binaryExpr.type->type);
+    const ValueId lhs = genInstAndConvert(*binaryExpr.lhs);
+    const LabelId falseLabelIden = makeLabel();
 
     emplaceJumpIfZero(lhs, falseLabelIden);
-    const std::shared_ptr<Value> rhs = genInstAndConvert(*binaryExpr.rhs);
+    const ValueId rhs = genInstAndConvert(*binaryExpr.rhs);
     emplaceJumpIfZero(rhs, falseLabelIden);
-    const auto oneVal = std::make_shared<ValueConst>(1);
+    const auto oneVal = makeConstant(1);
     emplaceCopy(oneVal, result, binaryExpr.type->type);
-    const Identifier endLabelIden = makeTemporaryName();
+    const LabelId endLabelIden = makeLabel();
     emplaceJump(endLabelIden);
     emplaceLabel(falseLabelIden);
-    const auto zeroVal = std::make_shared<ValueConst>(0);
+    const auto zeroVal = makeConstant(0);
     emplaceCopy(zeroVal, result, binaryExpr.type->type);
     emplaceLabel(endLabelIden);
     return std::make_unique<PlainOperand>(result);
@@ -842,19 +843,19 @@ std::unique_ptr<ExprResult> GenerateIr::genBinaryAndInst(const Parsing::BinaryEx
 
 std::unique_ptr<ExprResult> GenerateIr::genBinaryOrInst(const Parsing::BinaryExpr& binaryExpr)
 {
-    auto result = std::make_shared<ValueVar>(makeTemporaryName(), binaryExpr.type->type);
-    const std::shared_ptr<Value> lhs = genInstAndConvert(*binaryExpr.lhs);
-    const Identifier trueLabelIden = makeTemporaryName();
+    const ValueId result = makeTemporary(binaryExpr.type->type);
+    const ValueId lhs = genInstAndConvert(*binaryExpr.lhs);
+    const LabelId trueLabelIden = makeLabel();
 
     emplaceJumpIfNotZero(lhs, trueLabelIden);
-    const std::shared_ptr<Value> rhs = genInstAndConvert(*binaryExpr.rhs);
+    const ValueId rhs = genInstAndConvert(*binaryExpr.rhs);
     emplaceJumpIfNotZero(rhs, trueLabelIden);
-    const auto zeroVal = std::make_shared<ValueConst>(0);
+    const auto zeroVal = makeConstant(0);
     emplaceCopy(zeroVal, result, binaryExpr.type->type);
-    const Identifier endLabelIden = makeTemporaryName();
+    const LabelId endLabelIden = makeLabel();
     emplaceJump(endLabelIden);
     emplaceLabel(trueLabelIden);
-    const auto oneVal = std::make_shared<ValueConst>(1);
+    const auto oneVal = makeConstant(1);
     emplaceCopy(oneVal, result, binaryExpr.type->type);
     emplaceLabel(endLabelIden);
     return std::make_unique<PlainOperand>(result);
@@ -876,63 +877,61 @@ std::unique_ptr<ExprResult> GenerateIr::genBinaryPtrInst(const Parsing::BinaryEx
     return genBinarySimpleInst(binaryExpr);
 }
 
-void GenerateIr::binaryPtrSubInst(const std::shared_ptr<Value>& lhs,
-                                  const std::shared_ptr<Value>& rhs,
-                                  const std::shared_ptr<Value>& dst,
-                                  const i64 scale)
+void GenerateIr::binaryPtrSubInst(const ValueId lhs, const ValueId rhs, const ValueId dst, const i64 scale)
 {
-    const auto diff = std::make_shared<ValueVar>(makeTemporaryName(), lhs->type);
+    const ValueId diff = makeTemporary(value(lhs).type);
     emplaceBinary(BinaryInst::Operation::Subtract, lhs, rhs, diff, Type::I64);
-    const auto size = std::make_shared<ValueConst>(scale);
+    const auto size = makeConstant(scale);
     emplaceBinary(BinaryInst::Operation::Divide, diff, size, dst, Type::I64);
 }
 
 std::unique_ptr<ExprResult> GenerateIr::genBinaryPtrSubInst(const Parsing::BinaryExpr& binaryExpr)
 {
-    const std::shared_ptr<Value> lhs = genInstAndConvert(*binaryExpr.lhs);
-    const std::shared_ptr<Value> rhs = genInstAndConvert(*binaryExpr.rhs);
-    auto dst = std::make_shared<ValueVar>(makeTemporaryName(), lhs->type);
-    const i64 scale = getReferencedTypeSize(binaryExpr.lhs->type.get());
+    const ValueId lhs = genInstAndConvert(*binaryExpr.lhs);
+    const ValueId rhs = genInstAndConvert(*binaryExpr.rhs);
+    const ValueId dst = makeTemporary(value(lhs).type);
+    const i64 scale = getReferencedTypeSize(binaryExpr.lhs->type);
     binaryPtrSubInst(lhs, rhs, dst, scale);
     return std::make_unique<PlainOperand>(dst);
 }
 
 std::unique_ptr<ExprResult> GenerateIr::genBinaryPtrAddInst(const Parsing::BinaryExpr& binaryExpr)
 {
-    const std::shared_ptr<Value> ptr = genInstAndConvert(*binaryExpr.lhs);
-    std::shared_ptr<Value> index = genInstAndConvert(*binaryExpr.rhs);
+    const ValueId ptr = genInstAndConvert(*binaryExpr.lhs);
+    ValueId index = genInstAndConvert(*binaryExpr.rhs);
     if (binaryExpr.op == Parsing::BinaryExpr::Operator::Subtract) {
-        const auto dst = std::make_shared<ValueVar>(Identifier(makeTemporaryName()), Type::Pointer);
+        const ValueId dst = makeTemporary(Type::Pointer);
         emplaceUnary(UnaryInst::Operation::Negate, index, dst, Type::Pointer);
         index = dst;
     }
-    const i64 scale = getReferencedTypeSize(binaryExpr.lhs->type.get());
-    auto result = std::make_shared<ValueVar>(makeTemporaryName(), Type::Pointer);
+    const i64 scale = getReferencedTypeSize(binaryExpr.lhs->type);
+    const ValueId result = makeTemporary(Type::Pointer);
     emplaceAddPtr(ptr, index, result, scale);
     return std::make_unique<PlainOperand>(result);
 }
 
 void GenerateIr::genCompoundAssignWithoutDeref(
-    const Parsing::AssignmentExpr& assignmentExpr, std::shared_ptr<Value>& rhs, const std::shared_ptr<Value>& lhs)
+    const Parsing::AssignmentExpr& assignmentExpr, ValueId& rhs, const ValueId lhs)
 {
-    auto temp = std::make_shared<ValueVar>(makeTemporaryName(*lhs), lhs->type);
-    emplaceCopy(lhs, temp, lhs->type);
+    const Type lhsType = value(lhs).type;
+    ValueId temp = makeTemporary(lhs, lhsType);
+    emplaceCopy(lhs, temp, lhsType);
     const BinaryInst::Operation operation = convertBinaryOperation(assignmentExpr.op);
-    const Type leftType = lhs->type;
-    const Type rightType = rhs->type;
+    const Type leftType = lhsType;
+    const Type rightType = value(rhs).type;
     const Type commonType = getCommonType(leftType, rightType);
     if (commonType == Type::Pointer) {
         if (rightType == Type::Pointer && operation == BinaryInst::Operation::Subtract) {
-            const i64 scale = getReferencedTypeSize(assignmentExpr.lhs->type.get());
+            const i64 scale = getReferencedTypeSize(assignmentExpr.lhs->type);
             binaryPtrSubInst(temp, rhs, lhs, scale);
             return;
         }
         if (operation == BinaryInst::Operation::Subtract) {
-            const auto dst = std::make_shared<ValueVar>(Identifier(makeTemporaryName()), Type::Pointer);
+            const ValueId dst = makeTemporary(Type::Pointer);
             emplaceUnary(UnaryInst::Operation::Negate, rhs, dst, Type::Pointer);
             rhs = dst;
         }
-        const i64 scale = getReferencedTypeSize(assignmentExpr.lhs->type.get());
+        const i64 scale = getReferencedTypeSize(assignmentExpr.lhs->type);
         emplaceAddPtr(temp, rhs, lhs, scale);
         return;
     }
@@ -940,19 +939,19 @@ void GenerateIr::genCompoundAssignWithoutDeref(
         temp = castValue(temp, commonType, leftType);
     if (commonType != rightType && !isBitShift(assignmentExpr.op))
         rhs = castValue(rhs, commonType, rightType);
-    if (commonType != lhs->type && !isBitShift(assignmentExpr.op)) {
+    if (commonType != lhsType && !isBitShift(assignmentExpr.op)) {
         emplaceBinary(operation, temp, rhs, temp, commonType);
-        temp = castValue(temp, lhs->type, commonType);
-        emplaceCopy(temp, lhs, lhs->type);
+        temp = castValue(temp, lhsType, commonType);
+        emplaceCopy(temp, lhs, lhsType);
     }
     else
-        emplaceBinary(operation, temp, rhs, lhs, lhs->type);
+        emplaceBinary(operation, temp, rhs, lhs, lhsType);
 }
 
 std::unique_ptr<ExprResult> GenerateIr::genAssignInst(const Parsing::AssignmentExpr& assignmentExpr)
 {
     const std::unique_ptr<ExprResult> lhs = genInst(*assignmentExpr.lhs);
-    std::shared_ptr<Value> rhs = genInstAndConvert(*assignmentExpr.rhs);
+    ValueId rhs = genInstAndConvert(*assignmentExpr.rhs);
     switch (lhs->kind) {
         case ExprResult::Kind::PlainOperand: {
             const auto plainLhs = dynCast<const PlainOperand>(lhs.get());
@@ -966,8 +965,7 @@ std::unique_ptr<ExprResult> GenerateIr::genAssignInst(const Parsing::AssignmentE
         case ExprResult::Kind::DereferencedPointer: {
             const auto derefLhs = dynCast<const DereferencedPointer>(lhs.get());
             if (assignmentExpr.op != Parsing::AssignmentExpr::Operator::Assign) {
-                auto tempLhs = std::make_shared<ValueVar>(
-                    makeTemporaryName(*derefLhs->ptr), assignmentExpr.type->type);
+                const ValueId tempLhs = makeTemporary(derefLhs->ptr, assignmentExpr.type->type);
                 emplaceLoad(derefLhs->ptr, tempLhs, assignmentExpr.type->type);
                 genCompoundAssignWithoutDeref(assignmentExpr, rhs, tempLhs);
                 emplaceStore(tempLhs, derefLhs->ptr, assignmentExpr.type->type);
@@ -982,30 +980,29 @@ std::unique_ptr<ExprResult> GenerateIr::genAssignInst(const Parsing::AssignmentE
 
 std::unique_ptr<ExprResult> GenerateIr::genConstPlainOperand(const Parsing::ConstExpr& constExpr)
 {
-    const std::shared_ptr<Value> result = genConstValue(constExpr);
+    const ValueId result = intern(genConstValue(constExpr));
     return std::make_unique<PlainOperand>(result);
 }
 
 std::unique_ptr<ExprResult> GenerateIr::genStringPlainOperand(const Parsing::StringExpr& stringExpr)
 {
-    const Identifier iden = makeTemporaryName("string.");
-    m_topLevels.emplace_back(std::make_unique<StaticConstant>(iden, stringExpr.value, false, true));
-    auto valueVar = std::make_shared<ValueVar>(iden, Type::Pointer);
-    valueVar->referingTo = ReferingTo::Static;
+    const Identifier iden(Symbol::derive(m_temporaryBase, m_temporaryCounter++, ".string"));
+    m_topLevels.emplace_back(std::make_unique<StaticConstant>(iden, std::string(stringExpr.value), false, true));
+    const ValueId valueVar = intern(Value(iden, Type::Pointer, ReferingTo::Static, 0));
     return std::make_unique<PlainOperand>(valueVar);
 }
 
-std::shared_ptr<Value> genConstValue(const Parsing::ConstExpr& constExpr)
+Value genConstValue(const Parsing::ConstExpr& constExpr)
 {
     switch (constExpr.type->type) {
-        case Type::I8:          return std::make_shared<ValueConst>(std::get<i8>(constExpr.value));
-        case Type::U8:          return std::make_shared<ValueConst>(std::get<u8>(constExpr.value));
-        case Type::Char:        return std::make_shared<ValueConst>(std::get<char>(constExpr.value));
-        case Type::I32:         return std::make_shared<ValueConst>(std::get<i32>(constExpr.value));
-        case Type::U32:         return std::make_shared<ValueConst>(std::get<u32>(constExpr.value));
-        case Type::I64:         return std::make_shared<ValueConst>(std::get<i64>(constExpr.value));
-        case Type::U64:         return std::make_shared<ValueConst>(std::get<u64>(constExpr.value));
-        case Type::Double:      return std::make_shared<ValueConst>(std::get<double>(constExpr.value));
+        case Type::I8:          return Value(std::get<i8>(constExpr.value));
+        case Type::U8:          return Value(std::get<u8>(constExpr.value));
+        case Type::Char:        return Value(std::get<char>(constExpr.value));
+        case Type::I32:         return Value(std::get<i32>(constExpr.value));
+        case Type::U32:         return Value(std::get<u32>(constExpr.value));
+        case Type::I64:         return Value(std::get<i64>(constExpr.value));
+        case Type::U64:         return Value(std::get<u64>(constExpr.value));
+        case Type::Double:      return Value(std::get<double>(constExpr.value));
         default:
             std::abort();
     }
@@ -1013,23 +1010,23 @@ std::shared_ptr<Value> genConstValue(const Parsing::ConstExpr& constExpr)
 
 std::unique_ptr<ExprResult> GenerateIr::genTernaryInst(const Parsing::TernaryExpr& ternaryExpr)
 {
-    auto result = std::make_shared<ValueVar>(makeTemporaryName(), ternaryExpr.type->type);
-    const Identifier endLabelIden = makeTemporaryName();
-    const Identifier falseLabelName = makeTemporaryName();
+    const ValueId result = makeTemporary(ternaryExpr.type->type);
+    const LabelId endLabelIden = makeLabel();
+    const LabelId falseLabelName = makeLabel();
     const auto conditionalExpr = dynCast<const Parsing::TernaryExpr>(&ternaryExpr);
 
-    const std::shared_ptr<Value> condition = genInstAndConvert(*conditionalExpr->condition);
+    const ValueId condition = genInstAndConvert(*conditionalExpr->condition);
     emplaceJumpIfZero(condition, falseLabelName);
 
-    const std::shared_ptr<Value> trueValue = genInstAndConvert(*conditionalExpr->trueExpr);
-    if (trueValue->type != Type::Void)
-        emplaceCopy(trueValue, result, trueValue->type);
+    const ValueId trueValue = genInstAndConvert(*conditionalExpr->trueExpr);
+    if (value(trueValue).type != Type::Void)
+        emplaceCopy(trueValue, result, value(trueValue).type);
     emplaceJump(endLabelIden);
 
     emplaceLabel(falseLabelName);
-    const std::shared_ptr<Value> falseValue = genInstAndConvert(*conditionalExpr->falseExpr);
-    if (falseValue->type != Type::Void)
-        emplaceCopy(falseValue, result, falseValue->type);
+    const ValueId falseValue = genInstAndConvert(*conditionalExpr->falseExpr);
+    if (value(falseValue).type != Type::Void)
+        emplaceCopy(falseValue, result, value(falseValue).type);
 
     emplaceLabel(endLabelIden);
     return std::make_unique<PlainOperand>(result);
@@ -1037,25 +1034,25 @@ std::unique_ptr<ExprResult> GenerateIr::genTernaryInst(const Parsing::TernaryExp
 
 std::unique_ptr<ExprResult> GenerateIr::genFuncCallInst(const Parsing::FuncCallExpr& funcCallExpr)
 {
-    std::vector<std::shared_ptr<Value>> arguments;
+    std::vector<ValueId> arguments;
     arguments.reserve(funcCallExpr.args.size());
     for (const auto& expr : funcCallExpr.args) {
-        const std::shared_ptr<Value> arg = genInstAndConvert(*expr);
+        const ValueId arg = genInstAndConvert(*expr);
         arguments.emplace_back(arg);
     }
     if (funcCallExpr.type->type == Type::Void) {
-        auto dst = std::make_shared<ValueVar>(makeTemporaryName(), Type::Void);
-        emplaceFunCall(Identifier(funcCallExpr.name), std::move(arguments), Type::Void);
+        const ValueId dst = makeTemporary(Type::Void);
+        emplaceFunCall(Identifier(funcCallExpr.name), arguments, ValueId::None, Type::Void);
         return std::make_unique<PlainOperand>(dst);
     }
     if (funcCallExpr.type->type != Type::Pointer) {
-        const auto returnType = dynCast<const Parsing::VarType>(funcCallExpr.type.get());
-        auto dst = std::make_shared<ValueVar>(makeTemporaryName(), funcCallExpr.type->type);
-        emplaceFunCall(Identifier(funcCallExpr.name), std::move(arguments), dst, returnType->type);
+        const auto returnType = dynCast<const Parsing::VarType>(funcCallExpr.type);
+        const ValueId dst = makeTemporary(funcCallExpr.type->type);
+        emplaceFunCall(Identifier(funcCallExpr.name), arguments, dst, returnType->type);
         return std::make_unique<PlainOperand>(dst);
     }
-    auto dst = std::make_shared<ValueVar>(makeTemporaryName(), funcCallExpr.type->type);
-    emplaceFunCall(Identifier(funcCallExpr.name), std::move(arguments), dst, Type::Pointer);
+    const ValueId dst = makeTemporary(funcCallExpr.type->type);
+    emplaceFunCall(Identifier(funcCallExpr.name), arguments, dst, Type::Pointer);
     return std::make_unique<PlainOperand>(dst);
 }
 
@@ -1069,8 +1066,7 @@ std::unique_ptr<ExprResult> GenerateIr::genAddrOfInst(const Parsing::AddrOffExpr
     switch (inner->kind) {
         case ExprResult::Kind::PlainOperand: {
             const auto plainOperand = dynCast<const PlainOperand>(inner.get());
-            Identifier dstIden = makeTemporaryName();
-            std::shared_ptr<Value> dst = std::make_shared<ValueVar>(dstIden, Type::Pointer);
+            const ValueId dst = makeTemporary(Type::Pointer);
             emplaceGetAddress(plainOperand->value, dst, Type::Pointer);
             return std::make_unique<PlainOperand>(dst);
         }
@@ -1082,7 +1078,7 @@ std::unique_ptr<ExprResult> GenerateIr::genAddrOfInst(const Parsing::AddrOffExpr
     std::unreachable();
 }
 
-i64 getTypeOfSize(Parsing::TypeBase* typeBase)
+i64 getTypeOfSize(const Parsing::TypeBase* typeBase)
 {
     switch (typeBase->kind) {
         case Parsing::TypeBase::Kind::Pointer:
@@ -1094,14 +1090,14 @@ i64 getTypeOfSize(Parsing::TypeBase* typeBase)
     }
 }
 
-i64 getReferencedTypeSize(Parsing::TypeBase* typeBase)
+i64 getReferencedTypeSize(const Parsing::TypeBase* typeBase)
 {
     std::vector<i64> scales;
     while (typeBase->kind != Parsing::TypeBase::Kind::Var) {
         switch (typeBase->kind) {
             case Parsing::TypeBase::Kind::Pointer: {
                 const auto ptrType = dynCast<const Parsing::PointerType>(typeBase);
-                typeBase = ptrType->referenced.get();
+                typeBase = ptrType->referenced;
                 if (typeBase->type == Type::Pointer) {
                     i64 scale = 8;
                     for (const i64 i : scales)
@@ -1111,9 +1107,9 @@ i64 getReferencedTypeSize(Parsing::TypeBase* typeBase)
                 break;
             }
             case Parsing::TypeBase::Kind::Array: {
-                const auto arrayType = dynCast<Parsing::ArrayType>(typeBase);
+                const auto arrayType = dynCast<const Parsing::ArrayType>(typeBase);
                 scales.emplace_back(arrayType->size);
-                typeBase = arrayType->elementType.get();
+                typeBase = arrayType->elementType;
                 break;
             }
             default:
@@ -1126,15 +1122,15 @@ i64 getReferencedTypeSize(Parsing::TypeBase* typeBase)
     return scale;
 }
 
-Type getSubscriptDereferenceType(Parsing::TypeBase* typeBase)
+Type getSubscriptDereferenceType(const Parsing::TypeBase* typeBase)
 {
     switch (typeBase->kind) {
         case Parsing::TypeBase::Kind::Pointer: {
-            const auto ptrType = dynCast<Parsing::PointerType>(typeBase);
+            const auto ptrType = dynCast<const Parsing::PointerType>(typeBase);
             return ptrType->referenced->type;
         }
         case Parsing::TypeBase::Kind::Array: {
-            const auto arrayType = dynCast<Parsing::ArrayType>(typeBase);
+            const auto arrayType = dynCast<const Parsing::ArrayType>(typeBase);
             return arrayType->elementType->type;
         }
         default:
@@ -1144,19 +1140,19 @@ Type getSubscriptDereferenceType(Parsing::TypeBase* typeBase)
 
 std::unique_ptr<ExprResult> GenerateIr::genSubscriptInst(const Parsing::SubscriptExpr& subscriptExpr)
 {
-    const std::shared_ptr<Value> ptr = genInstAndConvert(*subscriptExpr.referencing);
-    const std::shared_ptr<Value> index = genInstAndConvert(*subscriptExpr.index);
-    Parsing::TypeBase* referencedType = subscriptExpr.referencing->type.get();
+    const ValueId ptr = genInstAndConvert(*subscriptExpr.referencing);
+    const ValueId index = genInstAndConvert(*subscriptExpr.index);
+    const Parsing::TypeBase* referencedType = subscriptExpr.referencing->type;
     const i64 scale = getReferencedTypeSize(referencedType);
-    auto result = std::make_shared<ValueVar>(makeTemporaryName(), Type::Pointer);
+    const ValueId result = makeTemporary(Type::Pointer);
     emplaceAddPtr(ptr, index, result, scale);
     return std::make_unique<DereferencedPointer>(
-        result, getSubscriptDereferenceType(subscriptExpr.referencing->type.get()));
+        result, getSubscriptDereferenceType(subscriptExpr.referencing->type));
 }
 
 std::unique_ptr<ExprResult> GenerateIr::genDereferenceInst(const Parsing::DereferenceExpr& dereferenceExpr)
 {
-    std::shared_ptr<Value> result = genInstAndConvert(*dereferenceExpr.reference);
+    ValueId result = genInstAndConvert(*dereferenceExpr.reference);
     return std::make_unique<DereferencedPointer>(result, dereferenceExpr.type->type);
 }
 
@@ -1164,46 +1160,61 @@ std::unique_ptr<ExprResult> GenerateIr::genSizeOfExprInst(const Parsing::SizeOfE
 {
     if (sizeOfExprExpr.innerExpr->kind == Parsing::Expr::Kind::Constant) {
         if (sizeOfExprExpr.innerExpr->type->kind == Parsing::TypeBase::Kind::Var) {
-            const auto varType = dynCast<const Parsing::VarType>(sizeOfExprExpr.innerExpr->type.get());
+            const auto varType = dynCast<const Parsing::VarType>(sizeOfExprExpr.innerExpr->type);
             if (varType->type == Type::Char) {
-                const auto valueSize = std::make_shared<ValueConst>(4l);
+                const auto valueSize = makeConstant(4l);
                 return std::make_unique<PlainOperand>(valueSize);
             }
         }
     }
-    const i64 size = getTypeOfSize(sizeOfExprExpr.innerExpr->type.get());
-    const auto valueSize = std::make_shared<ValueConst>(size);
+    const i64 size = getTypeOfSize(sizeOfExprExpr.innerExpr->type);
+    const auto valueSize = makeConstant(size);
     return std::make_unique<PlainOperand>(valueSize);
 }
 
 std::unique_ptr<ExprResult> GenerateIr::genSizeOfTypeInst(const Parsing::SizeOfTypeExpr& sizeOfTypeExpr)
 {
-    const i64 size = getTypeOfSize(sizeOfTypeExpr.sizeType.get());
-    const auto valueSize = std::make_shared<ValueConst>(size);
+    const i64 size = getTypeOfSize(sizeOfTypeExpr.sizeType);
+    const auto valueSize = makeConstant(size);
     return std::make_unique<PlainOperand>(valueSize);
 }
 
-Identifier makeTemporaryName()
+Identifier GenerateIr::makeTemporaryName()
 {
-    return makeTemporaryName("");
+    return makeTemporaryName(m_temporaryBase);
 }
 
-Identifier makeTemporaryName(Value& value)
+Identifier GenerateIr::makeTemporaryName(const Symbol name)
 {
-    if (value.kind == Value::Kind::Variable) {
-        const auto val = dynCast<ValueVar>(&value);
-        return makeTemporaryName(val->value.value);
-    }
-    return makeTemporaryName("");
+    return {Symbol::derive(name, m_temporaryCounter++)};
+}
+
+ValueId GenerateIr::makeTemporary(const Type type)
+{
+    return m_function->addValue(Value(makeTemporaryName(), type));
+}
+
+ValueId GenerateIr::makeTemporary(const ValueId base, const Type type)
+{
+    const Value& baseValue = value(base);
+    const Symbol name = baseValue.isVariable() ? baseValue.name : m_temporaryBase;
+    return m_function->addValue(Value(makeTemporaryName(name), type));
+}
+
+ValueId GenerateIr::intern(const Value& value)
+{
+    const auto [it, inserted] = m_valueIds.try_emplace(value, ValueId::None);
+    if (inserted)
+        it->second = m_function->addValue(value);
+    return it->second;
 }
 
-Identifier makeTemporaryName(const std::string& name)
+LabelId GenerateIr::namedLabel(const std::string_view name)
 {
-    static i64 id = 0;
-    std::string prefix = name;
-    prefix += '.';
-    prefix += std::to_string(id++);
-    return {prefix};
+    const auto [it, inserted] = m_labelIds.try_emplace(std::string(name), LabelId{});
+    if (inserted)
+        it->second = makeLabel();
+    return it->second;
 }
 
 static std::string generateCaseLabelName(std::string before)
@@ -1212,12 +1223,12 @@ static std::string generateCaseLabelName(std::string before)
     return before;
 }
 
-std::shared_ptr<ValueConst> getInrDecScale(const Parsing::UnaryExpr& unaryExpr, Type type)
+ValueId GenerateIr::incDecScale(const Parsing::UnaryExpr& unaryExpr, const Type type)
 {
     if (type == Type::Pointer)
-        return std::make_shared<ValueConst>(getReferencedTypeSize(unaryExpr.innerExpr->type.get()));
+        return makeConstant(getReferencedTypeSize(unaryExpr.innerExpr->type));
     if (type == Type::Double)
-        return std::make_shared<ValueConst>(1.0);
-    return std::make_shared<ValueConst>(1);
+        return makeConstant(1.0);
+    return makeConstant(1);
 }
 } // IR
\ No newline at end of file
@@ -1,47 +1,61 @@
 #pragma once
 
 #include "ASTParser.hpp"
+#include "Error.hpp"
 #include "SymbolTable.hpp"
 #include "ExprResult.hpp"
 
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 
 namespace Ir {
 class GenerateIr {
     using Storage = Parsing::Declaration::StorageClass;
 
     bool m_global = true;
-    std::vector<std::unique_ptr<Instruction>> m_insts;
+    // Values and instructions of file scope initializers land in m_fileScope, those of a
+    // function body in the function being generated.
+    Function m_fileScope{Identifier{}, false};
+    Function* m_function = &m_fileScope;
+    std::unordered_map<Value, ValueId, ValueHash> m_valueIds;
+    std::unordered_map<std::string, LabelId> m_labelIds;
     SymbolTable& m_symbolTable;
-    std::unordered_set<std::string> m_writtenGlobals;
+    std::unordered_set<Symbol> m_writtenGlobals;
     std::vector<std::unique_ptr<TopLevel>> m_topLevels;
+    Symbol m_temporaryBase;
+    i64 m_temporaryCounter = 0;
+    std::vector<Error> m_errors;
 public:
     explicit GenerateIr(SymbolTable& symbolTable)
         : m_symbolTable(symbolTable) {}
     void program(const Parsing::Program& parsingProgram, Program& tackyProgram);
+    // The top levels of one declaration: the string literals and static locals of a function
+    // come first, then the function itself.
+    [[nodiscard]] std::vector<std::unique_ptr<TopLevel>> declarationIr(const Parsing::Declaration& decl);
     std::unique_ptr<TopLevel> topLevelIr(const Parsing::Declaration& decl);
     std::unique_ptr<TopLevel> functionIr(const Parsing::FuncDeclaration& parsingFunction);
+    // Initializers of static storage that did not lower to a constant, the backend cannot emit those.
+    [[nodiscard]] std::vector<Error> takeErrors() { return std::exchange(m_errors, {}); }
 
     std::unique_ptr<TopLevel> staticVariableIr(const Parsing::VarDecl& varDecl);
     std::unique_ptr<TopLevel> genStaticArray(const Parsing::VarDecl& varDecl, bool defined);
     std::unique_ptr<TopLevel> genStaticInit(const Parsing::VarDecl& varDecl, bool defined);
     std::vector<std::unique_ptr<Initializer>> genStaticArrayInit(const Parsing::VarDecl& varDecl, bool defined);
-    std::shared_ptr<Value> genStaticVariableInit(const Parsing::VarDecl& varDecl, bool defined);
+    Value genStaticVariableInit(const Parsing::VarDecl& varDecl, bool defined);
+    Value genStaticSingleInit(const Parsing::Expr& expr);
 
     void genBlock(const Parsing::Block& block);
     void genBlockItem(const Parsing::BlockItem& blockItem);
     void genSingleDeclaration(const Parsing::VarDecl& varDecl);
-    void genZeroLocalInit(const std::string& name,
+    void genZeroLocalInit(Symbol name,
                           Type type,
-                          i64 arraySize,
-                          i64 alignment,
                           i64 lengthZeroInit,
                           i64& offset,
-                          const std::shared_ptr<Value>& zeroConst);
-    void genSingleLocalInit(const std::string& name,
+                          ValueId zeroConst);
+    void genSingleLocalInit(Symbol name,
                             Type type,
-                            i64 arraySize,
-                            i64 alignment,
                             i64& offset,
                             const Parsing::SingleInitializer& singleInit);
 
@@ -68,10 +82,10 @@ public:
     void genSwitchStmt(const Parsing::SwitchStmt& stmt);
 
     std::unique_ptr<ExprResult> genInst(const Parsing::Expr& parsingExpr);
-    std::shared_ptr<Value> genInstAndConvert(const Parsing::Expr& parsingExpr);
-    std::shared_ptr<ValueVar> castValue(const std::shared_ptr<Value>& result, Type towards, Type from);
+    ValueId genInstAndConvert(const Parsing::Expr& parsingExpr);
+    ValueId castValue(ValueId result, Type towards, Type from);
 
-    static std::unique_ptr<ExprResult> genConstPlainOperand(const Parsing::ConstExpr& constExpr);
+    std::unique_ptr<ExprResult> genConstPlainOperand(const Parsing::ConstExpr& constExpr);
     std::unique_ptr<ExprResult> genStringPlainOperand(const Parsing::StringExpr& stringExpr);
     std::unique_ptr<ExprResult> genCastInst(const Parsing::CastExpr& castExpr);
     std::unique_ptr<ExprResult> genUnaryInst(const Parsing::UnaryExpr& unaryExpr);
@@ -85,147 +99,144 @@ public:
     std::unique_ptr<ExprResult> genBinaryOrInst(const Parsing::BinaryExpr& binaryExpr);
     std::unique_ptr<ExprResult> genBinaryPtrInst(const Parsing::BinaryExpr& binaryExpr);
     std::unique_ptr<ExprResult> genBinaryPtrAddInst(const Parsing::BinaryExpr& binaryExpr);
-    void binaryPtrSubInst(const std::shared_ptr<Value>& lhs,
-                          const std::shared_ptr<Value>& rhs,
-                          const std::shared_ptr<Value>& dst,
-                          i64 scale);
+    void binaryPtrSubInst(ValueId lhs, ValueId rhs, ValueId dst, i64 scale);
     std::unique_ptr<ExprResult> genBinaryPtrSubInst(const Parsing::BinaryExpr& binaryExpr);
 
     std::unique_ptr<ExprResult> genAssignInst(const Parsing::AssignmentExpr& assignmentExpr);
     void genCompoundAssignWithoutDeref(const Parsing::AssignmentExpr& assignmentExpr,
-                                       std::shared_ptr<Value>& rhs,
-                                       const std::shared_ptr<Value>& lhs);
+                                       ValueId& rhs,
+                                       ValueId lhs);
     std::unique_ptr<ExprResult> genTernaryInst(const Parsing::TernaryExpr& ternaryExpr);
     std::unique_ptr<ExprResult> genFuncCallInst(const Parsing::FuncCallExpr& funcCallExpr);
     std::unique_ptr<ExprResult> genAddrOfInst(const Parsing::AddrOffExpr& addrOffExpr);
     std::unique_ptr<ExprResult> genSubscriptInst(const Parsing::SubscriptExpr& subscriptExpr);
     std::unique_ptr<ExprResult> genDereferenceInst(const Parsing::DereferenceExpr& dereferenceExpr);
-    static std::unique_ptr<ExprResult> genSizeOfExprInst(const Parsing::SizeOfExprExpr& sizeOfExprExpr);
-    static std::unique_ptr<ExprResult> genSizeOfTypeInst(const Parsing::SizeOfTypeExpr& sizeOfTypeExpr);
-    static std::unique_ptr<ExprResult> genVarInst(const Parsing::VarExpr& varExpr);
+    std::unique_ptr<ExprResult> genSizeOfExprInst(const Parsing::SizeOfExprExpr& sizeOfExprExpr);
+    std::unique_ptr<ExprResult> genSizeOfTypeInst(const Parsing::SizeOfTypeExpr& sizeOfTypeExpr);
+    std::unique_ptr<ExprResult> genVarInst(const Parsing::VarExpr& varExpr);
 
 private:
+    Identifier makeTemporaryName();
+    Identifier makeTemporaryName(Symbol name);
+    ValueId makeTemporary(Type type);
+    ValueId makeTemporary(ValueId base, Type type);
+    ValueId intern(const Value& value);
+    template<typename T>
+    ValueId makeConstant(const T constant) { return intern(Value(constant)); }
+    [[nodiscard]] const Value& value(const ValueId id) const { return m_function->value(id); }
+    LabelId makeLabel() { return m_function->addLabel(); }
+    LabelId namedLabel(std::string_view name);
+    ValueId incDecScale(const Parsing::UnaryExpr& unaryExpr, Type type);
     void allocateLocalArrayWithoutInitializer(const Parsing::VarDecl& varDecl);
-    void directlyPushConstant32Bit(const Parsing::VarDecl& varDecl, const std::shared_ptr<Value>& value);
+    void directlyPushConstant32Bit(const Parsing::VarDecl& varDecl, ValueId value);
 
+    template<typename T, typename... Args>
+    void emplace(Args&&... args)
+    {
+        m_function->insts.push_back(m_function->make<T>(std::forward<Args>(args)...));
+    }
     void emplaceReturn()
     {
-        m_insts.emplace_back(std::make_unique<ReturnInst>(Type::Void));
+        emplace<ReturnInst>(Type::Void);
     }
-    void emplaceReturn(const std::shared_ptr<Value>& src, const Type type)
+    void emplaceReturn(const ValueId src, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<ReturnInst>(src, type));
+        emplace<ReturnInst>(src, type);
     }
-    void emplaceSignExtend(const std::shared_ptr<Value>& src, const std::shared_ptr<Value>& dst, const Type type)
+    void emplaceSignExtend(const ValueId src, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<SignExtendInst>(src, dst, type));
+        emplace<SignExtendInst>(src, dst, type);
     }
-    void emplaceTruncate(const std::shared_ptr<Value>& src, const std::shared_ptr<Value>& dst, const Type type)
+    void emplaceTruncate(const ValueId src, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<TruncateInst>(src, dst, type));
+        emplace<TruncateInst>(src, dst, type);
     }
-    void emplaceZeroExtend(const std::shared_ptr<Value>& src, const std::shared_ptr<Value>& dst, const Type type)
+    void emplaceZeroExtend(const ValueId src, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<ZeroExtendInst>(src, dst, type));
+        emplace<ZeroExtendInst>(src, dst, type);
     }
-    void emplaceDoubleToInt(const std::shared_ptr<Value>& src, const std::shared_ptr<Value>& dst, const Type type)
+    void emplaceDoubleToInt(const ValueId src, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<DoubleToIntInst>(src, dst, type));
+        emplace<DoubleToIntInst>(src, dst, type);
     }
-    void emplaceDoubleToUInt(const std::shared_ptr<Value>& src, const std::shared_ptr<Value>& dst, const Type type)
+    void emplaceDoubleToUInt(const ValueId src, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<DoubleToUIntInst>(src, dst, type));
+        emplace<DoubleToUIntInst>(src, dst, type);
     }
-    void emplaceIntToDouble(const std::shared_ptr<Value>& src, const std::shared_ptr<Value>& dst, const Type type)
+    void emplaceIntToDouble(const ValueId src, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<IntToDoubleInst>(src, dst, type));
+        emplace<IntToDoubleInst>(src, dst, type);
     }
-    void emplaceUIntToDouble(const std::shared_ptr<Value>& src, const std::shared_ptr<Value>& dst, const Type type)
+    void emplaceUIntToDouble(const ValueId src, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<UIntToDoubleInst>(src, dst, type));
+        emplace<UIntToDoubleInst>(src, dst, type);
     }
-    void emplaceUnary(const UnaryInst::Operation oper, const std::shared_ptr<Value>& src,
-                      const std::shared_ptr<Value>& dst, const Type type)
+    void emplaceCopy(const ValueId src, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<UnaryInst>(oper, src, dst, type));
+        emplace<CopyInst>(src, dst, type);
     }
-    void emplaceBinary(const BinaryInst::Operation oper,
-                       const std::shared_ptr<Value>& lhs,
-                       const std::shared_ptr<Value>& rhs,
-                       const std::shared_ptr<Value>& dst,
-                       const Type type)
+    void emplaceGetAddress(const ValueId src, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<BinaryInst>(oper, lhs, rhs, dst, type));
+        emplace<GetAddressInst>(src, dst, type);
     }
-    void emplaceCopy(const std::shared_ptr<Value>& src, const std::shared_ptr<Value>& dst, const Type type)
+    void emplaceLoad(const ValueId src, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<CopyInst>(src, dst, type));
+        emplace<LoadInst>(src, dst, type);
     }
-    void emplaceGetAddress(const std::shared_ptr<Value>& src,
-                           const std::shared_ptr<Value>& dst,
-                           const Type type)
+    void emplaceStore(const ValueId src, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<GetAddressInst>(src, dst, type));
+        emplace<StoreInst>(src, dst, type);
     }
-    void emplaceLoad(const std::shared_ptr<Value>& src, const std::shared_ptr<Value>& dst, const Type type)
+    void emplaceUnary(const UnaryInst::Operation oper, const ValueId src, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<LoadInst>(src, dst, type));
+        emplace<UnaryInst>(oper, src, dst, type);
     }
-    void emplaceStore(const std::shared_ptr<Value>& src, const std::shared_ptr<Value>& dst, const Type type)
+    void emplaceBinary(const BinaryInst::Operation oper,
+                       const ValueId lhs,
+                       const ValueId rhs,
+                       const ValueId dst,
+                       const Type type)
     {
-        m_insts.emplace_back(std::make_unique<StoreInst>(src, dst, type));
+        emplace<BinaryInst>(oper, lhs, rhs, dst, type);
     }
-    void emplaceAddPtr(const std::shared_ptr<Value>& ptr,
-                       const std::shared_ptr<Value>& index,
-                       const std::shared_ptr<Value>& dst,
-                       const i64 scale)
+    void emplaceAddPtr(const ValueId ptr, const ValueId index, const ValueId dst, const i64 scale)
     {
-        m_insts.emplace_back(std::make_unique<AddPtrInst>(ptr, index, dst, scale));
+        emplace<AddPtrInst>(ptr, index, dst, scale);
     }
-    void emplaceCopyToOffset(const std::shared_ptr<Value>& src,
-                             const Identifier& iden,
+    void emplaceCopyToOffset(const ValueId src,
+                             const Identifier iden,
                              const i64 offset,
-                             const i64 arraySize,
-                             const i64 alignment,
                              const Type type)
     {
-        m_insts.emplace_back(std::make_unique<CopyToOffsetInst>(src, iden, offset, arraySize, alignment, type));
-    }
-    void emplaceJump(const Identifier& iden)
-    {
-        m_insts.emplace_back(std::make_unique<JumpInst>(iden));
+        emplace<CopyToOffsetInst>(src, iden, offset, type);
     }
-    void emplaceJumpIfZero(const std::shared_ptr<Value>& src, const Identifier& iden)
+    void emplaceJump(const LabelId target)
     {
-        m_insts.emplace_back(std::make_unique<JumpIfZeroInst>(src, iden));
+        emplace<JumpInst>(target);
     }
-    void emplaceJumpIfNotZero(const std::shared_ptr<Value>& src, const Identifier& iden)
+    void emplaceJumpIfZero(const ValueId condition, const LabelId target)
     {
-        m_insts.emplace_back(std::make_unique<JumpIfNotZeroInst>(src, iden));
+        emplace<JumpIfZeroInst>(condition, target, value(condition).type);
     }
-    void emplaceLabel(const Identifier& iden)
+    void emplaceJumpIfNotZero(const ValueId condition, const LabelId target)
     {
-        m_insts.emplace_back(std::make_unique<LabelInst>(iden));
+        emplace<JumpIfNotZeroInst>(condition, target, value(condition).type);
     }
-    void emplaceFunCall(const Identifier& iden,
-                    std::vector<std::shared_ptr<Value>>&& src,
-                    const Type type)
+    void emplaceLabel(const LabelId target)
     {
-        m_insts.emplace_back(std::make_unique<FunCallInst>(iden, src, type));
+        emplace<LabelInst>(target);
     }
-    void emplaceFunCall(const Identifier& iden,
-                        std::vector<std::shared_ptr<Value>>&& src,
-                        const std::shared_ptr<Value>& dst,
-                        const Type type)
+    void emplaceFunCall(const Identifier iden, const std::vector<ValueId>& args, const ValueId dst, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<FunCallInst>(iden, src, dst, type));
+        const auto firstArg = static_cast<u32>(m_function->callArgs.size());
+        m_function->callArgs.insert(m_function->callArgs.end(), args.begin(), args.end());
+        emplace<FunCallInst>(iden, firstArg, static_cast<u32>(args.size()), dst, type);
     }
-    void emplaceAllocate(const i64 size, const std::string& iden, const Type type)
+    void emplaceAllocate(const i64 size, const Symbol iden, const Type type)
     {
-        m_insts.emplace_back(std::make_unique<AllocateInst>(size, Identifier(iden), type));
+        emplace<AllocateInst>(size, Identifier(iden), type);
     }
 };
 
-i64 getReferencedTypeSize(Parsing::TypeBase* typeBase);
-std::shared_ptr<ValueConst> getInrDecScale(const Parsing::UnaryExpr& unaryExpr, Type type);
+i64 getReferencedTypeSize(const Parsing::TypeBase* typeBase);
 } // IR
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <bit>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Scanners returning the first position at or after pos whose character no longer belongs
+// to the run. Full vectors are classified at once, the remaining tail is done per character.
+namespace Lexing::CharScan {
+
+[[nodiscard]] constexpr bool isWhitespace(const char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+}
+
+[[nodiscard]] constexpr bool isDigit(const char ch)
+{
+    return '0' <= ch && ch <= '9';
+}
+
+[[nodiscard]] constexpr bool isIdentifierChar(const char ch)
+{
+    return ('a' <= ch && ch <= 'z') || ('A' <= ch && ch <= 'Z') || isDigit(ch) || ch == '_';
+}
+
+#if defined(__AVX2__)
+using Vector = __m256i;
+constexpr size_t vectorSize = 32;
+inline Vector load(const char* ptr) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)); }
+inline Vector splat(const char ch) { return _mm256_set1_epi8(ch); }
+inline Vector equal(const Vector a, const Vector b) { return _mm256_cmpeq_epi8(a, b); }
+inline Vector greater(const Vector a, const Vector b) { return _mm256_cmpgt_epi8(a, b); }
+inline Vector bitOr(const Vector a, const Vector b) { return _mm256_or_si256(a, b); }
+inline Vector bitAnd(const Vector a, const Vector b) { return _mm256_and_si256(a, b); }
+inline u32 mask(const Vector v) { return static_cast<u32>(_mm256_movemask_epi8(v)); }
+#elif defined(__SSE2__)
+using Vector = __m128i;
+constexpr size_t vectorSize = 16;
+inline Vector load(const char* ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+inline Vector splat(const char ch) { return _mm_set1_epi8(ch); }
+inline Vector equal(const Vector a, const Vector b) { return _mm_cmpeq_epi8(a, b); }
+inline Vector greater(const Vector a, const Vector b) { return _mm_cmpgt_epi8(a, b); }
+inline Vector bitOr(const Vector a, const Vector b) { return _mm_or_si128(a, b); }
+inline Vector bitAnd(const Vector a, const Vector b) { return _mm_and_si128(a, b); }
+inline u32 mask(const Vector v) { return static_cast<u32>(_mm_movemask_epi8(v)); }
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+constexpr u32 fullMask = vectorSize == 32 ? UINT32_MAX : 0xFFFF;
+
+// Signed byte compares are fine here, bytes above 0x7F are negative and fall outside every range.
+inline Vector inRange(const Vector chars, const char low, const char high)
+{
+    return bitAnd(greater(chars, splat(static_cast<char>(low - 1))),
+                  greater(splat(static_cast<char>(high + 1)), chars));
+}
+#endif
+
+struct Whitespace {
+    [[nodiscard]] static bool matches(const char ch) { return isWhitespace(ch); }
+#if defined(__AVX2__) || defined(__SSE2__)
+    [[nodiscard]] static u32 matches(const Vector chars)
+    {
+        return mask(bitOr(bitOr(equal(chars, splat(' ')), equal(chars, splat('\t'))),
+                          bitOr(equal(chars, splat('\r')), equal(chars, splat('\n')))));
+    }
+#endif
+};
+
+struct Digit {
+    [[nodiscard]] static bool matches(const char ch) { return isDigit(ch); }
+#if defined(__AVX2__) || defined(__SSE2__)
+    [[nodiscard]] static u32 matches(const Vector chars) { return mask(inRange(chars, '0', '9')); }
+#endif
+};
+
+struct IdentifierChar {
+    [[nodiscard]] static bool matches(const char ch) { return isIdentifierChar(ch); }
+#if defined(__AVX2__) || defined(__SSE2__)
+    [[nodiscard]] static u32 matches(const Vector chars)
+    {
+        const Vector lower = bitOr(chars, splat(0x20));
+        return mask(bitOr(bitOr(inRange(lower, 'a', 'z'), inRange(chars, '0', '9')),
+                          equal(chars, splat('_'))));
+    }
+#endif
+};
+
+template<typename CharClass>
+[[nodiscard]] size_t scanWhile(const char* data, size_t pos, const size_t size)
+{
+#if defined(__AVX2__) || defined(__SSE2__)
+    while (pos + vectorSize <= size) {
+        if (const u32 bits = CharClass::matches(load(data + pos)); bits != fullMask)
+            return pos + static_cast<size_t>(std::countr_one(bits));
+        pos += vectorSize;
+    }
+#endif
+    while (pos < size && CharClass::matches(data[pos]))
+        ++pos;
+    return pos;
+}
+
+[[nodiscard]] inline size_t skipWhitespace(const char* data, const size_t pos, const size_t size)
+{
+    return scanWhile<Whitespace>(data, pos, size);
+}
+
+[[nodiscard]] inline size_t identifierEnd(const char* data, const size_t pos, const size_t size)
+{
+    return scanWhile<IdentifierChar>(data, pos, size);
+}
+
+[[nodiscard]] inline size_t digitsEnd(const char* data, const size_t pos, const size_t size)
+{
+    return scanWhile<Digit>(data, pos, size);
+}
+
+} // Lexing::CharScan
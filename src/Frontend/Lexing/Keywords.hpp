@@ -0,0 +1,97 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+#include "Token.hpp"
+
+#include <array>
+#include <string_view>
+
+// Keyword recognition through a perfect hash whose seed is searched for at compile time.
+// A lookup hashes the length and three characters, then does a single string compare.
+namespace Lexing::Keywords {
+
+struct Keyword {
+    std::string_view text;
+    Token::Type type;
+};
+
+inline constexpr std::array keywords{
+    Keyword{ "return", Token::Type::Return },
+    Keyword{ "int", Token::Type::IntKeyword },
+    Keyword{ "void", Token::Type::Void },
+    Keyword{ "if", Token::Type::If },
+    Keyword{ "else", Token::Type::Else },
+    Keyword{ "do", Token::Type::Do },
+    Keyword{ "while", Token::Type::While },
+    Keyword{ "for", Token::Type::For },
+    Keyword{ "break", Token::Type::Break },
+    Keyword{ "continue", Token::Type::Continue },
+    Keyword{ "goto", Token::Type::Goto },
+    Keyword{ "switch", Token::Type::Switch },
+    Keyword{ "case", Token::Type::Case },
+    Keyword{ "default", Token::Type::Default },
+    Keyword{ "static", Token::Type::Static },
+    Keyword{ "extern", Token::Type::Extern },
+    Keyword{ "long", Token::Type::LongKeyword },
+    Keyword{ "signed", Token::Type::Signed },
+    Keyword{ "unsigned", Token::Type::Unsigned },
+    Keyword{ "double", Token::Type::DoubleKeyword },
+    Keyword{ "char", Token::Type::CharKeyword },
+    Keyword{ "sizeof", Token::Type::SizeOf },
+};
+
+inline constexpr size_t tableSize = 64;
+inline constexpr size_t minLength = 2;
+inline constexpr size_t maxLength = 8;
+
+[[nodiscard]] constexpr size_t hash(const std::string_view text, const u32 seed)
+{
+    u32 hash = seed;
+    for (const u32 part : {static_cast<u32>(text.size()), static_cast<u32>(text[0]),
+                           static_cast<u32>(text[1]), static_cast<u32>(text.back())})
+        hash = (hash ^ part) * 16777619u;
+    return (hash >> 16) % tableSize;
+}
+
+[[nodiscard]] constexpr bool isPerfect(const u32 seed)
+{
+    std::array<bool, tableSize> used{};
+    for (const Keyword& keyword : keywords) {
+        const size_t slot = hash(keyword.text, seed);
+        if (used[slot])
+            return false;
+        used[slot] = true;
+    }
+    return true;
+}
+
+[[nodiscard]] constexpr u32 findSeed()
+{
+    for (u32 seed = 1; seed < 100'000; ++seed)
+        if (isPerfect(seed))
+            return seed;
+    return 0;
+}
+
+inline constexpr u32 seed = findSeed();
+static_assert(seed != 0, "No perfect hash seed for the keyword set");
+
+inline constexpr std::array<i8, tableSize> table = [] {
+    std::array<i8, tableSize> result{};
+    result.fill(-1);
+    for (size_t i = 0; i < keywords.size(); ++i)
+        result[hash(keywords[i].text, seed)] = static_cast<i8>(i);
+    return result;
+}();
+
+[[nodiscard]] constexpr Token::Type lookup(const std::string_view text)
+{
+    if (text.size() < minLength || maxLength < text.size())
+        return Token::Type::Identifier;
+    const i8 index = table[hash(text, seed)];
+    if (index < 0 || keywords[index].text != text)
+        return Token::Type::Identifier;
+    return keywords[index].type;
+}
+
+} // Lexing::Keywords
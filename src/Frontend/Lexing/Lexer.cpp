@@ -1,5 +1,8 @@
 #include "Lexer.hpp"
+#include "CharScan.hpp"
+#include "Keywords.hpp"
 
+#include <charconv>
 #include <string>
 #include <cctype>
 #include <cmath>
@@ -8,11 +11,14 @@ namespace Lexing {
 
 std::vector<Error> Lexer::getLexemes()
 {
-    while (!isAtEnd()) {
+    while (true) {
+        m_current = static_cast<i32>(CharScan::skipWhitespace(c_source.data(), m_current, c_source.size()));
+        if (isAtEnd())
+            break;
         m_start = m_current;
         scanToken();
     }
-    tokenStore.emplaceBack(0, m_line, m_column, Type::EndOfFile, "");
+    tokenStore.emplaceBack(Type::EndOfFile, m_current, 0);
     return errors;
 }
 
@@ -198,14 +204,13 @@ void Lexer::forwardSlash()
         addToken(Type::DivideAssign);
         return;
     }
-    if (match('/'))
-        while (peek() != '\n' && !isAtEnd())
-            advance();
+    if (match('/')) {
+        const size_t end = c_source.find('\n', m_current);
+        m_current = static_cast<i32>(end == std::string::npos ? c_source.size() : end);
+    }
     else if (match('*')) {
-        while (c_source.substr(m_current, 2) != "*/" && !isAtEnd())
-            advance();
-        advance();
-        advance();
+        const size_t end = c_source.find("*/", m_current);
+        m_current = static_cast<i32>(end == std::string::npos ? c_source.size() : end + 2);
     }
     else
         addToken(Type::ForwardSlash);
@@ -249,53 +254,53 @@ char Lexer::peekNext() const
 
 char Lexer::advance()
 {
-    ++m_column;
-    if (c_source[m_current] == '\n') {
-        ++m_line;
-        m_column = 1;
-    }
     return c_source[m_current++];
 }
 
+void Lexer::skipDigits()
+{
+    m_current = static_cast<i32>(CharScan::digitsEnd(c_source.data(), m_current, c_source.size()));
+}
+
 void Lexer::number()
 {
-    u64 num = c_source[m_start] - '0';
-    while (!isAtEnd() && isdigit(peek())) {
-        num *= 10;
-        num += peek() - '0';
-        advance();
-    }
+    skipDigits();
     if (peek() == '.' || tolower(peek()) == 'e') {
         floating();
         return;
     }
     const i32 endNumbers = m_current;
+    u64 num = 0;
+    const auto [_, errorCode] = std::from_chars(c_source.data() + m_start, c_source.data() + endNumbers, num);
     while (!isAtEnd() && isalpha(peek()))
         advance();
+    if (errorCode != std::errc()) {
+        addToken(Type::Invalid);
+        return;
+    }
     if (endNumbers + 2 < m_current)
         addToken(Type::Invalid);
-    const i32 ahead = m_current - m_start;
-    std::string text = c_source.substr(m_start, ahead);
+    const std::string_view text = std::string_view(c_source).substr(m_start, m_current - m_start);
     if (matchesUL(text, endNumbers, m_current)) {
-        addToken(Type::UnsignedLongLiteral, num, ahead, text);
+        addToken(Type::UnsignedLongLiteral, num);
         return;
     }
     if (tolower(text.back()) == 'l' && endNumbers + 1 == m_current) {
-        addToken(Type::LongLiteral, num, ahead, text);
+        addToken(Type::LongLiteral, num);
         return;
     }
     if (tolower(text.back()) == 'u' && endNumbers + 1 == m_current) {
         if (MAX_U32 < num)
-            addToken(Type::UnsignedLongLiteral, num, ahead, text);
+            addToken(Type::UnsignedLongLiteral, num);
         else
-            addToken(Type::UnsignedIntegerLiteral, num, ahead, text);
+            addToken(Type::UnsignedIntegerLiteral, num);
         return;
     }
     if (endNumbers == m_current) {
         if (MAX_I32 < num)
-            addToken(Type::LongLiteral, num, ahead, text);
+            addToken(Type::LongLiteral, num);
         else
-            addToken(Type::IntegerLiteral, num, ahead, text);
+            addToken(Type::IntegerLiteral, num);
         return;
     }
     addToken(Type::Invalid);
@@ -305,8 +310,7 @@ void Lexer::floating()
 {
     if (peek() == '.')
         advance();
-    while (!isAtEnd() && isdigit(peek()))
-        advance();
+    skipDigits();
     if (tolower(peek()) == 'e') {
         advance();
         if (peek() == '+' || peek() == '-')
@@ -315,8 +319,7 @@ void Lexer::floating()
             addToken(Type::Invalid);
             return;
         }
-        while (!isAtEnd() && isdigit(peek()))
-            advance();
+        skipDigits();
     }
     if (peek() == '.' || isalnum(peek()) || peek() == '_') {
         addToken(Type::Invalid);
@@ -403,26 +406,24 @@ void Lexer::string()
         nextCh = peek();
     }
     advance();
-    addStringLiteral(toAdd);
+    addStringLiteral(std::move(toAdd));
 }
 
 void Lexer::identifier()
 {
-    while (isalnum(peek()) || peek() == '_')
-        advance();
-    const i32 ahead = m_current - m_start;
-    const std::string text = c_source.substr(m_start, ahead);
-    const auto iden = keywords.find(text);
-    if (iden == keywords.end()) {
+    m_current = static_cast<i32>(CharScan::identifierEnd(c_source.data(), m_current, c_source.size()));
+    const std::string_view text = std::string_view(c_source).substr(m_start, m_current - m_start);
+    const Type type = Keywords::lookup(text);
+    if (type == Type::Identifier) {
         addTokenStoreString(Type::Identifier);
         return;
     }
-    addToken(iden->second);
+    addToken(type);
 }
 
-void Lexer::addToken(const Token::Type type, const u64 num, const i32 ahead, std::string& text) const
+void Lexer::addToken(const Token::Type type, const u64 num) const
 {
-    std::variant<char, i8, u8, i32, i64, u32, u64, double> value;
+    TokenStore::Value value;
     if (type == Type::IntegerLiteral)
         value = static_cast<i32>(num);
     else if (type == Type::LongLiteral)
@@ -433,68 +434,44 @@ void Lexer::addToken(const Token::Type type, const u64 num, const i32 ahead, std
         value = num;
     else
         std::abort();
-    tokenStore.emplaceBack(
-        value,
-        m_line,
-        m_column - ahead,
-        type,
-        std::move(text));
+    tokenStore.emplaceBack(type, m_start, m_current - m_start, value);
 }
 
 void Lexer::addCharLiteral(const char ch) const
 {
-    const i32 ahead = m_current - m_start;
-    const std::variant<char, i8, u8, i32, i64, u32, u64, double> valueToStore = ch;
-    tokenStore.emplaceBack(
-        valueToStore,
-        m_line,
-        m_column - ahead,
-        Type::CharLiteral,
-        "");
+    tokenStore.emplaceBack(Type::CharLiteral, m_start, m_current - m_start, ch);
 }
 
-void Lexer::addStringLiteral(const std::string& str) const
+void Lexer::addStringLiteral(std::string str) const
 {
-    const i32 ahead = m_current - m_start;
-    tokenStore.emplaceBack(
-        std::variant<char, i8, u8, i32, i64, u32, u64, double>(),
-        m_line,
-        m_column - ahead,
-        Type::StringLiteral,
-        str);
+    tokenStore.emplaceBack(m_start, m_current - m_start, std::move(str));
 }
 
 void Lexer::addToken(const Token::Type type)
 {
-    const i32 ahead = m_current - m_start;
-    constexpr std::variant<char, i8, u8, i32, i64, u32, u64, double> valueToStore;
-    tokenStore.emplaceBack(
-        valueToStore,
-        m_line,
-        m_column - ahead,
-        type,
-        "");
+    tokenStore.emplaceBack(type, m_start, m_current - m_start);
     if (type == Type::Invalid)
         errors.emplace_back("Unknown token type", tokenStore.size() - 1);
 }
 
 void Lexer::addTokenStoreString(const Token::Type type) const
 {
-    const i32 ahead = m_current - m_start;
-    std::string text = c_source.substr(m_start, ahead);
-    std::variant<char, i8, u8, i32, i64, u32, u64, double> valueToStore = 0;
-    if (type == Type::DoubleLiteral) {
-        const double value = std::strtod(text.c_str(), nullptr);
-        if (errno == ERANGE && value == HUGE_VAL)
-            valueToStore = std::numeric_limits<double>::infinity();
-        else
-            valueToStore = value;
+    const i32 length = m_current - m_start;
+    if (type != Type::DoubleLiteral) {
+        tokenStore.emplaceBack(type, m_start, length);
+        return;
     }
-    tokenStore.emplaceBack(
-        valueToStore,
-        m_line,
-        m_column - ahead,
-        type,
-        std::move(text));
+    double value = 0.0;
+    const char* begin = c_source.data() + m_start;
+    if (const auto [_, errorCode] = std::from_chars(begin, begin + length, value); errorCode == std::errc()) {
+        tokenStore.emplaceBack(type, m_start, length, value);
+        return;
+    }
+    const std::string text = c_source.substr(m_start, length);
+    value = std::strtod(text.c_str(), nullptr);
+    if (errno == ERANGE && value == HUGE_VAL)
+        tokenStore.emplaceBack(type, m_start, length, std::numeric_limits<double>::infinity());
+    else
+        tokenStore.emplaceBack(type, m_start, length, value);
 }
 }
\ No newline at end of file
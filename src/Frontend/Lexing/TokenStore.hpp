@@ -2,75 +2,163 @@
 
 #include "ShortTypes.hpp"
 #include "Token.hpp"
+#include "Symbol.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <string>
+#include <string_view>
 #include <vector>
 
+// Tokens are kept as 16 byte records pointing into the preprocessed source owned by the store.
+// Literal values, string literal contents and identifier symbols live in side tables indexed
+// by TokenRecord::extra. Line and column are only derived from the offset when asked for.
 class TokenStore {
-    std::vector<std::variant<char, i8, u8, i32, i64, u32, u64, double>> m_data;
-    std::vector<i32> m_line;
-    std::vector<u16> m_column;
-    std::vector<Lexing::Token::Type> m_type;
-    std::vector<std::string> m_lexeme;
+public:
+    using Value = std::variant<char, i8, u8, i32, i64, u32, u64, double>;
+private:
+    using Type = Lexing::Token::Type;
+    struct TokenRecord {
+        u32 offset;
+        u32 length;
+        u32 extra;
+        Type type;
+    };
+    static_assert(sizeof(TokenRecord) == 16);
+    static constexpr u32 s_noExtra = UINT32_MAX;
+
+    std::string m_source;
+    std::vector<TokenRecord> m_tokens;
+    std::vector<Value> m_values;
+    std::vector<std::string> m_strings;
+    std::vector<Symbol> m_symbols;
+    mutable std::vector<u32> m_lineStarts;
 public:
     void clear()
     {
-        m_data.clear();
-        m_line.clear();
-        m_column.clear();
-        m_type.clear();
-        m_lexeme.clear();
+        m_source.clear();
+        m_tokens.clear();
+        m_values.clear();
+        m_strings.clear();
+        m_symbols.clear();
+        m_lineStarts.clear();
     }
     void reserve(const size_t size)
     {
-        m_data.reserve(size);
-        m_line.reserve(size);
-        m_column.reserve(size);
-        m_type.reserve(size);
-        m_lexeme.reserve(size);
-    }
-    void emplaceBack(
-        std::variant<char, i8, u8, i32, i64, u32, u64, double> value,
-        const i32 line,
-        const u16 column,
-        Lexing::Token::Type type,
-        std::string lexeme)
-    {
-        m_data.emplace_back(value);
-        m_line.emplace_back(line);
-        m_column.emplace_back(column);
-        m_type.emplace_back(type);
-        m_lexeme.emplace_back(std::move(lexeme));
+        m_tokens.reserve(size);
+    }
+    void setSource(std::string source)
+    {
+        clear();
+        m_source = std::move(source);
+    }
+    [[nodiscard]] const std::string& source() const { return m_source; }
+
+    void emplaceBack(const Type type, const u32 offset, const u32 length)
+    {
+        u32 extra = s_noExtra;
+        if (type == Type::Identifier) {
+            extra = static_cast<u32>(m_symbols.size());
+            m_symbols.emplace_back(std::string_view(m_source).substr(offset, length));
+        }
+        m_tokens.emplace_back(offset, length, extra, type);
+    }
+    void emplaceBack(const Type type, const u32 offset, const u32 length, const Value value)
+    {
+        m_tokens.emplace_back(offset, length, static_cast<u32>(m_values.size()), type);
+        m_values.emplace_back(value);
+    }
+    void emplaceBack(const u32 offset, const u32 length, std::string stringLiteral)
+    {
+        m_tokens.emplace_back(offset, length, static_cast<u32>(m_strings.size()), Type::StringLiteral);
+        m_strings.emplace_back(std::move(stringLiteral));
+    }
+    // Builds a token without a lexer by appending its text to the source, used for synthesized token streams.
+    void append(const Type type, const std::string_view text, const Value value = i32(0))
+    {
+        const auto offset = static_cast<u32>(m_source.size());
+        m_source += text;
+        m_source += ' ';
+        m_lineStarts.clear();
+        const auto length = static_cast<u32>(text.size());
+        if (type == Type::StringLiteral)
+            emplaceBack(offset, length, std::string(text));
+        else if (hasValue(type))
+            emplaceBack(type, offset, length, value);
+        else
+            emplaceBack(type, offset, length);
     }
+
     [[nodiscard]] Lexing::Token getToken(const size_t i) const
     {
-        assert(i < m_line.size());
-        return {getValue(i), getLineNumber(i), getColumnNumber(i), getType(i), getLexeme(i)};
+        assert(i < m_tokens.size());
+        return {getValue(i), getLineNumber(i), getColumnNumber(i), getType(i), std::string(getLexeme(i))};
     }
-    [[nodiscard]] std::variant<char, i8, u8, i32, i64, u32, u64, double> getValue(const size_t i) const
+    [[nodiscard]] Value getValue(const size_t i) const
     {
-        assert(i < m_line.size());
-        return m_data[i];
+        assert(i < m_tokens.size());
+        if (!hasValue(m_tokens[i].type))
+            return {};
+        return m_values[m_tokens[i].extra];
     }
     [[nodiscard]] i32 getLineNumber(const size_t i) const
     {
-        assert(i < m_line.size());
-        return m_line[i];
+        assert(i < m_tokens.size());
+        return static_cast<i32>(lineIndex(m_tokens[i].offset)) + 1;
     }
     [[nodiscard]] u16 getColumnNumber(const size_t i) const
     {
-        assert(i < m_line.size());
-        return m_column[i];
+        assert(i < m_tokens.size());
+        const u32 offset = m_tokens[i].offset;
+        return static_cast<u16>(offset - m_lineStarts[lineIndex(offset)] + 1);
+    }
+    [[nodiscard]] Type getType(const size_t i) const
+    {
+        assert(i < m_tokens.size());
+        return m_tokens[i].type;
+    }
+    [[nodiscard]] std::string_view getLexeme(const size_t i) const
+    {
+        assert(i < m_tokens.size());
+        const TokenRecord& token = m_tokens[i];
+        if (token.type == Type::StringLiteral)
+            return m_strings[token.extra];
+        if (token.type == Type::Identifier || (hasValue(token.type) && token.type != Type::CharLiteral))
+            return std::string_view(m_source).substr(token.offset, token.length);
+        return {};
+    }
+    [[nodiscard]] Symbol getSymbol(const size_t i) const
+    {
+        assert(i < m_tokens.size());
+        if (m_tokens[i].type != Type::Identifier)
+            return {};
+        return m_symbols[m_tokens[i].extra];
     }
-    [[nodiscard]] Lexing::Token::Type getType(const size_t i) const
+    [[nodiscard]] size_t size() const { return m_tokens.size(); }
+private:
+    [[nodiscard]] static bool hasValue(const Type type)
     {
-        assert(i < m_line.size());
-        return m_type[i];
+        switch (type) {
+            case Type::CharLiteral:
+            case Type::IntegerLiteral:
+            case Type::UnsignedIntegerLiteral:
+            case Type::LongLiteral:
+            case Type::UnsignedLongLiteral:
+            case Type::DoubleLiteral:
+                return true;
+            default:
+                return false;
+        }
     }
-    [[nodiscard]] std::string getLexeme(const size_t i) const
+    [[nodiscard]] size_t lineIndex(const u32 offset) const
     {
-        assert(i < m_line.size());
-        return m_lexeme[i];
+        if (m_lineStarts.empty()) {
+            m_lineStarts.emplace_back(0);
+            for (u32 i = 0; i < m_source.size(); ++i)
+                if (m_source[i] == '\n')
+                    m_lineStarts.emplace_back(i + 1);
+        }
+        const auto it = std::ranges::upper_bound(m_lineStarts, offset);
+        return static_cast<size_t>(it - m_lineStarts.begin()) - 1;
     }
-    [[nodiscard]] size_t size() const { return m_line.size(); }
-};
\ No newline at end of file
+};
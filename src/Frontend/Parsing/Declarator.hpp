@@ -2,6 +2,7 @@
 
 #include "ASTBase.hpp"
 #include "CodeGen/AsmAST.hpp"
+#include "Symbol.hpp"
 
 namespace Parsing {
 
@@ -61,9 +62,9 @@ protected:
 };
 
 struct IdentifierDeclarator : Declarator {
-    std::string identifier;
-    explicit IdentifierDeclarator(std::string&& identifier)
-        : Declarator(Kind::Identifier), identifier(std::move(identifier)) {}
+    Symbol identifier;
+    explicit IdentifierDeclarator(const Symbol identifier)
+        : Declarator(Kind::Identifier), identifier(identifier) {}
 
     static bool classOf(const Declarator* declarator) { return declarator->kind == Kind::Identifier; }
 
@@ -94,11 +95,11 @@ struct ArrayDeclarator : Declarator {
 };
 
 struct ParamInfo {
-    std::unique_ptr<TypeBase> type;
+    const TypeBase* type;
     std::unique_ptr<Declarator> declarator;
 
-    ParamInfo(std::unique_ptr<TypeBase>&& type, std::unique_ptr<Declarator>&& declarator)
-        : type(std::move(type)), declarator(std::move(declarator)) {}
+    ParamInfo(const TypeBase* type, std::unique_ptr<Declarator>&& declarator)
+        : type(type), declarator(std::move(declarator)) {}
 
     ParamInfo() = delete;
 };
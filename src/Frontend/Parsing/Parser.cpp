@@ -1,5 +1,5 @@
 #include "Parser.hpp"
-#include "ASTTypes.hpp"
+#include "TypeContext.hpp"
 #include "DynCast.hpp"
 #include "TypeConversion.hpp"
 
@@ -31,18 +31,16 @@ std::unique_ptr<Declaration> Parser::declarationParse()
     std::unique_ptr<Declarator> declarator = declaratorParse();
     if (declarator == nullptr)
         return nullptr;
-    auto varType = std::make_unique<VarType>(type);
-    auto [iden, typeBase, params] =
-            declaratorProcess(std::move(declarator), std::move(varType));
+    auto [iden, typeBase, params] = declaratorProcess(std::move(declarator), varType(type));
     if (iden.empty())
         return nullptr;
     if (typeBase->type == Type::Function)
-        return funDeclParse(iden, std::move(typeBase), storage, std::move(params));
-    return varDeclParse(iden, std::move(typeBase), storage);
+        return funDeclParse(iden, typeBase, storage, std::move(params));
+    return varDeclParse(iden, typeBase, storage);
 }
 
-std::unique_ptr<VarDecl> Parser::varDeclParse(const std::string& iden,
-                                              std::unique_ptr<TypeBase>&& type,
+std::unique_ptr<VarDecl> Parser::varDeclParse(const Symbol iden,
+                                              const TypeBase* type,
                                               const Storage storage)
 {
     std::unique_ptr<Initializer> init = nullptr;
@@ -57,20 +55,20 @@ std::unique_ptr<VarDecl> Parser::varDeclParse(const std::string& iden,
         addError("Expected semicolon after variable declaration");
         return nullptr;
     }
-    auto varDecl = std::make_unique<VarDecl>(m_current, storage, iden, std::move(type));
+    auto varDecl = std::make_unique<VarDecl>(m_current, storage, iden, type);
     if (init)
         varDecl->init = std::move(init);
     return varDecl;
 }
 
 std::unique_ptr<FuncDeclaration> Parser::funDeclParse(
-        const std::string& iden,
-        std::unique_ptr<TypeBase>&& type,
+        const Symbol iden,
+        const TypeBase* type,
         const Storage storage,
-        std::vector<std::string>&& params
+        ArenaVector<Symbol>&& params
     )
 {
-    auto result = std::make_unique<FuncDeclaration>(m_current, storage, iden, std::move(params), std::move(type));
+    auto result = std::make_unique<FuncDeclaration>(m_current, storage, iden, std::move(params), type);
     if (expect(TokenType::Semicolon))
         return result;
     const size_t before = m_current;
@@ -148,57 +146,53 @@ std::unique_ptr<Declarator> Parser::simpleDeclaratorParse()
         addError("Expected identifier");
         return nullptr;
     }
-    std::string iden = peek().m_lexeme;
+    const Symbol iden = c_tokenStore.getSymbol(m_current);
     advance();
-    return std::make_unique<IdentifierDeclarator>(std::move(iden));
+    return std::make_unique<IdentifierDeclarator>(iden);
 }
 
-std::tuple<std::string, std::unique_ptr<TypeBase>, std::vector<std::string>> Parser::processFunctionDeclarator(
-    std::unique_ptr<Declarator>&& declarator, std::unique_ptr<TypeBase>&& typeBase)
+std::tuple<Symbol, const TypeBase*, ArenaVector<Symbol>> Parser::processFunctionDeclarator(
+    std::unique_ptr<Declarator>&& declarator, const TypeBase* typeBase)
 {
     const auto funcDecl = dynCast<FunctionDeclarator>(declarator.get());
     if (funcDecl->declarator->kind != Declarator::Kind::Identifier)
         return {};
-    std::vector<std::unique_ptr<TypeBase>> paramTypes;
-    std::vector<std::string> params;
+    std::vector<const TypeBase*> paramTypes;
+    ArenaVector<Symbol> params;
     for (ParamInfo& param : funcDecl->params) {
         auto [iden, typeBaseParam, _] =
-                declaratorProcess(std::move(param.declarator), std::move(param.type));
+                declaratorProcess(std::move(param.declarator), param.type);
         if (typeBaseParam->type == Type::Function)
             return {};
-        params.emplace_back(std::move(iden));
-        paramTypes.emplace_back(std::move(typeBaseParam));
+        params.emplace_back(iden);
+        paramTypes.push_back(typeBaseParam);
     }
     const auto idenDecl = dynCast<IdentifierDeclarator>(funcDecl->declarator.get());
-    auto funcType = std::make_unique<FuncType>(std::move(typeBase), std::move(paramTypes));
-    return std::make_tuple(std::move(idenDecl->identifier), std::move(funcType), std::move(params));
+    return std::make_tuple(idenDecl->identifier, funcType(typeBase, std::move(paramTypes)), std::move(params));
 }
 
-std::tuple<std::string, std::unique_ptr<TypeBase>, std::vector<std::string>> Parser::declaratorProcess(
-    std::unique_ptr<Declarator>&& declarator, std::unique_ptr<TypeBase>&& typeBase)
+std::tuple<Symbol, const TypeBase*, ArenaVector<Symbol>> Parser::declaratorProcess(
+    std::unique_ptr<Declarator>&& declarator, const TypeBase* typeBase)
 {
     switch (declarator->kind) {
         case Declarator::Kind::Identifier: {
             const auto identifierDeclarator = dynCast<IdentifierDeclarator>(declarator.get());
-            return std::make_tuple(std::move(identifierDeclarator->identifier),
-                                   std::move(typeBase),
-                                   std::move(std::vector<std::string>()));
+            return std::make_tuple(identifierDeclarator->identifier, typeBase, ArenaVector<Symbol>());
         }
         case Declarator::Kind::Pointer: {
-            auto pointerType = std::make_unique<PointerType>(std::move(typeBase));
             const auto pointerDeclarator = dynCast<PointerDeclarator>(declarator.get());
-            return declaratorProcess(std::move(pointerDeclarator->inner), std::move(pointerType));
+            return declaratorProcess(std::move(pointerDeclarator->inner), pointerTo(typeBase));
         }
         case Declarator::Kind::Function: {
-            return processFunctionDeclarator(std::move(declarator), std::move(typeBase));
+            return processFunctionDeclarator(std::move(declarator), typeBase);
         }
         case Declarator::Kind::Array: {
             const auto arrayDeclarator = dynCast<ArrayDeclarator>(declarator.get());
-            auto arrayType = std::make_unique<ArrayType>(std::move(typeBase), std::move(arrayDeclarator->size));
-            return declaratorProcess(std::move(arrayDeclarator->declarator), std::move(arrayType));
+            return declaratorProcess(std::move(arrayDeclarator->declarator),
+                                     arrayOf(typeBase, arrayDeclarator->size));
         }
     }
-    return std::make_tuple(std::string(), std::move(typeBase), std::vector<std::string>());
+    return std::make_tuple(Symbol(), typeBase, ArenaVector<Symbol>());
 }
 
 std::unique_ptr<std::vector<ParamInfo>> Parser::paramsListParse()
@@ -234,8 +228,7 @@ std::unique_ptr<ParamInfo> Parser::paramParse()
     std::unique_ptr<Declarator> declarator = declaratorParse();
     if (declarator == nullptr)
         return nullptr;
-    std::unique_ptr<TypeBase> typeExpr = std::make_unique<VarType>(type);
-    return std::make_unique<ParamInfo>(std::move(typeExpr), std::move(declarator));
+    return std::make_unique<ParamInfo>(varType(type), std::move(declarator));
 }
 
 std::unique_ptr<Block> Parser::blockParse()
@@ -271,7 +264,7 @@ std::unique_ptr<BlockItem> Parser::blockItemParse()
 std::unique_ptr<Initializer> Parser::initializerParse()
 {
     if (expect(TokenType::OpenBrace)) {
-        std::vector<std::unique_ptr<Initializer>> initializers;
+        ArenaVector<std::unique_ptr<Initializer>> initializers;
         std::unique_ptr<Initializer> first = initializerParse();
         if (first == nullptr)
             return nullptr;
@@ -409,7 +402,7 @@ std::unique_ptr<Stmt> Parser::gotoStmtParse()
 {
     if (!expect(TokenType::Goto))
         return nullptr;
-    Lexing::Token lexeme = peek();
+    const std::string_view label = c_tokenStore.getLexeme(m_current);
     if (!expect(TokenType::Identifier)) {
         addError("Expected identifier after goto statement");
         return nullptr;
@@ -418,7 +411,7 @@ std::unique_ptr<Stmt> Parser::gotoStmtParse()
         addError("Expected semicolon after goto statement");
         return nullptr;
     }
-    return std::make_unique<GotoStmt>(m_current, lexeme.m_lexeme);
+    return std::make_unique<GotoStmt>(m_current, std::string(label));
 }
 
 std::unique_ptr<Stmt> Parser::breakStmtParse()
@@ -445,7 +438,7 @@ std::unique_ptr<Stmt> Parser::continueStmtParse()
 
 std::unique_ptr<Stmt> Parser::labelStmtParse()
 {
-    Lexing::Token lexeme = peek();
+    const std::string_view label = c_tokenStore.getLexeme(m_current);
     if (!expect(TokenType::Identifier))
         return nullptr;
     if (!expect(TokenType::Colon)) {
@@ -455,7 +448,7 @@ std::unique_ptr<Stmt> Parser::labelStmtParse()
     auto stmt = stmtParse();
     if (stmt == nullptr)
         return nullptr;
-    return std::make_unique<LabelStmt>(m_current, lexeme.m_lexeme, std::move(stmt));
+    return std::make_unique<LabelStmt>(m_current, std::string(label), std::move(stmt));
 }
 
 std::unique_ptr<Stmt> Parser::caseStmtParse()
@@ -636,10 +629,10 @@ std::unique_ptr<Expr> Parser::ternaryExprParse(std::unique_ptr<Expr>& condition)
         m_current, std::move(condition), std::move(trueExpr), std::move(falseExpr));
 }
 
-std::unique_ptr<Expr> Parser::assignmentExprParse(std::unique_ptr<Expr>& left, const Lexing::Token& nextToken)
+std::unique_ptr<Expr> Parser::assignmentExprParse(std::unique_ptr<Expr>& left, const TokenType nextToken)
 {
-    AssignmentExpr::Operator op = Operators::assignOperator(nextToken.m_type);
-    auto right = exprParse(Operators::precedence(nextToken.m_type));
+    AssignmentExpr::Operator op = Operators::assignOperator(nextToken);
+    auto right = exprParse(Operators::precedence(nextToken));
     if (right == nullptr) {
         addError("Expected right hand side after assignment operator");
         return nullptr;
@@ -648,10 +641,10 @@ std::unique_ptr<Expr> Parser::assignmentExprParse(std::unique_ptr<Expr>& left, c
         m_current, op, std::move(left), std::move(right));
 }
 
-std::unique_ptr<Expr> Parser::binaryExprParse(std::unique_ptr<Expr>& left, const Lexing::Token& nextToken)
+std::unique_ptr<Expr> Parser::binaryExprParse(std::unique_ptr<Expr>& left, const TokenType nextToken)
 {
-    BinaryExpr::Operator op = Operators::binaryOperator(nextToken.m_type);
-    auto right = exprParse(Operators::precedence(nextToken.m_type) + 1);
+    BinaryExpr::Operator op = Operators::binaryOperator(nextToken);
+    auto right = exprParse(Operators::precedence(nextToken) + 1);
     if (right == nullptr) {
         addError("Expected right hand side after binary operator");
         return nullptr;
@@ -664,18 +657,18 @@ std::unique_ptr<Expr> Parser::exprParse(const i32 minPrecedence)
     std::unique_ptr<Expr> left = castExprParse();
     if (left == nullptr)
         return nullptr;
-    Lexing::Token nextToken = peek();
+    TokenType nextToken = peekTokenType();
     while (continuePrecedenceClimbing(minPrecedence, peekTokenType())) {
         advance();
-        if (nextToken.m_type == TokenType::QuestionMark)
+        if (nextToken == TokenType::QuestionMark)
             left = ternaryExprParse(left);
-        if (Operators::isAssignmentOperator(nextToken.m_type))
+        if (Operators::isAssignmentOperator(nextToken))
             left = assignmentExprParse(left, nextToken);
-        if (Operators::isBinaryOperator(nextToken.m_type))
+        if (Operators::isBinaryOperator(nextToken))
             left = binaryExprParse(left, nextToken);
         if (left == nullptr)
             return nullptr;
-        nextToken = peek();
+        nextToken = peekTokenType();
     }
     return left;
 }
@@ -689,15 +682,13 @@ std::unique_ptr<Expr> Parser::castExprParse()
         std::unique_ptr<AbstractDeclarator> abstractDeclarator = abstractDeclaratorParse();
         if (abstractDeclarator == nullptr)
             return nullptr;
-        std::unique_ptr<TypeBase> typeBaseInner = std::make_unique<VarType>(type);
-        std::unique_ptr<TypeBase> typeBase = abstractDeclaratorProcess(std::move(abstractDeclarator),
-                                                                       std::move(typeBaseInner));
+        const TypeBase* typeBase = abstractDeclaratorProcess(std::move(abstractDeclarator), varType(type));
         if (!expect(TokenType::CloseParen))
             return nullptr;
         auto innerExpr = castExprParse();
         if (innerExpr == nullptr)
             return nullptr;
-        return std::make_unique<CastExpr>(m_current, std::move(typeBase), std::move(innerExpr));
+        return std::make_unique<CastExpr>(m_current, typeBase, std::move(innerExpr));
     }
     return unaryExprParse();
 }
@@ -731,7 +722,7 @@ std::unique_ptr<Expr> Parser::sizeOfExprParse()
             return nullptr;
         if (!expect(TokenType::CloseParen))
             return nullptr;
-        return std::make_unique<SizeOfTypeExpr>(m_current, std::move(typeBase));
+        return std::make_unique<SizeOfTypeExpr>(m_current, typeBase);
     }
     std::unique_ptr<Expr> innerExpr = unaryExprParse();
     if (innerExpr == nullptr)
@@ -790,30 +781,31 @@ std::unique_ptr<Expr> Parser::factorParse()
 {
     if (Operators::isLiteral(peekTokenType()))
         return constExprParse();
-    switch (const Lexing::Token lexeme = peek(); lexeme.m_type) {
+    switch (peekTokenType()) {
         case TokenType::StringLiteral: {
-            std::string tokenString = lexeme.m_lexeme;
+            std::string tokenString(c_tokenStore.getLexeme(m_current));
             const i64 location = m_current;
             advance();
             while (peekTokenType() == TokenType::StringLiteral)
-                tokenString += advance().m_lexeme;
+                tokenString += c_tokenStore.getLexeme(m_current++);
             auto constantExpr = std::make_unique<StringExpr>(
-                location, std::move(tokenString), std::make_unique<VarType>(Type::String));
+                location, std::move(tokenString), varType(Type::String));
             return constantExpr;
         }
         case TokenType::Identifier: {
+            const Symbol name = c_tokenStore.getSymbol(m_current);
             advance();
             if (!expect(TokenType::OpenParen))
-                return std::make_unique<VarExpr>(m_current, lexeme.m_lexeme);
-            const std::unique_ptr<std::vector<std::unique_ptr<Expr>>> arguments = argumentListParse();
+                return std::make_unique<VarExpr>(m_current, name);
+            const std::unique_ptr<ArenaVector<std::unique_ptr<Expr>>> arguments = argumentListParse();
             if (arguments == nullptr)
                 return nullptr;
             if (!expect(TokenType::CloseParen))
                 return nullptr;
-            return std::make_unique<FuncCallExpr>(m_current, lexeme.m_lexeme, std::move(*arguments));
+            return std::make_unique<FuncCallExpr>(m_current, name, std::move(*arguments));
         }
         case TokenType::OpenParen: {
-            if (advance().m_type == TokenType::EndOfFile)
+            if (advance() == TokenType::EndOfFile)
                 return nullptr;
             auto expr = exprParse(0);
             if (!expect(TokenType::CloseParen))
@@ -827,48 +819,36 @@ std::unique_ptr<Expr> Parser::factorParse()
 
 std::unique_ptr<Expr> Parser::constExprParse()
 {
-    std::variant<char, i8, u8, i32, i64, u32, u64, double> value;
-    std::unique_ptr<TypeBase> type;
-    switch (const Lexing::Token lexeme = peek(); lexeme.m_type) {
-        case TokenType::CharLiteral: {
-            value = lexeme.getCharValue();
-            type = std::make_unique<VarType>(Type::Char);
+    const TokenStore::Value value = c_tokenStore.getValue(m_current);
+    const TypeBase* type;
+    switch (peekTokenType()) {
+        case TokenType::CharLiteral:
+            type = varType(Type::Char);
             break;
-        }
-        case TokenType::IntegerLiteral: {
-            value = lexeme.getI32Value();
-            type = std::make_unique<VarType>(Type::I32);
+        case TokenType::IntegerLiteral:
+            type = varType(Type::I32);
             break;
-        }
-        case TokenType::UnsignedIntegerLiteral: {
-            value = lexeme.getU32Value();
-            type = std::make_unique<VarType>(Type::U32);
+        case TokenType::UnsignedIntegerLiteral:
+            type = varType(Type::U32);
             break;
-        }
-        case TokenType::LongLiteral: {
-            value = lexeme.getI64Value();
-            type = std::make_unique<VarType>(Type::I64);
+        case TokenType::LongLiteral:
+            type = varType(Type::I64);
             break;
-        }
-        case TokenType::UnsignedLongLiteral: {
-            value = lexeme.getU64Value();
-            type = std::make_unique<VarType>(Type::U64);
+        case TokenType::UnsignedLongLiteral:
+            type = varType(Type::U64);
             break;
-        }
-        case TokenType::DoubleLiteral: {
-            value = lexeme.getDoubleValue();
-            type = std::make_unique<VarType>(Type::Double);
+        case TokenType::DoubleLiteral:
+            type = varType(Type::Double);
             break;
-        }
         default:
             return nullptr;
     }
-    if (advance().m_type == TokenType::EndOfFile)
+    if (advance() == TokenType::EndOfFile)
         return nullptr;
-    return std::make_unique<ConstExpr>(m_current, value, std::move(type));
+    return std::make_unique<ConstExpr>(m_current, value, type);
 }
 
-std::unique_ptr<TypeBase> Parser::typeNameParse()
+const TypeBase* Parser::typeNameParse()
 {
     std::vector<TokenType> types;
     TokenType type = peekTokenType();
@@ -883,8 +863,7 @@ std::unique_ptr<TypeBase> Parser::typeNameParse()
     std::unique_ptr<AbstractDeclarator> abstractDeclarator = abstractDeclaratorParse();
     if (abstractDeclarator == nullptr)
         return nullptr;
-    std::unique_ptr<TypeBase> typeBaseInner = std::make_unique<VarType>(parsedType);
-    return abstractDeclaratorProcess(std::move(abstractDeclarator), std::move(typeBaseInner));
+    return abstractDeclaratorProcess(std::move(abstractDeclarator), varType(parsedType));
 }
 
 std::unique_ptr<AbstractDeclarator> Parser::abstractDeclaratorParse()
@@ -932,21 +911,20 @@ std::unique_ptr<AbstractDeclarator> Parser::directAbstractDeclaratorParse()
     return abstractDeclarator;
 }
 
-std::unique_ptr<TypeBase> Parser::abstractDeclaratorProcess(
-    std::unique_ptr<AbstractDeclarator>&& abstractDeclarator, std::unique_ptr<TypeBase>&& type)
+const TypeBase* Parser::abstractDeclaratorProcess(
+    std::unique_ptr<AbstractDeclarator>&& abstractDeclarator, const TypeBase* type)
 {
     if (!abstractDeclarator)
         return type;
     switch (abstractDeclarator->kind) {
         case AbstractArrayDeclarator::Kind::Pointer: {
-            type = std::make_unique<PointerType>(std::move(type));
             const auto inner = dynCast<AbstractPointer>(abstractDeclarator.get());
-            return abstractDeclaratorProcess(std::move(inner->inner), std::move(type));
+            return abstractDeclaratorProcess(std::move(inner->inner), pointerTo(type));
         }
         case AbstractArrayDeclarator::Kind::Array: {
             const auto arrayDeclarator = dynCast<AbstractArrayDeclarator>(abstractDeclarator.get());
-            type = std::make_unique<ArrayType>(std::move(type), arrayDeclarator->size);
-            return abstractDeclaratorProcess(std::move(arrayDeclarator->abstractDeclarator), std::move(type));
+            return abstractDeclaratorProcess(std::move(arrayDeclarator->abstractDeclarator),
+                                             arrayOf(type, arrayDeclarator->size));
         }
         case AbstractArrayDeclarator::Kind::Base:
             return type;
@@ -954,11 +932,11 @@ std::unique_ptr<TypeBase> Parser::abstractDeclaratorProcess(
     return type;
 }
 
-std::unique_ptr<std::vector<std::unique_ptr<Expr>>> Parser::argumentListParse()
+std::unique_ptr<ArenaVector<std::unique_ptr<Expr>>> Parser::argumentListParse()
 {
-    std::vector<std::unique_ptr<Expr>> arguments;
+    ArenaVector<std::unique_ptr<Expr>> arguments;
     if (peekTokenType() == TokenType::CloseParen)
-        return std::make_unique<std::vector<std::unique_ptr<Expr>>>(std::move(arguments));
+        return std::make_unique<ArenaVector<std::unique_ptr<Expr>>>(std::move(arguments));
     auto expr = exprParse(0);
     if (expr == nullptr)
         return nullptr;
@@ -969,7 +947,7 @@ std::unique_ptr<std::vector<std::unique_ptr<Expr>>> Parser::argumentListParse()
             return nullptr;
         arguments.push_back(std::move(expr));
     }
-    return std::make_unique<std::vector<std::unique_ptr<Expr>>>(std::move(arguments));
+    return std::make_unique<ArenaVector<std::unique_ptr<Expr>>>(std::move(arguments));
 }
 
 std::tuple<Type, Lexing::Token::Type> Parser::specifierParse()
@@ -1068,7 +1046,7 @@ bool containsSameTwice(std::vector<Lexing::Token::Type>& tokens)
 bool Parser::expect(const TokenType type)
 {
     if (peekTokenType() == type) {
-        if (advance().m_type == TokenType::EndOfFile)
+        if (advance() == TokenType::EndOfFile)
             return false;
         return true;
     }
@@ -93,14 +93,14 @@ public:
         : c_tokenStore(tokenStore) {}
     std::vector<Error> programParse(Program& program);
     [[nodiscard]] std::unique_ptr<Declaration> declarationParse();
-    [[nodiscard]] std::unique_ptr<VarDecl> varDeclParse(const std::string& iden,
-                                                        std::unique_ptr<TypeBase>&& type,
+    [[nodiscard]] std::unique_ptr<VarDecl> varDeclParse(Symbol iden,
+                                                        const TypeBase* type,
                                                         Storage storage);
     [[nodiscard]] std::unique_ptr<FuncDeclaration> funDeclParse(
-            const std::string& iden,
-            std::unique_ptr<TypeBase>&& type,
+            Symbol iden,
+            const TypeBase* type,
             Storage storage,
-            std::vector<std::string>&& params
+            ArenaVector<Symbol>&& params
         );
 
     [[nodiscard]] std::unique_ptr<Declarator> declaratorParse();
@@ -110,10 +110,10 @@ public:
     [[nodiscard]] std::unique_ptr<std::vector<ParamInfo>> paramsListParse();
     [[nodiscard]] std::unique_ptr<ParamInfo> paramParse();
 
-    [[nodiscard]] static std::tuple<std::string, std::unique_ptr<TypeBase>, std::vector<std::string>>
-        declaratorProcess(std::unique_ptr<Declarator>&& declarator, std::unique_ptr<TypeBase>&& typeBase);
-    [[nodiscard]] static std::tuple<std::string, std::unique_ptr<TypeBase>, std::vector<std::string>>
-        processFunctionDeclarator(std::unique_ptr<Declarator>&& declarator, std::unique_ptr<TypeBase>&& typeBase);
+    [[nodiscard]] static std::tuple<Symbol, const TypeBase*, ArenaVector<Symbol>>
+        declaratorProcess(std::unique_ptr<Declarator>&& declarator, const TypeBase* typeBase);
+    [[nodiscard]] static std::tuple<Symbol, const TypeBase*, ArenaVector<Symbol>>
+        processFunctionDeclarator(std::unique_ptr<Declarator>&& declarator, const TypeBase* typeBase);
 
     [[nodiscard]] std::unique_ptr<Block> blockParse();
     [[nodiscard]] std::unique_ptr<BlockItem> blockItemParse();
@@ -138,8 +138,8 @@ public:
 
     [[nodiscard]] std::unique_ptr<Expr> exprParse(i32 minPrecedence);
     [[nodiscard]] std::unique_ptr<Expr> ternaryExprParse(std::unique_ptr<Expr>& condition);
-    [[nodiscard]] std::unique_ptr<Expr> assignmentExprParse(std::unique_ptr<Expr>& left, const Lexing::Token& nextToken);
-    [[nodiscard]] std::unique_ptr<Expr> binaryExprParse(std::unique_ptr<Expr>& left, const Lexing::Token& nextToken);
+    [[nodiscard]] std::unique_ptr<Expr> assignmentExprParse(std::unique_ptr<Expr>& left, TokenType nextToken);
+    [[nodiscard]] std::unique_ptr<Expr> binaryExprParse(std::unique_ptr<Expr>& left, TokenType nextToken);
     [[nodiscard]] std::unique_ptr<Expr> unaryExprParse();
     [[nodiscard]] std::unique_ptr<Expr> addrOFExprParse();
     [[nodiscard]] std::unique_ptr<Expr> dereferenceExprParse();
@@ -150,22 +150,21 @@ public:
     [[nodiscard]] std::unique_ptr<Expr> factorParse();
     [[nodiscard]] std::unique_ptr<Expr> constExprParse();
 
-    [[nodiscard]] std::unique_ptr<TypeBase> typeNameParse();
+    [[nodiscard]] const TypeBase* typeNameParse();
     [[nodiscard]] std::unique_ptr<AbstractDeclarator> abstractDeclaratorParse();
     [[nodiscard]] std::unique_ptr<AbstractDeclarator> directAbstractDeclaratorParse();
 
-    [[nodiscard]] static std::unique_ptr<TypeBase> abstractDeclaratorProcess(
-        std::unique_ptr<AbstractDeclarator>&& abstractDeclarator, std::unique_ptr<TypeBase>&& type);
+    [[nodiscard]] static const TypeBase* abstractDeclaratorProcess(
+        std::unique_ptr<AbstractDeclarator>&& abstractDeclarator, const TypeBase* type);
 
-    [[nodiscard]] std::unique_ptr<std::vector<std::unique_ptr<Expr>>> argumentListParse();
+    [[nodiscard]] std::unique_ptr<ArenaVector<std::unique_ptr<Expr>>> argumentListParse();
     [[nodiscard]] Type typeParse();
     [[nodiscard]] std::tuple<Type, TokenType> specifierParse();
     [[nodiscard]] static Type typeResolve(std::vector<TokenType>& tokens);
 private:
-    Lexing::Token advance() { return c_tokenStore.getToken(m_current++); }
+    TokenType advance() { return c_tokenStore.getType(m_current++); }
     [[nodiscard]] bool isAtEnd() const { return peekTokenType() == TokenType::EndOfFile; }
     [[nodiscard]] static bool continuePrecedenceClimbing(i32 minPrecedence, TokenType nextToken);
-    [[nodiscard]] Lexing::Token peek() const { return c_tokenStore.getToken(m_current); }
     [[nodiscard]] TokenType peekTokenType() const;
     [[nodiscard]] TokenType peekNextTokenType() const;
     [[nodiscard]] TokenType peekNextNextTokenType() const;
@@ -0,0 +1,1123 @@
+#include "Preprocessor.hpp"
+#include "CharScan.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <utility>
+
+namespace Preprocessing {
+
+namespace {
+
+constexpr std::array<std::string_view, 23> multiCharPunctuators = {
+    "...", "<<=", ">>=", "->", "++", "--", "<<", ">>", "<=", ">=", "==", "!=",
+    "&&", "||", "*=", "/=", "%=", "+=", "-=", "&=", "^=", "|=", "##"
+};
+constexpr std::string_view singleCharPunctuators = "[](){}.&*+-~!/%<>^|?:;=,#";
+// The second characters of the punctuators above that are longer than one character.
+constexpr std::string_view punctuatorFollowers = ".<>+-=&|#";
+
+// The macros the glibc and gcc headers test, with the values gcc gives them on x86-64 Linux.
+// Like clang, the preprocessor claims to be gcc 4.2 so the headers take their gcc paths.
+constexpr std::array<std::pair<std::string_view, std::string_view>, 63> predefinedMacros = {{
+    {"__STDC__", "1"},
+    {"__STDC_HOSTED__", "1"},
+    {"__STDC_VERSION__", "201710L"},
+    {"__GNUC__", "4"},
+    {"__GNUC_MINOR__", "2"},
+    {"__GNUC_PATCHLEVEL__", "1"},
+    {"__x86_64__", "1"},
+    {"__x86_64", "1"},
+    {"__amd64__", "1"},
+    {"__amd64", "1"},
+    {"__LP64__", "1"},
+    {"_LP64", "1"},
+    {"__linux__", "1"},
+    {"__linux", "1"},
+    {"__gnu_linux__", "1"},
+    {"__unix__", "1"},
+    {"__unix", "1"},
+    {"__ELF__", "1"},
+    {"__USER_LABEL_PREFIX__", ""},
+    {"__ORDER_LITTLE_ENDIAN__", "1234"},
+    {"__ORDER_BIG_ENDIAN__", "4321"},
+    {"__ORDER_PDP_ENDIAN__", "3412"},
+    {"__BYTE_ORDER__", "__ORDER_LITTLE_ENDIAN__"},
+    {"__FLOAT_WORD_ORDER__", "__ORDER_LITTLE_ENDIAN__"},
+    {"__CHAR_BIT__", "8"},
+    {"__SCHAR_MAX__", "0x7f"},
+    {"__SHRT_MAX__", "0x7fff"},
+    {"__INT_MAX__", "0x7fffffff"},
+    {"__LONG_MAX__", "0x7fffffffffffffffL"},
+    {"__LONG_LONG_MAX__", "0x7fffffffffffffffLL"},
+    {"__WCHAR_MAX__", "0x7fffffff"},
+    {"__WCHAR_MIN__", "(-__WCHAR_MAX__ - 1)"},
+    {"__WINT_MAX__", "0xffffffffU"},
+    {"__WINT_MIN__", "0U"},
+    {"__SIZE_MAX__", "0xffffffffffffffffUL"},
+    {"__PTRDIFF_MAX__", "0x7fffffffffffffffL"},
+    {"__INTMAX_MAX__", "0x7fffffffffffffffL"},
+    {"__UINTMAX_MAX__", "0xffffffffffffffffUL"},
+    {"__INTPTR_MAX__", "0x7fffffffffffffffL"},
+    {"__UINTPTR_MAX__", "0xffffffffffffffffUL"},
+    {"__SIZEOF_SHORT__", "2"},
+    {"__SIZEOF_INT__", "4"},
+    {"__SIZEOF_LONG__", "8"},
+    {"__SIZEOF_LONG_LONG__", "8"},
+    {"__SIZEOF_POINTER__", "8"},
+    {"__SIZEOF_FLOAT__", "4"},
+    {"__SIZEOF_DOUBLE__", "8"},
+    {"__SIZEOF_LONG_DOUBLE__", "16"},
+    {"__SIZEOF_SIZE_T__", "8"},
+    {"__SIZEOF_PTRDIFF_T__", "8"},
+    {"__SIZEOF_WCHAR_T__", "4"},
+    {"__SIZEOF_WINT_T__", "4"},
+    {"__SIZE_TYPE__", "long unsigned int"},
+    {"__PTRDIFF_TYPE__", "long int"},
+    {"__WCHAR_TYPE__", "int"},
+    {"__WINT_TYPE__", "unsigned int"},
+    {"__INTMAX_TYPE__", "long int"},
+    {"__UINTMAX_TYPE__", "long unsigned int"},
+    {"__INTPTR_TYPE__", "long int"},
+    {"__UINTPTR_TYPE__", "long unsigned int"},
+    {"__CHAR16_TYPE__", "short unsigned int"},
+    {"__CHAR32_TYPE__", "unsigned int"},
+    {"__BIGGEST_ALIGNMENT__", "16"},
+}};
+
+bool readFile(const std::filesystem::path& path, std::string& source)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    source.assign(std::istreambuf_iterator(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Drops backslash-newline pairs and puts the swallowed newlines back after the end of
+// the logical line, so every following line keeps its physical line number.
+std::string spliceLines(const std::string_view source)
+{
+    std::string result;
+    result.reserve(source.size());
+    size_t pending = 0;
+    for (size_t i = 0; i < source.size(); ++i) {
+        if (source[i] == '\\') {
+            size_t next = i + 1;
+            if (next < source.size() && source[next] == '\r')
+                ++next;
+            if (next < source.size() && source[next] == '\n') {
+                ++pending;
+                i = next;
+                continue;
+            }
+        }
+        result += source[i];
+        if (source[i] == '\n') {
+            result.append(pending, '\n');
+            pending = 0;
+        }
+    }
+    return result;
+}
+
+// The tokens view the text, which has to outlive them.
+// Returns the line of an unterminated block comment, 0 when the text tokenized cleanly.
+i32 tokenizeText(const std::string_view text, std::vector<PPToken>& tokens)
+{
+    using Lexing::CharScan::isDigit;
+    using Lexing::CharScan::isIdentifierChar;
+    i32 line = 1;
+    bool lineStart = true;
+    bool space = false;
+    size_t i = 0;
+    const size_t size = text.size();
+    while (i < size) {
+        const char ch = text[i];
+        if (ch == '\n') {
+            ++line;
+            lineStart = true;
+            space = false;
+            ++i;
+            continue;
+        }
+        if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\f' || ch == '\v') {
+            space = true;
+            ++i;
+            continue;
+        }
+        if (ch == '/' && i + 1 < size && text[i + 1] == '/') {
+            i = std::min(text.find('\n', i), size);
+            space = true;
+            continue;
+        }
+        if (ch == '/' && i + 1 < size && text[i + 1] == '*') {
+            const size_t end = text.find("*/", i + 2);
+            if (end == std::string_view::npos)
+                return line;
+            line += static_cast<i32>(std::count(text.begin() + i, text.begin() + end, '\n'));
+            i = end + 2;
+            space = true;
+            continue;
+        }
+        PPToken token;
+        token.line = line;
+        token.lineStart = lineStart;
+        token.spaceBefore = space;
+        const size_t start = i;
+        if (isIdentifierChar(ch) && !isDigit(ch)) {
+            i = Lexing::CharScan::identifierEnd(text.data(), i, size);
+            token.kind = PPToken::Kind::Identifier;
+        }
+        else if (isDigit(ch) || (ch == '.' && i + 1 < size && isDigit(text[i + 1]))) {
+            ++i;
+            while (i < size) {
+                const char lower = static_cast<char>(text[i] | 0x20);
+                if ((lower == 'e' || lower == 'p') && i + 1 < size && (text[i + 1] == '+' || text[i + 1] == '-'))
+                    i += 2;
+                else if (isIdentifierChar(text[i]) || text[i] == '.')
+                    ++i;
+                else
+                    break;
+            }
+            token.kind = PPToken::Kind::Number;
+        }
+        else if (ch == '\'' || ch == '"') {
+            ++i;
+            while (i < size && text[i] != ch && text[i] != '\n') {
+                if (text[i] == '\\' && i + 1 < size && text[i + 1] != '\n')
+                    ++i;
+                ++i;
+            }
+            if (i < size && text[i] == ch)
+                ++i;
+            token.kind = ch == '"' ? PPToken::Kind::StringLiteral : PPToken::Kind::CharLiteral;
+        }
+        else {
+            token.kind = PPToken::Kind::Other;
+            const std::string_view rest = text.substr(i);
+            const auto it = 1 < rest.size() && punctuatorFollowers.contains(rest[1])
+                ? std::ranges::find_if(multiCharPunctuators,
+                      [rest](const std::string_view punctuator) { return rest.starts_with(punctuator); })
+                : multiCharPunctuators.end();
+            if (it != multiCharPunctuators.end()) {
+                i += it->size();
+                token.kind = PPToken::Kind::Punctuator;
+            }
+            else {
+                if (singleCharPunctuators.contains(ch))
+                    token.kind = PPToken::Kind::Punctuator;
+                ++i;
+            }
+        }
+        token.text = text.substr(start, i - start);
+        tokens.emplace_back(token);
+        lineStart = false;
+        space = false;
+    }
+    return 0;
+}
+
+std::string quote(const std::string_view text)
+{
+    std::string result = "\"";
+    for (const char ch : text) {
+        if (ch == '"' || ch == '\\')
+            result += '\\';
+        result += ch;
+    }
+    result += '"';
+    return result;
+}
+
+std::string stringize(const std::vector<PPToken>& arg)
+{
+    std::string text;
+    for (size_t i = 0; i < arg.size(); ++i) {
+        if (0 < i && arg[i].spaceBefore)
+            text += ' ';
+        text += arg[i].text;
+    }
+    return quote(text);
+}
+
+bool isWordChar(const char ch)
+{
+    return Lexing::CharScan::isIdentifierChar(ch) || ch == '.';
+}
+
+// Whether writing the two tokens back to back would lex as something else.
+bool needsSeparator(const char previous, const char next)
+{
+    if (isWordChar(previous) && isWordChar(next))
+        return true;
+    const std::array pair{previous, next};
+    const std::string_view joined(pair.data(), pair.size());
+    if (joined == "//" || joined == "/*")
+        return true;
+    return std::ranges::any_of(multiCharPunctuators,
+        [joined](const std::string_view punctuator) { return punctuator.starts_with(joined); });
+}
+
+std::optional<i64> parseNumber(std::string_view text)
+{
+    while (!text.empty() && (text.back() == 'u' || text.back() == 'U' || text.back() == 'l' || text.back() == 'L'))
+        text.remove_suffix(1);
+    i32 base = 10;
+    if (text.starts_with("0x") || text.starts_with("0X")) {
+        base = 16;
+        text.remove_prefix(2);
+    }
+    else if (1 < text.size() && text.front() == '0') {
+        base = 8;
+        text.remove_prefix(1);
+    }
+    u64 value = 0;
+    const auto [end, errorCode] = std::from_chars(text.data(), text.data() + text.size(), value, base);
+    if (errorCode != std::errc() || end != text.data() + text.size())
+        return std::nullopt;
+    return static_cast<i64>(value);
+}
+
+std::optional<i64> parseCharacter(const std::string_view text)
+{
+    if (text.size() < 3 || text.back() != '\'')
+        return std::nullopt;
+    if (text[1] != '\\')
+        return text.size() == 3 ? std::optional<i64>(text[1]) : std::nullopt;
+    switch (text[2]) {
+        case 'n':   return '\n';
+        case 't':   return '\t';
+        case 'r':   return '\r';
+        case '0':   return '\0';
+        case 'a':   return '\a';
+        case 'b':   return '\b';
+        case 'f':   return '\f';
+        case 'v':   return '\v';
+        case '\\':  return '\\';
+        case '\'':  return '\'';
+        case '"':   return '"';
+        case '?':   return '?';
+        default:    return std::nullopt;
+    }
+}
+
+// Value of an #if expression, held as the bits of an intmax_t or an uintmax_t (C11 6.10.1p4).
+struct ConditionValue {
+    u64 bits = 0;
+    bool isUnsigned = false;
+
+    static ConditionValue truth(const bool value) { return {value ? u64{1} : u64{0}, false}; }
+    [[nodiscard]] i64 asSigned() const { return static_cast<i64>(bits); }
+    [[nodiscard]] bool isTrue() const { return bits != 0; }
+};
+
+// Unsuffixed constants that do not fit intmax_t are unsigned as well, like gcc treats them.
+bool isUnsignedConstant(const std::string_view text, const i64 value)
+{
+    return value < 0 || text.find_first_of("uU") != std::string_view::npos;
+}
+
+// Integer constant expression of #if and #elif, after defined and macro replacement.
+// Operands go through the usual arithmetic conversions, the right hand side of a short
+// circuited operator is parsed without reporting division by zero.
+class ConditionEvaluator {
+    const std::vector<PPToken>& c_tokens;
+    size_t m_pos = 0;
+    i32 m_skipping = 0;
+    bool m_valid = true;
+public:
+    explicit ConditionEvaluator(const std::vector<PPToken>& tokens)
+        : c_tokens(tokens) {}
+    std::optional<i64> evaluate()
+    {
+        const ConditionValue value = conditional();
+        if (!m_valid || m_pos != c_tokens.size())
+            return std::nullopt;
+        return value.asSigned();
+    }
+private:
+    [[nodiscard]] bool peekIs(const std::string_view punctuator) const
+    {
+        return m_pos < c_tokens.size() && c_tokens[m_pos].is(punctuator);
+    }
+    bool match(const std::string_view punctuator)
+    {
+        if (!peekIs(punctuator))
+            return false;
+        ++m_pos;
+        return true;
+    }
+    static i32 precedence(const std::string_view op)
+    {
+        if (op == "||")                             return 1;
+        if (op == "&&")                             return 2;
+        if (op == "|")                              return 3;
+        if (op == "^")                              return 4;
+        if (op == "&")                              return 5;
+        if (op == "==" || op == "!=")               return 6;
+        if (op == "<" || op == ">" || op == "<=" || op == ">=")
+                                                    return 7;
+        if (op == "<<" || op == ">>")               return 8;
+        if (op == "+" || op == "-")                 return 9;
+        if (op == "*" || op == "/" || op == "%")    return 10;
+        return 0;
+    }
+    ConditionValue conditional()
+    {
+        const ConditionValue condition = binary(1);
+        if (!match("?"))
+            return condition;
+        m_skipping += !condition.isTrue();
+        const ConditionValue lhs = conditional();
+        m_skipping -= !condition.isTrue();
+        if (!match(":"))
+            m_valid = false;
+        m_skipping += condition.isTrue();
+        const ConditionValue rhs = conditional();
+        m_skipping -= condition.isTrue();
+        const ConditionValue result = condition.isTrue() ? lhs : rhs;
+        return {result.bits, lhs.isUnsigned || rhs.isUnsigned};
+    }
+    ConditionValue binary(const i32 minPrecedence)
+    {
+        ConditionValue lhs = unary();
+        while (m_valid && m_pos < c_tokens.size() && c_tokens[m_pos].kind == PPToken::Kind::Punctuator) {
+            const std::string_view op = c_tokens[m_pos].text;
+            const i32 opPrecedence = precedence(op);
+            if (opPrecedence == 0 || opPrecedence < minPrecedence)
+                break;
+            ++m_pos;
+            const bool shortCircuit = (op == "&&" && !lhs.isTrue()) || (op == "||" && lhs.isTrue());
+            m_skipping += shortCircuit;
+            const ConditionValue rhs = binary(opPrecedence + 1);
+            m_skipping -= shortCircuit;
+            lhs = apply(op, lhs, rhs);
+        }
+        return lhs;
+    }
+    ConditionValue apply(const std::string_view op, const ConditionValue lhs, const ConditionValue rhs)
+    {
+        if (op == "||")     return ConditionValue::truth(lhs.isTrue() || rhs.isTrue());
+        if (op == "&&")     return ConditionValue::truth(lhs.isTrue() && rhs.isTrue());
+        // A shift has the type of its left operand.
+        if (op == "<<")     return {lhs.bits << (rhs.bits & 63), lhs.isUnsigned};
+        if (op == ">>") {
+            if (lhs.isUnsigned)
+                return {lhs.bits >> (rhs.bits & 63), true};
+            return {static_cast<u64>(lhs.asSigned() >> (rhs.bits & 63)), false};
+        }
+        const bool isUnsigned = lhs.isUnsigned || rhs.isUnsigned;
+        const u64 a = lhs.bits;
+        const u64 b = rhs.bits;
+        if (op == "|")      return {a | b, isUnsigned};
+        if (op == "^")      return {a ^ b, isUnsigned};
+        if (op == "&")      return {a & b, isUnsigned};
+        if (op == "+")      return {a + b, isUnsigned};
+        if (op == "-")      return {a - b, isUnsigned};
+        if (op == "*")      return {a * b, isUnsigned};
+        if (op == "==")     return ConditionValue::truth(a == b);
+        if (op == "!=")     return ConditionValue::truth(a != b);
+        if (op == "<")      return ConditionValue::truth(isUnsigned ? a < b : lhs.asSigned() < rhs.asSigned());
+        if (op == ">")      return ConditionValue::truth(isUnsigned ? a > b : lhs.asSigned() > rhs.asSigned());
+        if (op == "<=")     return ConditionValue::truth(isUnsigned ? a <= b : lhs.asSigned() <= rhs.asSigned());
+        if (op == ">=")     return ConditionValue::truth(isUnsigned ? a >= b : lhs.asSigned() >= rhs.asSigned());
+        if (b == 0) {
+            if (m_skipping == 0)
+                m_valid = false;
+            return {0, isUnsigned};
+        }
+        if (isUnsigned)
+            return {op == "/" ? a / b : a % b, true};
+        // The quotient of INT64_MIN / -1 does not fit, it wraps around like gcc computes it.
+        if (lhs.asSigned() == std::numeric_limits<i64>::min() && rhs.asSigned() == -1)
+            return {op == "/" ? a : 0, false};
+        if (op == "/")      return {static_cast<u64>(lhs.asSigned() / rhs.asSigned()), false};
+        return {static_cast<u64>(lhs.asSigned() % rhs.asSigned()), false};
+    }
+    ConditionValue unary()
+    {
+        if (c_tokens.size() <= m_pos) {
+            m_valid = false;
+            return {};
+        }
+        const PPToken& token = c_tokens[m_pos++];
+        if (token.is("+"))
+            return unary();
+        if (token.is("-")) {
+            const ConditionValue value = unary();
+            return {0 - value.bits, value.isUnsigned};
+        }
+        if (token.is("~")) {
+            const ConditionValue value = unary();
+            return {~value.bits, value.isUnsigned};
+        }
+        if (token.is("!"))
+            return ConditionValue::truth(!unary().isTrue());
+        if (token.is("(")) {
+            const ConditionValue value = conditional();
+            if (!match(")"))
+                m_valid = false;
+            return value;
+        }
+        if (token.kind == PPToken::Kind::Number) {
+            const std::optional<i64> value = parseNumber(token.text);
+            if (!value.has_value()) {
+                m_valid = false;
+                return {};
+            }
+            return {static_cast<u64>(*value), isUnsignedConstant(token.text, *value)};
+        }
+        std::optional<i64> value;
+        if (token.kind == PPToken::Kind::CharLiteral)
+            value = parseCharacter(token.text);
+        else if (token.kind == PPToken::Kind::Identifier)
+            value = 0;
+        if (!value.has_value())
+            m_valid = false;
+        return {static_cast<u64>(value.value_or(0)), false};
+    }
+};
+
+} // namespace
+
+bool needsPreprocessing(const std::string_view source)
+{
+    return source.find('#') != std::string_view::npos
+        || source.find("__") != std::string_view::npos
+        || source.find("\\\n") != std::string_view::npos
+        || source.find("\\\r\n") != std::string_view::npos;
+}
+
+Preprocessor::Preprocessor()
+{
+    if (!std::string_view(CC_GCC_INCLUDE_DIR).empty())
+        m_includeDirs.emplace_back(CC_GCC_INCLUDE_DIR);
+    m_includeDirs.emplace_back("/usr/local/include");
+    m_includeDirs.emplace_back("/usr/include/x86_64-linux-gnu");
+    m_includeDirs.emplace_back("/usr/include");
+    for (const auto& [name, replacement] : predefinedMacros)
+        define(name, replacement);
+}
+
+void Preprocessor::addIncludeDirectory(std::filesystem::path dir)
+{
+    m_includeDirs.insert(m_includeDirs.begin() + static_cast<i64>(m_userIncludeDirs++), std::move(dir));
+}
+
+void Preprocessor::define(const std::string_view name, const std::string_view replacement)
+{
+    std::string text(name);
+    text += ' ';
+    text += replacement;
+    std::vector<PPToken> tokens;
+    if (tokenizeText(keep(std::move(text)), tokens) != 0)
+        return;
+    defineDirective(0, tokens);
+}
+
+std::vector<std::string> Preprocessor::processFile(const std::filesystem::path& file, std::string& output)
+{
+    std::string source;
+    if (!readFile(file, source))
+        return {"Could not open file " + file.string()};
+    return process(std::move(source), file, output);
+}
+
+std::vector<std::string> Preprocessor::process(std::string source, const std::filesystem::path& file, std::string& output)
+{
+    if (!needsPreprocessing(source)) {
+        output = std::move(source);
+        return {};
+    }
+    m_output.clear();
+    m_output.reserve(source.size());
+    m_outputLine = 1;
+    m_lastLine = 0;
+    m_lastFile = -1;
+    m_errors.clear();
+    FileContext context{file, file.string(), -1};
+    processText(std::move(source), context);
+    if (!m_output.empty())
+        m_output += '\n';
+    output = std::move(m_output);
+    return std::move(m_errors);
+}
+
+void Preprocessor::processText(std::string source, FileContext& file)
+{
+    file.id = m_fileCount++;
+    m_files.emplace_back(&file);
+    const std::string_view text = keep(source.contains('\\') ? spliceLines(source) : std::move(source));
+    // About one token per four characters in typical C, reserved so the list is not regrown.
+    file.tokens.reserve(text.size() / 4);
+    const i32 unterminated = tokenizeText(text, file.tokens);
+    if (unterminated != 0)
+        error(unterminated, "unterminated comment");
+    processTokens(file);
+    if (!file.conditionals.empty())
+        error(file.tokens.empty() ? 1 : file.tokens.back().line, "unterminated conditional directive");
+    m_files.pop_back();
+}
+
+void Preprocessor::processTokens(FileContext& file)
+{
+    std::vector<PPToken>& tokens = file.tokens;
+    const auto isDirectiveStart = [&tokens](const size_t i) {
+        return tokens[i].lineStart && tokens[i].is("#");
+    };
+    while (file.pos < tokens.size()) {
+        if (isDirectiveStart(file.pos)) {
+            const i32 line = tokens[file.pos].line;
+            size_t end = file.pos + 1;
+            while (end < tokens.size() && !tokens[end].lineStart)
+                ++end;
+            std::vector directiveTokens(tokens.begin() + static_cast<i64>(file.pos) + 1,
+                                        tokens.begin() + static_cast<i64>(end));
+            file.pos = end;
+            directive(file, line, std::move(directiveTokens));
+            continue;
+        }
+        size_t end = file.pos;
+        while (end < tokens.size() && !isDirectiveStart(end))
+            ++end;
+        if (isActive(file)) {
+            Input input{.next = tokens.data() + file.pos, .end = tokens.data() + end};
+            expand(input, [this](const PPToken& token) { emit(token); });
+        }
+        file.pos = end;
+    }
+}
+
+void Preprocessor::directive(FileContext& file, const i32 line, std::vector<PPToken> tokens)
+{
+    if (tokens.empty())
+        return;
+    const std::string_view name = tokens.front().text;
+    if (name == "if" || name == "ifdef" || name == "ifndef" || name == "elif" || name == "else" || name == "endif") {
+        conditionalDirective(file, line, name, std::vector(std::make_move_iterator(tokens.begin() + 1),
+                                                           std::make_move_iterator(tokens.end())));
+        return;
+    }
+    if (!isActive(file))
+        return;
+    if (tokens.front().kind == PPToken::Kind::Number) {
+        lineDirective(file, line, std::move(tokens));
+        return;
+    }
+    std::vector rest(std::make_move_iterator(tokens.begin() + 1), std::make_move_iterator(tokens.end()));
+    if (name == "include" || name == "include_next")
+        includeDirective(file, line, std::move(rest), name == "include_next");
+    else if (name == "define")
+        defineDirective(line, rest);
+    else if (name == "undef") {
+        if (rest.empty() || rest.front().kind != PPToken::Kind::Identifier)
+            error(line, "macro names must be identifiers");
+        else
+            m_macros.erase(rest.front().text);
+    }
+    else if (name == "line")
+        lineDirective(file, line, std::move(rest));
+    else if (name == "error") {
+        std::string message = "#error";
+        for (const PPToken& token : rest) {
+            message += ' ';
+            message += token.text;
+        }
+        error(line, message);
+    }
+    else if (name == "pragma") {
+        if (!rest.empty() && rest.front().text == "once")
+            m_pragmaOnce.insert(std::filesystem::weakly_canonical(file.path).string());
+    }
+    else if (name != "warning")
+        error(line, "invalid preprocessing directive #" + std::string(name));
+}
+
+void Preprocessor::includeDirective(const FileContext& file, const i32 line, std::vector<PPToken> tokens,
+                                    bool next)
+{
+    if (!tokens.empty() && tokens.front().kind != PPToken::Kind::StringLiteral && !tokens.front().is("<"))
+        tokens = expandList(tokens);
+    std::string name;
+    bool angled = false;
+    if (!tokens.empty() && tokens.front().kind == PPToken::Kind::StringLiteral && 2 <= tokens.front().text.size())
+        name = tokens.front().text.substr(1, tokens.front().text.size() - 2);
+    else if (!tokens.empty() && tokens.front().is("<")) {
+        angled = true;
+        size_t i = 1;
+        for (; i < tokens.size() && !tokens[i].is(">"); ++i) {
+            if (1 < i && tokens[i].spaceBefore)
+                name += ' ';
+            name += tokens[i].text;
+        }
+        if (i == tokens.size())
+            name.clear();
+    }
+    if (name.empty()) {
+        error(line, "#include expects \"FILENAME\" or <FILENAME>");
+        return;
+    }
+    // #include_next continues the search after the directory of the current file. In a file
+    // that was not found by a search it is a plain #include, as in gcc.
+    next = next && file.includeDir != -1;
+    std::filesystem::path found;
+    i32 foundDir = -1;
+    if (!angled && !next && std::filesystem::is_regular_file(file.path.parent_path() / name))
+        found = file.path.parent_path() / name;
+    const auto dirCount = static_cast<i32>(m_includeDirs.size());
+    for (i32 dir = next ? file.includeDir + 1 : 0; found.empty() && dir < dirCount; ++dir) {
+        if (std::filesystem::is_regular_file(m_includeDirs[dir] / name)) {
+            found = m_includeDirs[dir] / name;
+            foundDir = dir;
+        }
+    }
+    if (found.empty()) {
+        error(line, name + ": No such file or directory");
+        return;
+    }
+    if (s_maxIncludeDepth <= static_cast<i32>(m_files.size())) {
+        error(line, "#include nested too deeply");
+        return;
+    }
+    if (m_pragmaOnce.contains(std::filesystem::weakly_canonical(found).string()))
+        return;
+    std::string source;
+    if (!readFile(found, source)) {
+        error(line, "could not read " + found.string());
+        return;
+    }
+    FileContext included{found, found.string(), foundDir};
+    processText(std::move(source), included);
+}
+
+void Preprocessor::defineDirective(const i32 line, const std::vector<PPToken>& tokens)
+{
+    if (tokens.empty() || tokens.front().kind != PPToken::Kind::Identifier) {
+        error(line, "macro names must be identifiers");
+        return;
+    }
+    Macro macro;
+    size_t i = 1;
+    if (i < tokens.size() && tokens[i].is("(") && !tokens[i].spaceBefore) {
+        macro.functionLike = true;
+        ++i;
+        bool closed = false;
+        if (i < tokens.size() && tokens[i].is(")")) {
+            closed = true;
+            ++i;
+        }
+        while (!closed && i < tokens.size()) {
+            if (tokens[i].is("...")) {
+                macro.variadic = true;
+                macro.params.emplace_back("__VA_ARGS__");
+                closed = ++i < tokens.size() && tokens[i].is(")");
+                ++i;
+                break;
+            }
+            if (tokens[i].kind != PPToken::Kind::Identifier)
+                break;
+            macro.params.emplace_back(tokens[i].text);
+            if (++i == tokens.size())
+                break;
+            if (tokens[i].is(")")) {
+                closed = true;
+                ++i;
+                break;
+            }
+            if (!tokens[i].is(","))
+                break;
+            ++i;
+        }
+        if (!closed) {
+            error(line, "malformed parameter list of macro " + std::string(tokens.front().text));
+            return;
+        }
+    }
+    if (i < tokens.size())
+        macro.body.assign(tokens.begin() + static_cast<i64>(i), tokens.end());
+    if (!macro.body.empty()) {
+        macro.body.front().spaceBefore = false;
+        if (macro.body.front().is("##") || macro.body.back().is("##")) {
+            error(line, "'##' cannot appear at either end of a macro expansion");
+            return;
+        }
+    }
+    for (size_t j = 0; macro.functionLike && j < macro.body.size(); ++j) {
+        if (!macro.body[j].is("#"))
+            continue;
+        if (j + 1 == macro.body.size() || !std::ranges::contains(macro.params, macro.body[j + 1].text)
+                                      || macro.body[j + 1].kind != PPToken::Kind::Identifier) {
+            error(line, "'#' is not followed by a macro parameter");
+            return;
+        }
+    }
+    m_macros.insert_or_assign(tokens.front().text, std::move(macro));
+}
+
+void Preprocessor::lineDirective(FileContext& file, const i32 line, std::vector<PPToken> tokens)
+{
+    if (!tokens.empty() && tokens.front().kind != PPToken::Kind::Number)
+        tokens = expandList(tokens);
+    const std::optional<i64> number = tokens.empty() ? std::nullopt : parseNumber(tokens.front().text);
+    if (!number.has_value() || (tokens.front().text.front() == '0' && tokens.front().text != "0")) {
+        error(line, "#line directive requires a simple digit sequence");
+        return;
+    }
+    file.lineDelta = static_cast<i32>(*number) - (line + 1);
+    if (1 < tokens.size() && tokens[1].kind == PPToken::Kind::StringLiteral)
+        file.name = tokens[1].text.substr(1, tokens[1].text.size() - 2);
+}
+
+void Preprocessor::conditionalDirective(FileContext& file, const i32 line, const std::string_view name,
+                                        std::vector<PPToken> tokens)
+{
+    if (name == "if" || name == "ifdef" || name == "ifndef") {
+        const bool parentActive = isActive(file);
+        bool value = false;
+        if (parentActive && name == "if")
+            value = evaluateCondition(line, std::move(tokens));
+        else if (parentActive) {
+            if (tokens.empty() || tokens.front().kind != PPToken::Kind::Identifier)
+                error(line, "macro names must be identifiers");
+            else
+                value = isDefined(tokens.front().text) == (name == "ifdef");
+        }
+        file.conditionals.emplace_back(parentActive, value, value, false);
+        return;
+    }
+    if (file.conditionals.empty()) {
+        error(line, "#" + std::string(name) + " without #if");
+        return;
+    }
+    Conditional& conditional = file.conditionals.back();
+    if (name == "endif") {
+        file.conditionals.pop_back();
+        return;
+    }
+    if (conditional.seenElse) {
+        error(line, "#" + std::string(name) + " after #else");
+        return;
+    }
+    if (name == "else") {
+        conditional.seenElse = true;
+        conditional.active = conditional.parentActive && !conditional.taken;
+        conditional.taken = true;
+        return;
+    }
+    if (conditional.taken || !conditional.parentActive) {
+        conditional.active = false;
+        return;
+    }
+    conditional.active = evaluateCondition(line, std::move(tokens));
+    conditional.taken = conditional.active;
+}
+
+bool Preprocessor::evaluateCondition(const i32 line, std::vector<PPToken> tokens)
+{
+    std::vector<PPToken> replaced;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (tokens[i].kind != PPToken::Kind::Identifier || tokens[i].text != "defined") {
+            replaced.emplace_back(tokens[i]);
+            continue;
+        }
+        const bool parenthesized = i + 1 < tokens.size() && tokens[i + 1].is("(");
+        const size_t nameIndex = i + 1 + parenthesized;
+        if (tokens.size() <= nameIndex || tokens[nameIndex].kind != PPToken::Kind::Identifier
+                                       || (parenthesized && (tokens.size() <= nameIndex + 1
+                                                             || !tokens[nameIndex + 1].is(")")))) {
+            error(line, "operator \"defined\" requires an identifier");
+            return false;
+        }
+        PPToken result;
+        result.kind = PPToken::Kind::Number;
+        result.text = isDefined(tokens[nameIndex].text) ? "1" : "0";
+        result.line = tokens[i].line;
+        replaced.emplace_back(result);
+        i = nameIndex + parenthesized;
+    }
+    const std::vector<PPToken> expanded = expandList(std::move(replaced));
+    const std::optional<i64> value = ConditionEvaluator(expanded).evaluate();
+    if (!value.has_value()) {
+        error(line, "invalid expression in conditional directive");
+        return false;
+    }
+    return *value != 0;
+}
+
+template<typename Sink>
+void Preprocessor::expand(Input& input, Sink sink)
+{
+    while (!input.empty()) {
+        PPToken token = input.take();
+        if (token.kind != PPToken::Kind::Identifier || hides(token.hideSet, token.text) || builtinMacro(token)) {
+            sink(token);
+            continue;
+        }
+        const auto it = m_macros.find(token.text);
+        if (it == m_macros.end()) {
+            sink(token);
+            continue;
+        }
+        const Macro& macro = it->second;
+        u32 hideSet = 0;
+        std::vector<PPToken> body;
+        if (!macro.functionLike) {
+            hideSet = token.hideSet;
+            body = substitute(macro, {});
+        }
+        else {
+            if (input.empty() || !input.peek().is("(")) {
+                sink(token);
+                continue;
+            }
+            std::vector<std::vector<PPToken>> args;
+            PPToken closeParen;
+            if (!collectArguments(input, macro, args, closeParen)) {
+                error(token.line, "unterminated argument list invoking macro " + std::string(token.text));
+                return;
+            }
+            if (args.size() != macro.params.size()) {
+                error(token.line, "macro " + std::string(token.text) + " passed " + std::to_string(args.size())
+                                  + " arguments, but takes " + std::to_string(macro.params.size()));
+                continue;
+            }
+            hideSet = hideSetIntersection(token.hideSet, closeParen.hideSet);
+            body = substitute(macro, args);
+        }
+        hideSet = hideSetWith(hideSet, token.text);
+        for (PPToken& bodyToken : body) {
+            bodyToken.hideSet = hideSetUnion(bodyToken.hideSet, hideSet);
+            bodyToken.line = token.line;
+            bodyToken.lineStart = false;
+            bodyToken.fromMacro = true;
+        }
+        if (!body.empty())
+            body.front().spaceBefore = token.spaceBefore;
+        else if (!input.empty() && token.spaceBefore)
+            input.peek().spaceBefore = true;
+        input.stack.insert(input.stack.end(), body.rbegin(), body.rend());
+    }
+}
+
+std::vector<PPToken> Preprocessor::expandList(std::vector<PPToken> tokens)
+{
+    Input input{.next = tokens.data(), .end = tokens.data() + tokens.size()};
+    std::vector<PPToken> out;
+    expand(input, [&out](const PPToken& token) { out.emplace_back(token); });
+    return out;
+}
+
+bool Preprocessor::collectArguments(Input& input, const Macro& macro,
+                                    std::vector<std::vector<PPToken>>& args, PPToken& closeParen)
+{
+    input.take();
+    args.emplace_back();
+    i32 depth = 0;
+    while (true) {
+        if (input.empty())
+            return false;
+        const PPToken token = input.take();
+        if (depth == 0 && token.is(")")) {
+            closeParen = token;
+            break;
+        }
+        if (depth == 0 && token.is(",") && !(macro.variadic && args.size() == macro.params.size())) {
+            args.emplace_back();
+            continue;
+        }
+        if (token.is("("))
+            ++depth;
+        else if (token.is(")"))
+            --depth;
+        args.back().emplace_back(token);
+    }
+    if (macro.params.empty() && args.size() == 1 && args.front().empty())
+        args.clear();
+    if (macro.variadic && args.size() + 1 == macro.params.size())
+        args.emplace_back();
+    return true;
+}
+
+std::vector<PPToken> Preprocessor::substitute(const Macro& macro, const std::vector<std::vector<PPToken>>& args)
+{
+    const auto paramIndex = [&macro](const PPToken& token) -> i64 {
+        if (!macro.functionLike || token.kind != PPToken::Kind::Identifier)
+            return -1;
+        const auto it = std::ranges::find(macro.params, token.text);
+        return it == macro.params.end() ? -1 : it - macro.params.begin();
+    };
+    const std::vector<PPToken>& body = macro.body;
+    std::vector<PPToken> result;
+    bool emptyLhs = false;
+    for (size_t i = 0; i < body.size(); ++i) {
+        const PPToken& token = body[i];
+        if (macro.functionLike && token.is("#")) {
+            result.emplace_back(PPToken{.text = keep(stringize(args[paramIndex(body[i + 1])])),
+                                        .line = token.line,
+                                        .kind = PPToken::Kind::StringLiteral,
+                                        .spaceBefore = token.spaceBefore});
+            ++i;
+            emptyLhs = false;
+            continue;
+        }
+        if (token.is("##")) {
+            const PPToken& rhs = body[++i];
+            const i64 index = paramIndex(rhs);
+            const std::vector<PPToken> rhsTokens = index < 0 ? std::vector{rhs} : args[index];
+            if (rhsTokens.empty())
+                continue;
+            auto rest = rhsTokens.begin();
+            if (!emptyLhs && !result.empty()) {
+                if (!paste(result.back(), rhsTokens.front()))
+                    error(token.line, "pasting \"" + std::string(result.back().text) + "\" and \""
+                                      + std::string(rhsTokens.front().text)
+                                      + "\" does not give a valid preprocessing token");
+                ++rest;
+            }
+            result.insert(result.end(), rest, rhsTokens.end());
+            emptyLhs = false;
+            continue;
+        }
+        const i64 index = paramIndex(token);
+        if (index < 0) {
+            result.emplace_back(token);
+            emptyLhs = false;
+            continue;
+        }
+        const bool pasteFollows = i + 1 < body.size() && body[i + 1].is("##");
+        std::vector<PPToken> replacement = pasteFollows ? args[index] : expandList(args[index]);
+        emptyLhs = replacement.empty();
+        if (!replacement.empty())
+            replacement.front().spaceBefore = token.spaceBefore;
+        result.insert(result.end(), replacement.begin(), replacement.end());
+    }
+    return result;
+}
+
+bool Preprocessor::builtinMacro(PPToken& token)
+{
+    if (token.text == "__LINE__") {
+        token.kind = PPToken::Kind::Number;
+        token.text = keep(std::to_string(logicalLine(token.line)));
+        return true;
+    }
+    if (token.text == "__FILE__") {
+        token.kind = PPToken::Kind::StringLiteral;
+        token.text = keep(quote(m_files.empty() ? std::string() : m_files.back()->name));
+        return true;
+    }
+    return false;
+}
+
+bool Preprocessor::isDefined(const std::string_view name) const
+{
+    return m_macros.contains(name) || name == "__LINE__" || name == "__FILE__";
+}
+
+bool Preprocessor::isActive(const FileContext& file)
+{
+    return file.conditionals.empty() || file.conditionals.back().active;
+}
+
+bool Preprocessor::paste(PPToken& lhs, const PPToken& rhs)
+{
+    std::string text(lhs.text);
+    text += rhs.text;
+    std::vector<PPToken> pasted;
+    if (tokenizeText(text, pasted) != 0 || pasted.size() != 1)
+        return false;
+    lhs.text = keep(std::move(text));
+    lhs.kind = pasted.front().kind;
+    return true;
+}
+
+bool Preprocessor::hides(const u32 hideSet, const std::string_view name) const
+{
+    return hideSet != 0 && std::ranges::contains(m_hideSets[hideSet], name);
+}
+
+u32 Preprocessor::hideSetWith(const u32 hideSet, const std::string_view name)
+{
+    if (hides(hideSet, name))
+        return hideSet;
+    const auto [it, inserted] = m_hideSetsWith.try_emplace({hideSet, name}, static_cast<u32>(m_hideSets.size()));
+    if (inserted) {
+        std::vector<std::string_view> names = m_hideSets[hideSet];
+        names.emplace_back(name);
+        m_hideSets.emplace_back(std::move(names));
+    }
+    return it->second;
+}
+
+u32 Preprocessor::hideSetUnion(u32 lhs, const u32 rhs)
+{
+    if (lhs == rhs || rhs == 0)
+        return lhs;
+    if (lhs == 0)
+        return rhs;
+    // Indexed, hideSetWith can add to m_hideSets.
+    for (size_t i = 0; i < m_hideSets[rhs].size(); ++i)
+        lhs = hideSetWith(lhs, m_hideSets[rhs][i]);
+    return lhs;
+}
+
+u32 Preprocessor::hideSetIntersection(const u32 lhs, const u32 rhs)
+{
+    if (lhs == rhs)
+        return lhs;
+    u32 result = 0;
+    for (size_t i = 0; i < m_hideSets[lhs].size(); ++i)
+        if (hides(rhs, m_hideSets[lhs][i]))
+            result = hideSetWith(result, m_hideSets[lhs][i]);
+    return result;
+}
+
+std::string_view Preprocessor::keep(std::string text)
+{
+    return m_texts.emplace_back(std::move(text));
+}
+
+void Preprocessor::emit(const PPToken& token)
+{
+    const FileContext* file = m_files.back();
+    const i32 line = logicalLine(token.line);
+    if (file->id != m_lastFile || line != m_lastLine) {
+        if (file == m_files.front() && m_outputLine < line) {
+            m_output.append(line - m_outputLine, '\n');
+            m_outputLine = line;
+        }
+        else if (m_lastFile != -1) {
+            m_output += '\n';
+            ++m_outputLine;
+        }
+        m_lastFile = file->id;
+        m_lastLine = line;
+    }
+    else if (token.spaceBefore || ((token.fromMacro || m_lastFromMacro)
+                                   && needsSeparator(m_output.back(), token.text.front()))) {
+        m_output += ' ';
+    }
+    m_output += token.text;
+    m_lastFromMacro = token.fromMacro;
+}
+
+void Preprocessor::error(const i32 line, const std::string& message)
+{
+    if (m_files.empty()) {
+        m_errors.emplace_back("<command line>: " + message);
+        return;
+    }
+    m_errors.emplace_back(m_files.back()->name + ':' + std::to_string(logicalLine(line)) + ": " + message);
+}
+
+i32 Preprocessor::logicalLine(const i32 line) const
+{
+    return m_files.empty() ? line : line + m_files.back()->lineDelta;
+}
+
+} // Preprocessing
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Preprocessing {
+
+struct PPToken {
+    enum class Kind : u8 {
+        Identifier, Number, CharLiteral, StringLiteral, Punctuator, Other
+    };
+    // Views a source buffer or text the preprocessor made, both owned by the preprocessor.
+    std::string_view text;
+    // Index into the hide sets of the preprocessor. Only tokens produced by a macro expansion
+    // have a non-empty one, tokens read from a file keep 0.
+    u32 hideSet = 0;
+    i32 line = 1;
+    Kind kind = Kind::Other;
+    bool spaceBefore = false;
+    bool lineStart = false;
+    bool fromMacro = false;
+    [[nodiscard]] bool is(const std::string_view punctuator) const
+    {
+        return kind == Kind::Punctuator && text == punctuator;
+    }
+};
+
+// Text to text C preprocessor. Handles #include and #include_next, object- and function-like
+// macros (including # and ##), the conditional directives, #line, #error and #pragma once.
+// Angled includes search the directories added with addIncludeDirectory, then the system
+// directories gcc searches, so the glibc and gcc headers can be used as they are.
+// Each logical source line keeps its line number in the output so error locations
+// reported by the later stages still point into the main file.
+class Preprocessor {
+    struct Macro {
+        std::vector<std::string_view> params;
+        std::vector<PPToken> body;
+        bool functionLike = false;
+        bool variadic = false;
+    };
+    struct Conditional {
+        bool parentActive;
+        bool active;
+        bool taken;
+        bool seenElse;
+    };
+    struct FileContext {
+        std::filesystem::path path;
+        std::string name;
+        // The include directory the file was found in, -1 if it was not found by a search.
+        i32 includeDir = -1;
+        std::vector<PPToken> tokens{};
+        std::vector<Conditional> conditionals{};
+        size_t pos = 0;
+        i32 lineDelta = 0;
+        i32 id = 0;
+    };
+    // The tokens still to be expanded: the results of earlier expansions, stacked in reverse
+    // order, in front of the rest of a token list that is read in place.
+    struct Input {
+        std::vector<PPToken> stack{};
+        PPToken* next = nullptr;
+        PPToken* end = nullptr;
+
+        [[nodiscard]] bool empty() const { return stack.empty() && next == end; }
+        [[nodiscard]] PPToken& peek() { return stack.empty() ? *next : stack.back(); }
+        PPToken take()
+        {
+            if (stack.empty())
+                return *next++;
+            const PPToken token = stack.back();
+            stack.pop_back();
+            return token;
+        }
+    };
+    static constexpr i32 s_maxIncludeDepth = 200;
+
+    // Every source buffer and every token text the preprocessor made. Macro definitions view
+    // them, so they live as long as the preprocessor.
+    std::deque<std::string> m_texts;
+    std::unordered_map<std::string_view, Macro> m_macros;
+    // Hide sets are shared between tokens and never change once made, 0 is the empty set.
+    std::vector<std::vector<std::string_view>> m_hideSets{1};
+    std::map<std::pair<u32, std::string_view>, u32> m_hideSetsWith;
+    std::vector<std::filesystem::path> m_includeDirs;
+    size_t m_userIncludeDirs = 0;
+    std::unordered_set<std::string> m_pragmaOnce;
+    std::vector<FileContext*> m_files;
+    std::vector<std::string> m_errors;
+    std::string m_output;
+    i32 m_outputLine = 1;
+    i32 m_lastLine = 0;
+    i32 m_lastFile = -1;
+    i32 m_fileCount = 0;
+    bool m_lastFromMacro = false;
+public:
+    Preprocessor();
+    void addIncludeDirectory(std::filesystem::path dir);
+    void define(std::string_view name, std::string_view replacement);
+
+    // Sources without a directive, line splice or reserved identifier are handed back untouched.
+    [[nodiscard]] std::vector<std::string> processFile(const std::filesystem::path& file, std::string& output);
+    [[nodiscard]] std::vector<std::string> process(std::string source, const std::filesystem::path& file,
+                                                   std::string& output);
+private:
+    void processText(std::string source, FileContext& file);
+    void processTokens(FileContext& file);
+    void directive(FileContext& file, i32 line, std::vector<PPToken> tokens);
+    void includeDirective(const FileContext& file, i32 line, std::vector<PPToken> tokens, bool next);
+    void defineDirective(i32 line, const std::vector<PPToken>& tokens);
+    void lineDirective(FileContext& file, i32 line, std::vector<PPToken> tokens);
+    void conditionalDirective(FileContext& file, i32 line, std::string_view name, std::vector<PPToken> tokens);
+    [[nodiscard]] bool evaluateCondition(i32 line, std::vector<PPToken> tokens);
+
+    template<typename Sink>
+    void expand(Input& input, Sink sink);
+    [[nodiscard]] std::vector<PPToken> expandList(std::vector<PPToken> tokens);
+    [[nodiscard]] static bool collectArguments(Input& input, const Macro& macro,
+                                               std::vector<std::vector<PPToken>>& args, PPToken& closeParen);
+    [[nodiscard]] std::vector<PPToken> substitute(const Macro& macro, const std::vector<std::vector<PPToken>>& args);
+    [[nodiscard]] bool builtinMacro(PPToken& token);
+    [[nodiscard]] bool isDefined(std::string_view name) const;
+    [[nodiscard]] static bool isActive(const FileContext& file);
+    [[nodiscard]] bool paste(PPToken& lhs, const PPToken& rhs);
+
+    [[nodiscard]] bool hides(u32 hideSet, std::string_view name) const;
+    [[nodiscard]] u32 hideSetWith(u32 hideSet, std::string_view name);
+    [[nodiscard]] u32 hideSetUnion(u32 lhs, u32 rhs);
+    [[nodiscard]] u32 hideSetIntersection(u32 lhs, u32 rhs);
+    [[nodiscard]] std::string_view keep(std::string text);
+
+    void emit(const PPToken& token);
+    void error(i32 line, const std::string& message);
+    [[nodiscard]] i32 logicalLine(i32 line) const;
+};
+
+[[nodiscard]] bool needsPreprocessing(std::string_view source);
+
+} // Preprocessing
@@ -16,14 +16,14 @@ void GotoLabelsUnique::visit(Parsing::FuncDeclaration& funDecl)
         return;
     m_labels.clear();
     m_goto.clear();
-    m_funName = funDecl.name;
+    m_funName = funDecl.name.str();
     ASTTraverser::visit(funDecl);
     for (const std::vector<i64>& locations: m_labels | std::views::values)
         if (1 < locations.size())
             for (const auto& location: locations)
                 m_errors.emplace_back("Duplicate labels at ", location);
     for (auto& gotoStmt : m_goto)
-        if (!m_labels.contains(gotoStmt->identifier))
+        if (!m_labels.contains(std::string(gotoStmt->identifier)))
             m_errors.emplace_back("Did not find goto label ", gotoStmt->location);
 }
 
@@ -37,7 +37,7 @@ void GotoLabelsUnique::visit(Parsing::GotoStmt& gotoStmt)
 void GotoLabelsUnique::visit(Parsing::LabelStmt& labelStmt)
 {
     labelStmt.identifier += '.' + m_funName;
-    m_labels[labelStmt.identifier].emplace_back(labelStmt.location);
+    m_labels[std::string(labelStmt.identifier)].emplace_back(labelStmt.location);
     ASTTraverser::visit(labelStmt);
 }
 } // Semantics
\ No newline at end of file
@@ -17,6 +17,14 @@ std::vector<Error> LoopLabeling::programValidate(Parsing::Program& program)
     return std::move(errors);
 }
 
+// Labels are numbered per function, so they do not change when another function does.
+void LoopLabeling::visit(Parsing::FuncDeclaration& funDecl)
+{
+    m_functionName = funDecl.name.str();
+    m_labelCounter = 0;
+    ASTTraverser::visit(funDecl);
+}
+
 void LoopLabeling::visit(Parsing::VarDecl& varDecl)
 {
     if (!varDecl.init)
@@ -26,7 +34,7 @@ void LoopLabeling::visit(Parsing::VarDecl& varDecl)
             initArray(varDecl, errors);
             return;
         }
-        const auto arrayType = dynCast<Parsing::ArrayType>(varDecl.type.get());
+        const auto arrayType = dynCast<const Parsing::ArrayType>(varDecl.type);
         auto singleInitializer = dynCast<Parsing::SingleInitializer>(varDecl.init.get());
         if (isCharacterType(arrayType->elementType->type))
             initCharacterArray(varDecl, *singleInitializer, *arrayType);
@@ -79,9 +87,9 @@ void LoopLabeling::visit(Parsing::CaseStmt& caseStmt)
 void LoopLabeling::visit(Parsing::DefaultStmt& defaultStmt)
 {
     defaultStmt.identifier = switchLabel;
-    if (m_default.contains(defaultStmt.identifier))
+    if (m_default.contains(switchLabel))
         emplaceError("Duplicate default statement ", defaultStmt.location);
-    m_default.insert(defaultStmt.identifier);
+    m_default.insert(switchLabel);
     if (defaultStmt.identifier.empty())
         emplaceError("Default must be in switch statement ", defaultStmt.location);
     ASTTraverser::visit(defaultStmt);
@@ -149,7 +157,7 @@ void LoopLabeling::visit(Parsing::SwitchStmt& switchStmt)
     if (isCharacterType(conditionType)) {
         conditionType = Type::I32;
         switchStmt.condition = std::make_unique<Parsing::CastExpr>(
-            std::make_unique<Parsing::VarType>(Type::I32), std::move(switchStmt.condition));
+            Parsing::varType(Type::I32), std::move(switchStmt.condition));
     }
     if (conditionType == Type::Double || conditionType == Type::Pointer) {
         if (conditionType == Type::Double)
@@ -158,10 +166,12 @@ void LoopLabeling::visit(Parsing::SwitchStmt& switchStmt)
             emplaceError("Pointer as switch condition ", switchStmt.location);
         return;
     }
-    switchCases[switchStmt.identifier] = std::vector<std::variant<i32, i64, u32, u64>>();
+    const std::string identifier(switchStmt.identifier);
+    switchCases[identifier] = std::vector<std::variant<i32, i64, u32, u64>>();
     ASTTraverser::visit(switchStmt);
-    switchStmt.cases = switchCases[switchStmt.identifier];
-    if (m_default.contains(switchStmt.identifier))
+    const std::vector<std::variant<i32, i64, u32, u64>>& cases = switchCases[identifier];
+    switchStmt.cases.assign(cases.begin(), cases.end());
+    if (m_default.contains(identifier))
         switchStmt.hasDefault = true;
     breakLabel = breakTemp;
     switchLabel = switchTemp;
@@ -176,10 +186,10 @@ void initCharacterArray(Parsing::VarDecl& varDecl,
         return;
     const auto stringExpr = dynCast<Parsing::StringExpr>(singleInit.expr.get());
     const i64 diff = arrayType.size - static_cast<i64>(stringExpr->value.size());
-    std::vector<std::unique_ptr<Parsing::Initializer>> initializers;
+    Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>> initializers;
     for (const char ch : stringExpr->value) {
         auto constExpr = std::make_unique<Parsing::ConstExpr>(
-            ch, std::make_unique<Parsing::VarType>(Type::Char));
+            ch, Parsing::varType(Type::Char));
         auto charInit = std::make_unique<Parsing::SingleInitializer>(std::move(constExpr));
         initializers.push_back(std::move(charInit));
     }
@@ -200,7 +210,7 @@ struct Node {
 
 void initArray(Parsing::VarDecl& array, std::vector<Error>& errors)
 {
-    const Type innerArrayType = Ir::getArrayType(array.type.get());
+    const Type innerArrayType = Ir::getArrayType(array.type);
     const auto arrayInit = array.init.get();
     const std::vector<i64> dimensions = getDimensions(array);
     auto[staticInitializer, emplacedPositions] =
@@ -225,7 +235,7 @@ void createInitsWithPositionsCompound(std::stack<Node,
 void createInitsWithPositionsSingle(const Type innerArrayType,
                                     std::vector<Error>& errors,
                                     const std::vector<i64>& dimensions,
-                                    std::vector<std::unique_ptr<Parsing::Initializer>>& staticInitializer,
+                                    Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>>& staticInitializer,
                                     std::vector<std::vector<i64>>& emplacedPositions,
                                     const std::vector<i64>& position,
                                     Parsing::SingleInitializer& singleInit)
@@ -248,9 +258,7 @@ void createInitsWithPositionsSingle(const Type innerArrayType,
     if (innerArrayType == Type::Pointer) {
         std::vector<i64> positionInCompound = position;
         emplacedPositions.emplace_back(positionInCompound);
-        std::string stringValue = stringExpr->value;
-        auto newStringExpr = std::make_unique<Parsing::StringExpr>(stringExpr->location,
-            std::move(stringValue));
+        auto newStringExpr = std::make_unique<Parsing::StringExpr>(stringExpr->location, stringExpr->value);
         auto newSingleInit = std::make_unique<Parsing::SingleInitializer>(std::move(newStringExpr));
         staticInitializer.push_back(std::move(newSingleInit));
         return;
@@ -261,20 +269,20 @@ void createInitsWithPositionsSingle(const Type innerArrayType,
         emplacedPositions.emplace_back(positionInCompound);
         const char ch = stringExpr->value[i];
         auto constExpr = std::make_unique<Parsing::ConstExpr>(
-            ch, std::make_unique<Parsing::VarType>(Type::Char));
+            ch, Parsing::varType(Type::Char));
         auto newSingleInit = std::make_unique<Parsing::SingleInitializer>(std::move(constExpr));
         staticInitializer.push_back(std::move(newSingleInit));
     }
 }
 
-std::tuple<std::vector<std::unique_ptr<Parsing::Initializer>>, std::vector<std::vector<i64>>>
+std::tuple<Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>>, std::vector<std::vector<i64>>>
     createInitsWithPositions(
         const Type innerArrayType,
         Parsing::Initializer* arrayInit,
         std::vector<Error>& errors,
         const std::vector<i64>& dimensions)
 {
-    std::vector<std::unique_ptr<Parsing::Initializer>> staticInitializer;
+    Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>> staticInitializer;
     std::vector<std::vector<i64>> emplacedPositions;
     std::stack<Node, std::vector<Node>> stack;
     std::vector<i64> firstPosition;
@@ -306,10 +314,10 @@ std::tuple<std::vector<std::unique_ptr<Parsing::Initializer>>, std::vector<std::
                     errors.emplace_back("Wrong type for String init", stringInit->location);
                     continue;
                 }
-                std::vector<std::unique_ptr<Parsing::Initializer>> stringInitializer;
+                Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>> stringInitializer;
                 for (const char ch : stringInit->value) {
                     auto constExpr = std::make_unique<Parsing::ConstExpr>(
-                        ch, std::make_unique<Parsing::VarType>(Type::Char));
+                        ch, Parsing::varType(Type::Char));
                     auto singleInit = std::make_unique<Parsing::SingleInitializer>(std::move(constExpr));
                     stringInitializer.push_back(std::move(singleInit));
                 }
@@ -344,15 +352,15 @@ std::unique_ptr<Parsing::Initializer> emplaceNewSingleInit(
     return std::make_unique<Parsing::SingleInitializer>(std::move(singleInit.expr));
 }
 
-std::vector<std::unique_ptr<Parsing::Initializer>> getZeroInits(
-    const std::vector<std::unique_ptr<Parsing::Initializer>>& staticInitializer,
+Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>> getZeroInits(
+    const Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>>& staticInitializer,
     const std::vector<i64>& dimensions,
     const std::vector<std::vector<i64>>& emplacedPositions)
 {
     using InitKind = Parsing::Initializer::Kind;
 
     std::vector<i64> positionBefore;
-    std::vector<std::unique_ptr<Parsing::Initializer>> newInitializers;
+    Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>> newInitializers;
     for (size_t i = 0; i < staticInitializer.size(); ++i) {
         auto init = staticInitializer[i].get();
         const std::vector<i64>& position = emplacedPositions[i];
@@ -418,11 +426,11 @@ bool isZeroSingleInit(const Parsing::Initializer& init)
 std::vector<i64> getDimensions(const Parsing::VarDecl& array)
 {
     std::vector<i64> dimensions;
-    Parsing::TypeBase* type = array.type.get();
+    const Parsing::TypeBase* type = array.type;
     do {
-        const auto arrayType = dynCast<Parsing::ArrayType>(type);
+        const auto arrayType = dynCast<const Parsing::ArrayType>(type);
         dimensions.emplace_back(arrayType->size);
-        type = arrayType->elementType.get();
+        type = arrayType->elementType;
     } while (type->kind == Parsing::TypeBase::Kind::Array);
     return dimensions;
 }
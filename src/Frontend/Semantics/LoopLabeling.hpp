@@ -40,9 +40,13 @@ class LoopLabeling : public Parsing::ASTTraverser {
     std::string breakLabel;
     std::string continueLabel;
     std::string switchLabel;
+    std::string m_functionName;
+    i32 m_labelCounter = 0;
 public:
     std::vector<Error> programValidate(Parsing::Program& program);
 
+    void visit(Parsing::FuncDeclaration& funDecl) override;
+
     void visit(Parsing::VarDecl& varDecl) override;
 
     void visit(Parsing::BreakStmt& breakStmt) override;
@@ -56,7 +60,7 @@ public:
 private:
     static bool isOutsideSwitchStmt(const Parsing::CaseStmt& caseStmt);
     static bool isNonConstantInSwitchCase(const Parsing::CaseStmt& caseStmt);
-    static std::string makeTemporary(const std::string& name);
+    std::string makeTemporary(const std::string& name);
     void emplaceError(std::string&& message, const i64 location)
     {
         errors.emplace_back(std::move(message), location);
@@ -75,8 +79,7 @@ inline bool LoopLabeling::isNonConstantInSwitchCase(const Parsing::CaseStmt& cas
 
 inline std::string LoopLabeling::makeTemporary(const std::string& name)
 {
-    static i32 m_counter = 0;
-    return name + '.' + std::to_string(m_counter++);
+    return name + '.' + m_functionName + '.' + std::to_string(m_labelCounter++);
 }
 
 void initCharacterArray(Parsing::VarDecl& varDecl,
@@ -88,19 +91,19 @@ std::vector<i64> getDimensions(const Parsing::VarDecl& array);
 void createInitsWithPositionsSingle(Type innerArrayType,
                                     std::vector<Error>& errors,
                                     const std::vector<i64>& dimensions,
-                                    std::vector<std::unique_ptr<Parsing::Initializer>>& staticInitializer,
+                                    Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>>& staticInitializer,
                                     std::vector<std::vector<i64>>& emplacedPositions,
                                     const std::vector<i64>& position,
                                     Parsing::SingleInitializer& singleInit);
 std::vector<i64> getScales(const std::vector<i64>& dimensions, i64 size);
-std::tuple<std::vector<std::unique_ptr<Parsing::Initializer>>, std::vector<std::vector<i64>>>
+std::tuple<Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>>, std::vector<std::vector<i64>>>
     createInitsWithPositions(Type innerArrayType,
                              Parsing::Initializer* arrayInit,
                              std::vector<Error>& errors,
                              const std::vector<i64>& dimensions);
 bool isZeroSingleInit(const Parsing::Initializer& init);
-std::vector<std::unique_ptr<Parsing::Initializer>> getZeroInits(
-    const std::vector<std::unique_ptr<Parsing::Initializer>>& staticInitializer,
+Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>> getZeroInits(
+    const Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>>& staticInitializer,
     const std::vector<i64>& dimensions,
     const std::vector<std::vector<i64>>& emplacedPositions);
 std::unique_ptr<Parsing::Initializer> emplaceNewSingleInit(
@@ -112,6 +115,6 @@ i64 getPosition(const std::vector<i64>& position, const std::vector<i64>& dimens
 void emplaceZeroInitIfNecessary(const std::vector<i64>& dimensions,
                                 std::vector<i64>& positionBefore,
                                 const std::vector<i64>& position,
-                                std::vector<std::unique_ptr<Parsing::Initializer>>& newInitializers);
+                                Parsing::ArenaVector<std::unique_ptr<Parsing::Initializer>>& newInitializers);
 
 } // Semantics
\ No newline at end of file
@@ -24,8 +24,7 @@ void TypeResolution::visit(Parsing::FuncDeclaration& funDecl)
         addError("Function declaration does not exist", funDecl.location);
         return;
     }
-    const auto funcType = dynCast<Parsing::FuncType>(funDecl.type.get());
-    std::vector<std::unique_ptr<Parsing::TypeBase>> paramsTypes;
+    const auto funcType = dynCast<const Parsing::FuncType>(funDecl.type);
     if (funcType->returnType->type == Type::Array) {
         addError("Function cannot return array", funDecl.location);
         return;
@@ -33,7 +32,7 @@ void TypeResolution::visit(Parsing::FuncDeclaration& funDecl)
 
     if (funDecl.body != nullptr)
         m_definedFunctions.insert(funDecl.name);
-    const auto type = dynCast<Parsing::FuncType>(funDecl.type.get());
+    const auto type = dynCast<const Parsing::FuncType>(funDecl.type);
     FuncEntry funcEntry(type->params, type->returnType->type, funDecl.storage,
         funDecl.body != nullptr);
     m_functions.emplace_hint(it, funDecl.name, std::move(funcEntry));
@@ -58,11 +57,11 @@ bool TypeResolution::validFuncDecl(const FuncEntry& funcEntry, const Parsing::Fu
         addError("Unequal parameter numbers in function declarations", funDecl.location);
         return false;
     }
-    const auto funcType = dynCast<Parsing::FuncType>(funDecl.type.get());
+    const auto funcType = dynCast<const Parsing::FuncType>(funDecl.type);
     for (size_t i = 0; i < funDecl.params.size(); ++i) {
-        const auto paramTypeEntry = funcEntry.paramTypes[i].get();
-        const auto paramTypeFunc = funcType->params[i].get();
-        if (!Parsing::areEquivalentArrayConversion(*paramTypeEntry, *paramTypeFunc)) {
+        const auto paramTypeEntry = funcEntry.paramTypes[i];
+        const auto paramTypeFunc = funcType->params[i];
+        if (!Parsing::areEquivalentArrayConversion(paramTypeEntry, paramTypeFunc)) {
             addError("Incompatible parameter types in function declarations", funDecl.location);
             return false;
         }
@@ -111,7 +110,7 @@ void TypeResolution::visit(Parsing::VarDecl& varDecl)
 void TypeResolution::verifyArrayInSingleInit(
     const Parsing::VarDecl& varDecl, const Parsing::SingleInitializer& singleInitializer)
 {
-    const auto arrayType = dynCast<Parsing::ArrayType>(varDecl.type.get());
+    const auto arrayType = dynCast<const Parsing::ArrayType>(varDecl.type);
     if (!isCharacterType(arrayType->elementType->type)) {
         addError("Cannot initialize array with single init", varDecl.location);
         return;
@@ -135,15 +134,13 @@ void TypeResolution::handleSingleInit(Parsing::VarDecl& varDecl)
     if (hasError())
         return;
 
-    if (!Parsing::areEquivalentTypes(*varDecl.type, *singleInit->expr->type)) {
+    if (varDecl.type != singleInit->expr->type) {
         if (isVoidPointer(*varDecl.type) && singleInit->expr->type->type == Type::Pointer) {
-            singleInit->expr->type = std::make_unique<Parsing::PointerType>(
-                std::make_unique<Parsing::VarType>(Type::Void));
+            singleInit->expr->type = Parsing::pointerTo(Parsing::varType(Type::Void));
             return;
         }
         if (isVoidPointer(*singleInit->expr->type) && varDecl.type->type == Type::Pointer) {
-            singleInit->expr->type = std::make_unique<Parsing::PointerType>(
-                std::make_unique<Parsing::VarType>(Type::Void));
+            singleInit->expr->type = Parsing::pointerTo(Parsing::varType(Type::Void));
             return;
         }
         if (varDecl.type->type == Type::Pointer) {
@@ -151,9 +148,8 @@ void TypeResolution::handleSingleInit(Parsing::VarDecl& varDecl)
                 addError("Cannot convert pointer init to pointer", varDecl.location);
                 return;
             }
-            auto typeExpr = std::make_unique<Parsing::VarType>(Type::U64);
             varDecl.init = std::make_unique<Parsing::SingleInitializer>(
-                std::make_unique<Parsing::ConstExpr>(0ul, std::move(typeExpr)));
+                std::make_unique<Parsing::ConstExpr>(0ul, Parsing::varType(Type::U64)));
         }
     }
 }
@@ -165,11 +161,11 @@ void TypeResolution::handelCompoundInit(const Parsing::VarDecl& varDecl)
         addError("Cannot have compound initializer on non array", varDecl.location);
         return;
     }
-    const auto arrayType = dynCast<Parsing::ArrayType>(varDecl.type.get());
+    const auto arrayType = dynCast<const Parsing::ArrayType>(varDecl.type);
     if (arrayType->size < compoundInit->initializers.size())
         addError("Compound initializer cannot be longer than array size", varDecl.location);
 
-    const Type arrayTypeInner = Ir::getArrayType(varDecl.type.get());
+    const Type arrayTypeInner = Ir::getArrayType(varDecl.type);
 
     for (const auto& initializer : compoundInit->initializers) {
         if (initializer->kind == Parsing::Initializer::Kind::Single) {
@@ -183,7 +179,7 @@ void TypeResolution::handelCompoundInit(const Parsing::VarDecl& varDecl)
             if (singleInit->expr->type->type != arrayTypeInner) {
                 singleInit->expr = std::make_unique<Parsing::CastExpr>(
                     singleInit->expr->location,
-                    Parsing::deepCopy(*arrayType->elementType),
+                    arrayType->elementType,
                     std::move(singleInit->expr));
             }
         }
@@ -309,9 +305,9 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertArrayType(Parsing::Expr& e
     auto genExpr = convert(expr);
     if (genExpr->type && genExpr->type->type == Type::Array && genExpr->kind != Parsing::Expr::Kind::AddrOf) {
         if (genExpr->kind != Parsing::Expr::Kind::AddrOf) {
-            const auto arrayType = dynCast<Parsing::ArrayType>(genExpr->type.get());
+            const auto arrayType = dynCast<const Parsing::ArrayType>(genExpr->type);
             auto addressOf = std::make_unique<Parsing::AddrOffExpr>(genExpr->location, Parsing::deepCopy(*genExpr));
-            addressOf->type = std::make_unique<Parsing::PointerType>(Parsing::deepCopy(*arrayType->elementType));
+            addressOf->type = Parsing::pointerTo(arrayType->elementType);
             return addressOf;
         }
     }
@@ -392,22 +388,21 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertStringExpr(Parsing::String
 {
     if (m_inArrayInit)
         return deepCopy(expr);
-    expr.type = std::make_unique<Parsing::ArrayType>(
-        std::make_unique<Parsing::VarType>(Type::Char), expr.value.size() + 1);
+    expr.type = Parsing::arrayOf(Parsing::varType(Type::Char), expr.value.size() + 1);
     return deepCopy(expr);
 }
 
 void TypeResolution::validateAndConvertFuncCallArgs(
     Parsing::FuncCallExpr& funCallExpr,
-    const std::unordered_map<std::string, FuncEntry>::iterator& it)
+    const std::unordered_map<Symbol, FuncEntry>::iterator& it)
 {
     for (size_t i = 0; i < funCallExpr.args.size(); ++i) {
         const Parsing::Expr* const callExpr = funCallExpr.args[i].get();
-        const Parsing::TypeBase* const argTypeBase = it->second.paramTypes[i].get();
+        const Parsing::TypeBase* const argTypeBase = it->second.paramTypes[i];
         const Type typeInner = funCallExpr.args[i]->type->type;
         const Type castToType = it->second.paramTypes[i]->type;
         if (typeInner == Type::Pointer && castToType == Type::Pointer) {
-            if (!Parsing::areEquivalentTypes(*callExpr->type, *argTypeBase)
+            if (callExpr->type != argTypeBase
                 && !isVoidPointer(*callExpr->type) && !isVoidPointer(*argTypeBase))
                 addError("Function arg of of different type with param", callExpr->location);
         }
@@ -415,7 +410,7 @@ void TypeResolution::validateAndConvertFuncCallArgs(
             addError("Cannot cast pointer arg to non pointer", callExpr->location);
         if (typeInner != castToType) {
             funCallExpr.args[i] = std::make_unique<Parsing::CastExpr>(
-                Parsing::deepCopy(*argTypeBase), std::move(funCallExpr.args[i]));
+                argTypeBase, std::move(funCallExpr.args[i]));
         }
     }
 }
@@ -432,7 +427,7 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertFuncCallExpr(Parsing::Func
         return Parsing::deepCopy(funCallExpr);
     }
 
-    std::vector<std::unique_ptr<Parsing::Expr>> args;
+    Parsing::ArenaVector<std::unique_ptr<Parsing::Expr>> args;
     for (const auto& arg : funCallExpr.args)
         args.push_back(convertArrayType(*arg));
     funCallExpr.args = std::move(args);
@@ -491,14 +486,14 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertUnaryExpr(Parsing::UnaryEx
         }
     }
     if (unaryExpr.op == Operator::Not)
-        unaryExpr.type = std::make_unique<Parsing::VarType>(s_boolType);
+        unaryExpr.type = Parsing::varType(s_boolType);
     else
-        unaryExpr.type = Parsing::deepCopy(*unaryExpr.innerExpr->type);
+        unaryExpr.type = unaryExpr.innerExpr->type;
 
     if (isCharacterType(unaryExpr.innerExpr->type->type) &&
         (unaryExpr.op == Operator::Negate || unaryExpr.op == Operator::Complement)) {
         unaryExpr.innerExpr = convertOrCastToType(*unaryExpr.innerExpr, Type::I32);
-        unaryExpr.type = std::make_unique<Parsing::VarType>(Type::I32);
+        unaryExpr.type = Parsing::varType(Type::I32);
     }
 
     return Parsing::deepCopy(unaryExpr);
@@ -518,7 +513,7 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertBinaryExpr(Parsing::Binary
         return Parsing::deepCopy(binaryExpr);
     }
     if (binaryExpr.op == BinaryOp::And || binaryExpr.op == BinaryOp::Or) {
-        binaryExpr.type = std::make_unique<Parsing::VarType>(Type::I32);
+        binaryExpr.type = Parsing::varType(Type::I32);
         return Parsing::deepCopy(binaryExpr);
     }
     const Type commonType = getCommonType(leftType, rightType);
@@ -536,7 +531,7 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertBinaryExpr(Parsing::Binary
 bool areValidNonArithmeticTypesInBinaryExpr(const Parsing::BinaryExpr& binaryExpr,
         const Type leftType, const Type rightType, const Type commonType)
 {
-    if (Parsing::areEquivalentTypes(*binaryExpr.lhs->type, *binaryExpr.rhs->type))
+    if (binaryExpr.lhs->type == binaryExpr.rhs->type)
         return true;
     if (canConvertToNullPtr(*binaryExpr.lhs) || canConvertToNullPtr(*binaryExpr.rhs))
         return true;
@@ -556,7 +551,7 @@ std::unique_ptr<Parsing::Expr> TypeResolution::handleAddSubtractPtrToIntegerType
     if (isIntegerType(rightType)) {
         if (rightType != Type::I64)
             binaryExpr.rhs = convertOrCastToType(*binaryExpr.rhs, Type::I64);
-        binaryExpr.type = Parsing::deepCopy(*binaryExpr.lhs->type);
+        binaryExpr.type = binaryExpr.lhs->type;
     }
     else if (isIntegerType(leftType)) {
         if (binaryExpr.op == BinaryOp::Subtract) {
@@ -565,11 +560,11 @@ std::unique_ptr<Parsing::Expr> TypeResolution::handleAddSubtractPtrToIntegerType
         }
         if (leftType != Type::I64)
             binaryExpr.lhs = convertOrCastToType(*binaryExpr.lhs, Type::I64);
-        binaryExpr.type = Parsing::deepCopy(*binaryExpr.rhs->type);
+        binaryExpr.type = binaryExpr.rhs->type;
         auto returnExpr = std::make_unique<Parsing::BinaryExpr>(binaryExpr.location,
             binaryExpr.op, std::move(binaryExpr.rhs), std::move(binaryExpr.lhs));
         if (binaryExpr.type)
-            returnExpr->type =  std::move(binaryExpr.type);
+            returnExpr->type = binaryExpr.type;
         return returnExpr;
     }
     return Parsing::deepCopy(binaryExpr);
@@ -577,9 +572,9 @@ std::unique_ptr<Parsing::Expr> TypeResolution::handleAddSubtractPtrToIntegerType
 
 std::unique_ptr<Parsing::Expr> TypeResolution::handlePtrToPtrBinaryOpers(Parsing::BinaryExpr& binaryExpr)
 {
-    if (Parsing::areEquivalentTypes(*binaryExpr.lhs->type, *binaryExpr.rhs->type)) {
+    if (binaryExpr.lhs->type == binaryExpr.rhs->type) {
         if (isBinaryComparison(binaryExpr.op)) {
-            binaryExpr.type = std::make_unique<Parsing::VarType>(Type::I32);
+            binaryExpr.type = Parsing::varType(Type::I32);
             return Parsing::deepCopy(binaryExpr);
         }
         if (isVoidPointer(*binaryExpr.lhs->type) || isVoidPointer(*binaryExpr.rhs->type)) {
@@ -587,13 +582,13 @@ std::unique_ptr<Parsing::Expr> TypeResolution::handlePtrToPtrBinaryOpers(Parsing
             return Parsing::deepCopy(binaryExpr);
         }
         if (binaryExpr.op == BinaryOp::Subtract) {
-            binaryExpr.type = std::make_unique<Parsing::VarType>(Type::I64);
+            binaryExpr.type = Parsing::varType(Type::I64);
             return Parsing::deepCopy(binaryExpr);
         }
     }
     if ((binaryExpr.op == BinaryOp::Equal || binaryExpr.op == BinaryOp::NotEqual) &&
         (isVoidPointer(*binaryExpr.lhs->type) || isVoidPointer(*binaryExpr.rhs->type))) {
-        binaryExpr.type = std::make_unique<Parsing::VarType>(Type::I32);
+        binaryExpr.type = Parsing::varType(Type::I32);
         return Parsing::deepCopy(binaryExpr);
     }
     addError("Cannot apply operator to pointers", binaryExpr.location);
@@ -633,15 +628,15 @@ std::unique_ptr<Parsing::Expr> TypeResolution::handleBinaryPtr(Parsing::BinaryEx
 
     if (leftType != Type::Pointer) {
         binaryExpr.lhs = std::make_unique<Parsing::CastExpr>(binaryExpr.lhs->location,
-            std::move(Parsing::deepCopy(*binaryExpr.rhs->type)), std::move(binaryExpr.lhs));
+            binaryExpr.rhs->type, std::move(binaryExpr.lhs));
     }
     if (rightType != Type::Pointer) {
         binaryExpr.rhs = std::make_unique<Parsing::CastExpr>(binaryExpr.rhs->location,
-            std::move(Parsing::deepCopy(*binaryExpr.lhs->type)), std::move(binaryExpr.rhs));
+            binaryExpr.lhs->type, std::move(binaryExpr.rhs));
     }
 
     if (binaryExpr.op == BinaryOp::Equal || binaryExpr.op == BinaryOp::NotEqual)
-        binaryExpr.type = std::make_unique<Parsing::VarType>(Type::I32);
+        binaryExpr.type = Parsing::varType(Type::I32);
     return Parsing::deepCopy(binaryExpr);
 }
 
@@ -678,12 +673,12 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertAssignExpr(Parsing::Assign
         }
         else {
             assignmentExpr.rhs = std::make_unique<Parsing::CastExpr>(
-                std::make_unique<Parsing::VarType>(leftType), std::move(assignmentExpr.rhs));
+                Parsing::varType(leftType), std::move(assignmentExpr.rhs));
         }
     }
     if (leftType == Type::Pointer && isIntegerType(rightType))
         assignmentExpr.rhs = convertOrCastToType(*assignmentExpr.rhs, Type::I64);
-    assignmentExpr.type = Parsing::deepCopy(*assignmentExpr.lhs->type);
+    assignmentExpr.type = assignmentExpr.lhs->type;
     return Parsing::deepCopy(assignmentExpr);
 }
 
@@ -695,7 +690,7 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertCastExpr(Parsing::CastExpr
         return Parsing::deepCopy(castExpr);
     const Type outerType = castExpr.type->type;
     const Type innerType = castExpr.innerExpr->type->type;
-    if (Parsing::areEquivalentTypes(*castExpr.type, *castExpr.innerExpr->type))
+    if (castExpr.type == castExpr.innerExpr->type)
         return Parsing::deepCopy(castExpr);
     if (innerType == Type::Void)
         addError("Cannot cast to void", castExpr.location);
@@ -710,8 +705,7 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertCastExpr(Parsing::CastExpr
     if (isArithmetic(outerType) && isArithmetic(innerType))
         return convertOrCastToType(*castExpr.innerExpr, outerType);
     if (outerType == Type::Pointer && innerType == Type::Pointer) {
-        auto innerTypeCopy = Parsing::deepCopy(*castExpr.type);
-        castExpr.innerExpr->type = std::move(innerTypeCopy);
+        castExpr.innerExpr->type = castExpr.type;
         return Parsing::deepCopy(*castExpr.innerExpr);
     }
     return Parsing::deepCopy(castExpr);
@@ -739,11 +733,10 @@ bool TypeResolution::isLegalAssignExpr(Parsing::AssignmentExpr& assignmentExpr)
     }
     if (leftType == Type::Pointer && rightType == Type::Pointer) {
         if (isVoidPointer(*assignmentExpr.lhs->type)) {
-            assignmentExpr.rhs->type = std::make_unique<Parsing::PointerType>(
-                std::make_unique<Parsing::VarType>(Type::Void));
+            assignmentExpr.rhs->type = Parsing::pointerTo(Parsing::varType(Type::Void));
             return true;
         }
-        if (!Parsing::areEquivalentTypes(*assignmentExpr.lhs->type, *assignmentExpr.rhs->type)
+        if (assignmentExpr.lhs->type != assignmentExpr.rhs->type
             && !isVoidPointer(*assignmentExpr.rhs->type)) {
             addError("Cannot assign pointer of different types", assignmentExpr.location);
             return false;
@@ -753,7 +746,7 @@ bool TypeResolution::isLegalAssignExpr(Parsing::AssignmentExpr& assignmentExpr)
     if (leftType == Type::Pointer) {
         if (canConvertToNullPtr(*assignmentExpr.rhs)) {
             assignmentExpr.rhs = std::make_unique<Parsing::CastExpr>(
-                Parsing::deepCopy(*assignmentExpr.lhs->type), std::move(assignmentExpr.rhs));
+                assignmentExpr.lhs->type, std::move(assignmentExpr.rhs));
         }
         else if (assignmentExpr.lhs->kind == Parsing::Expr::Kind::Subscript)
             return true;
@@ -774,13 +767,12 @@ std::unique_ptr<Parsing::Expr> TypeResolution::validateAndConvertPtrsInTernaryEx
 {
     if (trueType == Type::Pointer && falseType == Type::Pointer) {
         if (isVoidPointer(*ternaryExpr.trueExpr->type) || isVoidPointer(*ternaryExpr.falseExpr->type)) {
-            ternaryExpr.type = std::make_unique<Parsing::PointerType>(
-                std::make_unique<Parsing::VarType>(Type::Void));
+            ternaryExpr.type = Parsing::pointerTo(Parsing::varType(Type::Void));
             return Parsing::deepCopy(ternaryExpr);
         }
-        if (!Parsing::areEquivalentTypes(*ternaryExpr.trueExpr->type, *ternaryExpr.falseExpr->type))
+        if (ternaryExpr.trueExpr->type != ternaryExpr.falseExpr->type)
             addError("Ternary true and false expression must have same type", ternaryExpr.location);
-        ternaryExpr.type = std::move(Parsing::deepCopy(*ternaryExpr.trueExpr->type));
+        ternaryExpr.type = ternaryExpr.trueExpr->type;
         return Parsing::deepCopy(ternaryExpr);
     }
     if (!areValidNonArithmeticTypesInTernaryExpr(ternaryExpr)) {
@@ -789,13 +781,13 @@ std::unique_ptr<Parsing::Expr> TypeResolution::validateAndConvertPtrsInTernaryEx
     }
     if (trueType != Type::Pointer) {
         ternaryExpr.trueExpr = std::make_unique<Parsing::CastExpr>(
-            std::move(Parsing::deepCopy(*ternaryExpr.falseExpr->type)), std::move(ternaryExpr.trueExpr));
+            ternaryExpr.falseExpr->type, std::move(ternaryExpr.trueExpr));
     }
     if (falseType != Type::Pointer) {
         ternaryExpr.falseExpr = std::make_unique<Parsing::CastExpr>(
-            std::move(Parsing::deepCopy(*ternaryExpr.trueExpr->type)), std::move(ternaryExpr.falseExpr));
+            ternaryExpr.trueExpr->type, std::move(ternaryExpr.falseExpr));
     }
-    ternaryExpr.type = std::move(Parsing::deepCopy(*ternaryExpr.trueExpr->type));
+    ternaryExpr.type = ternaryExpr.trueExpr->type;
     return Parsing::deepCopy(ternaryExpr);
 }
 
@@ -811,7 +803,7 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertTernaryExpr(Parsing::Terna
     const Type trueType = ternaryExpr.trueExpr->type->type;
     const Type falseType = ternaryExpr.falseExpr->type->type;
     if (trueType == Type::Void && falseType == Type::Void) {
-        ternaryExpr.type = Parsing::deepCopy(*ternaryExpr.trueExpr->type);
+        ternaryExpr.type = ternaryExpr.trueExpr->type;
         return Parsing::deepCopy(ternaryExpr);
     }
     if (trueType == Type::Void || falseType == Type::Void) {
@@ -823,17 +815,17 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertTernaryExpr(Parsing::Terna
         return validateAndConvertPtrsInTernaryExpr(ternaryExpr, trueType, falseType);
     if (commonType != trueType)
         ternaryExpr.trueExpr = std::make_unique<Parsing::CastExpr>(
-            std::make_unique<Parsing::VarType>(commonType), std::move(ternaryExpr.trueExpr));
+            Parsing::varType(commonType), std::move(ternaryExpr.trueExpr));
     if (commonType != falseType)
         ternaryExpr.falseExpr = std::make_unique<Parsing::CastExpr>(
-            std::make_unique<Parsing::VarType>(commonType), std::move(ternaryExpr.falseExpr));
-    ternaryExpr.type = std::make_unique<Parsing::VarType>(commonType);
+            Parsing::varType(commonType), std::move(ternaryExpr.falseExpr));
+    ternaryExpr.type = Parsing::varType(commonType);
     return Parsing::deepCopy(ternaryExpr);
 }
 
 bool areValidNonArithmeticTypesInTernaryExpr(const Parsing::TernaryExpr& ternaryExpr)
 {
-    if (Parsing::areEquivalentTypes(*ternaryExpr.trueExpr->type, *ternaryExpr.falseExpr->type))
+    if (ternaryExpr.trueExpr->type == ternaryExpr.falseExpr->type)
         return true;
     if (canConvertToNullPtr(*ternaryExpr.trueExpr) || canConvertToNullPtr(*ternaryExpr.falseExpr))
         return true;
@@ -850,8 +842,7 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertAddrOfExpr(Parsing::AddrOf
         addError("Cannot have address-of of address-of operation", addrOffExpr.location);
         return Parsing::deepCopy(addrOffExpr);
     }
-    addrOffExpr.type = std::make_unique<Parsing::PointerType>(
-        Parsing::deepCopy(*addrOffExpr.reference->type));
+    addrOffExpr.type = Parsing::pointerTo(addrOffExpr.reference->type);
     return Parsing::deepCopy(addrOffExpr);
 }
 
@@ -865,8 +856,8 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertDerefExpr(Parsing::Derefer
         addError("Cannot dereference non pointer", dereferenceExpr.location);
         return Parsing::deepCopy(dereferenceExpr);
     }
-    const auto referencedPtrType = dynCast<const Parsing::PointerType>(dereferenceExpr.reference->type.get());
-    dereferenceExpr.type = Parsing::deepCopy(*referencedPtrType->referenced);
+    const auto referencedPtrType = dynCast<const Parsing::PointerType>(dereferenceExpr.reference->type);
+    dereferenceExpr.type = referencedPtrType->referenced;
     return Parsing::deepCopy(dereferenceExpr);
 }
 
@@ -901,8 +892,8 @@ std::unique_ptr<Parsing::Expr> TypeResolution::convertSubscriptExpr(Parsing::Sub
     const auto subscriptExprPtr = dynCast<Parsing::SubscriptExpr>(result.get());
     if (subscriptExprPtr->index->type->type != Type::I64)
         subscriptExprPtr->index = convertOrCastToType(*subscriptExprPtr->index, Type::I64);
-    const auto ptrType = dynCast<Parsing::PointerType>(subscriptExprPtr->referencing->type.get());
-    result->type = Parsing::deepCopy(*ptrType->referenced);
+    const auto ptrType = dynCast<const Parsing::PointerType>(subscriptExprPtr->referencing->type);
+    result->type = ptrType->referenced;
     return result;
 }
 
@@ -20,32 +20,28 @@ void convertConstantExprRudolf(Parsing::VarDecl& varDecl, const Parsing::ConstEx
     const TargetType value = getValueFromConst<TargetType>(constExpr);
     varDecl.init = std::make_unique<Parsing::SingleInitializer>(
             std::make_unique<Parsing::ConstExpr>(
-        value, std::make_unique<Parsing::VarType>(TargetKind)));
+        value, Parsing::varType(TargetKind)));
 }
 
 class TypeResolution final : public Parsing::ASTTraverser {
     static constexpr auto s_boolType = Type::I32;
 
     struct FuncEntry {
-        std::vector<std::unique_ptr<Parsing::TypeBase>> paramTypes;
+        std::vector<const Parsing::TypeBase*> paramTypes;
         Type returnType;
         Parsing::Declaration::StorageClass storage;
         bool defined;
-        FuncEntry(const std::vector<std::unique_ptr<Parsing::TypeBase>>& params,
+        FuncEntry(const std::vector<const Parsing::TypeBase*>& params,
                   const Type returnType,
                   const Parsing::Declaration::StorageClass storage,
                   const bool defined)
-            : returnType(returnType), storage(storage), defined(defined)
-        {
-            for (const auto& paramType : params)
-                paramTypes.emplace_back(std::move(Parsing::deepCopy(*paramType)));
-        }
+            : paramTypes(params), returnType(returnType), storage(storage), defined(defined) {}
     };
     using Storage = Parsing::Declaration::StorageClass;
-    std::unordered_map<std::string, FuncEntry> m_functions;
-    std::unordered_set<std::string> m_definedFunctions;
-    std::unordered_set<std::string> m_localExternVars;
-    std::unordered_set<std::string> m_globalStaticVars;
+    std::unordered_map<Symbol, FuncEntry> m_functions;
+    std::unordered_set<Symbol> m_definedFunctions;
+    std::unordered_set<Symbol> m_localExternVars;
+    std::unordered_set<Symbol> m_globalStaticVars;
     std::vector<Error> m_errors;
     bool m_isConst = true;
     bool m_global = true;
@@ -90,7 +86,7 @@ public:
     std::unique_ptr<Parsing::Expr> convertFuncCallExpr(Parsing::FuncCallExpr& funCallExpr);
     void validateAndConvertFuncCallArgs(
         Parsing::FuncCallExpr& funCallExpr,
-        const std::unordered_map<std::string, FuncEntry>::iterator& it);
+        const std::unordered_map<Symbol, FuncEntry>::iterator& it);
     std::unique_ptr<Parsing::Expr> convertDerefExpr(Parsing::DereferenceExpr& dereferenceExpr);
     std::unique_ptr<Parsing::Expr> convertAddrOfExpr(Parsing::AddrOffExpr& addrOffExpr);
     std::unique_ptr<Parsing::Expr> convertSubscriptExpr(Parsing::SubscriptExpr& subscriptExpr);
@@ -110,7 +106,7 @@ public:
 private:
     void addError(const std::string& error, const i64 location) { m_errors.emplace_back(error, location); }
     [[nodiscard]] bool hasError() const { return !m_errors.empty(); }
-    std::unique_ptr<Parsing::TypeBase> getCommonPointerType(
+    const Parsing::TypeBase* getCommonPointerType(
         const std::unique_ptr<Parsing::Expr>& left,
         const std::unique_ptr<Parsing::Expr>& right);
 };
@@ -22,21 +22,21 @@ void assignTypeToArithmeticBinaryExpr(Parsing::BinaryExpr& binaryExpr)
     if (binaryExpr.op == BinaryOp::LeftShift || binaryExpr.op == BinaryOp::RightShift) {
         if (isCharacterType(leftType)) {
             binaryExpr.lhs = std::make_unique<Parsing::CastExpr>(
-                std::make_unique<Parsing::VarType>(Type::I32), std::move(binaryExpr.lhs));
-            binaryExpr.type = std::make_unique<Parsing::VarType>(Type::I32);
+                Parsing::varType(Type::I32), std::move(binaryExpr.lhs));
+            binaryExpr.type = Parsing::varType(Type::I32);
             return;
         }
-        binaryExpr.type = std::make_unique<Parsing::VarType>(leftType);
+        binaryExpr.type = Parsing::varType(leftType);
         return;
     }
     if (isBinaryComparison(binaryExpr.op)) {
         if (commonType == Type::Double || isSigned(commonType))
-            binaryExpr.type = std::make_unique<Parsing::VarType>(Type::I32);
+            binaryExpr.type = Parsing::varType(Type::I32);
         else
-            binaryExpr.type = std::make_unique<Parsing::VarType>(Type::U32);
+            binaryExpr.type = Parsing::varType(Type::U32);
         return;
     }
-    binaryExpr.type = std::make_unique<Parsing::VarType>(commonType);
+    binaryExpr.type = Parsing::varType(commonType);
 }
 
 bool isZeroArithmeticType(const Parsing::ConstExpr& constExpr)
@@ -110,7 +110,7 @@ std::unique_ptr<Parsing::Expr> convertToArithmeticType(const Parsing::Expr& expr
     return std::make_unique<Parsing::ConstExpr>(
         constExpr->location,
         convertedValue,
-        std::make_unique<Parsing::VarType>(targetType));
+        Parsing::varType(targetType));
 }
 
 bool isVoidPointer(const Parsing::TypeBase& type)
@@ -133,7 +133,7 @@ bool isArrayOfVoidPointer(const Parsing::TypeBase& type)
     const Parsing::TypeBase* currentType = &type;
     while (currentType->kind == Parsing::TypeBase::Kind::Array) {
         const auto arrayType = dynCast<const Parsing::ArrayType>(currentType);
-        currentType = arrayType->elementType.get();
+        currentType = arrayType->elementType;
     }
     return isVoidPointer(*currentType);
 }
@@ -165,7 +165,7 @@ std::unique_ptr<Parsing::Expr> convertOrCastToType(const Parsing::Expr& expr, co
     if (expr.kind != Parsing::Expr::Kind::Constant) {
         return std::make_unique<Parsing::CastExpr>(
             expr.location,
-            std::make_unique<Parsing::VarType>(targetType),
+            Parsing::varType(targetType),
             Parsing::deepCopy(expr));
     }
     return convertToArithmeticType(expr, targetType);
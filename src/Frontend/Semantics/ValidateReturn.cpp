@@ -36,14 +36,14 @@ void ValidateReturn::visit(Parsing::FuncDeclaration& funDecl)
         return;
     }
     const auto returnStmt = dynCast<Parsing::ReturnStmt>(stmtBlockItem->stmt.get());
-    const auto funcType = dynCast<const Parsing::FuncType>(funDecl.type.get());
+    const auto funcType = dynCast<const Parsing::FuncType>(funDecl.type);
     if (funcType->returnType->type == Type::Pointer && returnStmt->expr->type->type != Type::Pointer) {
         if (!canConvertToNullPtr(*returnStmt->expr)) {
             m_errors.emplace_back("Cannot convert return type to pointer ", returnStmt->expr->location);
             return;
         }
         returnStmt->expr = std::make_unique<Parsing::CastExpr>(
-            Parsing::deepCopy(*funcType->returnType), std::move(returnStmt->expr));
+            funcType->returnType, std::move(returnStmt->expr));
     }
     if (funcType->returnType->type == Type::Void) {
         if (returnStmt->expr) {
@@ -61,16 +61,14 @@ void ValidateReturn::visit(Parsing::FuncDeclaration& funDecl)
     assert(returnStmt->expr->type->type);
     if (funcType->returnType->type == Type::Pointer || returnStmt->expr->type->type == Type::Pointer) {
         if (isVoidPointer(*funcType->returnType)) {
-            returnStmt->expr->type = std::make_unique<Parsing::PointerType>(
-                std::make_unique<Parsing::VarType>(Type::Void));
+            returnStmt->expr->type = Parsing::pointerTo(Parsing::varType(Type::Void));
             return;
         }
         if (isVoidPointer(*returnStmt->expr->type) && funcType->returnType->type == Type::Pointer) {
-            returnStmt->expr->type = std::make_unique<Parsing::PointerType>(
-                std::make_unique<Parsing::VarType>(Type::Void));
+            returnStmt->expr->type = Parsing::pointerTo(Parsing::varType(Type::Void));
             return;
         }
-        if (!Parsing::areEquivalentTypes(*funcType->returnType, *returnStmt->expr->type)) {
+        if (funcType->returnType != returnStmt->expr->type) {
             m_errors.emplace_back("Return type does not conform to function return type ",
                                 returnStmt->expr->location);
             return;
@@ -78,7 +76,7 @@ void ValidateReturn::visit(Parsing::FuncDeclaration& funDecl)
     }
     if (funcType->returnType->type != returnStmt->expr->type->type) {
         returnStmt->expr = std::make_unique<Parsing::CastExpr>(
-            std::make_unique<Parsing::VarType>(funcType->returnType->type),
+            Parsing::varType(funcType->returnType->type),
             std::move(returnStmt->expr));
     }
 }
@@ -17,7 +17,7 @@ private:
 
 inline void ValidateReturn::addReturnZero(Parsing::FuncDeclaration& funDecl)
 {
-    auto zeroConstExpr = std::make_unique<Parsing::ConstExpr>(0, std::make_unique<Parsing::VarType>(Type::I32));
+    auto zeroConstExpr = std::make_unique<Parsing::ConstExpr>(0, Parsing::varType(Type::I32));
     auto returnStmt = std::make_unique<Parsing::ReturnStmt>(std::move(zeroConstExpr));
     auto returnBlockStmt = std::make_unique<Parsing::StmtBlockItem>(std::move(returnStmt));
     funDecl.body->body.push_back(std::move(returnBlockStmt));
@@ -22,6 +22,8 @@ void VariableResolution::visit(Parsing::FuncDeclaration& funDecl)
     validateFuncDecl(funDecl, m_symbolTable, prevEntry);
     addFuncToSymbolTable(funDecl, prevEntry);
     if (funDecl.body) {
+        m_functionName = funDecl.name.str();
+        m_nameCounter = 0;
         FunctionGuard functionGuard(m_symbolTable, funDecl);
         ScopeGuard guard(m_symbolTable);
         funDecl.body->accept(*this);
@@ -50,7 +52,7 @@ void VariableResolution::validateFuncDecl(const Parsing::FuncDeclaration& funDec
     if (returnedEntry.hasExternalLinkage() && funDecl.storage == Storage::Static)
         addError("Functions with different linkage", funDecl.location);
     if (returnedEntry.typeBase->type == Type::Function) {
-        const auto funcType = dynCast<const Parsing::FuncType>(returnedEntry.typeBase.get());
+        const auto funcType = dynCast<const Parsing::FuncType>(returnedEntry.typeBase);
         if (funcType->params.size() != funDecl.params.size())
             addError("Functions with different parameter count", funDecl.location);
     }
@@ -58,7 +60,7 @@ void VariableResolution::validateFuncDecl(const Parsing::FuncDeclaration& funDec
 
 void VariableResolution::checkFuncDeclForTypeVoid(const Parsing::FuncDeclaration& funDecl)
 {
-    const auto funcType = dynCast<const Parsing::FuncType>(funDecl.type.get());
+    const auto funcType = dynCast<const Parsing::FuncType>(funDecl.type);
     for (const auto& param : funcType->params) {
         if (param->type == Type::Void) {
             addError("Function with void param type", funDecl.location);
@@ -73,10 +75,10 @@ void VariableResolution::checkFuncDeclForTypeVoid(const Parsing::FuncDeclaration
     }
 }
 
-bool duplicatesInArgs(const std::vector<std::string>& args)
+bool duplicatesInArgs(const Parsing::ArenaVector<Symbol>& args)
 {
-    std::unordered_set<std::string> duplicates;
-    for (const std::string& arg : args) {
+    std::unordered_set<Symbol> duplicates;
+    for (const Symbol arg : args) {
         if (duplicates.contains(arg))
             return true;
         duplicates.insert(arg);
@@ -146,7 +148,7 @@ void VariableResolution::validateVarDeclGlobal(const Parsing::VarDecl& varDecl,
         addError("Conflicting variable linkage", varDecl.location);
     if (varDecl.storage == Storage::None && prevEntry.hasInternalLinkage())
         addError("Conflicting variable linkage", varDecl.location);
-    if (varDecl.type->type == Type::Array && !Parsing::areEquivalentTypes(*varDecl.type, *prevEntry.typeBase))
+    if (varDecl.type->type == Type::Array && varDecl.type != prevEntry.typeBase)
         addError("Cannot define arrays with different types", varDecl.location);
 }
 
@@ -162,7 +164,7 @@ void VariableResolution::visit(Parsing::VarExpr& varExpr)
             varExpr.referingTo = ReferingTo::Extern;
         if (returnedEntry.hasInternalLinkage())
             varExpr.referingTo = ReferingTo::Static;
-        varExpr.type = Parsing::deepCopy(*returnedEntry.typeBase);
+        varExpr.type = returnedEntry.typeBase;
     }
     ASTTraverser::visit(varExpr);
 }
@@ -186,8 +188,8 @@ void VariableResolution::visit(Parsing::FuncCallExpr& funcCallExpr)
 {
     const SymbolTable::ReturnedEntry returnedEntry = m_symbolTable.lookup(funcCallExpr.name);
     if (isValidFuncCall(funcCallExpr.location, returnedEntry)) {
-        const auto funcType = dynCast<const Parsing::FuncType>(returnedEntry.typeBase.get());
-        funcCallExpr.type = Parsing::deepCopy(*funcType->returnType);
+        const auto funcType = dynCast<const Parsing::FuncType>(returnedEntry.typeBase);
+        funcCallExpr.type = funcType->returnType;
     }
     ASTTraverser::visit(funcCallExpr);
 }
@@ -213,7 +215,7 @@ void VariableResolution::addFuncToSymbolTable(
     const bool internal = prevEntry.hasInternalLinkage() || funDecl.storage == Storage::Static;
     const bool external = !prevEntry.hasInternalLinkage() && funDecl.storage != Storage::Static;
     m_symbolTable.addEntry(funDecl.name, funDecl.name,
-                           *Parsing::deepCopy(*funDecl.type), internal, external,
+                           funDecl.type, internal, external,
                            !m_symbolTable.inFunc(), defined);
 }
 
@@ -222,14 +224,14 @@ void VariableResolution::addVarToSymbolTable(
     Parsing::VarDecl& varDecl,
     const SymbolTable::ReturnedEntry& prevEntry)
 {
-    if (prevEntry.typeBase && !Parsing::areEquivalentTypes(*varDecl.type, *prevEntry.typeBase)) {
+    if (prevEntry.typeBase && varDecl.type != prevEntry.typeBase) {
         const bool global = !m_symbolTable.inFunc();
         const bool defined = varDecl.init != nullptr;
         const bool internal = hasInternalLinkageVar(varDecl);
         const bool external = hasExternalLinkageVar(varDecl, !m_symbolTable.inFunc());
-        const std::string uniqueName = makeTemporaryName(varDecl.name);
+        const Symbol uniqueName = makeTemporaryName(varDecl);
         m_symbolTable.addEntry(
-            varDecl.name, uniqueName, *varDecl.type,
+            varDecl.name, uniqueName, varDecl.type,
             internal, external, global, defined);
         varDecl.name = uniqueName;
         return;
@@ -241,21 +243,25 @@ void VariableResolution::addVarToSymbolTable(
                            hasExternalLinkageVar(varDecl, !m_symbolTable.inFunc());
     if (!m_symbolTable.inFunc() || varDecl.storage == Storage::Extern) {
         m_symbolTable.addEntry(
-            varDecl.name, varDecl.name, *varDecl.type,
+            varDecl.name, varDecl.name, varDecl.type,
             internal, external, global, defined);
     }
     else {
-        const std::string uniqueName = makeTemporaryName(varDecl.name);
+        const Symbol uniqueName = makeTemporaryName(varDecl);
         m_symbolTable.addEntry(
-            varDecl.name, uniqueName, *varDecl.type,
+            varDecl.name, uniqueName, varDecl.type,
             internal, external, global, defined);
         varDecl.name = uniqueName;
     }
 }
 
-std::string VariableResolution::makeTemporaryName(const std::string& name)
+// Names are numbered per function. Static locals end up in the object file, so their names
+// also carry the function to stay unique in the translation unit.
+Symbol VariableResolution::makeTemporaryName(const Parsing::VarDecl& varDecl)
 {
-    return name + '.' + std::to_string(m_nameCounter++) + ".tmp";
+    if (varDecl.storage == Storage::Static && m_symbolTable.inFunc())
+        return Symbol::derive(Symbol(varDecl.name.str() + '.' + m_functionName), m_nameCounter++);
+    return Symbol::derive(varDecl.name, m_nameCounter++, ".tmp");
 }
 
 } // Semantics
\ No newline at end of file
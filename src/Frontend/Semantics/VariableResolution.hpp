@@ -29,6 +29,7 @@ class VariableResolution : public Parsing::ASTTraverser {
         ~FunctionGuard() { table.clearArgs(); }
     };
     SymbolTable& m_symbolTable;
+    std::string m_functionName;
     i32 m_nameCounter = 0;
     std::vector<Error> m_errors;
 public:
@@ -61,11 +62,11 @@ public:
     bool isValidVarExpr(i64 location, const SymbolTable::ReturnedEntry& returnedEntry);
 private:
     void checkFuncDeclForTypeVoid(const Parsing::FuncDeclaration& funDecl);
-    std::string makeTemporaryName(const std::string &name);
+    Symbol makeTemporaryName(const Parsing::VarDecl& varDecl);
     void addError(const std::string& msg, const i64 location) { m_errors.emplace_back(msg, location); }
 };
 
-bool duplicatesInArgs(const std::vector<std::string>& args);
+bool duplicatesInArgs(const Parsing::ArenaVector<Symbol>& args);
 inline bool isIllegalVarRedecl(const Parsing::VarDecl& varDecl, const SymbolTable::ReturnedEntry& prevEntry)
 {
     using Storage = Parsing::Declaration::StorageClass;
@@ -1,106 +1,177 @@
 #include "SymbolTable.hpp"
-#include "ASTTypes.hpp"
+#include "TypeContext.hpp"
 #include "DynCast.hpp"
 #include "ASTDeepCopy.hpp"
 
 #include <cassert>
 
+namespace {
+size_t slotIndex(const u32 id, const size_t mask)
+{
+    return (static_cast<u64>(id) * 0x9e3779b97f4a7c15ull >> 32) & mask;
+}
+} // namespace
+
 SymbolTable::SymbolTable()
+    : m_slots(64)
 {
     addScope();
 }
 
-bool SymbolTable::contains(const std::string& name) const
+const SymbolTable::Slot* SymbolTable::find(const Symbol name) const
 {
-    for (size_t i = m_entries.size(); 0 < i--;)
-        if (m_entries[i].contains(name))
-            return true;
-    return false;
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = slotIndex(name.id(), mask);; i = (i + 1) & mask) {
+        const Slot& slot = m_slots[i];
+        if (slot.symbol == name.id())
+            return &slot;
+        if (slot.symbol == 0)
+            return nullptr;
+    }
 }
 
-SymbolTable::ReturnedEntry SymbolTable::lookup(const std::string& uniqueName) const
+SymbolTable::Slot* SymbolTable::findMut(const Symbol name)
 {
-    const bool inArgs = isInArgs(uniqueName);
-    if (inArgs) {
-        for (i32 i = 0; i < m_argTypes.size(); ++i)
-            if (uniqueName == m_args[i])
-                return {Parsing::deepCopy(*m_argTypes[i]), true, true, false, false, false, false, false};
-    }
-    for (size_t i = m_entries.size(); 0 < i--;) {
-        const auto it = m_entries[i].find(uniqueName);
-        if (it == m_entries[i].end())
-            continue;
-        const bool fromCurrentScope = i == m_entries.size() - 1;
-        const bool internal = it->second.hasInternalLinkage();
-        const bool external = it->second.hasExternalLinkage();
-        const bool global = it->second.isGlobal();
-        const bool defined = it->second.isDefined();
-        return {Parsing::deepCopy(*it->second.varType), true, inArgs, fromCurrentScope, internal, external, global, defined};
+    return const_cast<Slot*>(find(name));
+}
+
+SymbolTable::Slot& SymbolTable::findOrInsert(const Symbol name)
+{
+    if (m_slots.size() < 2 * (m_usedSlots + 1))
+        grow();
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = slotIndex(name.id(), mask);; i = (i + 1) & mask) {
+        Slot& slot = m_slots[i];
+        if (slot.symbol == name.id())
+            return slot;
+        if (slot.symbol == 0) {
+            slot.symbol = name.id();
+            ++m_usedSlots;
+            return slot;
+        }
     }
-    return {nullptr, false, inArgs, false, false, false, false, false};
 }
 
-std::string SymbolTable::getUniqueName(const std::string& unique) const
+void SymbolTable::grow()
 {
-    for (size_t i = m_entries.size(); 0 < i--;) {
-        const auto it = m_entries[i].find(unique);
-        if (it == m_entries[i].end())
+    std::vector<Slot> old(m_slots.size() * 2);
+    std::swap(old, m_slots);
+    const size_t mask = m_slots.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.symbol == 0)
             continue;
-        return it->second.uniqueName;
+        size_t i = slotIndex(slot.symbol, mask);
+        while (m_slots[i].symbol != 0)
+            i = (i + 1) & mask;
+        m_slots[i] = slot;
     }
-    assert(false && "Should always get called after contains never happen in SymbolTable::getUniqueName");
+}
+
+bool SymbolTable::contains(const Symbol name) const
+{
+    const Slot* slot = find(name);
+    return slot != nullptr && slot->binding != s_none;
+}
+
+SymbolTable::ReturnedEntry SymbolTable::lookup(const Symbol uniqueName) const
+{
+    const Slot* slot = find(uniqueName);
+    if (slot == nullptr)
+        return {nullptr, false, false, false, false, false, false, false};
+    if (slot->arg != s_none)
+        return {m_argTypes[slot->arg], true, true, false, false, false, false, false};
+    if (slot->binding == s_none)
+        return {nullptr, false, false, false, false, false, false, false};
+    const Binding& binding = m_bindings[slot->binding];
+    const Entry& entry = binding.entry;
+    const bool fromCurrentScope = binding.depth == m_scopeStarts.size() - 1;
+    return {entry.varType, true, false, fromCurrentScope, entry.hasInternalLinkage(),
+            entry.hasExternalLinkage(), entry.isGlobal(), entry.isDefined()};
+}
+
+Symbol SymbolTable::getUniqueName(const Symbol unique) const
+{
+    const Slot* slot = find(unique);
+    assert(slot != nullptr && slot->binding != s_none &&
+           "Should always get called after contains never happen in SymbolTable::getUniqueName");
+    return m_bindings[slot->binding].entry.uniqueName;
+}
+
+bool SymbolTable::isInArgs(const Symbol name) const
+{
+    const Slot* slot = find(name);
+    return slot != nullptr && slot->arg != s_none;
 }
 
 void SymbolTable::setArgs(Parsing::FuncDeclaration& funDecl)
 {
-    m_args = funDecl.params;
+    clearArgs();
+    m_args.assign(funDecl.params.begin(), funDecl.params.end());
     m_argTypes.clear();
-    const auto funcType = dynCast<Parsing::FuncType>(funDecl.type.get());
-    for (auto& param : funcType->params) {
-        if (param->type == Type::Array) {
-            const auto arrayType = dynCast<Parsing::ArrayType>(param.get());
-            auto pointerType = std::make_unique<Parsing::PointerType>(
-                Parsing::deepCopy(*arrayType->elementType));
-            param = std::move(pointerType);
-        }
-        m_argTypes.emplace_back(Parsing::deepCopy(*param));
+    const auto funcType = dynCast<const Parsing::FuncType>(funDecl.type);
+    for (const Parsing::TypeBase* param : funcType->params)
+        m_argTypes.push_back(Parsing::convertArrayFirstDimToPtr(param));
+    funDecl.type = Parsing::funcType(funcType->returnType, m_argTypes);
+    for (u32 i = 0; i < m_args.size(); ++i) {
+        Slot& slot = findOrInsert(m_args[i]);
+        if (slot.arg == s_none)
+            slot.arg = i;
     }
 }
 
 void SymbolTable::clearArgs()
 {
+    for (const Symbol arg : m_args)
+        findMut(arg)->arg = s_none;
     m_args.clear();
 }
 
-void SymbolTable::addEntry(const std::string& name,
-                           const std::string& uniqueName,
-                           const Parsing::TypeBase& typeBase,
+void SymbolTable::addEntry(const Symbol name,
+                           const Symbol uniqueName,
+                           const Parsing::TypeBase* typeBase,
                            const bool internal,
                            const bool external,
                            const bool global,
                            const bool defined)
 {
-
-    m_entries.back().insert_or_assign(name,Entry(
-        uniqueName, Parsing::deepCopy(typeBase),
-        internal, external, global, defined)
-        );
+    const auto depth = static_cast<u32>(m_scopeStarts.size() - 1);
+    const Entry entry(uniqueName, typeBase, internal, external, global, defined);
+    Slot& slot = findOrInsert(name);
+    if (slot.binding != s_none && m_bindings[slot.binding].depth == depth) {
+        m_bindings[slot.binding].entry = entry;
+        return;
+    }
+    m_bindings.emplace_back(entry, depth, slot.binding);
+    slot.binding = static_cast<u32>(m_bindings.size() - 1);
+    m_undoLog.push_back(name);
 }
 
 void SymbolTable::addScope()
 {
-    m_entries.emplace_back();
+    m_scopeStarts.push_back(m_undoLog.size());
 }
 
 void SymbolTable::removeScope()
 {
-    m_entries.pop_back();
+    const size_t start = m_scopeStarts.back();
+    m_scopeStarts.pop_back();
+    while (start < m_undoLog.size()) {
+        Slot* slot = findMut(m_undoLog.back());
+        slot->binding = m_bindings[slot->binding].shadowed;
+        m_bindings.pop_back();
+        m_undoLog.pop_back();
+    }
 }
 
-bool SymbolTable::isFunc(const std::string& name) const
+bool SymbolTable::isFunc(const Symbol name) const
 {
-    const auto it = m_entries.front().find(name);
-    if (it == m_entries.front().end())
+    const Slot* slot = find(name);
+    if (slot == nullptr)
+        return false;
+    u32 binding = slot->binding;
+    while (binding != s_none && m_bindings[binding].depth != 0)
+        binding = m_bindings[binding].shadowed;
+    if (binding == s_none)
         return false;
-    return it->second.varType->type == Type::Function;
-}
\ No newline at end of file
+    return m_bindings[binding].entry.varType->type == Type::Function;
+}
@@ -2,11 +2,10 @@
 
 #include "ShortTypes.hpp"
 #include "ASTParser.hpp"
+#include "Symbol.hpp"
 
-#include <string>
 #include <utility>
 #include <vector>
-#include <unordered_map>
 
 class SymbolTable {
 public:
@@ -49,8 +48,8 @@ public:
         }
     };
     struct ReturnedEntry : FlagBase<ReturnedEntry>  {
-        std::unique_ptr<Parsing::TypeBase> typeBase;
-        ReturnedEntry(std::unique_ptr<Parsing::TypeBase>&& t,
+        const Parsing::TypeBase* typeBase;
+        ReturnedEntry(const Parsing::TypeBase* t,
                          const bool contains,
                          const bool inArgs,
                          const bool fromCurrentScope,
@@ -58,8 +57,8 @@ public:
                          const bool external,
                          const bool global,
                          const bool defined)
+            : typeBase(t)
         {
-            typeBase = std::move(t);
             if (contains)
                 set(State::Contains);
             if (inArgs)
@@ -78,18 +77,17 @@ public:
     };
 private:
     struct Entry : FlagBase<Entry>  {
-        std::string uniqueName;
+        Symbol uniqueName;
         State returnFlag = State::None;
-        std::unique_ptr<Parsing::TypeBase> varType;
-        Entry(std::string uniqueName,
-              std::unique_ptr<Parsing::TypeBase>&& typeBase,
+        const Parsing::TypeBase* varType;
+        Entry(const Symbol uniqueName,
+              const Parsing::TypeBase* typeBase,
               const bool internal,
               const bool external,
               const bool global,
               const bool defined)
-            : uniqueName(std::move(uniqueName))
+            : uniqueName(uniqueName), varType(typeBase)
         {
-            varType = std::move(typeBase);
             if (internal)
                 set(State::InternalLinkage);
             if (external)
@@ -100,26 +98,47 @@ private:
                 set(State::Defined);
         }
     };
-    std::vector<std::unordered_map<std::string, Entry>> m_entries;
-    std::unordered_map<std::string, i32> m_funcs;
-    std::vector<std::string> m_args;
-    std::vector<std::unique_ptr<Parsing::TypeBase>> m_argTypes;
+    // All scopes share one open-addressing table keyed by symbol id. A slot points at
+    // the innermost binding of its name, which links to the binding it shadows, and the
+    // undo log records which names each scope bound so removeScope can unwind them.
+    static constexpr u32 s_none = ~0u;
+    struct Binding {
+        Entry entry;
+        u32 depth;
+        u32 shadowed;
+    };
+    struct Slot {
+        u32 symbol = 0;
+        u32 binding = s_none;
+        u32 arg = s_none;
+    };
+    std::vector<Slot> m_slots;
+    u32 m_usedSlots = 0;
+    std::vector<Binding> m_bindings;
+    std::vector<Symbol> m_undoLog;
+    std::vector<size_t> m_scopeStarts;
+    std::vector<Symbol> m_args;
+    std::vector<const Parsing::TypeBase*> m_argTypes;
 public:
     SymbolTable();
-    [[nodiscard]] bool contains(const std::string& name) const;
-    [[nodiscard]] ReturnedEntry lookup(const std::string& uniqueName) const;
-    std::string getUniqueName(const std::string& unique) const;
+    [[nodiscard]] bool contains(Symbol name) const;
+    [[nodiscard]] ReturnedEntry lookup(Symbol uniqueName) const;
+    [[nodiscard]] Symbol getUniqueName(Symbol unique) const;
     void setArgs(Parsing::FuncDeclaration& funDecl);
     void clearArgs();
-    void addEntry(const std::string& name,
-                  const std::string& uniqueName,
-                  const Parsing::TypeBase& typeBase,
+    void addEntry(Symbol name,
+                  Symbol uniqueName,
+                  const Parsing::TypeBase* typeBase,
                   bool internal, bool external, bool global, bool defined);
     void addScope();
     void removeScope();
 
-    [[nodiscard]] i32 argSize(const std::string& funcName) const { return m_funcs.at(funcName); }
-    [[nodiscard]] bool isInArgs(const std::string& name) const { return std::ranges::find(m_args, name) != m_args.end(); }
-    [[nodiscard]] bool inFunc() const { return 1 < m_entries.size(); }
-    [[nodiscard]] bool isFunc(const std::string& name) const;
+    [[nodiscard]] bool isInArgs(Symbol name) const;
+    [[nodiscard]] bool inFunc() const { return 1 < m_scopeStarts.size(); }
+    [[nodiscard]] bool isFunc(Symbol name) const;
+private:
+    [[nodiscard]] const Slot* find(Symbol name) const;
+    [[nodiscard]] Slot* findMut(Symbol name);
+    [[nodiscard]] Slot& findOrInsert(Symbol name);
+    void grow();
 };
\ No newline at end of file
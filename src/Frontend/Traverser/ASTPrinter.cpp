@@ -111,21 +111,21 @@ void ASTPrinter::visit(const Program& program)
 void ASTPrinter::visit(const VarDecl& varDecl)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("VarDecl " + varDecl.name + ' ' + storageClass(varDecl.storage) + ' ' + varTypeToString(varDecl.type->type));
+    addLine("VarDecl " + varDecl.name.str() + ' ' + storageClass(varDecl.storage) + ' ' + varTypeToString(varDecl.type->type));
     ConstASTTraverser::visit(varDecl);
 }
 
 void ASTPrinter::visit(const FuncDeclaration& funDecl)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("FunDecl: " + funDecl.name + ' ' + storageClass(funDecl.storage));
-    auto type = dynCast<const Parsing::FuncType>(funDecl.type.get());
+    addLine("FunDecl: " + funDecl.name.str() + ' ' + storageClass(funDecl.storage));
+    auto type = dynCast<const Parsing::FuncType>(funDecl.type);
     addLine("ReturnType " + varTypeToString(type->returnType->type));
     std::string args = "args: ";
     for (i64 i = 0; i < funDecl.params.size(); ++i) {
         if (i != 0)
             args += ", ";
-        args += varTypeToString(type->params[i]->type) + " " + funDecl.params[i];
+        args += varTypeToString(type->params[i]->type) + " " + funDecl.params[i].str();
     }
     addLine(args);
     ConstASTTraverser::visit(funDecl);
@@ -150,9 +150,9 @@ void ASTPrinter::visit(const StringInitializer& stringInitializer)
 {
     IndentGuard guard(m_indentLevel);
     if (stringInitializer.nullTerminated)
-        addLine(stringInitializer.value + " is null terminated " + " string init");
+        addLine(std::string(stringInitializer.value) + " is null terminated " + " string init");
     else
-        addLine(stringInitializer.value + " is not null terminated " + " string init");
+        addLine(std::string(stringInitializer.value) + " is not null terminated " + " string init");
 }
 
 void ASTPrinter::visit(const VarType& varType)
@@ -214,7 +214,7 @@ void ASTPrinter::visit(const IfStmt& ifStmt)
 void ASTPrinter::visit(const GotoStmt& gotoStmt)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("GotoStmt " + gotoStmt.identifier);
+    addLine("GotoStmt " + std::string(gotoStmt.identifier));
     ConstASTTraverser::visit(gotoStmt);
 }
 
@@ -242,25 +242,25 @@ void ASTPrinter::visit(const CompoundStmt& function)
 void ASTPrinter::visit(const BreakStmt& breakStmt)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("BreakStmt " + breakStmt.identifier);
+    addLine("BreakStmt " + std::string(breakStmt.identifier));
 }
 
 void ASTPrinter::visit(const ContinueStmt& continueStmt)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("ContinueStmt "  + continueStmt.identifier);
+    addLine("ContinueStmt "  + std::string(continueStmt.identifier));
 }
 
 void ASTPrinter::visit(const LabelStmt& labelStmt)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("LabelStmt "  + labelStmt.identifier);
+    addLine("LabelStmt "  + std::string(labelStmt.identifier));
 }
 
 void ASTPrinter::visit(const CaseStmt& caseStmt)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("CaseStmt: " + caseStmt.identifier);
+    addLine("CaseStmt: " + std::string(caseStmt.identifier));
     ConstASTTraverser::visit(caseStmt);
 }
 
@@ -312,7 +312,7 @@ void ASTPrinter::visit(const UnaryExpr& unaryExpr)
 void ASTPrinter::visit(const StringExpr& stringExpr)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("StringExpr: " + stringExpr.value);
+    addLine("StringExpr: " + std::string(stringExpr.value));
     ConstASTTraverser::visit(stringExpr);
 }
 
@@ -368,9 +368,9 @@ void ASTPrinter::visit(const VarExpr& varExpr)
 {
     IndentGuard guard(m_indentLevel);
     if (varExpr.type)
-        addLine(varExpr.name + " " + varTypeToString(varExpr.type->type));
+        addLine(varExpr.name.str() + " " + varTypeToString(varExpr.type->type));
     else
-        addLine(varExpr.name);
+        addLine(varExpr.name.str());
     ConstASTTraverser::visit(varExpr);
 }
 
@@ -394,7 +394,7 @@ void ASTPrinter::visit(const NullStmt& nullStmt)
 void ASTPrinter::visit(const FuncCallExpr& functionCallExpr)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("Function Call: " + functionCallExpr.name);
+    addLine("Function Call: " + functionCallExpr.name.str());
     ConstASTTraverser::visit(functionCallExpr);
 }
 
@@ -1,6 +1,5 @@
 #include "ASTTraverser.hpp"
 #include "ASTParser.hpp"
-#include "ASTTypes.hpp"
 
 namespace Parsing {
 
@@ -40,23 +39,6 @@ void ASTTraverser::visit(DeclBlockItem& declBlockItem)
     declBlockItem.decl->accept(*this);
 }
 
-void ASTTraverser::visit(FuncType& functionType)
-{
-    functionType.returnType->accept(*this);
-    for (const std::unique_ptr<TypeBase>& type : functionType.params)
-        type->accept(*this);
-}
-
-void ASTTraverser::visit(PointerType& pointerType)
-{
-    pointerType.referenced->accept(*this);
-}
-
-void ASTTraverser::visit(ArrayType& arrayType)
-{
-    arrayType.elementType->accept(*this);
-}
-
 void ASTTraverser::visit(SingleInitializer& singleInitializer)
 {
     singleInitializer.expr->accept(*this);
@@ -202,11 +184,6 @@ void ASTTraverser::visit(SubscriptExpr& subscriptExpr)
     subscriptExpr.index->accept(*this);
 }
 
-void ASTTraverser::visit(SizeOfTypeExpr& sizeOfTypeExpr)
-{
-    sizeOfTypeExpr.sizeType->accept(*this);
-}
-
 void ASTTraverser::visit(SizeOfExprExpr& sizeOfExprExpr)
 {
     sizeOfExprExpr.innerExpr->accept(*this);
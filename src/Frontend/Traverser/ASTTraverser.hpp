@@ -17,12 +17,6 @@ public:
     void visit(StmtBlockItem& stmtBlockItem) override;
     void visit(DeclBlockItem& declBlockItem) override;
 
-    // Type
-    void visit(VarType& varType) override {}
-    void visit(FuncType& functionType) override;
-    void visit(PointerType& pointerType) override;
-    void visit(ArrayType& arrayType) override;
-
     // Initializers
     void visit(SingleInitializer& singleInitializer) override;
     void visit(CompoundInitializer& compoundInitializer) override;
@@ -63,7 +57,7 @@ public:
     void visit(DereferenceExpr& dereferenceExpr) override;
     void visit(AddrOffExpr& addrOffExpr) override;
     void visit(SubscriptExpr& subscriptExpr) override;
-    void visit(SizeOfTypeExpr& sizeOfTypeExpr) override;
+    void visit(SizeOfTypeExpr& sizeOfTypeExpr) override {}
     void visit(SizeOfExprExpr& sizeOfExprExpr) override;
 };
 
@@ -0,0 +1,420 @@
+#include "FunctionFingerprint.hpp"
+#include "ASTTypes.hpp"
+
+#include <bit>
+
+namespace Parsing {
+
+namespace {
+
+enum class Node : u8 {
+    Function, VarDecl, Block,
+    VarType, FuncType, PointerType, ArrayType,
+    SingleInit, CompoundInit, ZeroInit, StringInit,
+    StmtItem, DeclItem, DeclForInit, ExprForInit,
+    Return, ExprStmt, If, Goto, Compound, Break, Continue, Label, Case, Default,
+    While, DoWhile, For, Switch, Null,
+    Const, String, Var, Cast, Unary, Binary, Assignment, Ternary, Call,
+    Dereference, AddrOf, Subscript, SizeOfType, SizeOfExpr
+};
+
+constexpr u8 tag(const Node node)
+{
+    return static_cast<u8>(node);
+}
+
+} // namespace
+
+std::string FunctionFingerprint::encode(const FuncDeclaration& funDecl, const bool isGlobal)
+{
+    FunctionFingerprint fingerprint;
+    fingerprint.add(isGlobal);
+    funDecl.accept(fingerprint);
+    return std::move(fingerprint.m_bytes);
+}
+
+void FunctionFingerprint::visit(const VarDecl& varDecl)
+{
+    open(tag(Node::VarDecl));
+    add(varDecl.name.text());
+    add(static_cast<u64>(varDecl.storage));
+    varDecl.type->accept(*this);
+    ConstASTTraverser::visit(varDecl);
+    close();
+}
+
+void FunctionFingerprint::visit(const FuncDeclaration& funDecl)
+{
+    open(tag(Node::Function));
+    add(funDecl.name.text());
+    add(static_cast<u64>(funDecl.storage));
+    for (const Symbol param : funDecl.params)
+        add(param.text());
+    funDecl.type->accept(*this);
+    ConstASTTraverser::visit(funDecl);
+    close();
+}
+
+void FunctionFingerprint::visit(const Block& block)
+{
+    open(tag(Node::Block));
+    ConstASTTraverser::visit(block);
+    close();
+}
+
+void FunctionFingerprint::visit(const VarType& varType)
+{
+    open(tag(Node::VarType));
+    add(static_cast<u64>(varType.type));
+    close();
+}
+
+void FunctionFingerprint::visit(const FuncType& functionType)
+{
+    open(tag(Node::FuncType));
+    ConstASTTraverser::visit(functionType);
+    close();
+}
+
+void FunctionFingerprint::visit(const PointerType& pointerType)
+{
+    open(tag(Node::PointerType));
+    ConstASTTraverser::visit(pointerType);
+    close();
+}
+
+void FunctionFingerprint::visit(const ArrayType& arrayType)
+{
+    open(tag(Node::ArrayType));
+    add(static_cast<u64>(arrayType.size));
+    ConstASTTraverser::visit(arrayType);
+    close();
+}
+
+void FunctionFingerprint::visit(const SingleInitializer& singleInitializer)
+{
+    open(tag(Node::SingleInit));
+    ConstASTTraverser::visit(singleInitializer);
+    close();
+}
+
+void FunctionFingerprint::visit(const CompoundInitializer& compoundInitializer)
+{
+    open(tag(Node::CompoundInit));
+    ConstASTTraverser::visit(compoundInitializer);
+    close();
+}
+
+void FunctionFingerprint::visit(const ZeroInitializer& zeroInitializer)
+{
+    open(tag(Node::ZeroInit));
+    add(static_cast<u64>(zeroInitializer.size));
+    close();
+}
+
+void FunctionFingerprint::visit(const StringInitializer& stringInitializer)
+{
+    open(tag(Node::StringInit));
+    add(stringInitializer.value);
+    add(stringInitializer.nullTerminated);
+    close();
+}
+
+void FunctionFingerprint::visit(const StmtBlockItem& stmtBlockItem)
+{
+    open(tag(Node::StmtItem));
+    ConstASTTraverser::visit(stmtBlockItem);
+    close();
+}
+
+void FunctionFingerprint::visit(const DeclBlockItem& declBlockItem)
+{
+    open(tag(Node::DeclItem));
+    ConstASTTraverser::visit(declBlockItem);
+    close();
+}
+
+void FunctionFingerprint::visit(const DeclForInit& declForInit)
+{
+    open(tag(Node::DeclForInit));
+    ConstASTTraverser::visit(declForInit);
+    close();
+}
+
+void FunctionFingerprint::visit(const ExprForInit& exprForInit)
+{
+    open(tag(Node::ExprForInit));
+    ConstASTTraverser::visit(exprForInit);
+    close();
+}
+
+void FunctionFingerprint::visit(const ReturnStmt& returnStmt)
+{
+    open(tag(Node::Return));
+    ConstASTTraverser::visit(returnStmt);
+    close();
+}
+
+void FunctionFingerprint::visit(const ExprStmt& exprStmt)
+{
+    open(tag(Node::ExprStmt));
+    ConstASTTraverser::visit(exprStmt);
+    close();
+}
+
+void FunctionFingerprint::visit(const IfStmt& ifStmt)
+{
+    open(tag(Node::If));
+    ConstASTTraverser::visit(ifStmt);
+    close();
+}
+
+void FunctionFingerprint::visit(const GotoStmt& gotoStmt)
+{
+    open(tag(Node::Goto));
+    add(gotoStmt.identifier);
+    close();
+}
+
+void FunctionFingerprint::visit(const CompoundStmt& compoundStmt)
+{
+    open(tag(Node::Compound));
+    ConstASTTraverser::visit(compoundStmt);
+    close();
+}
+
+void FunctionFingerprint::visit(const BreakStmt& breakStmt)
+{
+    open(tag(Node::Break));
+    add(breakStmt.identifier);
+    close();
+}
+
+void FunctionFingerprint::visit(const ContinueStmt& continueStmt)
+{
+    open(tag(Node::Continue));
+    add(continueStmt.identifier);
+    close();
+}
+
+void FunctionFingerprint::visit(const LabelStmt& labelStmt)
+{
+    open(tag(Node::Label));
+    add(labelStmt.identifier);
+    ConstASTTraverser::visit(labelStmt);
+    close();
+}
+
+void FunctionFingerprint::visit(const CaseStmt& caseStmt)
+{
+    open(tag(Node::Case));
+    add(caseStmt.identifier);
+    ConstASTTraverser::visit(caseStmt);
+    close();
+}
+
+void FunctionFingerprint::visit(const DefaultStmt& defaultStmt)
+{
+    open(tag(Node::Default));
+    add(defaultStmt.identifier);
+    ConstASTTraverser::visit(defaultStmt);
+    close();
+}
+
+void FunctionFingerprint::visit(const WhileStmt& whileStmt)
+{
+    open(tag(Node::While));
+    add(whileStmt.identifier);
+    ConstASTTraverser::visit(whileStmt);
+    close();
+}
+
+void FunctionFingerprint::visit(const DoWhileStmt& doWhileStmt)
+{
+    open(tag(Node::DoWhile));
+    add(doWhileStmt.identifier);
+    ConstASTTraverser::visit(doWhileStmt);
+    close();
+}
+
+void FunctionFingerprint::visit(const ForStmt& forStmt)
+{
+    open(tag(Node::For));
+    add(forStmt.identifier);
+    // Each part is optional, so mark which ones are there.
+    add(static_cast<u64>(forStmt.init != nullptr) | static_cast<u64>(forStmt.condition != nullptr) << 1 |
+        static_cast<u64>(forStmt.post != nullptr) << 2);
+    ConstASTTraverser::visit(forStmt);
+    close();
+}
+
+void FunctionFingerprint::visit(const SwitchStmt& switchStmt)
+{
+    open(tag(Node::Switch));
+    add(switchStmt.identifier);
+    add(switchStmt.hasDefault);
+    for (const std::variant<i32, i64, u32, u64>& value : switchStmt.cases)
+        std::visit([this](const auto caseValue) { add(static_cast<u64>(caseValue)); }, value);
+    ConstASTTraverser::visit(switchStmt);
+    close();
+}
+
+void FunctionFingerprint::visit(const NullStmt&)
+{
+    open(tag(Node::Null));
+    close();
+}
+
+void FunctionFingerprint::visit(const ConstExpr& constExpr)
+{
+    open(tag(Node::Const));
+    addType(constExpr);
+    std::visit([this]<typename T>(const T value) {
+        if constexpr (std::is_same_v<T, double>)
+            add(std::bit_cast<u64>(value));
+        else
+            add(static_cast<u64>(value));
+    }, constExpr.value);
+    close();
+}
+
+void FunctionFingerprint::visit(const StringExpr& stringExpr)
+{
+    open(tag(Node::String));
+    addType(stringExpr);
+    add(stringExpr.value);
+    close();
+}
+
+void FunctionFingerprint::visit(const VarExpr& varExpr)
+{
+    open(tag(Node::Var));
+    addType(varExpr);
+    add(varExpr.name.text());
+    add(static_cast<u64>(varExpr.referingTo));
+    close();
+}
+
+void FunctionFingerprint::visit(const CastExpr& castExpr)
+{
+    open(tag(Node::Cast));
+    addType(castExpr);
+    ConstASTTraverser::visit(castExpr);
+    close();
+}
+
+void FunctionFingerprint::visit(const UnaryExpr& unaryExpr)
+{
+    open(tag(Node::Unary));
+    addType(unaryExpr);
+    add(static_cast<u64>(unaryExpr.op));
+    ConstASTTraverser::visit(unaryExpr);
+    close();
+}
+
+void FunctionFingerprint::visit(const BinaryExpr& binaryExpr)
+{
+    open(tag(Node::Binary));
+    addType(binaryExpr);
+    add(static_cast<u64>(binaryExpr.op));
+    ConstASTTraverser::visit(binaryExpr);
+    close();
+}
+
+void FunctionFingerprint::visit(const AssignmentExpr& assignmentExpr)
+{
+    open(tag(Node::Assignment));
+    addType(assignmentExpr);
+    add(static_cast<u64>(assignmentExpr.op));
+    ConstASTTraverser::visit(assignmentExpr);
+    close();
+}
+
+void FunctionFingerprint::visit(const TernaryExpr& conditionalExpr)
+{
+    open(tag(Node::Ternary));
+    addType(conditionalExpr);
+    ConstASTTraverser::visit(conditionalExpr);
+    close();
+}
+
+void FunctionFingerprint::visit(const FuncCallExpr& functionCallExpr)
+{
+    open(tag(Node::Call));
+    addType(functionCallExpr);
+    add(functionCallExpr.name.text());
+    ConstASTTraverser::visit(functionCallExpr);
+    close();
+}
+
+void FunctionFingerprint::visit(const DereferenceExpr& dereferenceExpr)
+{
+    open(tag(Node::Dereference));
+    addType(dereferenceExpr);
+    ConstASTTraverser::visit(dereferenceExpr);
+    close();
+}
+
+void FunctionFingerprint::visit(const AddrOffExpr& addrOffExpr)
+{
+    open(tag(Node::AddrOf));
+    addType(addrOffExpr);
+    ConstASTTraverser::visit(addrOffExpr);
+    close();
+}
+
+void FunctionFingerprint::visit(const SubscriptExpr& subscriptExpr)
+{
+    open(tag(Node::Subscript));
+    addType(subscriptExpr);
+    ConstASTTraverser::visit(subscriptExpr);
+    close();
+}
+
+void FunctionFingerprint::visit(const SizeOfTypeExpr& sizeOfTypeExpr)
+{
+    open(tag(Node::SizeOfType));
+    addType(sizeOfTypeExpr);
+    ConstASTTraverser::visit(sizeOfTypeExpr);
+    close();
+}
+
+void FunctionFingerprint::visit(const SizeOfExprExpr& sizeOfExprExpr)
+{
+    open(tag(Node::SizeOfExpr));
+    addType(sizeOfExprExpr);
+    ConstASTTraverser::visit(sizeOfExprExpr);
+    close();
+}
+
+void FunctionFingerprint::open(const u8 tag)
+{
+    m_bytes += '(';
+    m_bytes += static_cast<char>(tag);
+}
+
+// LEB128, most values are small kinds and counts and the encoding is hashed for every function.
+void FunctionFingerprint::add(u64 value)
+{
+    for (; 0x80 <= value; value >>= 7)
+        m_bytes += static_cast<char>((value & 0x7F) | 0x80);
+    m_bytes += static_cast<char>(value);
+}
+
+void FunctionFingerprint::add(const std::string_view text)
+{
+    add(static_cast<u64>(text.size()));
+    m_bytes += text;
+}
+
+void FunctionFingerprint::addType(const Expr& expr)
+{
+    if (expr.type == nullptr) {
+        add(u64{0});
+        return;
+    }
+    add(u64{1});
+    expr.type->accept(*this);
+}
+
+} // Parsing
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ASTParser.hpp"
+#include "ConstASTTraverser.hpp"
+
+#include <string>
+
+namespace Parsing {
+
+// Canonical byte encoding of a resolved and type checked function definition. Everything the
+// generated code depends on is covered: the body with the types annotated on each expression,
+// which include the types of the globals and callees it references, and the linkage of the
+// function. Whitespace, comments and source positions are not, so two functions with the same
+// encoding compile to the same output.
+class FunctionFingerprint final : public ConstASTTraverser {
+    std::string m_bytes;
+public:
+    [[nodiscard]] static std::string encode(const FuncDeclaration& funDecl, bool isGlobal);
+
+    void visit(const VarDecl& varDecl) override;
+    void visit(const FuncDeclaration& funDecl) override;
+    void visit(const Block& block) override;
+
+    void visit(const VarType& varType) override;
+    void visit(const FuncType& functionType) override;
+    void visit(const PointerType& pointerType) override;
+    void visit(const ArrayType& arrayType) override;
+
+    void visit(const SingleInitializer& singleInitializer) override;
+    void visit(const CompoundInitializer& compoundInitializer) override;
+    void visit(const ZeroInitializer& zeroInitializer) override;
+    void visit(const StringInitializer& stringInitializer) override;
+
+    void visit(const StmtBlockItem& stmtBlockItem) override;
+    void visit(const DeclBlockItem& declBlockItem) override;
+    void visit(const DeclForInit& declForInit) override;
+    void visit(const ExprForInit& exprForInit) override;
+
+    void visit(const ReturnStmt& returnStmt) override;
+    void visit(const ExprStmt& exprStmt) override;
+    void visit(const IfStmt& ifStmt) override;
+    void visit(const GotoStmt& gotoStmt) override;
+    void visit(const CompoundStmt& compoundStmt) override;
+    void visit(const BreakStmt& breakStmt) override;
+    void visit(const ContinueStmt& continueStmt) override;
+    void visit(const LabelStmt& labelStmt) override;
+    void visit(const CaseStmt& caseStmt) override;
+    void visit(const DefaultStmt& defaultStmt) override;
+    void visit(const WhileStmt& whileStmt) override;
+    void visit(const DoWhileStmt& doWhileStmt) override;
+    void visit(const ForStmt& forStmt) override;
+    void visit(const SwitchStmt& switchStmt) override;
+    void visit(const NullStmt& nullStmt) override;
+
+    void visit(const ConstExpr& constExpr) override;
+    void visit(const StringExpr& stringExpr) override;
+    void visit(const VarExpr& varExpr) override;
+    void visit(const CastExpr& castExpr) override;
+    void visit(const UnaryExpr& unaryExpr) override;
+    void visit(const BinaryExpr& binaryExpr) override;
+    void visit(const AssignmentExpr& assignmentExpr) override;
+    void visit(const TernaryExpr& conditionalExpr) override;
+    void visit(const FuncCallExpr& functionCallExpr) override;
+    void visit(const DereferenceExpr& dereferenceExpr) override;
+    void visit(const AddrOffExpr& addrOffExpr) override;
+    void visit(const SubscriptExpr& subscriptExpr) override;
+    void visit(const SizeOfTypeExpr& sizeOfTypeExpr) override;
+    void visit(const SizeOfExprExpr& sizeOfExprExpr) override;
+private:
+    void open(u8 tag);
+    void close() { m_bytes += ')'; }
+    void add(u64 value);
+    void add(std::string_view text);
+    void addType(const Expr& expr);
+};
+
+} // Parsing
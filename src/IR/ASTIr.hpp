@@ -1,12 +1,15 @@
 #pragma once
 
 #include "ShortTypes.hpp"
+#include "Symbol.hpp"
 #include "Types/Type.hpp"
+#include "InstructionPool.hpp"
 
+#include <bit>
 #include <memory>
+#include <span>
 #include <string>
 #include <utility>
-#include <variant>
 #include <vector>
 
 /*
@@ -49,60 +52,77 @@ binary_operator = Add | Subtract | Multiply | Divide | Remainder |
 namespace Ir {
 
 struct Identifier {
-    std::string value;
+    Symbol value;
 };
 
+// Operands are indices into the value table of the function they belong to, labels
+// are numbered per function and only get a name when assembly is generated.
+enum class ValueId : u32 {
+    None = ~0u
+};
+
+enum class LabelId : u32 {};
+
 struct Value {
-    enum class Kind {
+    enum class Kind : u8 {
         Variable, Constant
     };
-    Type type;
-    const Kind kind;
-    Value() = delete;
-    virtual ~Value() = default;
-protected:
-    explicit Value(const Type t, const Kind k)
-        : type(t), kind(k) {}
-};
-
-struct ValueVar final : Value {
+    Kind kind;
     ReferingTo referingTo = ReferingTo::Local;
-    Identifier value;
-    i64 size = 0;
-
-    ValueVar(Identifier v, const Type t)
-        : Value(t, Kind::Variable), value(std::move(v)) {}
-
-    ValueVar(Identifier v, const Type t, const i64 size)
-        : Value(t, Kind::Variable), value(std::move(v)), size(size) {}
+    Type type;
+    Symbol name;
+    union {
+        i64 size;
+        u64 bits;
+    };
 
-    static bool classOf(const Value* value) { return value->kind == Kind::Variable; }
+    Value(const Identifier iden, const Type t)
+        : kind(Kind::Variable), type(t), name(iden.value), size(0) {}
+    Value(const Identifier iden, const Type t, const ReferingTo referingTo, const i64 size)
+        : kind(Kind::Variable), referingTo(referingTo), type(t), name(iden.value), size(size) {}
+
+    explicit Value(const char ch)
+        : kind(Kind::Constant), type(Type::Char), bits(static_cast<u64>(static_cast<i64>(ch))) {}
+    explicit Value(const i8 v)
+        : kind(Kind::Constant), type(Type::I8), bits(static_cast<u64>(static_cast<i64>(v))) {}
+    explicit Value(const u8 v)
+        : kind(Kind::Constant), type(Type::U8), bits(v) {}
+    explicit Value(const i32 v)
+        : kind(Kind::Constant), type(Type::I32), bits(static_cast<u64>(static_cast<i64>(v))) {}
+    explicit Value(const i64 v)
+        : kind(Kind::Constant), type(Type::I64), bits(static_cast<u64>(v)) {}
+    explicit Value(const u32 v)
+        : kind(Kind::Constant), type(Type::U32), bits(v) {}
+    explicit Value(const u64 v)
+        : kind(Kind::Constant), type(Type::U64), bits(v) {}
+    explicit Value(const double v)
+        : kind(Kind::Constant), type(Type::Double), bits(std::bit_cast<u64>(v)) {}
+
+    [[nodiscard]] bool isConstant() const { return kind == Kind::Constant; }
+    [[nodiscard]] bool isVariable() const { return kind == Kind::Variable; }
+    // Integer constants are held sign or zero extended from their own width.
+    [[nodiscard]] i64 asI64() const { return static_cast<i64>(bits); }
+    [[nodiscard]] double asDouble() const { return std::bit_cast<double>(bits); }
+
+    bool operator==(const Value& other) const
+    {
+        return kind == other.kind && referingTo == other.referingTo && type == other.type &&
+               name == other.name && bits == other.bits;
+    }
 
-    ValueVar() = delete;
+    Value() = delete;
 };
 
-struct ValueConst final : Value {
-    std::variant<char, i8, u8, i32, i64, u32, u64, double> value;
-    explicit ValueConst(const u8 v)
-        : Value(Type::U8, Kind::Constant), value(v) {}
-    explicit ValueConst(const i8 v)
-        : Value(Type::I8, Kind::Constant), value(v) {}
-    explicit ValueConst(const char ch)
-        : Value(Type::Char, Kind::Constant), value(ch) {}
-    explicit ValueConst(const i32 v)
-        : Value(Type::I32 ,Kind::Constant), value(v) {}
-    explicit ValueConst(const i64 v)
-        : Value(Type::I64 ,Kind::Constant), value(v) {}
-    explicit ValueConst(const u32 v)
-        : Value(Type::U32 ,Kind::Constant), value(v) {}
-    explicit ValueConst(const u64 v)
-        : Value(Type::U64 ,Kind::Constant), value(v) {}
-    explicit ValueConst(const double v)
-        : Value(Type::Double ,Kind::Constant), value(v) {}
-
-    static bool classOf(const Value* value) { return value->kind == Kind::Constant; }
+static_assert(sizeof(Value) == 16);
 
-    ValueConst() = delete;
+struct ValueHash {
+    size_t operator()(const Value& value) const noexcept
+    {
+        u64 hash = value.bits * 0x9e3779b97f4a7c15ull;
+        hash ^= (static_cast<u64>(value.name.id()) << 24) | (static_cast<u64>(value.type) << 8) |
+                (static_cast<u64>(value.referingTo) << 2) | static_cast<u64>(value.kind);
+        return hash * 0xff51afd7ed558ccdull;
+    }
 };
 
 struct Initializer {
@@ -119,10 +139,10 @@ protected:
 };
 
 struct ValueInitializer final : Initializer {
-    std::shared_ptr<Value> value;
+    Value value;
 
-    explicit ValueInitializer(std::shared_ptr<Value> value)
-        : Initializer(Kind::Value), value(std::move(value)) {}
+    explicit ValueInitializer(const Value& value)
+        : Initializer(Kind::Value), value(value) {}
 
     static bool classOf(const Initializer* initializer) { return initializer->kind == Kind::Value; }
 };
@@ -137,7 +157,7 @@ struct ZeroInitializer final : Initializer {
 };
 
 struct Instruction {
-    enum class Kind {
+    enum class Kind : u8 {
         Return,
         SignExtend, Truncate, ZeroExtend,
         DoubleToInt, DoubleToUInt, IntToDouble, UIntToDouble,
@@ -150,20 +170,18 @@ struct Instruction {
     Type type;
 
     Instruction() = delete;
-
-    virtual ~Instruction() = default;
 protected:
     explicit Instruction(const Kind k, const Type t)
         : kind(k), type(t) {}
 };
 
 struct ReturnInst final : Instruction {
-    std::shared_ptr<Value> returnValue = nullptr;
+    ValueId returnValue = ValueId::None;
 
     explicit ReturnInst(const Type t)
         : Instruction(Kind::Return, t) {}
-    explicit ReturnInst(std::shared_ptr<Value> v, const Type t)
-        : Instruction(Kind::Return, t), returnValue(std::move(v)) {}
+    explicit ReturnInst(const ValueId v, const Type t)
+        : Instruction(Kind::Return, t), returnValue(v) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::Return; }
 
@@ -171,10 +189,10 @@ struct ReturnInst final : Instruction {
 };
 
 struct SignExtendInst final : Instruction {
-    std::shared_ptr<Value> src;
-    std::shared_ptr<Value> dst;
-    SignExtendInst(std::shared_ptr<Value> src, std::shared_ptr<Value> dst, const Type t)
-        : Instruction(Kind::SignExtend, t), src(std::move(src)), dst(std::move(dst)) {}
+    ValueId src;
+    ValueId dst;
+    SignExtendInst(const ValueId src, const ValueId dst, const Type t)
+        : Instruction(Kind::SignExtend, t), src(src), dst(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::SignExtend; }
 
@@ -182,10 +200,10 @@ struct SignExtendInst final : Instruction {
 };
 
 struct TruncateInst final : Instruction {
-    std::shared_ptr<Value> src;
-    std::shared_ptr<Value> dst;
-    TruncateInst(std::shared_ptr<Value> src, std::shared_ptr<Value> dst, const Type t)
-        : Instruction(Kind::Truncate, t), src(std::move(src)), dst(std::move(dst)) {}
+    ValueId src;
+    ValueId dst;
+    TruncateInst(const ValueId src, const ValueId dst, const Type t)
+        : Instruction(Kind::Truncate, t), src(src), dst(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::Truncate; }
 
@@ -193,10 +211,10 @@ struct TruncateInst final : Instruction {
 };
 
 struct ZeroExtendInst final : Instruction {
-    std::shared_ptr<Value> src;
-    std::shared_ptr<Value> dst;
-    ZeroExtendInst(std::shared_ptr<Value> src, std::shared_ptr<Value> dst, const Type t)
-        : Instruction(Kind::ZeroExtend, t), src(std::move(src)), dst(std::move(dst)) {}
+    ValueId src;
+    ValueId dst;
+    ZeroExtendInst(const ValueId src, const ValueId dst, const Type t)
+        : Instruction(Kind::ZeroExtend, t), src(src), dst(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::ZeroExtend; }
 
@@ -204,10 +222,10 @@ struct ZeroExtendInst final : Instruction {
 };
 
 struct DoubleToIntInst final : Instruction {
-    std::shared_ptr<Value> src;
-    std::shared_ptr<Value> dst;
-    DoubleToIntInst(std::shared_ptr<Value> src, std::shared_ptr<Value> dst, const Type t)
-        : Instruction(Kind::DoubleToInt, t), src(std::move(src)), dst(std::move(dst)) {}
+    ValueId src;
+    ValueId dst;
+    DoubleToIntInst(const ValueId src, const ValueId dst, const Type t)
+        : Instruction(Kind::DoubleToInt, t), src(src), dst(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::DoubleToInt; }
 
@@ -215,10 +233,10 @@ struct DoubleToIntInst final : Instruction {
 };
 
 struct DoubleToUIntInst final : Instruction {
-    std::shared_ptr<Value> src;
-    std::shared_ptr<Value> dst;
-    DoubleToUIntInst(std::shared_ptr<Value> src, std::shared_ptr<Value> dst, const Type t)
-        : Instruction(Kind::DoubleToUInt, t), src(std::move(src)), dst(std::move(dst)) {}
+    ValueId src;
+    ValueId dst;
+    DoubleToUIntInst(const ValueId src, const ValueId dst, const Type t)
+        : Instruction(Kind::DoubleToUInt, t), src(src), dst(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::DoubleToUInt; }
 
@@ -226,10 +244,10 @@ struct DoubleToUIntInst final : Instruction {
 };
 
 struct IntToDoubleInst final : Instruction {
-    std::shared_ptr<Value> src;
-    std::shared_ptr<Value> dst;
-    IntToDoubleInst(std::shared_ptr<Value> src, std::shared_ptr<Value> dst, const Type t)
-        : Instruction(Kind::IntToDouble, t), src(std::move(src)), dst(std::move(dst)) {}
+    ValueId src;
+    ValueId dst;
+    IntToDoubleInst(const ValueId src, const ValueId dst, const Type t)
+        : Instruction(Kind::IntToDouble, t), src(src), dst(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::IntToDouble; }
 
@@ -237,10 +255,10 @@ struct IntToDoubleInst final : Instruction {
 };
 
 struct UIntToDoubleInst final : Instruction {
-    std::shared_ptr<Value> src;
-    std::shared_ptr<Value> dst;
-    UIntToDoubleInst(std::shared_ptr<Value> src, std::shared_ptr<Value> dst, const Type t)
-        : Instruction(Kind::UIntToDouble, t), src(std::move(src)), dst(std::move(dst)) {}
+    ValueId src;
+    ValueId dst;
+    UIntToDoubleInst(const ValueId src, const ValueId dst, const Type t)
+        : Instruction(Kind::UIntToDouble, t), src(src), dst(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::UIntToDouble; }
 
@@ -248,14 +266,14 @@ struct UIntToDoubleInst final : Instruction {
 };
 
 struct UnaryInst final : Instruction {
-    enum class Operation {
+    enum class Operation : u8 {
         Complement, Negate, Not
     };
     Operation operation;
-    std::shared_ptr<Value> src;
-    std::shared_ptr<Value> dst;
-    UnaryInst(const Operation op, std::shared_ptr<Value> src, std::shared_ptr<Value> dst, const Type t)
-        : Instruction(Kind::Unary, t), operation(op), src(std::move(src)), dst(std::move(dst)) {}
+    ValueId src;
+    ValueId dst;
+    UnaryInst(const Operation op, const ValueId src, const ValueId dst, const Type t)
+        : Instruction(Kind::Unary, t), operation(op), src(src), dst(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::Unary; }
 
@@ -263,7 +281,7 @@ struct UnaryInst final : Instruction {
 };
 
 struct BinaryInst final : Instruction {
-    enum class Operation {
+    enum class Operation : u8 {
         Add, Subtract, Multiply, Divide, Remainder,
         BitwiseAnd, BitwiseOr, BitwiseXor,
         LeftShift, RightShift,
@@ -271,14 +289,10 @@ struct BinaryInst final : Instruction {
         LessThan, LessOrEqual, GreaterThan, GreaterOrEqual
     };
     Operation operation;
-    std::shared_ptr<Value> lhs;
-    std::shared_ptr<Value> rhs;
-    std::shared_ptr<Value> dst;
-    BinaryInst(const Operation op,
-               const std::shared_ptr<Value>& src1,
-               const std::shared_ptr<Value>& src2,
-               const std::shared_ptr<Value>& dst,
-               const Type t)
+    ValueId lhs;
+    ValueId rhs;
+    ValueId dst;
+    BinaryInst(const Operation op, const ValueId src1, const ValueId src2, const ValueId dst, const Type t)
         : Instruction(Kind::Binary, t), operation(op), lhs(src1), rhs(src2), dst(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::Binary; }
@@ -287,10 +301,10 @@ struct BinaryInst final : Instruction {
 };
 
 struct CopyInst final : Instruction {
-    std::shared_ptr<Value> src;
-    std::shared_ptr<Value> dst;
-    CopyInst(std::shared_ptr<Value> src, std::shared_ptr<Value> dst, const Type t)
-        : Instruction(Kind::Copy, t), src(std::move(src)), dst(std::move(dst)) {}
+    ValueId src;
+    ValueId dst;
+    CopyInst(const ValueId src, const ValueId dst, const Type t)
+        : Instruction(Kind::Copy, t), src(src), dst(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::Copy; }
 
@@ -298,10 +312,10 @@ struct CopyInst final : Instruction {
 };
 
 struct GetAddressInst final : Instruction {
-    std::shared_ptr<Value> src;
-    std::shared_ptr<Value> dst;
-    GetAddressInst(std::shared_ptr<Value> src, std::shared_ptr<Value> dst, const Type t)
-        : Instruction(Kind::GetAddress, t), src(std::move(src)), dst(std::move(dst)) {}
+    ValueId src;
+    ValueId dst;
+    GetAddressInst(const ValueId src, const ValueId dst, const Type t)
+        : Instruction(Kind::GetAddress, t), src(src), dst(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::GetAddress; }
 
@@ -309,10 +323,10 @@ struct GetAddressInst final : Instruction {
 };
 
 struct LoadInst final : Instruction {
-    std::shared_ptr<Value> ptr;
-    std::shared_ptr<Value> dst;
-    LoadInst(std::shared_ptr<Value> src, std::shared_ptr<Value> dst, const Type t)
-        : Instruction(Kind::Load, t), ptr(std::move(src)), dst(std::move(dst)) {}
+    ValueId ptr;
+    ValueId dst;
+    LoadInst(const ValueId src, const ValueId dst, const Type t)
+        : Instruction(Kind::Load, t), ptr(src), dst(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::Load; }
 
@@ -320,10 +334,10 @@ struct LoadInst final : Instruction {
 };
 
 struct StoreInst final : Instruction {
-    std::shared_ptr<Value> src;
-    std::shared_ptr<Value> ptr;
-    StoreInst(std::shared_ptr<Value> src, std::shared_ptr<Value> dst, const Type t)
-        : Instruction(Kind::Store, t), src(std::move(src)), ptr(std::move(dst)) {}
+    ValueId src;
+    ValueId ptr;
+    StoreInst(const ValueId src, const ValueId dst, const Type t)
+        : Instruction(Kind::Store, t), src(src), ptr(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::Store; }
 
@@ -331,17 +345,16 @@ struct StoreInst final : Instruction {
 };
 
 struct AddPtrInst final : Instruction {
-    std::shared_ptr<Value> ptr;
-    std::shared_ptr<Value> index;
-    std::shared_ptr<Value> dst;
+    ValueId ptr;
+    ValueId index;
+    ValueId dst;
     i64 scale;
 
-    AddPtrInst(std::shared_ptr<Value> src, std::shared_ptr<Value> index,
-               std::shared_ptr<Value> dst, const i64 scale)
+    AddPtrInst(const ValueId src, const ValueId index, const ValueId dst, const i64 scale)
         : Instruction(Kind::AddPtr, Type::Pointer),
-          ptr(std::move(src)),
-          index(std::move(index)),
-          dst(std::move(dst)),
+          ptr(src),
+          index(index),
+          dst(dst),
           scale(scale) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::AddPtr; }
@@ -350,20 +363,12 @@ struct AddPtrInst final : Instruction {
 };
 
 struct CopyToOffsetInst final : Instruction {
-    std::shared_ptr<Value> src;
+    ValueId src;
     const Identifier iden;
     const i64 offset;
-    const i64 size;
-    const i64 alignment;
 
-    CopyToOffsetInst(std::shared_ptr<Value> src,
-                     Identifier iden,
-                     const i64 offset,
-                     const i64 sizeArray,
-                     const i64 alignment,
-                     const Type t)
-        : Instruction(Kind::CopyToOffset, t), src(std::move(src)),
-          iden(std::move(iden)), offset(offset), size(sizeArray), alignment(alignment) {}
+    CopyToOffsetInst(const ValueId src, const Identifier iden, const i64 offset, const Type t)
+        : Instruction(Kind::CopyToOffset, t), src(src), iden(iden), offset(offset) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::CopyToOffset; }
 
@@ -371,9 +376,9 @@ struct CopyToOffsetInst final : Instruction {
 };
 
 struct JumpInst final : Instruction {
-    Identifier target;
-    explicit JumpInst(Identifier target)
-        : Instruction(Kind::Jump, Type::I32), target(std::move(target)) {}
+    LabelId target;
+    explicit JumpInst(const LabelId target)
+        : Instruction(Kind::Jump, Type::I32), target(target) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::Jump; }
 
@@ -381,12 +386,10 @@ struct JumpInst final : Instruction {
 };
 
 struct JumpIfZeroInst final : Instruction {
-    std::shared_ptr<Value> condition;
-    Identifier target;
-    JumpIfZeroInst(std::shared_ptr<Value> condition, Identifier target)
-        : Instruction(Kind::JumpIfZero, condition->type),
-            condition(std::move(condition)),
-            target(std::move(target)) {}
+    ValueId condition;
+    LabelId target;
+    JumpIfZeroInst(const ValueId condition, const LabelId target, const Type t)
+        : Instruction(Kind::JumpIfZero, t), condition(condition), target(target) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::JumpIfZero; }
 
@@ -394,12 +397,10 @@ struct JumpIfZeroInst final : Instruction {
 };
 
 struct JumpIfNotZeroInst final : Instruction {
-    std::shared_ptr<Value> condition;
-    Identifier target;
-    JumpIfNotZeroInst(std::shared_ptr<Value> condition, Identifier target)
-        : Instruction(Kind::JumpIfNotZero, condition->type),
-            condition(std::move(condition)),
-            target(std::move(target)) {}
+    ValueId condition;
+    LabelId target;
+    JumpIfNotZeroInst(const ValueId condition, const LabelId target, const Type t)
+        : Instruction(Kind::JumpIfNotZero, t), condition(condition), target(target) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::JumpIfNotZero; }
 
@@ -407,33 +408,32 @@ struct JumpIfNotZeroInst final : Instruction {
 };
 
 struct LabelInst final : Instruction {
-    Identifier target;
-    explicit LabelInst(Identifier target)
-        : Instruction(Kind::Label, Type::I32), target(std::move(target)) {}
+    LabelId target;
+    explicit LabelInst(const LabelId target)
+        : Instruction(Kind::Label, Type::I32), target(target) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::Label; }
 
     LabelInst() = delete;
 };
 
+// The arguments live in the callArgs table of the function, [firstArg, firstArg + argCount).
 struct FunCallInst final : Instruction {
     Identifier funName;
-    std::vector<std::shared_ptr<Value>> args;
-    std::shared_ptr<Value> destination = nullptr;
-
-    FunCallInst(Identifier funName,
-                std::vector<std::shared_ptr<Value>> args,
-                std::shared_ptr<Value> dst,
+    u32 firstArg;
+    u32 argCount;
+    ValueId destination = ValueId::None;
+
+    FunCallInst(const Identifier funName,
+                const u32 firstArg,
+                const u32 argCount,
+                const ValueId dst,
                 const Type t)
         : Instruction(Kind::FunCall, t),
-            funName(std::move(funName)),
-            args(std::move(args)),
-            destination(std::move(dst)) {}
-
-    FunCallInst(Identifier funName,
-            std::vector<std::shared_ptr<Value>> args,
-            const Type t)
-    : Instruction(Kind::FunCall, t), funName(std::move(funName)), args(std::move(args)) {}
+            funName(funName),
+            firstArg(firstArg),
+            argCount(argCount),
+            destination(dst) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::FunCall; }
 
@@ -444,8 +444,8 @@ struct AllocateInst final : Instruction {
     const i64 size;
     const Identifier iden;
 
-    AllocateInst(const i64 size, Identifier iden, const Type type)
-        : Instruction(Kind::Allocate, type), size(size), iden(std::move(iden)) {}
+    AllocateInst(const i64 size, const Identifier iden, const Type type)
+        : Instruction(Kind::Allocate, type), size(size), iden(iden) {}
 
     static bool classOf(const Instruction* inst) { return inst->kind == Kind::Allocate; }
 
@@ -467,13 +467,36 @@ protected:
 };
 
 struct Function final : TopLevel {
-    std::string name;
+    Identifier name;
     std::vector<Identifier> args;
     std::vector<Type> argTypes;
-    std::vector<std::unique_ptr<Instruction>> insts;
+    std::vector<Instruction*> insts;
+    std::vector<Value> values;
+    std::vector<ValueId> callArgs;
+    InstructionPool pool;
+    u32 labelCount = 0;
     const bool isGlobal;
-    Function(std::string identifier, const bool isGlobal)
-        : TopLevel(Kind::Function), name(std::move(identifier)), isGlobal(isGlobal) {}
+    Function(const Identifier identifier, const bool isGlobal)
+        : TopLevel(Kind::Function), name(identifier), isGlobal(isGlobal) {}
+
+    [[nodiscard]] const Value& value(const ValueId id) const { return values[static_cast<u32>(id)]; }
+    [[nodiscard]] Value& value(const ValueId id) { return values[static_cast<u32>(id)]; }
+    [[nodiscard]] std::span<const ValueId> arguments(const FunCallInst& inst) const
+    {
+        return {callArgs.data() + inst.firstArg, inst.argCount};
+    }
+    [[nodiscard]] std::span<ValueId> arguments(const FunCallInst& inst)
+    {
+        return {callArgs.data() + inst.firstArg, inst.argCount};
+    }
+    ValueId addValue(const Value& value)
+    {
+        values.push_back(value);
+        return static_cast<ValueId>(values.size() - 1);
+    }
+    LabelId addLabel() { return static_cast<LabelId>(labelCount++); }
+    template<typename T, typename... Args>
+    T* make(Args&&... args) { return pool.make<T>(std::forward<Args>(args)...); }
 
     static bool classOf(const TopLevel* topLevel) { return topLevel->kind == Kind::Function; }
 
@@ -481,33 +504,32 @@ struct Function final : TopLevel {
 };
 
 struct StaticVariable final : TopLevel {
-    const std::string name;
-    const std::shared_ptr<Value> value;
+    const Identifier name;
+    const Value value;
     const Type type;
     const bool global;
-    StaticVariable(std::string identifier,
-                   const std::shared_ptr<Value>& value,
+    StaticVariable(const Identifier identifier,
+                   const Value& value,
                    const Type ty,
                    const bool isGlobal)
-        : TopLevel(Kind::StaticVariable), name(std::move(identifier)),
+        : TopLevel(Kind::StaticVariable), name(identifier),
                 value(value), type(ty), global(isGlobal) {}
 
     static bool classOf(const TopLevel* topLevel) { return topLevel->kind == Kind::StaticVariable; }
 
     StaticVariable() = delete;
 };
-
 struct StaticArray final : TopLevel {
-    const std::string name;
+    const Identifier name;
     const std::vector<std::unique_ptr<Initializer>> initializers;
     const Type type;
     const bool global;
-    StaticArray(std::string identifier,
+    StaticArray(const Identifier identifier,
                 std::vector<std::unique_ptr<Initializer>>&& initializers,
                 const Type ty,
                 const bool isGlobal)
         : TopLevel(Kind::StaticArray),
-          name(std::move(identifier)),
+          name(identifier),
           initializers(std::move(initializers)),
           type(ty),
           global(isGlobal) {}
@@ -536,7 +558,6 @@ struct StaticConstant final : TopLevel {
 
 struct Program {
     std::vector<std::unique_ptr<TopLevel>> topLevels;
-    std::vector<std::unique_ptr<Value>> values;
     Program() = default;
 
     Program(Program&&) = default;
@@ -0,0 +1,24 @@
+#include "InstructionPool.hpp"
+
+#include <algorithm>
+
+namespace Ir {
+
+void* InstructionPool::allocate(const size_t size, const size_t alignment)
+{
+    auto cursor = reinterpret_cast<uintptr_t>(m_cursor);
+    uintptr_t aligned = (cursor + alignment - 1) & ~(alignment - 1);
+    if (m_cursor == nullptr || m_end < reinterpret_cast<std::byte*>(aligned + size)) {
+        const size_t blockSize = std::max(s_blockSize, size + alignment);
+        m_blocks.emplace_back(new std::byte[blockSize]);
+        m_cursor = m_blocks.back().get();
+        m_end = m_cursor + blockSize;
+        cursor = reinterpret_cast<uintptr_t>(m_cursor);
+        aligned = (cursor + alignment - 1) & ~(alignment - 1);
+    }
+    m_cursor = reinterpret_cast<std::byte*>(aligned + size);
+    m_bytesAllocated += size;
+    return reinterpret_cast<void*>(aligned);
+}
+
+} // Ir
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Ir {
+
+// Bump storage for the instructions of one function. Instructions are trivially
+// destructible, so the pool hands its blocks back at once without visiting them.
+class InstructionPool {
+    static constexpr size_t s_blockSize = 16 * 1024;
+    std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+    std::byte* m_cursor = nullptr;
+    std::byte* m_end = nullptr;
+    size_t m_bytesAllocated = 0;
+public:
+    InstructionPool() = default;
+    InstructionPool(InstructionPool&& other) noexcept
+        : m_blocks(std::move(other.m_blocks)),
+          m_cursor(std::exchange(other.m_cursor, nullptr)),
+          m_end(std::exchange(other.m_end, nullptr)),
+          m_bytesAllocated(std::exchange(other.m_bytesAllocated, 0)) {}
+    InstructionPool& operator=(InstructionPool&& other) noexcept
+    {
+        m_blocks = std::move(other.m_blocks);
+        m_cursor = std::exchange(other.m_cursor, nullptr);
+        m_end = std::exchange(other.m_end, nullptr);
+        m_bytesAllocated = std::exchange(other.m_bytesAllocated, 0);
+        return *this;
+    }
+
+    InstructionPool(const InstructionPool&) = delete;
+    InstructionPool& operator=(const InstructionPool&) = delete;
+
+    template<typename T, typename... Args>
+    [[nodiscard]] T* make(Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible_v<T>);
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+    [[nodiscard]] size_t bytesAllocated() const { return m_bytesAllocated; }
+private:
+    [[nodiscard]] void* allocate(size_t size, size_t alignment);
+};
+
+} // Ir
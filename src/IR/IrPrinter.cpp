@@ -41,7 +41,7 @@ std::string IrPrinter::print(const Program& program)
 void IrPrinter::print(const StaticConstant& staticConstant)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("StaticConstant: " + staticConstant.identifier.value);
+    addLine("StaticConstant: " + print(staticConstant.identifier));
     addLine("Value: " + staticConstant.value);
     if (staticConstant.global)
         addLine("Is Global");
@@ -52,7 +52,7 @@ void IrPrinter::print(const StaticConstant& staticConstant)
 void IrPrinter::print(const StaticArray& staticArray)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("StaticArray: " + staticArray.name);
+    addLine("StaticArray: " + print(staticArray.name));
     addLine("Type: " + to_string(staticArray.type));
     IndentGuard guardInits(m_indentLevel);
     if (staticArray.global)
@@ -61,7 +61,7 @@ void IrPrinter::print(const StaticArray& staticArray)
         switch (init->kind) {
             case Initializer::Kind::Value: {
                 const auto value = dynCast<ValueInitializer>(init.get());
-                addLine(print(*value->value));
+                addLine(print(value->value));
                 break;
             }
             case Initializer::Kind::Zero: {
@@ -76,19 +76,19 @@ void IrPrinter::print(const StaticArray& staticArray)
 void IrPrinter::print(const StaticVariable& variable)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("Variable: " + variable.name);
+    addLine("Variable: " + print(variable.name));
     IndentGuard innerGuard(m_indentLevel);
     if (variable.global)
         addLine("is Global");
     else
         addLine("is not Global");
-    addLine(print(*variable.value));
+    addLine(print(variable.value));
 }
 
 void IrPrinter::print(const Function& function)
 {
     IndentGuard guard(m_indentLevel);
-    addLine("Function " + function.name);
+    addLine("Function " + print(function.name));
     if (function.isGlobal)
         addLine("is Global");
     else
@@ -99,31 +99,31 @@ void IrPrinter::print(const Function& function)
             args += print(arg) + ", ";
         addLine("args: " + args);
     }
-    for (const auto& inst : function.insts)
+    m_function = &function;
+    for (const Instruction* inst : function.insts)
         print(*inst);
+    m_function = nullptr;
 }
 
-std::string IrPrinter::print(const Value& value)
+std::string IrPrinter::print(const ValueId value) const
 {
-    switch (value.kind) {
-        case Value::Kind::Variable:
-            return print(*dynCast<const ValueVar>(&value));
-        case Value::Kind::Constant:
-            return print(*dynCast<const ValueConst>(&value));
-        default:
-            std::abort();
-    }
+    return print(m_function->value(value));
+}
+
+std::string IrPrinter::print(const LabelId label)
+{
+    return "L" + std::to_string(static_cast<u32>(label));
 }
 
 std::string IrPrinter::print(const Identifier& identifier)
 {
-    return identifier.value;
+    return identifier.value.str();
 }
 
 void IrPrinter::print(const ReturnInst& inst)
 {
-    if (inst.returnValue)
-        addLine("Return: " + print(*inst.returnValue));
+    if (inst.returnValue != ValueId::None)
+        addLine("Return: " + print(inst.returnValue));
     else
         addLine("Return:");
     addLine("");
@@ -131,90 +131,90 @@ void IrPrinter::print(const ReturnInst& inst)
 
 void IrPrinter::print(const SignExtendInst& inst)
 {
-    addLine("SignExtend: " + print(*inst.src) + " -> " + print(*inst.dst) + ", " + to_string(inst.type));
+    addLine("SignExtend: " + print(inst.src) + " -> " + print(inst.dst) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const ZeroExtendInst& inst)
 {
-    addLine("ZeroExtend: " + print(*inst.src) + " -> " + print(*inst.dst) + ", " + to_string(inst.type));
+    addLine("ZeroExtend: " + print(inst.src) + " -> " + print(inst.dst) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const TruncateInst& inst)
 {
-    addLine("Truncate: " + print(*inst.src) + " -> " + print(*inst.dst) + ", " + to_string(inst.type));
+    addLine("Truncate: " + print(inst.src) + " -> " + print(inst.dst) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const DoubleToIntInst& inst)
 {
-    addLine("DoubleToInt: " + print(*inst.src) + " -> " + print(*inst.dst) + ", " + to_string(inst.type));
+    addLine("DoubleToInt: " + print(inst.src) + " -> " + print(inst.dst) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const DoubleToUIntInst& inst)
 {
-    addLine("DoubleToUInt: " + print(*inst.src) + " -> " + print(*inst.dst) + ", " + to_string(inst.type));
+    addLine("DoubleToUInt: " + print(inst.src) + " -> " + print(inst.dst) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const IntToDoubleInst& inst)
 {
-    addLine("IntToDouble: " + print(*inst.src) + " -> " + print(*inst.dst) + ", " + to_string(inst.type));
+    addLine("IntToDouble: " + print(inst.src) + " -> " + print(inst.dst) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const UIntToDoubleInst& inst)
 {
-    addLine("UIntToDouble: " + print(*inst.src) + " -> " + print(*inst.dst) + ", " + to_string(inst.type));
+    addLine("UIntToDouble: " + print(inst.src) + " -> " + print(inst.dst) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const UnaryInst& inst)
 {
     addLine(to_string(inst.operation) + " " +
-            print(*inst.src) + " -> " +
-            print(*inst.dst) + ", " +
+            print(inst.src) + " -> " +
+            print(inst.dst) + ", " +
             to_string(inst.type));
 }
 
 void IrPrinter::print(const BinaryInst& inst)
 {
-    addLine(print(*inst.lhs) + " " +
+    addLine(print(inst.lhs) + " " +
             to_string(inst.operation) + " " +
-            print(*inst.rhs) + " -> " +
-            print(*inst.dst) + ", " +
+            print(inst.rhs) + " -> " +
+            print(inst.dst) + ", " +
             to_string(inst.type));
 }
 
 void IrPrinter::print(const CopyInst& inst)
 {
-    addLine("Copy: " + print(*inst.src) + " -> " + print(*inst.dst) + ", " + to_string(inst.type));
+    addLine("Copy: " + print(inst.src) + " -> " + print(inst.dst) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const GetAddressInst& inst)
 {
-    addLine("GetAddress: " + print(*inst.src) + " -> " + print(*inst.dst) + ", " + to_string(inst.type));
+    addLine("GetAddress: " + print(inst.src) + " -> " + print(inst.dst) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const LoadInst& inst)
 {
-    addLine("Load: " + print(*inst.ptr) + " -> " + print(*inst.dst) + ", " + to_string(inst.type));
+    addLine("Load: " + print(inst.ptr) + " -> " + print(inst.dst) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const StoreInst& inst)
 {
-    addLine("Store: " + print(*inst.src) + " -> " + print(*inst.ptr) + ", " + to_string(inst.type));
+    addLine("Store: " + print(inst.src) + " -> " + print(inst.ptr) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const AddPtrInst& inst)
 {
     addLine("AddPtrInst: " +
-            print(*inst.ptr) + " + " +
-            print(*inst.index) + " * " +
+            print(inst.ptr) + " + " +
+            print(inst.index) + " * " +
             std::to_string(inst.scale) + " -> " +
-            print(*inst.dst) + " " +
+            print(inst.dst) + " " +
             to_string(inst.type));
 }
 
 void IrPrinter::print(const CopyToOffsetInst& inst)
 {
     addLine("CopyToOffsetInst: " +
-            print(*inst.src) + " -> " +
+            print(inst.src) + " -> " +
             print(inst.iden) + " offset " +
             std::to_string(inst.offset) + ", " +
             to_string(inst.type));
@@ -227,12 +227,12 @@ void IrPrinter::print(const JumpInst& inst)
 
 void IrPrinter::print(const JumpIfZeroInst& inst)
 {
-    addLine("JumpIfZero: " + print(*inst.condition) + ", " + print(inst.target) + ", " + to_string(inst.type));
+    addLine("JumpIfZero: " + print(inst.condition) + ", " + print(inst.target) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const JumpIfNotZeroInst& inst)
 {
-    addLine("JumpIfNotZero: " + print(*inst.condition) + ", " + print(inst.target) + ", " + to_string(inst.type));
+    addLine("JumpIfNotZero: " + print(inst.condition) + ", " + print(inst.target) + ", " + to_string(inst.type));
 }
 
 void IrPrinter::print(const LabelInst& inst)
@@ -242,16 +242,16 @@ void IrPrinter::print(const LabelInst& inst)
 
 void IrPrinter::print(const FunCallInst &inst)
 {
-    addLine("FunCall: " + inst.funName.value);
+    addLine("FunCall: " + print(inst.funName));
     IndentGuard guard2(m_indentLevel);
-    if (!inst.args.empty()) {
+    if (inst.argCount != 0) {
         std::string args;
-        for (const auto& arg : inst.args)
-            args += print(*arg) + ", ";
+        for (const ValueId arg : m_function->arguments(inst))
+            args += print(arg) + ", ";
         addLine("args: " + args);
     }
-    if (inst.destination)
-        print(*inst.destination);
+    if (inst.destination != ValueId::None)
+        addLine(print(inst.destination));
 }
 
 void IrPrinter::print(const AllocateInst& inst)
@@ -259,24 +259,22 @@ void IrPrinter::print(const AllocateInst& inst)
     addLine("Allocate:" + print(inst.iden) + ", " + std::to_string(inst.size));
 }
 
-std::string IrPrinter::print(const ValueVar& val)
-{
-    if (val.type == Type::I32)
-        return "Var(" + print(val.value) + ") i32";
-    return "Var(" + print(val.value) + ") i64";
-}
-
-std::string IrPrinter::print(const ValueConst& val)
+std::string IrPrinter::print(const Value& value)
 {
-    switch (val.type) {
-        case Type::I8:           return "Const(" + std::to_string(std::get<i8>(val.value)) + ") I8";
-        case Type::U8:           return "Const(" + std::to_string(std::get<u8>(val.value)) + ") U8";
-        case Type::Char:         return "Const(" + std::to_string(std::get<char>(val.value)) + ") Char";
-        case Type::I32:          return "Const(" + std::to_string(std::get<i32>(val.value)) + ") i32";
-        case Type::I64:          return "Const(" + std::to_string(std::get<i64>(val.value)) + ") i64";
-        case Type::U32:          return "Const(" + std::to_string(std::get<u32>(val.value)) + ") u32";
-        case Type::U64:          return "Const(" + std::to_string(std::get<u64>(val.value)) + ") u64";
-        case Type::Double:       return "Const(" + std::to_string(std::get<double>(val.value)) + ") double";
+    if (value.isVariable()) {
+        if (value.type == Type::I32)
+            return "Var(" + value.name.str() + ") i32";
+        return "Var(" + value.name.str() + ") i64";
+    }
+    switch (value.type) {
+        case Type::I8:           return "Const(" + std::to_string(value.asI64()) + ") I8";
+        case Type::U8:           return "Const(" + std::to_string(value.bits) + ") U8";
+        case Type::Char:         return "Const(" + std::to_string(value.asI64()) + ") Char";
+        case Type::I32:          return "Const(" + std::to_string(value.asI64()) + ") i32";
+        case Type::I64:          return "Const(" + std::to_string(value.asI64()) + ") i64";
+        case Type::U32:          return "Const(" + std::to_string(value.bits) + ") u32";
+        case Type::U64:          return "Const(" + std::to_string(value.bits) + ") u64";
+        case Type::Double:       return "Const(" + std::to_string(value.asDouble()) + ") double";
         default:
             std::abort();
     }
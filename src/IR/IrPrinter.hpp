@@ -17,6 +17,7 @@ class IrPrinter {
         size_t& m_level;
     };
     std::ostringstream m_oss;
+    const Function* m_function = nullptr;
     size_t m_indentLevel = 0;
     static constexpr i32 c_indentMult = 4;
 public:
@@ -30,8 +31,8 @@ public:
     void print(const Instruction& instruction);
     static std::string print(const Value& value);
     static std::string print(const Identifier& identifier);
-    static std::string print(const ValueVar& val);
-    static std::string print(const ValueConst& val);
+    static std::string print(LabelId label);
+    [[nodiscard]] std::string print(ValueId value) const;
 
 private:
     void print(const ReturnInst& inst);
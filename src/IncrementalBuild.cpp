@@ -0,0 +1,138 @@
+#include "IncrementalBuild.hpp"
+#include "Assembly.hpp"
+#include "CodeGenDriver.hpp"
+#include "DynCast.hpp"
+#include "FunctionFingerprint.hpp"
+#include "GenerateAsmTree.hpp"
+#include "GenerateIr.hpp"
+#include "ObjectEmitter.hpp"
+
+#include <utility>
+
+IncrementalBuild::IncrementalBuild(const CompileCache& cache, std::string argument,
+                                   const Optimization::Options& optimization)
+    : m_cache(cache), m_argument(std::move(argument))
+{
+    m_flags = m_argument;
+    if (const std::string flags = optimization.flags(); !flags.empty())
+        m_flags += ' ' + flags;
+    m_passManager = Optimization::PassManager::create(optimization);
+}
+
+StateCode IncrementalBuild::run(FrontendDriver& frontend, CodeGen::Program& program,
+                                const CodeGen::WorkStealingPool& pool)
+{
+    m_segments.clear();
+    m_reused = 0;
+    m_generated = 0;
+    auto [irProgram, err] = frontend.run([this, &pool](const Parsing::Program& parsingProgram,
+                                                       SymbolTable& symbolTable,
+                                                       std::vector<Error>& errors) {
+        return lower(parsingProgram, symbolTable, errors, pool);
+    });
+    if (!irProgram.has_value())
+        return err;
+    m_passManager.runFunctionPasses(*irProgram, pool);
+
+    std::vector<CodeGen::GenerateAsmTree::GeneratedTopLevel> generated =
+        CodeGen::GenerateAsmTree::genTopLevels(*irProgram, pool);
+    CodeGen::Program fresh;
+    for (CodeGen::GenerateAsmTree::GeneratedTopLevel& topLevel : generated)
+        fresh.topLevels.emplace_back(std::move(topLevel.topLevel));
+    CodeGen::fixAsm(fresh, pool);
+    emitFunctions(fresh, pool);
+
+    std::vector<std::unique_ptr<CodeGen::TopLevel>> constants;
+    std::vector<std::pair<std::string, std::string>> entries;
+    for (Segment& segment : m_segments) {
+        CodeGen::FunctionUnit unit;
+        if (segment.cached.has_value()) {
+            unit = std::move(*segment.cached);
+        }
+        else {
+            for (size_t i = segment.begin; i < segment.end; ++i) {
+                unit.topLevels.emplace_back(std::move(fresh.topLevels[i]));
+                for (std::unique_ptr<CodeGen::TopLevel>& constant : generated[i].constants)
+                    unit.constants.emplace_back(std::move(constant));
+            }
+            if (!segment.key.empty())
+                entries.emplace_back(segment.key, unit.serialize());
+        }
+        for (std::unique_ptr<CodeGen::TopLevel>& topLevel : unit.topLevels)
+            program.topLevels.emplace_back(std::move(topLevel));
+        for (std::unique_ptr<CodeGen::TopLevel>& constant : unit.constants)
+            constants.emplace_back(std::move(constant));
+    }
+    CodeGen::GenerateAsmTree generateAsmTree;
+    generateAsmTree.appendConstants(program, std::move(constants));
+    m_cache.save(entries);
+    return StateCode::Continue;
+}
+
+Ir::Program IncrementalBuild::lower(const Parsing::Program& program, SymbolTable& symbolTable,
+                                    std::vector<Error>& errors, const CodeGen::WorkStealingPool& pool)
+{
+    m_segments.resize(program.declarations.size());
+    std::vector<bool> isGlobal(program.declarations.size());
+    for (size_t i = 0; i < program.declarations.size(); ++i)
+        if (const Parsing::FuncDeclaration* function = definition(*program.declarations[i]))
+            isGlobal[i] = !symbolTable.lookup(function->name).hasInternalLinkage();
+    pool.run(program.declarations.size(), [this, &program, &isGlobal](const size_t i) {
+        const Parsing::FuncDeclaration* function = definition(*program.declarations[i]);
+        if (function == nullptr)
+            return;
+        Segment& segment = m_segments[i];
+        segment.key = CompileCache::key(Parsing::FunctionFingerprint::encode(*function, isGlobal[i]),
+                                        m_flags + " function");
+        if (const std::optional<std::string> bytes = m_cache.load(segment.key))
+            segment.cached = CodeGen::FunctionUnit::deserialize(*bytes);
+    });
+
+    Ir::Program irProgram;
+    Ir::GenerateIr generateIr(symbolTable);
+    for (size_t i = 0; i < program.declarations.size(); ++i) {
+        Segment& segment = m_segments[i];
+        if (segment.cached.has_value()) {
+            ++m_reused;
+            continue;
+        }
+        if (!segment.key.empty())
+            ++m_generated;
+        segment.begin = irProgram.topLevels.size();
+        for (std::unique_ptr<Ir::TopLevel>& topLevel : generateIr.declarationIr(*program.declarations[i]))
+            irProgram.topLevels.emplace_back(std::move(topLevel));
+        segment.end = irProgram.topLevels.size();
+    }
+    errors = generateIr.takeErrors();
+    return irProgram;
+}
+
+const Parsing::FuncDeclaration* IncrementalBuild::definition(const Parsing::Declaration& declaration)
+{
+    if (declaration.kind != Parsing::Declaration::Kind::FuncDecl)
+        return nullptr;
+    const auto function = dynCast<const Parsing::FuncDeclaration>(&declaration);
+    if (function->body == nullptr)
+        return nullptr;
+    return function;
+}
+
+// Emits each function in the form it is cached in. Emission is per function already, so the
+// program assembled from these gives the same output as emitting it all at once.
+void IncrementalBuild::emitFunctions(CodeGen::Program& program, const CodeGen::WorkStealingPool& pool) const
+{
+    const bool assembly = m_argument == "--assemble";
+    pool.run(program.topLevels.size(), [&program, assembly](const size_t i) {
+        std::unique_ptr<CodeGen::TopLevel>& topLevel = program.topLevels[i];
+        if (topLevel->kind != CodeGen::TopLevel::Kind::Function)
+            return;
+        const auto function = dynCast<const CodeGen::Function>(topLevel.get());
+        std::string text;
+        CodeGen::ObjectModule object;
+        if (assembly)
+            CodeGen::asmFunction(text, *function);
+        else
+            object = CodeGen::emitFunctionObject(*function);
+        topLevel = std::make_unique<CodeGen::EmittedFunction>(function->name, std::move(text), std::move(object));
+    });
+}
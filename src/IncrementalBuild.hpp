@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CompileCache.hpp"
+#include "FrontendDriver.hpp"
+#include "FunctionUnit.hpp"
+#include "PassManager.hpp"
+#include "StateCode.hpp"
+#include "WorkStealingPool.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+// Compiles a translation unit to a backend program, reusing the cached output of every function
+// definition whose FunctionFingerprint did not change. Only the other functions go through
+// GenerateIr and the backend; declarations outside of functions are always lowered again.
+// The result is the program a full compilation would produce, with each function already emitted.
+class IncrementalBuild {
+    // The top levels of one declaration, either cached or the range [begin, end) of the IR program.
+    struct Segment {
+        std::string key;
+        std::optional<CodeGen::FunctionUnit> cached;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+    const CompileCache& m_cache;
+    std::string m_argument;
+    std::string m_flags;
+    Optimization::PassManager m_passManager;
+    std::vector<Segment> m_segments;
+    size_t m_reused = 0;
+    size_t m_generated = 0;
+public:
+    // argument is "-c" or "--assemble" and selects whether functions are kept as machine code or text.
+    // Functions are optimized on their own, so only the function passes of optimization run.
+    IncrementalBuild(const CompileCache& cache, std::string argument,
+                     const Optimization::Options& optimization = {});
+
+    [[nodiscard]] StateCode run(FrontendDriver& frontend, CodeGen::Program& program,
+                                const CodeGen::WorkStealingPool& pool);
+    [[nodiscard]] size_t reused() const { return m_reused; }
+    [[nodiscard]] size_t generated() const { return m_generated; }
+private:
+    // Looks the function definitions up in the cache, in parallel, then lowers all other declarations.
+    [[nodiscard]] Ir::Program lower(const Parsing::Program& program, SymbolTable& symbolTable,
+                                    std::vector<Error>& errors, const CodeGen::WorkStealingPool& pool);
+    [[nodiscard]] static const Parsing::FuncDeclaration* definition(const Parsing::Declaration& declaration);
+    void emitFunctions(CodeGen::Program& program, const CodeGen::WorkStealingPool& pool) const;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "ASTIr.hpp"
+#include "ShortTypes.hpp"
+
+#include <array>
+#include <memory>
+
+namespace Optimization {
+
+struct Analysis {
+    enum class Kind : u8 {
+        Cfg, Dominators, Liveness
+    };
+    static constexpr size_t kindCount = 3;
+    const Kind kind;
+
+    Analysis() = delete;
+    virtual ~Analysis() = default;
+protected:
+    explicit Analysis(const Kind kind)
+        : kind(kind) {}
+};
+
+// What a pass leaves intact. A pass that did not change its function preserves everything,
+// one that rewrote the instruction list usually nothing.
+enum class Preserved : u8 {
+    None = 0,
+    Cfg = 1 << static_cast<u8>(Analysis::Kind::Cfg),
+    Dominators = 1 << static_cast<u8>(Analysis::Kind::Dominators),
+    Liveness = 1 << static_cast<u8>(Analysis::Kind::Liveness),
+    All = 0xff
+};
+
+constexpr Preserved operator|(const Preserved lhs, const Preserved rhs)
+{
+    return static_cast<Preserved>(static_cast<u8>(lhs) | static_cast<u8>(rhs));
+}
+
+constexpr Preserved operator&(const Preserved lhs, const Preserved rhs)
+{
+    return static_cast<Preserved>(static_cast<u8>(lhs) & static_cast<u8>(rhs));
+}
+
+// Analyses of one function, computed on first use and kept until a pass invalidates them.
+// Every analysis type has a static kind and is constructed from the function and this cache,
+// so analyses can build on each other.
+class FunctionAnalyses {
+    Ir::Function& m_function;
+    std::array<std::unique_ptr<Analysis>, Analysis::kindCount> m_cache;
+    u64 m_computed = 0;
+public:
+    explicit FunctionAnalyses(Ir::Function& function)
+        : m_function(function) {}
+
+    FunctionAnalyses(const FunctionAnalyses&) = delete;
+    FunctionAnalyses& operator=(const FunctionAnalyses&) = delete;
+
+    template<typename T>
+    const T& get()
+    {
+        std::unique_ptr<Analysis>& slot = m_cache[static_cast<size_t>(T::kind)];
+        if (slot == nullptr) {
+            slot = std::make_unique<T>(m_function, *this);
+            ++m_computed;
+        }
+        return *static_cast<const T*>(slot.get());
+    }
+    template<typename T>
+    [[nodiscard]] bool cached() const { return m_cache[static_cast<size_t>(T::kind)] != nullptr; }
+    // Every other analysis is derived from the CFG, so dropping it drops them all.
+    void invalidate(Preserved preserved)
+    {
+        if ((preserved & Preserved::Cfg) == Preserved::None)
+            preserved = Preserved::None;
+        for (size_t i = 0; i < m_cache.size(); ++i)
+            if ((static_cast<u8>(preserved) & (1 << i)) == 0)
+                m_cache[i].reset();
+    }
+    [[nodiscard]] Ir::Function& function() const { return m_function; }
+    // Number of times an analysis was computed, cache hits do not count.
+    [[nodiscard]] u64 computed() const { return m_computed; }
+};
+
+} // Optimization
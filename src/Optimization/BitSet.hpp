@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <vector>
+
+namespace Optimization {
+
+// Fixed size set of small integers for the dataflow analyses.
+class BitSet {
+    std::vector<u64> m_words;
+public:
+    BitSet() = default;
+    explicit BitSet(const size_t size, const bool full = false)
+        : m_words((size + 63) / 64, full ? ~u64{0} : 0) {}
+
+    [[nodiscard]] bool test(const u32 index) const { return (m_words[index / 64] >> (index % 64)) & 1; }
+    void set(const u32 index) { m_words[index / 64] |= u64{1} << (index % 64); }
+    void reset(const u32 index) { m_words[index / 64] &= ~(u64{1} << (index % 64)); }
+
+    void subtract(const BitSet& other)
+    {
+        for (size_t i = 0; i < m_words.size(); ++i)
+            m_words[i] &= ~other.m_words[i];
+    }
+    // Both return whether the set changed.
+    bool intersect(const BitSet& other)
+    {
+        bool changed = false;
+        for (size_t i = 0; i < m_words.size(); ++i) {
+            const u64 word = m_words[i] & other.m_words[i];
+            changed |= word != m_words[i];
+            m_words[i] = word;
+        }
+        return changed;
+    }
+    bool unite(const BitSet& other)
+    {
+        bool changed = false;
+        for (size_t i = 0; i < m_words.size(); ++i) {
+            const u64 word = m_words[i] | other.m_words[i];
+            changed |= word != m_words[i];
+            m_words[i] = word;
+        }
+        return changed;
+    }
+
+    bool operator==(const BitSet& other) const = default;
+};
+
+} // Optimization
@@ -0,0 +1,409 @@
+#include "ConstantFolding.hpp"
+#include "Operands.hpp"
+#include "Types/TypeConversion.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace Optimization {
+
+namespace {
+
+using Kind = Ir::Instruction::Kind;
+
+bool isFoldable(const Type type)
+{
+    switch (type) {
+        case Type::Char:
+        case Type::I8:
+        case Type::U8:
+        case Type::I32:
+        case Type::U32:
+        case Type::I64:
+        case Type::U64:
+        case Type::Double:
+            return true;
+        default:
+            return false;
+    }
+}
+
+u32 bitWidth(const Type type)
+{
+    return static_cast<u32>(getTypeSize(type)) * 8;
+}
+
+u64 zeroExtend(const u64 bits, const u32 width)
+{
+    return width == 64 ? bits : bits & ((u64{1} << width) - 1);
+}
+
+u64 signExtend(const u64 bits, const u32 width)
+{
+    const u32 unused = 64 - width;
+    return static_cast<u64>(static_cast<i64>(bits << unused) >> unused);
+}
+
+// The integer constant of the type holding the low bits.
+Ir::Value integer(const Type type, const u64 bits)
+{
+    switch (type) {
+        case Type::Char: return Ir::Value(static_cast<char>(bits));
+        case Type::I8:   return Ir::Value(static_cast<i8>(bits));
+        case Type::U8:   return Ir::Value(static_cast<u8>(bits));
+        case Type::I32:  return Ir::Value(static_cast<i32>(bits));
+        case Type::U32:  return Ir::Value(static_cast<u32>(bits));
+        case Type::I64:  return Ir::Value(static_cast<i64>(bits));
+        case Type::U64:  return Ir::Value(bits);
+        default:
+            std::abort();
+    }
+}
+
+bool isZero(const Ir::Value& value)
+{
+    return value.type == Type::Double ? value.asDouble() == 0.0 : value.bits == 0;
+}
+
+std::optional<Ir::Value> foldDoubleBinary(const Ir::BinaryInst::Operation operation,
+                                          const double lhs, const double rhs, const Type dstType)
+{
+    using Operation = Ir::BinaryInst::Operation;
+    const auto arithmetic = [dstType](const double result) -> std::optional<Ir::Value> {
+        if (dstType != Type::Double)
+            return std::nullopt;
+        return Ir::Value(result);
+    };
+    const auto comparison = [dstType](const bool result) -> std::optional<Ir::Value> {
+        if (dstType == Type::Double)
+            return std::nullopt;
+        return integer(dstType, result);
+    };
+    switch (operation) {
+        case Operation::Add:            return arithmetic(lhs + rhs);
+        case Operation::Subtract:       return arithmetic(lhs - rhs);
+        case Operation::Multiply:       return arithmetic(lhs * rhs);
+        case Operation::Divide:         return arithmetic(lhs / rhs);
+        case Operation::Equal:          return comparison(lhs == rhs);
+        case Operation::NotEqual:       return comparison(lhs != rhs);
+        case Operation::LessThan:       return comparison(lhs < rhs);
+        case Operation::LessOrEqual:    return comparison(lhs <= rhs);
+        case Operation::GreaterThan:    return comparison(lhs > rhs);
+        case Operation::GreaterOrEqual: return comparison(lhs >= rhs);
+        default:
+            return std::nullopt;
+    }
+}
+
+// Integer operands are held extended to 64 bits, so the low bits of the 64-bit result are the
+// result in the narrower type. Shifts count against the width of the promoted left operand.
+std::optional<Ir::Value> foldIntegerBinary(const Ir::BinaryInst::Operation operation,
+                                           const Ir::Value& lhs, const Ir::Value& rhs, const Type dstType)
+{
+    using Operation = Ir::BinaryInst::Operation;
+    const u64 a = lhs.bits;
+    const u64 b = rhs.bits;
+    const bool isSignedType = isSigned(lhs.type);
+    const i64 minimum = isSignedType ? static_cast<i64>(signExtend(u64{1} << (bitWidth(lhs.type) - 1),
+                                                                   bitWidth(lhs.type)))
+                                     : 0;
+    switch (operation) {
+        case Operation::Add:        return integer(dstType, a + b);
+        case Operation::Subtract:   return integer(dstType, a - b);
+        case Operation::Multiply:   return integer(dstType, a * b);
+        case Operation::BitwiseAnd: return integer(dstType, a & b);
+        case Operation::BitwiseOr:  return integer(dstType, a | b);
+        case Operation::BitwiseXor: return integer(dstType, a ^ b);
+        case Operation::Divide:
+        case Operation::Remainder: {
+            if (b == 0)
+                return std::nullopt;
+            if (!isSignedType)
+                return integer(dstType, operation == Operation::Divide ? a / b : a % b);
+            if (lhs.asI64() == minimum && rhs.asI64() == -1)
+                return std::nullopt;
+            const i64 result = operation == Operation::Divide ? lhs.asI64() / rhs.asI64()
+                                                              : lhs.asI64() % rhs.asI64();
+            return integer(dstType, static_cast<u64>(result));
+        }
+        case Operation::LeftShift:
+        case Operation::RightShift: {
+            const i64 count = rhs.asI64();
+            const i64 promotedWidth = bitWidth(lhs.type) == 64 ? 64 : 32;
+            if (count < 0 || promotedWidth <= count)
+                return std::nullopt;
+            if (operation == Operation::LeftShift)
+                return integer(dstType, a << count);
+            return integer(dstType, isSignedType ? static_cast<u64>(lhs.asI64() >> count) : a >> count);
+        }
+        case Operation::And:            return integer(dstType, a != 0 && b != 0);
+        case Operation::Or:             return integer(dstType, a != 0 || b != 0);
+        case Operation::Equal:          return integer(dstType, a == b);
+        case Operation::NotEqual:       return integer(dstType, a != b);
+        case Operation::LessThan:       return integer(dstType, isSignedType ? lhs.asI64() < rhs.asI64() : a < b);
+        case Operation::LessOrEqual:    return integer(dstType, isSignedType ? lhs.asI64() <= rhs.asI64() : a <= b);
+        case Operation::GreaterThan:    return integer(dstType, isSignedType ? lhs.asI64() > rhs.asI64() : a > b);
+        case Operation::GreaterOrEqual: return integer(dstType, isSignedType ? lhs.asI64() >= rhs.asI64() : a >= b);
+    }
+    std::abort();
+}
+
+// A double converts to an integer type only if its truncation fits, C leaves anything else
+// undefined.
+std::optional<Ir::Value> doubleToInteger(const double value, const Type dstType, const bool toSigned)
+{
+    if (!isIntegerType(dstType) || isSigned(dstType) != toSigned)
+        return std::nullopt;
+    const double truncated = std::trunc(value);
+    const i32 width = static_cast<i32>(bitWidth(dstType));
+    const double lower = toSigned ? -std::ldexp(1.0, width - 1) : 0.0;
+    const double upper = std::ldexp(1.0, toSigned ? width - 1 : width);
+    if (!(lower <= truncated && truncated < upper))
+        return std::nullopt;
+    if (toSigned)
+        return integer(dstType, static_cast<u64>(static_cast<i64>(truncated)));
+    return integer(dstType, static_cast<u64>(truncated));
+}
+
+class Folder {
+    Ir::Function& m_function;
+    const std::vector<u32> m_canonical;
+    // Per canonical value, whether it is a local assigned exactly once with its address never
+    // taken, and the constant it was assigned once that is known.
+    std::vector<bool> m_singleAssignment;
+    std::vector<Ir::ValueId> m_constantOf;
+    std::unordered_map<Ir::Value, Ir::ValueId, Ir::ValueHash> m_constants;
+    bool m_jumpsChanged = false;
+public:
+    explicit Folder(Ir::Function& function);
+
+    // One pass over the instructions, returns whether anything changed.
+    bool sweep();
+    [[nodiscard]] bool jumpsChanged() const { return m_jumpsChanged; }
+private:
+    [[nodiscard]] const Ir::Value& value(const Ir::ValueId id) const { return m_function.value(id); }
+    [[nodiscard]] u32 canonical(const Ir::ValueId id) const { return m_canonical[static_cast<u32>(id)]; }
+    Ir::ValueId constant(const Ir::Value& value);
+    Ir::ValueId knownConstant(Ir::ValueId id);
+    void assigned(Ir::ValueId dst, Ir::ValueId src);
+    bool fold(Ir::Instruction*& inst);
+    bool foldJump(Ir::Instruction*& inst, Ir::ValueId condition, Ir::LabelId target, bool jumpIfZero);
+};
+
+Folder::Folder(Ir::Function& function)
+    : m_function(function), m_canonical(canonicalValues(function)),
+      m_singleAssignment(function.values.size(), false),
+      m_constantOf(function.values.size(), Ir::ValueId::None)
+{
+    std::vector<u8> assignments(function.values.size(), 0);
+    for (const Ir::Instruction* inst : function.insts)
+        if (const Ir::ValueId dst = destination(*inst); dst != Ir::ValueId::None) {
+            u8& count = assignments[canonical(dst)];
+            count = std::min<u8>(count + 1, 2);
+        }
+    const std::vector<bool> taken = addressTaken(function, m_canonical);
+    for (u32 i = 0; i < function.values.size(); ++i) {
+        const Ir::Value& value = function.values[i];
+        m_singleAssignment[i] = value.isVariable() && m_canonical[i] == i && assignments[i] == 1 &&
+                                !taken[i] && value.referingTo == ReferingTo::Local;
+    }
+    for (const Ir::Identifier& arg : function.args)
+        for (u32 i = 0; i < function.values.size(); ++i)
+            if (function.values[i].isVariable() && function.values[i].name == arg.value)
+                m_singleAssignment[m_canonical[i]] = false;
+}
+
+Ir::ValueId Folder::constant(const Ir::Value& value)
+{
+    const auto [it, inserted] = m_constants.try_emplace(value, Ir::ValueId::None);
+    if (inserted)
+        it->second = m_function.addValue(value);
+    return it->second;
+}
+
+// The constant the value is known to hold, in its own type, ValueId::None if there is none.
+Ir::ValueId Folder::knownConstant(const Ir::ValueId id)
+{
+    const Ir::Value& variable = value(id);
+    if (variable.isConstant() || m_constantOf[canonical(id)] == Ir::ValueId::None)
+        return Ir::ValueId::None;
+    const Ir::Value& known = value(m_constantOf[canonical(id)]);
+    if (known.type == variable.type)
+        return m_constantOf[canonical(id)];
+    if (!isIntegerType(known.type) || !isIntegerType(variable.type) || !isFoldable(variable.type) ||
+        getTypeSize(known.type) != getTypeSize(variable.type))
+        return Ir::ValueId::None;
+    return constant(integer(variable.type, known.bits));
+}
+
+void Folder::assigned(const Ir::ValueId dst, const Ir::ValueId src)
+{
+    if (m_singleAssignment[canonical(dst)] && value(src).isConstant())
+        m_constantOf[canonical(dst)] = src;
+}
+
+bool Folder::sweep()
+{
+    bool changed = false;
+    for (Ir::Instruction*& inst : m_function.insts) {
+        forEachSource(m_function, *inst, [this, &changed](Ir::ValueId& id) {
+            if (const Ir::ValueId known = knownConstant(id); known != Ir::ValueId::None) {
+                id = known;
+                changed = true;
+            }
+        });
+        changed |= fold(inst);
+        if (inst != nullptr && inst->kind == Kind::Copy) {
+            const auto copy = dynCast<const Ir::CopyInst>(inst);
+            assigned(copy->dst, copy->src);
+        }
+    }
+    std::erase(m_function.insts, nullptr);
+    return changed;
+}
+
+// Replaces the instruction by a copy of its constant result, or removes it or turns it into
+// a jump if it is a conditional jump on a constant.
+bool Folder::fold(Ir::Instruction*& inst)
+{
+    std::optional<Ir::Value> result;
+    switch (inst->kind) {
+        case Kind::Unary: {
+            const auto unary = dynCast<const Ir::UnaryInst>(inst);
+            if (value(unary->src).isConstant())
+                result = foldUnary(unary->operation, value(unary->src), value(unary->dst).type);
+            break;
+        }
+        case Kind::Binary: {
+            const auto binary = dynCast<const Ir::BinaryInst>(inst);
+            if (value(binary->lhs).isConstant() && value(binary->rhs).isConstant())
+                result = foldBinary(binary->operation, value(binary->lhs), value(binary->rhs),
+                                    value(binary->dst).type);
+            break;
+        }
+        case Kind::SignExtend:
+        case Kind::Truncate:
+        case Kind::ZeroExtend:
+        case Kind::DoubleToInt:
+        case Kind::DoubleToUInt:
+        case Kind::IntToDouble:
+        case Kind::UIntToDouble: {
+            Ir::ValueId src = Ir::ValueId::None;
+            forEachSource(m_function, *inst, [&src](const Ir::ValueId id) { src = id; });
+            if (value(src).isConstant())
+                result = foldConversion(inst->kind, value(src), value(destination(*inst)).type);
+            break;
+        }
+        case Kind::JumpIfZero: {
+            const auto jump = dynCast<const Ir::JumpIfZeroInst>(inst);
+            return foldJump(inst, jump->condition, jump->target, true);
+        }
+        case Kind::JumpIfNotZero: {
+            const auto jump = dynCast<const Ir::JumpIfNotZeroInst>(inst);
+            return foldJump(inst, jump->condition, jump->target, false);
+        }
+        default:
+            break;
+    }
+    if (!result)
+        return false;
+    const Ir::ValueId dst = destination(*inst);
+    inst = m_function.make<Ir::CopyInst>(constant(*result), dst, value(dst).type);
+    return true;
+}
+
+bool Folder::foldJump(Ir::Instruction*& inst, const Ir::ValueId condition, const Ir::LabelId target,
+                      const bool jumpIfZero)
+{
+    if (!value(condition).isConstant())
+        return false;
+    if (isZero(value(condition)) == jumpIfZero)
+        inst = m_function.make<Ir::JumpInst>(target);
+    else
+        inst = nullptr;
+    m_jumpsChanged = true;
+    return true;
+}
+
+} // namespace
+
+std::optional<Ir::Value> foldUnary(const Ir::UnaryInst::Operation operation, const Ir::Value& src,
+                                   const Type dstType)
+{
+    using Operation = Ir::UnaryInst::Operation;
+    if (!isFoldable(src.type) || !isFoldable(dstType))
+        return std::nullopt;
+    if (operation == Operation::Not)
+        return dstType == Type::Double ? std::nullopt : std::optional(integer(dstType, isZero(src)));
+    if (src.type == Type::Double || dstType == Type::Double) {
+        if (operation != Operation::Negate || src.type != dstType)
+            return std::nullopt;
+        return Ir::Value(-src.asDouble());
+    }
+    if (operation == Operation::Negate)
+        return integer(dstType, u64{0} - src.bits);
+    return integer(dstType, ~src.bits);
+}
+
+std::optional<Ir::Value> foldBinary(const Ir::BinaryInst::Operation operation,
+                                    const Ir::Value& lhs, const Ir::Value& rhs, const Type dstType)
+{
+    if (!isFoldable(lhs.type) || !isFoldable(rhs.type) || !isFoldable(dstType))
+        return std::nullopt;
+    if (lhs.type == Type::Double && rhs.type == Type::Double)
+        return foldDoubleBinary(operation, lhs.asDouble(), rhs.asDouble(), dstType);
+    if (lhs.type == Type::Double || rhs.type == Type::Double || dstType == Type::Double)
+        return std::nullopt;
+    return foldIntegerBinary(operation, lhs, rhs, dstType);
+}
+
+std::optional<Ir::Value> foldConversion(const Ir::Instruction::Kind kind, const Ir::Value& src, const Type dstType)
+{
+    if (!isFoldable(src.type) || !isFoldable(dstType))
+        return std::nullopt;
+    const bool fromDouble = src.type == Type::Double;
+    const bool toDouble = dstType == Type::Double;
+    switch (kind) {
+        case Kind::SignExtend:
+            if (fromDouble || toDouble)
+                return std::nullopt;
+            return integer(dstType, signExtend(src.bits, bitWidth(src.type)));
+        case Kind::ZeroExtend:
+            if (fromDouble || toDouble)
+                return std::nullopt;
+            return integer(dstType, zeroExtend(src.bits, bitWidth(src.type)));
+        case Kind::Truncate:
+            if (fromDouble || toDouble)
+                return std::nullopt;
+            return integer(dstType, src.bits);
+        case Kind::DoubleToInt:
+        case Kind::DoubleToUInt:
+            if (!fromDouble)
+                return std::nullopt;
+            return doubleToInteger(src.asDouble(), dstType, kind == Kind::DoubleToInt);
+        case Kind::IntToDouble:
+            if (fromDouble || !toDouble)
+                return std::nullopt;
+            return Ir::Value(static_cast<double>(static_cast<i64>(signExtend(src.bits, bitWidth(src.type)))));
+        case Kind::UIntToDouble:
+            if (fromDouble || !toDouble)
+                return std::nullopt;
+            return Ir::Value(static_cast<double>(zeroExtend(src.bits, bitWidth(src.type))));
+        default:
+            return std::nullopt;
+    }
+}
+
+Preserved ConstantFolding::run(Ir::Function& function, FunctionAnalyses&) const
+{
+    Folder folder(function);
+    bool changed = false;
+    while (folder.sweep())
+        changed = true;
+    if (!changed)
+        return Preserved::All;
+    return folder.jumpsChanged() ? Preserved::None : Preserved::Cfg | Preserved::Dominators;
+}
+
+} // Optimization
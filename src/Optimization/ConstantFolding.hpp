@@ -0,0 +1,29 @@
+#pragma once
+
+#include "PassManager.hpp"
+
+#include <optional>
+
+namespace Optimization {
+
+// Evaluates unary, binary and conversion instructions whose operands are all constants, with
+// the wraparound, shift and conversion rules of C for the types involved, and replaces them by
+// a copy of the result. Conditional jumps on a constant become jumps or disappear.
+// A local that is assigned exactly once, a constant, and whose address is never taken holds that
+// constant wherever it is read, so its uses are replaced by the constant as well. That lets the
+// temporaries of an expression such as 1 + 2 * 3 fold in one go.
+// Nothing is folded that would trap or is undefined at run time: division by zero, signed
+// division overflow, shifts by at least the width and out of range conversions from double.
+class ConstantFolding final : public FunctionPass {
+public:
+    [[nodiscard]] std::string_view name() const override { return "constant-folding"; }
+    Preserved run(Ir::Function& function, FunctionAnalyses& analyses) const override;
+};
+
+[[nodiscard]] std::optional<Ir::Value> foldUnary(Ir::UnaryInst::Operation operation, const Ir::Value& src, Type dstType);
+[[nodiscard]] std::optional<Ir::Value> foldBinary(Ir::BinaryInst::Operation operation,
+                                                  const Ir::Value& lhs, const Ir::Value& rhs, Type dstType);
+// Folds SignExtend, Truncate, ZeroExtend and the conversions to and from double.
+[[nodiscard]] std::optional<Ir::Value> foldConversion(Ir::Instruction::Kind kind, const Ir::Value& src, Type dstType);
+
+} // Optimization
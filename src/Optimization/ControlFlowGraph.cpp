@@ -0,0 +1,127 @@
+#include "ControlFlowGraph.hpp"
+#include "DynCast.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace Optimization {
+
+ControlFlowGraph::ControlFlowGraph(const Ir::Function& function)
+    : Analysis(Kind::Cfg)
+{
+    findBlocks(function);
+    connect(function);
+    orderBlocks();
+}
+
+void ControlFlowGraph::findBlocks(const Ir::Function& function)
+{
+    m_blockOfLabel.assign(function.labelCount, noBlock);
+    const auto count = static_cast<u32>(function.insts.size());
+    u32 begin = 0;
+    for (u32 i = 0; i < count; ++i) {
+        const Ir::Instruction& inst = *function.insts[i];
+        if (inst.kind == Ir::Instruction::Kind::Label && begin != i) {
+            m_blocks.push_back({.begin = begin, .end = i});
+            begin = i;
+        }
+        if (inst.kind == Ir::Instruction::Kind::Label)
+            m_blockOfLabel[static_cast<u32>(dynCast<const Ir::LabelInst>(&inst)->target)] =
+                static_cast<u32>(m_blocks.size());
+        if (endsBlock(inst)) {
+            m_blocks.push_back({.begin = begin, .end = i + 1});
+            begin = i + 1;
+        }
+    }
+    if (begin != count || m_blocks.empty())
+        m_blocks.push_back({.begin = begin, .end = count});
+}
+
+void ControlFlowGraph::connect(const Ir::Function& function)
+{
+    const auto link = [this](const u32 from, const u32 to) {
+        if (to == noBlock || std::ranges::contains(m_blocks[from].successors, to))
+            return;
+        m_blocks[from].successors.push_back(to);
+        m_blocks[to].predecessors.push_back(from);
+    };
+    for (u32 i = 0; i < m_blocks.size(); ++i) {
+        const u32 next = i + 1 < m_blocks.size() ? i + 1 : noBlock;
+        if (m_blocks[i].empty()) {
+            link(i, next);
+            continue;
+        }
+        const Ir::Instruction& last = *function.insts[m_blocks[i].end - 1];
+        Ir::LabelId target{};
+        switch (last.kind) {
+            case Ir::Instruction::Kind::Return:
+                break;
+            case Ir::Instruction::Kind::Jump:
+                if (jumpTarget(last, target))
+                    link(i, blockOf(target));
+                break;
+            case Ir::Instruction::Kind::JumpIfZero:
+            case Ir::Instruction::Kind::JumpIfNotZero:
+                link(i, next);
+                if (jumpTarget(last, target))
+                    link(i, blockOf(target));
+                break;
+            default:
+                link(i, next);
+        }
+    }
+}
+
+void ControlFlowGraph::orderBlocks()
+{
+    std::vector<bool> visited(m_blocks.size(), false);
+    std::vector<std::pair<u32, size_t>> stack = {{0, 0}};
+    visited[0] = true;
+    while (!stack.empty()) {
+        auto& [index, nextSuccessor] = stack.back();
+        const std::vector<u32>& successors = m_blocks[index].successors;
+        if (nextSuccessor == successors.size()) {
+            m_reversePostOrder.push_back(index);
+            stack.pop_back();
+            continue;
+        }
+        const u32 successor = successors[nextSuccessor++];
+        if (!visited[successor]) {
+            visited[successor] = true;
+            stack.emplace_back(successor, 0);
+        }
+    }
+    std::ranges::reverse(m_reversePostOrder);
+    m_orderIndex.assign(m_blocks.size(), noBlock);
+    for (u32 i = 0; i < m_reversePostOrder.size(); ++i)
+        m_orderIndex[m_reversePostOrder[i]] = i;
+}
+
+bool jumpTarget(const Ir::Instruction& inst, Ir::LabelId& target)
+{
+    switch (inst.kind) {
+        case Ir::Instruction::Kind::Jump:
+            target = dynCast<const Ir::JumpInst>(&inst)->target;
+            return true;
+        case Ir::Instruction::Kind::JumpIfZero:
+            target = dynCast<const Ir::JumpIfZeroInst>(&inst)->target;
+            return true;
+        case Ir::Instruction::Kind::JumpIfNotZero:
+            target = dynCast<const Ir::JumpIfNotZeroInst>(&inst)->target;
+            return true;
+        case Ir::Instruction::Kind::Label:
+            target = dynCast<const Ir::LabelInst>(&inst)->target;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool endsBlock(const Ir::Instruction& inst)
+{
+    using Kind = Ir::Instruction::Kind;
+    return inst.kind == Kind::Jump || inst.kind == Kind::JumpIfZero ||
+           inst.kind == Kind::JumpIfNotZero || inst.kind == Kind::Return;
+}
+
+} // Optimization
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Analysis.hpp"
+#include "ASTIr.hpp"
+
+#include <vector>
+
+namespace Optimization {
+
+// A maximal run of instructions [begin, end) of Function::insts that is only entered at its
+// first instruction and only left after its last one. A block starts at a label or after a
+// jump or return; a label, if any, is its first instruction.
+struct BasicBlock {
+    u32 begin = 0;
+    u32 end = 0;
+    std::vector<u32> predecessors{};
+    std::vector<u32> successors{};
+
+    [[nodiscard]] bool empty() const { return begin == end; }
+};
+
+// Basic-block view of a function. Block 0 is the entry, blocks are numbered in instruction
+// order. Returning or falling off the end of the function leaves a block without successors.
+class ControlFlowGraph final : public Analysis {
+    std::vector<BasicBlock> m_blocks;
+    std::vector<u32> m_blockOfLabel;
+    std::vector<u32> m_reversePostOrder;
+    std::vector<u32> m_orderIndex;
+public:
+    static constexpr Kind kind = Kind::Cfg;
+    static constexpr u32 noBlock = ~0u;
+
+    explicit ControlFlowGraph(const Ir::Function& function);
+    ControlFlowGraph(const Ir::Function& function, FunctionAnalyses&)
+        : ControlFlowGraph(function) {}
+
+    [[nodiscard]] const std::vector<BasicBlock>& blocks() const { return m_blocks; }
+    [[nodiscard]] const BasicBlock& block(const u32 index) const { return m_blocks[index]; }
+    [[nodiscard]] size_t size() const { return m_blocks.size(); }
+    // The block starting with the label, noBlock if the label is not in the function.
+    [[nodiscard]] u32 blockOf(const Ir::LabelId label) const
+    {
+        const auto index = static_cast<u32>(label);
+        return index < m_blockOfLabel.size() ? m_blockOfLabel[index] : noBlock;
+    }
+    // The blocks reachable from the entry, each before its successors unless on a back edge.
+    [[nodiscard]] const std::vector<u32>& reversePostOrder() const { return m_reversePostOrder; }
+    // Position of the block in the reverse postorder, noBlock if it is unreachable.
+    [[nodiscard]] u32 orderIndex(const u32 index) const { return m_orderIndex[index]; }
+    [[nodiscard]] bool reachable(const u32 index) const { return m_orderIndex[index] != noBlock; }
+
+    static bool classOf(const Analysis* analysis) { return analysis->kind == Kind::Cfg; }
+private:
+    void findBlocks(const Ir::Function& function);
+    void connect(const Ir::Function& function);
+    void orderBlocks();
+};
+
+// The label a jump, conditional jump or label instruction refers to.
+[[nodiscard]] bool jumpTarget(const Ir::Instruction& inst, Ir::LabelId& target);
+[[nodiscard]] bool endsBlock(const Ir::Instruction& inst);
+
+} // Optimization
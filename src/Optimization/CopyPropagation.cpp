@@ -0,0 +1,195 @@
+#include "CopyPropagation.hpp"
+#include "BitSet.hpp"
+#include "ControlFlowGraph.hpp"
+#include "Operands.hpp"
+
+#include <unordered_map>
+
+namespace Optimization {
+
+namespace {
+
+using Kind = Ir::Instruction::Kind;
+
+struct Copy {
+    Ir::ValueId src;
+    Ir::ValueId dst;
+};
+
+class ReachingCopies {
+    static constexpr u32 noCopy = ~0u;
+
+    const Ir::Function& m_function;
+    const ControlFlowGraph& m_cfg;
+    const std::vector<u32> m_canonical;
+    std::vector<Copy> m_copies;
+    // The copy each instruction makes, noCopy if it makes none.
+    std::vector<u32> m_copyAt;
+    // Per canonical value, the copies it is the source or destination of, and those into it.
+    std::vector<std::vector<u32>> m_involving;
+    std::vector<std::vector<u32>> m_into;
+    // The copies that calls and stores end.
+    BitSet m_clobberedByMemory;
+    std::unordered_map<Symbol, u32> m_variableNamed;
+    std::vector<BitSet> m_in;
+public:
+    ReachingCopies(const Ir::Function& function, const ControlFlowGraph& cfg);
+
+    [[nodiscard]] size_t size() const { return m_copies.size(); }
+    // The copies reaching the start of the block.
+    [[nodiscard]] const BitSet& in(const u32 block) const { return m_in[block]; }
+    // Updates copies from before to after the instruction.
+    void transfer(u32 index, BitSet& copies) const;
+    // The value the operand can be read from instead, ValueId::None if there is none.
+    [[nodiscard]] Ir::ValueId replacement(const BitSet& copies, Ir::ValueId id) const;
+    // Whether the instruction copies a value into a variable that already holds it.
+    [[nodiscard]] bool redundant(const BitSet& copies, u32 index) const;
+private:
+    [[nodiscard]] u32 canonical(const Ir::ValueId id) const { return m_canonical[static_cast<u32>(id)]; }
+    void findCopies();
+    void solve();
+    void kill(u32 canonicalValue, BitSet& copies) const;
+};
+
+ReachingCopies::ReachingCopies(const Ir::Function& function, const ControlFlowGraph& cfg)
+    : m_function(function), m_cfg(cfg), m_canonical(canonicalValues(function)),
+      m_copyAt(function.insts.size(), noCopy), m_involving(function.values.size()),
+      m_into(function.values.size())
+{
+    findCopies();
+    solve();
+}
+
+void ReachingCopies::findCopies()
+{
+    std::unordered_map<u64, u32> indexOf;
+    for (u32 i = 0; i < m_function.insts.size(); ++i) {
+        if (m_function.insts[i]->kind != Kind::Copy)
+            continue;
+        const auto copy = dynCast<const Ir::CopyInst>(m_function.insts[i]);
+        if (m_function.value(copy->src).type != m_function.value(copy->dst).type ||
+            canonical(copy->src) == canonical(copy->dst))
+            continue;
+        const u64 key = static_cast<u64>(copy->src) << 32 | static_cast<u32>(copy->dst);
+        const auto [it, inserted] = indexOf.try_emplace(key, static_cast<u32>(m_copies.size()));
+        if (inserted) {
+            m_copies.push_back({copy->src, copy->dst});
+            m_involving[canonical(copy->src)].push_back(it->second);
+            m_involving[canonical(copy->dst)].push_back(it->second);
+            m_into[canonical(copy->dst)].push_back(it->second);
+        }
+        m_copyAt[i] = it->second;
+    }
+    const std::vector<bool> taken = addressTaken(m_function, m_canonical);
+    m_clobberedByMemory = BitSet(m_copies.size());
+    for (u32 i = 0; i < m_function.values.size(); ++i) {
+        const Ir::Value& value = m_function.values[i];
+        if (!value.isVariable() || m_canonical[i] != i)
+            continue;
+        m_variableNamed.emplace(value.name, i);
+        if (taken[i] || value.referingTo != ReferingTo::Local)
+            for (const u32 copy : m_involving[i])
+                m_clobberedByMemory.set(copy);
+    }
+}
+
+// Copies reach a block if they reach the end of all its reachable predecessors, nothing
+// reaches the entry.
+void ReachingCopies::solve()
+{
+    m_in.assign(m_cfg.size(), BitSet(m_copies.size()));
+    std::vector<BitSet> out(m_cfg.size(), BitSet(m_copies.size(), true));
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const u32 b : m_cfg.reversePostOrder()) {
+            BitSet copies(m_copies.size(), b != 0);
+            for (const u32 predecessor : m_cfg.block(b).predecessors)
+                if (m_cfg.reachable(predecessor))
+                    copies.intersect(out[predecessor]);
+            m_in[b] = copies;
+            for (u32 i = m_cfg.block(b).begin; i < m_cfg.block(b).end; ++i)
+                transfer(i, copies);
+            if (copies != out[b]) {
+                out[b] = std::move(copies);
+                changed = true;
+            }
+        }
+    }
+}
+
+void ReachingCopies::kill(const u32 canonicalValue, BitSet& copies) const
+{
+    for (const u32 copy : m_involving[canonicalValue])
+        copies.reset(copy);
+}
+
+void ReachingCopies::transfer(const u32 index, BitSet& copies) const
+{
+    const Ir::Instruction& inst = *m_function.insts[index];
+    if (inst.kind == Kind::FunCall || inst.kind == Kind::Store)
+        copies.subtract(m_clobberedByMemory);
+    if (inst.kind == Kind::CopyToOffset) {
+        const auto it = m_variableNamed.find(dynCast<const Ir::CopyToOffsetInst>(&inst)->iden.value);
+        if (it != m_variableNamed.end())
+            kill(it->second, copies);
+    }
+    if (const Ir::ValueId dst = destination(inst); dst != Ir::ValueId::None)
+        kill(canonical(dst), copies);
+    if (m_copyAt[index] != noCopy)
+        copies.set(m_copyAt[index]);
+}
+
+Ir::ValueId ReachingCopies::replacement(const BitSet& copies, const Ir::ValueId id) const
+{
+    for (const u32 copy : m_into[canonical(id)])
+        if (copies.test(copy) && m_function.value(m_copies[copy].dst).type == m_function.value(id).type)
+            return m_copies[copy].src;
+    return Ir::ValueId::None;
+}
+
+bool ReachingCopies::redundant(const BitSet& copies, const u32 index) const
+{
+    return m_copyAt[index] != noCopy && copies.test(m_copyAt[index]);
+}
+
+} // namespace
+
+Preserved CopyPropagation::run(Ir::Function& function, FunctionAnalyses& analyses) const
+{
+    const ControlFlowGraph& cfg = analyses.get<ControlFlowGraph>();
+    const ReachingCopies reaching(function, cfg);
+    if (reaching.size() == 0)
+        return Preserved::All;
+    bool replaced = false;
+    bool removed = false;
+    for (u32 b = 0; b < cfg.size(); ++b) {
+        if (!cfg.reachable(b))
+            continue;
+        BitSet copies = reaching.in(b);
+        for (u32 i = cfg.block(b).begin; i < cfg.block(b).end; ++i) {
+            // All copies in the set hold at once, so a chain of them is followed to its start.
+            forEachSource(function, *function.insts[i], [&](Ir::ValueId& id) {
+                for (size_t step = 0; step < reaching.size(); ++step) {
+                    const Ir::ValueId src = reaching.replacement(copies, id);
+                    if (src == Ir::ValueId::None)
+                        break;
+                    id = src;
+                    replaced = true;
+                }
+            });
+            const bool isRedundant = reaching.redundant(copies, i);
+            reaching.transfer(i, copies);
+            if (isRedundant) {
+                function.insts[i] = nullptr;
+                removed = true;
+            }
+        }
+    }
+    if (removed) {
+        std::erase(function.insts, nullptr);
+        return Preserved::None;
+    }
+    return replaced ? Preserved::Cfg | Preserved::Dominators : Preserved::All;
+}
+
+} // Optimization
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "PassManager.hpp"
+
+namespace Optimization {
+
+// Replaces reads of a variable by the source of the copy that last assigned it, wherever that
+// copy reaches the read along every path, and removes copies of a value into a variable that
+// already holds it. Which copies reach an instruction is a forward dataflow analysis over the
+// CFG. Any assignment to the source or destination of a copy ends it, and so do calls and
+// stores through pointers for copies involving statics or variables whose address is taken.
+class CopyPropagation final : public FunctionPass {
+public:
+    [[nodiscard]] std::string_view name() const override { return "copy-propagation"; }
+    Preserved run(Ir::Function& function, FunctionAnalyses& analyses) const override;
+};
+
+} // Optimization
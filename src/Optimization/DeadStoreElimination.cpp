@@ -0,0 +1,68 @@
+#include "DeadStoreElimination.hpp"
+#include "ControlFlowGraph.hpp"
+#include "Liveness.hpp"
+#include "Operands.hpp"
+
+namespace Optimization {
+
+namespace {
+
+using Kind = Ir::Instruction::Kind;
+
+bool hasSideEffects(const Ir::Instruction& inst)
+{
+    switch (inst.kind) {
+        case Kind::SignExtend:
+        case Kind::Truncate:
+        case Kind::ZeroExtend:
+        case Kind::DoubleToInt:
+        case Kind::DoubleToUInt:
+        case Kind::IntToDouble:
+        case Kind::UIntToDouble:
+        case Kind::Unary:
+        case Kind::Binary:
+        case Kind::Copy:
+        case Kind::GetAddress:
+        case Kind::Load:
+        case Kind::AddPtr:
+            return false;
+        default:
+            return true;
+    }
+}
+
+// Marks the dead instructions of the reachable blocks with nullptr, returns whether there were any.
+bool markDead(Ir::Function& function, const ControlFlowGraph& cfg, const Liveness& liveness)
+{
+    bool removed = false;
+    for (const u32 b : cfg.reversePostOrder()) {
+        BitSet live = liveness.liveOut(b);
+        for (u32 i = cfg.block(b).end; i-- > cfg.block(b).begin;) {
+            const Ir::Instruction& inst = *function.insts[i];
+            const Ir::ValueId dst = destination(inst);
+            if (dst != Ir::ValueId::None && !hasSideEffects(inst) &&
+                liveness.tracked(dst) && !live.test(liveness.variable(dst))) {
+                function.insts[i] = nullptr;
+                removed = true;
+                continue;
+            }
+            liveness.transfer(inst, live);
+        }
+    }
+    return removed;
+}
+
+} // namespace
+
+Preserved DeadStoreElimination::run(Ir::Function& function, FunctionAnalyses& analyses) const
+{
+    bool removed = false;
+    while (markDead(function, analyses.get<ControlFlowGraph>(), analyses.get<Liveness>())) {
+        std::erase(function.insts, nullptr);
+        analyses.invalidate(Preserved::None);
+        removed = true;
+    }
+    return removed ? Preserved::None : Preserved::All;
+}
+
+} // Optimization
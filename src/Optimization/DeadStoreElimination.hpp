@@ -0,0 +1,18 @@
+#pragma once
+
+#include "PassManager.hpp"
+
+namespace Optimization {
+
+// Removes instructions without side effects whose destination is dead, which after pseudo
+// register replacement would each still be a store to the stack. Liveness only tracks locals
+// whose address is never taken, so writes to statics and to variables a pointer may read stay,
+// and so do calls and stores through pointers. Removing an instruction can leave the ones
+// computing its operands dead, the pass repeats until none are left.
+class DeadStoreElimination final : public FunctionPass {
+public:
+    [[nodiscard]] std::string_view name() const override { return "dead-store-elimination"; }
+    Preserved run(Ir::Function& function, FunctionAnalyses& analyses) const override;
+};
+
+} // Optimization
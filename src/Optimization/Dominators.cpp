@@ -0,0 +1,50 @@
+#include "Dominators.hpp"
+
+namespace Optimization {
+
+Dominators::Dominators(const ControlFlowGraph& cfg)
+    : Analysis(Kind::Dominators), m_idom(cfg.size(), ControlFlowGraph::noBlock)
+{
+    for (u32 block = 0; block < cfg.size(); ++block)
+        m_order.push_back(cfg.orderIndex(block));
+    m_idom[0] = 0;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const u32 block : cfg.reversePostOrder()) {
+            if (block == 0)
+                continue;
+            u32 idom = ControlFlowGraph::noBlock;
+            for (const u32 predecessor : cfg.block(block).predecessors) {
+                if (m_idom[predecessor] == ControlFlowGraph::noBlock)
+                    continue;
+                idom = idom == ControlFlowGraph::noBlock ? predecessor : intersect(predecessor, idom);
+            }
+            if (m_idom[block] != idom) {
+                m_idom[block] = idom;
+                changed = true;
+            }
+        }
+    }
+}
+
+bool Dominators::dominates(const u32 dominator, u32 block) const
+{
+    if (m_idom[block] == ControlFlowGraph::noBlock || m_idom[dominator] == ControlFlowGraph::noBlock)
+        return false;
+    while (block != dominator && block != 0)
+        block = m_idom[block];
+    return block == dominator;
+}
+
+u32 Dominators::intersect(u32 lhs, u32 rhs) const
+{
+    while (lhs != rhs) {
+        while (m_order[rhs] < m_order[lhs])
+            lhs = m_idom[lhs];
+        while (m_order[lhs] < m_order[rhs])
+            rhs = m_idom[rhs];
+    }
+    return lhs;
+}
+
+} // Optimization
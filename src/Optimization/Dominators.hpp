@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Analysis.hpp"
+#include "ControlFlowGraph.hpp"
+
+#include <vector>
+
+namespace Optimization {
+
+// Immediate dominators of the reachable blocks, computed with the iterative algorithm of
+// Cooper, Harvey and Kennedy over the reverse postorder of the CFG.
+class Dominators final : public Analysis {
+    std::vector<u32> m_idom;
+    std::vector<u32> m_order;
+public:
+    static constexpr Kind kind = Kind::Dominators;
+
+    explicit Dominators(const ControlFlowGraph& cfg);
+    Dominators(const Ir::Function&, FunctionAnalyses& analyses)
+        : Dominators(analyses.get<ControlFlowGraph>()) {}
+
+    // The entry is its own immediate dominator, unreachable blocks have none.
+    [[nodiscard]] u32 immediateDominator(const u32 block) const { return m_idom[block]; }
+    [[nodiscard]] bool dominates(u32 dominator, u32 block) const;
+
+    static bool classOf(const Analysis* analysis) { return analysis->kind == Kind::Dominators; }
+private:
+    [[nodiscard]] u32 intersect(u32 lhs, u32 rhs) const;
+};
+
+} // Optimization
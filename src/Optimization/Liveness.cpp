@@ -0,0 +1,54 @@
+#include "Liveness.hpp"
+#include "Operands.hpp"
+
+#include <ranges>
+
+namespace Optimization {
+
+Liveness::Liveness(const Ir::Function& function, const ControlFlowGraph& cfg)
+    : Analysis(Kind::Liveness), m_function(function), m_variableOf(function.values.size(), untracked)
+{
+    const std::vector<u32> canonical = canonicalValues(function);
+    const std::vector<bool> taken = addressTaken(function, canonical);
+    for (u32 i = 0; i < function.values.size(); ++i) {
+        const Ir::Value& value = function.values[i];
+        if (!value.isVariable() || value.referingTo != ReferingTo::Local || taken[canonical[i]])
+            continue;
+        if (canonical[i] == i) {
+            m_variableOf[i] = static_cast<u32>(m_values.size());
+            m_values.push_back(Ir::ValueId(i));
+        }
+        else {
+            m_variableOf[i] = m_variableOf[canonical[i]];
+        }
+    }
+    m_liveIn.assign(cfg.size(), BitSet(m_values.size()));
+    m_liveOut.assign(cfg.size(), BitSet(m_values.size()));
+    // Nothing tracked is live once the function returns.
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const u32 b : std::views::reverse(cfg.reversePostOrder())) {
+            for (const u32 successor : cfg.block(b).successors)
+                m_liveOut[b].unite(m_liveIn[successor]);
+            BitSet live = m_liveOut[b];
+            for (u32 i = cfg.block(b).end; i-- > cfg.block(b).begin;)
+                transfer(*function.insts[i], live);
+            if (live != m_liveIn[b]) {
+                m_liveIn[b] = std::move(live);
+                changed = true;
+            }
+        }
+    }
+}
+
+void Liveness::transfer(const Ir::Instruction& inst, BitSet& live) const
+{
+    if (const Ir::ValueId dst = destination(inst); dst != Ir::ValueId::None && tracked(dst))
+        live.reset(variable(dst));
+    forEachSource(m_function, inst, [&](const Ir::ValueId id) {
+        if (tracked(id))
+            live.set(variable(id));
+    });
+}
+
+} // Optimization
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Analysis.hpp"
+#include "BitSet.hpp"
+#include "ControlFlowGraph.hpp"
+
+#include <vector>
+
+namespace Optimization {
+
+// Which variables are live at the start and end of every reachable block, a backward dataflow
+// analysis over the CFG. Only locals whose address is never taken are tracked, they are the
+// ones only named operands read, everything else can be read through memory at any time.
+// Variables get dense indices so register allocation can use the sets directly.
+class Liveness final : public Analysis {
+    static constexpr u32 untracked = ~0u;
+
+    const Ir::Function& m_function;
+    std::vector<u32> m_variableOf;
+    std::vector<Ir::ValueId> m_values;
+    std::vector<BitSet> m_liveIn;
+    std::vector<BitSet> m_liveOut;
+public:
+    static constexpr Kind kind = Kind::Liveness;
+
+    Liveness(const Ir::Function& function, const ControlFlowGraph& cfg);
+    Liveness(const Ir::Function& function, FunctionAnalyses& analyses)
+        : Liveness(function, analyses.get<ControlFlowGraph>()) {}
+
+    [[nodiscard]] size_t variableCount() const { return m_values.size(); }
+    [[nodiscard]] bool tracked(const Ir::ValueId id) const { return variable(id) != untracked; }
+    // The index of the variable the value names, untracked if it is not tracked.
+    [[nodiscard]] u32 variable(const Ir::ValueId id) const { return m_variableOf[static_cast<u32>(id)]; }
+    // The first value of the variable with the index.
+    [[nodiscard]] Ir::ValueId value(const u32 variable) const { return m_values[variable]; }
+
+    // Unreachable blocks have nothing live.
+    [[nodiscard]] const BitSet& liveIn(const u32 block) const { return m_liveIn[block]; }
+    [[nodiscard]] const BitSet& liveOut(const u32 block) const { return m_liveOut[block]; }
+    // Updates live from after the instruction to before it.
+    void transfer(const Ir::Instruction& inst, BitSet& live) const;
+
+    static bool classOf(const Analysis* analysis) { return analysis->kind == Kind::Liveness; }
+};
+
+} // Optimization
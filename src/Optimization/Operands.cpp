@@ -0,0 +1,58 @@
+#include "Operands.hpp"
+
+#include <unordered_map>
+
+namespace Optimization {
+
+Ir::ValueId destination(const Ir::Instruction& inst)
+{
+    using Kind = Ir::Instruction::Kind;
+    switch (inst.kind) {
+        case Kind::SignExtend: return dynCast<const Ir::SignExtendInst>(&inst)->dst;
+        case Kind::Truncate: return dynCast<const Ir::TruncateInst>(&inst)->dst;
+        case Kind::ZeroExtend: return dynCast<const Ir::ZeroExtendInst>(&inst)->dst;
+        case Kind::DoubleToInt: return dynCast<const Ir::DoubleToIntInst>(&inst)->dst;
+        case Kind::DoubleToUInt: return dynCast<const Ir::DoubleToUIntInst>(&inst)->dst;
+        case Kind::IntToDouble: return dynCast<const Ir::IntToDoubleInst>(&inst)->dst;
+        case Kind::UIntToDouble: return dynCast<const Ir::UIntToDoubleInst>(&inst)->dst;
+        case Kind::Unary: return dynCast<const Ir::UnaryInst>(&inst)->dst;
+        case Kind::Binary: return dynCast<const Ir::BinaryInst>(&inst)->dst;
+        case Kind::Copy: return dynCast<const Ir::CopyInst>(&inst)->dst;
+        case Kind::GetAddress: return dynCast<const Ir::GetAddressInst>(&inst)->dst;
+        case Kind::Load: return dynCast<const Ir::LoadInst>(&inst)->dst;
+        case Kind::AddPtr: return dynCast<const Ir::AddPtrInst>(&inst)->dst;
+        case Kind::FunCall: return dynCast<const Ir::FunCallInst>(&inst)->destination;
+        case Kind::Return:
+        case Kind::Store:
+        case Kind::CopyToOffset:
+        case Kind::Jump:
+        case Kind::JumpIfZero:
+        case Kind::JumpIfNotZero:
+        case Kind::Label:
+        case Kind::Allocate:
+            return Ir::ValueId::None;
+    }
+    std::abort();
+}
+
+std::vector<u32> canonicalValues(const Ir::Function& function)
+{
+    std::vector<u32> canonical(function.values.size());
+    std::unordered_map<Symbol, u32> byName;
+    for (u32 i = 0; i < function.values.size(); ++i) {
+        const Ir::Value& value = function.values[i];
+        canonical[i] = value.isVariable() ? byName.try_emplace(value.name, i).first->second : i;
+    }
+    return canonical;
+}
+
+std::vector<bool> addressTaken(const Ir::Function& function, const std::vector<u32>& canonical)
+{
+    std::vector<bool> taken(function.values.size(), false);
+    for (const Ir::Instruction* inst : function.insts)
+        if (inst->kind == Ir::Instruction::Kind::GetAddress)
+            taken[canonical[static_cast<u32>(dynCast<const Ir::GetAddressInst>(inst)->src)]] = true;
+    return taken;
+}
+
+} // Optimization
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "ASTIr.hpp"
+#include "DynCast.hpp"
+
+#include <type_traits>
+#include <vector>
+
+namespace Optimization {
+
+namespace Detail {
+
+template<typename T, typename From>
+auto* as(From& inst)
+{
+    return dynCast<std::conditional_t<std::is_const_v<From>, const T, T>>(&inst);
+}
+
+} // Detail
+
+// Calls visit with every operand whose contents the instruction reads, call arguments included.
+// The source of GetAddress is not one of them, only its address is used. With a non-const
+// instruction the operands are passed by reference and can be replaced.
+template<typename FunctionT, typename InstructionT, typename Visit>
+void forEachSource(FunctionT& function, InstructionT& inst, Visit&& visit)
+{
+    using Kind = Ir::Instruction::Kind;
+    using Detail::as;
+    switch (inst.kind) {
+        case Kind::Return:
+            if (auto& value = as<Ir::ReturnInst>(inst)->returnValue; value != Ir::ValueId::None)
+                visit(value);
+            return;
+        case Kind::SignExtend: visit(as<Ir::SignExtendInst>(inst)->src); return;
+        case Kind::Truncate: visit(as<Ir::TruncateInst>(inst)->src); return;
+        case Kind::ZeroExtend: visit(as<Ir::ZeroExtendInst>(inst)->src); return;
+        case Kind::DoubleToInt: visit(as<Ir::DoubleToIntInst>(inst)->src); return;
+        case Kind::DoubleToUInt: visit(as<Ir::DoubleToUIntInst>(inst)->src); return;
+        case Kind::IntToDouble: visit(as<Ir::IntToDoubleInst>(inst)->src); return;
+        case Kind::UIntToDouble: visit(as<Ir::UIntToDoubleInst>(inst)->src); return;
+        case Kind::Unary: visit(as<Ir::UnaryInst>(inst)->src); return;
+        case Kind::Binary: {
+            auto binary = as<Ir::BinaryInst>(inst);
+            visit(binary->lhs);
+            visit(binary->rhs);
+            return;
+        }
+        case Kind::Copy: visit(as<Ir::CopyInst>(inst)->src); return;
+        case Kind::Load: visit(as<Ir::LoadInst>(inst)->ptr); return;
+        case Kind::Store: {
+            auto store = as<Ir::StoreInst>(inst);
+            visit(store->src);
+            visit(store->ptr);
+            return;
+        }
+        case Kind::AddPtr: {
+            auto addPtr = as<Ir::AddPtrInst>(inst);
+            visit(addPtr->ptr);
+            visit(addPtr->index);
+            return;
+        }
+        case Kind::CopyToOffset: visit(as<Ir::CopyToOffsetInst>(inst)->src); return;
+        case Kind::JumpIfZero: visit(as<Ir::JumpIfZeroInst>(inst)->condition); return;
+        case Kind::JumpIfNotZero: visit(as<Ir::JumpIfNotZeroInst>(inst)->condition); return;
+        case Kind::FunCall:
+            for (auto& arg : function.arguments(*as<Ir::FunCallInst>(inst)))
+                visit(arg);
+            return;
+        case Kind::GetAddress:
+        case Kind::Jump:
+        case Kind::Label:
+        case Kind::Allocate:
+            return;
+    }
+    std::abort();
+}
+
+// The value the instruction assigns, ValueId::None if it assigns none. Store writes through a
+// pointer and CopyToOffset into an array, neither names a value.
+[[nodiscard]] Ir::ValueId destination(const Ir::Instruction& inst);
+
+// Values sharing a name are the same variable. Maps every value to the first value of its
+// variable, constants map to themselves.
+[[nodiscard]] std::vector<u32> canonicalValues(const Ir::Function& function);
+// Per canonical value, whether the function takes its address.
+[[nodiscard]] std::vector<bool> addressTaken(const Ir::Function& function, const std::vector<u32>& canonical);
+
+} // Optimization
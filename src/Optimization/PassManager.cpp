@@ -0,0 +1,147 @@
+#include "PassManager.hpp"
+#include "ConstantFolding.hpp"
+#include "CopyPropagation.hpp"
+#include "DeadStoreElimination.hpp"
+#include "DynCast.hpp"
+#include "SimplifyCfg.hpp"
+#include "TimeTrace.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace Optimization {
+
+namespace {
+
+struct PassInfo {
+    std::string_view name;
+    // The lowest level that runs the pass.
+    OptLevel level;
+    std::unique_ptr<FunctionPass> (*createFunctionPass)();
+    std::unique_ptr<ModulePass> (*createModulePass)();
+};
+
+template<typename T>
+std::unique_ptr<FunctionPass> makeFunctionPass()
+{
+    return std::make_unique<T>();
+}
+
+// Every pass in the order they run in.
+constexpr std::array<PassInfo, 4> registry = {{
+    {"constant-folding", OptLevel::O1, &makeFunctionPass<ConstantFolding>, nullptr},
+    {"copy-propagation", OptLevel::O1, &makeFunctionPass<CopyPropagation>, nullptr},
+    {"dead-store-elimination", OptLevel::O1, &makeFunctionPass<DeadStoreElimination>, nullptr},
+    {"simplify-cfg", OptLevel::O1, &makeFunctionPass<SimplifyCfg>, nullptr},
+}};
+
+std::string_view levelFlag(const OptLevel level)
+{
+    switch (level) {
+        case OptLevel::O0: return "-O0";
+        case OptLevel::O1: return "-O1";
+        case OptLevel::O2: return "-O2";
+    }
+    std::abort();
+}
+
+} // namespace
+
+std::string Options::flags() const
+{
+    if (level == OptLevel::O0 && !explicitPasses)
+        return {};
+    std::string result(levelFlag(level));
+    if (explicitPasses) {
+        result += " --passes=";
+        for (size_t i = 0; i < passes.size(); ++i)
+            result += (i == 0 ? "" : ",") + passes[i];
+    }
+    return result;
+}
+
+PassManager PassManager::create(const Options& options)
+{
+    PassManager passManager;
+    for (const PassInfo& info : registry) {
+        const bool selected = options.explicitPasses
+            ? std::ranges::contains(options.passes, info.name)
+            : info.level <= options.level && options.level != OptLevel::O0;
+        if (!selected)
+            continue;
+        if (info.createFunctionPass != nullptr)
+            passManager.add(info.createFunctionPass());
+        else
+            passManager.add(info.createModulePass());
+    }
+    passManager.repeatUntilFixedPoint(options.level == OptLevel::O2);
+    return passManager;
+}
+
+void PassManager::run(Ir::Program& program, const CodeGen::WorkStealingPool& pool) const
+{
+    if (empty())
+        return;
+    const TimeTrace::Scope scope("optimize");
+    runFunctionPasses(program, pool);
+    for (const std::unique_ptr<ModulePass>& pass : m_modulePasses)
+        pass->run(program);
+}
+
+void PassManager::runFunctionPasses(Ir::Program& program, const CodeGen::WorkStealingPool& pool) const
+{
+    if (m_functionPasses.empty())
+        return;
+    pool.run(program.topLevels.size(), [this, &program](const size_t i) {
+        Ir::TopLevel* topLevel = program.topLevels[i].get();
+        if (topLevel->kind == Ir::TopLevel::Kind::Function)
+            run(*dynCast<Ir::Function>(topLevel));
+    });
+}
+
+void PassManager::run(Ir::Function& function) const
+{
+    if (m_functionPasses.empty())
+        return;
+    const TimeTrace::FunctionScope scope("optimize", function.name.value.text());
+    FunctionAnalyses analyses(function);
+    for (i32 iteration = 0; iteration < maxIterations; ++iteration) {
+        bool changed = false;
+        for (const std::unique_ptr<FunctionPass>& pass : m_functionPasses) {
+            const Preserved preserved = pass->run(function, analyses);
+            analyses.invalidate(preserved);
+            changed |= preserved != Preserved::All;
+        }
+        if (!changed || !m_untilFixedPoint)
+            return;
+    }
+}
+
+std::vector<std::string_view> passNames()
+{
+    std::vector<std::string_view> names;
+    for (const PassInfo& info : registry)
+        names.push_back(info.name);
+    return names;
+}
+
+bool parsePasses(const std::string_view list, Options& options, std::vector<std::string>& errors)
+{
+    options.explicitPasses = true;
+    options.passes.clear();
+    size_t begin = 0;
+    while (begin <= list.size()) {
+        const size_t end = std::min(list.find(',', begin), list.size());
+        const std::string_view name = list.substr(begin, end - begin);
+        if (name.empty())
+            errors.emplace_back("Empty pass name in --passes");
+        else if (!std::ranges::contains(passNames(), name))
+            errors.push_back("Unknown pass " + std::string(name));
+        else
+            options.passes.emplace_back(name);
+        begin = end + 1;
+    }
+    return errors.empty();
+}
+
+} // Optimization
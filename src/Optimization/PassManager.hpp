@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Analysis.hpp"
+#include "ASTIr.hpp"
+#include "WorkStealingPool.hpp"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Optimization {
+
+enum class OptLevel : u8 {
+    O0, O1, O2
+};
+
+// What -O and --passes asked for. An explicit pass list replaces the passes of the level.
+struct Options {
+    OptLevel level = OptLevel::O0;
+    std::vector<std::string> passes;
+    bool explicitPasses = false;
+
+    // Spelling of these options as part of cache keys, empty when nothing runs.
+    [[nodiscard]] std::string flags() const;
+};
+
+class FunctionPass {
+public:
+    virtual ~FunctionPass() = default;
+    [[nodiscard]] virtual std::string_view name() const = 0;
+    // Returns what is still valid afterwards, Preserved::All if the function did not change.
+    virtual Preserved run(Ir::Function& function, FunctionAnalyses& analyses) const = 0;
+};
+
+class ModulePass {
+public:
+    virtual ~ModulePass() = default;
+    [[nodiscard]] virtual std::string_view name() const = 0;
+    // Returns whether the program changed.
+    virtual bool run(Ir::Program& program) const = 0;
+};
+
+// Runs the function passes over every function, in parallel across functions, and then the
+// module passes over the whole program. Passes always run in the order they were added in.
+// At -O2 the function passes are repeated until none of them changes the function any more.
+class PassManager {
+    std::vector<std::unique_ptr<FunctionPass>> m_functionPasses;
+    std::vector<std::unique_ptr<ModulePass>> m_modulePasses;
+    bool m_untilFixedPoint = false;
+public:
+    static constexpr i32 maxIterations = 8;
+
+    PassManager() = default;
+    // The passes for options. The names in options.passes are known, parsePasses checks them.
+    static PassManager create(const Options& options);
+
+    void add(std::unique_ptr<FunctionPass> pass) { m_functionPasses.push_back(std::move(pass)); }
+    void add(std::unique_ptr<ModulePass> pass) { m_modulePasses.push_back(std::move(pass)); }
+    void repeatUntilFixedPoint(const bool repeat) { m_untilFixedPoint = repeat; }
+
+    [[nodiscard]] bool empty() const { return m_functionPasses.empty() && m_modulePasses.empty(); }
+    void run(Ir::Program& program, const CodeGen::WorkStealingPool& pool) const;
+    // Only the function passes, for callers that hold just some functions of a program.
+    void runFunctionPasses(Ir::Program& program, const CodeGen::WorkStealingPool& pool) const;
+    void run(Ir::Function& function) const;
+};
+
+// Names accepted by --passes, in the order a pass manager runs them.
+[[nodiscard]] std::vector<std::string_view> passNames();
+// Parses the value of --passes=, a comma separated list.
+[[nodiscard]] bool parsePasses(std::string_view list, Options& options, std::vector<std::string>& errors);
+
+} // Optimization
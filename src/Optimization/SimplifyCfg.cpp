@@ -0,0 +1,227 @@
+#include "SimplifyCfg.hpp"
+#include "ControlFlowGraph.hpp"
+#include "DynCast.hpp"
+
+#include <algorithm>
+
+namespace Optimization {
+
+namespace {
+
+using Kind = Ir::Instruction::Kind;
+
+bool isJump(const Ir::Instruction& inst)
+{
+    return inst.kind == Kind::Jump || inst.kind == Kind::JumpIfZero || inst.kind == Kind::JumpIfNotZero;
+}
+
+void retarget(Ir::Instruction& inst, const Ir::LabelId target)
+{
+    switch (inst.kind) {
+        case Kind::Jump:
+            dynCast<Ir::JumpInst>(&inst)->target = target;
+            return;
+        case Kind::JumpIfZero:
+            dynCast<Ir::JumpIfZeroInst>(&inst)->target = target;
+            return;
+        case Kind::JumpIfNotZero:
+            dynCast<Ir::JumpIfNotZeroInst>(&inst)->target = target;
+            return;
+        default:
+            std::abort();
+    }
+}
+
+// Allocate only declares the stack slot of an array, so it survives the removal of its block.
+bool removeUnreachable(Ir::Function& function, const ControlFlowGraph& cfg)
+{
+    if (cfg.reversePostOrder().size() == cfg.size())
+        return false;
+    std::vector<Ir::Instruction*> insts;
+    for (u32 b = 0; b < cfg.size(); ++b) {
+        if (cfg.reachable(b))
+            continue;
+        const BasicBlock& block = cfg.block(b);
+        for (u32 i = block.begin; i < block.end; ++i)
+            if (function.insts[i]->kind == Kind::Allocate)
+                insts.push_back(function.insts[i]);
+    }
+    for (u32 b = 0; b < cfg.size(); ++b) {
+        const BasicBlock& block = cfg.block(b);
+        if (cfg.reachable(b))
+            insts.insert(insts.end(), function.insts.begin() + block.begin, function.insts.begin() + block.end);
+    }
+    function.insts = std::move(insts);
+    return true;
+}
+
+// Follows the label through blocks that are only labels or labels and a jump. A cycle of such
+// blocks, an infinite loop, keeps the label.
+Ir::LabelId resolve(const Ir::Function& function, const ControlFlowGraph& cfg, const Ir::LabelId label)
+{
+    std::vector<u32> visited;
+    Ir::LabelId current = label;
+    while (true) {
+        const u32 b = cfg.blockOf(current);
+        if (b == ControlFlowGraph::noBlock || std::ranges::contains(visited, b))
+            return b == ControlFlowGraph::noBlock ? current : label;
+        visited.push_back(b);
+        const BasicBlock& block = cfg.block(b);
+        u32 i = block.begin;
+        while (i < block.end && function.insts[i]->kind == Kind::Label)
+            ++i;
+        if (i == block.end) {
+            if (b + 1 == cfg.size())
+                return current;
+            const Ir::Instruction& next = *function.insts[cfg.block(b + 1).begin];
+            if (next.kind != Kind::Label)
+                return current;
+            current = dynCast<const Ir::LabelInst>(&next)->target;
+            continue;
+        }
+        if (i + 1 != block.end || function.insts[i]->kind != Kind::Jump)
+            return current;
+        current = dynCast<const Ir::JumpInst>(function.insts[i])->target;
+    }
+}
+
+bool threadJumps(Ir::Function& function, const ControlFlowGraph& cfg)
+{
+    bool changed = false;
+    for (const BasicBlock& block : cfg.blocks()) {
+        if (block.empty())
+            continue;
+        Ir::Instruction& last = *function.insts[block.end - 1];
+        Ir::LabelId target{};
+        if (!isJump(last) || !jumpTarget(last, target))
+            continue;
+        const Ir::LabelId resolved = resolve(function, cfg, target);
+        if (resolved != target) {
+            retarget(last, resolved);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// A block ending in a jump to a block that has no other predecessor is followed by it directly.
+// Only blocks that end in a jump or return are moved, so nothing else depends on where they are.
+bool mergeBlocks(Ir::Function& function, const ControlFlowGraph& cfg)
+{
+    const auto size = static_cast<u32>(cfg.size());
+    std::vector<u32> mergeInto(size, ControlFlowGraph::noBlock);
+    std::vector<bool> merged(size, false);
+    bool changed = false;
+    for (u32 a = 0; a < size; ++a) {
+        const BasicBlock& block = cfg.block(a);
+        if (block.empty() || !cfg.reachable(a) || function.insts[block.end - 1]->kind != Kind::Jump)
+            continue;
+        const u32 b = cfg.blockOf(dynCast<const Ir::JumpInst>(function.insts[block.end - 1])->target);
+        if (b == ControlFlowGraph::noBlock || b == a || b == 0 || cfg.block(b).predecessors.size() != 1)
+            continue;
+        const Ir::Instruction& bLast = *function.insts[cfg.block(b).end - 1];
+        if (bLast.kind != Kind::Jump && bLast.kind != Kind::Return)
+            continue;
+        mergeInto[a] = b;
+        merged[b] = true;
+        changed = true;
+    }
+    if (!changed)
+        return false;
+    std::vector<Ir::Instruction*> insts;
+    insts.reserve(function.insts.size());
+    for (u32 start = 0; start < size; ++start) {
+        if (merged[start])
+            continue;
+        for (u32 b = start; b != ControlFlowGraph::noBlock; b = mergeInto[b]) {
+            const BasicBlock& block = cfg.block(b);
+            const u32 end = mergeInto[b] == ControlFlowGraph::noBlock ? block.end : block.end - 1;
+            insts.insert(insts.end(), function.insts.begin() + block.begin, function.insts.begin() + end);
+        }
+    }
+    function.insts = std::move(insts);
+    return true;
+}
+
+bool labelFollows(const Ir::Function& function, size_t i, const Ir::LabelId target)
+{
+    for (; i < function.insts.size() && function.insts[i]->kind == Kind::Label; ++i)
+        if (dynCast<const Ir::LabelInst>(function.insts[i])->target == target)
+            return true;
+    return false;
+}
+
+// Drops jumps to the labels right after them and turns
+//     JumpIfZero c, L; Jump M; Label L
+// into
+//     JumpIfNotZero c, M; Label L
+bool removeRedundantJumps(Ir::Function& function)
+{
+    std::vector<Ir::Instruction*> insts;
+    insts.reserve(function.insts.size());
+    bool changed = false;
+    for (size_t i = 0; i < function.insts.size(); ++i) {
+        Ir::Instruction* inst = function.insts[i];
+        Ir::LabelId target{};
+        if (!isJump(*inst) || !jumpTarget(*inst, target)) {
+            insts.push_back(inst);
+            continue;
+        }
+        if (labelFollows(function, i + 1, target)) {
+            changed = true;
+            continue;
+        }
+        const bool conditional = inst->kind != Kind::Jump;
+        if (conditional && i + 1 < function.insts.size() && function.insts[i + 1]->kind == Kind::Jump &&
+            labelFollows(function, i + 2, target)) {
+            const Ir::LabelId other = dynCast<const Ir::JumpInst>(function.insts[i + 1])->target;
+            if (inst->kind == Kind::JumpIfZero) {
+                const auto jump = dynCast<const Ir::JumpIfZeroInst>(inst);
+                insts.push_back(function.make<Ir::JumpIfNotZeroInst>(jump->condition, other, jump->type));
+            }
+            else {
+                const auto jump = dynCast<const Ir::JumpIfNotZeroInst>(inst);
+                insts.push_back(function.make<Ir::JumpIfZeroInst>(jump->condition, other, jump->type));
+            }
+            ++i;
+            changed = true;
+            continue;
+        }
+        insts.push_back(inst);
+    }
+    if (changed)
+        function.insts = std::move(insts);
+    return changed;
+}
+
+bool removeUnusedLabels(Ir::Function& function)
+{
+    std::vector<bool> used(function.labelCount, false);
+    for (const Ir::Instruction* inst : function.insts) {
+        Ir::LabelId target{};
+        if (isJump(*inst) && jumpTarget(*inst, target))
+            used[static_cast<u32>(target)] = true;
+    }
+    const size_t removed = std::erase_if(function.insts, [&used](const Ir::Instruction* inst) {
+        return inst->kind == Kind::Label && !used[static_cast<u32>(dynCast<const Ir::LabelInst>(inst)->target)];
+    });
+    return removed != 0;
+}
+
+} // namespace
+
+Preserved SimplifyCfg::run(Ir::Function& function, FunctionAnalyses& analyses) const
+{
+    bool changed = false;
+    while (true) {
+        const ControlFlowGraph& cfg = analyses.get<ControlFlowGraph>();
+        if (!removeUnreachable(function, cfg) && !threadJumps(function, cfg) && !mergeBlocks(function, cfg) &&
+            !removeRedundantJumps(function) && !removeUnusedLabels(function))
+            break;
+        analyses.invalidate(Preserved::None);
+        changed = true;
+    }
+    return changed ? Preserved::None : Preserved::All;
+}
+
+} // Optimization
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "PassManager.hpp"
+
+namespace Optimization {
+
+// Cleans up the control flow GenerateIr leaves behind: removes unreachable blocks, threads
+// jumps through blocks that only jump on, merges a block into the single block jumping to it,
+// drops jumps to the next instruction and deletes labels nothing jumps to. Repeats until none
+// of these changes the function any more.
+class SimplifyCfg final : public FunctionPass {
+public:
+    [[nodiscard]] std::string_view name() const override { return "simplify-cfg"; }
+    Preserved run(Ir::Function& function, FunctionAnalyses& analyses) const override;
+};
+
+} // Optimization
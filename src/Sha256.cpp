@@ -0,0 +1,93 @@
+#include "Sha256.hpp"
+
+#include <bit>
+#include <cstring>
+
+namespace {
+
+constexpr std::array<u32, 64> roundConstants{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+} // namespace
+
+void Sha256::update(const std::string_view data)
+{
+    m_length += data.size();
+    const auto* bytes = reinterpret_cast<const u8*>(data.data());
+    size_t remaining = data.size();
+    if (m_blockSize != 0) {
+        const size_t take = std::min(remaining, m_block.size() - m_blockSize);
+        std::memcpy(m_block.data() + m_blockSize, bytes, take);
+        m_blockSize += take;
+        bytes += take;
+        remaining -= take;
+        if (m_blockSize < m_block.size())
+            return;
+        compress(m_block.data());
+        m_blockSize = 0;
+    }
+    for (; m_block.size() <= remaining; bytes += m_block.size(), remaining -= m_block.size())
+        compress(bytes);
+    std::memcpy(m_block.data(), bytes, remaining);
+    m_blockSize = remaining;
+}
+
+std::array<u8, 32> Sha256::digest()
+{
+    const u64 bitLength = m_length * 8;
+    update(std::string_view("\x80", 1));
+    while (m_blockSize != 56)
+        update(std::string_view("\0", 1));
+    std::array<char, 8> lengthBytes{};
+    for (size_t i = 0; i < lengthBytes.size(); ++i)
+        lengthBytes[i] = static_cast<char>(bitLength >> (56 - 8 * i));
+    update(std::string_view(lengthBytes.data(), lengthBytes.size()));
+    std::array<u8, 32> result{};
+    for (size_t i = 0; i < m_state.size(); ++i)
+        for (size_t j = 0; j < 4; ++j)
+            result[4 * i + j] = static_cast<u8>(m_state[i] >> (24 - 8 * j));
+    return result;
+}
+
+std::string Sha256::hexDigest()
+{
+    constexpr std::string_view hexDigits = "0123456789abcdef";
+    std::string hex;
+    for (const u8 byte : digest()) {
+        hex += hexDigits[byte >> 4];
+        hex += hexDigits[byte & 0xF];
+    }
+    return hex;
+}
+
+void Sha256::compress(const u8* block)
+{
+    std::array<u32, 64> w{};
+    for (size_t i = 0; i < 16; ++i)
+        w[i] = static_cast<u32>(block[4 * i]) << 24 | static_cast<u32>(block[4 * i + 1]) << 16 |
+               static_cast<u32>(block[4 * i + 2]) << 8 | block[4 * i + 3];
+    for (size_t i = 16; i < w.size(); ++i) {
+        const u32 s0 = std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const u32 s1 = std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    std::array<u32, 8> v = m_state;
+    for (size_t i = 0; i < w.size(); ++i) {
+        const u32 s1 = std::rotr(v[4], 6) ^ std::rotr(v[4], 11) ^ std::rotr(v[4], 25);
+        const u32 choose = (v[4] & v[5]) ^ (~v[4] & v[6]);
+        const u32 t1 = v[7] + s1 + choose + roundConstants[i] + w[i];
+        const u32 s0 = std::rotr(v[0], 2) ^ std::rotr(v[0], 13) ^ std::rotr(v[0], 22);
+        const u32 majority = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+        v = {t1 + s0 + majority, v[0], v[1], v[2], v[3] + t1, v[4], v[5], v[6]};
+    }
+    for (size_t i = 0; i < m_state.size(); ++i)
+        m_state[i] += v[i];
+}
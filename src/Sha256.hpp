@@ -0,0 +1,22 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <array>
+#include <string>
+#include <string_view>
+
+// Incremental SHA-256, used to address cached compiler output by content.
+class Sha256 {
+    std::array<u32, 8> m_state{
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    std::array<u8, 64> m_block{};
+    size_t m_blockSize = 0;
+    u64 m_length = 0;
+public:
+    void update(std::string_view data);
+    [[nodiscard]] std::array<u8, 32> digest();
+    [[nodiscard]] std::string hexDigest();
+private:
+    void compress(const u8* block);
+};
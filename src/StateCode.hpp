@@ -17,6 +17,13 @@ enum class StateCode {
     Switch,
     Codegen,
     AsmFileWrite,
+    Preprocessor,
+    Jit,
+    ObjectFileWrite,
+    Link,
+    Server,
+    TimeTraceWrite,
+    IrGeneration,
     ERROR_UNKNOWN
 };
 
@@ -41,6 +48,13 @@ inline std::string to_string(StateCode code)
         case StateCode::Codegen:                    return "Error Codegen";
         case StateCode::TypeResolution:             return "Error TypeResolution";
         case StateCode::AsmFileWrite:               return "Error Assembly File Write";
+        case StateCode::Preprocessor:               return "Error Preprocessor";
+        case StateCode::Jit:                        return "Error JIT";
+        case StateCode::ObjectFileWrite:            return "Error Object File Write";
+        case StateCode::Link:                       return "Error Link";
+        case StateCode::Server:                     return "Error Compile server";
+        case StateCode::TimeTraceWrite:             return "Error Time Trace Write";
+        case StateCode::IrGeneration:               return "Error IR generation";
         default:                                    return "Error Unknown";
     }
 }
\ No newline at end of file
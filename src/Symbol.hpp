@@ -0,0 +1,255 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Interned name. Comparing and hashing is done on the 32-bit id only, the text is looked up
+// when a name has to be printed. Names created while a Symbol::Scope is active go to the
+// Table of that scope and are dropped with it, the rest lives in a process-wide table.
+class Symbol {
+    class Interner;
+    static constexpr u32 s_scopedBit = 1u << 31;
+    static constexpr u32 s_shardShift = 27;
+    static constexpr u32 s_shardCount = 16;
+    static constexpr u32 s_indexMask = (1u << s_shardShift) - 1;
+    u32 m_id = 0;
+    explicit Symbol(const u32 id)
+        : m_id(id) {}
+public:
+    class Table;
+    class Scope;
+
+    Symbol() = default;
+    explicit Symbol(std::string_view name);
+
+    // Symbol spelled "<base>.<number><suffix>", the text is only built when asked for.
+    // Deriving twice from the same arguments within one table gives the same symbol.
+    [[nodiscard]] static Symbol derive(Symbol base, u64 number, std::string_view suffix = "");
+
+    [[nodiscard]] u32 id() const { return m_id; }
+    [[nodiscard]] bool empty() const { return m_id == 0; }
+    [[nodiscard]] std::string_view text() const;
+    [[nodiscard]] std::string str() const { return std::string(text()); }
+
+    bool operator==(const Symbol& other) const = default;
+};
+
+template<>
+struct std::hash<Symbol> {
+    size_t operator()(const Symbol symbol) const noexcept { return symbol.id(); }
+};
+
+// One shard of a Table. Index 0 is reserved for the empty name.
+class Symbol::Interner {
+    struct Entry {
+        std::string text;
+        u32 base = 0;
+        u64 number = 0;
+        std::string suffix;
+        bool materialized = true;
+    };
+public:
+    struct DerivedKey {
+        u32 base;
+        u64 number;
+        std::string_view suffix;
+        bool operator==(const DerivedKey& other) const = default;
+    };
+    struct DerivedKeyHash {
+        size_t operator()(const DerivedKey& key) const noexcept
+        {
+            size_t hash = std::hash<u64>()(key.number) * 31 + key.base;
+            return hash * 31 + std::hash<std::string_view>()(key.suffix);
+        }
+    };
+private:
+    std::deque<Entry> m_entries;
+    std::unordered_map<std::string_view, u32> m_ids;
+    std::unordered_map<DerivedKey, u32, DerivedKeyHash> m_derived;
+    mutable std::shared_mutex m_mutex;
+public:
+    Interner() { m_entries.emplace_back(); }
+
+    [[nodiscard]] bool find(const std::string_view name, u32& index) const
+    {
+        std::shared_lock lock(m_mutex);
+        const auto it = m_ids.find(name);
+        if (it == m_ids.end())
+            return false;
+        index = it->second;
+        return true;
+    }
+    u32 intern(const std::string_view name)
+    {
+        if (u32 index; find(name, index))
+            return index;
+        std::unique_lock lock(m_mutex);
+        if (const auto it = m_ids.find(name); it != m_ids.end())
+            return it->second;
+        const auto index = static_cast<u32>(m_entries.size());
+        m_entries.emplace_back(std::string(name));
+        m_ids.emplace(m_entries.back().text, index);
+        return index;
+    }
+    // The suffix is copied into the entry and the key views that copy, so the caller's
+    // string may go away.
+    u32 derive(const DerivedKey& key)
+    {
+        {
+            std::shared_lock lock(m_mutex);
+            if (const auto it = m_derived.find(key); it != m_derived.end())
+                return it->second;
+        }
+        std::unique_lock lock(m_mutex);
+        if (const auto it = m_derived.find(key); it != m_derived.end())
+            return it->second;
+        const auto index = static_cast<u32>(m_entries.size());
+        const Entry& entry = m_entries.emplace_back(std::string(), key.base, key.number, std::string(key.suffix), false);
+        m_derived.emplace(DerivedKey{key.base, key.number, entry.suffix}, index);
+        return index;
+    }
+    // The text of a base may live in another shard or table, so it is built without holding
+    // the lock and stored by whoever gets there first.
+    std::string_view text(const u32 index)
+    {
+        u32 base;
+        u64 number;
+        std::string_view suffix;
+        {
+            std::shared_lock lock(m_mutex);
+            const Entry& entry = m_entries[index];
+            if (entry.materialized)
+                return entry.text;
+            base = entry.base;
+            number = entry.number;
+            suffix = entry.suffix;
+        }
+        std::string text(Symbol(base).text());
+        text += '.';
+        text += std::to_string(number);
+        text += suffix;
+        std::unique_lock lock(m_mutex);
+        Entry& entry = m_entries[index];
+        if (!entry.materialized) {
+            entry.text = std::move(text);
+            entry.materialized = true;
+        }
+        return entry.text;
+    }
+    [[nodiscard]] size_t size() const
+    {
+        std::shared_lock lock(m_mutex);
+        return m_entries.size() - 1;
+    }
+};
+
+// Symbols of one compilation. The table is split into shards picked by hash, so the backend
+// workers of a compile rarely wait on each other when they derive temporaries.
+class Symbol::Table {
+    friend class Symbol;
+    std::array<Interner, s_shardCount> m_shards;
+    u32 m_tag;
+    static inline thread_local Table* s_active = nullptr;
+
+    explicit Table(const u32 tag)
+        : m_tag(tag) {}
+    u32 id(const u32 shard, const u32 index) const
+    {
+        if (s_indexMask < index)
+            std::abort();
+        return m_tag | shard << s_shardShift | index;
+    }
+    static u32 shardOf(const size_t hash) { return static_cast<u32>(hash >> 7) % s_shardCount; }
+    bool find(const std::string_view name, u32& id) const
+    {
+        const u32 shard = shardOf(std::hash<std::string_view>()(name));
+        u32 index;
+        if (!m_shards[shard].find(name, index))
+            return false;
+        id = this->id(shard, index);
+        return true;
+    }
+    u32 intern(const std::string_view name)
+    {
+        const u32 shard = shardOf(std::hash<std::string_view>()(name));
+        return id(shard, m_shards[shard].intern(name));
+    }
+    u32 derive(const u32 base, const u64 number, const std::string_view suffix)
+    {
+        const Interner::DerivedKey key{base, number, suffix};
+        const u32 shard = shardOf(Interner::DerivedKeyHash()(key));
+        return id(shard, m_shards[shard].derive(key));
+    }
+    std::string_view text(const u32 id)
+    {
+        return m_shards[(id & ~s_scopedBit) >> s_shardShift].text(id & s_indexMask);
+    }
+public:
+    Table()
+        : m_tag(s_scopedBit) {}
+    Table(const Table& other) = delete;
+    Table& operator=(const Table& other) = delete;
+
+    [[nodiscard]] static Table& global()
+    {
+        static Table table(0);
+        return table;
+    }
+    [[nodiscard]] static Table* active() { return s_active; }
+    [[nodiscard]] size_t size() const
+    {
+        size_t size = 0;
+        for (const Interner& shard : m_shards)
+            size += shard.size();
+        return size;
+    }
+};
+
+// Makes table the destination of new symbols on this thread, nullptr selects the global table.
+class Symbol::Scope {
+    Table* m_previous;
+public:
+    explicit Scope(Table* table)
+        : m_previous(Table::s_active) { Table::s_active = table; }
+    ~Scope() { Table::s_active = m_previous; }
+    Scope(const Scope& other) = delete;
+    Scope& operator=(const Scope& other) = delete;
+};
+
+inline Symbol::Symbol(const std::string_view name)
+{
+    Table* table = Table::active();
+    if (name.empty())
+        m_id = 0;
+    else if (table == nullptr)
+        m_id = Table::global().intern(name);
+    else if (!table->find(name, m_id) && !Table::global().find(name, m_id))
+        m_id = table->intern(name);
+}
+
+inline Symbol Symbol::derive(const Symbol base, const u64 number, const std::string_view suffix)
+{
+    Table* table = Table::active();
+    if (table == nullptr)
+        table = &Table::global();
+    return Symbol(table->derive(base.m_id, number, suffix));
+}
+
+inline std::string_view Symbol::text() const
+{
+    if ((m_id & s_scopedBit) == 0)
+        return Table::global().text(m_id);
+    Table* table = Table::active();
+    if (table == nullptr)
+        std::abort();
+    return table->text(m_id);
+}
@@ -0,0 +1,95 @@
+#include "TimeTrace.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+namespace {
+
+void appendString(std::string& json, const std::string_view text)
+{
+    json += '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            json += '\\';
+            json += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            json += escaped;
+        }
+        else {
+            json += c;
+        }
+    }
+    json += '"';
+}
+
+} // namespace
+
+namespace TimeTrace {
+
+std::string toJson(const std::vector<Event>& events)
+{
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+        const Event& event = events[i];
+        if (i != 0)
+            json += ',';
+        json += "\n{\"name\":";
+        appendString(json, event.name);
+        json += ",\"cat\":";
+        appendString(json, event.category);
+        json += ",\"ph\":\"X\",\"ts\":" + std::to_string(event.begin) +
+                ",\"dur\":" + std::to_string(event.duration) +
+                ",\"pid\":1,\"tid\":" + std::to_string(event.thread) +
+                ",\"args\":{\"allocations\":" + std::to_string(event.allocations);
+        if (!event.stage.empty()) {
+            json += ",\"stage\":";
+            appendString(json, event.stage);
+        }
+        if (0 <= event.peakRssKb)
+            json += ",\"peakRssKb\":" + std::to_string(event.peakRssKb);
+        json += "}}";
+    }
+    json += "\n]}\n";
+    return json;
+}
+
+bool write(const std::filesystem::path& path)
+{
+    const std::string json = toJson(Recorder::instance().stop());
+    std::ofstream file(path, std::ios::binary);
+    file << json;
+    return file.good();
+}
+
+} // TimeTrace
+
+void* operator new(const std::size_t size)
+{
+    if (TimeTrace::enabled.load(std::memory_order_relaxed)) {
+        TimeTrace::allocations.fetch_add(1, std::memory_order_relaxed);
+        ++TimeTrace::threadAllocations;
+    }
+    for (;;) {
+        if (void* memory = std::malloc(size == 0 ? 1 : size))
+            return memory;
+        const std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "ShortTypes.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+
+// Process-wide recording of where compile time goes, written as Chrome trace-event JSON by
+// --time-trace. Spans cost one relaxed load while tracing is off. The replaced operator new
+// in TimeTrace.cpp feeds the allocation counters, it only counts while tracing is on.
+namespace TimeTrace {
+
+inline std::atomic<bool> enabled = false;
+inline std::atomic<u64> allocations = 0;
+inline thread_local u64 threadAllocations = 0;
+
+struct Event {
+    std::string name;
+    std::string_view category;
+    std::string_view stage{};
+    u64 begin = 0;
+    u64 duration = 0;
+    u32 thread = 0;
+    u64 allocations = 0;
+    i64 peakRssKb = -1;
+};
+
+class Recorder {
+    std::vector<Event> m_events;
+    std::chrono::steady_clock::time_point m_origin = std::chrono::steady_clock::now();
+    std::atomic<u32> m_threadCount = 0;
+    std::mutex m_mutex;
+
+    Recorder() = default;
+public:
+    static Recorder& instance()
+    {
+        static Recorder recorder;
+        return recorder;
+    }
+    void start()
+    {
+        const std::lock_guard lock(m_mutex);
+        m_events.clear();
+        m_origin = std::chrono::steady_clock::now();
+        enabled.store(true, std::memory_order_relaxed);
+    }
+    [[nodiscard]] std::vector<Event> stop()
+    {
+        enabled.store(false, std::memory_order_relaxed);
+        const std::lock_guard lock(m_mutex);
+        return std::exchange(m_events, {});
+    }
+    [[nodiscard]] u64 now() const
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - m_origin;
+        return static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+    [[nodiscard]] u32 threadId()
+    {
+        thread_local const u32 id = m_threadCount++;
+        return id;
+    }
+    void record(Event event)
+    {
+        const std::lock_guard lock(m_mutex);
+        m_events.emplace_back(std::move(event));
+    }
+};
+
+[[nodiscard]] inline i64 peakRssKb()
+{
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+    return usage.ru_maxrss;
+}
+
+// Span of one compiler stage. Allocations are counted over all threads, so stages that run
+// at the same time in different translation units see each other's allocations.
+class Scope {
+    std::string_view m_name;
+    u64 m_begin = 0;
+    u64 m_allocations = 0;
+    bool m_active;
+public:
+    explicit Scope(const std::string_view name)
+        : m_name(name), m_active(enabled.load(std::memory_order_relaxed))
+    {
+        if (!m_active)
+            return;
+        m_allocations = allocations.load(std::memory_order_relaxed);
+        m_begin = Recorder::instance().now();
+    }
+    ~Scope()
+    {
+        if (!m_active)
+            return;
+        Recorder& recorder = Recorder::instance();
+        const u64 end = recorder.now();
+        recorder.record({
+            .name = std::string(m_name), .category = "stage", .begin = m_begin, .duration = end - m_begin,
+            .thread = recorder.threadId(),
+            .allocations = allocations.load(std::memory_order_relaxed) - m_allocations,
+            .peakRssKb = peakRssKb()});
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+// Span of one function inside a stage, counting only the allocations of the calling thread.
+class FunctionScope {
+    std::string_view m_stage;
+    std::string_view m_function;
+    u64 m_begin = 0;
+    u64 m_allocations = 0;
+    bool m_active;
+public:
+    FunctionScope(const std::string_view stage, const std::string_view function)
+        : m_stage(stage), m_function(function), m_active(enabled.load(std::memory_order_relaxed))
+    {
+        if (!m_active)
+            return;
+        m_allocations = threadAllocations;
+        m_begin = Recorder::instance().now();
+    }
+    ~FunctionScope()
+    {
+        if (!m_active)
+            return;
+        Recorder& recorder = Recorder::instance();
+        const u64 end = recorder.now();
+        recorder.record({
+            .name = std::string(m_function), .category = "function", .stage = m_stage, .begin = m_begin,
+            .duration = end - m_begin, .thread = recorder.threadId(),
+            .allocations = threadAllocations - m_allocations});
+    }
+
+    FunctionScope(const FunctionScope&) = delete;
+    FunctionScope& operator=(const FunctionScope&) = delete;
+};
+
+inline void start()
+{
+    Recorder::instance().start();
+}
+
+[[nodiscard]] std::string toJson(const std::vector<Event>& events);
+// Stops recording and writes everything recorded since start to path.
+[[nodiscard]] bool write(const std::filesystem::path& path);
+
+} // TimeTrace
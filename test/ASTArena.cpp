@@ -0,0 +1,74 @@
+#include "ASTArena.hpp"
+#include "ASTParser.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace Parsing;
+
+TEST(ASTArenaTest, NodesCreatedInScopeLiveInArena)
+{
+    ASTArena arena;
+    {
+        const ArenaScope scope(arena);
+        auto expr = std::make_unique<VarExpr>(Symbol("x"));
+        auto stmt = std::make_unique<ReturnStmt>(std::move(expr));
+        EXPECT_GT(arena.bytesAllocated(), 0u);
+        EXPECT_EQ(arena.blockCount(), 1u);
+    }
+    EXPECT_EQ(activeArena(), nullptr);
+    arena.release();
+    EXPECT_EQ(arena.bytesAllocated(), 0u);
+    EXPECT_EQ(arena.blockCount(), 0u);
+}
+
+TEST(ASTArenaTest, NodesAreLaidOutInAllocationOrder)
+{
+    ASTArena arena;
+    const ArenaScope scope(arena);
+    const auto first = std::make_unique<NullStmt>();
+    const auto second = std::make_unique<NullStmt>();
+    const auto* firstAddress = reinterpret_cast<const std::byte*>(first.get());
+    const auto* secondAddress = reinterpret_cast<const std::byte*>(second.get());
+    EXPECT_LT(firstAddress, secondAddress);
+    EXPECT_LT(secondAddress - firstAddress, 64);
+}
+
+TEST(ASTArenaTest, NodesOutsideScopeUseTheHeap)
+{
+    ASTArena arena;
+    {
+        const ArenaScope scope(arena);
+    }
+    const auto stmt = std::make_unique<NullStmt>();
+    EXPECT_EQ(arena.bytesAllocated(), 0u);
+}
+
+TEST(ASTArenaTest, ScopesNest)
+{
+    ASTArena outer;
+    ASTArena inner;
+    const ArenaScope outerScope(outer);
+    {
+        const ArenaScope innerScope(inner);
+        EXPECT_EQ(activeArena(), &inner);
+    }
+    EXPECT_EQ(activeArena(), &outer);
+}
+
+TEST(ASTArenaTest, ListsAndStringsInScopeUseTheArena)
+{
+    ASTArena arena;
+    {
+        const ArenaScope scope(arena);
+        auto stmt = std::make_unique<GotoStmt>("a label that does not fit into the small string buffer");
+        const size_t afterNode = arena.bytesAllocated();
+        auto block = std::make_unique<Block>();
+        block->body.push_back(nullptr);
+        EXPECT_GT(afterNode, sizeof(GotoStmt));
+        EXPECT_GT(arena.bytesAllocated(), afterNode + sizeof(Block));
+        EXPECT_EQ(block->body.get_allocator().arena(), &arena);
+        EXPECT_EQ(stmt->identifier.get_allocator().arena(), &arena);
+    }
+    const ArenaVector<i32> heapList{1, 2, 3};
+    EXPECT_EQ(heapList.get_allocator().arena(), nullptr);
+}
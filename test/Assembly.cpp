@@ -5,6 +5,7 @@
 #include "ASTIr.hpp"
 
 #include <gtest/gtest.h>
+#include <cstdio>
 #include <utility>
 
 namespace {
@@ -19,7 +20,6 @@ using DataOperand = CodeGen::DataOperand;
 using ImmOperand = CodeGen::ImmOperand;
 using RegisterOperand = CodeGen::RegisterOperand;
 using MemoryOperand = CodeGen::MemoryOperand;
-using std::make_shared;
 }
 
 TEST(AssemblyTests, addType)
@@ -218,19 +218,19 @@ TEST(AssemblyTests, asmOperand)
 {
     struct TestDataOperand {
         const std::string expected;
-        const std::shared_ptr<CodeGen::Operand> operand;
-        TestDataOperand(std::string expected, const std::shared_ptr<CodeGen::Operand>& operand)
+        const CodeGen::Operand operand;
+        TestDataOperand(std::string expected, const CodeGen::Operand& operand)
             : expected(std::move(expected)), operand(operand) {}
     };
 
     const std::vector<TestDataOperand> tests = {
-        {"invalid pseudo", make_shared<PseudoOperand>(Iden(""), ReferingTo::Local, CodeGen::AsmType::LongWord, true)},
-        {"(%rip)", make_shared<DataOperand>(Iden(""), CodeGen::AsmType::LongWord, true)},
-        {".L(%rip)", make_shared<DataOperand>(Iden(""), CodeGen::AsmType::Double, true)},
-        {"$0", make_shared<ImmOperand>(0l, CodeGen::AsmType::QuadWord)},
-        {"%rax", make_shared<RegisterOperand>(RegKind::AX, CodeGen::AsmType::QuadWord)},
-        {"10(%rcx)", make_shared<MemoryOperand>(RegKind::CX, 10, CodeGen::AsmType::QuadWord)},
-        {"(%rcx)", make_shared<MemoryOperand>(RegKind::CX, 0, CodeGen::AsmType::QuadWord)},
+        {"invalid pseudo", PseudoOperand(Iden(""), ReferingTo::Local, CodeGen::AsmType::LongWord, true)},
+        {"(%rip)", DataOperand(Iden(""), CodeGen::AsmType::LongWord, true)},
+        {".L(%rip)", DataOperand(Iden(""), CodeGen::AsmType::Double, true)},
+        {"$0", ImmOperand(0l, CodeGen::AsmType::QuadWord)},
+        {"%rax", RegisterOperand(RegKind::AX, CodeGen::AsmType::QuadWord)},
+        {"10(%rcx)", MemoryOperand(RegKind::CX, 10, CodeGen::AsmType::QuadWord)},
+        {"(%rcx)", MemoryOperand(RegKind::CX, 0, CodeGen::AsmType::QuadWord)},
     };
     for (const TestDataOperand& test : tests) {
         const std::string operString = CodeGen::asmOperand(test.operand);
@@ -244,4 +244,30 @@ TEST(AssemblyTests, asmFormatLabel)
     const std::string name = "name";
     const std::string result = CodeGen::asmFormatLabel(name);
     EXPECT_EQ(result, expected);
-}
\ No newline at end of file
+}
+
+TEST(AssemblyTests, asmWriterPadsAcrossFlushes)
+{
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    {
+        CodeGen::AsmWriter out(fileno(file));
+        const std::string filler(100000, 'x');
+        out.put(filler);
+        out.endTopLevel();
+        const u64 start = out.position();
+        out.put("movl");
+        out.padTo(start + 12);
+        out.putNumber(-42);
+        out.put('\n');
+        out.flush();
+        EXPECT_FALSE(out.failed());
+        EXPECT_EQ(out.position(), filler.size() + 16);
+    }
+    std::string written(100017, '\0');
+    std::rewind(file);
+    written.resize(std::fread(written.data(), 1, written.size(), file));
+    std::fclose(file);
+    ASSERT_EQ(written.size(), 100016);
+    EXPECT_EQ(written.substr(100000), "movl        -42\n");
+}
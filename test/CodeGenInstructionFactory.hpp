@@ -1,7 +1,5 @@
 #pragma once
 
-#include <memory>
-
 #include "AsmAST.hpp"
 
 namespace CodeGen {
@@ -24,11 +22,11 @@ public:
           m_integerSrc(integerSrc), m_integerDst(integerDst) {}
     CodeGenInstructionFactory() = default;
 
-    std::unique_ptr<Inst> create(Inst::Kind kind, OperKind srcKind, OperKind dstKind, AsmType asmType);
-    std::unique_ptr<Inst> create(Inst::Kind kind, OperKind src, OperKind dst);
-    std::unique_ptr<Inst> createBinary(
-        BinaryInst::Operator kind, AsmType asmType, OperKind srcKind, OperKind dstKind);
-    std::unique_ptr<Operand> createOperand(OperKind kind, AsmType asmType);
+    Inst* create(InstructionPool& pool, Inst::Kind kind, OperKind srcKind, OperKind dstKind, AsmType asmType);
+    Inst* create(InstructionPool& pool, Inst::Kind kind, OperKind src, OperKind dst);
+    Inst* createBinary(
+        InstructionPool& pool, BinaryInst::Operator kind, AsmType asmType, OperKind srcKind, OperKind dstKind);
+    Operand createOperand(OperKind kind, AsmType asmType);
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "CompileCache.hpp"
+#include "CompilerDriver.hpp"
+#include "Sha256.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include <unistd.h>
+
+namespace {
+
+class CompileCacheTest : public testing::Test {
+protected:
+    std::filesystem::path m_directory;
+
+    void SetUp() override
+    {
+        m_directory = std::filesystem::temp_directory_path() / ("cc-cache-" + std::to_string(getpid()));
+        std::filesystem::create_directories(m_directory);
+    }
+
+    void TearDown() override
+    {
+        unsetenv("CC_CACHE_DIR");
+        std::filesystem::remove_all(m_directory);
+    }
+
+    void write(const std::string& name, const std::string& text) const
+    {
+        std::ofstream(m_directory / name) << text;
+    }
+
+    [[nodiscard]] std::string read(const std::string& name) const
+    {
+        std::ifstream file(m_directory / name);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    // Output files and the function entries IncrementalBuild stores next to them.
+    [[nodiscard]] u64 entriesSize() const
+    {
+        u64 size = 0;
+        const std::filesystem::path cache = m_directory / "cache";
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(cache)) {
+            const std::filesystem::path directory = entry.path().parent_path();
+            if (entry.is_regular_file() && directory.parent_path() == cache && directory.filename() != "tmp")
+                size += entry.file_size();
+        }
+        return size;
+    }
+
+    [[nodiscard]] i32 compile(const std::vector<std::string>& args) const
+    {
+        std::vector<std::string> argv{"CC"};
+        argv.insert(argv.end(), args.begin(), args.end());
+        const CompilerDriver driver(argv, m_directory);
+        return driver.runLocal();
+    }
+};
+
+}
+
+TEST(Sha256Test, MatchesKnownDigests)
+{
+    Sha256 empty;
+    EXPECT_EQ(empty.hexDigest(), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    Sha256 abc;
+    abc.update("abc");
+    EXPECT_EQ(abc.hexDigest(), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    Sha256 pieces;
+    for (const char* piece : {"abcdbcdecdefdefgefghfghighijhi", "jkijkljklmklmnlmnomnopnopq"})
+        pieces.update(piece);
+    EXPECT_EQ(pieces.hexDigest(), "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+}
+
+TEST_F(CompileCacheTest, KeyDependsOnSourceAndFlags)
+{
+    const std::string key = CompileCache::key("int main(void) { return 0; }", "-c");
+    EXPECT_EQ(CompileCache::key("int main(void) { return 0; }", "-c"), key);
+    EXPECT_NE(CompileCache::key("int main(void) { return 1; }", "-c"), key);
+    EXPECT_NE(CompileCache::key("int main(void) { return 0; }", "--assemble"), key);
+}
+
+TEST_F(CompileCacheTest, SecondCompilationIsServedFromTheCache)
+{
+    setenv("CC_CACHE_DIR", (m_directory / "cache").c_str(), 1);
+    write("unit.c", "#define VALUE 7\nint main(void) { return VALUE; }\n");
+    ASSERT_EQ(compile({"-c", "unit.c"}), 0);
+    const std::string object = read("unit.o");
+    std::filesystem::remove(m_directory / "unit.o");
+
+    // Only a comment changes, the preprocessed text and so the key stay the same.
+    write("unit.c", "#define VALUE 7\n/* comment */ int main(void) { return VALUE; }\n");
+    ASSERT_EQ(compile({"-c", "unit.c"}), 0);
+    EXPECT_EQ(read("unit.o"), object);
+
+    const CompileCache::Stats stats = CompileCache(m_directory / "cache", CompileCache::defaultMaxSize).stats();
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.bytesSaved, object.size());
+    EXPECT_EQ(stats.size, entriesSize());
+}
+
+TEST_F(CompileCacheTest, FailedCompilationsAreNotCached)
+{
+    setenv("CC_CACHE_DIR", (m_directory / "cache").c_str(), 1);
+    write("bad.c", "int main(void) { return x; }\n");
+    EXPECT_NE(compile({"-c", "bad.c"}), 0);
+    EXPECT_NE(compile({"-c", "bad.c"}), 0);
+    const CompileCache::Stats stats = CompileCache(m_directory / "cache", CompileCache::defaultMaxSize).stats();
+    EXPECT_EQ(stats.hits, 0);
+    EXPECT_EQ(stats.size, 0);
+}
+
+TEST_F(CompileCacheTest, EvictsLeastRecentlyUsedEntries)
+{
+    const CompileCache cache(m_directory / "cache", 250);
+    const std::vector<std::string> keys{CompileCache::key("a", ""), CompileCache::key("b", ""),
+                                        CompileCache::key("c", "")};
+    write("output", std::string(100, 'x'));
+    cache.store(keys[0], m_directory / "output");
+    cache.store(keys[1], m_directory / "output");
+    // Make the first entry the most recently used one, so the second is evicted.
+    std::filesystem::last_write_time(m_directory / "cache" / keys[1].substr(0, 2) / keys[1].substr(2),
+        std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+    EXPECT_TRUE(cache.fetch(keys[0], m_directory / "fetched"));
+    cache.store(keys[2], m_directory / "output");
+
+    EXPECT_TRUE(cache.fetch(keys[0], m_directory / "fetched"));
+    EXPECT_FALSE(cache.fetch(keys[1], m_directory / "fetched"));
+    EXPECT_TRUE(cache.fetch(keys[2], m_directory / "fetched"));
+    EXPECT_EQ(cache.stats().size, 200);
+}
@@ -0,0 +1,130 @@
+#include "CompileServer.hpp"
+#include "StateCode.hpp"
+#include "Symbol.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <unistd.h>
+
+namespace {
+
+i64 residentKb()
+{
+    i64 pages = 0;
+    i64 resident = 0;
+    std::ifstream("/proc/self/statm") >> pages >> resident;
+    return resident * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+class CompileServerTest : public testing::Test {
+protected:
+    std::filesystem::path m_directory;
+    std::filesystem::path m_socketPath;
+    std::unique_ptr<Server::CompileServer> m_server;
+    std::jthread m_thread;
+
+    void SetUp() override
+    {
+        m_directory = std::filesystem::temp_directory_path() / ("cc-server-" + std::to_string(getpid()));
+        std::filesystem::create_directories(m_directory);
+        m_socketPath = m_directory / "socket";
+        std::ofstream(m_directory / "good.c") << "int main(void) { return 3; }\n";
+        std::ofstream(m_directory / "bad.c") << "int main(void) { return x; }\n";
+        m_server = std::make_unique<Server::CompileServer>(m_socketPath);
+        const std::vector<std::string> errors = m_server->listen();
+        ASSERT_TRUE(errors.empty()) << errors.front();
+        m_thread = std::jthread([this] { m_server->serve(); });
+    }
+
+    void TearDown() override
+    {
+        if (m_server != nullptr)
+            m_server->stop();
+        if (m_thread.joinable())
+            m_thread.join();
+        m_server.reset();
+        std::filesystem::remove_all(m_directory);
+    }
+
+    std::optional<i32> compile(const std::vector<std::string>& args) const
+    {
+        std::vector<std::string> argv{"CC"};
+        argv.insert(argv.end(), args.begin(), args.end());
+        return Server::forward(m_socketPath, m_directory, argv);
+    }
+};
+
+}
+
+TEST_F(CompileServerTest, ResolvesPathsAgainstClientDirectory)
+{
+    EXPECT_EQ(compile({"--validate", "good.c"}), 0);
+    EXPECT_EQ(compile({"-c", "good.c"}), 0);
+    EXPECT_TRUE(std::filesystem::exists(m_directory / "good.o"));
+}
+
+TEST_F(CompileServerTest, ReturnsTheExitCodeOfFailedCompilations)
+{
+    EXPECT_EQ(compile({"--validate", "bad.c"}), static_cast<i32>(StateCode::VariableResolution));
+    EXPECT_EQ(compile({"--validate", "missing.c"}), static_cast<i32>(StateCode::FileNotFound));
+}
+
+TEST_F(CompileServerTest, ServesConcurrentClients)
+{
+    std::vector<std::optional<i32>> results(8);
+    {
+        std::vector<std::jthread> clients;
+        for (size_t i = 0; i < results.size(); ++i)
+            clients.emplace_back([this, &results, i] {
+                results[i] = compile({"--validate", i % 2 == 0 ? "good.c" : "bad.c"});
+            });
+    }
+    for (size_t i = 0; i < results.size(); ++i)
+        EXPECT_EQ(results[i], i % 2 == 0 ? 0 : static_cast<i32>(StateCode::VariableResolution));
+}
+
+TEST_F(CompileServerTest, MemoryStaysFlatAcrossRequests)
+{
+    // Every request spells new names and plenty of temporaries, so symbols or types outliving
+    // it would show up quickly.
+    const auto request = [this](const i32 index) {
+        const std::string name = "f" + std::to_string(index);
+        {
+            std::ofstream file(m_directory / (name + ".c"));
+            file << "long " << name << "(long x, long *p" << name << ") {\n";
+            for (i32 i = 0; i < 300; ++i)
+                file << "    x = x * " << i << " + p" << name << "[" << i % 7 << "];\n";
+            file << "    return x;\n}\n";
+        }
+        return compile({"--codegen", name + ".c"});
+    };
+    for (i32 i = 0; i < 20; ++i)
+        ASSERT_EQ(request(i), 0);
+    const size_t globalSymbols = Symbol::Table::global().size();
+    const i64 before = residentKb();
+    for (i32 i = 20; i < 120; ++i)
+        ASSERT_EQ(request(i), 0);
+    EXPECT_EQ(Symbol::Table::global().size(), globalSymbols);
+    EXPECT_LT(residentKb() - before, 1024);
+}
+
+TEST_F(CompileServerTest, LeavesRunToTheClient)
+{
+    EXPECT_EQ(compile({"--run", "good.c"}), std::nullopt);
+}
+
+TEST_F(CompileServerTest, LeavesTimeTraceToTheClient)
+{
+    EXPECT_EQ(compile({"--validate", "--time-trace=trace.json", "good.c"}), std::nullopt);
+    EXPECT_FALSE(std::filesystem::exists(m_directory / "trace.json"));
+}
+
+TEST(CompileServerClientTest, ReportsMissingServer)
+{
+    const std::filesystem::path socketPath = std::filesystem::temp_directory_path() / "cc-no-such-server";
+    EXPECT_EQ(Server::forward(socketPath, "/", {"CC", "--validate", "x.c"}), std::nullopt);
+}
@@ -0,0 +1,167 @@
+#include "ConstantFolding.hpp"
+#include "DynCast.hpp"
+#include "IrFunctionBuilder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+using namespace Ir;
+using namespace Optimization;
+
+namespace {
+
+using Operation = BinaryInst::Operation;
+
+std::optional<Value> binary(const Operation operation, const Value& lhs, const Value& rhs)
+{
+    return foldBinary(operation, lhs, rhs, lhs.type);
+}
+
+i64 compare(const Operation operation, const Value& lhs, const Value& rhs)
+{
+    const std::optional<Value> result = foldBinary(operation, lhs, rhs, Type::I32);
+    EXPECT_TRUE(result.has_value());
+    return result->asI64();
+}
+
+}
+
+TEST(ConstantFoldingTest, IntegerArithmeticWrapsInItsWidth)
+{
+    EXPECT_EQ(binary(Operation::Add, Value(std::numeric_limits<i32>::max()), Value(1)),
+              Value(std::numeric_limits<i32>::min()));
+    EXPECT_EQ(binary(Operation::Subtract, Value(0u), Value(1u)), Value(std::numeric_limits<u32>::max()));
+    EXPECT_EQ(binary(Operation::Multiply, Value(u64{1} << 40), Value(u64{1} << 30)), Value(u64{0}));
+    EXPECT_EQ(binary(Operation::Multiply, Value(i64{3037000500}), Value(i64{3037000500})),
+              Value(static_cast<i64>(u64{3037000500} * u64{3037000500})));
+    EXPECT_EQ(binary(Operation::Add, Value(static_cast<u8>(250)), Value(static_cast<u8>(10))),
+              Value(static_cast<u8>(4)));
+    EXPECT_EQ(binary(Operation::Divide, Value(-7), Value(2)), Value(-3));
+    EXPECT_EQ(binary(Operation::Remainder, Value(-7), Value(2)), Value(-1));
+    EXPECT_EQ(binary(Operation::Divide, Value(4294967295u), Value(2u)), Value(2147483647u));
+    EXPECT_EQ(binary(Operation::BitwiseXor, Value(i64{-1}), Value(i64{0xff})), Value(i64{-256}));
+}
+
+TEST(ConstantFoldingTest, ShiftsFollowSignednessAndWidth)
+{
+    EXPECT_EQ(binary(Operation::RightShift, Value(-16), Value(2)), Value(-4));
+    EXPECT_EQ(binary(Operation::RightShift, Value(0xfffffff0u), Value(2)), Value(0x3ffffffcu));
+    EXPECT_EQ(binary(Operation::LeftShift, Value(1), Value(31)), Value(std::numeric_limits<i32>::min()));
+    EXPECT_EQ(binary(Operation::LeftShift, Value(i64{1}), Value(40)), Value(i64{1} << 40));
+    EXPECT_EQ(binary(Operation::RightShift, Value(static_cast<char>(-4)), Value(1)), Value(static_cast<char>(-2)));
+    EXPECT_FALSE(binary(Operation::LeftShift, Value(1), Value(32)));
+    EXPECT_FALSE(binary(Operation::LeftShift, Value(1), Value(-1)));
+    EXPECT_FALSE(binary(Operation::RightShift, Value(i64{1}), Value(64)));
+}
+
+TEST(ConstantFoldingTest, TrapsAreLeftForRunTime)
+{
+    EXPECT_FALSE(binary(Operation::Divide, Value(1), Value(0)));
+    EXPECT_FALSE(binary(Operation::Remainder, Value(1u), Value(0u)));
+    EXPECT_FALSE(binary(Operation::Divide, Value(std::numeric_limits<i32>::min()), Value(-1)));
+    EXPECT_FALSE(binary(Operation::Remainder, Value(std::numeric_limits<i64>::min()), Value(i64{-1})));
+    EXPECT_EQ(binary(Operation::Divide, Value(std::numeric_limits<i64>::min()), Value(i64{2})),
+              Value(std::numeric_limits<i64>::min() / 2));
+}
+
+TEST(ConstantFoldingTest, ComparisonsUseTheOperandType)
+{
+    EXPECT_EQ(compare(Operation::LessThan, Value(-1), Value(1)), 1);
+    EXPECT_EQ(compare(Operation::LessThan, Value(4294967295u), Value(1u)), 0);
+    EXPECT_EQ(compare(Operation::GreaterOrEqual, Value(u64{1} << 63), Value(u64{1})), 1);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_EQ(compare(Operation::Equal, Value(nan), Value(nan)), 0);
+    EXPECT_EQ(compare(Operation::NotEqual, Value(nan), Value(nan)), 1);
+    EXPECT_EQ(compare(Operation::LessOrEqual, Value(0.5), Value(0.5)), 1);
+}
+
+TEST(ConstantFoldingTest, UnaryOperations)
+{
+    using Unary = UnaryInst::Operation;
+    EXPECT_EQ(foldUnary(Unary::Negate, Value(std::numeric_limits<i32>::min()), Type::I32),
+              Value(std::numeric_limits<i32>::min()));
+    EXPECT_EQ(foldUnary(Unary::Negate, Value(1u), Type::U32), Value(4294967295u));
+    EXPECT_EQ(foldUnary(Unary::Complement, Value(i64{0}), Type::I64), Value(i64{-1}));
+    EXPECT_EQ(foldUnary(Unary::Not, Value(0), Type::I32), Value(1));
+    EXPECT_EQ(foldUnary(Unary::Not, Value(-0.0), Type::I32), Value(1));
+    EXPECT_EQ(foldUnary(Unary::Negate, Value(0.0), Type::Double)->bits, std::bit_cast<u64>(-0.0));
+}
+
+TEST(ConstantFoldingTest, Conversions)
+{
+    using Kind = Instruction::Kind;
+    EXPECT_EQ(foldConversion(Kind::SignExtend, Value(-5), Type::I64), Value(i64{-5}));
+    EXPECT_EQ(foldConversion(Kind::SignExtend, Value(static_cast<char>(-1)), Type::U32), Value(4294967295u));
+    EXPECT_EQ(foldConversion(Kind::ZeroExtend, Value(4294967295u), Type::I64), Value(i64{4294967295}));
+    EXPECT_EQ(foldConversion(Kind::ZeroExtend, Value(static_cast<u8>(200)), Type::I32), Value(200));
+    EXPECT_EQ(foldConversion(Kind::Truncate, Value(i64{0x1ffffffff}), Type::I32), Value(-1));
+    EXPECT_EQ(foldConversion(Kind::Truncate, Value(300), Type::Char), Value(static_cast<char>(44)));
+    EXPECT_EQ(foldConversion(Kind::DoubleToInt, Value(-2.9), Type::I32), Value(-2));
+    EXPECT_EQ(foldConversion(Kind::DoubleToUInt, Value(4294967295.5), Type::U32), Value(4294967295u));
+    EXPECT_EQ(foldConversion(Kind::DoubleToUInt, Value(-0.5), Type::U64), Value(u64{0}));
+    EXPECT_FALSE(foldConversion(Kind::DoubleToInt, Value(2147483648.0), Type::I32));
+    EXPECT_FALSE(foldConversion(Kind::DoubleToUInt, Value(-1.0), Type::U32));
+    EXPECT_FALSE(foldConversion(Kind::DoubleToInt, Value(std::nan("")), Type::I64));
+    EXPECT_EQ(foldConversion(Kind::IntToDouble, Value(static_cast<char>(-3)), Type::Double), Value(-3.0));
+    EXPECT_EQ(foldConversion(Kind::UIntToDouble, Value(u64{1} << 63), Type::Double), Value(9223372036854775808.0));
+}
+
+TEST(ConstantFoldingTest, FoldsThroughSingleAssignmentTemporaries)
+{
+    // return 1 + 2 * 3;
+    IrFunctionBuilder builder;
+    const ValueId product = builder.var("f.0");
+    const ValueId sum = builder.var("f.1");
+    builder.add<BinaryInst>(Operation::Multiply, builder.constant(2), builder.constant(3), product, Type::I32)
+        .add<BinaryInst>(Operation::Add, builder.constant(1), product, sum, Type::I32)
+        .add<ReturnInst>(sum, Type::I32);
+    Function& function = builder.function();
+    FunctionAnalyses analyses(function);
+    EXPECT_EQ(ConstantFolding().run(function, analyses), Preserved::Cfg | Preserved::Dominators);
+    const auto returnInst = dynCast<const ReturnInst>(function.insts[2]);
+    EXPECT_EQ(function.value(returnInst->returnValue), Value(7));
+    EXPECT_EQ(ConstantFolding().run(function, analyses), Preserved::All);
+}
+
+TEST(ConstantFoldingTest, LeavesReassignedAndAddressTakenVariables)
+{
+    IrFunctionBuilder builder;
+    const ValueId x = builder.var("x");
+    const ValueId y = builder.var("y");
+    const ValueId pointer = builder.var("p", Type::Pointer);
+    const ValueId arg = builder.var("a");
+    builder.function().args.push_back(Identifier{Symbol("a")});
+    builder.add<CopyInst>(builder.constant(1), x, Type::I32)
+        .add<CopyInst>(builder.constant(2), x, Type::I32)
+        .add<CopyInst>(builder.constant(3), y, Type::I32)
+        .add<GetAddressInst>(y, pointer, Type::Pointer)
+        .add<CopyInst>(builder.constant(4), arg, Type::I32)
+        .add<BinaryInst>(Operation::Add, x, y, x, Type::I32)
+        .add<BinaryInst>(Operation::Add, arg, arg, x, Type::I32);
+    Function& function = builder.function();
+    FunctionAnalyses analyses(function);
+    EXPECT_EQ(ConstantFolding().run(function, analyses), Preserved::All);
+}
+
+TEST(ConstantFoldingTest, ConstantConditionsDecideJumps)
+{
+    IrFunctionBuilder builder;
+    const ValueId c = builder.var("c");
+    const LabelId taken = builder.label();
+    const LabelId skipped = builder.label();
+    builder.add<CopyInst>(builder.constant(0), c, Type::I32)
+        .add<JumpIfZeroInst>(c, taken, Type::I32)
+        .add<JumpIfNotZeroInst>(c, skipped, Type::I32)
+        .add<LabelInst>(skipped)
+        .add<LabelInst>(taken)
+        .add<ReturnInst>(c, Type::I32);
+    Function& function = builder.function();
+    FunctionAnalyses analyses(function);
+    EXPECT_EQ(ConstantFolding().run(function, analyses), Preserved::None);
+    ASSERT_EQ(function.insts.size(), 5);
+    EXPECT_EQ(function.insts[1]->kind, Instruction::Kind::Jump);
+    EXPECT_EQ(dynCast<const JumpInst>(function.insts[1])->target, taken);
+    EXPECT_EQ(function.insts[2]->kind, Instruction::Kind::Label);
+}
@@ -0,0 +1,124 @@
+#include "CopyPropagation.hpp"
+#include "DynCast.hpp"
+#include "IrFunctionBuilder.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace Ir;
+using namespace Optimization;
+
+namespace {
+
+using Operation = BinaryInst::Operation;
+
+Preserved propagate(Function& function)
+{
+    FunctionAnalyses analyses(function);
+    return CopyPropagation().run(function, analyses);
+}
+
+ValueId lhsOf(const Function& function, const size_t index)
+{
+    return dynCast<const BinaryInst>(function.insts[index])->lhs;
+}
+
+}
+
+TEST(CopyPropagationTest, ReplacesReadsOfTheCopy)
+{
+    IrFunctionBuilder builder;
+    const ValueId x = builder.var("x");
+    const ValueId t = builder.var("t");
+    const ValueId u = builder.var("u");
+    builder.add<CopyInst>(x, t, Type::I32)
+        .add<CopyInst>(t, u, Type::I32)
+        .add<BinaryInst>(Operation::Add, u, builder.constant(1), x, Type::I32)
+        .add<ReturnInst>(t, Type::I32);
+    Function& function = builder.function();
+    EXPECT_EQ(propagate(function), Preserved::Cfg | Preserved::Dominators);
+    EXPECT_EQ(dynCast<const CopyInst>(function.insts[1])->src, x);
+    EXPECT_EQ(lhsOf(function, 2), x);
+    // x is assigned after the copies, so t no longer holds it.
+    EXPECT_EQ(dynCast<const ReturnInst>(function.insts[3])->returnValue, t);
+}
+
+TEST(CopyPropagationTest, CopiesMustReachAlongEveryPath)
+{
+    // if (c) t = x; else t = <x or y>; return t + 1;
+    const auto build = [](const bool sameSource) {
+        IrFunctionBuilder builder;
+        const ValueId c = builder.var("c");
+        const ValueId t = builder.var("t");
+        const LabelId elseLabel = builder.label();
+        const LabelId end = builder.label();
+        builder.add<JumpIfZeroInst>(c, elseLabel, Type::I32)
+            .add<CopyInst>(builder.var("x"), t, Type::I32)
+            .add<JumpInst>(end)
+            .add<LabelInst>(elseLabel)
+            .add<CopyInst>(builder.var(sameSource ? "x" : "y"), t, Type::I32)
+            .add<LabelInst>(end)
+            .add<BinaryInst>(Operation::Add, t, builder.constant(1), c, Type::I32);
+        return builder.build();
+    };
+    const std::unique_ptr<Function> same = build(true);
+    EXPECT_EQ(propagate(*same), Preserved::Cfg | Preserved::Dominators);
+    EXPECT_EQ(same->value(lhsOf(*same, 6)).name, Symbol("x"));
+    const std::unique_ptr<Function> different = build(false);
+    EXPECT_EQ(propagate(*different), Preserved::All);
+}
+
+TEST(CopyPropagationTest, LoopsEndCopiesTheyReassign)
+{
+    IrFunctionBuilder builder;
+    const ValueId x = builder.var("x");
+    const ValueId t = builder.var("t");
+    const ValueId y = builder.var("y");
+    const LabelId loop = builder.label();
+    builder.add<CopyInst>(x, t, Type::I32)
+        .add<LabelInst>(loop)
+        .add<BinaryInst>(Operation::Add, t, builder.constant(1), y, Type::I32)
+        .add<BinaryInst>(Operation::Add, x, builder.constant(1), x, Type::I32)
+        .add<JumpIfNotZeroInst>(y, loop, Type::I32);
+    Function& function = builder.function();
+    EXPECT_EQ(propagate(function), Preserved::All);
+}
+
+TEST(CopyPropagationTest, CallsAndStoresClobberMemory)
+{
+    IrFunctionBuilder builder;
+    const ValueId global = builder.var("g", Type::I32, ReferingTo::Static);
+    const ValueId local = builder.var("l");
+    const ValueId taken = builder.var("a");
+    const ValueId pointer = builder.var("p", Type::Pointer);
+    const ValueId fromGlobal = builder.var("t1");
+    const ValueId fromLocal = builder.var("t2");
+    const ValueId fromTaken = builder.var("t3");
+    builder.add<GetAddressInst>(taken, pointer, Type::Pointer)
+        .add<CopyInst>(global, fromGlobal, Type::I32)
+        .add<CopyInst>(local, fromLocal, Type::I32)
+        .add<CopyInst>(taken, fromTaken, Type::I32)
+        .call("f", {}, ValueId::None)
+        .add<BinaryInst>(Operation::Add, fromGlobal, fromLocal, local, Type::I32)
+        .add<CopyInst>(taken, fromTaken, Type::I32)
+        .add<StoreInst>(builder.constant(1), pointer, Type::I32)
+        .add<BinaryInst>(Operation::Add, fromTaken, fromLocal, local, Type::I32);
+    Function& function = builder.function();
+    EXPECT_EQ(propagate(function), Preserved::Cfg | Preserved::Dominators);
+    EXPECT_EQ(lhsOf(function, 5), fromGlobal);
+    EXPECT_EQ(dynCast<const BinaryInst>(function.insts[5])->rhs, local);
+    EXPECT_EQ(lhsOf(function, 8), fromTaken);
+}
+
+TEST(CopyPropagationTest, RemovesCopiesOfValuesAlreadyHeld)
+{
+    IrFunctionBuilder builder;
+    const ValueId x = builder.var("x");
+    const ValueId t = builder.var("t");
+    builder.add<CopyInst>(x, t, Type::I32)
+        .add<CopyInst>(x, t, Type::I32)
+        .add<ReturnInst>(t, Type::I32);
+    Function& function = builder.function();
+    EXPECT_EQ(propagate(function), Preserved::None);
+    ASSERT_EQ(function.insts.size(), 2);
+    EXPECT_EQ(dynCast<const ReturnInst>(function.insts[1])->returnValue, x);
+}
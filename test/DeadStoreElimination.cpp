@@ -0,0 +1,113 @@
+#include "DeadStoreElimination.hpp"
+#include "DynCast.hpp"
+#include "IrFunctionBuilder.hpp"
+#include "Liveness.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace Ir;
+using namespace Optimization;
+
+namespace {
+
+using Operation = BinaryInst::Operation;
+using Kind = Instruction::Kind;
+
+Preserved eliminate(Function& function)
+{
+    FunctionAnalyses analyses(function);
+    return DeadStoreElimination().run(function, analyses);
+}
+
+}
+
+TEST(LivenessTest, VariablesLiveAcrossBranchesAndLoops)
+{
+    // i = 0; loop: t = i + 1; i = t; if (t) goto loop; return x;
+    IrFunctionBuilder builder;
+    const ValueId i = builder.var("i");
+    const ValueId t = builder.var("t");
+    const ValueId x = builder.var("x");
+    const ValueId global = builder.var("g", Type::I32, ReferingTo::Static);
+    const LabelId loop = builder.label();
+    builder.add<CopyInst>(builder.constant(0), i, Type::I32)
+        .add<LabelInst>(loop)
+        .add<BinaryInst>(Operation::Add, i, builder.constant(1), t, Type::I32)
+        .add<CopyInst>(t, i, Type::I32)
+        .add<JumpIfNotZeroInst>(t, loop, Type::I32)
+        .add<CopyInst>(global, t, Type::I32)
+        .add<ReturnInst>(x, Type::I32);
+    Function& function = builder.function();
+    FunctionAnalyses analyses(function);
+    const ControlFlowGraph& cfg = analyses.get<ControlFlowGraph>();
+    const Liveness& liveness = analyses.get<Liveness>();
+    ASSERT_EQ(cfg.size(), 3);
+    EXPECT_FALSE(liveness.tracked(global));
+    EXPECT_EQ(liveness.variableCount(), 3);
+    EXPECT_EQ(liveness.value(liveness.variable(t)), t);
+    EXPECT_TRUE(liveness.liveIn(0).test(liveness.variable(x)));
+    EXPECT_FALSE(liveness.liveIn(0).test(liveness.variable(i)));
+    EXPECT_TRUE(liveness.liveIn(1).test(liveness.variable(i)));
+    EXPECT_TRUE(liveness.liveOut(1).test(liveness.variable(i)));
+    EXPECT_FALSE(liveness.liveOut(1).test(liveness.variable(t)));
+    EXPECT_FALSE(liveness.liveIn(2).test(liveness.variable(i)));
+    EXPECT_TRUE(liveness.liveIn(2).test(liveness.variable(x)));
+    EXPECT_EQ(liveness.liveOut(2), BitSet(liveness.variableCount()));
+}
+
+TEST(DeadStoreEliminationTest, RemovesChainsOfDeadComputations)
+{
+    IrFunctionBuilder builder;
+    const ValueId x = builder.var("x");
+    const ValueId t1 = builder.var("t1");
+    const ValueId t2 = builder.var("t2");
+    const ValueId d = builder.var("d", Type::Double);
+    builder.add<BinaryInst>(Operation::Multiply, x, x, t1, Type::I32)
+        .add<IntToDoubleInst>(t1, d, Type::Double)
+        .add<BinaryInst>(Operation::Add, t1, builder.constant(1), t2, Type::I32)
+        .add<CopyInst>(builder.constant(2), x, Type::I32)
+        .add<ReturnInst>(x, Type::I32);
+    Function& function = builder.function();
+    EXPECT_EQ(eliminate(function), Preserved::None);
+    ASSERT_EQ(function.insts.size(), 2);
+    EXPECT_EQ(function.insts[0]->kind, Kind::Copy);
+    EXPECT_EQ(eliminate(function), Preserved::All);
+}
+
+TEST(DeadStoreEliminationTest, KeepsValuesReadAlongAnyPath)
+{
+    // if (c) x = 1; else { x = 2; return x; } return c;
+    IrFunctionBuilder builder;
+    const ValueId c = builder.var("c");
+    const ValueId x = builder.var("x");
+    const LabelId elseLabel = builder.label();
+    builder.add<JumpIfZeroInst>(c, elseLabel, Type::I32)
+        .add<CopyInst>(builder.constant(1), x, Type::I32)
+        .add<ReturnInst>(c, Type::I32)
+        .add<LabelInst>(elseLabel)
+        .add<CopyInst>(builder.constant(2), x, Type::I32)
+        .add<ReturnInst>(x, Type::I32);
+    Function& function = builder.function();
+    EXPECT_EQ(eliminate(function), Preserved::None);
+    ASSERT_EQ(function.insts.size(), 5);
+    EXPECT_EQ(function.insts[1]->kind, Kind::Return);
+    EXPECT_EQ(function.insts[3]->kind, Kind::Copy);
+}
+
+TEST(DeadStoreEliminationTest, KeepsSideEffectsAndWritesReadThroughMemory)
+{
+    IrFunctionBuilder builder;
+    const ValueId global = builder.var("g", Type::I32, ReferingTo::Static);
+    const ValueId taken = builder.var("a");
+    const ValueId pointer = builder.var("p", Type::Pointer);
+    const ValueId result = builder.var("r");
+    builder.add<CopyInst>(builder.constant(1), global, Type::I32)
+        .add<GetAddressInst>(taken, pointer, Type::Pointer)
+        .add<CopyInst>(builder.constant(2), taken, Type::I32)
+        .call("f", {pointer}, result)
+        .add<StoreInst>(builder.constant(3), pointer, Type::I32)
+        .add<ReturnInst>(builder.constant(0), Type::I32);
+    Function& function = builder.function();
+    EXPECT_EQ(eliminate(function), Preserved::All);
+    EXPECT_EQ(function.insts.size(), 6);
+}
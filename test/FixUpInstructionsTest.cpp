@@ -13,63 +13,63 @@ std::array binaryOtherOpers{BinaryOper::Add, BinaryOper::Sub,
 
 void FixUpInstructionsTest::addMove(const OperKind srcKind, const OperKind dstKind, const AsmType asmType)
 {
-    insts.push_back(factory.create(InstKind::Move, srcKind, dstKind, asmType));
+    insts.push_back(factory.create(pool, InstKind::Move, srcKind, dstKind, asmType));
 }
 
 void FixUpInstructionsTest::addMoveZero(const OperKind srcKind, const OperKind dstKind, const AsmType asmType)
 {
-    insts.push_back(factory.create(InstKind::MoveZeroExtend, srcKind, dstKind, asmType));
+    insts.push_back(factory.create(pool, InstKind::MoveZeroExtend, srcKind, dstKind, asmType));
 }
 
 void FixUpInstructionsTest::addMoveSX(const OperKind srcKind, const OperKind dstKind)
 {
-    insts.push_back(factory.create(InstKind::MoveSX, srcKind, dstKind));
+    insts.push_back(factory.create(pool, InstKind::MoveSX, srcKind, dstKind));
 }
 
 void FixUpInstructionsTest::addLea(const OperKind srcKind, const OperKind dstKind)
 {
-    insts.push_back(factory.create(InstKind::Lea, srcKind, dstKind));
+    insts.push_back(factory.create(pool, InstKind::Lea, srcKind, dstKind));
 }
 
 void FixUpInstructionsTest::addDiv(const OperKind srcKind, const OperKind dstKind)
 {
-    insts.push_back(factory.create(InstKind::Div, srcKind, dstKind));
+    insts.push_back(factory.create(pool, InstKind::Div, srcKind, dstKind));
 }
 
 void FixUpInstructionsTest::addIdiv(const OperKind srcKind, const OperKind dstKind)
 {
-    insts.push_back(factory.create(InstKind::Idiv, srcKind, dstKind));
+    insts.push_back(factory.create(pool, InstKind::Idiv, srcKind, dstKind));
 }
 
 void FixUpInstructionsTest::addCvttsd2si(OperKind srcKind, OperKind dstKind)
 {
-    insts.push_back(factory.create(InstKind::Cvttsd2si, srcKind, dstKind));
+    insts.push_back(factory.create(pool, InstKind::Cvttsd2si, srcKind, dstKind));
 }
 
 void FixUpInstructionsTest::addCvtsi2sd(OperKind srcKind, OperKind dstKind)
 {
-    insts.push_back(factory.create(InstKind::Cvtsi2sd, srcKind, dstKind));
+    insts.push_back(factory.create(pool, InstKind::Cvtsi2sd, srcKind, dstKind));
 }
 
 void FixUpInstructionsTest::addCmp(const OperKind srcKind, const OperKind dstKind, const AsmType asmType)
 {
-    insts.push_back(factory.create(InstKind::Cmp, srcKind, dstKind, asmType));
+    insts.push_back(factory.create(pool, InstKind::Cmp, srcKind, dstKind, asmType));
 }
 
 void FixUpInstructionsTest::addBinary(CodeGen::BinaryInst::Operator oper, AsmType asmType, OperKind srcKind, OperKind dstKind)
 {
-    insts.push_back(factory.createBinary(oper, asmType, srcKind, dstKind));
+    insts.push_back(factory.createBinary(pool, oper, asmType, srcKind, dstKind));
 }
 
 void FixUpInstructionsTest::run()
 {
-    CodeGen::FixUpInstructions fixUpInstructions(insts, 0);
+    CodeGen::FixUpInstructions fixUpInstructions(insts, pool, 0);
     fixUpInstructions.fixUp();
 }
 
 void FixUpInstructionsTest::run(const i32 stackAlloc)
 {
-    CodeGen::FixUpInstructions fixUpInstructions(insts, stackAlloc);
+    CodeGen::FixUpInstructions fixUpInstructions(insts, pool, stackAlloc);
     fixUpInstructions.fixUp();
 }
 
@@ -90,13 +90,12 @@ TEST_F(FixUpInstructionsTest, fixStackAlignment_fixAlignment)
     run(-8);
     EXPECT_EQ(insts.size(), 1);
     EXPECT_EQ(insts[0]->kind, InstKind::Binary);
-    const auto binary = dynCast<CodeGen::BinaryInst>(insts[0].get());
-    EXPECT_EQ(binary->lhs->kind, OperKind::Imm);
-    EXPECT_EQ(binary->rhs->kind, OperKind::Register);
+    const auto binary = dynCast<CodeGen::BinaryInst>(insts[0]);
+    EXPECT_EQ(binary->lhs.kind, OperKind::Imm);
+    EXPECT_EQ(binary->rhs.kind, OperKind::Register);
     EXPECT_EQ(binary->oper, BinaryOper::Sub);
     EXPECT_EQ(binary->type, AsmType::QuadWord);
-    const auto imm = dynCast<CodeGen::ImmOperand>(binary->lhs.get());
-    EXPECT_EQ(imm->value, 16);
+    EXPECT_EQ(binary->lhs.value, 16);
 }
 
 TEST_F(FixUpInstructionsTest, fixMove_expandSrcOnStack)
@@ -409,28 +408,28 @@ TEST_F(FixUpInstructionsTest, fixCvtsi2sd_fixSrcImm)
 
 TEST_F(FixUpInstructionsTest, genSrcOperand_Double)
 {
-    const auto expected = make_shared<RegisterOperand>(RegType::XMM14, AsmType::Double);
+    const RegisterOperand expected(RegType::XMM14, AsmType::Double);
     const auto actual = CodeGen::FixUpInstructions::genSrcOperand(AsmType::Double);
-    EXPECT_EQ(expected->regKind, actual->regKind);
+    EXPECT_EQ(expected.regKind, actual.regKind);
 }
 
 TEST_F(FixUpInstructionsTest, genSrcOperand_Long)
 {
-    const auto expected = make_shared<RegisterOperand>(RegType::R10, AsmType::LongWord);
+    const RegisterOperand expected(RegType::R10, AsmType::LongWord);
     const auto actual = CodeGen::FixUpInstructions::genSrcOperand(AsmType::LongWord);
-    EXPECT_EQ(expected->regKind, actual->regKind);
+    EXPECT_EQ(expected.regKind, actual.regKind);
 }
 
 TEST_F(FixUpInstructionsTest, genDstOperand_Double)
 {
-    const auto expected = make_shared<RegisterOperand>(RegType::XMM15, AsmType::Double);
+    const RegisterOperand expected(RegType::XMM15, AsmType::Double);
     const auto actual = CodeGen::FixUpInstructions::genDstOperand(AsmType::Double);
-    EXPECT_EQ(expected->regKind, actual->regKind);
+    EXPECT_EQ(expected.regKind, actual.regKind);
 }
 
 TEST_F(FixUpInstructionsTest, genDstOperand_Long)
 {
-    const auto expected = make_shared<RegisterOperand>(RegType::R11, AsmType::LongWord);
+    const RegisterOperand expected(RegType::R11, AsmType::LongWord);
     const auto actual = CodeGen::FixUpInstructions::genDstOperand(AsmType::LongWord);
-    EXPECT_EQ(expected->regKind, actual->regKind);
+    EXPECT_EQ(expected.regKind, actual.regKind);
 }
\ No newline at end of file
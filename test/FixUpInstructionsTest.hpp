@@ -3,7 +3,6 @@
 #include "AsmAST.hpp"
 #include "CodeGenInstructionFactory.hpp"
 
-#include <memory>
 #include <vector>
 #include <gtest/gtest.h>
 
@@ -14,12 +13,12 @@ using OperKind = CodeGen::Operand::Kind;
 using InstKind = CodeGen::Inst::Kind;
 using AsmType = CodeGen::AsmType;
 using BinaryOper = CodeGen::BinaryInst::Operator;
-using std::make_shared;
 
 class FixUpInstructionsTest : public testing::Test {
     CodeGen::CodeGenInstructionFactory factory;
 public:
-    std::vector<std::unique_ptr<CodeGen::Inst>> insts;
+    CodeGen::InstructionPool pool;
+    std::vector<CodeGen::Inst*> insts;
     void addMove(OperKind srcKind, OperKind dstKind, AsmType asmType);
     void addMoveZero(OperKind srcKind, OperKind dstKind, AsmType asmType);
     void addMoveSX(OperKind srcKind, OperKind dstKind);
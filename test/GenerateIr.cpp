@@ -5,11 +5,17 @@
 #include "ASTIr.hpp"
 #include "Frontend/AST/ASTParser.hpp"
 #include "Frontend/AST/ASTTypes.hpp"
+#include "FrontendDriver.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+#include <unistd.h>
 
 // TEST(GenerateIrTests, VarExprToIrPreservesType)
 // {
 //     auto varExpr = std::make_unique<Parsing::VarExpr>("v");
-//     varExpr->type = std::make_unique<Parsing::VarType>(Type::I32);
+//     varExpr->type = Parsing::varType(Type::I32);
 //     const auto expected = std::make_shared<Ir::ValueVar>(Ir::Identifier("v"), Type::I32);
 //     const std::shared_ptr<Ir::Value> result = Ir::GenerateIr::genVarInst(*varExpr);
 //     EXPECT_EQ(expected->kind, result->kind);
@@ -18,9 +24,44 @@
 // TEST(GenerateIrTests, ConstExprToIrPreservesType)
 // {
 //     const auto constExpr = std::make_unique<Parsing::ConstExpr>(
-//         5, std::make_unique<Parsing::VarType>(Type::I32)
+//         5, Parsing::varType(Type::I32)
 //         );
 //     const auto expected = std::make_shared<Ir::ValueConst>(5);
 //     const std::shared_ptr<Ir::Value> result = Ir::GenerateIr::genConstInst(*constExpr);
 //     EXPECT_EQ(expected->kind, result->kind);
-// }
\ No newline at end of file
+// }
+
+namespace {
+
+StateCode lowerSource(const std::string& source)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() /
+        ("static-init-" + std::to_string(getpid()) + ".c");
+    std::ofstream(path) << source;
+    FrontendDriver frontend("", path);
+    auto [irProgram, err] = frontend.run();
+    std::filesystem::remove(path);
+    return err;
+}
+
+}
+
+TEST(GenerateIrTests, ConstantStaticInitializersLower)
+{
+    EXPECT_EQ(lowerSource("int a = 25;\n"
+                          "long b[3] = {1, 2};\n"
+                          "int main(void) { static double d = 1; return a; }\n"),
+              StateCode::Continue);
+}
+
+TEST(GenerateIrTests, NonConstantStaticInitializersAreReported)
+{
+    EXPECT_EQ(lowerSource("char *str = \"hello\";\n"
+                          "int main(void) { return str[1]; }\n"),
+              StateCode::IrGeneration);
+    EXPECT_EQ(lowerSource("int a = ((4 + 1) * (4 + 1));\n"
+                          "int main(void) { return a; }\n"),
+              StateCode::IrGeneration);
+    EXPECT_EQ(lowerSource("int main(void) { static int a = 2 * 3; return a; }\n"),
+              StateCode::IrGeneration);
+}
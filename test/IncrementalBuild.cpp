@@ -0,0 +1,172 @@
+#include "CodeGenDriver.hpp"
+#include "CodeGen/Assembly.hpp"
+#include "CompileCache.hpp"
+#include "ElfWriter.hpp"
+#include "FrontendDriver.hpp"
+#include "GenerateAsmTree.hpp"
+#include "IncrementalBuild.hpp"
+#include "ObjectEmitter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include <unistd.h>
+
+namespace {
+
+std::string function(const i32 i, const std::string& extra = "")
+{
+    const std::string n = std::to_string(i);
+    return "int f" + n + "(int x) {\n"
+           "    static int calls = " + n + ";\n"
+           "    char *name = \"f" + n + "\";\n"
+           "    double d = x * 1.5 + " + n + ".25;\n"
+           "    calls = calls + 1;\n"
+           "    for (int i = 0; i < x; i = i + 1) {\n"
+           "        switch (i % 3) {\n"
+           "            case 0: d = d + scale; break;\n"
+           "            default: continue;\n"
+           "        }\n"
+           "    }\n" + extra +
+           "    return (int)d + calls + name[0] + helper(x);\n"
+           "}\n";
+}
+
+std::string source(const std::string& scaleType, const i32 edited)
+{
+    std::string text = "static " + scaleType + " scale = 2;\n"
+                       "static int helper(int x) { return x > 0 ? x - 1 : 0; }\n";
+    for (i32 i = 0; i < 8; ++i)
+        text += function(i, i == edited ? "    x = x + 1;\n" : "");
+    return text + "int main(void) { return f7(3) + f0(1); }\n";
+}
+
+class IncrementalBuildTest : public testing::Test {
+protected:
+    std::filesystem::path m_directory;
+    std::filesystem::path m_file;
+
+    void SetUp() override
+    {
+        m_directory = std::filesystem::temp_directory_path() / ("cc-incremental-" + std::to_string(getpid()));
+        std::filesystem::create_directories(m_directory);
+        m_file = m_directory / "unit.c";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_directory);
+    }
+
+    void write(const std::string& text) const
+    {
+        std::ofstream(m_file) << text;
+    }
+
+    [[nodiscard]] std::string fullBuild(const std::string& argument) const
+    {
+        FrontendDriver frontend("", m_file);
+        auto [irProgram, err] = frontend.run();
+        EXPECT_TRUE(irProgram.has_value());
+        if (!irProgram.has_value())
+            return {};
+        CodeGen::Program program;
+        CodeGen::GenerateAsmTree generateAsmTree;
+        generateAsmTree.genProgram(*irProgram, program);
+        CodeGen::fixAsm(program);
+        return emit(program, argument);
+    }
+
+    [[nodiscard]] std::string incrementalBuild(IncrementalBuild& build, const std::string& argument) const
+    {
+        FrontendDriver frontend("", m_file);
+        CodeGen::Program program;
+        EXPECT_EQ(build.run(frontend, program, CodeGen::WorkStealingPool(2)), StateCode::Continue);
+        return emit(program, argument);
+    }
+
+    [[nodiscard]] static std::string emit(const CodeGen::Program& program, const std::string& argument)
+    {
+        if (argument == "--assemble")
+            return CodeGen::asmProgram(program);
+        const std::vector<u8> object = CodeGen::elfObject(CodeGen::emitObject(program));
+        return {object.begin(), object.end()};
+    }
+};
+
+}
+
+TEST_F(IncrementalBuildTest, OutputMatchesFullBuild)
+{
+    const CompileCache cache(m_directory / "cache", CompileCache::defaultMaxSize);
+    write(source("double", -1));
+    for (const std::string argument : {"-c", "--assemble"}) {
+        IncrementalBuild cold(cache, argument);
+        EXPECT_EQ(incrementalBuild(cold, argument), fullBuild(argument));
+        EXPECT_EQ(cold.reused(), 0);
+        EXPECT_EQ(cold.generated(), 10);
+
+        IncrementalBuild warm(cache, argument);
+        EXPECT_EQ(incrementalBuild(warm, argument), fullBuild(argument));
+        EXPECT_EQ(warm.reused(), 10);
+        EXPECT_EQ(warm.generated(), 0);
+    }
+}
+
+TEST_F(IncrementalBuildTest, OnlyEditedFunctionsAreRebuilt)
+{
+    const CompileCache cache(m_directory / "cache", CompileCache::defaultMaxSize);
+    write(source("double", -1));
+    IncrementalBuild first(cache, "-c");
+    static_cast<void>(incrementalBuild(first, "-c"));
+
+    write(source("double", 4));
+    IncrementalBuild edited(cache, "-c");
+    EXPECT_EQ(incrementalBuild(edited, "-c"), fullBuild("-c"));
+    EXPECT_EQ(edited.generated(), 1);
+    EXPECT_EQ(edited.reused(), 9);
+
+    // Every f reads scale, so changing its type invalidates them but not helper and main.
+    write(source("long", 4));
+    IncrementalBuild retyped(cache, "-c");
+    EXPECT_EQ(incrementalBuild(retyped, "-c"), fullBuild("-c"));
+    EXPECT_EQ(retyped.generated(), 8);
+    EXPECT_EQ(retyped.reused(), 2);
+}
+
+TEST_F(IncrementalBuildTest, CorruptEntriesAreRebuilt)
+{
+    const CompileCache cache(m_directory / "cache", CompileCache::defaultMaxSize);
+    write(source("double", -1));
+    IncrementalBuild first(cache, "-c");
+    static_cast<void>(incrementalBuild(first, "-c"));
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(m_directory / "cache"))
+        if (entry.is_regular_file() && entry.path().filename() != "stats")
+            std::filesystem::resize_file(entry.path(), entry.file_size() / 2);
+
+    IncrementalBuild second(cache, "-c");
+    EXPECT_EQ(incrementalBuild(second, "-c"), fullBuild("-c"));
+    EXPECT_EQ(second.generated(), 10);
+}
+
+TEST(FunctionUnitTest, RoundTrips)
+{
+    CodeGen::FunctionUnit unit;
+    unit.topLevels.emplace_back(std::make_unique<CodeGen::StringVariable>(
+        CodeGen::Identifier(Symbol("f.0.string")), std::string("a\0b", 3), false, true));
+    CodeGen::ObjectModule object;
+    object.section(CodeGen::ObjectModule::SectionKind::Text).bytes = {0x55, 0xE8, 0, 0, 0, 0};
+    object.textRelocations.push_back({2, object.symbol("g"), CodeGen::ObjectModule::RelocationKind::PLT32, -4});
+    unit.topLevels.emplace_back(std::make_unique<CodeGen::EmittedFunction>(
+        CodeGen::Identifier(Symbol("f")), "f:\n", std::move(object)));
+    unit.constants.emplace_back(std::make_unique<CodeGen::ConstVariable>(
+        CodeGen::Identifier(Symbol("double.0")), 16, -0.0, true));
+
+    const std::string bytes = unit.serialize();
+    const std::optional<CodeGen::FunctionUnit> copy = CodeGen::FunctionUnit::deserialize(bytes);
+    ASSERT_TRUE(copy.has_value());
+    EXPECT_EQ(copy->serialize(), bytes);
+    EXPECT_FALSE(CodeGen::FunctionUnit::deserialize(bytes.substr(0, bytes.size() - 1)).has_value());
+}
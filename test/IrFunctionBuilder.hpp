@@ -0,0 +1,50 @@
+#pragma once
+
+#include "ASTIr.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace Ir {
+
+// Builds TACKY functions by hand for the optimization tests. Variables are looked up by name,
+// so every mention of a name is the same value.
+class IrFunctionBuilder {
+    std::unique_ptr<Function> m_function;
+    std::unordered_map<std::string, ValueId> m_variables;
+public:
+    explicit IrFunctionBuilder(const std::string& name = "f")
+        : m_function(std::make_unique<Function>(Identifier{Symbol(name)}, true)) {}
+
+    ValueId var(const std::string& name, const Type type = Type::I32,
+                const ReferingTo referingTo = ReferingTo::Local)
+    {
+        if (const auto it = m_variables.find(name); it != m_variables.end())
+            return it->second;
+        const ValueId id = m_function->addValue(Value(Identifier{Symbol(name)}, type, referingTo, 0));
+        m_variables.emplace(name, id);
+        return id;
+    }
+    template<typename T>
+    ValueId constant(const T value) { return m_function->addValue(Value(value)); }
+    LabelId label() { return m_function->addLabel(); }
+    template<typename T, typename... Args>
+    IrFunctionBuilder& add(Args&&... args)
+    {
+        m_function->insts.push_back(m_function->make<T>(std::forward<Args>(args)...));
+        return *this;
+    }
+    IrFunctionBuilder& call(const std::string& name, const std::vector<ValueId>& args, const ValueId dst,
+                            const Type type = Type::I32)
+    {
+        const auto firstArg = static_cast<u32>(m_function->callArgs.size());
+        m_function->callArgs.insert(m_function->callArgs.end(), args.begin(), args.end());
+        return add<FunCallInst>(Identifier{Symbol(name)}, firstArg, static_cast<u32>(args.size()), dst, type);
+    }
+
+    [[nodiscard]] Function& function() const { return *m_function; }
+    [[nodiscard]] std::unique_ptr<Function> build() { return std::move(m_function); }
+};
+
+} // Ir
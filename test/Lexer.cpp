@@ -1,6 +1,7 @@
 #include <Lexer.hpp>
 #include "Frontend/Lexing/Lexer.hpp"
 #include "Frontend/Lexing/Token.hpp"
+#include "Frontend/Lexing/Keywords.hpp"
 #include <gtest/gtest.h>
 
 namespace {
@@ -196,4 +197,43 @@ TEST(LexerTests, MultiLineComment)
 {
     const auto tokens = runLexerTest(MULTILINE_COMMENT_PROGRAM);
     EXPECT_TRUE(tokens.size() == 1) << " " << tokens.size();
-}
\ No newline at end of file
+}
+TEST(LexerTests, LexemesAreViewsIntoOwnedSource)
+{
+    TokenStore tokenStore;
+    {
+        Lexing::Lexer lexer(std::string("int x;\n  y = \"a\\n\" 2.5;"), tokenStore);
+        EXPECT_TRUE(lexer.getLexemes().empty());
+    }
+    ASSERT_EQ(tokenStore.size(), 9);
+    EXPECT_EQ(tokenStore.getLexeme(1), "x");
+    EXPECT_EQ(tokenStore.getSymbol(1), Symbol("x"));
+    EXPECT_EQ(tokenStore.getLexeme(5), "a\n");
+    EXPECT_EQ(std::get<double>(tokenStore.getValue(6)), 2.5);
+    EXPECT_EQ(tokenStore.getLineNumber(3), 2);
+    EXPECT_EQ(tokenStore.getColumnNumber(3), 3);
+    EXPECT_EQ(tokenStore.getColumnNumber(5), 7);
+}
+
+TEST(LexerTests, KeywordPerfectHash)
+{
+    for (const Lexing::Keywords::Keyword& keyword : Lexing::Keywords::keywords)
+        EXPECT_EQ(Lexing::Keywords::lookup(keyword.text), keyword.type) << keyword.text;
+    for (const std::string_view text : {"i", "in", "ints", "retur", "returned", "Int", "_int", "unsigne", "sizeof_"})
+        EXPECT_EQ(Lexing::Keywords::lookup(text), TokenType::Identifier) << text;
+}
+
+TEST(LexerTests, RunsCrossingVectorWidth)
+{
+    const std::string identifier(70, 'a');
+    const std::string digits(40, '7');
+    const TokenStore tokenStore = runLexerTest(std::string(37, ' ') + identifier + "\t\n" + std::string(33, ' ')
+                                               + "1" + std::string(20, '0') + " " + digits.substr(0, 9) + "ul");
+    ASSERT_EQ(tokenStore.size(), 4);
+    EXPECT_EQ(tokenStore.getLexeme(0), identifier);
+    EXPECT_EQ(tokenStore.getType(1), TokenType::Invalid);
+    EXPECT_EQ(tokenStore.getLexeme(2), digits.substr(0, 9) + "ul");
+    EXPECT_EQ(std::get<u64>(tokenStore.getValue(2)), 777777777ul);
+    EXPECT_EQ(tokenStore.getLineNumber(2), 2);
+    EXPECT_EQ(tokenStore.getColumnNumber(0), 38);
+}
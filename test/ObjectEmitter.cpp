@@ -0,0 +1,180 @@
+#include "AsmAST.hpp"
+#include "ElfWriter.hpp"
+#include "JitImage.hpp"
+#include "ObjectEmitter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <elf.h>
+
+#include <cstring>
+
+namespace {
+using namespace CodeGen;
+using RegKind = Operand::RegKind;
+using std::make_unique;
+
+const std::vector<u8> prologue{0x55, 0x48, 0x89, 0xE5};
+
+template<typename T, typename... Args>
+void push(Function& function, Args&&... args)
+{
+    function.instructions.push_back(function.make<T>(std::forward<Args>(args)...));
+}
+
+std::vector<u8> encode(std::unique_ptr<Function> function)
+{
+    Program program;
+    program.topLevels.push_back(std::move(function));
+    const ObjectModule module = emitObject(program);
+    const std::vector<u8>& text = module.section(ObjectModule::SectionKind::Text).bytes;
+    EXPECT_TRUE(std::equal(prologue.begin(), prologue.end(), text.begin()));
+    return {text.begin() + static_cast<i64>(prologue.size()), text.end()};
+}
+
+Operand reg(const RegKind kind, const AsmType type)
+{
+    return RegisterOperand(kind, type);
+}
+
+Operand stack(const i64 offset, const AsmType type)
+{
+    return MemoryOperand(RegKind::BP, offset, type);
+}
+
+Operand imm(const u64 value, const AsmType type)
+{
+    return ImmOperand(value, type);
+}
+}
+
+TEST(ObjectEmitterTest, MovesAndArithmetic)
+{
+    auto function = make_unique<Function>(Identifier("f"), true);
+    push<MoveInst>(*function, imm(5, AsmType::LongWord), stack(-4, AsmType::LongWord),
+                   AsmType::LongWord);
+    push<MoveInst>(*function, reg(RegKind::SI, AsmType::Byte), stack(-1, AsmType::Byte), AsmType::Byte);
+    push<MoveInst>(*function, imm(5000000000, AsmType::QuadWord), reg(RegKind::R10, AsmType::QuadWord),
+                   AsmType::QuadWord);
+    push<BinaryInst>(*function, imm(1000, AsmType::QuadWord), reg(RegKind::R10, AsmType::QuadWord),
+                     BinaryInst::Operator::Add, AsmType::QuadWord);
+    push<BinaryInst>(*function, stack(-300, AsmType::LongWord), reg(RegKind::R11, AsmType::LongWord),
+                     BinaryInst::Operator::Mul, AsmType::LongWord);
+    push<SetCCInst>(*function, Inst::CondCode::L, reg(RegKind::DI, AsmType::Byte));
+    push<ReturnInst>(*function);
+    const std::vector<u8> expected{
+        0xC7, 0x45, 0xFC, 0x05, 0x00, 0x00, 0x00,
+        0x40, 0x88, 0x75, 0xFF,
+        0x49, 0xBA, 0x00, 0xF2, 0x05, 0x2A, 0x01, 0x00, 0x00, 0x00,
+        0x49, 0x81, 0xC2, 0xE8, 0x03, 0x00, 0x00,
+        0x44, 0x0F, 0xAF, 0x9D, 0xD4, 0xFE, 0xFF, 0xFF,
+        0x40, 0x0F, 0x9C, 0xC7,
+        0x48, 0x89, 0xEC, 0x5D, 0xC3,
+    };
+    EXPECT_EQ(encode(std::move(function)), expected);
+}
+
+TEST(ObjectEmitterTest, DoubleInstructions)
+{
+    auto function = make_unique<Function>(Identifier("f"), true);
+    push<Cvttsd2siInst>(*function, reg(RegKind::XMM1, AsmType::Double),
+                        reg(RegKind::R11, AsmType::QuadWord), AsmType::QuadWord);
+    push<BinaryInst>(*function, reg(RegKind::XMM14, AsmType::Double), reg(RegKind::XMM15, AsmType::Double),
+                     BinaryInst::Operator::DivDouble, AsmType::Double);
+    push<CmpInst>(*function, stack(-16, AsmType::Double), reg(RegKind::XMM0, AsmType::Double),
+                  AsmType::Double);
+    const std::vector<u8> expected{
+        0xF2, 0x4C, 0x0F, 0x2C, 0xD9,
+        0xF2, 0x45, 0x0F, 0x5E, 0xFE,
+        0x66, 0x0F, 0x2F, 0x45, 0xF0,
+    };
+    EXPECT_EQ(encode(std::move(function)), expected);
+}
+
+TEST(ObjectEmitterTest, JumpsAreWidenedOnlyWhenNeeded)
+{
+    auto function = make_unique<Function>(Identifier("f"), true);
+    push<JmpCCInst>(*function, Inst::CondCode::E, Identifier("near"));
+    push<JmpInst>(*function, Identifier("far"));
+    push<LabelInst>(*function, Identifier("near"));
+    for (i32 i = 0; i < 40; ++i)
+        push<MoveInst>(*function, imm(0, AsmType::LongWord), stack(-8, AsmType::LongWord),
+                       AsmType::LongWord);
+    push<LabelInst>(*function, Identifier("far"));
+    const std::vector<u8> code = encode(std::move(function));
+    ASSERT_EQ(code.size(), 2 + 5 + 40 * 7);
+    EXPECT_EQ(code[0], 0x74);
+    EXPECT_EQ(code[1], 0x05);
+    EXPECT_EQ(code[2], 0xE9);
+    EXPECT_EQ(code[3] | code[4] << 8, 40 * 7);
+}
+
+TEST(ObjectEmitterTest, ElfObjectLayout)
+{
+    Program program;
+    auto function = make_unique<Function>(Identifier("main"), true);
+    push<MoveInst>(*function,
+        DataOperand(Identifier("counter"), AsmType::LongWord, false),
+        reg(RegKind::AX, AsmType::LongWord), AsmType::LongWord);
+    push<CallInst>(*function, Identifier("putchar"));
+    push<ReturnInst>(*function);
+    program.topLevels.push_back(std::move(function));
+    auto counter = make_unique<StaticVariable>(Identifier("counter"), AsmType::LongWord, false);
+    counter->init = 7;
+    program.topLevels.push_back(std::move(counter));
+    program.topLevels.push_back(make_unique<StaticVariable>(Identifier("zeroed"), AsmType::QuadWord, true));
+
+    const ObjectModule module = emitObject(program);
+    EXPECT_EQ(module.section(ObjectModule::SectionKind::Data).bytes, (std::vector<u8>{7, 0, 0, 0}));
+    EXPECT_EQ(module.section(ObjectModule::SectionKind::Bss).size(), 8);
+    ASSERT_EQ(module.textRelocations.size(), 2);
+    EXPECT_EQ(module.textRelocations[0].kind, ObjectModule::RelocationKind::PC32);
+    EXPECT_EQ(module.textRelocations[0].offset, 6);
+    EXPECT_EQ(module.textRelocations[1].kind, ObjectModule::RelocationKind::PLT32);
+
+    const std::vector<u8> bytes = elfObject(module);
+    Elf64_Ehdr header;
+    ASSERT_GE(bytes.size(), sizeof(header));
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    EXPECT_EQ(std::memcmp(header.e_ident, ELFMAG, SELFMAG), 0);
+    EXPECT_EQ(header.e_type, ET_REL);
+    EXPECT_EQ(header.e_machine, EM_X86_64);
+    EXPECT_EQ(header.e_shoff + header.e_shnum * sizeof(Elf64_Shdr), bytes.size());
+}
+
+TEST(JitImageTest, RunsGeneratedCode)
+{
+    Program program;
+    auto function = make_unique<Function>(Identifier("answer"), true);
+    push<MoveInst>(*function,
+        imm(-7, AsmType::LongWord), reg(RegKind::DI, AsmType::LongWord), AsmType::LongWord);
+    push<CallInst>(*function, Identifier("abs"));
+    push<BinaryInst>(*function,
+        DataOperand(Identifier("base"), AsmType::LongWord, false),
+        reg(RegKind::AX, AsmType::LongWord), BinaryInst::Operator::Add, AsmType::LongWord);
+    push<ReturnInst>(*function);
+    program.topLevels.push_back(std::move(function));
+    auto base = make_unique<StaticVariable>(Identifier("base"), AsmType::LongWord, false);
+    base->init = 35;
+    program.topLevels.push_back(std::move(base));
+
+    const ObjectModule module = emitObject(program);
+    JitImage image;
+    ASSERT_TRUE(image.load(module).empty());
+    const auto answer = reinterpret_cast<i32 (*)()>(image.symbolAddress("answer"));
+    ASSERT_NE(answer, nullptr);
+    EXPECT_EQ(answer(), 42);
+    EXPECT_EQ(image.symbolAddress("abs"), nullptr);
+}
+
+TEST(JitImageTest, ReportsUndefinedSymbols)
+{
+    Program program;
+    auto function = make_unique<Function>(Identifier("f"), true);
+    push<CallInst>(*function, Identifier("no_such_function_anywhere"));
+    program.topLevels.push_back(std::move(function));
+    JitImage image;
+    const std::vector<std::string> errors = image.load(emitObject(program));
+    ASSERT_EQ(errors.size(), 1);
+    EXPECT_EQ(errors.front(), "undefined reference to 'no_such_function_anywhere'");
+}
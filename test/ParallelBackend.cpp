@@ -0,0 +1,80 @@
+#include "CodeGenDriver.hpp"
+#include "CodeGen/Assembly.hpp"
+#include "ElfWriter.hpp"
+#include "FrontendDriver.hpp"
+#include "GenerateAsmTree.hpp"
+#include "ObjectEmitter.hpp"
+#include "WorkStealingPool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+#include <unistd.h>
+
+namespace {
+
+std::string generatedSource(const i32 functionCount)
+{
+    std::string source = "static double scale = 2.5;\n";
+    for (i32 i = 0; i < functionCount; ++i) {
+        const std::string n = std::to_string(i);
+        source += "int f" + n + "(int x, double d) {\n"
+                  "    int total = 0;\n"
+                  "    for (int i = 0; i < x; i = i + 1)\n"
+                  "        total = total + (i % " + std::to_string(i % 7 + 2) + " ? i : -i);\n"
+                  "    if (d * scale > " + n + ".5 && total)\n"
+                  "        return total + f" + std::to_string(i == 0 ? 0 : i - 1) + "(x - 1, -d);\n"
+                  "    return total;\n"
+                  "}\n";
+    }
+    return source + "int main(void) { return f" + std::to_string(functionCount - 1) + "(5, 1.0); }\n";
+}
+
+struct Backend {
+    std::string assembly;
+    std::vector<u8> object;
+};
+
+Backend runBackend(const Ir::Program& irProgram, const size_t threadCount)
+{
+    const CodeGen::WorkStealingPool pool(threadCount);
+    CodeGen::Program program;
+    CodeGen::GenerateAsmTree generateAsmTree;
+    generateAsmTree.genProgram(irProgram, program, pool);
+    CodeGen::fixAsm(program, pool);
+    return {CodeGen::asmProgram(program, pool), CodeGen::elfObject(CodeGen::emitObject(program, pool))};
+}
+
+}
+
+TEST(WorkStealingPoolTest, RunsEveryTaskOnce)
+{
+    for (const size_t threadCount : {1, 2, 4, 16}) {
+        const CodeGen::WorkStealingPool pool(threadCount);
+        std::vector<std::atomic<i32>> runs(1000);
+        pool.run(runs.size(), [&runs](const size_t i) { ++runs[i]; });
+        for (const std::atomic<i32>& count : runs)
+            EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(ParallelBackendTest, OutputDoesNotDependOnThreadCount)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() /
+        ("backend-" + std::to_string(getpid()) + ".c");
+    std::ofstream(path) << generatedSource(64);
+    FrontendDriver frontend("", path);
+    auto [irProgram, err] = frontend.run();
+    std::filesystem::remove(path);
+    ASSERT_TRUE(irProgram.has_value());
+
+    const Backend serial = runBackend(*irProgram, 1);
+    for (const size_t threadCount : {2, 4, 8}) {
+        const Backend parallel = runBackend(*irProgram, threadCount);
+        EXPECT_EQ(parallel.assembly, serial.assembly);
+        EXPECT_EQ(parallel.object, serial.object);
+    }
+}
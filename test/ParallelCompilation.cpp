@@ -0,0 +1,70 @@
+#include "FrontendDriver.hpp"
+#include "IrPrinter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <unistd.h>
+
+namespace {
+
+const std::string source =
+    "static int counter = 3;\n"
+    "int sum(int n) {\n"
+    "    int total = 0;\n"
+    "    for (int i = 0; i < n; i = i + 1)\n"
+    "        total = total + (i % 2 ? i : -i);\n"
+    "    return total + counter;\n"
+    "}\n"
+    "int main(void) {\n"
+    "    double d = 1.5;\n"
+    "    return sum(10) + (d > 1.0 && counter) + 0;\n"
+    "}\n";
+
+std::filesystem::path writeSource()
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() /
+        ("parallel-" + std::to_string(getpid()) + ".c");
+    std::ofstream(path) << source;
+    return path;
+}
+
+std::string printedIr(const std::filesystem::path& path)
+{
+    FrontendDriver frontend("", path);
+    auto [irProgram, err] = frontend.run();
+    EXPECT_EQ(err, StateCode::Continue);
+    if (!irProgram.has_value())
+        return {};
+    Ir::IrPrinter printer;
+    return printer.print(*irProgram);
+}
+
+}
+
+TEST(ParallelCompilationTest, TemporaryNamesArePerCompilation)
+{
+    const std::filesystem::path path = writeSource();
+    const std::string first = printedIr(path);
+    EXPECT_FALSE(first.empty());
+    EXPECT_EQ(printedIr(path), first);
+    std::filesystem::remove(path);
+}
+
+TEST(ParallelCompilationTest, ConcurrentFrontendsProduceIdenticalIr)
+{
+    const std::filesystem::path path = writeSource();
+    const std::string expected = printedIr(path);
+    std::vector<std::string> results(4);
+    {
+        std::vector<std::jthread> workers;
+        for (std::string& result : results)
+            workers.emplace_back([&result, &path] { result = printedIr(path); });
+    }
+    for (const std::string& result : results)
+        EXPECT_EQ(result, expected);
+    std::filesystem::remove(path);
+}
@@ -18,11 +18,11 @@ TokenStore generateTokens(const std::vector<Lexing::Token::Type>& tokenTypes)
     g_tokenStore.reserve(tokenTypes.size() + 1);
     for (const TokenType tokenType : tokenTypes) {
         if (tokenType == TokenType::Identifier)
-            g_tokenStore.emplaceBack(0, 1, 1, tokenType, "x");
+            g_tokenStore.append(tokenType, "x");
         else
-            g_tokenStore.emplaceBack(0, 1, 1, tokenType, "");
+            g_tokenStore.append(tokenType, "");
     }
-    g_tokenStore.emplaceBack(0, 1, 1, TokenType::EndOfFile, "");
+    g_tokenStore.append(TokenType::EndOfFile, "");
     return g_tokenStore;
 }
 
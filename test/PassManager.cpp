@@ -0,0 +1,178 @@
+#include "CompilerDriver.hpp"
+#include "ControlFlowGraph.hpp"
+#include "Dominators.hpp"
+#include "IrFunctionBuilder.hpp"
+#include "PassManager.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include <unistd.h>
+
+using namespace Ir;
+using namespace Optimization;
+
+namespace {
+
+// if (c) x = 1; else x = 2; return x; followed by code that is never reached.
+std::unique_ptr<Function> diamond()
+{
+    IrFunctionBuilder builder;
+    const ValueId c = builder.var("c");
+    const ValueId x = builder.var("x");
+    const LabelId elseLabel = builder.label();
+    const LabelId endLabel = builder.label();
+    builder.add<JumpIfZeroInst>(c, elseLabel, Type::I32)                 // block 0
+        .add<CopyInst>(builder.constant(1), x, Type::I32)                // block 1
+        .add<JumpInst>(endLabel)
+        .add<LabelInst>(elseLabel)                                       // block 2
+        .add<CopyInst>(builder.constant(2), x, Type::I32)
+        .add<LabelInst>(endLabel)                                        // block 3
+        .add<ReturnInst>(x, Type::I32)
+        .add<CopyInst>(builder.constant(3), x, Type::I32);               // block 4
+    return builder.build();
+}
+
+class CountingPass final : public FunctionPass {
+    Preserved m_preserved;
+public:
+    explicit CountingPass(const Preserved preserved)
+        : m_preserved(preserved) {}
+    [[nodiscard]] std::string_view name() const override { return "counting"; }
+    Preserved run(Function&, FunctionAnalyses& analyses) const override
+    {
+        (void)analyses.get<Dominators>();
+        return m_preserved;
+    }
+};
+
+Invocation parse(std::vector<std::string> args)
+{
+    const std::filesystem::path source = std::filesystem::temp_directory_path() /
+        ("options-" + std::to_string(getpid()) + ".c");
+    std::ofstream(source) << "int main(void) { return 0; }\n";
+    args.insert(args.begin(), "CC");
+    args.push_back(source.string());
+    Invocation invocation;
+    const CompilerDriver driver(args, {});
+    EXPECT_EQ(driver.validateAndSetArg(invocation), StateCode::Continue);
+    std::filesystem::remove(source);
+    return invocation;
+}
+
+}
+
+TEST(ControlFlowGraphTest, SplitsAtLabelsJumpsAndReturns)
+{
+    const std::unique_ptr<Function> function = diamond();
+    const ControlFlowGraph cfg(*function);
+    ASSERT_EQ(cfg.size(), 5);
+    EXPECT_EQ(cfg.block(0).successors, (std::vector<u32>{1, 2}));
+    EXPECT_EQ(cfg.block(1).successors, (std::vector<u32>{3}));
+    EXPECT_EQ(cfg.block(2).successors, (std::vector<u32>{3}));
+    EXPECT_EQ(cfg.block(3).predecessors, (std::vector<u32>{1, 2}));
+    EXPECT_TRUE(cfg.block(3).successors.empty());
+    EXPECT_EQ(cfg.blockOf(static_cast<LabelId>(1)), 3);
+    EXPECT_FALSE(cfg.reachable(4));
+    EXPECT_EQ(cfg.reversePostOrder().front(), 0);
+    EXPECT_EQ(cfg.reversePostOrder().back(), 3);
+}
+
+TEST(ControlFlowGraphTest, EmptyFunctionHasOneBlock)
+{
+    IrFunctionBuilder builder;
+    const ControlFlowGraph cfg(builder.function());
+    ASSERT_EQ(cfg.size(), 1);
+    EXPECT_TRUE(cfg.block(0).empty());
+}
+
+TEST(DominatorsTest, JoinIsDominatedByTheBranch)
+{
+    const std::unique_ptr<Function> function = diamond();
+    const ControlFlowGraph cfg(*function);
+    const Dominators dominators(cfg);
+    EXPECT_EQ(dominators.immediateDominator(1), 0);
+    EXPECT_EQ(dominators.immediateDominator(2), 0);
+    EXPECT_EQ(dominators.immediateDominator(3), 0);
+    EXPECT_TRUE(dominators.dominates(0, 3));
+    EXPECT_FALSE(dominators.dominates(1, 3));
+    EXPECT_FALSE(dominators.dominates(0, 4));
+}
+
+TEST(PassManagerTest, AnalysesAreCachedUntilInvalidated)
+{
+    const std::unique_ptr<Function> function = diamond();
+    FunctionAnalyses analyses(*function);
+    const CountingPass preserving(Preserved::All);
+    analyses.invalidate(preserving.run(*function, analyses));
+    analyses.invalidate(preserving.run(*function, analyses));
+    EXPECT_EQ(analyses.computed(), 2);
+
+    const CountingPass keepsCfg(Preserved::Cfg);
+    analyses.invalidate(keepsCfg.run(*function, analyses));
+    EXPECT_TRUE(analyses.cached<ControlFlowGraph>());
+    EXPECT_FALSE(analyses.cached<Dominators>());
+
+    const CountingPass keepsDominators(Preserved::Dominators);
+    analyses.invalidate(keepsDominators.run(*function, analyses));
+    EXPECT_FALSE(analyses.cached<ControlFlowGraph>());
+    EXPECT_FALSE(analyses.cached<Dominators>());
+    EXPECT_EQ(analyses.computed(), 3);
+}
+
+TEST(PassManagerTest, RepeatsUntilNothingChanges)
+{
+    class ChangesTwice final : public FunctionPass {
+        mutable i32 m_runs = 0;
+    public:
+        [[nodiscard]] std::string_view name() const override { return "changes-twice"; }
+        Preserved run(Function&, FunctionAnalyses&) const override
+        {
+            return ++m_runs <= 2 ? Preserved::None : Preserved::All;
+        }
+        [[nodiscard]] i32 runs() const { return m_runs; }
+    };
+    const std::unique_ptr<Function> function = diamond();
+    auto pass = std::make_unique<ChangesTwice>();
+    const ChangesTwice& counter = *pass;
+    PassManager passManager;
+    passManager.add(std::move(pass));
+    passManager.run(*function);
+    EXPECT_EQ(counter.runs(), 1);
+    passManager.repeatUntilFixedPoint(true);
+    passManager.run(*function);
+    EXPECT_EQ(counter.runs(), 3);
+}
+
+TEST(PassManagerTest, UnknownPassesAreRejected)
+{
+    Options options;
+    std::vector<std::string> errors;
+    EXPECT_FALSE(parsePasses("nope,,", options, errors));
+    EXPECT_EQ(errors, (std::vector<std::string>{"Unknown pass nope", "Empty pass name in --passes",
+                                                "Empty pass name in --passes"}));
+}
+
+TEST(PassManagerTest, FlagsSpellTheOptions)
+{
+    Options options;
+    EXPECT_EQ(options.flags(), "");
+    options.level = OptLevel::O2;
+    EXPECT_EQ(options.flags(), "-O2");
+    options.explicitPasses = true;
+    EXPECT_EQ(options.flags(), "-O2 --passes=");
+}
+
+TEST(CommandLineTest, OptionsCombineWithTheArgument)
+{
+    const Invocation invocation = parse({"-O2", "-c", "-lm", "-lpthread", "-j", "2"});
+    EXPECT_EQ(invocation.argument, "-c");
+    EXPECT_EQ(invocation.optimization.level, OptLevel::O2);
+    EXPECT_EQ(invocation.libraries, (std::vector<std::string>{"-lm", "-lpthread"}));
+    EXPECT_EQ(invocation.jobs, 2);
+    EXPECT_EQ(parse({"--printTacky", "-O1"}).optimization.level, OptLevel::O1);
+    EXPECT_EQ(parse({"-O"}).optimization.level, OptLevel::O1);
+    EXPECT_EQ(parse({"-O0", "--assemble"}).optimization.level, OptLevel::O0);
+}
@@ -0,0 +1,149 @@
+#include "Preprocessor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+namespace {
+
+std::string preprocess(const std::string& source, std::vector<std::string>* errors = nullptr)
+{
+    Preprocessing::Preprocessor preprocessor;
+    std::string output;
+    std::vector<std::string> result = preprocessor.process(source, "test.c", output);
+    if (errors != nullptr)
+        *errors = std::move(result);
+    else
+        EXPECT_TRUE(result.empty()) << result.front();
+    return output;
+}
+
+}
+
+TEST(PreprocessorTest, FastPathReturnsSourceUntouched)
+{
+    const std::string source = "int main(void) {\n    /* comment */ return 0;\n}\n";
+    EXPECT_FALSE(Preprocessing::needsPreprocessing(source));
+    EXPECT_EQ(preprocess(source), source);
+}
+
+TEST(PreprocessorTest, ObjectLikeMacroKeepsLineNumbers)
+{
+    EXPECT_EQ(preprocess("#define N 10\n\nint x = N;\n"), "\n\nint x = 10;\n");
+}
+
+TEST(PreprocessorTest, FunctionLikeMacro)
+{
+    EXPECT_EQ(preprocess("#define MAX(a, b) ((a) > (b) ? (a) : (b))\nint y = MAX(1, x + 2);\n"),
+              "\nint y = ((1) > (x + 2) ? (1) : (x + 2));\n");
+}
+
+TEST(PreprocessorTest, StringizeAndPaste)
+{
+    EXPECT_EQ(preprocess("#define STR(x) #x\n#define CAT(a, b) a ## b\nCAT(va, r1) = STR(a  + \"b\");\n"),
+              "\n\nvar1 = \"a + \\\"b\\\"\";\n");
+}
+
+TEST(PreprocessorTest, RecursiveMacroIsNotReexpanded)
+{
+    EXPECT_EQ(preprocess("#define f(x) x + f(x)\n#define g f\ng(1);\n"), "\n\n1 + f(1);\n");
+}
+
+TEST(PreprocessorTest, Conditionals)
+{
+    const std::string source =
+        "#define A 2\n"
+        "#if A > 1 && defined(A) && !defined B\n"
+        "one\n"
+        "#elif 1 / 0\n"
+        "two\n"
+        "#else\n"
+        "three\n"
+        "#endif\n"
+        "#ifdef B\n"
+        "#error unreachable\n"
+        "#endif\n";
+    EXPECT_EQ(preprocess(source), "\n\none\n");
+}
+
+TEST(PreprocessorTest, OverflowingDivisionWraps)
+{
+    const std::string source =
+        "#if (-9223372036854775807 - 1) / -1 == (-9223372036854775807 - 1)\n"
+        "quotient\n"
+        "#endif\n"
+        "#if (-9223372036854775807 - 1) % -1 == 0\n"
+        "remainder\n"
+        "#endif\n";
+    EXPECT_EQ(preprocess(source), "\nquotient\n\n\nremainder\n");
+}
+
+TEST(PreprocessorTest, UnsignedOperandsConvertTheOtherOperand)
+{
+    const std::string source =
+        "#if (-1 < 0u)\n"
+        "wrong\n"
+        "#endif\n"
+        "#if 18446744073709551615u / 2 == 9223372036854775807 && -1 / 2u > 0\n"
+        "division\n"
+        "#endif\n"
+        "#if -1u >> 63 == 1 && -1 >> 63 == -1 && (1 ? -1 : 0u) > 0\n"
+        "shift\n"
+        "#endif\n";
+    EXPECT_EQ(preprocess(source), "\n\n\n\ndivision\n\n\nshift\n");
+}
+
+TEST(PreprocessorTest, LineDirective)
+{
+    EXPECT_EQ(preprocess("#line 5 \"renamed.c\"\nint l = __LINE__; char* f = __FILE__;\n"),
+              "\n\n\n\nint l = 5; char* f = \"renamed.c\";\n");
+}
+
+TEST(PreprocessorTest, ReportsErrors)
+{
+    std::vector<std::string> errors;
+    static_cast<void>(preprocess("#if 1\n#error stop here\n", &errors));
+    ASSERT_EQ(errors.size(), 2);
+    EXPECT_EQ(errors[0], "test.c:2: #error stop here");
+    EXPECT_EQ(errors[1], "test.c:2: unterminated conditional directive");
+}
+
+TEST(PreprocessorTest, IncludeWithPragmaOnce)
+{
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "cc_preprocessor_test";
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "header.h") << "#pragma once\nint twice(int x);\n";
+    std::ofstream(dir / "main.c") << "#include \"header.h\"\n#include \"header.h\"\nint main(void) { return 0; }\n";
+    Preprocessing::Preprocessor preprocessor;
+    std::string output;
+    EXPECT_TRUE(preprocessor.processFile(dir / "main.c", output).empty());
+    EXPECT_EQ(output, "int twice(int x);\n\nint main(void) { return 0; }\n");
+    std::filesystem::remove_all(dir);
+}
+
+TEST(PreprocessorTest, IncludeNextContinuesTheSearch)
+{
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "cc_include_next_test";
+    std::filesystem::create_directories(dir / "first");
+    std::filesystem::create_directories(dir / "second");
+    std::ofstream(dir / "first" / "wrap.h") << "#include_next <wrap.h>\nint first;\n";
+    std::ofstream(dir / "second" / "wrap.h") << "int second;\n";
+    std::ofstream(dir / "main.c") << "#include <wrap.h>\n";
+    Preprocessing::Preprocessor preprocessor;
+    preprocessor.addIncludeDirectory(dir / "first");
+    preprocessor.addIncludeDirectory(dir / "second");
+    std::string output;
+    EXPECT_TRUE(preprocessor.processFile(dir / "main.c", output).empty());
+    EXPECT_EQ(output, "int second;\nint first;\n");
+    std::filesystem::remove_all(dir);
+}
+
+TEST(PreprocessorTest, SystemHeaders)
+{
+    if (!std::filesystem::is_regular_file("/usr/include/limits.h"))
+        GTEST_SKIP() << "no C library headers installed";
+    const std::string output = preprocess(
+        "#include <limits.h>\n#include <stddef.h>\nint max = INT_MAX; int bits = CHAR_BIT; size_t size;\n");
+    EXPECT_TRUE(output.contains("int max = 0x7fffffff; int bits = 8; size_t size;")) << output;
+    EXPECT_TRUE(output.contains("typedef long unsigned int size_t;")) << output;
+}
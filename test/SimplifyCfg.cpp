@@ -0,0 +1,133 @@
+#include "ControlFlowGraph.hpp"
+#include "DynCast.hpp"
+#include "IrFunctionBuilder.hpp"
+#include "SimplifyCfg.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace Ir;
+using namespace Optimization;
+
+namespace {
+
+std::vector<Instruction::Kind> kinds(const Function& function)
+{
+    std::vector<Instruction::Kind> result;
+    for (const Instruction* inst : function.insts)
+        result.push_back(inst->kind);
+    return result;
+}
+
+bool simplify(Function& function)
+{
+    FunctionAnalyses analyses(function);
+    return SimplifyCfg().run(function, analyses) != Preserved::All;
+}
+
+}
+
+using Kind = Instruction::Kind;
+
+TEST(SimplifyCfgTest, RemovesCodeAfterReturnAndUnusedLabels)
+{
+    IrFunctionBuilder builder;
+    const ValueId x = builder.var("x");
+    const LabelId unused = builder.label();
+    const LabelId dead = builder.label();
+    builder.add<LabelInst>(unused)
+        .add<ReturnInst>(x, Type::I32)
+        .add<CopyInst>(builder.constant(1), x, Type::I32)
+        .add<JumpInst>(dead)
+        .add<LabelInst>(dead)
+        .add<ReturnInst>(x, Type::I32);
+    Function& function = builder.function();
+    EXPECT_TRUE(simplify(function));
+    EXPECT_EQ(kinds(function), (std::vector{Kind::Return}));
+    EXPECT_FALSE(simplify(function));
+}
+
+TEST(SimplifyCfgTest, ThreadsJumpChains)
+{
+    // while (c) { if (d) break; } with the jumps GenerateIr emits for it.
+    IrFunctionBuilder builder;
+    const ValueId c = builder.var("c");
+    const ValueId d = builder.var("d");
+    const LabelId loop = builder.label();
+    const LabelId breakLabel = builder.label();
+    const LabelId endIf = builder.label();
+    const LabelId exit = builder.label();
+    builder.add<LabelInst>(loop)
+        .add<JumpIfZeroInst>(c, breakLabel, Type::I32)
+        .add<JumpIfZeroInst>(d, endIf, Type::I32)
+        .add<JumpInst>(breakLabel)
+        .add<LabelInst>(endIf)
+        .add<JumpInst>(loop)
+        .add<LabelInst>(breakLabel)
+        .add<JumpInst>(exit)
+        .add<LabelInst>(exit)
+        .add<ReturnInst>(c, Type::I32);
+    Function& function = builder.function();
+    EXPECT_TRUE(simplify(function));
+    EXPECT_EQ(kinds(function), (std::vector{Kind::Label, Kind::JumpIfZero, Kind::JumpIfZero,
+                                            Kind::Label, Kind::Return}));
+    const auto loopCheck = dynCast<const JumpIfZeroInst>(function.insts[1]);
+    const auto breakCheck = dynCast<const JumpIfZeroInst>(function.insts[2]);
+    EXPECT_EQ(loopCheck->target, dynCast<const LabelInst>(function.insts[3])->target);
+    EXPECT_EQ(breakCheck->condition, d);
+    EXPECT_EQ(breakCheck->target, loop);
+}
+
+TEST(SimplifyCfgTest, InvertsBranchOverJump)
+{
+    IrFunctionBuilder builder;
+    const ValueId c = builder.var("c");
+    const ValueId x = builder.var("x");
+    const LabelId skip = builder.label();
+    const LabelId target = builder.label();
+    builder.add<JumpIfZeroInst>(c, skip, Type::I32)
+        .add<JumpInst>(target)
+        .add<LabelInst>(skip)
+        .add<CopyInst>(builder.constant(1), x, Type::I32)
+        .add<LabelInst>(target)
+        .add<ReturnInst>(x, Type::I32);
+    Function& function = builder.function();
+    EXPECT_TRUE(simplify(function));
+    EXPECT_EQ(kinds(function), (std::vector{Kind::JumpIfNotZero, Kind::Copy, Kind::Label, Kind::Return}));
+    EXPECT_EQ(dynCast<const JumpIfNotZeroInst>(function.insts[0])->target, target);
+}
+
+TEST(SimplifyCfgTest, MergesBlockWithItsOnlyPredecessor)
+{
+    IrFunctionBuilder builder;
+    const ValueId c = builder.var("c");
+    const ValueId x = builder.var("x");
+    const LabelId later = builder.label();
+    const LabelId other = builder.label();
+    builder.add<JumpIfZeroInst>(c, other, Type::I32)
+        .add<CopyInst>(builder.constant(1), x, Type::I32)
+        .add<JumpInst>(later)
+        .add<LabelInst>(other)
+        .add<ReturnInst>(c, Type::I32)
+        .add<LabelInst>(later)
+        .add<CopyInst>(builder.constant(2), x, Type::I32)
+        .add<ReturnInst>(x, Type::I32);
+    Function& function = builder.function();
+    EXPECT_TRUE(simplify(function));
+    EXPECT_EQ(kinds(function), (std::vector{Kind::JumpIfZero, Kind::Copy, Kind::Copy, Kind::Return,
+                                            Kind::Label, Kind::Return}));
+    const ControlFlowGraph cfg(function);
+    EXPECT_EQ(cfg.size(), 3);
+}
+
+TEST(SimplifyCfgTest, KeepsInfiniteLoopsAndArrayAllocations)
+{
+    IrFunctionBuilder builder;
+    const LabelId loop = builder.label();
+    builder.add<LabelInst>(loop)
+        .add<JumpInst>(loop)
+        .add<AllocateInst>(12, Identifier{Symbol("array")}, Type::I32);
+    Function& function = builder.function();
+    EXPECT_TRUE(simplify(function));
+    EXPECT_EQ(kinds(function), (std::vector{Kind::Allocate, Kind::Label, Kind::Jump}));
+    EXPECT_FALSE(simplify(function));
+}
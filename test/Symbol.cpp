@@ -0,0 +1,72 @@
+#include "Symbol.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(SymbolTest, SameTextSameId)
+{
+    const Symbol first("counter");
+    const Symbol second(std::string("count") + "er");
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first.id(), second.id());
+    EXPECT_EQ(first.text(), "counter");
+}
+
+TEST(SymbolTest, DifferentTextDifferentId)
+{
+    EXPECT_NE(Symbol("a"), Symbol("b"));
+}
+
+TEST(SymbolTest, DefaultIsEmpty)
+{
+    const Symbol empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.text(), "");
+    EXPECT_EQ(empty, Symbol(""));
+}
+
+TEST(SymbolTest, DerivedSymbolsAreDedupedAndSpelledLazily)
+{
+    const Symbol base("x");
+    const Symbol first = Symbol::derive(base, 3, std::string(".tmp").c_str());
+    const Symbol second = Symbol::derive(base, 3, ".tmp");
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, Symbol::derive(base, 4, ".tmp"));
+    EXPECT_NE(first, Symbol::derive(base, 3, ".label"));
+    EXPECT_EQ(first.text(), "x.3.tmp");
+    EXPECT_EQ(Symbol::derive(first, 7).text(), "x.3.tmp.7");
+    EXPECT_EQ(Symbol::derive(Symbol(), 12).text(), ".12");
+}
+
+TEST(SymbolTest, DerivedSymbolsKeepTheirOwnSuffix)
+{
+    const Symbol base("y");
+    std::string suffix = ".buffer";
+    const Symbol derived = Symbol::derive(base, 5, suffix);
+    suffix.assign(64, '#');
+    EXPECT_EQ(Symbol::derive(base, 5, ".buffer"), derived);
+    EXPECT_EQ(derived.text(), "y.5.buffer");
+}
+
+TEST(SymbolTest, ScopedSymbolsLiveInTheirTable)
+{
+    const Symbol global("shared");
+    const size_t globalSize = Symbol::Table::global().size();
+    Symbol::Table table;
+    {
+        const Symbol::Scope scope(&table);
+        EXPECT_EQ(Symbol("shared"), global);
+        const Symbol local("local.only");
+        const Symbol derived = Symbol::derive(local, 1, ".tmp");
+        EXPECT_EQ(Symbol("local.only"), local);
+        EXPECT_EQ(Symbol::derive(Symbol("local.only"), 1, ".tmp"), derived);
+        EXPECT_EQ(derived.text(), "local.only.1.tmp");
+        EXPECT_EQ(Symbol::derive(global, 2).text(), "shared.2");
+        EXPECT_EQ(table.size(), 3);
+        {
+            const Symbol::Scope inner(nullptr);
+            EXPECT_EQ(Symbol(""), Symbol());
+        }
+    }
+    EXPECT_EQ(Symbol::Table::global().size(), globalSize);
+    EXPECT_EQ(Symbol::Table::active(), nullptr);
+}
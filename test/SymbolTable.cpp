@@ -0,0 +1,93 @@
+#include "SymbolTable.hpp"
+#include "TypeContext.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace Parsing;
+
+TEST(SymbolTableTest, InnerScopeShadowsAndRestoresOuter)
+{
+    SymbolTable table;
+    const Symbol x("x");
+    table.addEntry(x, Symbol("x.global"), varType(Type::I32), false, true, true, true);
+    table.addScope();
+    table.addEntry(x, Symbol("x.0"), varType(Type::Double), false, false, false, true);
+    EXPECT_EQ(table.getUniqueName(x), Symbol("x.0"));
+    EXPECT_EQ(table.lookup(x).typeBase, varType(Type::Double));
+    EXPECT_TRUE(table.lookup(x).isFromCurrentScope());
+    table.addScope();
+    EXPECT_FALSE(table.lookup(x).isFromCurrentScope());
+    table.removeScope();
+    table.removeScope();
+    EXPECT_EQ(table.getUniqueName(x), Symbol("x.global"));
+    EXPECT_TRUE(table.lookup(x).isGlobal());
+    EXPECT_TRUE(table.lookup(x).isFromCurrentScope());
+}
+
+TEST(SymbolTableTest, RedeclarationInSameScopeOverwrites)
+{
+    SymbolTable table;
+    table.addScope();
+    const Symbol y("y");
+    table.addEntry(y, Symbol("y.0"), varType(Type::I32), false, false, false, false);
+    table.addEntry(y, Symbol("y.1"), varType(Type::I64), false, false, false, true);
+    EXPECT_EQ(table.getUniqueName(y), Symbol("y.1"));
+    EXPECT_TRUE(table.lookup(y).isDefined());
+    table.removeScope();
+    EXPECT_FALSE(table.contains(y));
+    EXPECT_FALSE(table.lookup(y).contains());
+}
+
+TEST(SymbolTableTest, ArgsAreFoundWithoutScanning)
+{
+    SymbolTable table;
+    const Symbol a("a");
+    const Symbol b("b");
+    FuncDeclaration decl(Declaration::StorageClass::None, Symbol("f"), {a, b},
+                         funcType(varType(Type::I32), {arrayOf(varType(Type::I32), 3), varType(Type::Char)}));
+    table.addEntry(decl.name, decl.name, decl.type, false, true, true, true);
+    table.setArgs(decl);
+    EXPECT_TRUE(table.isInArgs(a));
+    EXPECT_TRUE(table.lookup(b).isInArgs());
+    EXPECT_EQ(table.lookup(a).typeBase, pointerTo(varType(Type::I32)));
+    EXPECT_TRUE(table.isFunc(decl.name));
+    table.clearArgs();
+    EXPECT_FALSE(table.isInArgs(a));
+    EXPECT_FALSE(table.lookup(b).contains());
+}
+
+TEST(SymbolTableTest, IsFuncOnlyLooksAtFileScope)
+{
+    SymbolTable table;
+    const Symbol g("g");
+    table.addEntry(g, g, funcType(varType(Type::I32), {}), false, true, true, false);
+    table.addScope();
+    table.addEntry(g, Symbol("g.0"), varType(Type::I32), false, false, false, true);
+    EXPECT_TRUE(table.isFunc(g));
+    EXPECT_FALSE(table.isFunc(Symbol("h")));
+}
+
+TEST(SymbolTableTest, ManyNamesAcrossDeepScopes)
+{
+    SymbolTable table;
+    constexpr i32 depth = 64;
+    constexpr i32 perScope = 50;
+    for (i32 d = 0; d < depth; ++d) {
+        table.addScope();
+        for (i32 i = 0; i < perScope; ++i) {
+            const Symbol name(std::to_string(i + (d % 2) * perScope));
+            table.addEntry(name, Symbol(name.str() + "." + std::to_string(d)), varType(Type::I32), false, false, false, true);
+        }
+    }
+    for (i32 d = depth - 1; 0 <= d; --d) {
+        for (i32 i = 0; i < perScope; ++i) {
+            const Symbol name(std::to_string(i + (d % 2) * perScope));
+            ASSERT_EQ(table.getUniqueName(name).str(), name.str() + "." + std::to_string(d));
+        }
+        table.removeScope();
+    }
+    EXPECT_FALSE(table.contains(Symbol("0")));
+    EXPECT_FALSE(table.inFunc());
+}
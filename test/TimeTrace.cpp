@@ -0,0 +1,93 @@
+#include "CompilerDriver.hpp"
+#include "TimeTrace.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+
+#include <unistd.h>
+
+namespace {
+
+std::vector<std::unique_ptr<i32>> allocate(const i32 count)
+{
+    std::vector<std::unique_ptr<i32>> values;
+    values.reserve(count);
+    for (i32 i = 0; i < count; ++i)
+        values.push_back(std::make_unique<i32>(i));
+    return values;
+}
+
+}
+
+TEST(TimeTraceTest, NothingIsRecordedWhileDisabled)
+{
+    {
+        const TimeTrace::Scope scope("idle");
+        const std::vector<std::unique_ptr<i32>> values = allocate(4);
+    }
+    EXPECT_TRUE(TimeTrace::Recorder::instance().stop().empty());
+}
+
+TEST(TimeTraceTest, ScopesCountTheirAllocations)
+{
+    TimeTrace::start();
+    {
+        const TimeTrace::Scope scope("stage");
+        {
+            const TimeTrace::FunctionScope functionScope("stage", "main");
+            const std::vector<std::unique_ptr<i32>> values = allocate(100);
+        }
+    }
+    const std::vector<TimeTrace::Event> events = TimeTrace::Recorder::instance().stop();
+    ASSERT_EQ(events.size(), 2);
+    const TimeTrace::Event& function = events[0];
+    EXPECT_EQ(function.name, "main");
+    EXPECT_EQ(function.category, "function");
+    EXPECT_EQ(function.stage, "stage");
+    EXPECT_EQ(function.allocations, 101);
+    EXPECT_EQ(function.peakRssKb, -1);
+    const TimeTrace::Event& stage = events[1];
+    EXPECT_EQ(stage.name, "stage");
+    EXPECT_EQ(stage.category, "stage");
+    EXPECT_LE(101, stage.allocations);
+    EXPECT_LT(0, stage.peakRssKb);
+    EXPECT_LE(stage.begin, function.begin);
+    EXPECT_LE(function.begin + function.duration, stage.begin + stage.duration);
+}
+
+TEST(TimeTraceTest, JsonEscapesNames)
+{
+    const std::vector<TimeTrace::Event> events = {
+        {.name = "a\"b\\c\n", .category = "stage", .begin = 5, .duration = 7, .thread = 2, .allocations = 3,
+         .peakRssKb = 1024}
+    };
+    EXPECT_EQ(TimeTrace::toJson(events),
+        "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        "{\"name\":\"a\\\"b\\\\c\\u000a\",\"cat\":\"stage\",\"ph\":\"X\",\"ts\":5,\"dur\":7,\"pid\":1,\"tid\":2,"
+        "\"args\":{\"allocations\":3,\"peakRssKb\":1024}}\n"
+        "]}\n");
+}
+
+TEST(TimeTraceTest, DriverWritesSpansForStagesAndFunctions)
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::filesystem::path source = directory / ("trace-" + std::to_string(getpid()) + ".c");
+    const std::filesystem::path trace = directory / ("trace-" + std::to_string(getpid()) + ".json");
+    std::ofstream(source) << "int square(int x) { return x * x; }\nint main(void) { return square(3); }\n";
+    const CompilerDriver driver({"CC", "--codegen", "--time-trace=" + trace.string(), source.string()}, {});
+    EXPECT_EQ(driver.runLocal(), 0);
+    std::ifstream file(trace);
+    const std::string json((std::istreambuf_iterator(file)), std::istreambuf_iterator<char>());
+    for (const char* stage : {"preprocess", "lex", "parse", "VariableResolution", "TypeResolution",
+                              "LvalueVerification", "ValidateReturn", "GotoLabelsUnique", "LoopLabeling",
+                              "GenerateIr", "GenerateAsmTree"})
+        EXPECT_NE(json.find("{\"name\":\"" + std::string(stage) + "\",\"cat\":\"stage\""), std::string::npos) << stage;
+    EXPECT_NE(json.find("{\"name\":\"square\",\"cat\":\"function\""), std::string::npos);
+    EXPECT_NE(json.find("\"stage\":\"GenerateAsmTree\""), std::string::npos);
+    std::filesystem::remove(source);
+    std::filesystem::remove(trace);
+}
@@ -0,0 +1,76 @@
+#include "TypeContext.hpp"
+#include "ASTDeepCopy.hpp"
+#include "DynCast.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace Parsing;
+
+TEST(TypeContextTest, EqualTypesAreTheSameObject)
+{
+    EXPECT_EQ(varType(Type::I32), varType(Type::I32));
+    EXPECT_NE(varType(Type::I32), varType(Type::U32));
+    EXPECT_EQ(pointerTo(varType(Type::Char)), pointerTo(varType(Type::Char)));
+    EXPECT_NE(pointerTo(varType(Type::Char)), pointerTo(varType(Type::I8)));
+    EXPECT_EQ(arrayOf(varType(Type::Double), 4), arrayOf(varType(Type::Double), 4));
+    EXPECT_NE(arrayOf(varType(Type::Double), 4), arrayOf(varType(Type::Double), 5));
+}
+
+TEST(TypeContextTest, NestedTypesAreInterned)
+{
+    const TypeBase* matrix = arrayOf(arrayOf(varType(Type::I64), 3), 2);
+    const TypeBase* rowPointer = pointerTo(arrayOf(varType(Type::I64), 3));
+    EXPECT_EQ(matrix, arrayOf(arrayOf(varType(Type::I64), 3), 2));
+    EXPECT_EQ(convertArrayFirstDimToPtr(matrix), rowPointer);
+    EXPECT_EQ(dynCast<const ArrayType>(matrix)->elementType,
+              dynCast<const PointerType>(rowPointer)->referenced);
+}
+
+TEST(TypeContextTest, FunctionTypesCompareReturnAndParams)
+{
+    const TypeBase* intType = varType(Type::I32);
+    const TypeBase* charPointer = pointerTo(varType(Type::Char));
+    const FuncType* function = funcType(intType, {charPointer, intType});
+    EXPECT_EQ(function, funcType(intType, {charPointer, intType}));
+    EXPECT_NE(function, funcType(intType, {intType, charPointer}));
+    EXPECT_NE(function, funcType(varType(Type::I64), {charPointer, intType}));
+    EXPECT_NE(funcType(intType, {}), funcType(intType, {intType}));
+    EXPECT_EQ(function->params.size(), 2u);
+    EXPECT_EQ(function->returnType, intType);
+}
+
+TEST(TypeContextTest, InterningIsThreadSafe)
+{
+    constexpr i32 threadCount = 4;
+    std::vector<const TypeBase*> results(threadCount);
+    std::vector<std::thread> threads;
+    for (i32 i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&results, i] {
+            const TypeBase* type = varType(Type::U8);
+            for (i64 size = 1; size < 200; ++size)
+                type = pointerTo(arrayOf(type, size % 7 + 1));
+            results[i] = type;
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    for (const TypeBase* result : results)
+        EXPECT_EQ(result, results.front());
+}
+
+TEST(TypeContextTest, ScopedContextsOwnTheirTypes)
+{
+    const TypeBase* global = pointerTo(varType(Type::U64));
+    {
+        TypeContext context;
+        const TypeScope scope(context);
+        const TypeBase* scoped = pointerTo(varType(Type::U64));
+        EXPECT_NE(scoped, global);
+        EXPECT_EQ(scoped, context.pointer(varType(Type::U64)));
+        EXPECT_EQ(dynCast<const PointerType>(scoped)->referenced, varType(Type::U64));
+    }
+    EXPECT_EQ(pointerTo(varType(Type::U64)), global);
+}